@@ -1,14 +1,20 @@
 #version 450
 #extension GL_ARB_shading_language_include : enable
 
+// UNLIT is a permutation axis of pbr.shaderImport, variants that switch it on get it defined to 1. Unlit variants
+// leave out every light, so their pipelines don't bind the lights set at all
+#if !UNLIT
 #define USE_POINT_LIGHTS 1
 #define USE_DIR_LIGHTS   1
 #define USE_SPOT_LIGHTS  1
+#endif
 
 #include "../common/scene_ubo.glsl"
 #include "../common/vertex_io.glsl"
 #include "../material/material_pbr.glsl"
+#if !UNLIT
 #include "../lighting/lighting_common.glsl"
+#endif
 
 #if USE_DIR_LIGHTS
 #include "../lighting/light_directional.glsl"
@@ -36,7 +42,11 @@ void main()
     vec3 normal = normalize(inNormal);
     vec3 viewDir = normalize(sceneUbo.cameraPos - inWorldPos);
 
+    #if UNLIT
+    vec3 color = albedo;
+    #else
     vec3 color = AMBIENT_LIGHT * albedo;
+    #endif
 
     #if USE_DIR_LIGHTS
     color += AccumulateDirectionalLights(normal, inWorldPos, viewDir);
@@ -4,10 +4,19 @@
 #include <boost/uuid/uuid.hpp>
 #include <filesystem>
 #include <any>
+#include <cstdint>
+#include <vector>
 #include "AssetTypes.hpp"
 #include "AssetInfo.hpp"
 
 namespace am {
+    // What an import reads and runs with besides its source file, known before the importer runs. Asset types
+    // provide it through a static getImportInputs(const ImportContext&), it takes part in the import cache key
+    struct ImportInputs {
+        std::vector<std::string> sourceFiles;   // Includes and other files the import resolves
+        uint64_t settingsHash = 0;              // Flags and options the importer is built with
+    };
+
     class Asset {
     public:
         explicit Asset(const boost::uuids::uuid& id) : id(id) {}
@@ -33,6 +42,15 @@ namespace am {
         virtual void SaveAssetMetadata(rapidjson::Document& document) = 0;
         virtual void LoadAssetMetadata(rapidjson::Document& document) = 0;
 
+        // Assets this one references directly, loaded alongside it by AssetManager::loadAssetAsync
+        [[nodiscard]] virtual std::vector<boost::uuids::uuid> getDependencies() const { return {}; }
+
+        // Files besides its import path the asset was built from, a change to any of them reimports it
+        [[nodiscard]] virtual std::vector<std::string> getSourceFiles() const { return {}; }
+
+        // Bytes held by the asset's data, counted against AssetManager's memory budget
+        [[nodiscard]] virtual size_t getMemoryUsage() const { return 0; }
+
         boost::uuids::uuid id;
     };
 }
@@ -38,6 +38,7 @@ namespace am {
         AssetType type;
         std::string lookUpName;
         size_t contentHash;
+        uint64_t sourceHash = 0;    // Import cache key, see AssetManager::importAsset. 0 when not imported from a file
         ImportContext importContext;
         bool isLoaded = false;
         Asset *loadedAsset = nullptr;
@@ -67,6 +68,7 @@ namespace am {
               , path(std::move(other.path))
               , type(other.type)
               , contentHash(other.contentHash)
+              , sourceHash(other.sourceHash)
               , importContext(std::move(other.importContext))
               , loadedAsset(other.loadedAsset)
               , lookUpName(other.lookUpName)
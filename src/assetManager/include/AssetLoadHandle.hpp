@@ -0,0 +1,84 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef ASSETLOADHANDLE_HPP
+#define ASSETLOADHANDLE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <boost/uuid/uuid.hpp>
+
+namespace am
+{
+    class Asset;
+
+    enum class LoadPriority : uint8_t {
+        Background,
+        Normal,
+        High,
+        Critical
+    };
+
+    enum class AssetLoadState : uint8_t {
+        Queued,
+        Loading,        // The asset itself or something it depends on is still loading
+        Ready,
+        Failed,
+        Cancelled
+    };
+
+    // State shared by every handle to the same in flight load
+    class AssetLoadRequest
+    {
+    public:
+        AssetLoadRequest(const boost::uuids::uuid& id, LoadPriority priority) : id(id), priority(priority) {}
+
+        // Drops one outstanding load (the asset's own or a dependency's), the last one settles the request
+        void finishOne();
+
+        const boost::uuids::uuid id;
+        std::atomic<LoadPriority> priority;
+        std::atomic<AssetLoadState> state{AssetLoadState::Queued};
+        std::atomic<Asset*> asset{nullptr};
+        std::atomic<uint32_t> pending{1};
+
+        std::mutex mutex;
+        std::condition_variable settled;
+        bool done = false;                                          // Guarded by mutex
+        std::vector<std::shared_ptr<AssetLoadRequest>> dependents;  // Guarded by mutex, requests waiting on this one
+        // Keeps settled dependencies alive, so asking for them again while this is held doesn't start a new load
+        std::vector<std::shared_ptr<AssetLoadRequest>> dependencies;
+    };
+
+    class AssetLoadHandle
+    {
+    public:
+        AssetLoadHandle() = default;
+        explicit AssetLoadHandle(std::shared_ptr<AssetLoadRequest> request) : request(std::move(request)) {}
+
+        [[nodiscard]] bool valid() const { return request != nullptr; }
+        [[nodiscard]] boost::uuids::uuid getId() const;
+        [[nodiscard]] AssetLoadState getState() const;
+
+        // Ready once the asset and everything it depends on are loaded
+        [[nodiscard]] bool isReady() const { return getState() == AssetLoadState::Ready; }
+        [[nodiscard]] bool isDone() const;
+
+        // nullptr until ready
+        [[nodiscard]] Asset* get() const;
+        Asset* wait() const;
+
+        // Only stops loads that haven't started yet, it affects every handle to the same request
+        bool cancel() const;
+
+    private:
+        std::shared_ptr<AssetLoadRequest> request;
+    };
+}
+
+#endif //ASSETLOADHANDLE_HPP
@@ -8,6 +8,8 @@
 #include <boost/uuid/uuid.hpp>
 #include <utility>
 #include "AssetInfo.hpp"
+#include "AssetLoadHandle.hpp"
+#include "AssetResidency.hpp"
 
 
 namespace am
@@ -27,20 +29,36 @@ namespace am
 
         virtual std::any getAssetData(const boost::uuids::uuid& id) = 0;
 
+        // nullptr when the asset isn't there or failed to load
         template<typename T>
         T* getAssetData(const boost::uuids::uuid& id) {
-            return std::any_cast<T*>(getAssetData(id));
+            const std::any data = getAssetData(id);
+            T* const* typed = std::any_cast<T*>(&data);
+            return typed ? *typed : nullptr;
         }
 
         virtual std::any getAssetData(std::string lookupName) = 0;
 
         template<typename T>
         T* getAssetData(std::string lookupName) {
-            return std::any_cast<T*>(getAssetData(lookupName));
+            const std::any data = getAssetData(lookupName);
+            T* const* typed = std::any_cast<T*>(&data);
+            return typed ? *typed : nullptr;
         }
 
         virtual std::optional<std::shared_ptr<AssetInfo>> getAssetInfo(const boost::uuids::uuid& id) const = 0;
+        // Loads the asset if needed. While a memory budget is set the pointer is only good until the next load evicts
+        // it, callers keeping it around have to acquireAsset instead
         virtual std::optional<Asset*> getAsset(const boost::uuids::uuid& id) = 0;
+        // Loads the asset and everything it depends on on worker threads
+        virtual AssetLoadHandle loadAssetAsync(const boost::uuids::uuid& id, LoadPriority priority = LoadPriority::Normal) = 0;
+
+        // Residency. Loaded assets nobody acquired sit in an LRU list and are evicted once the budget is exceeded,
+        // pointers from getAsset stay valid only while the asset is acquired or the budget is unlimited
+        virtual Asset* acquireAsset(const boost::uuids::uuid& id) = 0;
+        virtual void releaseAsset(const boost::uuids::uuid& id) = 0;
+        virtual void setMemoryBudget(size_t bytes) = 0;
+        virtual AssetResidencyStats getResidencyStats() const = 0;
 
         virtual void saveAsset(boost::uuids::uuid id) = 0;
         virtual void saveAsset(std::string lookupName) = 0;
@@ -51,6 +69,12 @@ namespace am
         virtual std::vector<boost::uuids::uuid> getRegisteredAssetsUuids() const = 0;
         virtual std::vector<boost::uuids::uuid> getRegisteredAssetsUuids(AssetType type) const = 0;
 
+        // Hot reload. Once enabled the files registered assets were built from are watched, each poll reimports what
+        // changed on disk and everything built on it under the same ids and returns those, dependencies first.
+        // Poll from the thread driving the frames, then let the renderer rebuild what was returned
+        virtual void enableHotReload() = 0;
+        virtual std::vector<boost::uuids::uuid> pollHotReload() = 0;
+
     };
 }
 
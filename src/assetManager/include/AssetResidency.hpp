@@ -0,0 +1,24 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef ASSETRESIDENCY_HPP
+#define ASSETRESIDENCY_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace am
+{
+    struct AssetResidencyStats
+    {
+        size_t budgetBytes = 0;         // 0 when unlimited
+        size_t residentBytes = 0;
+        size_t residentCount = 0;
+        size_t referencedCount = 0;     // Pinned by acquireAsset, never evicted
+        size_t evictableCount = 0;      // Waiting in the LRU list
+        uint64_t evictionCount = 0;
+    };
+}
+
+#endif //ASSETRESIDENCY_HPP
@@ -129,11 +129,11 @@ namespace am {
         case AssetType::Model:         return false;
         case AssetType::Texture:       return true;
         case AssetType::Shader:        return true;
-        case AssetType::ShaderProgram: return false;
+        case AssetType::ShaderProgram: return true;
         case AssetType::Animation:     return true;
         case AssetType::Material:      return false;
         case AssetType::Animator:      return true;
-        case AssetType::Scene:         return false;
+        case AssetType::Scene:         return true;
         case AssetType::Prefab:        return false;
         default:                       return false;
         }
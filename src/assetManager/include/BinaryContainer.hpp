@@ -0,0 +1,173 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef BINARYCONTAINER_HPP
+#define BINARYCONTAINER_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <boost/uuid/uuid.hpp>
+
+namespace am
+{
+    // Payloads are used in place from the mapping, so the host has to match the on disk byte order
+    static_assert(std::endian::native == std::endian::little, "Binary asset containers are little endian only");
+
+    constexpr uint32_t makeFourCC(char a, char b, char c, char d)
+    {
+        return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+               static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8 |
+               static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16 |
+               static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24;
+    }
+
+    constexpr uint32_t kBinaryContainerMagic = makeFourCC('R', 'B', 'I', 'N');
+    constexpr uint16_t kBinaryContainerVersion = 1;
+    constexpr uint64_t kBinaryContainerAlignment = 16;
+
+    // On disk layout:
+    //   BinaryHeader | BinarySection[sectionCount] | payloads
+    // Every payload starts on a kBinaryContainerAlignment boundary relative to the start of the container.
+    struct BinaryHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;    // sizeof(BinaryHeader), lets newer readers skip fields they don't know
+        uint32_t kind;          // FourCC of the asset type stored in the container
+        uint32_t sectionCount;
+        uint8_t uuid[16];
+    };
+    static_assert(sizeof(BinaryHeader) == 32);
+
+    struct BinarySection {
+        uint32_t tag;           // FourCC
+        uint32_t elementSize;   // Stride of one element, used to reject files written with a different layout
+        uint64_t offset;        // In bytes from the start of the container
+        uint64_t size;          // In bytes
+        uint64_t reserved;
+    };
+    static_assert(sizeof(BinarySection) == 32);
+
+    // Read only view of a whole file, mmap on POSIX and a file mapping object on Windows.
+    // Also used for sub ranges of another mapping and for heap buffers, so asset data only
+    // ever has to keep one kind of handle alive.
+    class MappedFile
+    {
+    public:
+        static std::shared_ptr<const MappedFile> open(const std::string& path);
+
+        // Keeps parent alive, bytes() is the given range of it
+        static std::shared_ptr<const MappedFile> slice(std::shared_ptr<const MappedFile> parent, uint64_t offset, uint64_t size,
+                                                       std::string path);
+
+        // 16 byte aligned heap buffer, fill it through writableBytes() before sharing it
+        static std::shared_ptr<MappedFile> allocate(size_t size, std::string path);
+
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] std::span<const std::byte> bytes() const { return {data, size}; }
+        [[nodiscard]] std::span<std::byte> writableBytes() { return ownsBuffer ? std::span(const_cast<std::byte*>(data), size) : std::span<std::byte>(); }
+        [[nodiscard]] const std::string& getPath() const { return path; }
+
+    private:
+        MappedFile() = default;
+
+        const std::byte* data = nullptr;
+        size_t size = 0;
+        std::string path;
+        std::shared_ptr<const MappedFile> parent;
+        bool ownsBuffer = false;
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    };
+
+    class BinaryContainerReader
+    {
+    public:
+        // bytes has to point into file, which is kept alive by the reader and every view handed out of it.
+        // Passing a sub range allows reading containers embedded in a bigger file.
+        static std::optional<BinaryContainerReader> open(std::shared_ptr<const MappedFile> file, std::span<const std::byte> bytes,
+                                                         uint32_t kind);
+        static std::optional<BinaryContainerReader> open(const std::string& path, uint32_t kind);
+
+        // Cheap check used to route old files to their legacy readers
+        static bool isContainer(std::span<const std::byte> bytes);
+
+        [[nodiscard]] const BinaryHeader& getHeader() const { return header; }
+        [[nodiscard]] boost::uuids::uuid getId() const;
+        [[nodiscard]] const std::shared_ptr<const MappedFile>& getFile() const { return file; }
+
+        [[nodiscard]] const BinarySection* findSection(uint32_t tag) const;
+        [[nodiscard]] std::span<const std::byte> section(uint32_t tag) const;
+
+        // Typed view straight into the mapping, empty if the section is missing or its layout doesn't match T
+        template<typename T>
+        [[nodiscard]] std::span<const T> sectionAs(uint32_t tag) const;
+
+        // Copy of a single POD block, for small headers that are read once
+        template<typename T>
+        [[nodiscard]] std::optional<T> sectionValue(uint32_t tag) const;
+
+    private:
+        BinaryContainerReader(std::shared_ptr<const MappedFile> file, std::span<const std::byte> bytes, const BinaryHeader& header);
+
+        std::shared_ptr<const MappedFile> file;
+        std::span<const std::byte> bytes;
+        BinaryHeader header;
+        std::span<const BinarySection> sections;
+    };
+
+    class BinaryContainerWriter
+    {
+    public:
+        BinaryContainerWriter(uint32_t kind, const boost::uuids::uuid& id);
+
+        // The data is referenced, not copied, and has to outlive write()
+        void addSection(uint32_t tag, std::span<const std::byte> data, uint32_t elementSize = 1);
+
+        template<typename T>
+        void addSection(uint32_t tag, std::span<const T> values);
+
+        // Copies value into the writer, meant for small fixed size headers
+        template<typename T>
+        void addValue(uint32_t tag, const T& value);
+
+        [[nodiscard]] uint64_t getSize() const;
+
+        bool write(std::ostream& os) const;
+        bool write(const std::string& path) const;
+
+    private:
+        struct PendingSection {
+            uint32_t tag;
+            uint32_t elementSize;
+            std::span<const std::byte> data;
+        };
+
+        uint32_t kind;
+        boost::uuids::uuid id;
+        std::vector<PendingSection> pending;
+        std::vector<std::vector<std::byte>> ownedValues;
+    };
+
+    constexpr uint64_t alignBinaryOffset(uint64_t offset)
+    {
+        return (offset + kBinaryContainerAlignment - 1) & ~(kBinaryContainerAlignment - 1);
+    }
+}
+
+#include "BinaryContainer.tpp"
+
+#endif //BINARYCONTAINER_HPP
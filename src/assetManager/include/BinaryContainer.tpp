@@ -0,0 +1,54 @@
+#pragma once
+#include "BinaryContainer.hpp"
+
+#include <cstring>
+
+namespace am
+{
+    template<typename T>
+    std::span<const T> BinaryContainerReader::sectionAs(uint32_t tag) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be viewed in place");
+        static_assert(alignof(T) <= kBinaryContainerAlignment, "Section payloads are only 16 byte aligned");
+
+        const BinarySection* entry = findSection(tag);
+        if (!entry || entry->elementSize != sizeof(T) || entry->size % sizeof(T) != 0)
+            return {};
+
+        std::span<const std::byte> payload = section(tag);
+        if (reinterpret_cast<std::uintptr_t>(payload.data()) % alignof(T) != 0)
+            return {};
+
+        return {reinterpret_cast<const T*>(payload.data()), payload.size() / sizeof(T)};
+    }
+
+    template<typename T>
+    std::optional<T> BinaryContainerReader::sectionValue(uint32_t tag) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        const BinarySection* entry = findSection(tag);
+        if (!entry || entry->elementSize != sizeof(T) || entry->size != sizeof(T))
+            return std::nullopt;
+
+        T value;
+        std::memcpy(&value, section(tag).data(), sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void BinaryContainerWriter::addSection(uint32_t tag, std::span<const T> values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        addSection(tag, std::as_bytes(values), static_cast<uint32_t>(sizeof(T)));
+    }
+
+    template<typename T>
+    void BinaryContainerWriter::addValue(uint32_t tag, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        auto& owned = ownedValues.emplace_back(sizeof(T));
+        std::memcpy(owned.data(), &value, sizeof(T));
+        addSection(tag, std::span<const std::byte>(owned), static_cast<uint32_t>(sizeof(T)));
+    }
+}
@@ -0,0 +1,59 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef CONTENTHASH_HPP
+#define CONTENTHASH_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#define XXH_STATIC_LINKING_ONLY
+#include <xxhash.h>
+
+namespace am
+{
+    // Bytes are hashed as they lie in memory, which only hashes the same everywhere on little endian targets
+    static_assert(std::endian::native == std::endian::little, "Content hashes assume a little endian target");
+
+    // Streaming XXH3 over raw asset data, using the SIMD unit of the target. The result is the same on every platform
+    // and run, so it can be stored. Types hashed as bytes must not have padding, whatever it holds would leak in
+    class ContentHasher
+    {
+    public:
+        ContentHasher()
+        {
+            XXH3_INITSTATE(&state);
+            XXH3_64bits_reset(&state);
+        }
+
+        // One shot, skips the streaming state for a buffer that is already in memory as a whole
+        [[nodiscard]] static uint64_t hash(const void* data, size_t size) { return XXH3_64bits(data, size); }
+
+        void update(const void* data, size_t size) { XXH3_64bits_update(&state, data, size); }
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        void add(const T& value) { update(&value, sizeof(T)); }
+
+        // Prefixed with the count, so [ab][c] and [a][bc] hash differently
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        void addSpan(std::span<const T> values)
+        {
+            add(static_cast<uint64_t>(values.size()));
+            update(values.data(), values.size_bytes());
+        }
+
+        void addString(std::string_view text) { addSpan(std::span<const char>(text)); }
+
+        [[nodiscard]] uint64_t result() const { return XXH3_64bits_digest(&state); }
+
+    private:
+        XXH3_state_t state;
+    };
+}
+
+#endif //CONTENTHASH_HPP
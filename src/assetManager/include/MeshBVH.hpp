@@ -0,0 +1,80 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef MESHBVH_HPP
+#define MESHBVH_HPP
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include <glm/vec3.hpp>
+
+#include "VertexAsset.hpp"
+
+namespace am
+{
+    // Triangles tested together by one packet, 8 AVX lanes or two groups of 4 SSE lanes
+    inline constexpr uint32_t kMeshTrianglePacketWidth = 8;
+    inline constexpr uint32_t kMeshBVHInvalidTriangle = 0xFFFFFFFFu;
+
+    // Nodes are stored depth first, the left child of an inner node directly follows it
+    struct MeshBVHNode {
+        glm::vec3 boundsMin;
+        uint32_t offset;            // Inner node: index of the right child. Leaf: index of its packet
+        glm::vec3 boundsMax;
+        uint32_t triangleCount;     // 0 for inner nodes, 1 to kMeshTrianglePacketWidth for leaves
+    };
+
+    // Triangles of one leaf as lanes, first vertex and both edges precomputed for Moeller-Trumbore. Unused lanes have
+    // zero edges and can never be hit
+    struct alignas(16) MeshTrianglePacket {
+        float vertex0[3][kMeshTrianglePacketWidth];
+        float edge1[3][kMeshTrianglePacketWidth];
+        float edge2[3][kMeshTrianglePacketWidth];
+        uint32_t triangle[kMeshTrianglePacketWidth];    // Index of the triangle in the mesh, indices[3 * triangle]
+    };
+
+    // Owned tree, either built at import or for files written before meshes stored one
+    struct MeshBVH {
+        std::vector<MeshBVHNode> nodes;
+        std::vector<MeshTrianglePacket> packets;
+    };
+
+    struct MeshRayHit {
+        float distance;
+        uint32_t triangle;
+        float u;                    // Barycentric weights of the second and third vertex
+        float v;
+    };
+
+    enum class TriangleLanes {
+        Scalar = 1,
+        SSE = 4,
+        AVX = 8,
+    };
+
+    // Binned surface area heuristic over triangle centroids, leaves hold at most one packet
+    [[nodiscard]] MeshBVH buildMeshBVH(std::span<const VertexAsset> vertices, std::span<const unsigned int> indices);
+
+    // Whether a tree read from a file can be walked: every child and packet index is in range and right children come
+    // after their left subtree, so traversal never revisits a node
+    [[nodiscard]] bool validateMeshBVH(std::span<const MeshBVHNode> nodes, std::span<const MeshTrianglePacket> packets);
+
+    // Widest lane group this build and CPU have, detected once
+    [[nodiscard]] TriangleLanes detectTriangleLanes();
+
+    // Closest triangle the ray hits before maxDistance, both sides count. Distance is in units of the direction length.
+    // The tree is one buildMeshBVH made or one that passed validateMeshBVH, indices aren't checked while walking it
+    [[nodiscard]] std::optional<MeshRayHit> intersectMeshBVH(std::span<const MeshBVHNode> nodes,
+                                                             std::span<const MeshTrianglePacket> packets,
+                                                             const glm::vec3& origin, const glm::vec3& direction,
+                                                             float maxDistance, TriangleLanes lanes);
+    [[nodiscard]] std::optional<MeshRayHit> intersectMeshBVH(std::span<const MeshBVHNode> nodes,
+                                                             std::span<const MeshTrianglePacket> packets,
+                                                             const glm::vec3& origin, const glm::vec3& direction,
+                                                             float maxDistance);
+}
+
+#endif //MESHBVH_HPP
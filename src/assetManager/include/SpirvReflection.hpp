@@ -0,0 +1,75 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef SPIRVREFLECTION_HPP
+#define SPIRVREFLECTION_HPP
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace am
+{
+    enum class ShaderResourceType : uint8_t {
+        Sampler,
+        SampledImage,
+        CombinedImageSampler,
+        StorageImage,
+        UniformTexelBuffer,
+        StorageTexelBuffer,
+        UniformBuffer,
+        StorageBuffer,
+        InputAttachment
+    };
+
+    // SPIR-V Dim values, None for resources that aren't images
+    enum class ShaderImageDimension : uint8_t {
+        Dim1D = 0,
+        Dim2D = 1,
+        Dim3D = 2,
+        Cube = 3,
+        Rect = 4,
+        Buffer = 5,
+        SubpassData = 6,
+        None = 0xFF
+    };
+
+    struct ShaderResourceBinding {
+        uint32_t set = 0;
+        uint32_t binding = 0;
+        ShaderResourceType type = ShaderResourceType::UniformBuffer;
+        ShaderImageDimension dimension = ShaderImageDimension::None;
+        uint32_t count = 1;    // Array length, 0 for a runtime sized array
+        std::string name;      // Variable name, the block name for buffers, empty when stripped
+    };
+
+    struct ShaderPushConstantBlock {
+        std::string name;      // Block type name, e.g. ModelPushConstant
+        uint32_t size = 0;     // End of the last member, offsets included
+    };
+
+    // What a SPIR-V module declares to the pipeline. Everything declared is reported, whether the entry point reads it or not
+    struct ShaderReflection {
+        std::vector<ShaderResourceBinding> bindings;   // Sorted by set, then binding
+        std::optional<ShaderPushConstantBlock> pushConstants;
+        uint32_t inputLocations = 0;                   // Bit per user input location below 32, built-ins left out
+        bool multiview = false;                        // Declares the MultiView capability
+
+        [[nodiscard]] uint32_t getSetMask() const {
+            uint32_t mask = 0;
+            for (const auto& binding : bindings) {
+                mask |= binding.set < 32 ? 1u << binding.set : 0;
+            }
+            return mask;
+        }
+    };
+
+    // Single pass over the module plus a walk of the types the resources point at.
+    // nullopt with an error logged if the words aren't a SPIR-V module
+    std::optional<ShaderReflection> reflectSpirv(std::span<const std::uint32_t> spirv);
+}
+
+#endif //SPIRVREFLECTION_HPP
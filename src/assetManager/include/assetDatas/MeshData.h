@@ -4,6 +4,12 @@
 
 #ifndef MESHDATA_H
 #define MESHDATA_H
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "BinaryContainer.hpp"
+#include "MeshBVH.hpp"
 #include "VertexAsset.hpp"
 
 
@@ -16,6 +22,33 @@ namespace am
         std::shared_ptr<am::AssetInfo> material;
         glm::vec3 boundingBoxMin;
         glm::vec3 boundingBoxMax;
+        // Triangle tree for exact ray hits, built at import and stored with the mesh
+        MeshBVH bvh;
+
+        // Set when loaded from a binary container. The vectors stay empty and the
+        // views below point straight into the mapping that is kept alive here.
+        std::shared_ptr<const MappedFile> mapping;
+        std::span<const am::VertexAsset> mappedVertices;
+        std::span<const unsigned int> mappedIndices;
+        std::span<const MeshBVHNode> mappedBvhNodes;
+        std::span<const MeshTrianglePacket> mappedBvhPackets;
+
+        [[nodiscard]] std::span<const am::VertexAsset> getVertices() const {
+            return mapping ? mappedVertices : std::span<const am::VertexAsset>(vertices);
+        }
+
+        [[nodiscard]] std::span<const unsigned int> getIndices() const {
+            return mapping ? mappedIndices : std::span<const unsigned int>(indices);
+        }
+
+        // Mapped files written before meshes had a tree get an owned one built on load
+        [[nodiscard]] std::span<const MeshBVHNode> getBvhNodes() const {
+            return mapping && !mappedBvhNodes.empty() ? mappedBvhNodes : std::span<const MeshBVHNode>(bvh.nodes);
+        }
+
+        [[nodiscard]] std::span<const MeshTrianglePacket> getBvhPackets() const {
+            return mapping && !mappedBvhNodes.empty() ? mappedBvhPackets : std::span<const MeshTrianglePacket>(bvh.packets);
+        }
     };
 }
 #endif //MESHDATA_H
@@ -8,6 +8,7 @@
 #include <glm/mat4x4.hpp>
 
 #include "../AssetInfo.hpp"
+#include "../ContentHash.hpp"
 
 namespace am
 {
@@ -20,34 +21,30 @@ namespace am
         std::vector<std::shared_ptr<AssetInfo>> meshes;
     };
 
-    [[nodiscard]] inline size_t CalculateContentHash(Node node)
+    inline void HashNodeContent(const Node& node, ContentHasher& hasher)
     {
-        size_t hash = 0;
-        hash ^= std::hash<std::string>{} (node.mName);
-        for (int x = 0; x < 4; ++x)
-        {
-            for (int y = 0; y < 4; ++y)
-            {
-                hash ^= std::hash<float>{} (node.mTransformation[x][y]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            }
-        }
+        hasher.addString(node.mName);
+        hasher.add(node.mTransformation);
 
-        // Hash vertices
+        // Meshes by their content, so re-importing them under new ids keeps the hash
+        hasher.add(static_cast<uint64_t>(node.meshes.size()));
         for (const auto &mesh: node.meshes)
         {
-            // Combine hash with vertex data
-
-            hash ^= std::hash<float>{}(mesh->contentHash) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            hasher.add(static_cast<uint64_t>(mesh->contentHash));
         }
 
-        for (const auto &node: node.mChildren)
+        hasher.add(static_cast<uint64_t>(node.mChildren.size()));
+        for (const auto &child: node.mChildren)
         {
-            // Combine hash with vertex data
-
-            hash ^= std::hash<float>{}(CalculateContentHash(node)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            HashNodeContent(child, hasher);
         }
+    }
 
-        return hash;
+    [[nodiscard]] inline size_t CalculateContentHash(const Node& node)
+    {
+        ContentHasher hasher;
+        HashNodeContent(node, hasher);
+        return hasher.result();
     }
 }
 
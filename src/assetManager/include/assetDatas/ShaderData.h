@@ -6,8 +6,13 @@
 #define SHADERDATA_H
 #include <cstdint>
 #include <map>
+#include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
+#include "BinaryContainer.hpp"
+
 
 namespace am
 {
@@ -25,6 +30,15 @@ namespace am
         ShaderStage stage;
         std::map<std::string, std::string> defines;
         std::string originalSource; // Path to the original GLSL source file
+
+        // Set when loaded from a binary container, bytecode stays empty and the
+        // SPIR-V is read straight from the mapping kept alive here
+        std::shared_ptr<const MappedFile> mapping;
+        std::span<const std::uint32_t> mappedBytecode;
+
+        [[nodiscard]] std::span<const std::uint32_t> getBytecode() const {
+            return mapping ? mappedBytecode : std::span<const std::uint32_t>(bytecode);
+        }
     };
 }
 #endif //SHADERDATA_H
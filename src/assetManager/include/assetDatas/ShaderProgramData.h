@@ -1,13 +1,31 @@
 #ifndef SHADERPROGRAMDATA_H
 #define SHADERPROGRAMDATA_H
 
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 #include "AssetTypes.hpp"
+#include "ShaderData.h"
 
 namespace am {
     class AssetInfo;
 
+    constexpr size_t kShaderStageCount = 6;
+    constexpr uint32_t kMaxPermutationAxes = 16;
+    constexpr uint32_t kNoShaderModule = UINT32_MAX;
+
+    // One compiled combination of a program's permutation axes, bit i of the mask is set when axis i is on
+    struct ShaderProgramVariant {
+        uint32_t mask = 0;
+        // Index into ShaderProgramData::modules per ShaderStage, kNoShaderModule for the stages the program doesn't have
+        std::array<uint32_t, kShaderStageCount> modules{};
+    };
+
     struct ShaderProgramData {
         std::shared_ptr<am::AssetInfo> vertexShader;
         std::shared_ptr<am::AssetInfo> fragmentShader;
@@ -15,6 +33,34 @@ namespace am {
         std::shared_ptr<am::AssetInfo> geometryShader;
         std::shared_ptr<am::AssetInfo> tessellationControlShader;
         std::shared_ptr<am::AssetInfo> tessellationEvaluationShader;
+
+        // Defines the variants switch, in bit order. Empty for a program without permutations
+        std::vector<std::string> permutationAxes;
+        // Only the combinations the program declared reachable, sorted by mask
+        std::vector<ShaderProgramVariant> variants;
+        // SPIR-V the variants point into, a module several variants compile to is kept once
+        std::vector<ShaderData> modules;
+
+        // 0 for an axis the program doesn't have, so asking for it selects nothing
+        [[nodiscard]] uint32_t getPermutationBit(std::string_view axis) const {
+            const auto it = std::ranges::find(permutationAxes, axis);
+            return it == permutationAxes.end() ? 0 : 1u << static_cast<uint32_t>(it - permutationAxes.begin());
+        }
+
+        // nullptr when the combination wasn't compiled, the caller falls back to the program's own stages
+        [[nodiscard]] const ShaderProgramVariant* findVariant(uint32_t mask) const {
+            const auto it = std::ranges::lower_bound(variants, mask, {}, &ShaderProgramVariant::mask);
+            return it != variants.end() && it->mask == mask ? &*it : nullptr;
+        }
+
+        [[nodiscard]] std::span<const std::uint32_t> getVariantBytecode(uint32_t mask, ShaderStage stage) const {
+            const auto* variant = findVariant(mask);
+            if (!variant) {
+                return {};
+            }
+            const uint32_t module = variant->modules[static_cast<size_t>(stage)];
+            return module == kNoShaderModule ? std::span<const std::uint32_t>() : modules[module].getBytecode();
+        }
     };
 }
 
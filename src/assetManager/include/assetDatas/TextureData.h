@@ -4,9 +4,14 @@
 
 #ifndef TEXTUREDATA_H
 #define TEXTUREDATA_H
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
+#include "BinaryContainer.hpp"
+
 
 namespace am
 {
@@ -15,13 +20,46 @@ namespace am
         TextureCube
     };
 
+    enum class MipFilter : uint32_t {
+        Box,
+        Kaiser
+    };
+
+    // One level of the mip chain, offset is in texels into TextureData::pixels
+    struct TextureMipLevel {
+        uint32_t width{0};
+        uint32_t height{0};
+        uint64_t offset{0};
+    };
+
     struct TextureData {
+        // One packed RGBA8 texel per element, all mip levels stored back to back
         std::vector<std::uint32_t> pixels;
         uint32_t width{0};
         uint32_t height{0};
         uint32_t channels{0};
         bool hasAlpha{false};
         TextureType type;
+
+        // Mip generation settings, applied at import time
+        MipFilter mipFilter{MipFilter::Kaiser};
+        bool srgb{true};
+        float alphaCutoff{0.5f}; // <= 0 disables alpha coverage preservation
+
+        std::vector<TextureMipLevel> mips;
+
+        // Set when loaded from a binary container, pixels stays empty and the
+        // texels are read straight from the mapping kept alive here
+        std::shared_ptr<const MappedFile> mapping;
+        std::span<const std::uint32_t> mappedPixels;
+
+        [[nodiscard]] std::span<const std::uint32_t> getPixels() const {
+            return mapping ? mappedPixels : std::span<const std::uint32_t>(pixels);
+        }
+
+        [[nodiscard]] uint32_t mipLevels() const {
+            return mips.empty() ? 1u : static_cast<uint32_t>(mips.size());
+        }
     };
 }
 #endif //TEXTUREDATA_H
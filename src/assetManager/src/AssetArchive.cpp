@@ -0,0 +1,281 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "AssetArchive.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <lz4.h>
+#include <unordered_set>
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <spdlog/spdlog.h>
+
+namespace am
+{
+    namespace
+    {
+        constexpr uint32_t kEmptyBucket = UINT32_MAX;
+
+        bool readWholeFile(const std::string& path, std::vector<char>& out)
+        {
+            std::ifstream ifs(path, std::ios::binary | std::ios::in | std::ios::ate);
+            if (!ifs.is_open())
+                return false;
+
+            const auto size = static_cast<size_t>(ifs.tellg());
+            ifs.seekg(0);
+            out.resize(size);
+            ifs.read(out.data(), static_cast<std::streamsize>(size));
+            return static_cast<bool>(ifs);
+        }
+    }
+
+    uint64_t AssetArchive::hashId(const boost::uuids::uuid& id)
+    {
+        // Stored on disk, so this must not depend on the standard library's hash
+        uint64_t halves[2];
+        std::memcpy(halves, &id, sizeof(halves));
+
+        uint64_t h = halves[0] ^ (halves[1] * 0x9E3779B97F4A7C15ull);
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        return h;
+    }
+
+    AssetArchive::AssetArchive(std::shared_ptr<const MappedFile> file) : file(std::move(file))
+    {
+    }
+
+    std::unique_ptr<AssetArchive> AssetArchive::open(const std::string& path)
+    {
+        auto file = MappedFile::open(path);
+        if (!file)
+            return nullptr;
+
+        const auto bytes = file->bytes();
+        if (bytes.size() < sizeof(ArchiveHeader)) {
+            spdlog::error("Asset archive is too small: {}", path);
+            return nullptr;
+        }
+
+        ArchiveHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (header.magic != kAssetArchiveMagic || header.version != kAssetArchiveVersion || header.headerSize < sizeof(ArchiveHeader)) {
+            spdlog::error("Not a supported asset archive: {}", path);
+            return nullptr;
+        }
+
+        const uint64_t entriesBytes = static_cast<uint64_t>(header.entryCount) * sizeof(ArchiveEntry);
+        const uint64_t bucketsBytes = static_cast<uint64_t>(header.bucketCount) * sizeof(uint32_t);
+        if (!std::has_single_bit(header.bucketCount) || header.bucketCount < header.entryCount ||
+            header.entriesOffset % alignof(ArchiveEntry) != 0 || header.bucketsOffset % alignof(uint32_t) != 0 ||
+            header.entriesOffset > bytes.size() || entriesBytes > bytes.size() - header.entriesOffset ||
+            header.bucketsOffset > bytes.size() || bucketsBytes > bytes.size() - header.bucketsOffset) {
+            spdlog::error("Corrupt table of contents in asset archive: {}", path);
+            return nullptr;
+        }
+
+        std::unique_ptr<AssetArchive> archive(new AssetArchive(file));
+        archive->entries = {reinterpret_cast<const ArchiveEntry*>(bytes.data() + header.entriesOffset), header.entryCount};
+        archive->buckets = {reinterpret_cast<const uint32_t*>(bytes.data() + header.bucketsOffset), header.bucketCount};
+
+        for (const auto& entry : archive->entries) {
+            const bool knownCompression = entry.compression == static_cast<uint32_t>(ArchiveCompression::None) ||
+                                          entry.compression == static_cast<uint32_t>(ArchiveCompression::LZ4);
+            if (!knownCompression || entry.offset > bytes.size() || entry.storedSize > bytes.size() - entry.offset) {
+                spdlog::error("Corrupt entry in asset archive: {}", path);
+                return nullptr;
+            }
+        }
+        for (uint32_t index : archive->buckets) {
+            if (index != kEmptyBucket && index >= header.entryCount) {
+                spdlog::error("Corrupt hash table in asset archive: {}", path);
+                return nullptr;
+            }
+        }
+
+        spdlog::info("Mounted asset archive {} with {} entries", path, header.entryCount);
+        return archive;
+    }
+
+    const ArchiveEntry* AssetArchive::find(const boost::uuids::uuid& id) const
+    {
+        if (buckets.empty())
+            return nullptr;
+
+        const size_t mask = buckets.size() - 1;
+        size_t slot = static_cast<size_t>(hashId(id)) & mask;
+        for (size_t probe = 0; probe < buckets.size(); ++probe) {
+            const uint32_t index = buckets[slot];
+            if (index == kEmptyBucket)
+                return nullptr;
+            if (std::memcmp(entries[index].uuid, &id, sizeof(entries[index].uuid)) == 0)
+                return &entries[index];
+            slot = (slot + 1) & mask;
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<const MappedFile> AssetArchive::openEntry(const boost::uuids::uuid& id) const
+    {
+        const ArchiveEntry* entry = find(id);
+        if (!entry)
+            return nullptr;
+
+        std::string name = file->getPath() + ":" + boost::uuids::to_string(id);
+
+        if (entry->compression == static_cast<uint32_t>(ArchiveCompression::None))
+            return MappedFile::slice(file, entry->offset, entry->storedSize, std::move(name));
+
+        if (entry->size > static_cast<uint64_t>(LZ4_MAX_INPUT_SIZE) || entry->storedSize > static_cast<uint64_t>(INT32_MAX)) {
+            spdlog::error("Compressed archive entry is too large: {}", name);
+            return nullptr;
+        }
+
+        auto buffer = MappedFile::allocate(static_cast<size_t>(entry->size), name);
+        auto destination = buffer->writableBytes();
+        const int decompressed = LZ4_decompress_safe(reinterpret_cast<const char*>(file->bytes().data() + entry->offset),
+                                                     reinterpret_cast<char*>(destination.data()),
+                                                     static_cast<int>(entry->storedSize), static_cast<int>(entry->size));
+        if (decompressed < 0 || static_cast<uint64_t>(decompressed) != entry->size) {
+            spdlog::error("Failed to decompress archive entry: {}", name);
+            return nullptr;
+        }
+        return buffer;
+    }
+
+    bool AssetArchive::build(const std::string& path, const std::vector<BuildEntry>& buildEntries, const BuildSettings& settings)
+    {
+        if (!std::has_single_bit(settings.alignment) || settings.alignment < kBinaryContainerAlignment) {
+            spdlog::error("Asset archive alignment must be a power of two of at least {}", kBinaryContainerAlignment);
+            return false;
+        }
+
+        // Drop duplicates up front so the table of contents can be sized exactly
+        std::vector<const BuildEntry*> unique;
+        std::unordered_set<boost::uuids::uuid, boost::hash<boost::uuids::uuid>> seen;
+        unique.reserve(buildEntries.size());
+        for (const auto& entry : buildEntries) {
+            if (seen.insert(entry.id).second)
+                unique.push_back(&entry);
+            else
+                spdlog::warn("Asset {} listed twice for archive {}", boost::uuids::to_string(entry.id), path);
+        }
+
+        ArchiveHeader header{};
+        header.magic = kAssetArchiveMagic;
+        header.version = kAssetArchiveVersion;
+        header.headerSize = sizeof(ArchiveHeader);
+        header.bucketCount = std::bit_ceil(std::max<uint32_t>(static_cast<uint32_t>(unique.size()) * 2, 1));
+        header.entriesOffset = alignBinaryOffset(sizeof(ArchiveHeader));
+        header.alignment = settings.alignment;
+
+        const std::string tempPath = path + ".tmp";
+        std::ofstream ofs(tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!ofs.is_open()) {
+            spdlog::error("Failed to open asset archive for writing: {}", tempPath);
+            return false;
+        }
+
+        // The table of contents is written last, reserve the largest size it can have
+        const uint64_t maxBucketsOffset = header.entriesOffset + unique.size() * sizeof(ArchiveEntry);
+        uint64_t cursor = maxBucketsOffset + static_cast<uint64_t>(header.bucketCount) * sizeof(uint32_t);
+        const std::vector<char> padding(settings.alignment, 0);
+        for (uint64_t written = 0; written < cursor;) {
+            const auto chunk = std::min<uint64_t>(cursor - written, padding.size());
+            ofs.write(padding.data(), static_cast<std::streamsize>(chunk));
+            written += chunk;
+        }
+
+        std::vector<ArchiveEntry> entries;
+        entries.reserve(unique.size());
+        std::vector<char> contents;
+        std::vector<char> compressed;
+        uint64_t rawBytes = 0;
+
+        for (const BuildEntry* buildEntry : unique) {
+            if (!readWholeFile(buildEntry->path, contents)) {
+                spdlog::error("Failed to read {} for asset archive, skipping it", buildEntry->path);
+                continue;
+            }
+            rawBytes += contents.size();
+
+            ArchiveEntry entry{};
+            std::memcpy(entry.uuid, &buildEntry->id, sizeof(entry.uuid));
+            entry.assetType = static_cast<uint32_t>(buildEntry->type);
+            entry.compression = static_cast<uint32_t>(ArchiveCompression::None);
+            entry.size = contents.size();
+
+            const char* payload = contents.data();
+            uint64_t payloadSize = contents.size();
+
+            const bool isBinary = BinaryContainerReader::isContainer(std::as_bytes(std::span(contents)));
+            if (settings.compression == ArchiveCompression::LZ4 && (!isBinary || settings.compressBinaryAssets) &&
+                !contents.empty() && contents.size() <= static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+                compressed.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(contents.size()))));
+                const int compressedSize = LZ4_compress_default(contents.data(), compressed.data(),
+                                                                static_cast<int>(contents.size()), static_cast<int>(compressed.size()));
+                if (compressedSize > 0 &&
+                    static_cast<float>(compressedSize) <= static_cast<float>(contents.size()) * (1.0f - settings.minCompressionSavings)) {
+                    entry.compression = static_cast<uint32_t>(ArchiveCompression::LZ4);
+                    payload = compressed.data();
+                    payloadSize = static_cast<uint64_t>(compressedSize);
+                }
+            }
+
+            const uint64_t aligned = (cursor + settings.alignment - 1) & ~(settings.alignment - 1);
+            ofs.write(padding.data(), static_cast<std::streamsize>(aligned - cursor));
+            ofs.write(payload, static_cast<std::streamsize>(payloadSize));
+
+            entry.offset = aligned;
+            entry.storedSize = payloadSize;
+            cursor = aligned + payloadSize;
+            entries.push_back(entry);
+        }
+
+        // Hash table over the entries that made it in
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.bucketsOffset = header.entriesOffset + entries.size() * sizeof(ArchiveEntry);
+        std::vector<uint32_t> buckets(header.bucketCount, kEmptyBucket);
+        const size_t mask = buckets.size() - 1;
+        for (uint32_t i = 0; i < entries.size(); ++i) {
+            boost::uuids::uuid id;
+            std::memcpy(&id, entries[i].uuid, sizeof(entries[i].uuid));
+            size_t slot = static_cast<size_t>(hashId(id)) & mask;
+            while (buckets[slot] != kEmptyBucket)
+                slot = (slot + 1) & mask;
+            buckets[slot] = i;
+        }
+
+        ofs.seekp(0);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ofs.seekp(static_cast<std::streamoff>(header.entriesOffset));
+        ofs.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(ArchiveEntry)));
+        ofs.write(reinterpret_cast<const char*>(buckets.data()), static_cast<std::streamsize>(buckets.size() * sizeof(uint32_t)));
+        ofs.close();
+
+        if (!ofs) {
+            spdlog::error("Failed to write asset archive: {}", tempPath);
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            spdlog::error("Failed to replace asset archive {}: {}", path, error.message());
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+
+        spdlog::info("Packed {} assets into {} ({} bytes loose, {} bytes packed)", entries.size(), path, rawBytes, cursor);
+        return true;
+    }
+}
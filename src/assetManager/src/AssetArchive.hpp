@@ -0,0 +1,97 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef ASSETARCHIVE_HPP
+#define ASSETARCHIVE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <boost/uuid/uuid.hpp>
+
+#include "../include/AssetTypes.hpp"
+#include "../include/BinaryContainer.hpp"
+
+namespace am
+{
+    enum class ArchiveCompression : uint32_t {
+        None,
+        LZ4
+    };
+
+    constexpr uint32_t kAssetArchiveMagic = makeFourCC('R', 'P', 'A', 'K');
+    constexpr uint16_t kAssetArchiveVersion = 1;
+
+    // On disk layout:
+    //   ArchiveHeader | ArchiveEntry[entryCount] | uint32 buckets[bucketCount] | entry data
+    // The bucket array is an open addressing hash table of entry indices keyed by uuid,
+    // so a lookup touches one or two cache lines of the mapping instead of building a map on mount.
+    struct ArchiveHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;
+        uint32_t entryCount;
+        uint32_t bucketCount;       // Power of two
+        uint64_t entriesOffset;
+        uint64_t bucketsOffset;
+        uint64_t alignment;         // Every entry's data starts on a multiple of this
+        uint64_t reserved;
+    };
+    static_assert(sizeof(ArchiveHeader) == 48);
+
+    struct ArchiveEntry {
+        uint8_t uuid[16];
+        uint32_t assetType;         // AssetType
+        uint32_t compression;       // ArchiveCompression
+        uint64_t offset;            // From the start of the archive
+        uint64_t storedSize;        // Bytes in the archive
+        uint64_t size;              // Bytes once decompressed
+    };
+    static_assert(sizeof(ArchiveEntry) == 48);
+
+    // Read only archive of packed asset files, mapped once on mount
+    class AssetArchive
+    {
+    public:
+        struct BuildEntry {
+            boost::uuids::uuid id;
+            AssetType type;
+            std::string path;           // Loose file that gets packed
+        };
+
+        struct BuildSettings {
+            ArchiveCompression compression = ArchiveCompression::None;
+            // Binary containers stored raw are used in place from the mapping, compressing
+            // them trades that for a smaller archive and a copy on load
+            bool compressBinaryAssets = false;
+            float minCompressionSavings = 0.1f;     // Entries that shrink less than this are stored raw
+            uint64_t alignment = kBinaryContainerAlignment;
+        };
+
+        static std::unique_ptr<AssetArchive> open(const std::string& path);
+        static bool build(const std::string& path, const std::vector<BuildEntry>& entries, const BuildSettings& settings);
+
+        [[nodiscard]] const ArchiveEntry* find(const boost::uuids::uuid& id) const;
+        [[nodiscard]] bool contains(const boost::uuids::uuid& id) const { return find(id) != nullptr; }
+
+        // Raw entries are slices of the archive mapping, compressed ones are decompressed into their own buffer
+        [[nodiscard]] std::shared_ptr<const MappedFile> openEntry(const boost::uuids::uuid& id) const;
+
+        [[nodiscard]] uint32_t getEntryCount() const { return static_cast<uint32_t>(entries.size()); }
+        [[nodiscard]] const std::string& getPath() const { return file->getPath(); }
+
+        static uint64_t hashId(const boost::uuids::uuid& id);
+
+    private:
+        explicit AssetArchive(std::shared_ptr<const MappedFile> file);
+
+        std::shared_ptr<const MappedFile> file;
+        std::span<const ArchiveEntry> entries;
+        std::span<const uint32_t> buckets;
+    };
+}
+
+#endif //ASSETARCHIVE_HPP
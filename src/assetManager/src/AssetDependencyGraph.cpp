@@ -0,0 +1,156 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "AssetDependencyGraph.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+namespace am
+{
+    std::string AssetDependencyGraph::normalizePath(const std::string& path)
+    {
+        std::error_code error;
+        const auto absolute = std::filesystem::absolute(path, error);
+        return (error ? std::filesystem::path(path) : absolute).lexically_normal().string();
+    }
+
+    void AssetDependencyGraph::record(const boost::uuids::uuid& id, const std::vector<boost::uuids::uuid>& dependencies,
+                                      const std::vector<std::string>& sourceFiles)
+    {
+        std::unique_lock lock(mutex);
+        Node& node = nodes[id];
+        unlinkLocked(id, node);
+
+        for (const auto& dependency : dependencies) {
+            if (dependency == id || std::ranges::find(node.dependencies, dependency) != node.dependencies.end())
+                continue;
+            node.dependencies.push_back(dependency);
+            nodes[dependency].dependents.push_back(id);
+        }
+        for (const auto& sourceFile : sourceFiles) {
+            std::string normalized = normalizePath(sourceFile);
+            if (std::ranges::find(node.sourceFiles, normalized) != node.sourceFiles.end())
+                continue;
+            readers[normalized].push_back(id);
+            node.sourceFiles.push_back(std::move(normalized));
+        }
+    }
+
+    void AssetDependencyGraph::addSourceFile(const boost::uuids::uuid& id, const std::string& sourceFile)
+    {
+        std::unique_lock lock(mutex);
+        Node& node = nodes[id];
+        std::string normalized = normalizePath(sourceFile);
+        if (std::ranges::find(node.sourceFiles, normalized) != node.sourceFiles.end())
+            return;
+        readers[normalized].push_back(id);
+        node.sourceFiles.push_back(std::move(normalized));
+    }
+
+    void AssetDependencyGraph::remove(const boost::uuids::uuid& id)
+    {
+        std::unique_lock lock(mutex);
+        auto it = nodes.find(id);
+        if (it == nodes.end())
+            return;
+
+        unlinkLocked(id, it->second);
+        // Assets still depending on it keep their edge, a node without anything left is dropped
+        if (it->second.dependents.empty())
+            nodes.erase(it);
+    }
+
+    void AssetDependencyGraph::unlinkLocked(const boost::uuids::uuid& id, Node& node)
+    {
+        for (const auto& dependency : node.dependencies) {
+            auto it = nodes.find(dependency);
+            if (it != nodes.end())
+                std::erase(it->second.dependents, id);
+        }
+        for (const auto& sourceFile : node.sourceFiles) {
+            auto it = readers.find(sourceFile);
+            if (it == readers.end())
+                continue;
+            std::erase(it->second, id);
+            if (it->second.empty())
+                readers.erase(it);
+        }
+        node.dependencies.clear();
+        node.sourceFiles.clear();
+    }
+
+    std::vector<boost::uuids::uuid> AssetDependencyGraph::getDependents(const boost::uuids::uuid& id) const
+    {
+        std::shared_lock lock(mutex);
+        auto it = nodes.find(id);
+        return it != nodes.end() ? it->second.dependents : std::vector<boost::uuids::uuid>{};
+    }
+
+    std::vector<boost::uuids::uuid> AssetDependencyGraph::getReaders(const std::string& sourceFile) const
+    {
+        std::shared_lock lock(mutex);
+        auto it = readers.find(normalizePath(sourceFile));
+        return it != readers.end() ? it->second : std::vector<boost::uuids::uuid>{};
+    }
+
+    std::vector<std::string> AssetDependencyGraph::getSourceFiles() const
+    {
+        std::shared_lock lock(mutex);
+        std::vector<std::string> sourceFiles;
+        sourceFiles.reserve(readers.size());
+        for (const auto& [sourceFile, ids] : readers)
+            sourceFiles.push_back(sourceFile);
+        return sourceFiles;
+    }
+
+    std::vector<boost::uuids::uuid> AssetDependencyGraph::collectAffected(const std::vector<std::string>& changedFiles) const
+    {
+        std::shared_lock lock(mutex);
+
+        // Readers of the files, then whatever depends on them, breadth first
+        std::vector<boost::uuids::uuid> found;
+        std::unordered_set<boost::uuids::uuid, UuidHash> affected;
+        for (const auto& changedFile : changedFiles) {
+            auto it = readers.find(normalizePath(changedFile));
+            if (it == readers.end())
+                continue;
+            for (const auto& id : it->second) {
+                if (affected.insert(id).second)
+                    found.push_back(id);
+            }
+        }
+        for (size_t i = 0; i < found.size(); ++i) {
+            auto it = nodes.find(found[i]);
+            if (it == nodes.end())
+                continue;
+            for (const auto& dependent : it->second.dependents) {
+                if (affected.insert(dependent).second)
+                    found.push_back(dependent);
+            }
+        }
+
+        // Depth first over the dependencies inside the affected set, an asset is emitted once everything it uses was
+        std::vector<boost::uuids::uuid> ordered;
+        ordered.reserve(found.size());
+        std::unordered_set<boost::uuids::uuid, UuidHash> visited;
+        std::function<void(const boost::uuids::uuid&)> visit = [&](const boost::uuids::uuid& id) {
+            if (!visited.insert(id).second)
+                return;
+            if (auto it = nodes.find(id); it != nodes.end()) {
+                for (const auto& dependency : it->second.dependencies) {
+                    if (affected.contains(dependency))
+                        visit(dependency);
+                }
+            }
+            ordered.push_back(id);
+        };
+        for (const auto& id : found)
+            visit(id);
+        return ordered;
+    }
+}
@@ -0,0 +1,59 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef ASSETDEPENDENCYGRAPH_HPP
+#define ASSETDEPENDENCYGRAPH_HPP
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+namespace am
+{
+    // What every asset was built from, recorded as assets are imported and loaded: the assets it references
+    // (model -> meshes -> material -> textures, program -> shaders) and the files it read (import path, shader includes).
+    // Edges are kept both ways so a changed file leads to everything that has to be rebuilt. Safe to use from any thread
+    class AssetDependencyGraph
+    {
+    public:
+        // Replaces whatever was recorded for the asset before, what depends on it is kept
+        void record(const boost::uuids::uuid& id, const std::vector<boost::uuids::uuid>& dependencies,
+                    const std::vector<std::string>& sourceFiles);
+        // Adds a file without touching the rest, for assets known from the registry but not loaded yet
+        void addSourceFile(const boost::uuids::uuid& id, const std::string& sourceFile);
+        void remove(const boost::uuids::uuid& id);
+
+        [[nodiscard]] std::vector<boost::uuids::uuid> getDependents(const boost::uuids::uuid& id) const;
+        [[nodiscard]] std::vector<boost::uuids::uuid> getReaders(const std::string& sourceFile) const;
+        // Every recorded file, normalized
+        [[nodiscard]] std::vector<std::string> getSourceFiles() const;
+
+        // Assets that read any of the files and everything depending on them, each one after the assets it depends on
+        [[nodiscard]] std::vector<boost::uuids::uuid> collectAffected(const std::vector<std::string>& changedFiles) const;
+
+        // Absolute and lexically normal, so a file reached through different relative paths or includes is one node
+        static std::string normalizePath(const std::string& path);
+
+    private:
+        using UuidHash = boost::hash<boost::uuids::uuid>;
+
+        struct Node {
+            std::vector<boost::uuids::uuid> dependencies;
+            std::vector<boost::uuids::uuid> dependents;
+            std::vector<std::string> sourceFiles;
+        };
+
+        // The caller holds the unique lock
+        void unlinkLocked(const boost::uuids::uuid& id, Node& node);
+
+        mutable std::shared_mutex mutex;
+        std::unordered_map<boost::uuids::uuid, Node, UuidHash> nodes;
+        std::unordered_map<std::string, std::vector<boost::uuids::uuid>> readers;
+    };
+}
+
+#endif //ASSETDEPENDENCYGRAPH_HPP
@@ -50,6 +50,8 @@ void am::AssetInfo::SerializeAssetInfoToJson(rapidjson::Value& obj, rapidjson::D
     obj.AddMember("type", rapidjson::Value(AssetTypeToString(type).c_str(), allocator), allocator);
     obj.AddMember("lookUpName", rapidjson::Value(lookUpName.c_str(), allocator), allocator);
     obj.AddMember("contentHash", rapidjson::Value(static_cast<uint64_t>(contentHash)), allocator);
+    if (sourceHash != 0)
+        obj.AddMember("sourceHash", rapidjson::Value(sourceHash), allocator);
 
     // Add AssetFactoryData
     rapidjson::Value factoryDataObj(rapidjson::kObjectType);
@@ -79,6 +81,8 @@ am::AssetInfo am::AssetInfo::DeserializeAssetInfoFromJson(const rapidjson::Value
 
     AssetInfo info(id, path, type, contentHash, assetFactoryData, lookUpName);
     info.isLoaded = false;
+    if (obj.HasMember("sourceHash") && obj["sourceHash"].IsUint64())
+        info.sourceHash = obj["sourceHash"].GetUint64();
 
     return info;
 }
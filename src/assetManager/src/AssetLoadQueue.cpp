@@ -0,0 +1,195 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "AssetLoadQueue.hpp"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "../include/Asset.hpp"
+
+namespace am
+{
+    void AssetLoadRequest::finishOne()
+    {
+        if (pending.fetch_sub(1) != 1)
+            return;
+
+        AssetLoadState expected = AssetLoadState::Loading;
+        state.compare_exchange_strong(expected, asset.load() ? AssetLoadState::Ready : AssetLoadState::Failed);
+
+        std::vector<std::shared_ptr<AssetLoadRequest>> waiting;
+        {
+            std::lock_guard lock(mutex);
+            done = true;
+            waiting.swap(dependents);
+        }
+        settled.notify_all();
+
+        // A dependency failing doesn't fail the asset, whoever uses it falls back to loading it synchronously
+        for (const auto& dependent : waiting)
+            dependent->finishOne();
+    }
+
+    boost::uuids::uuid AssetLoadHandle::getId() const
+    {
+        return request ? request->id : boost::uuids::uuid{};
+    }
+
+    AssetLoadState AssetLoadHandle::getState() const
+    {
+        return request ? request->state.load() : AssetLoadState::Failed;
+    }
+
+    bool AssetLoadHandle::isDone() const
+    {
+        if (!request)
+            return true;
+        std::lock_guard lock(request->mutex);
+        return request->done;
+    }
+
+    Asset* AssetLoadHandle::get() const
+    {
+        return isReady() ? request->asset.load() : nullptr;
+    }
+
+    Asset* AssetLoadHandle::wait() const
+    {
+        if (!request)
+            return nullptr;
+
+        std::unique_lock lock(request->mutex);
+        request->settled.wait(lock, [this]() { return request->done; });
+        lock.unlock();
+        return get();
+    }
+
+    bool AssetLoadHandle::cancel() const
+    {
+        if (!request)
+            return false;
+
+        AssetLoadState expected = AssetLoadState::Queued;
+        if (!request->state.compare_exchange_strong(expected, AssetLoadState::Cancelled))
+            return false;
+
+        // The worker skips it when it comes off the queue, settle it now so nobody waits on it
+        request->finishOne();
+        return true;
+    }
+
+    AssetLoadQueue::AssetLoadQueue(LoadFunction load, unsigned int threadCount) : loadFunction(std::move(load))
+    {
+        threadCount = std::max(1u, threadCount);
+        workers.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; ++i)
+            workers.emplace_back([this](std::stop_token stopToken) { workerLoop(stopToken); });
+    }
+
+    AssetLoadQueue::~AssetLoadQueue()
+    {
+        for (auto& worker : workers)
+            worker.request_stop();
+        wake.notify_all();
+        workers.clear();
+
+        // Whatever never started is cancelled so handles held elsewhere don't wait forever
+        while (!queue.empty()) {
+            AssetLoadHandle(queue.top().request).cancel();
+            queue.pop();
+        }
+    }
+
+    AssetLoadHandle AssetLoadQueue::request(const boost::uuids::uuid& id, LoadPriority priority)
+    {
+        return AssetLoadHandle(enqueue(id, priority));
+    }
+
+    size_t AssetLoadQueue::getQueuedCount() const
+    {
+        std::lock_guard lock(mutex);
+        return queue.size();
+    }
+
+    std::shared_ptr<AssetLoadRequest> AssetLoadQueue::enqueue(const boost::uuids::uuid& id, LoadPriority priority)
+    {
+        std::lock_guard lock(mutex);
+
+        auto it = inFlight.find(id);
+        if (it != inFlight.end()) {
+            if (auto existing = it->second.lock()) {
+                const AssetLoadState state = existing->state.load();
+                if (state != AssetLoadState::Cancelled && state != AssetLoadState::Failed) {
+                    // Push it again at the new priority, the stale entry is skipped once it is no longer queued
+                    if (state == AssetLoadState::Queued && priority > existing->priority.load()) {
+                        existing->priority = priority;
+                        queue.push({priority, nextSequence++, existing});
+                        wake.notify_one();
+                    }
+                    return existing;
+                }
+            }
+        }
+
+        if (inFlight.size() >= pruneThreshold) {
+            std::erase_if(inFlight, [](const auto& entry) { return entry.second.expired(); });
+            pruneThreshold = std::max<size_t>(64, inFlight.size() * 2);
+        }
+
+        auto request = std::make_shared<AssetLoadRequest>(id, priority);
+        inFlight[id] = request;
+        queue.push({priority, nextSequence++, request});
+        wake.notify_one();
+        return request;
+    }
+
+    void AssetLoadQueue::workerLoop(std::stop_token stopToken)
+    {
+        while (true) {
+            std::shared_ptr<AssetLoadRequest> request;
+            {
+                std::unique_lock lock(mutex);
+                if (!wake.wait(lock, stopToken, [this]() { return !queue.empty(); }) || stopToken.stop_requested())
+                    return;
+                request = queue.top().request;
+                queue.pop();
+            }
+            load(request);
+        }
+    }
+
+    void AssetLoadQueue::load(const std::shared_ptr<AssetLoadRequest>& request)
+    {
+        // Cancelled, or a duplicate entry left behind by a priority bump
+        AssetLoadState expected = AssetLoadState::Queued;
+        if (!request->state.compare_exchange_strong(expected, AssetLoadState::Loading))
+            return;
+
+        Asset* asset = nullptr;
+        try {
+            asset = loadFunction(request->id);
+        } catch (const std::exception& e) {
+            spdlog::error("Failed to load asset {} asynchronously: {}", boost::uuids::to_string(request->id), e.what());
+        }
+        request->asset = asset;
+
+        if (asset) {
+            for (const auto& dependencyId : asset->getDependencies()) {
+                auto dependency = enqueue(dependencyId, request->priority.load());
+
+                // Registered before checking done, so a dependency settling concurrently can't be missed
+                std::lock_guard lock(dependency->mutex);
+                if (!dependency->done) {
+                    request->pending.fetch_add(1);
+                    dependency->dependents.push_back(request);
+                }
+                request->dependencies.push_back(std::move(dependency));
+            }
+        }
+
+        request->finishOne();
+    }
+}
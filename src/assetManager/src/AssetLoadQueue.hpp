@@ -0,0 +1,71 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef ASSETLOADQUEUE_HPP
+#define ASSETLOADQUEUE_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <boost/functional/hash.hpp>
+
+#include "../include/AssetLoadHandle.hpp"
+
+namespace am
+{
+    // Priority ordered loads on a pool of worker threads. Once an asset is loaded its dependencies are
+    // queued at the same priority and its request settles when all of them have.
+    class AssetLoadQueue
+    {
+    public:
+        // Called on the workers, returns nullptr on failure
+        using LoadFunction = std::function<Asset*(const boost::uuids::uuid&)>;
+
+        AssetLoadQueue(LoadFunction load, unsigned int threadCount);
+        ~AssetLoadQueue();
+
+        AssetLoadQueue(const AssetLoadQueue&) = delete;
+        AssetLoadQueue& operator=(const AssetLoadQueue&) = delete;
+
+        // Requests for an id that is already queued or loading share its state, a higher priority bumps it
+        AssetLoadHandle request(const boost::uuids::uuid& id, LoadPriority priority);
+
+        [[nodiscard]] size_t getQueuedCount() const;
+
+    private:
+        struct QueueEntry {
+            LoadPriority priority;
+            uint64_t sequence;
+            std::shared_ptr<AssetLoadRequest> request;
+
+            // Highest priority first, FIFO within a priority
+            bool operator<(const QueueEntry& other) const
+            {
+                if (priority != other.priority)
+                    return priority < other.priority;
+                return sequence > other.sequence;
+            }
+        };
+
+        std::shared_ptr<AssetLoadRequest> enqueue(const boost::uuids::uuid& id, LoadPriority priority);
+        void workerLoop(std::stop_token stopToken);
+        void load(const std::shared_ptr<AssetLoadRequest>& request);
+
+        LoadFunction loadFunction;
+
+        mutable std::mutex mutex;
+        std::condition_variable_any wake;
+        std::priority_queue<QueueEntry> queue;
+        std::unordered_map<boost::uuids::uuid, std::weak_ptr<AssetLoadRequest>, boost::hash<boost::uuids::uuid>> inFlight;
+        size_t pruneThreshold = 64;
+        uint64_t nextSequence = 0;
+
+        std::vector<std::jthread> workers;
+    };
+}
+
+#endif //ASSETLOADQUEUE_HPP
@@ -5,6 +5,12 @@
 #include "../include/Asset.hpp"
 #include "AssetManager.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include "ContentHash.hpp"
 #include <spdlog/spdlog.h>
 
 #include "assets/ModelAsset.h"
@@ -16,6 +22,35 @@
 #include "JsonHelpers.hpp"
 
 namespace am {
+    namespace {
+        constexpr const char* kRegistryPath = "C:\\Users\\redkc\\CLionProjects\\ReasonableVulkan\\res\\metadatas.json";
+
+        struct ThreadImporter {
+            Assimp::Importer importer;
+            std::string path;
+        };
+
+        ThreadImporter& getThreadImporter()
+        {
+            thread_local ThreadImporter threadImporter;
+            return threadImporter;
+        }
+
+        // Bump when an importer or its settings change, every cached import of that type is redone
+        constexpr uint32_t getImporterVersion(AssetType type)
+        {
+            switch (type) {
+            case AssetType::Mesh:
+                return 2;   // Container binaries
+            case AssetType::Texture:
+                return 2;   // Mip chains generated at import
+            case AssetType::Shader:
+                return 2;   // Container binaries
+            default:
+                return 1;
+            }
+        }
+    }
 
     AssetManager::AssetManager() : AssetManagerInterface()
     {
@@ -28,11 +63,13 @@ namespace am {
         RegisterAssetType<SceneAsset>();
         RegisterAssetType<PrefabAsset>();
 
-        loadRegistryMetadataFromFile("C:\\Users\\redkc\\CLionProjects\\ReasonableVulkan\\res\\metadatas.json");
+        openRegistry();
+        mountArchivesInDirectory(getRegistryDirectory());
     }
 
     AssetManager::~AssetManager() {
-        saveRegistryMetadataToFile("C:\\Users\\redkc\\CLionProjects\\ReasonableVulkan\\res\\metadatas.json");
+        // Every registration already reached the journal, nothing is left to write
+        loadQueue.reset();
     }
 
     std::optional<boost::uuids::uuid> AssetManager::createAsset(AssetType assetType, std::string path) {
@@ -43,13 +80,7 @@ namespace am {
 
         std::string lookUpName = baseName + GetExtensionFromAssetType(assetType);
 
-        int counter = 1;
-
-        while (lookupNamesToUUIDs.find(lookUpName) != lookupNamesToUUIDs.end())
-        {
-            lookUpName = baseName + "_" + std::to_string(counter) +  GetExtensionFromAssetType(assetType);
-            counter++;
-        }
+        lookUpName = makeUniqueLookupName(lookUpName);
 
         std::string normalizedPath = p.parent_path().string() + "/" + lookUpName;
 
@@ -59,7 +90,7 @@ namespace am {
     std::optional<boost::uuids::uuid> AssetManager::createAsset(AssetType assetType, string path, std::string lookupName) {
         std::filesystem::path p = std::filesystem::path(path).lexically_normal();
 
-        if (lookupNamesToUUIDs.find(lookupName) != lookupNamesToUUIDs.end())
+        if (getAssetUuid(lookupName))
         {
             spdlog::error("Lookup name already exists");
             throw std::runtime_error("Lookup name already exists");
@@ -93,7 +124,6 @@ namespace am {
                 std::string filename = GetBinPath(path, additionalSufix);
                 info->path = filename;
                 newAsset->SaveAssetToBin(filename);
-                metadata.insert(std::make_pair(id, info));
             }else
             {
                 rapidjson::Document doc;
@@ -101,11 +131,18 @@ namespace am {
                 newAsset->SaveAssetToJson(doc);
                 saveJsonToFile(path, doc);
                 info->path = path;
-                metadata.insert(std::make_pair(id, info));
             }
-            lookupNamesToUUIDs.insert(std::make_pair(lookupName, id));
-            assets[id] = std::move(newAsset);
-            metadata[id]->loadedAsset = assets[id].get();
+
+            registry.insert(info, false);
+
+            // Resolvable from the moment it is registered, keep the copy of whoever got it into assets first
+            std::unique_lock lock(assetsMutex);
+            looseOverrides.insert(id);
+            auto [it, inserted] = assets.try_emplace(id, std::move(newAsset));
+            if (inserted) {
+                trackResidency(id, *it->second);
+                info->loadedAsset = it->second.get();
+            }
             return id;
         }
         catch (std::exception& e)
@@ -130,11 +167,11 @@ namespace am {
     // Create metadata array
     rapidjson::Value metadataArray(rapidjson::kArrayType);
 
-    for (const auto& [uuid, info] : metadata) {
+    registry.forEach([&](const RegistryEntryView& entry) {
         rapidjson::Value assetInfoObj(rapidjson::kObjectType);
-        info->SerializeAssetInfoToJson(assetInfoObj, allocator);
+        AssetRegistry::makeInfo(entry)->SerializeAssetInfoToJson(assetInfoObj, allocator);
         metadataArray.PushBack(assetInfoObj, allocator);
-    }
+    });
 
     document.AddMember("metadata", metadataArray, allocator);
 
@@ -154,66 +191,350 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
     }
 
     // Clear existing data
-    metadata.clear();
-    lookupNamesToUUIDs.clear();
+    std::unique_lock lock(assetsMutex);
     assets.clear();
+    {
+        std::lock_guard residencyLock(residencyMutex);
+        residency.clear();
+        evictionList.clear();
+        residentBytes = 0;
+    }
+    lock.unlock();
 
     // Load metadata
+    std::vector<std::shared_ptr<AssetInfo>> infos;
     const auto& metadataArray = document["metadata"].GetArray();
+    infos.reserve(metadataArray.Size());
     for (const auto& assetInfoValue : metadataArray) {
-        auto assetInfo = AssetInfo::DeserializeAssetInfoFromJson(assetInfoValue);
-        auto infoPtr = std::make_shared<AssetInfo>(std::move(assetInfo));
-        metadata[infoPtr->id] = infoPtr;
-        lookupNamesToUUIDs[infoPtr->lookUpName] = infoPtr->id;
+        infos.push_back(std::make_shared<AssetInfo>(AssetInfo::DeserializeAssetInfoFromJson(assetInfoValue)));
     }
 
-    return true;
+    return registry.reset(infos);
 }
-    
+
+    void AssetManager::openRegistry() {
+        const std::filesystem::path jsonPath(kRegistryPath);
+        const std::string snapshotPath = std::filesystem::path(jsonPath).replace_extension(".reg").string();
+        const std::string journalPath = std::filesystem::path(jsonPath).replace_extension(".journal").string();
+
+        registry.open(snapshotPath, journalPath);
+
+        // Registries from before the snapshot existed are converted once
+        std::error_code error;
+        if (!registry.hasSnapshot() && std::filesystem::exists(jsonPath, error)) {
+            spdlog::info("Migrating {} to {}", jsonPath.string(), snapshotPath);
+            loadRegistryMetadataFromFile(jsonPath.string());
+        }
+    }
+
+    bool AssetManager::compactRegistry() {
+        return registry.compact();
+    }
+
+    bool AssetManager::mountArchive(const std::string& path) {
+        auto archive = AssetArchive::open(path);
+        if (!archive) {
+            return false;
+        }
+        std::unique_lock lock(assetsMutex);
+        archives.push_back(std::move(archive));
+        return true;
+    }
+
+    void AssetManager::unmountArchives() {
+        std::unique_lock lock(assetsMutex);
+        archives.clear();
+    }
+
+    std::string AssetManager::getRegistryDirectory() const {
+        return std::filesystem::path(kRegistryPath).parent_path().string();
+    }
+
+    std::string AssetManager::getCacheDirectory(const std::string& name) const {
+        const auto directory = std::filesystem::path(getRegistryDirectory()) / "cache" / name;
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            spdlog::error("Failed to create cache directory {}: {}", directory.string(), error.message());
+        }
+        return directory.string();
+    }
+
+    void AssetManager::mountArchivesInDirectory(const std::string& directory) {
+        std::error_code error;
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".pak") {
+                paths.push_back(entry.path());
+            }
+        }
+
+        // Deterministic priority when several archives hold the same asset
+        std::sort(paths.begin(), paths.end());
+        for (const auto& path : paths) {
+            mountArchive(path.string());
+        }
+    }
+
+    bool AssetManager::buildArchive(const std::string& path, const AssetArchive::BuildSettings& settings) {
+        // Packing can load assets and register what they reference, so work on a copy of the registry
+        std::vector<std::shared_ptr<AssetInfo>> infos;
+        registry.forEach([&](const RegistryEntryView& entry) {
+            infos.push_back(AssetRegistry::makeInfo(entry));
+        });
+
+        std::vector<AssetArchive::BuildEntry> entries;
+        entries.reserve(infos.size());
+
+        for (const auto& info : infos) {
+            const auto& id = info->id;
+            if (GetEditorSavesToBin(info->type)) {
+                // Only containers can be used in place from the archive, upgrade anything older
+                auto file = MappedFile::open(info->path);
+                if (!file || !BinaryContainerReader::isContainer(file->bytes())) {
+                    file.reset();
+                    auto asset = getAsset(id);
+                    if (!asset) {
+                        spdlog::error("Failed to load {} for packing, skipping it", info->path);
+                        continue;
+                    }
+                    asset.value()->SaveAssetToBin(info->path);
+                }
+            }
+            entries.push_back({id, info->type, info->path});
+        }
+
+        return AssetArchive::build(path, entries, settings);
+    }
+
+    std::shared_ptr<const MappedFile> AssetManager::openAssetFile(const boost::uuids::uuid& id, const std::string& path) {
+        std::shared_lock lock(assetsMutex);
+        if (!looseOverrides.contains(id)) {
+            for (const auto& archive : archives) {
+                if (archive->contains(id)) {
+                    return archive->openEntry(id);
+                }
+            }
+        }
+        lock.unlock();
+        return MappedFile::open(path);
+    }
+
+    bool AssetManager::loadAssetJson(const boost::uuids::uuid& id, const std::string& path, rapidjson::Document& document) {
+        std::shared_lock lock(assetsMutex);
+        if (!looseOverrides.contains(id)) {
+            for (const auto& archive : archives) {
+                if (archive->contains(id)) {
+                    auto file = archive->openEntry(id);
+                    return file && loadJsonFromBytes(file->bytes(), file->getPath(), document);
+                }
+            }
+        }
+        lock.unlock();
+        return loadJsonFromFile(path, document);
+    }
+
+    const aiScene* AssetManager::getImportScene(const std::string& path, unsigned int flags) {
+        ThreadImporter& threadImporter = getThreadImporter();
+        if (threadImporter.path == path && threadImporter.importer.GetScene()) {
+            return threadImporter.importer.GetScene();
+        }
+
+        threadImporter.path.clear();
+        const aiScene* scene = threadImporter.importer.ReadFile(path, flags);
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            return nullptr;
+        }
+        threadImporter.path = path;
+        return scene;
+    }
+
+    void AssetManager::releaseImportScene() {
+        ThreadImporter& threadImporter = getThreadImporter();
+        threadImporter.importer.FreeScene();
+        threadImporter.path.clear();
+    }
+
+    std::string AssetManager::getImportError() const {
+        return getThreadImporter().importer.GetErrorString();
+    }
+
+    ImportInputs AssetManager::getImportSceneInputs(const std::string& path, unsigned int flags) {
+        ImportInputs inputs;
+        ContentHasher settings;
+        settings.add(static_cast<uint32_t>(flags));
+        inputs.settingsHash = settings.result();
+
+        const std::filesystem::path basePath = std::filesystem::path(path).parent_path();
+        const std::string extension = std::filesystem::path(path).extension().string();
+        if (extension == ".gltf") {
+            rapidjson::Document document;
+            if (!loadJsonFromFile(path, document) || !document.IsObject()) {
+                return inputs;
+            }
+            for (const char* key : {"buffers", "images"}) {
+                if (!document.HasMember(key) || !document[key].IsArray()) {
+                    continue;
+                }
+                for (const auto& entry : document[key].GetArray()) {
+                    // Embedded data URIs are part of the file's own bytes
+                    if (entry.IsObject() && entry.HasMember("uri") && entry["uri"].IsString() &&
+                        !std::string_view(entry["uri"].GetString()).starts_with("data:")) {
+                        inputs.sourceFiles.push_back((basePath / entry["uri"].GetString()).lexically_normal().string());
+                    }
+                }
+            }
+        } else if (extension == ".obj") {
+            std::ifstream file(path);
+            std::string line;
+            while (std::getline(file, line)) {
+                if (line.starts_with("mtllib ")) {
+                    std::string library = line.substr(7);
+                    library.erase(library.find_last_not_of(" \t\r") + 1);
+                    inputs.sourceFiles.push_back((basePath / library).lexically_normal().string());
+                }
+            }
+        }
+        return inputs;
+    }
+
+    std::optional<uint64_t> AssetManager::hashSourceFile(const std::string& path) {
+        std::error_code error;
+        const auto writeTime = std::filesystem::last_write_time(path, error);
+        if (error) {
+            return std::nullopt;
+        }
+        const auto size = std::filesystem::file_size(path, error);
+        if (error) {
+            return std::nullopt;
+        }
+
+        {
+            std::lock_guard lock(sourceFileHashesMutex);
+            auto it = sourceFileHashes.find(path);
+            if (it != sourceFileHashes.end() && it->second.writeTime == writeTime && it->second.size == size) {
+                return it->second.hash;
+            }
+        }
+
+        auto file = MappedFile::open(path);
+        if (!file) {
+            return std::nullopt;
+        }
+        const auto bytes = file->bytes();
+        const uint64_t hash = ContentHasher::hash(bytes.data(), bytes.size());
+
+        std::lock_guard lock(sourceFileHashesMutex);
+        sourceFileHashes[path] = {writeTime, size, hash};
+        return hash;
+    }
+
+    std::optional<uint64_t> AssetManager::computeImportKey(const ImportContext& importContext) {
+        const auto sourceHash = hashSourceFile(importContext.importPath);
+        if (!sourceHash) {
+            return std::nullopt;
+        }
+
+        const uint64_t sourceHashValue = sourceHash.value();
+        const auto type = static_cast<uint32_t>(importContext.assetType);
+        const auto index = static_cast<int32_t>(importContext.assimpIndex);
+        const uint32_t version = getImporterVersion(importContext.assetType);
+
+        ContentHasher hasher;
+        hasher.add(sourceHashValue);
+        hasher.add(type);
+        hasher.add(index);
+        hasher.add(version);
+
+        if (auto resolver = importInputs.find(getTypeIndex(importContext.assetType)); resolver != importInputs.end()) {
+            ImportInputs inputs = resolver->second(importContext);
+            for (auto& sourceFile : inputs.sourceFiles) {
+                sourceFile = AssetDependencyGraph::normalizePath(sourceFile);
+            }
+            // Sorted so the order the importer found them in doesn't matter
+            std::ranges::sort(inputs.sourceFiles);
+            inputs.sourceFiles.erase(std::ranges::unique(inputs.sourceFiles).begin(), inputs.sourceFiles.end());
+            // Only the bytes, the paths are absolute and would tie the key to where the project is checked out.
+            // A missing file counts too, the key changes again once it shows up
+            for (const auto& sourceFile : inputs.sourceFiles) {
+                hasher.add(hashSourceFile(sourceFile).value_or(0));
+            }
+            hasher.add(inputs.settingsHash);
+        }
+        const uint64_t key = hasher.result();
+        // 0 marks assets that weren't imported
+        return key != 0 ? key : 1;
+    }
+
+    std::string AssetManager::makeUniqueLookupName(const std::string& lookUpName) const {
+        return registry.findFreeLookupName(lookUpName);
+    }
+
     AssetManager &AssetManager::getInstance() {
         static AssetManager instance;
         return instance;
     }
     
     std::optional<std::shared_ptr<AssetInfo> > AssetManager::getAssetInfo(const boost::uuids::uuid &id) const {
-        auto it = metadata.find(id);
-        if (it != metadata.end()) return it->second;
+        if (auto info = registry.find(id)) return info;
         spdlog::error("No asset found!");
         return std::nullopt;
     }
 
     std::optional<Asset*> AssetManager::getAsset(const boost::uuids::uuid& id)
     {
-        auto it = assets.find(id);
-        if (it != assets.end()) return it->second.get();
+        std::shared_ptr<AssetInfo> decodedAssetInfo;
+        {
+            std::shared_lock lock(assetsMutex);
+            auto it = assets.find(id);
+            if (it != assets.end()) {
+                std::lock_guard residencyLock(residencyMutex);
+                auto entry = residency.find(id);
+                if (entry != residency.end() && entry->second.refCount == 0) {
+                    evictionList.splice(evictionList.begin(), evictionList, entry->second.lruPosition);
+                }
+                return it->second.get();
+            }
+        }
+
+        decodedAssetInfo = registry.find(id);
+        if (!decodedAssetInfo) return std::nullopt;
 
-        auto assetInfo = metadata.find(id);
-        if (assetInfo == metadata.end()) return std::nullopt;
-        auto decodedAssetInfo = assetInfo->second;
+        // Loaders can resolve other assets, so the lock is not held while loading
         unique_ptr<Asset> assetNew;
         try
         {
-            if (GetEditorSavesToBin(assetInfo->second->type))
+            if (GetEditorSavesToBin(decodedAssetInfo->type))
             {
-                auto binLoader = getLoader(getTypeIndex(assetInfo->second->type));
+                auto binLoader = getLoader(getTypeIndex(decodedAssetInfo->type));
                 if (!binLoader) {
                     spdlog::error("No factory registered for asset type");
                     throw std::runtime_error("No factory registered for asset type");
                 }
-                assetNew = binLoader(id, assetInfo->second->path, AssetFormat::Binary);
+                assetNew = binLoader(id, decodedAssetInfo->path, AssetFormat::Binary);
             }else
             {
-                auto jsonLoader = getLoader(getTypeIndex(assetInfo->second->type));
+                auto jsonLoader = getLoader(getTypeIndex(decodedAssetInfo->type));
                 if (!jsonLoader) {
                     spdlog::error("No factory registered for asset type");
                     throw std::runtime_error("No factory registered for asset type");
                 }
-                assetNew = jsonLoader(id, assetInfo->second->path, AssetFormat::Json);
+                assetNew = jsonLoader(id, decodedAssetInfo->path, AssetFormat::Json);
+            }
+
+            // Another thread may have loaded it meanwhile, keep whichever got in first
+            std::unique_lock lock(assetsMutex);
+            auto [it, inserted] = assets.try_emplace(id, std::move(assetNew));
+            if (inserted) {
+                decodedAssetInfo->loadedAsset = it->second.get();
+                decodedAssetInfo->isLoaded = true;
+                trackResidency(id, *it->second);
+                recordDependencies(*decodedAssetInfo, *it->second);
             }
-            assetInfo->second->loadedAsset = assetNew.get();
-            assetInfo->second->isLoaded = true;
-            assets[id] = std::move(assetNew);
-            return assets[id].get();
+            Asset* asset = it->second.get();
+            auto evicted = evictOverBudget(id);
+            lock.unlock();
+            return asset;
         }catch (const std::exception& e)
         {
             spdlog::error("Failed to load asset");
@@ -222,6 +543,158 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
         return std::nullopt;
     }
 
+    AssetLoadHandle AssetManager::loadAssetAsync(const boost::uuids::uuid& id, LoadPriority priority)
+    {
+        std::call_once(loadQueueStarted, [this]() {
+            // Leave a core for the thread that consumes the results
+            const unsigned int threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+            loadQueue = std::make_unique<AssetLoadQueue>([this](const boost::uuids::uuid& assetId) {
+                return getAsset(assetId).value_or(nullptr);
+            }, threadCount);
+        });
+        return loadQueue->request(id, priority);
+    }
+
+    Asset* AssetManager::acquireAsset(const boost::uuids::uuid& id)
+    {
+        while (true) {
+            auto asset = getAsset(id);
+            if (!asset.has_value() || !asset.value()) {
+                return nullptr;
+            }
+
+            std::shared_lock lock(assetsMutex);
+            auto it = assets.find(id);
+            if (it == assets.end()) {
+                continue;   // Another thread evicted it before it could be pinned
+            }
+
+            std::lock_guard residencyLock(residencyMutex);
+            auto& entry = residency[id];
+            if (entry.refCount++ == 0) {
+                evictionList.erase(entry.lruPosition);
+            }
+            return it->second.get();
+        }
+    }
+
+    void AssetManager::releaseAsset(const boost::uuids::uuid& id)
+    {
+        {
+            std::shared_lock lock(assetsMutex);
+            std::lock_guard residencyLock(residencyMutex);
+            auto entry = residency.find(id);
+            if (entry == residency.end() || entry->second.refCount == 0) {
+                spdlog::error("Released asset {} that was never acquired", boost::uuids::to_string(id));
+                return;
+            }
+            if (--entry->second.refCount == 0) {
+                entry->second.lruPosition = evictionList.insert(evictionList.begin(), id);
+            }
+        }
+        trimToBudget(boost::uuids::nil_uuid());
+    }
+
+    void AssetManager::setMemoryBudget(size_t bytes)
+    {
+        {
+            std::lock_guard residencyLock(residencyMutex);
+            memoryBudget = bytes;
+        }
+        trimToBudget(boost::uuids::nil_uuid());
+    }
+
+    AssetResidencyStats AssetManager::getResidencyStats() const
+    {
+        std::lock_guard residencyLock(residencyMutex);
+        AssetResidencyStats stats;
+        stats.budgetBytes = memoryBudget;
+        stats.residentBytes = residentBytes;
+        stats.residentCount = residency.size();
+        stats.evictableCount = evictionList.size();
+        stats.referencedCount = residency.size() - evictionList.size();
+        stats.evictionCount = evictionCount;
+        return stats;
+    }
+
+    void AssetManager::trackResidency(const boost::uuids::uuid& id, const Asset& asset)
+    {
+        std::lock_guard residencyLock(residencyMutex);
+        auto [entry, inserted] = residency.try_emplace(id);
+        residentBytes -= entry->second.bytes;
+        entry->second.bytes = asset.getMemoryUsage();
+        residentBytes += entry->second.bytes;
+        if (inserted) {
+            entry->second.lruPosition = evictionList.insert(evictionList.begin(), id);
+        }
+    }
+
+    std::vector<std::unique_ptr<Asset>> AssetManager::evictOverBudget(const boost::uuids::uuid& keep)
+    {
+        std::vector<std::unique_ptr<Asset>> evicted;
+        std::lock_guard residencyLock(residencyMutex);
+        if (memoryBudget == 0) {
+            return evicted;
+        }
+
+        auto it = evictionList.end();
+        while (residentBytes > memoryBudget && it != evictionList.begin()) {
+            --it;
+            if (*it == keep) {
+                continue;
+            }
+
+            const boost::uuids::uuid id = *it;
+            auto entry = residency.find(id);
+            residentBytes -= entry->second.bytes;
+            residency.erase(entry);
+            it = evictionList.erase(it);
+
+            // Dropped from the info too, its next getAsset loads it again
+            if (auto asset = assets.find(id); asset != assets.end()) {
+                evicted.push_back(std::move(asset->second));
+                assets.erase(asset);
+            }
+            if (auto info = registry.find(id)) {
+                info->loadedAsset = nullptr;
+                info->isLoaded = false;
+            }
+            ++evictionCount;
+        }
+        return evicted;
+    }
+
+    std::unique_ptr<Asset> AssetManager::unloadAsset(const boost::uuids::uuid& id)
+    {
+        std::lock_guard residencyLock(residencyMutex);
+        auto entry = residency.find(id);
+        if (entry != residency.end()) {
+            if (entry->second.refCount != 0) {
+                spdlog::warn("Asset {} stays loaded until it is released", boost::uuids::to_string(id));
+                return nullptr;
+            }
+            residentBytes -= entry->second.bytes;
+            evictionList.erase(entry->second.lruPosition);
+            residency.erase(entry);
+        }
+
+        std::unique_ptr<Asset> asset;
+        if (auto it = assets.find(id); it != assets.end()) {
+            asset = std::move(it->second);
+            assets.erase(it);
+        }
+        return asset;
+    }
+
+    void AssetManager::trimToBudget(const boost::uuids::uuid& keep)
+    {
+        std::vector<std::unique_ptr<Asset>> evicted;
+        {
+            std::unique_lock lock(assetsMutex);
+            evicted = evictOverBudget(keep);
+        }
+    }
+
     void AssetManager::saveAsset(const boost::uuids::uuid id)
     {
         auto info = getAssetInfo(id);
@@ -235,6 +708,12 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
             spdlog::error("No asset found with id: {}", boost::uuids::to_string(id));
         }
         
+        // The loose file is newer than whatever an archive holds from now on
+        {
+            std::unique_lock lock(assetsMutex);
+            looseOverrides.insert(id);
+        }
+
         if (GetEditorSavesToBin(info.value()->type))
         {
             asset.value()->SaveAssetToBin(info.value()->path);
@@ -275,7 +754,7 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
 
         std::string extension = p.extension().string();
 
-        if (lookupNamesToUUIDs.find(lookUpName) != lookupNamesToUUIDs.end())
+        if (getAssetUuid(lookUpName))
         {
             spdlog::error("Lookup name already exists");
             throw std::runtime_error("Lookup name already exists");
@@ -293,15 +772,7 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
         std::string baseName = p.stem().string();
         std::string extension = p.extension().string();
 
-        std::string lookUpName = baseName + GetExtensionFromAssetType(GetAssetTypeFromExtension(extension));
-
-        int counter = 1;
-
-        while (lookupNamesToUUIDs.find(lookUpName) != lookupNamesToUUIDs.end())
-        {
-            lookUpName = baseName + "_" + std::to_string(counter) +  GetExtensionFromAssetType(GetAssetTypeFromExtension(extension));
-            counter++;
-        }
+        std::string lookUpName = makeUniqueLookupName(baseName + GetExtensionFromAssetType(GetAssetTypeFromExtension(extension)));
 
         ImportContext assetFactoryData(normalizedPath, GetAssetTypeFromExtension(extension), 0);
         return importAsset(assetFactoryData, lookUpName);
@@ -338,15 +809,19 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
         std::string baseName = p.stem().string();
         std::string extension = p.extension().string();
 
-        std::string baseLookupName = baseName + "_" + std::to_string(importContext.assimpIndex);
+        // One buffer for every candidate, only the suffix changes between them
+        const std::string assetExtension = GetExtensionFromAssetType(importContext.assetType);
+        std::string lookUpName = baseName + "_" + std::to_string(importContext.assimpIndex);
+        const size_t baseLength = lookUpName.size();
         std::string suffix = "";
-        std::string lookUpName;
 
         while (true)
         {
-            lookUpName = baseLookupName + suffix + GetExtensionFromAssetType(importContext.assetType);
+            lookUpName.resize(baseLength);
+            lookUpName += suffix;
+            lookUpName += assetExtension;
 
-            if (lookupNamesToUUIDs.find(lookUpName) == lookupNamesToUUIDs.end())
+            if (!registry.isLookupNameTaken(lookUpName))
                 break;
 
             suffix = incrementSuffix(suffix);
@@ -355,13 +830,60 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
         return importAsset(importContext, lookUpName);
     }
 
+    std::vector<std::optional<boost::uuids::uuid>> AssetManager::registerAssets(const std::vector<std::string>& paths, unsigned int threadCount)
+    {
+        std::vector<std::optional<boost::uuids::uuid>> results(paths.size());
+        if (paths.empty()) {
+            return results;
+        }
+
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threadCount = static_cast<unsigned int>(std::min<size_t>(threadCount, paths.size()));
+
+        // Biggest files first so a large model picked up last doesn't leave the other workers idle
+        std::vector<std::pair<uintmax_t, size_t>> order;
+        order.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) {
+            std::error_code error;
+            const uintmax_t size = std::filesystem::file_size(paths[i], error);
+            order.emplace_back(error ? 0 : size, i);
+        }
+        std::sort(order.begin(), order.end(), std::greater<>());
+
+        std::atomic<size_t> next = 0;
+        auto worker = [&]() {
+            for (size_t i = next.fetch_add(1); i < order.size(); i = next.fetch_add(1)) {
+                const size_t index = order[i].second;
+                try {
+                    results[index] = registerAsset(paths[index]);
+                } catch (const std::exception& e) {
+                    spdlog::error("Failed to import {}: {}", paths[index], e.what());
+                }
+            }
+            // Each worker's importer dies with the thread, don't keep its last scene around until then
+            releaseImportScene();
+        };
+
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(threadCount - 1);
+            for (unsigned int i = 1; i < threadCount; ++i) {
+                workers.emplace_back(worker);
+            }
+            worker();
+        }
+
+        spdlog::info("Imported {} files on {} threads", paths.size(), threadCount);
+        return results;
+    }
+
 
 
     std::optional<boost::uuids::uuid> AssetManager::getAssetUuid(std::string lookupName)
     {
-        auto uuid = lookupNamesToUUIDs.find(lookupName);
-        if (uuid == lookupNamesToUUIDs.end()) return std::nullopt;
-        return uuid->second;
+        return registry.findByLookupName(lookupName);
     }
 
 
@@ -377,9 +899,8 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
 
     any AssetManager::getAssetData(std::string lookupName)
     {
-        auto it = lookupNamesToUUIDs.find(lookupName);
-        if (it != lookupNamesToUUIDs.end() ) {
-            return getAssetData(it->second);
+        if (auto id = getAssetUuid(lookupName)) {
+            return getAssetData(id.value());
         }
         return nullptr;
     }
@@ -387,18 +908,17 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
     std::vector<std::string> AssetManager::getRegisteredAssetsNames() const
     {
         std::vector<std::string> result;
-        result.reserve(lookupNamesToUUIDs.size());
-        for (const auto& [name, uuids] : lookupNamesToUUIDs) {
-            result.push_back(name);
-        }
+        registry.forEach([&](const RegistryEntryView& entry) {
+            result.emplace_back(entry.lookUpName);
+        });
         return result;
     }
 
     std::vector<std::string> AssetManager::getRegisteredAssetsNames(AssetType type) const
     {
         std::vector<std::string> result;
-        for (const auto& [_, info] : metadata) {
-            if (info->type == type)
+        for (const auto& id : registry.findByType(type)) {
+            if (auto info = registry.find(id))
                 result.push_back(info->lookUpName);
         }
         return result;
@@ -407,21 +927,48 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
     std::vector<boost::uuids::uuid> AssetManager::getRegisteredAssetsUuids() const
     {
         std::vector<boost::uuids::uuid> result;
-        result.reserve(metadata.size());
-        for (const auto& [_, info] : metadata) {
-            result.push_back(info.get()->id);
-        }
+        registry.forEach([&](const RegistryEntryView& entry) {
+            result.push_back(entry.id);
+        });
         return result;
     }
 
     std::vector<boost::uuids::uuid> AssetManager::getRegisteredAssetsUuids(AssetType type) const
     {
-        std::vector<boost::uuids::uuid> result;
-        for (const auto& [_, info] : metadata) {
-            if (info->type == type)
-                result.push_back(info.get()->id);
+        return registry.findByType(type);
+    }
+
+    std::vector<boost::uuids::uuid> AssetManager::getAssetsImportedFrom(const std::string& importPath) const
+    {
+        return registry.findByImportPath(std::filesystem::path(importPath).lexically_normal().string());
+    }
+
+    bool AssetManager::unregisterAsset(const boost::uuids::uuid& id)
+    {
+        {
+            std::lock_guard residencyLock(residencyMutex);
+            auto entry = residency.find(id);
+            if (entry != residency.end() && entry->second.refCount != 0) {
+                spdlog::error("Can't unregister asset {} while it is acquired", boost::uuids::to_string(id));
+                return false;
+            }
         }
-        return result;
+        auto info = registry.find(id);
+        if (!info || !registry.remove(id)) {
+            spdlog::error("No asset found with id: {}", boost::uuids::to_string(id));
+            return false;
+        }
+
+        std::unique_ptr<Asset> unloaded;
+        {
+            std::unique_lock lock(assetsMutex);
+            looseOverrides.erase(id);
+            unloaded = unloadAsset(id);
+            info->loadedAsset = nullptr;
+            info->isLoaded = false;
+        }
+        dependencyGraph.remove(id);
+        return true;
     }
 
     std::optional<boost::uuids::uuid> AssetManager::importAsset(ImportContext importContext, string lookUpName)
@@ -429,6 +976,25 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
         importContext.importPath = std::filesystem::path(importContext.importPath).lexically_normal().string();
         try
         {
+            // Unchanged source imported before with the same importer, reuse its output without running the importer
+            const auto importKey = computeImportKey(importContext);
+            if (importKey) {
+                const auto cachedId = registry.findBySourceHash(importKey.value());
+                auto cached = cachedId ? registry.find(cachedId.value()) : nullptr;
+                std::error_code error;
+                if (cached && std::filesystem::exists(cached->path, error)) {
+                    return cached->id;
+                }
+            }
+
+            // Imported before from a source that changed since, reimported under the id everything refers to it by
+            if (auto previous = findImportedAsset(importContext)) {
+                if (!reimportAsset(previous)) {
+                    return std::nullopt;
+                }
+                return previous->id;
+            }
+
             // Create and load the asset to calculate its hash
             auto factory = getImporter(getTypeIndex(importContext.assetType));
             if (!factory) {
@@ -437,23 +1003,13 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
             }
 
             auto id = boost::uuids::random_generator()();
+            importerRuns.fetch_add(1, std::memory_order_relaxed);
             std::unique_ptr<Asset> newAsset = factory(id, importContext);
             size_t contentHash = newAsset->calculateContentHash();
 
-            // Check if we have an asset with the same content hash
-            auto existingAsset = std::find_if(metadata.begin(), metadata.end(),
-                                              [contentHash](const auto &pair) {
-                                                  return pair.second->contentHash == contentHash;
-                                              });
-
-            if (existingAsset != metadata.end()) {
-                // We found an asset with the same content
-                return existingAsset->second.get()->id;
-            }
-
-            // If we get here, this is a new unique asset
             auto info = std::make_shared<AssetInfo>(id, importContext.importPath, importContext.assetType, contentHash,importContext, lookUpName);
             info->isLoaded = true;
+            info->sourceHash = importKey.value_or(0);
 
             std::filesystem::path p = std::filesystem::path(importContext.importPath).lexically_normal();
             std::string baseName = p.stem().string();
@@ -465,35 +1021,41 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
                 {
                     additionalSufix = GetShaderSufix(newAsset.get()->getAssetDataAs<ShaderData>()->stage);
                 }
-                std::string filename = GetBinPath((p.parent_path() / (baseName + GetExtensionFromAssetType(importContext.assetType))).string(), additionalSufix);
-                info->path = filename;
-                newAsset->SaveAssetToBin(filename);
+                info->path = GetBinPath((p.parent_path() / (baseName + GetExtensionFromAssetType(importContext.assetType))).string(), additionalSufix);
             } else {
-                std::string filename = (p.parent_path() / (baseName + GetExtensionFromAssetType(importContext.assetType))).string();
-                info->path = filename;
-                auto jsonSaver = getJsonSaver(getTypeIndex(importContext.assetType));
-
-                rapidjson::Document document;
-                document.SetObject();
-                auto& allocator = document.GetAllocator();
-
-                // Add encoding information
-                rapidjson::Value encodingInfo(rapidjson::kObjectType);
-                encodingInfo.AddMember("encoding", "UTF-8", allocator);
-                encodingInfo.AddMember("version", "1.0", allocator);
-                document.AddMember("_meta", encodingInfo, allocator);
-
-                jsonSaver(*newAsset, document);
+                info->path = (p.parent_path() / (baseName + GetExtensionFromAssetType(importContext.assetType))).string();
+            }
 
-                saveJsonToFile(filename, document);
+            // Loaded before it is registered, so nobody who finds it tries the file that is only written below
+            Asset* asset = newAsset.get();
+            {
+                std::unique_lock lock(assetsMutex);
+                looseOverrides.insert(id);
+                trackResidency(id, *newAsset);
+                assets[id] = std::move(newAsset);
+                info->loadedAsset = asset;
             }
 
-            //We are here so we can save everything
+            // Another worker may have imported the same content meanwhile, the registry picks the winner.
+            // The caller picked the name without any lock too, insert moves it to a free one
+            const auto registeredId = registry.insert(info, true);
+            if (registeredId != id) {
+                // We found an asset with the same content, route this source to it too for the rest of the session
+                if (importKey) {
+                    registry.addSourceAlias(importKey.value(), registeredId);
+                }
+                std::unique_ptr<Asset> duplicate;
+                {
+                    std::unique_lock lock(assetsMutex);
+                    looseOverrides.erase(id);
+                    duplicate = unloadAsset(id);
+                }
+                return registeredId;
+            }
 
-            metadata.insert(std::make_pair(id, info));
-            assets[id] = std::move(newAsset);
-            info->loadedAsset = assets[id].get();
-            lookupNamesToUUIDs[lookUpName] = id;
+            // Written after registering so a second import of the same content returns early instead of writing the same file
+            writeImportedAsset(*asset, *info);
+            recordDependencies(*info, *asset);
             return id;
         }
         catch (std::exception& e)
@@ -503,6 +1065,176 @@ bool AssetManager::loadRegistryMetadataFromFile(const std::string& filename) {
         return std::nullopt;
     }
     
+    std::shared_ptr<AssetInfo> AssetManager::findImportedAsset(const ImportContext& importContext) const
+    {
+        for (const auto& id : registry.findByImportPath(importContext.importPath)) {
+            auto info = registry.find(id);
+            if (info && info->importContext == importContext) {
+                return info;
+            }
+        }
+        return nullptr;
+    }
+
+    void AssetManager::writeImportedAsset(Asset& asset, const AssetInfo& info)
+    {
+        if (GetEditorSavesToBin(info.type))
+        {
+            std::string path = info.path;
+            asset.SaveAssetToBin(path);
+        } else {
+            auto jsonSaver = getJsonSaver(getTypeIndex(info.type));
+
+            rapidjson::Document document;
+            document.SetObject();
+            auto& allocator = document.GetAllocator();
+
+            // Add encoding information
+            rapidjson::Value encodingInfo(rapidjson::kObjectType);
+            encodingInfo.AddMember("encoding", "UTF-8", allocator);
+            encodingInfo.AddMember("version", "1.0", allocator);
+            document.AddMember("_meta", encodingInfo, allocator);
+
+            jsonSaver(asset, document);
+
+            saveJsonToFile(info.path, document);
+        }
+    }
+
+    bool AssetManager::reimportAsset(const std::shared_ptr<AssetInfo>& info)
+    {
+        const boost::uuids::uuid id = info->id;
+        ImportContext importContext = info->importContext;
+        try
+        {
+            auto factory = getImporter(getTypeIndex(importContext.assetType));
+            if (!factory) {
+                spdlog::error("No factory registered for asset type");
+                throw std::runtime_error("No factory registered for asset type");
+            }
+
+            // Computed before the importer runs, an edit made meanwhile gets a key of its own and is imported again
+            const auto importKey = computeImportKey(importContext);
+            importerRuns.fetch_add(1, std::memory_order_relaxed);
+            std::unique_ptr<Asset> newAsset = factory(id, importContext);
+            const size_t contentHash = newAsset->calculateContentHash();
+
+            registry.update(info, [&](AssetInfo& changed) {
+                changed.contentHash = contentHash;
+                changed.sourceHash = importKey.value_or(0);
+            });
+            // Binaries are written next to the old file and renamed over it, so a loaded copy mapping it stays valid
+            writeImportedAsset(*newAsset, *info);
+            recordDependencies(*info, *newAsset);
+
+            std::unique_lock lock(assetsMutex);
+            looseOverrides.insert(id);
+            {
+                std::lock_guard residencyLock(residencyMutex);
+                auto entry = residency.find(id);
+                if (entry != residency.end() && entry->second.refCount != 0) {
+                    spdlog::warn("Asset {} is acquired, it keeps its previous data until it is released and loaded again",
+                                 boost::uuids::to_string(id));
+                    return true;
+                }
+            }
+
+            Asset* asset = newAsset.get();
+            if (auto loaded = assets.find(id); loaded != assets.end()) {
+                replacedAssets.push_back(std::move(loaded->second));
+                loaded->second = std::move(newAsset);
+            } else {
+                assets.emplace(id, std::move(newAsset));
+            }
+            trackResidency(id, *asset);
+            info->loadedAsset = asset;
+            info->isLoaded = true;
+            spdlog::info("Reimported {} from {}", info->lookUpName, importContext.importPath);
+            return true;
+        }
+        catch (std::exception& e)
+        {
+            spdlog::error("Failed to reimport asset {} from {}: {}", boost::uuids::to_string(id), importContext.importPath, e.what());
+        }
+        return false;
+    }
+
+    void AssetManager::recordDependencies(const AssetInfo& info, const Asset& asset)
+    {
+        std::vector<std::string> sourceFiles = asset.getSourceFiles();
+        if (!info.importContext.importPath.empty()) {
+            sourceFiles.push_back(info.importContext.importPath);
+        }
+        dependencyGraph.record(info.id, asset.getDependencies(), sourceFiles);
+
+        std::lock_guard lock(watcherMutex);
+        if (watcher) {
+            for (const auto& sourceFile : sourceFiles) {
+                watcher->watch(AssetDependencyGraph::normalizePath(sourceFile));
+            }
+        }
+    }
+
+    void AssetManager::enableHotReload()
+    {
+        // Assets that weren't loaded yet are only known by their import path, loading them records the rest
+        registry.forEach([this](const RegistryEntryView& entry) {
+            if (!entry.importPath.empty()) {
+                dependencyGraph.addSourceFile(entry.id, std::string(entry.importPath));
+            }
+        });
+
+        std::lock_guard lock(watcherMutex);
+        if (!watcher) {
+            watcher = std::make_unique<AssetWatcher>();
+        }
+        for (const auto& sourceFile : dependencyGraph.getSourceFiles()) {
+            watcher->watch(sourceFile);
+        }
+        spdlog::info("Hot reload watching {} source files", dependencyGraph.getSourceFiles().size());
+    }
+
+    std::vector<boost::uuids::uuid> AssetManager::pollHotReload()
+    {
+        std::vector<std::string> changed;
+        {
+            std::lock_guard lock(watcherMutex);
+            if (!watcher) {
+                return {};
+            }
+            changed = watcher->poll();
+        }
+        if (changed.empty()) {
+            return {};
+        }
+        return reloadSourceFiles(changed);
+    }
+
+    std::vector<boost::uuids::uuid> AssetManager::reloadSourceFiles(const std::vector<std::string>& paths)
+    {
+        // Whoever still pointed into the copies the last reload replaced was told about it then
+        std::vector<std::unique_ptr<Asset>> replaced;
+        {
+            std::unique_lock lock(assetsMutex);
+            replaced.swap(replacedAssets);
+        }
+
+        // Dependencies come first, so an importer resolving one finds it already reimported in the import cache
+        std::vector<boost::uuids::uuid> reloaded;
+        for (const auto& id : dependencyGraph.collectAffected(paths)) {
+            auto info = registry.find(id);
+            if (!info) {
+                dependencyGraph.remove(id);
+                continue;
+            }
+            // Created rather than imported, its data only refers to the others by id and stays as it is
+            if (info->importContext.importPath.empty() || reimportAsset(info)) {
+                reloaded.push_back(id);
+            }
+        }
+        return reloaded;
+    }
+
     std::type_index AssetManager::getTypeIndex(AssetType type) const
     {
         switch (type) {
@@ -13,11 +13,23 @@
 #include "../include/UUIDManager.hpp"
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <list>
 #include <functional>
 #include <optional>
+#include <filesystem>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 #include <assimp/Importer.hpp>
+#include <assimp/scene.h>
 
 #include "AssetManagerInterface.h"
+#include "AssetArchive.hpp"
+#include "AssetDependencyGraph.hpp"
+#include "AssetLoadQueue.hpp"
+#include "AssetRegistry.hpp"
+#include "AssetWatcher.hpp"
 #include "../include/AssetInfo.hpp"
 
 
@@ -36,13 +48,21 @@ namespace am {
         using AssetLoader = std::function<std::unique_ptr<am::Asset>(const boost::uuids::uuid&, const std::string&, AssetFormat)>;
         using MetadataLoader = std::function<void(am::Asset&, rapidjson::Document&)>;
         using MetadataSaver  = std::function<void(am::Asset&, rapidjson::Document&)>;
+        using ImportInputsResolver = std::function<ImportInputs(const am::ImportContext&)>;
 
     public:
         AssetManager(const AssetManager&) = delete;
         AssetManager& operator=(const AssetManager&) = delete;
         static AssetManager &getInstance();
 
-        Assimp::Importer importer;
+        // Scene loaded by the calling thread's importer, path is only read if it isn't the scene already loaded.
+        // Every thread owns its importer so imports can run in parallel.
+        const aiScene* getImportScene(const std::string& path, unsigned int flags);
+        void releaseImportScene();
+        std::string getImportError() const;
+        // Import inputs of an assimp scene read with flags: the glTF buffers and images or OBJ material libraries the
+        // file points at, and the flags themselves
+        static ImportInputs getImportSceneInputs(const std::string& path, unsigned int flags);
 
         //Types
         std::type_index getTypeIndex(AssetType type) const;
@@ -73,6 +93,10 @@ namespace am {
         std::optional<boost::uuids::uuid> registerAsset(std::string path,std::string lookupName) override;
         std::optional<boost::uuids::uuid> registerAsset(std::string path) override;
         std::optional<boost::uuids::uuid> registerAsset(ImportContext importContext);
+        // Imports every file on a pool of threadCount workers (0 = one per core), results are in the order of paths
+        std::vector<std::optional<boost::uuids::uuid>> registerAssets(const std::vector<std::string>& paths, unsigned int threadCount = 0);
+        // Times an importer ran, for new assets and reimports. Imports answered by the import cache don't count
+        [[nodiscard]] uint64_t getImporterRunCount() const { return importerRuns.load(std::memory_order_relaxed); }
 
         //Getters
         std::optional<boost::uuids::uuid> getAssetUuid(std::string lookupName) override;
@@ -85,9 +109,23 @@ namespace am {
 
         std::vector<boost::uuids::uuid> getRegisteredAssetsUuids() const override;
         std::vector<boost::uuids::uuid> getRegisteredAssetsUuids(AssetType type) const override;
+        // Every asset imported from the source file
+        std::vector<boost::uuids::uuid> getAssetsImportedFrom(const std::string& importPath) const;
+
+        // Forgets the asset and unloads it, fails while it is acquired. Its files are left alone
+        bool unregisterAsset(const boost::uuids::uuid& id);
 
         std::optional<std::shared_ptr<AssetInfo>> getAssetInfo(const boost::uuids::uuid &id) const override;
+        // Not pinned, see AssetManagerInterface::getAsset. Keep the result past the next load only after acquireAsset
         std::optional<Asset*> getAsset(const boost::uuids::uuid& id) override;
+        AssetLoadHandle loadAssetAsync(const boost::uuids::uuid& id, LoadPriority priority = LoadPriority::Normal) override;
+
+        //Residency
+        Asset* acquireAsset(const boost::uuids::uuid& id) override;
+        void releaseAsset(const boost::uuids::uuid& id) override;
+        // 0 keeps every loaded asset resident
+        void setMemoryBudget(size_t bytes) override;
+        AssetResidencyStats getResidencyStats() const override;
 
         void saveAsset(boost::uuids::uuid id) override;
         void saveAsset(std::string lookupName) override;
@@ -100,24 +138,127 @@ namespace am {
         void RegisterAssetType();
 
         //Json
+        // Export and import of the registry as json, the registry itself lives in the binary snapshot and journal
         bool saveRegistryMetadataToFile(const std::string& filename) const;
+        // Replaces every registered asset with the file's and rewrites the snapshot from them
         bool loadRegistryMetadataFromFile(const std::string& filename);
 
+        //Registry
+        // Writes every registered asset to a new snapshot and empties the journal
+        bool compactRegistry();
+
+        //Caches
+        // Directory next to the registry for derived data that can be rebuilt at any time, created when missing
+        std::string getCacheDirectory(const std::string& name) const;
+
+        //Hot reload
+        void enableHotReload() override;
+        std::vector<boost::uuids::uuid> pollHotReload() override;
+        // Reimports the assets that read any of the files and everything built on them, keeping their ids.
+        // Returns the ids in the order they were reimported, dependencies first
+        std::vector<boost::uuids::uuid> reloadSourceFiles(const std::vector<std::string>& paths);
+
+        //Archives
+        // Every .pak next to the registry is mounted on startup, see mountArchivesInDirectory. Build them with am_pack
+        bool mountArchive(const std::string& path);
+        void mountArchivesInDirectory(const std::string& directory);
+        // Reads go back to the loose files, entries already handed out stay valid
+        void unmountArchives();
+        std::string getRegistryDirectory() const;
+        // Packs every registered asset into one archive, binary assets still in a legacy format are resaved first
+        bool buildArchive(const std::string& path, const AssetArchive::BuildSettings& settings = {});
+
+        // Asset bytes from the first mounted archive that has the id, the loose file at path otherwise
+        std::shared_ptr<const MappedFile> openAssetFile(const boost::uuids::uuid& id, const std::string& path);
+        bool loadAssetJson(const boost::uuids::uuid& id, const std::string& path, rapidjson::Document& document);
+
     private:
         AssetManager();
         ~AssetManager();
 
         std::optional<boost::uuids::uuid> importAsset(ImportContext importContext, std::string lookUpName);
+        std::string makeUniqueLookupName(const std::string& lookUpName) const;
+
+        // The registered asset imported with exactly this context, nullptr if there is none
+        std::shared_ptr<AssetInfo> findImportedAsset(const ImportContext& importContext) const;
+        // Runs the importer again under the asset's id and rewrites its file. The loaded copy is swapped for the new
+        // one unless it is acquired, the old copy lives until the next reload
+        bool reimportAsset(const std::shared_ptr<AssetInfo>& info);
+        // Binary or json, whichever the asset type is saved as
+        void writeImportedAsset(Asset& asset, const AssetInfo& info);
+        // Remembers what the asset was built from, its files are watched once hot reload is enabled
+        void recordDependencies(const AssetInfo& info, const Asset& asset);
+
+        // Hash of the source bytes, the asset type and index, the importer version and the type's ImportInputs: the
+        // bytes of every file the import resolves and its settings. nullopt if the source can't be read
+        std::optional<uint64_t> computeImportKey(const ImportContext& importContext);
+        std::optional<uint64_t> hashSourceFile(const std::string& path);
+
+        // Maps the registry, migrating metadatas.json when there is no snapshot yet
+        void openRegistry();
+
+        // The caller holds the unique assets lock for both
+        void trackResidency(const boost::uuids::uuid& id, const Asset& asset);
+        // Unreferenced assets, least recently used first, until the budget fits. Returned so they are destroyed after unlocking
+        std::vector<std::unique_ptr<Asset>> evictOverBudget(const boost::uuids::uuid& keep);
+        void trimToBudget(const boost::uuids::uuid& keep);
+        // Drops a loaded asset that isn't acquired, the caller holds the unique assets lock and destroys it after unlocking
+        std::unique_ptr<Asset> unloadAsset(const boost::uuids::uuid& id);
+
+        // Registered assets and their indexes, synchronized on its own so resolving never waits on assetsMutex
+        AssetRegistry registry;
+
+        // Guards the loaded assets, archives and overrides, held only around lookups and inserts, never while an asset is loaded or imported
+        mutable std::shared_mutex assetsMutex;
 
         std::unordered_map<boost::uuids::uuid, std::unique_ptr<Asset>, boost::hash<boost::uuids::uuid>> assets;
-        std::unordered_map<boost::uuids::uuid, std::shared_ptr<AssetInfo>, boost::hash<boost::uuids::uuid>> metadata;
-        std::unordered_map<std::string, boost::uuids::uuid> lookupNamesToUUIDs;
         std::unordered_map<std::type_index, AssetCreator> creators;
         std::unordered_map<std::type_index, AssetImporter> importers;
         std::unordered_map<std::type_index, AssetJsonSaver> jsonSavers;
         std::unordered_map<std::type_index, AssetLoader> loaders;
         std::unordered_map<std::type_index, MetadataSaver> metadataSavers;
         std::unordered_map<std::type_index, MetadataLoader> metadataLoaders;
+        std::unordered_map<std::type_index, ImportInputsResolver> importInputs;     // Only types that have any
+
+        struct SourceFileHash {
+            std::filesystem::file_time_type writeTime;
+            uintmax_t size;
+            uint64_t hash;
+        };
+        // Every mesh and material of a model hashes the same source file, remember it until the file changes
+        std::unordered_map<std::string, SourceFileHash> sourceFileHashes;
+        std::mutex sourceFileHashesMutex;
+        std::atomic<uint64_t> importerRuns = 0;
+
+        struct Residency {
+            uint32_t refCount = 0;
+            size_t bytes = 0;
+            std::list<boost::uuids::uuid>::iterator lruPosition;  // Valid while refCount is 0
+        };
+        // Guards the residency data, taken after assetsMutex so cache hits can reorder the LRU under a shared lock
+        mutable std::mutex residencyMutex;
+        std::unordered_map<boost::uuids::uuid, Residency, boost::hash<boost::uuids::uuid>> residency;
+        std::list<boost::uuids::uuid> evictionList;     // Unreferenced resident assets, most recently used first
+        size_t residentBytes = 0;
+        size_t memoryBudget = 0;
+        uint64_t evictionCount = 0;
+
+        // Filled as assets are imported and loaded, hot reload walks it from changed files to everything built on them
+        AssetDependencyGraph dependencyGraph;
+        // Created by enableHotReload, polled by the thread driving the frames
+        std::mutex watcherMutex;
+        std::unique_ptr<AssetWatcher> watcher;
+        // Loaded copies a reimport replaced, guarded by assetsMutex. Whoever pointed into them rebuilds after the reload
+        // that replaced them and they are destroyed at the start of the next one
+        std::vector<std::unique_ptr<Asset>> replacedAssets;
+
+        std::vector<std::unique_ptr<AssetArchive>> archives;
+        // Assets saved after the archives were built, their loose files are newer
+        std::unordered_set<boost::uuids::uuid, boost::hash<boost::uuids::uuid>> looseOverrides;
+
+        // Started on the first async load, declared last so its workers stop before the maps they use go away
+        std::once_flag loadQueueStarted;
+        std::unique_ptr<AssetLoadQueue> loadQueue;
 
     #ifdef AM_ENABLE_TESTS
         friend struct AssetManagerTestFixture;
@@ -4,13 +4,11 @@
 template <typename T>
 std::shared_ptr<T> AssetManager::getByUUID(const boost::uuids::uuid& id)
 {
-    auto it = assets.find(id);
-    if (it != assets.end()) {
-        return std::dynamic_pointer_cast<T>(std::shared_ptr<Asset>(it->second.get(), [](Asset *) {
-        }));
+    auto asset = getAsset(id);
+    if (!asset.has_value()) {
+        return nullptr;
     }
-    auto asset = getAssetData(id);
-    return std::dynamic_pointer_cast<T>(std::shared_ptr<Asset>(asset, [](Asset *) {
+    return std::dynamic_pointer_cast<T>(std::shared_ptr<Asset>(asset.value(), [](Asset *) {
     }));
 }
 
@@ -49,4 +47,9 @@ void AssetManager::RegisterAssetType()
         static_cast<T&>(asset).LoadAssetMetadata(doc);
     };
 
+    if constexpr (requires(const am::ImportContext& context) { { T::getImportInputs(context) } -> std::same_as<am::ImportInputs>; })
+    {
+        importInputs[type] = &T::getImportInputs;
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,403 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "AssetRegistry.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+
+namespace am
+{
+    namespace
+    {
+        // Journal records beyond this are folded into a new snapshot, grows with the snapshot so compaction stays rare
+        constexpr uint32_t kMinJournalRecordsBeforeCompaction = 1024;
+
+        uint32_t getCompactionThreshold(const AssetRegistrySnapshot* snapshot)
+        {
+            return std::max(kMinJournalRecordsBeforeCompaction, snapshot ? snapshot->size() / 4 : 0u);
+        }
+    }
+
+    std::shared_ptr<AssetInfo> AssetRegistry::makeInfo(const RegistryEntryView& entry)
+    {
+        auto info = std::make_shared<AssetInfo>(entry.id, std::string(entry.path), entry.type, entry.contentHash,
+                                                ImportContext(std::string(entry.importPath), entry.importType, entry.assimpIndex),
+                                                std::string(entry.lookUpName));
+        info->sourceHash = entry.sourceHash;
+        return info;
+    }
+
+    RegistryEntryView AssetRegistry::makeEntry(const AssetInfo& info)
+    {
+        return {info.id, info.type, info.importContext.assetType, info.importContext.assimpIndex, info.contentHash, info.sourceHash,
+                info.path, info.lookUpName, info.importContext.importPath};
+    }
+
+    bool AssetRegistry::open(const std::string& snapshotPath, const std::string& journalPath)
+    {
+        std::lock_guard writeLock(writeMutex);
+        this->snapshotPath = snapshotPath;
+
+        std::error_code error;
+        if (std::filesystem::exists(snapshotPath, error)) {
+            snapshot.store(AssetRegistrySnapshot::open(snapshotPath), std::memory_order_release);
+        }
+
+        // Newer than anything in the snapshot, so replayed records win
+        journal = AssetRegistryJournal::open(journalPath, [this](const RegistryEntryView& entry) {
+            if (entry.removed) {
+                if (auto info = find(entry.id))
+                    removeLocked(info);
+            } else {
+                // An asset reimported in place is journaled again, its earlier record's hashes must not stay indexed
+                if (auto previous = infos.find(entry.id); previous && previous.value())
+                    eraseIndexes(*previous.value());
+                addPending(makeInfo(entry));
+            }
+        });
+        if (!journal) {
+            spdlog::error("Asset registry journal unavailable, new assets won't be remembered: {}", journalPath);
+            return false;
+        }
+
+        if (journal->getRecordCount() > getCompactionThreshold(loadSnapshot().get()))
+            compactLocked();
+        return true;
+    }
+
+    std::shared_ptr<AssetInfo> AssetRegistry::find(const boost::uuids::uuid& id) const
+    {
+        if (auto info = infos.find(id))
+            return info.value();
+
+        auto current = loadSnapshot();
+        if (!current)
+            return nullptr;
+        auto entry = current->find(id);
+        if (!entry)
+            return nullptr;
+
+        // A removal that got in meanwhile left nullptr, which wins over the copy
+        auto copy = makeInfo(entry.value());
+        return infos.update(id, [&](auto& map) {
+            return map.try_emplace(id, std::move(copy)).first->second;
+        });
+    }
+
+    bool AssetRegistry::isRemoved(const boost::uuids::uuid& id) const
+    {
+        return infos.read(id, [&](const auto& map) {
+            auto it = map.find(id);
+            return it != map.end() && it->second == nullptr;
+        });
+    }
+
+    bool AssetRegistry::isCurrent(const RegistryEntryView& entry) const
+    {
+        return infos.read(entry.id, [&](const auto& map) {
+            auto it = map.find(entry.id);
+            if (it == map.end())
+                return true;
+            return it->second != nullptr && it->second->contentHash == entry.contentHash && it->second->sourceHash == entry.sourceHash;
+        });
+    }
+
+    std::optional<boost::uuids::uuid> AssetRegistry::findByLookupName(const std::string& lookUpName) const
+    {
+        if (auto id = lookupNames.find(lookUpName))
+            return id;
+        if (auto current = loadSnapshot()) {
+            if (auto entry = current->findByLookupName(lookUpName); entry && !isRemoved(entry->id))
+                return entry->id;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<boost::uuids::uuid> AssetRegistry::findByContentHash(uint64_t contentHash) const
+    {
+        if (contentHash == 0)
+            return std::nullopt;
+        if (auto id = contentHashes.find(contentHash))
+            return id;
+        if (auto current = loadSnapshot()) {
+            if (auto entry = current->findByContentHash(contentHash); entry && isCurrent(entry.value()))
+                return entry->id;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<boost::uuids::uuid> AssetRegistry::findBySourceHash(uint64_t sourceHash) const
+    {
+        if (sourceHash == 0)
+            return std::nullopt;
+        if (auto id = sourceHashes.find(sourceHash))
+            return id;
+        if (auto current = loadSnapshot()) {
+            if (auto entry = current->findBySourceHash(sourceHash); entry && isCurrent(entry.value()))
+                return entry->id;
+        }
+        if (auto id = sourceAliases.find(sourceHash); id && !isRemoved(id.value()))
+            return id;
+        return std::nullopt;
+    }
+
+    std::vector<boost::uuids::uuid> AssetRegistry::findByImportPath(const std::string& importPath) const
+    {
+        std::vector<boost::uuids::uuid> result = importPaths.find(importPath).value_or(std::vector<boost::uuids::uuid>{});
+        if (auto current = loadSnapshot()) {
+            const UuidSet pending(result.begin(), result.end());
+            for (const auto& entry : current->findByImportPath(importPath)) {
+                if (!pending.contains(entry.id) && !isRemoved(entry.id))
+                    result.push_back(entry.id);
+            }
+        }
+        return result;
+    }
+
+    AssetRegistry::UuidSet AssetRegistry::collectPending(std::optional<AssetType> type) const
+    {
+        UuidSet pending;
+        if (type) {
+            pending = types.find(type.value()).value_or(UuidSet{});
+        } else {
+            types.forEach([&](AssetType, const UuidSet& ids) {
+                pending.insert(ids.begin(), ids.end());
+            });
+        }
+        return pending;
+    }
+
+    std::vector<boost::uuids::uuid> AssetRegistry::findByType(AssetType type) const
+    {
+        // Pending first, the snapshot loaded after it already holds whatever compaction took out of it
+        const UuidSet pending = collectPending(type);
+        std::vector<boost::uuids::uuid> result(pending.begin(), pending.end());
+        if (auto current = loadSnapshot()) {
+            const RegistryTypeRange range = current->getTypeRange(type);
+            result.reserve(result.size() + range.count);
+            for (uint32_t i = range.first; i < range.first + range.count; ++i) {
+                const auto entry = current->at(i);
+                if (!pending.contains(entry.id) && !isRemoved(entry.id))
+                    result.push_back(entry.id);
+            }
+        }
+        return result;
+    }
+
+    bool AssetRegistry::isLookupNameTaken(const std::string& lookUpName) const
+    {
+        return findByLookupName(lookUpName).has_value();
+    }
+
+    std::string AssetRegistry::findFreeLookupName(const std::string& lookUpName) const
+    {
+        if (!isLookupNameTaken(lookUpName))
+            return lookUpName;
+
+        const std::filesystem::path p(lookUpName);
+        const std::string extension = p.extension().string();
+        std::string candidate = p.stem().string() + "_";
+        const size_t baseLength = candidate.size();
+        for (int counter = 1;; ++counter) {
+            candidate.resize(baseLength);
+            candidate += std::to_string(counter);
+            candidate += extension;
+            if (!isLookupNameTaken(candidate))
+                return candidate;
+        }
+    }
+
+    void AssetRegistry::forEach(const std::function<void(const RegistryEntryView&)>& visit) const
+    {
+        // Collected first so visit runs without any shard locked and may call back into the registry
+        const UuidSet pending = collectPending(std::nullopt);
+        std::vector<std::shared_ptr<AssetInfo>> pendingInfos;
+        pendingInfos.reserve(pending.size());
+        for (const auto& id : pending) {
+            if (auto info = infos.find(id); info && info.value())
+                pendingInfos.push_back(std::move(info.value()));
+        }
+
+        auto current = loadSnapshot();
+        for (const auto& info : pendingInfos)
+            visit(makeEntry(*info));
+        if (current) {
+            for (uint32_t i = 0; i < current->size(); ++i) {
+                const auto entry = current->at(i);
+                if (!pending.contains(entry.id) && !isRemoved(entry.id))
+                    visit(entry);
+            }
+        }
+    }
+
+    boost::uuids::uuid AssetRegistry::insert(const std::shared_ptr<AssetInfo>& info, bool deduplicate)
+    {
+        std::lock_guard writeLock(writeMutex);
+        if (deduplicate) {
+            if (auto existing = findByContentHash(info->contentHash))
+                return existing.value();
+        }
+
+        // Writers are serialized, so the name is still free when it is indexed below
+        info->lookUpName = findFreeLookupName(info->lookUpName);
+        addPending(info);
+        appendToJournal(*info, false);
+        return info->id;
+    }
+
+    bool AssetRegistry::remove(const boost::uuids::uuid& id)
+    {
+        std::lock_guard writeLock(writeMutex);
+        auto info = find(id);
+        if (!info)
+            return false;
+
+        removeLocked(info);
+        appendToJournal(*info, true);
+        return true;
+    }
+
+    bool AssetRegistry::update(const std::shared_ptr<AssetInfo>& info, const std::function<void(AssetInfo&)>& change)
+    {
+        std::lock_guard writeLock(writeMutex);
+        if (find(info->id) != info)
+            return false;
+
+        // Changed under the lock of its shard, so isCurrent never compares against half written hashes
+        eraseIndexes(*info);
+        infos.update(info->id, [&](auto&) { change(*info); });
+        addPending(info);
+        appendToJournal(*info, false);
+        return true;
+    }
+
+    void AssetRegistry::addSourceAlias(uint64_t sourceHash, const boost::uuids::uuid& id)
+    {
+        if (sourceHash != 0)
+            sourceAliases.update(sourceHash, [&](auto& map) { map.try_emplace(sourceHash, id); });
+    }
+
+    bool AssetRegistry::reset(const std::vector<std::shared_ptr<AssetInfo>>& newInfos)
+    {
+        std::lock_guard writeLock(writeMutex);
+        snapshot.store(nullptr, std::memory_order_release);
+        clearPending();
+        infos.clear();
+        sourceAliases.clear();
+        for (const auto& info : newInfos)
+            addPending(info);
+        return compactLocked();
+    }
+
+    bool AssetRegistry::compact()
+    {
+        std::lock_guard writeLock(writeMutex);
+        return compactLocked();
+    }
+
+    void AssetRegistry::addPending(const std::shared_ptr<AssetInfo>& info)
+    {
+        const auto& id = info->id;
+        infos.insertOrAssign(id, info);
+        lookupNames.insertOrAssign(info->lookUpName, id);
+        if (info->contentHash != 0)
+            contentHashes.update(info->contentHash, [&](auto& map) { map.try_emplace(info->contentHash, id); });
+        if (info->sourceHash != 0)
+            sourceHashes.update(info->sourceHash, [&](auto& map) { map.try_emplace(info->sourceHash, id); });
+        if (!info->importContext.importPath.empty())
+            importPaths.update(info->importContext.importPath, [&](auto& map) { map[info->importContext.importPath].push_back(id); });
+        types.update(info->type, [&](auto& map) { map[info->type].insert(id); });
+    }
+
+    void AssetRegistry::removeLocked(const std::shared_ptr<AssetInfo>& info)
+    {
+        // Kept as nullptr rather than erased, so the snapshot entry of the asset stays hidden
+        infos.insertOrAssign(info->id, nullptr);
+        eraseIndexes(*info);
+    }
+
+    void AssetRegistry::eraseIndexes(const AssetInfo& info)
+    {
+        const auto& id = info.id;
+        auto eraseIfOwned = [&](auto& index, const auto& key) {
+            index.update(key, [&](auto& map) {
+                if (auto it = map.find(key); it != map.end() && it->second == id)
+                    map.erase(it);
+            });
+        };
+        eraseIfOwned(lookupNames, info.lookUpName);
+        eraseIfOwned(contentHashes, static_cast<uint64_t>(info.contentHash));
+        eraseIfOwned(sourceHashes, info.sourceHash);
+        importPaths.update(info.importContext.importPath, [&](auto& map) {
+            auto it = map.find(info.importContext.importPath);
+            if (it == map.end())
+                return;
+            std::erase(it->second, id);
+            if (it->second.empty())
+                map.erase(it);
+        });
+        types.update(info.type, [&](auto& map) {
+            if (auto it = map.find(info.type); it != map.end())
+                it->second.erase(id);
+        });
+    }
+
+    void AssetRegistry::clearPending()
+    {
+        lookupNames.clear();
+        contentHashes.clear();
+        sourceHashes.clear();
+        importPaths.clear();
+        types.clear();
+    }
+
+    void AssetRegistry::appendToJournal(const AssetInfo& info, bool removed)
+    {
+        if (!journal)
+            return;
+
+        RegistryEntryView entry = makeEntry(info);
+        entry.removed = removed;
+        if (journal->append(entry) && journal->getRecordCount() > getCompactionThreshold(loadSnapshot().get()))
+            compactLocked();
+    }
+
+    bool AssetRegistry::compactLocked()
+    {
+        // Writers wait on writeMutex, so this is every registered asset. The views point into the pending infos
+        // and the current snapshot, both stay alive until the new one is written
+        auto current = loadSnapshot();
+        std::vector<std::shared_ptr<AssetInfo>> pendingInfos;
+        std::vector<RegistryEntryView> entries;
+        const UuidSet pending = collectPending(std::nullopt);
+        for (const auto& id : pending) {
+            if (auto info = infos.find(id); info && info.value()) {
+                entries.push_back(makeEntry(*info.value()));
+                pendingInfos.push_back(std::move(info.value()));
+            }
+        }
+        if (current) {
+            for (uint32_t i = 0; i < current->size(); ++i) {
+                const auto entry = current->at(i);
+                if (!pending.contains(entry.id) && !isRemoved(entry.id))
+                    entries.push_back(entry);
+            }
+        }
+
+        if (!AssetRegistrySnapshot::write(snapshotPath, entries))
+            return false;
+        std::shared_ptr<const AssetRegistrySnapshot> written = AssetRegistrySnapshot::open(snapshotPath);
+        if (!written)
+            return false;
+
+        // Published before the pending indexes are emptied, a reader that misses an asset there finds it in the snapshot
+        snapshot.store(std::move(written), std::memory_order_release);
+        clearPending();
+
+        spdlog::info("Compacted asset registry to {} entries", entries.size());
+        return !journal || journal->clear();
+    }
+}
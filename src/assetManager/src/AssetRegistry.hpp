@@ -0,0 +1,115 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef ASSETREGISTRY_HPP
+#define ASSETREGISTRY_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+#include "../include/AssetInfo.hpp"
+#include "../include/AssetTypes.hpp"
+#include "AssetRegistryFile.hpp"
+#include "ShardedMap.hpp"
+
+namespace am
+{
+    // Every registered asset, readable from any thread while imports add to it.
+    // Assets in the snapshot are answered from its mapping, the ones registered since live in sharded maps with the
+    // same secondary indexes. Readers only take the shared lock of the shard a key falls in, writers are serialized
+    // among themselves and lock each shard they change briefly. Compaction publishes a new snapshot atomically,
+    // RCU style: a reader keeps the snapshot it loaded alive until it is done with it.
+    class AssetRegistry
+    {
+    public:
+        AssetRegistry() = default;
+        AssetRegistry(const AssetRegistry&) = delete;
+        AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+        // Maps the snapshot if there is one and replays the journal, which is created when missing
+        bool open(const std::string& snapshotPath, const std::string& journalPath);
+        [[nodiscard]] bool hasSnapshot() const { return loadSnapshot() != nullptr; }
+
+        // nullptr when unknown or removed. Snapshot entries are copied out the first time they are asked for,
+        // later calls share that copy
+        [[nodiscard]] std::shared_ptr<AssetInfo> find(const boost::uuids::uuid& id) const;
+        [[nodiscard]] std::optional<boost::uuids::uuid> findByLookupName(const std::string& lookUpName) const;
+        [[nodiscard]] std::optional<boost::uuids::uuid> findByContentHash(uint64_t contentHash) const;
+        [[nodiscard]] std::optional<boost::uuids::uuid> findBySourceHash(uint64_t sourceHash) const;
+        // Every asset imported from the file, a model brings its meshes and materials along
+        [[nodiscard]] std::vector<boost::uuids::uuid> findByImportPath(const std::string& importPath) const;
+        [[nodiscard]] std::vector<boost::uuids::uuid> findByType(AssetType type) const;
+
+        [[nodiscard]] bool isLookupNameTaken(const std::string& lookUpName) const;
+        // name_1.ext, name_2.ext... until one is free
+        [[nodiscard]] std::string findFreeLookupName(const std::string& lookUpName) const;
+        // Assets registered or removed while visiting may or may not be visited
+        void forEach(const std::function<void(const RegistryEntryView&)>& visit) const;
+
+        // Registers info under the first free variant of its lookup name, written back to info before it is shared.
+        // With deduplicate, an asset already registered with the same content hash is returned instead and info is dropped
+        boost::uuids::uuid insert(const std::shared_ptr<AssetInfo>& info, bool deduplicate);
+        bool remove(const boost::uuids::uuid& id);
+        // Changes a registered asset in place, for a reimport that keeps its id. Its indexes and the journal follow,
+        // whoever holds info sees the change. False if info isn't the registered asset
+        bool update(const std::shared_ptr<AssetInfo>& info, const std::function<void(AssetInfo&)>& change);
+        // Routes an import key to an existing asset until the registry is reopened
+        void addSourceAlias(uint64_t sourceHash, const boost::uuids::uuid& id);
+        // Replaces every registered asset and rewrites the snapshot from them
+        bool reset(const std::vector<std::shared_ptr<AssetInfo>>& infos);
+        // Writes every registered asset to a new snapshot and empties the journal
+        bool compact();
+
+        static std::shared_ptr<AssetInfo> makeInfo(const RegistryEntryView& entry);
+        // Views into info, valid as long as it is
+        static RegistryEntryView makeEntry(const AssetInfo& info);
+
+    private:
+        using UuidHash = boost::hash<boost::uuids::uuid>;
+        using UuidSet = std::unordered_set<boost::uuids::uuid, UuidHash>;
+
+        std::shared_ptr<const AssetRegistrySnapshot> loadSnapshot() const { return snapshot.load(std::memory_order_acquire); }
+        [[nodiscard]] bool isRemoved(const boost::uuids::uuid& id) const;
+        // False for a removed asset and for one updated since, whose snapshot entry still has the hashes it had
+        [[nodiscard]] bool isCurrent(const RegistryEntryView& entry) const;
+        // Ids of the assets registered since the snapshot, of one type or all of them
+        [[nodiscard]] UuidSet collectPending(std::optional<AssetType> type) const;
+
+        // The caller holds writeMutex for the rest
+        void addPending(const std::shared_ptr<AssetInfo>& info);
+        void removeLocked(const std::shared_ptr<AssetInfo>& info);
+        void eraseIndexes(const AssetInfo& info);
+        void clearPending();
+        void appendToJournal(const AssetInfo& info, bool removed);
+        bool compactLocked();
+
+        std::atomic<std::shared_ptr<const AssetRegistrySnapshot>> snapshot;
+        // Assets registered since the snapshot, copies of the snapshot entries asked for, nullptr once removed
+        mutable ShardedMap<boost::uuids::uuid, std::shared_ptr<AssetInfo>, UuidHash> infos;
+        // Secondary indexes of the assets registered since the snapshot, its own tables cover the rest.
+        // Compaction empties them after publishing the snapshot that took their assets over, so readers look here first
+        ShardedMap<std::string, boost::uuids::uuid> lookupNames;
+        ShardedMap<uint64_t, boost::uuids::uuid> contentHashes;
+        ShardedMap<uint64_t, boost::uuids::uuid> sourceHashes;
+        ShardedMap<std::string, std::vector<boost::uuids::uuid>> importPaths;
+        ShardedMap<AssetType, UuidSet> types;
+        // Sources whose import turned out to duplicate another asset, never written
+        ShardedMap<uint64_t, boost::uuids::uuid> sourceAliases;
+
+        // Serializes inserts, removals and compaction, readers never take it
+        std::mutex writeMutex;
+        std::string snapshotPath;
+        std::unique_ptr<AssetRegistryJournal> journal;
+    };
+}
+
+#endif //ASSETREGISTRY_HPP
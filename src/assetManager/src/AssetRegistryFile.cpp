@@ -0,0 +1,450 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "AssetRegistryFile.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <boost/hash2/xxhash.hpp>
+#include <spdlog/spdlog.h>
+
+#include "AssetArchive.hpp"
+
+namespace am
+{
+    namespace
+    {
+        constexpr uint32_t kEmptyBucket = UINT32_MAX;
+
+        RegistryString appendString(std::string& strings, std::string_view value)
+        {
+            RegistryString result{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size())};
+            strings.append(value);
+            return result;
+        }
+
+        RegistryRecord encodeRecord(const RegistryEntryView& entry, std::string& strings)
+        {
+            RegistryRecord record{};
+            std::memcpy(record.uuid, &entry.id, sizeof(record.uuid));
+            record.type = static_cast<uint32_t>(entry.type);
+            record.importType = static_cast<uint32_t>(entry.importType);
+            record.assimpIndex = entry.assimpIndex;
+            record.flags = entry.removed ? kRegistryRecordRemoved : 0;
+            record.contentHash = entry.contentHash;
+            record.sourceHash = entry.sourceHash;
+            record.path = appendString(strings, entry.path);
+            record.lookUpName = appendString(strings, entry.lookUpName);
+            record.importPath = appendString(strings, entry.importPath);
+            return record;
+        }
+
+        // Strings outside the block decode as empty rather than reading past the mapping
+        std::string_view decodeString(const RegistryString& value, std::string_view strings)
+        {
+            if (value.offset > strings.size() || value.size > strings.size() - value.offset) {
+                spdlog::error("Asset registry string out of range");
+                return {};
+            }
+            return strings.substr(value.offset, value.size);
+        }
+
+        RegistryEntryView decodeRecord(const RegistryRecord& record, std::string_view strings)
+        {
+            RegistryEntryView entry{};
+            std::memcpy(&entry.id, record.uuid, sizeof(record.uuid));
+            entry.type = static_cast<AssetType>(record.type);
+            entry.importType = static_cast<AssetType>(record.importType);
+            entry.assimpIndex = record.assimpIndex;
+            entry.removed = (record.flags & kRegistryRecordRemoved) != 0;
+            entry.contentHash = record.contentHash;
+            entry.sourceHash = record.sourceHash;
+            entry.path = decodeString(record.path, strings);
+            entry.lookUpName = decodeString(record.lookUpName, strings);
+            entry.importPath = decodeString(record.importPath, strings);
+            return entry;
+        }
+
+        uint32_t checksum(const RegistryRecord& record, std::string_view strings)
+        {
+            boost::hash2::xxhash_64 hasher;
+            hasher.update(&record, sizeof(record));
+            hasher.update(strings.data(), strings.size());
+            return static_cast<uint32_t>(hasher.result());
+        }
+    }
+
+    uint64_t registry::hashString(std::string_view value)
+    {
+        boost::hash2::xxhash_64 hasher;
+        hasher.update(value.data(), value.size());
+        return hasher.result();
+    }
+
+    uint64_t registry::hashValue(uint64_t value)
+    {
+        value ^= value >> 30;
+        value *= 0xBF58476D1CE4E5B9ull;
+        value ^= value >> 27;
+        value *= 0x94D049BB133111EBull;
+        value ^= value >> 31;
+        return value;
+    }
+
+    AssetRegistrySnapshot::AssetRegistrySnapshot(std::shared_ptr<const MappedFile> file) : file(std::move(file))
+    {
+    }
+
+    std::unique_ptr<AssetRegistrySnapshot> AssetRegistrySnapshot::open(const std::string& path)
+    {
+        auto file = MappedFile::open(path);
+        if (!file)
+            return nullptr;
+
+        const auto bytes = file->bytes();
+        if (bytes.size() < sizeof(RegistryHeader)) {
+            spdlog::error("Asset registry is too small: {}", path);
+            return nullptr;
+        }
+
+        RegistryHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (header.magic != kAssetRegistryMagic || header.version != kAssetRegistryVersion || header.headerSize < sizeof(RegistryHeader)) {
+            spdlog::error("Not a supported asset registry: {}", path);
+            return nullptr;
+        }
+
+        const uint64_t recordsBytes = static_cast<uint64_t>(header.recordCount) * sizeof(RegistryRecord);
+        const uint64_t bucketsBytes = static_cast<uint64_t>(header.bucketCount) * TableCount * sizeof(uint32_t);
+        if (!std::has_single_bit(header.bucketCount) || header.bucketCount < header.recordCount ||
+            header.recordsOffset % alignof(RegistryRecord) != 0 || header.bucketsOffset % alignof(uint32_t) != 0 ||
+            header.recordsOffset > bytes.size() || recordsBytes > bytes.size() - header.recordsOffset ||
+            header.bucketsOffset > bytes.size() || bucketsBytes > bytes.size() - header.bucketsOffset ||
+            header.stringsOffset > bytes.size() || header.stringsSize > bytes.size() - header.stringsOffset) {
+            spdlog::error("Corrupt asset registry: {}", path);
+            return nullptr;
+        }
+        for (const auto& range : header.typeRanges) {
+            if (range.first > header.recordCount || range.count > header.recordCount - range.first) {
+                spdlog::error("Corrupt type ranges in asset registry: {}", path);
+                return nullptr;
+            }
+        }
+
+        // Records and buckets are checked as they are used, opening stays independent of the registry size
+        std::unique_ptr<AssetRegistrySnapshot> snapshot(new AssetRegistrySnapshot(file));
+        snapshot->records = {reinterpret_cast<const RegistryRecord*>(bytes.data() + header.recordsOffset), header.recordCount};
+        snapshot->buckets = {reinterpret_cast<const uint32_t*>(bytes.data() + header.bucketsOffset), header.bucketCount * TableCount};
+        snapshot->bucketCount = header.bucketCount;
+        snapshot->strings = {reinterpret_cast<const char*>(bytes.data() + header.stringsOffset), header.stringsSize};
+        std::copy(std::begin(header.typeRanges), std::end(header.typeRanges), snapshot->typeRanges.begin());
+        return snapshot;
+    }
+
+    RegistryEntryView AssetRegistrySnapshot::at(uint32_t index) const
+    {
+        return decodeRecord(records[index], strings);
+    }
+
+    RegistryTypeRange AssetRegistrySnapshot::getTypeRange(AssetType type) const
+    {
+        const auto slot = static_cast<uint32_t>(type);
+        return slot < typeRanges.size() ? typeRanges[slot] : RegistryTypeRange{0, 0};
+    }
+
+    template<typename Matches, typename Visit>
+    void AssetRegistrySnapshot::findIn(Table table, uint64_t hash, Matches matches, Visit visit) const
+    {
+        if (bucketCount == 0)
+            return;
+
+        const auto tableBuckets = buckets.subspan(static_cast<size_t>(table) * bucketCount, bucketCount);
+        const size_t mask = bucketCount - 1;
+        size_t slot = static_cast<size_t>(hash) & mask;
+        for (size_t probe = 0; probe < bucketCount; ++probe) {
+            const uint32_t index = tableBuckets[slot];
+            if (index == kEmptyBucket)
+                return;
+            if (index >= records.size()) {
+                spdlog::error("Corrupt hash table in asset registry: {}", file->getPath());
+                return;
+            }
+            if (matches(records[index]) && !visit(at(index)))
+                return;
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    template<typename Matches>
+    std::optional<RegistryEntryView> AssetRegistrySnapshot::findFirstIn(Table table, uint64_t hash, Matches matches) const
+    {
+        std::optional<RegistryEntryView> result;
+        findIn(table, hash, matches, [&](const RegistryEntryView& entry) {
+            result = entry;
+            return false;
+        });
+        return result;
+    }
+
+    std::optional<RegistryEntryView> AssetRegistrySnapshot::find(const boost::uuids::uuid& id) const
+    {
+        return findFirstIn(ById, AssetArchive::hashId(id), [&](const RegistryRecord& record) {
+            return std::memcmp(record.uuid, &id, sizeof(record.uuid)) == 0;
+        });
+    }
+
+    std::optional<RegistryEntryView> AssetRegistrySnapshot::findByLookupName(std::string_view lookUpName) const
+    {
+        return findFirstIn(ByLookupName, registry::hashString(lookUpName), [&](const RegistryRecord& record) {
+            return decodeString(record.lookUpName, strings) == lookUpName;
+        });
+    }
+
+    std::optional<RegistryEntryView> AssetRegistrySnapshot::findByContentHash(uint64_t contentHash) const
+    {
+        if (contentHash == 0)
+            return std::nullopt;
+        return findFirstIn(ByContentHash, registry::hashValue(contentHash), [&](const RegistryRecord& record) {
+            return record.contentHash == contentHash;
+        });
+    }
+
+    std::optional<RegistryEntryView> AssetRegistrySnapshot::findBySourceHash(uint64_t sourceHash) const
+    {
+        if (sourceHash == 0)
+            return std::nullopt;
+        return findFirstIn(BySourceHash, registry::hashValue(sourceHash), [&](const RegistryRecord& record) {
+            return record.sourceHash == sourceHash;
+        });
+    }
+
+    std::vector<RegistryEntryView> AssetRegistrySnapshot::findByImportPath(std::string_view importPath) const
+    {
+        std::vector<RegistryEntryView> result;
+        if (importPath.empty())
+            return result;
+        findIn(ByImportPath, registry::hashString(importPath), [&](const RegistryRecord& record) {
+            return decodeString(record.importPath, strings) == importPath;
+        }, [&](const RegistryEntryView& entry) {
+            result.push_back(entry);
+            return true;
+        });
+        return result;
+    }
+
+    bool AssetRegistrySnapshot::write(const std::string& path, std::span<const RegistryEntryView> entries)
+    {
+        RegistryHeader header{};
+        header.magic = kAssetRegistryMagic;
+        header.version = kAssetRegistryVersion;
+        header.headerSize = sizeof(RegistryHeader);
+        header.recordCount = static_cast<uint32_t>(entries.size());
+        header.bucketCount = std::bit_ceil(std::max<uint32_t>(header.recordCount * 2, 1));
+        header.recordsOffset = alignBinaryOffset(sizeof(RegistryHeader));
+        header.bucketsOffset = header.recordsOffset + entries.size() * sizeof(RegistryRecord);
+        header.stringsOffset = header.bucketsOffset + static_cast<uint64_t>(header.bucketCount) * TableCount * sizeof(uint32_t);
+
+        // Stable, so entries of one type keep the order they were given in
+        std::vector<uint32_t> order(entries.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return static_cast<uint32_t>(entries[a].type) < static_cast<uint32_t>(entries[b].type);
+        });
+
+        std::vector<RegistryRecord> records;
+        records.reserve(entries.size());
+        std::string strings;
+        for (uint32_t i = 0; i < order.size(); ++i) {
+            const auto& entry = entries[order[i]];
+            const auto slot = static_cast<uint32_t>(entry.type);
+            if (slot >= kRegistryTypeSlots) {
+                spdlog::error("Asset type {} doesn't fit the asset registry", slot);
+                return false;
+            }
+            auto& range = header.typeRanges[slot];
+            if (range.count++ == 0)
+                range.first = i;
+            records.push_back(encodeRecord(entry, strings));
+        }
+        header.stringsSize = strings.size();
+
+        std::vector<uint32_t> buckets(static_cast<size_t>(header.bucketCount) * TableCount, kEmptyBucket);
+        const size_t mask = header.bucketCount - 1;
+        auto insert = [&](Table table, uint64_t hash, uint32_t index, auto sameKey) {
+            uint32_t* tableBuckets = buckets.data() + static_cast<size_t>(table) * header.bucketCount;
+            size_t slot = static_cast<size_t>(hash) & mask;
+            while (tableBuckets[slot] != kEmptyBucket) {
+                if (sameKey(entries[order[tableBuckets[slot]]]))
+                    return;
+                slot = (slot + 1) & mask;
+            }
+            tableBuckets[slot] = index;
+        };
+
+        for (uint32_t i = 0; i < order.size(); ++i) {
+            const auto& entry = entries[order[i]];
+            insert(ById, AssetArchive::hashId(entry.id), i, [&](const RegistryEntryView& other) { return other.id == entry.id; });
+            insert(ByLookupName, registry::hashString(entry.lookUpName), i,
+                   [&](const RegistryEntryView& other) { return other.lookUpName == entry.lookUpName; });
+            if (entry.contentHash != 0) {
+                insert(ByContentHash, registry::hashValue(entry.contentHash), i,
+                       [&](const RegistryEntryView& other) { return other.contentHash == entry.contentHash; });
+            }
+            if (entry.sourceHash != 0) {
+                insert(BySourceHash, registry::hashValue(entry.sourceHash), i,
+                       [&](const RegistryEntryView& other) { return other.sourceHash == entry.sourceHash; });
+            }
+            if (!entry.importPath.empty())
+                insert(ByImportPath, registry::hashString(entry.importPath), i, [](const RegistryEntryView&) { return false; });
+        }
+
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream ofs(tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!ofs.is_open()) {
+                spdlog::error("Failed to open asset registry for writing: {}", tempPath);
+                return false;
+            }
+
+            const std::vector<char> padding(header.recordsOffset - sizeof(RegistryHeader), 0);
+            ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            ofs.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+            ofs.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(RegistryRecord)));
+            ofs.write(reinterpret_cast<const char*>(buckets.data()), static_cast<std::streamsize>(buckets.size() * sizeof(uint32_t)));
+            ofs.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+            ofs.close();
+            if (!ofs) {
+                spdlog::error("Failed to write asset registry: {}", tempPath);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            spdlog::error("Failed to replace asset registry {}: {}", path, error.message());
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+        return true;
+    }
+
+    std::unique_ptr<AssetRegistryJournal> AssetRegistryJournal::open(const std::string& path,
+                                                                     const std::function<void(const RegistryEntryView&)>& visit)
+    {
+        std::unique_ptr<AssetRegistryJournal> journal(new AssetRegistryJournal(path));
+
+        std::error_code error;
+        if (std::filesystem::exists(path, error)) {
+            std::vector<char> bytes;
+            {
+                std::ifstream ifs(path, std::ios::binary | std::ios::in | std::ios::ate);
+                bytes.resize(static_cast<size_t>(ifs.tellg()));
+                ifs.seekg(0);
+                ifs.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+                if (!ifs) {
+                    spdlog::error("Failed to read asset registry journal: {}", path);
+                    return nullptr;
+                }
+            }
+
+            JournalHeader header{};
+            size_t valid = 0;
+            if (bytes.size() >= sizeof(JournalHeader)) {
+                std::memcpy(&header, bytes.data(), sizeof(header));
+                if (header.magic == kAssetJournalMagic && header.version == kAssetJournalVersion && header.headerSize >= sizeof(JournalHeader))
+                    valid = header.headerSize;
+                else
+                    spdlog::error("Not a supported asset registry journal, starting a new one: {}", path);
+            }
+
+            while (valid != 0 && bytes.size() - valid >= sizeof(JournalRecordHeader)) {
+                JournalRecordHeader recordHeader;
+                std::memcpy(&recordHeader, bytes.data() + valid, sizeof(recordHeader));
+                const size_t payload = valid + sizeof(JournalRecordHeader);
+                if (recordHeader.size < sizeof(RegistryRecord) || recordHeader.size > bytes.size() - payload)
+                    break;
+
+                RegistryRecord record;
+                std::memcpy(&record, bytes.data() + payload, sizeof(record));
+                const std::string_view strings(bytes.data() + payload + sizeof(record), recordHeader.size - sizeof(record));
+                if (checksum(record, strings) != recordHeader.checksum)
+                    break;
+
+                visit(decodeRecord(record, strings));
+                ++journal->recordCount;
+                valid = payload + recordHeader.size;
+            }
+
+            if (valid != bytes.size()) {
+                spdlog::warn("Dropping {} bytes torn off the end of asset registry journal {}", bytes.size() - valid, path);
+                std::filesystem::resize_file(path, valid, error);
+                if (error) {
+                    spdlog::error("Failed to truncate asset registry journal {}: {}", path, error.message());
+                    return nullptr;
+                }
+            }
+        }
+
+        if (!journal->openForAppend())
+            return nullptr;
+        return journal;
+    }
+
+    bool AssetRegistryJournal::openForAppend()
+    {
+        std::error_code error;
+        const bool empty = !std::filesystem::exists(path, error) || std::filesystem::file_size(path, error) == 0;
+
+        stream.open(path, std::ios::binary | std::ios::out | std::ios::app);
+        if (!stream.is_open()) {
+            spdlog::error("Failed to open asset registry journal: {}", path);
+            return false;
+        }
+
+        if (empty) {
+            JournalHeader header{};
+            header.magic = kAssetJournalMagic;
+            header.version = kAssetJournalVersion;
+            header.headerSize = sizeof(JournalHeader);
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.flush();
+        }
+        return static_cast<bool>(stream);
+    }
+
+    bool AssetRegistryJournal::append(const RegistryEntryView& entry)
+    {
+        std::string strings;
+        const RegistryRecord record = encodeRecord(entry, strings);
+        const JournalRecordHeader recordHeader{static_cast<uint32_t>(sizeof(record) + strings.size()), checksum(record, strings)};
+
+        // One write per record keeps a crash from interleaving half of one record with the next
+        buffer.resize(sizeof(recordHeader) + sizeof(record) + strings.size());
+        std::memcpy(buffer.data(), &recordHeader, sizeof(recordHeader));
+        std::memcpy(buffer.data() + sizeof(recordHeader), &record, sizeof(record));
+        std::memcpy(buffer.data() + sizeof(recordHeader) + sizeof(record), strings.data(), strings.size());
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        stream.flush();
+
+        if (!stream) {
+            spdlog::error("Failed to append to asset registry journal: {}", path);
+            return false;
+        }
+        ++recordCount;
+        return true;
+    }
+
+    bool AssetRegistryJournal::clear()
+    {
+        stream.close();
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        recordCount = 0;
+        return openForAppend();
+    }
+}
@@ -0,0 +1,182 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef ASSETREGISTRYFILE_HPP
+#define ASSETREGISTRYFILE_HPP
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/uuid/uuid.hpp>
+
+#include "../include/AssetTypes.hpp"
+#include "../include/BinaryContainer.hpp"
+
+namespace am
+{
+    constexpr uint32_t kAssetRegistryMagic = makeFourCC('R', 'R', 'E', 'G');
+    constexpr uint32_t kAssetJournalMagic = makeFourCC('R', 'J', 'N', 'L');
+    constexpr uint16_t kAssetRegistryVersion = 2;   // 2: records sorted by type, import path table
+    constexpr uint16_t kAssetJournalVersion = 1;
+    // Room for every AssetType in the snapshot header
+    constexpr uint32_t kRegistryTypeSlots = 16;
+    static_assert(static_cast<uint32_t>(AssetType::Other) < kRegistryTypeSlots);
+
+    constexpr uint32_t kRegistryRecordRemoved = 1u << 0;   // Journal only, the asset was unregistered
+
+    // One registered asset, the strings point into whatever it was read from
+    struct RegistryEntryView {
+        boost::uuids::uuid id;
+        AssetType type;
+        AssetType importType;
+        int32_t assimpIndex;
+        uint64_t contentHash;   // 0 for created assets
+        uint64_t sourceHash;    // 0 when not imported from a file
+        std::string_view path;
+        std::string_view lookUpName;
+        std::string_view importPath;
+        bool removed = false;
+    };
+
+    struct RegistryString {
+        uint32_t offset;        // Into the string bytes of the snapshot or journal record
+        uint32_t size;
+    };
+
+    struct RegistryRecord {
+        uint8_t uuid[16];
+        uint32_t type;          // AssetType
+        uint32_t importType;    // AssetType
+        int32_t assimpIndex;
+        uint32_t flags;         // kRegistryRecord*
+        uint64_t contentHash;
+        uint64_t sourceHash;
+        RegistryString path;
+        RegistryString lookUpName;
+        RegistryString importPath;
+    };
+    static_assert(sizeof(RegistryRecord) == 72);
+
+    struct RegistryTypeRange {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // Snapshot layout:
+    //   RegistryHeader | RegistryRecord[recordCount] | uint32 buckets[5][bucketCount] | string bytes
+    // Records are sorted by type, so listing one type reads a single range of them. The five bucket arrays are
+    // open addressing tables of record indices keyed by uuid, lookup name, content hash, source hash and import
+    // path, so opening the snapshot only maps it and lookups touch a few pages. Import paths are shared by every
+    // asset of a model, that table keeps all of them.
+    struct RegistryHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;
+        uint32_t recordCount;
+        uint32_t bucketCount;       // Power of two, per table
+        uint64_t recordsOffset;
+        uint64_t bucketsOffset;
+        uint64_t stringsOffset;
+        uint64_t stringsSize;
+        RegistryTypeRange typeRanges[kRegistryTypeSlots];   // Indexed by AssetType
+    };
+    static_assert(sizeof(RegistryHeader) == 176);
+
+    // Journal layout:
+    //   JournalHeader | { JournalRecordHeader | RegistryRecord | string bytes }*
+    struct JournalHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;
+        uint64_t reserved;
+    };
+    static_assert(sizeof(JournalHeader) == 16);
+
+    struct JournalRecordHeader {
+        uint32_t size;              // Bytes that follow, record and strings
+        uint32_t checksum;          // Low half of their xxhash_64, catches records torn by a crash
+    };
+    static_assert(sizeof(JournalRecordHeader) == 8);
+
+    // Read only registry snapshot, mapped once and never parsed as a whole
+    class AssetRegistrySnapshot
+    {
+    public:
+        static std::unique_ptr<AssetRegistrySnapshot> open(const std::string& path);
+        // Later entries with an id, lookup name or hash already written don't replace the earlier one in that table.
+        // Hashes of 0 aren't indexed
+        static bool write(const std::string& path, std::span<const RegistryEntryView> entries);
+
+        [[nodiscard]] std::optional<RegistryEntryView> find(const boost::uuids::uuid& id) const;
+        [[nodiscard]] std::optional<RegistryEntryView> findByLookupName(std::string_view lookUpName) const;
+        [[nodiscard]] std::optional<RegistryEntryView> findByContentHash(uint64_t contentHash) const;
+        [[nodiscard]] std::optional<RegistryEntryView> findBySourceHash(uint64_t sourceHash) const;
+        [[nodiscard]] std::vector<RegistryEntryView> findByImportPath(std::string_view importPath) const;
+
+        [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(records.size()); }
+        [[nodiscard]] RegistryEntryView at(uint32_t index) const;
+        // Indices of the records of one type, at(first) to at(first + count - 1)
+        [[nodiscard]] RegistryTypeRange getTypeRange(AssetType type) const;
+
+    private:
+        enum Table : uint32_t { ById, ByLookupName, ByContentHash, BySourceHash, ByImportPath, TableCount };
+
+        explicit AssetRegistrySnapshot(std::shared_ptr<const MappedFile> file);
+
+        // Visits the matching records until visit returns false
+        template<typename Matches, typename Visit>
+        void findIn(Table table, uint64_t hash, Matches matches, Visit visit) const;
+        template<typename Matches>
+        std::optional<RegistryEntryView> findFirstIn(Table table, uint64_t hash, Matches matches) const;
+
+        std::shared_ptr<const MappedFile> file;
+        std::span<const RegistryRecord> records;
+        std::span<const uint32_t> buckets;      // TableCount tables back to back
+        uint32_t bucketCount = 0;
+        std::string_view strings;
+        std::array<RegistryTypeRange, kRegistryTypeSlots> typeRanges{};
+    };
+
+    // Append only log of the entries registered since the snapshot was written
+    class AssetRegistryJournal
+    {
+    public:
+        // Replays every complete record into visit, a torn record at the end is cut off before appending resumes
+        static std::unique_ptr<AssetRegistryJournal> open(const std::string& path,
+                                                          const std::function<void(const RegistryEntryView&)>& visit);
+
+        // Flushed before returning, so the entry survives the process dying right after
+        bool append(const RegistryEntryView& entry);
+        // Drops every record, called once they made it into a new snapshot
+        bool clear();
+
+        [[nodiscard]] uint32_t getRecordCount() const { return recordCount; }
+
+    private:
+        explicit AssetRegistryJournal(std::string path) : path(std::move(path)) {}
+
+        bool openForAppend();
+
+        std::string path;
+        std::ofstream stream;
+        uint32_t recordCount = 0;
+        std::vector<char> buffer;
+    };
+
+    namespace registry
+    {
+        // Stored on disk, so these must not depend on the standard library's hash
+        uint64_t hashString(std::string_view value);
+        uint64_t hashValue(uint64_t value);
+    }
+}
+
+#endif //ASSETREGISTRYFILE_HPP
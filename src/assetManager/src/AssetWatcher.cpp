@@ -0,0 +1,161 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "AssetWatcher.hpp"
+
+#include <cerrno>
+#include <spdlog/spdlog.h>
+
+#include "BinaryContainer.hpp"
+#include "ContentHash.hpp"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace am
+{
+    AssetWatcher::AssetWatcher()
+    {
+#ifdef __linux__
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0) {
+            spdlog::warn("inotify unavailable (errno {}), asset changes are found by comparing write times", errno);
+        }
+#endif
+    }
+
+    AssetWatcher::~AssetWatcher()
+    {
+#ifdef __linux__
+        if (inotifyFd >= 0) {
+            close(inotifyFd);
+        }
+#endif
+    }
+
+    std::optional<uint64_t> AssetWatcher::hashFile(const std::string& path)
+    {
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error)) {
+            return std::nullopt;
+        }
+        auto file = MappedFile::open(path);
+        if (!file) {
+            return std::nullopt;
+        }
+        const auto bytes = file->bytes();
+        return ContentHasher::hash(bytes.data(), bytes.size());
+    }
+
+    void AssetWatcher::watch(const std::string& path)
+    {
+        auto [it, inserted] = files.try_emplace(path);
+        if (!inserted) {
+            return;
+        }
+        std::error_code error;
+        it->second.writeTime = std::filesystem::last_write_time(path, error);
+        it->second.hash = hashFile(path);
+
+#ifdef __linux__
+        if (inotifyFd < 0) {
+            return;
+        }
+        // Editors save by writing a temporary file and renaming it over the old one, which only the directory sees
+        std::string directory = std::filesystem::path(path).parent_path().string();
+        if (directory.empty()) {
+            directory = ".";
+        }
+        if (!watchedDirectories.insert(directory).second) {
+            return;
+        }
+        const int descriptor = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (descriptor < 0) {
+            spdlog::warn("Can't watch {} for asset changes (errno {})", directory, errno);
+            return;
+        }
+        directories[descriptor] = std::move(directory);
+#endif
+    }
+
+    bool AssetWatcher::refresh(const std::string& path, WatchedFile& file)
+    {
+        std::error_code error;
+        file.writeTime = std::filesystem::last_write_time(path, error);
+        const auto hash = hashFile(path);
+        // A file that went away isn't a change anyone can reimport, it counts once it is back
+        if (!hash || hash == file.hash) {
+            return false;
+        }
+        file.hash = hash;
+        return true;
+    }
+
+#ifdef __linux__
+    void AssetWatcher::readEvents(std::unordered_set<std::string>& touched, bool& overflowed)
+    {
+        alignas(inotify_event) char buffer[16 * 1024];
+        while (true) {
+            const ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                return;     // EAGAIN once the queue is drained
+            }
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    overflowed = true;
+                    continue;
+                }
+                auto directory = directories.find(event->wd);
+                if (directory == directories.end() || event->len == 0) {
+                    continue;
+                }
+                std::string path = (std::filesystem::path(directory->second) / event->name).string();
+                if (files.contains(path)) {
+                    touched.insert(std::move(path));
+                }
+            }
+        }
+    }
+#endif
+
+    std::vector<std::string> AssetWatcher::poll()
+    {
+        std::vector<std::string> changed;
+
+#ifdef __linux__
+        if (inotifyFd >= 0) {
+            std::unordered_set<std::string> touched;
+            bool overflowed = false;
+            readEvents(touched, overflowed);
+            // Events were dropped, the write times say which files they were about
+            if (overflowed) {
+                spdlog::warn("Asset watcher missed events, checking every watched file");
+                std::error_code error;
+                for (const auto& [path, file] : files) {
+                    if (std::filesystem::last_write_time(path, error) != file.writeTime)
+                        touched.insert(path);
+                }
+            }
+            for (const auto& path : touched) {
+                if (refresh(path, files.at(path)))
+                    changed.push_back(path);
+            }
+            return changed;
+        }
+#endif
+
+        std::error_code error;
+        for (auto& [path, file] : files) {
+            const auto writeTime = std::filesystem::last_write_time(path, error);
+            if (!error && writeTime != file.writeTime && refresh(path, file))
+                changed.push_back(path);
+        }
+        return changed;
+    }
+}
@@ -0,0 +1,59 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef ASSETWATCHER_HPP
+#define ASSETWATCHER_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace am
+{
+    // Reports watched source files whose contents changed. On Linux the directories holding them are watched with
+    // inotify, so a poll only looks at files something wrote to. Elsewhere every poll compares write times.
+    // Paths are reported as they were passed to watch. Not thread safe, the owner serializes the calls
+    class AssetWatcher
+    {
+    public:
+        AssetWatcher();
+        ~AssetWatcher();
+        AssetWatcher(const AssetWatcher&) = delete;
+        AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+        // Files that don't exist yet are picked up once they are created
+        void watch(const std::string& path);
+        [[nodiscard]] bool isWatching(const std::string& path) const { return files.contains(path); }
+
+        // Never blocks. A file written several times since the last call is reported once, one written back with the
+        // bytes it had before not at all, so editors saving in steps and reimports rewriting outputs settle
+        std::vector<std::string> poll();
+
+    private:
+        struct WatchedFile {
+            std::filesystem::file_time_type writeTime{};
+            std::optional<uint64_t> hash;     // nullopt while the file is missing
+        };
+
+        // True when the file's bytes differ from the ones last seen, which are updated
+        bool refresh(const std::string& path, WatchedFile& file);
+        static std::optional<uint64_t> hashFile(const std::string& path);
+
+        std::unordered_map<std::string, WatchedFile> files;
+
+#ifdef __linux__
+        void readEvents(std::unordered_set<std::string>& touched, bool& overflowed);
+
+        int inotifyFd = -1;
+        std::unordered_map<int, std::string> directories;       // Watch descriptor -> directory
+        std::unordered_set<std::string> watchedDirectories;
+#endif
+    };
+}
+
+#endif //ASSETWATCHER_HPP
@@ -0,0 +1,327 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "BinaryContainer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace am
+{
+    std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path)
+    {
+        std::shared_ptr<MappedFile> mapped(new MappedFile());
+        mapped->path = path;
+
+#ifdef _WIN32
+        // Share delete so files that are rewritten while mapped, like the asset registry, can be replaced
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            spdlog::error("Failed to open file for mapping: {}", path);
+            return nullptr;
+        }
+        mapped->fileHandle = file;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            spdlog::error("Failed to query size of file: {}", path);
+            return nullptr;
+        }
+        mapped->size = static_cast<size_t>(fileSize.QuadPart);
+        if (mapped->size == 0)
+            return mapped;
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            spdlog::error("Failed to create file mapping: {}", path);
+            return nullptr;
+        }
+        mapped->mappingHandle = mapping;
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            spdlog::error("Failed to map view of file: {}", path);
+            return nullptr;
+        }
+        mapped->data = static_cast<const std::byte*>(view);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            spdlog::error("Failed to open file for mapping: {}", path);
+            return nullptr;
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            spdlog::error("Failed to query size of file: {}", path);
+            ::close(fd);
+            return nullptr;
+        }
+        mapped->size = static_cast<size_t>(info.st_size);
+        if (mapped->size == 0) {
+            ::close(fd);
+            return mapped;
+        }
+
+        void* view = mmap(nullptr, mapped->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping holds its own reference to the file
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            spdlog::error("Failed to map file: {}", path);
+            mapped->size = 0;
+            return nullptr;
+        }
+        mapped->data = static_cast<const std::byte*>(view);
+#endif
+        return mapped;
+    }
+
+    std::shared_ptr<const MappedFile> MappedFile::slice(std::shared_ptr<const MappedFile> parent, uint64_t offset, uint64_t size,
+                                                        std::string path)
+    {
+        auto parentBytes = parent->bytes();
+        if (offset > parentBytes.size() || size > parentBytes.size() - offset) {
+            spdlog::error("Slice out of bounds of mapping {}: {}", parent->getPath(), path);
+            return nullptr;
+        }
+
+        std::shared_ptr<MappedFile> view(new MappedFile());
+        view->data = parentBytes.data() + offset;
+        view->size = static_cast<size_t>(size);
+        view->path = std::move(path);
+        view->parent = std::move(parent);
+        return view;
+    }
+
+    std::shared_ptr<MappedFile> MappedFile::allocate(size_t size, std::string path)
+    {
+        std::shared_ptr<MappedFile> buffer(new MappedFile());
+        buffer->data = static_cast<const std::byte*>(::operator new(std::max<size_t>(size, 1), std::align_val_t(kBinaryContainerAlignment)));
+        buffer->size = size;
+        buffer->path = std::move(path);
+        buffer->ownsBuffer = true;
+        return buffer;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (ownsBuffer) {
+            ::operator delete(const_cast<std::byte*>(data), std::align_val_t(kBinaryContainerAlignment));
+            return;
+        }
+        // Slices only hold on to their parent
+        if (parent)
+            return;
+
+#ifdef _WIN32
+        if (data)
+            UnmapViewOfFile(data);
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        if (fileHandle)
+            CloseHandle(fileHandle);
+#else
+        if (data)
+            munmap(const_cast<std::byte*>(data), size);
+#endif
+    }
+
+    BinaryContainerReader::BinaryContainerReader(std::shared_ptr<const MappedFile> file, std::span<const std::byte> bytes,
+                                                 const BinaryHeader& header)
+        : file(std::move(file)), bytes(bytes), header(header)
+    {
+        sections = {reinterpret_cast<const BinarySection*>(bytes.data() + header.headerSize), header.sectionCount};
+    }
+
+    bool BinaryContainerReader::isContainer(std::span<const std::byte> bytes)
+    {
+        if (bytes.size() < sizeof(uint32_t))
+            return false;
+
+        uint32_t magic;
+        std::memcpy(&magic, bytes.data(), sizeof(magic));
+        return magic == kBinaryContainerMagic;
+    }
+
+    std::optional<BinaryContainerReader> BinaryContainerReader::open(const std::string& path, uint32_t kind)
+    {
+        auto file = MappedFile::open(path);
+        if (!file)
+            return std::nullopt;
+
+        auto bytes = file->bytes();
+        return open(std::move(file), bytes, kind);
+    }
+
+    std::optional<BinaryContainerReader> BinaryContainerReader::open(std::shared_ptr<const MappedFile> file,
+                                                                     std::span<const std::byte> bytes, uint32_t kind)
+    {
+        const std::string path = file ? file->getPath() : std::string();
+
+        if (bytes.size() < sizeof(BinaryHeader) || !isContainer(bytes)) {
+            spdlog::error("Not a binary asset container: {}", path);
+            return std::nullopt;
+        }
+
+        // Views are typed in place, so the container itself has to start aligned
+        if (reinterpret_cast<std::uintptr_t>(bytes.data()) % kBinaryContainerAlignment != 0) {
+            spdlog::error("Binary asset container is not {} byte aligned: {}", kBinaryContainerAlignment, path);
+            return std::nullopt;
+        }
+
+        BinaryHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        if (header.version != kBinaryContainerVersion) {
+            spdlog::error("Unsupported binary asset container version {} in {}", header.version, path);
+            return std::nullopt;
+        }
+        if (header.kind != kind) {
+            spdlog::error("Binary asset container {} holds a different asset kind", path);
+            return std::nullopt;
+        }
+        if (header.headerSize < sizeof(BinaryHeader) ||
+            header.headerSize % alignof(BinarySection) != 0 ||
+            static_cast<uint64_t>(header.headerSize) + static_cast<uint64_t>(header.sectionCount) * sizeof(BinarySection) > bytes.size()) {
+            spdlog::error("Corrupt section table in binary asset container: {}", path);
+            return std::nullopt;
+        }
+
+        BinaryContainerReader reader(std::move(file), bytes, header);
+        for (const auto& entry : reader.sections) {
+            if (entry.offset % kBinaryContainerAlignment != 0 || entry.offset > bytes.size() || entry.size > bytes.size() - entry.offset) {
+                spdlog::error("Section out of bounds in binary asset container: {}", path);
+                return std::nullopt;
+            }
+        }
+        return reader;
+    }
+
+    boost::uuids::uuid BinaryContainerReader::getId() const
+    {
+        boost::uuids::uuid id;
+        std::memcpy(&id, header.uuid, sizeof(header.uuid));
+        return id;
+    }
+
+    const BinarySection* BinaryContainerReader::findSection(uint32_t tag) const
+    {
+        // A handful of sections per asset, a linear scan beats anything fancier
+        for (const auto& entry : sections) {
+            if (entry.tag == tag)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    std::span<const std::byte> BinaryContainerReader::section(uint32_t tag) const
+    {
+        const BinarySection* entry = findSection(tag);
+        if (!entry)
+            return {};
+        return bytes.subspan(entry->offset, entry->size);
+    }
+
+    BinaryContainerWriter::BinaryContainerWriter(uint32_t kind, const boost::uuids::uuid& id) : kind(kind), id(id)
+    {
+    }
+
+    void BinaryContainerWriter::addSection(uint32_t tag, std::span<const std::byte> data, uint32_t elementSize)
+    {
+        pending.push_back({tag, elementSize, data});
+    }
+
+    uint64_t BinaryContainerWriter::getSize() const
+    {
+        uint64_t offset = alignBinaryOffset(sizeof(BinaryHeader) + pending.size() * sizeof(BinarySection));
+        for (const auto& section : pending)
+            offset = alignBinaryOffset(offset + section.data.size());
+        return offset;
+    }
+
+    bool BinaryContainerWriter::write(std::ostream& os) const
+    {
+        BinaryHeader header{};
+        header.magic = kBinaryContainerMagic;
+        header.version = kBinaryContainerVersion;
+        header.headerSize = sizeof(BinaryHeader);
+        header.kind = kind;
+        header.sectionCount = static_cast<uint32_t>(pending.size());
+        std::memcpy(header.uuid, &id, sizeof(header.uuid));
+
+        std::vector<BinarySection> table;
+        table.reserve(pending.size());
+        uint64_t offset = alignBinaryOffset(sizeof(BinaryHeader) + pending.size() * sizeof(BinarySection));
+        for (const auto& section : pending) {
+            table.push_back({section.tag, section.elementSize, offset, section.data.size(), 0});
+            offset = alignBinaryOffset(offset + section.data.size());
+        }
+
+        static constexpr std::array<char, kBinaryContainerAlignment> padding{};
+        uint64_t written = 0;
+        auto pad = [&](uint64_t to) {
+            os.write(padding.data(), static_cast<std::streamsize>(to - written));
+            written = to;
+        };
+
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(BinarySection)));
+        written = sizeof(header) + table.size() * sizeof(BinarySection);
+
+        for (size_t i = 0; i < pending.size(); ++i) {
+            pad(table[i].offset);
+            os.write(reinterpret_cast<const char*>(pending[i].data.data()), static_cast<std::streamsize>(pending[i].data.size()));
+            written += pending[i].data.size();
+        }
+        pad(alignBinaryOffset(written));
+
+        return static_cast<bool>(os);
+    }
+
+    bool BinaryContainerWriter::write(const std::string& path) const
+    {
+        // The sections may point into a mapping of the file being replaced, so never truncate it
+        // in place. Renaming over it keeps the old contents alive for existing mappings.
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream ofs(tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!ofs.is_open()) {
+                spdlog::error("Failed to open file for writing binary asset: {}", tempPath);
+                return false;
+            }
+
+            if (!write(ofs)) {
+                spdlog::error("Failed to write binary asset: {}", tempPath);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            spdlog::error("Failed to replace binary asset {}: {}", path, error.message());
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+        return true;
+    }
+}
@@ -8,7 +8,9 @@
 #include <rapidjson/document.h>
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/stringbuffer.h>
+#include <cstddef>
 #include <fstream>
+#include <span>
 #include <string>
 #include <spdlog/spdlog.h>
 
@@ -79,6 +81,27 @@ namespace am {
         }
     }
 
+    inline bool loadJsonFromBytes(std::span<const std::byte> bytes, const std::string& name, rapidjson::Document& document) {
+        const char* text = reinterpret_cast<const char*>(bytes.data());
+        size_t size = bytes.size();
+
+        // Skip UTF-8 BOM if present
+        if (size >= 3 && text[0] == static_cast<char>(0xEF) && text[1] == static_cast<char>(0xBB) && text[2] == static_cast<char>(0xBF)) {
+            text += 3;
+            size -= 3;
+        }
+
+        document.Parse(text, size);
+
+        if (document.HasParseError()) {
+            spdlog::error("JSON parse error in {}: {} (offset {})",
+                         name, (int)document.GetParseError(), document.GetErrorOffset());
+            return false;
+        }
+
+        return true;
+    }
+
 } // namespace am
 
 #endif //REASONABLEVULKAN_JSONHELPERS_HPP
@@ -0,0 +1,536 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "MeshBVH.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <glm/glm.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AM_MESHBVH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC emits any intrinsic without flags, GCC and Clang need the target on each function using it
+#if defined(AM_MESHBVH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MESHBVH_TARGET(features) __attribute__((target(features)))
+#else
+#define MESHBVH_TARGET(features)
+#endif
+
+namespace am
+{
+    namespace
+    {
+        constexpr uint32_t kBinCount = 16;
+        // Past this depth nodes are split at the median, so the tree stays shallower than the traversal stack
+        constexpr uint32_t kMaxSAHDepth = 64;
+        constexpr size_t kStackSize = 128;
+        constexpr float kDeterminantEpsilon = 1e-12f;
+
+        struct BuildTriangle {
+            glm::vec3 boundsMin;
+            glm::vec3 boundsMax;
+            glm::vec3 centroid;
+            uint32_t index;
+        };
+
+        struct Bounds {
+            glm::vec3 min{std::numeric_limits<float>::max()};
+            glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+            void grow(const glm::vec3& point)
+            {
+                min = glm::min(min, point);
+                max = glm::max(max, point);
+            }
+            void grow(const Bounds& other)
+            {
+                min = glm::min(min, other.min);
+                max = glm::max(max, other.max);
+            }
+            [[nodiscard]] float surfaceArea() const
+            {
+                if (min.x > max.x) {
+                    return 0.0f;
+                }
+                const glm::vec3 size = max - min;
+                return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+            }
+        };
+
+        class MeshBVHBuilder
+        {
+        public:
+            MeshBVHBuilder(std::span<const VertexAsset> vertices, std::span<const unsigned int> indices, MeshBVH& bvh)
+                : vertices(vertices), indices(indices), bvh(bvh)
+            {
+                const size_t triangleCount = indices.size() / 3;
+                triangles.reserve(triangleCount);
+                for (size_t i = 0; i < triangleCount; ++i) {
+                    if (indices[3 * i] >= vertices.size() || indices[3 * i + 1] >= vertices.size() ||
+                        indices[3 * i + 2] >= vertices.size()) {
+                        continue;
+                    }
+                    Bounds bounds;
+                    for (int corner = 0; corner < 3; ++corner) {
+                        bounds.grow(vertices[indices[3 * i + corner]].Position);
+                    }
+                    triangles.push_back({bounds.min, bounds.max, (bounds.min + bounds.max) * 0.5f, static_cast<uint32_t>(i)});
+                }
+            }
+
+            void build()
+            {
+                if (triangles.empty()) {
+                    return;
+                }
+                bvh.nodes.reserve(2 * (triangles.size() / kMeshTrianglePacketWidth + 1));
+                bvh.packets.reserve(triangles.size() / (kMeshTrianglePacketWidth / 2) + 1);
+                buildNode(0, static_cast<uint32_t>(triangles.size()), 0);
+            }
+
+        private:
+            void buildNode(uint32_t first, uint32_t count, uint32_t depth)
+            {
+                Bounds bounds, centroidBounds;
+                for (uint32_t i = first; i < first + count; ++i) {
+                    bounds.grow(Bounds{triangles[i].boundsMin, triangles[i].boundsMax});
+                    centroidBounds.grow(triangles[i].centroid);
+                }
+
+                const uint32_t nodeIndex = static_cast<uint32_t>(bvh.nodes.size());
+                bvh.nodes.push_back({bounds.min, 0, bounds.max, 0});
+                if (count <= kMeshTrianglePacketWidth) {
+                    bvh.nodes[nodeIndex].offset = static_cast<uint32_t>(bvh.packets.size());
+                    bvh.nodes[nodeIndex].triangleCount = count;
+                    writePacket(first, count);
+                    return;
+                }
+
+                const uint32_t split = partition(first, count, depth, centroidBounds);
+                buildNode(first, split - first, depth + 1);
+                bvh.nodes[nodeIndex].offset = static_cast<uint32_t>(bvh.nodes.size());
+                buildNode(split, first + count - split, depth + 1);
+            }
+
+            // Index of the first triangle of the right child
+            uint32_t partition(uint32_t first, uint32_t count, uint32_t depth, const Bounds& centroidBounds)
+            {
+                const glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+                const int longestAxis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+                if (depth < kMaxSAHDepth && extent[longestAxis] > 0.0f) {
+                    int bestAxis = -1;
+                    uint32_t bestBin = 0;
+                    float bestCost = std::numeric_limits<float>::max();
+                    for (int axis = 0; axis < 3; ++axis) {
+                        if (extent[axis] <= 0.0f) {
+                            continue;
+                        }
+                        std::array<Bounds, kBinCount> bins{};
+                        std::array<uint32_t, kBinCount> binCounts{};
+                        const float scale = kBinCount / extent[axis];
+                        for (uint32_t i = first; i < first + count; ++i) {
+                            const uint32_t bin = binOf(triangles[i].centroid[axis], centroidBounds.min[axis], scale);
+                            bins[bin].grow(Bounds{triangles[i].boundsMin, triangles[i].boundsMax});
+                            ++binCounts[bin];
+                        }
+
+                        // Sweep from the right, then evaluate every plane sweeping from the left
+                        std::array<float, kBinCount> rightCosts{};
+                        Bounds right;
+                        uint32_t rightCount = 0;
+                        for (uint32_t bin = kBinCount - 1; bin > 0; --bin) {
+                            right.grow(bins[bin]);
+                            rightCount += binCounts[bin];
+                            rightCosts[bin] = right.surfaceArea() * static_cast<float>(rightCount);
+                        }
+                        Bounds left;
+                        uint32_t leftCount = 0;
+                        for (uint32_t bin = 0; bin + 1 < kBinCount; ++bin) {
+                            left.grow(bins[bin]);
+                            leftCount += binCounts[bin];
+                            const float cost = left.surfaceArea() * static_cast<float>(leftCount) + rightCosts[bin + 1];
+                            if (leftCount > 0 && leftCount < count && cost < bestCost) {
+                                bestCost = cost;
+                                bestAxis = axis;
+                                bestBin = bin;
+                            }
+                        }
+                    }
+
+                    if (bestAxis >= 0) {
+                        const float minimum = centroidBounds.min[bestAxis];
+                        const float scale = kBinCount / extent[bestAxis];
+                        auto middle = std::partition(triangles.begin() + first, triangles.begin() + first + count,
+                                                     [&](const BuildTriangle& triangle) {
+                                                         return binOf(triangle.centroid[bestAxis], minimum, scale) <= bestBin;
+                                                     });
+                        return static_cast<uint32_t>(middle - triangles.begin());
+                    }
+                }
+
+                // Stacked centroids or a too deep branch, halving keeps the depth logarithmic from here on
+                const uint32_t middle = first + count / 2;
+                std::nth_element(triangles.begin() + first, triangles.begin() + middle, triangles.begin() + first + count,
+                                 [&](const BuildTriangle& a, const BuildTriangle& b) {
+                                     return a.centroid[longestAxis] < b.centroid[longestAxis];
+                                 });
+                return middle;
+            }
+
+            static uint32_t binOf(float centroid, float minimum, float scale)
+            {
+                return std::min(static_cast<uint32_t>((centroid - minimum) * scale), kBinCount - 1);
+            }
+
+            void writePacket(uint32_t first, uint32_t count)
+            {
+                MeshTrianglePacket& packet = bvh.packets.emplace_back();
+                for (uint32_t lane = 0; lane < kMeshTrianglePacketWidth; ++lane) {
+                    glm::vec3 vertex0(0.0f), edge1(0.0f), edge2(0.0f);
+                    uint32_t triangle = kMeshBVHInvalidTriangle;
+                    if (lane < count) {
+                        triangle = triangles[first + lane].index;
+                        vertex0 = vertices[indices[3 * triangle]].Position;
+                        edge1 = vertices[indices[3 * triangle + 1]].Position - vertex0;
+                        edge2 = vertices[indices[3 * triangle + 2]].Position - vertex0;
+                    }
+                    for (int axis = 0; axis < 3; ++axis) {
+                        packet.vertex0[axis][lane] = vertex0[axis];
+                        packet.edge1[axis][lane] = edge1[axis];
+                        packet.edge2[axis][lane] = edge2[axis];
+                    }
+                    packet.triangle[lane] = triangle;
+                }
+            }
+
+            std::span<const VertexAsset> vertices;
+            std::span<const unsigned int> indices;
+            MeshBVH& bvh;
+            std::vector<BuildTriangle> triangles;
+        };
+
+        struct PreparedRay {
+            glm::vec3 origin;
+            glm::vec3 direction;
+            glm::vec3 inverseDirection;
+        };
+
+        // Lane of the closest hit nearer than distance, which is then moved to it. -1 if no lane is nearer
+        using PacketKernel = int (*)(const MeshTrianglePacket& packet, const PreparedRay& ray, float& distance, float& u, float& v);
+
+        int intersectPacketScalar(const MeshTrianglePacket& packet, const PreparedRay& ray, float& distance, float& u, float& v)
+        {
+            int hitLane = -1;
+            for (uint32_t lane = 0; lane < kMeshTrianglePacketWidth; ++lane) {
+                const glm::vec3 edge1(packet.edge1[0][lane], packet.edge1[1][lane], packet.edge1[2][lane]);
+                const glm::vec3 edge2(packet.edge2[0][lane], packet.edge2[1][lane], packet.edge2[2][lane]);
+                const glm::vec3 p = glm::cross(ray.direction, edge2);
+                const float determinant = glm::dot(edge1, p);
+                if (std::abs(determinant) < kDeterminantEpsilon) {
+                    continue;
+                }
+                const float inverseDeterminant = 1.0f / determinant;
+                const glm::vec3 s = ray.origin - glm::vec3(packet.vertex0[0][lane], packet.vertex0[1][lane], packet.vertex0[2][lane]);
+                const float laneU = glm::dot(s, p) * inverseDeterminant;
+                if (laneU < 0.0f || laneU > 1.0f) {
+                    continue;
+                }
+                const glm::vec3 q = glm::cross(s, edge1);
+                const float laneV = glm::dot(ray.direction, q) * inverseDeterminant;
+                if (laneV < 0.0f || laneU + laneV > 1.0f) {
+                    continue;
+                }
+                const float t = glm::dot(edge2, q) * inverseDeterminant;
+                if (t > 0.0f && t < distance) {
+                    distance = t;
+                    u = laneU;
+                    v = laneV;
+                    hitLane = static_cast<int>(lane);
+                }
+            }
+            return hitLane;
+        }
+
+#ifdef AM_MESHBVH_X86
+        // Nearest set lane of the mask, the distances of every lane are in t
+        inline int closestLane(unsigned mask, const float* t, const float* laneU, const float* laneV, int laneOffset,
+                               float& distance, float& u, float& v)
+        {
+            int hitLane = -1;
+            for (; mask != 0; mask &= mask - 1) {
+                const int lane = std::countr_zero(mask);
+                if (t[lane] < distance) {
+                    distance = t[lane];
+                    u = laneU[lane];
+                    v = laneV[lane];
+                    hitLane = laneOffset + lane;
+                }
+            }
+            return hitLane;
+        }
+
+        MESHBVH_TARGET("sse2")
+        int intersectPacketSSE(const MeshTrianglePacket& packet, const PreparedRay& ray, float& distance, float& u, float& v)
+        {
+            const __m128 dx = _mm_set1_ps(ray.direction.x), dy = _mm_set1_ps(ray.direction.y), dz = _mm_set1_ps(ray.direction.z);
+            const __m128 ox = _mm_set1_ps(ray.origin.x), oy = _mm_set1_ps(ray.origin.y), oz = _mm_set1_ps(ray.origin.z);
+            const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+            const __m128 epsilon = _mm_set1_ps(kDeterminantEpsilon);
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+
+            int hitLane = -1;
+            for (uint32_t group = 0; group < kMeshTrianglePacketWidth; group += 4) {
+                const __m128 e1x = _mm_load_ps(packet.edge1[0] + group), e1y = _mm_load_ps(packet.edge1[1] + group), e1z = _mm_load_ps(packet.edge1[2] + group);
+                const __m128 e2x = _mm_load_ps(packet.edge2[0] + group), e2y = _mm_load_ps(packet.edge2[1] + group), e2z = _mm_load_ps(packet.edge2[2] + group);
+
+                // p = direction x edge2
+                const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+                const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+                const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+                const __m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+                const __m128 inverseDeterminant = _mm_div_ps(one, determinant);
+
+                const __m128 sx = _mm_sub_ps(ox, _mm_load_ps(packet.vertex0[0] + group));
+                const __m128 sy = _mm_sub_ps(oy, _mm_load_ps(packet.vertex0[1] + group));
+                const __m128 sz = _mm_sub_ps(oz, _mm_load_ps(packet.vertex0[2] + group));
+                const __m128 laneU = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inverseDeterminant);
+
+                // q = s x edge1
+                const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+                const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+                const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+                const __m128 laneV = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverseDeterminant);
+                const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverseDeterminant);
+
+                __m128 hit = _mm_cmpge_ps(_mm_andnot_ps(signMask, determinant), epsilon);
+                hit = _mm_and_ps(hit, _mm_cmpge_ps(laneU, zero));
+                hit = _mm_and_ps(hit, _mm_cmpge_ps(laneV, zero));
+                hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(laneU, laneV), one));
+                hit = _mm_and_ps(hit, _mm_cmpgt_ps(t, zero));
+                hit = _mm_and_ps(hit, _mm_cmplt_ps(t, _mm_set1_ps(distance)));
+                const unsigned mask = static_cast<unsigned>(_mm_movemask_ps(hit));
+                if (mask == 0) {
+                    continue;
+                }
+
+                alignas(16) float tValues[4], uValues[4], vValues[4];
+                _mm_store_ps(tValues, t);
+                _mm_store_ps(uValues, laneU);
+                _mm_store_ps(vValues, laneV);
+                const int lane = closestLane(mask, tValues, uValues, vValues, static_cast<int>(group), distance, u, v);
+                if (lane >= 0) {
+                    hitLane = lane;
+                }
+            }
+            return hitLane;
+        }
+
+        MESHBVH_TARGET("avx")
+        int intersectPacketAVX(const MeshTrianglePacket& packet, const PreparedRay& ray, float& distance, float& u, float& v)
+        {
+            const __m256 dx = _mm256_set1_ps(ray.direction.x), dy = _mm256_set1_ps(ray.direction.y), dz = _mm256_set1_ps(ray.direction.z);
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+            const __m256 e1x = _mm256_loadu_ps(packet.edge1[0]), e1y = _mm256_loadu_ps(packet.edge1[1]), e1z = _mm256_loadu_ps(packet.edge1[2]);
+            const __m256 e2x = _mm256_loadu_ps(packet.edge2[0]), e2y = _mm256_loadu_ps(packet.edge2[1]), e2z = _mm256_loadu_ps(packet.edge2[2]);
+
+            const __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+            const __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+            const __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+            const __m256 determinant = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+            const __m256 inverseDeterminant = _mm256_div_ps(one, determinant);
+
+            const __m256 sx = _mm256_sub_ps(_mm256_set1_ps(ray.origin.x), _mm256_loadu_ps(packet.vertex0[0]));
+            const __m256 sy = _mm256_sub_ps(_mm256_set1_ps(ray.origin.y), _mm256_loadu_ps(packet.vertex0[1]));
+            const __m256 sz = _mm256_sub_ps(_mm256_set1_ps(ray.origin.z), _mm256_loadu_ps(packet.vertex0[2]));
+            const __m256 laneU = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), inverseDeterminant);
+
+            const __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+            const __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+            const __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+            const __m256 laneV = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), inverseDeterminant);
+            const __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), inverseDeterminant);
+
+            __m256 hit = _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), determinant), _mm256_set1_ps(kDeterminantEpsilon), _CMP_GE_OQ);
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(laneU, zero, _CMP_GE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(laneV, zero, _CMP_GE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_add_ps(laneU, laneV), one, _CMP_LE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, zero, _CMP_GT_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, _mm256_set1_ps(distance), _CMP_LT_OQ));
+            const unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(hit));
+            if (mask == 0) {
+                return -1;
+            }
+
+            alignas(32) float tValues[8], uValues[8], vValues[8];
+            _mm256_store_ps(tValues, t);
+            _mm256_store_ps(uValues, laneU);
+            _mm256_store_ps(vValues, laneV);
+            return closestLane(mask, tValues, uValues, vValues, 0, distance, u, v);
+        }
+
+        bool cpuHasAVX()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            const bool osxsave = info[2] & (1 << 27);
+            const bool avx = info[2] & (1 << 28);
+            return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+            return __builtin_cpu_supports("avx");
+#endif
+        }
+#endif
+
+        PacketKernel packetKernel(TriangleLanes lanes)
+        {
+            static const TriangleLanes supported = detectTriangleLanes();
+            if (static_cast<int>(lanes) > static_cast<int>(supported)) {
+                lanes = supported;
+            }
+#ifdef AM_MESHBVH_X86
+            switch (lanes) {
+                case TriangleLanes::AVX:
+                    return intersectPacketAVX;
+                case TriangleLanes::SSE:
+                    return intersectPacketSSE;
+                case TriangleLanes::Scalar:
+                    break;
+            }
+#endif
+            return intersectPacketScalar;
+        }
+
+        // Distance where the ray enters the box, clamped to the origin. False if it misses before maxDistance
+        bool intersectBounds(const MeshBVHNode& node, const PreparedRay& ray, float maxDistance, float& entry)
+        {
+            const glm::vec3 t1 = (node.boundsMin - ray.origin) * ray.inverseDirection;
+            const glm::vec3 t2 = (node.boundsMax - ray.origin) * ray.inverseDirection;
+            const glm::vec3 tNear = glm::min(t1, t2);
+            const glm::vec3 tFar = glm::max(t1, t2);
+            entry = std::max(std::max(std::max(tNear.x, tNear.y), tNear.z), 0.0f);
+            const float exit = std::min(std::min(std::min(tFar.x, tFar.y), tFar.z), maxDistance);
+            return entry <= exit;
+        }
+    }
+
+    MeshBVH buildMeshBVH(std::span<const VertexAsset> vertices, std::span<const unsigned int> indices)
+    {
+        MeshBVH bvh;
+        MeshBVHBuilder(vertices, indices, bvh).build();
+        return bvh;
+    }
+
+    bool validateMeshBVH(std::span<const MeshBVHNode> nodes, std::span<const MeshTrianglePacket> packets)
+    {
+        for (size_t index = 0; index < nodes.size(); ++index) {
+            const MeshBVHNode& node = nodes[index];
+            if (node.triangleCount > 0) {
+                if (node.triangleCount > kMeshTrianglePacketWidth || node.offset >= packets.size()) {
+                    return false;
+                }
+            } else if (index + 1 >= nodes.size() || node.offset <= index + 1 || node.offset >= nodes.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    TriangleLanes detectTriangleLanes()
+    {
+#ifdef AM_MESHBVH_X86
+        static const TriangleLanes lanes = cpuHasAVX() ? TriangleLanes::AVX : TriangleLanes::SSE;
+        return lanes;
+#else
+        return TriangleLanes::Scalar;
+#endif
+    }
+
+    std::optional<MeshRayHit> intersectMeshBVH(std::span<const MeshBVHNode> nodes, std::span<const MeshTrianglePacket> packets,
+                                               const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                                               TriangleLanes lanes)
+    {
+        if (nodes.empty()) {
+            return std::nullopt;
+        }
+
+        // Zero components are nudged so the slab reciprocals stay finite
+        PreparedRay ray{origin, direction, {}};
+        for (int axis = 0; axis < 3; ++axis) {
+            ray.inverseDirection[axis] = 1.0f / (direction[axis] == 0.0f ? 1e-6f : direction[axis]);
+        }
+        const PacketKernel kernel = packetKernel(lanes);
+
+        MeshRayHit hit{maxDistance, kMeshBVHInvalidTriangle, 0.0f, 0.0f};
+        float entry;
+        if (!intersectBounds(nodes[0], ray, hit.distance, entry)) {
+            return std::nullopt;
+        }
+
+        struct Entry {
+            uint32_t node;
+            float distance;
+        };
+        std::array<Entry, kStackSize> stack;
+        size_t top = 0;
+        stack[top++] = {0, entry};
+        while (top > 0) {
+            const Entry current = stack[--top];
+            // Pushed before a closer triangle was found
+            if (current.distance > hit.distance) {
+                continue;
+            }
+            const MeshBVHNode& node = nodes[current.node];
+            if (node.triangleCount > 0) {
+                const MeshTrianglePacket& packet = packets[node.offset];
+                const int lane = kernel(packet, ray, hit.distance, hit.u, hit.v);
+                if (lane >= 0) {
+                    hit.triangle = packet.triangle[lane];
+                }
+                continue;
+            }
+
+            const uint32_t left = current.node + 1;
+            const uint32_t right = node.offset;
+            float leftEntry, rightEntry;
+            const bool hitLeft = intersectBounds(nodes[left], ray, hit.distance, leftEntry);
+            const bool hitRight = intersectBounds(nodes[right], ray, hit.distance, rightEntry);
+            if (top + 2 > kStackSize) {
+                break;
+            }
+            // The nearer child goes on top so its hits clip the far side
+            if (hitLeft && hitRight) {
+                const bool leftFirst = leftEntry <= rightEntry;
+                stack[top++] = leftFirst ? Entry{right, rightEntry} : Entry{left, leftEntry};
+                stack[top++] = leftFirst ? Entry{left, leftEntry} : Entry{right, rightEntry};
+            } else if (hitLeft) {
+                stack[top++] = {left, leftEntry};
+            } else if (hitRight) {
+                stack[top++] = {right, rightEntry};
+            }
+        }
+
+        if (hit.triangle == kMeshBVHInvalidTriangle) {
+            return std::nullopt;
+        }
+        return hit;
+    }
+
+    std::optional<MeshRayHit> intersectMeshBVH(std::span<const MeshBVHNode> nodes, std::span<const MeshTrianglePacket> packets,
+                                               const glm::vec3& origin, const glm::vec3& direction, float maxDistance)
+    {
+        static const TriangleLanes lanes = detectTriangleLanes();
+        return intersectMeshBVH(nodes, packets, origin, direction, maxDistance, lanes);
+    }
+}
@@ -0,0 +1,103 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef SHARDEDMAP_HPP
+#define SHARDEDMAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace am
+{
+    // unordered_map split into shards that each have their own shared_mutex. Readers of different keys rarely
+    // share a lock and never wait on each other, writers only block the shard they touch
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, size_t ShardCount = 16>
+    class ShardedMap
+    {
+    public:
+        using Map = std::unordered_map<Key, Value, Hash>;
+
+        [[nodiscard]] std::optional<Value> find(const Key& key) const
+        {
+            const Shard& shard = shardFor(key);
+            std::shared_lock lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it == shard.map.end())
+                return std::nullopt;
+            return it->second;
+        }
+
+        [[nodiscard]] bool contains(const Key& key) const
+        {
+            const Shard& shard = shardFor(key);
+            std::shared_lock lock(shard.mutex);
+            return shard.map.contains(key);
+        }
+
+        // Reads the shard map of key under its shared lock
+        template<typename Read>
+        decltype(auto) read(const Key& key, Read read) const
+        {
+            const Shard& shard = shardFor(key);
+            std::shared_lock lock(shard.mutex);
+            return read(shard.map);
+        }
+
+        // Changes the shard map of key under its unique lock
+        template<typename Update>
+        decltype(auto) update(const Key& key, Update update)
+        {
+            Shard& shard = shardFor(key);
+            std::unique_lock lock(shard.mutex);
+            return update(shard.map);
+        }
+
+        void insertOrAssign(const Key& key, Value value)
+        {
+            update(key, [&](Map& map) { map.insert_or_assign(key, std::move(value)); });
+        }
+
+        bool erase(const Key& key)
+        {
+            return update(key, [&](Map& map) { return map.erase(key) != 0; });
+        }
+
+        // One shard at a time, entries inserted meanwhile may or may not be visited
+        template<typename Visit>
+        void forEach(Visit visit) const
+        {
+            for (const Shard& shard : shards) {
+                std::shared_lock lock(shard.mutex);
+                for (const auto& [key, value] : shard.map)
+                    visit(key, value);
+            }
+        }
+
+        void clear()
+        {
+            for (Shard& shard : shards) {
+                std::unique_lock lock(shard.mutex);
+                shard.map.clear();
+            }
+        }
+
+    private:
+        // Own cache line each, so readers of neighbouring shards don't bounce the same line between cores
+        struct alignas(64) Shard {
+            mutable std::shared_mutex mutex;
+            Map map;
+        };
+
+        Shard& shardFor(const Key& key) { return shards[Hash{}(key) % ShardCount]; }
+        const Shard& shardFor(const Key& key) const { return shards[Hash{}(key) % ShardCount]; }
+
+        std::array<Shard, ShardCount> shards;
+    };
+}
+
+#endif //SHARDEDMAP_HPP
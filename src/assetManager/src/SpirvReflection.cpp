@@ -0,0 +1,345 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "SpirvReflection.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <spdlog/spdlog.h>
+
+namespace am
+{
+    namespace
+    {
+        constexpr std::uint32_t kSpirvMagic = 0x07230203;
+        constexpr size_t kHeaderWords = 5;
+        constexpr uint32_t kNotDecorated = UINT32_MAX;
+        // Types nest far less than this in anything glslang emits, deeper means a broken module
+        constexpr int kMaxTypeDepth = 32;
+
+        // Only the part of the SPIR-V grammar the reflection looks at
+        enum Op : uint32_t {
+            OpName = 5,
+            OpCapability = 17,
+            OpTypeInt = 21,
+            OpTypeFloat = 22,
+            OpTypeVector = 23,
+            OpTypeMatrix = 24,
+            OpTypeImage = 25,
+            OpTypeSampler = 26,
+            OpTypeSampledImage = 27,
+            OpTypeArray = 28,
+            OpTypeRuntimeArray = 29,
+            OpTypeStruct = 30,
+            OpTypePointer = 32,
+            OpConstant = 43,
+            OpVariable = 59,
+            OpDecorate = 71,
+            OpMemberDecorate = 72
+        };
+
+        enum Decoration : uint32_t {
+            DecorationBufferBlock = 3,
+            DecorationArrayStride = 6,
+            DecorationMatrixStride = 7,
+            DecorationBuiltIn = 11,
+            DecorationLocation = 30,
+            DecorationBinding = 33,
+            DecorationDescriptorSet = 34,
+            DecorationOffset = 35
+        };
+
+        enum StorageClass : uint32_t {
+            StorageClassUniformConstant = 0,
+            StorageClassInput = 1,
+            StorageClassUniform = 2,
+            StorageClassPushConstant = 9,
+            StorageClassStorageBuffer = 12
+        };
+
+        constexpr uint32_t kCapabilityMultiView = 4439;
+        constexpr uint32_t kImageSampledStorage = 2;
+
+        struct Member {
+            uint32_t offset = kNotDecorated;
+            uint32_t matrixStride = 0;
+            bool builtIn = false;
+        };
+
+        // What the module says about one id, the defining instruction stays in the module's words
+        struct IdInfo {
+            std::span<const std::uint32_t> instruction;
+            std::string_view name;
+            uint32_t set = kNotDecorated;
+            uint32_t binding = kNotDecorated;
+            uint32_t location = kNotDecorated;
+            uint32_t arrayStride = 0;
+            bool builtIn = false;
+            bool bufferBlock = false;
+            std::vector<Member> members;
+
+            [[nodiscard]] uint32_t opcode() const { return instruction.empty() ? 0 : instruction[0] & 0xFFFF; }
+            [[nodiscard]] uint32_t word(size_t index) const { return index < instruction.size() ? instruction[index] : 0; }
+        };
+
+        class Module {
+        public:
+            explicit Module(uint32_t bound) : ids(bound) {}
+
+            IdInfo* find(uint32_t id) { return id < ids.size() ? &ids[id] : nullptr; }
+
+            Member* findMember(uint32_t structId, uint32_t index) {
+                IdInfo* info = find(structId);
+                if (!info || index > 1024) {
+                    return nullptr;
+                }
+                if (info->members.size() <= index) {
+                    info->members.resize(index + 1);
+                }
+                return &info->members[index];
+            }
+
+            uint32_t typeSize(uint32_t typeId, uint32_t matrixStride = 0, int depth = 0) {
+                const IdInfo* type = find(typeId);
+                if (!type || depth > kMaxTypeDepth) {
+                    return 0;
+                }
+                switch (type->opcode()) {
+                    case OpTypeInt:
+                    case OpTypeFloat:
+                        return type->word(2) / 8;
+                    case OpTypeVector:
+                        return type->word(3) * typeSize(type->word(2), 0, depth + 1);
+                    case OpTypeMatrix:
+                        return type->word(3) * (matrixStride != 0 ? matrixStride : typeSize(type->word(2), 0, depth + 1));
+                    case OpTypeArray: {
+                        const uint32_t stride = type->arrayStride != 0 ? type->arrayStride : typeSize(type->word(2), matrixStride, depth + 1);
+                        return constantValue(type->word(3)) * stride;
+                    }
+                    case OpTypeStruct: {
+                        // std140 and std430 both give every member an offset, the struct ends where its furthest member does
+                        uint32_t size = 0;
+                        const size_t memberCount = type->instruction.size() - 2;
+                        for (size_t i = 0; i < memberCount; ++i) {
+                            const Member layout = i < type->members.size() ? type->members[i] : Member{};
+                            const uint32_t memberSize = typeSize(type->word(2 + i), layout.matrixStride, depth + 1);
+                            size = layout.offset == kNotDecorated ? size + memberSize : std::max(size, layout.offset + memberSize);
+                        }
+                        return size;
+                    }
+                    default:
+                        return 0;
+                }
+            }
+
+            uint32_t constantValue(uint32_t id) {
+                const IdInfo* constant = find(id);
+                return constant && constant->opcode() == OpConstant ? constant->word(3) : 0;
+            }
+
+            std::vector<uint32_t> variables;
+
+        private:
+            std::vector<IdInfo> ids;
+        };
+
+        std::string_view readString(std::span<const std::uint32_t> words)
+        {
+            const char* text = reinterpret_cast<const char*>(words.data());
+            const char* end = text + words.size() * sizeof(std::uint32_t);
+            return {text, static_cast<size_t>(std::find(text, end, '\0') - text)};
+        }
+
+        // Fills in the type, dimension and count of a resource, false for things that aren't descriptors
+        bool classifyResource(Module& module, uint32_t typeId, uint32_t storageClass, ShaderResourceBinding& binding)
+        {
+            const IdInfo* type = module.find(typeId);
+            for (int depth = 0; type && depth < kMaxTypeDepth; ++depth) {
+                if (type->opcode() == OpTypeArray) {
+                    binding.count *= module.constantValue(type->word(3));
+                } else if (type->opcode() == OpTypeRuntimeArray) {
+                    binding.count = 0;
+                } else {
+                    break;
+                }
+                type = module.find(type->word(2));
+            }
+            if (!type) {
+                return false;
+            }
+
+            auto classifyImage = [&](const IdInfo& image) {
+                binding.dimension = static_cast<ShaderImageDimension>(image.word(3));
+                const bool storage = image.word(7) == kImageSampledStorage;
+                if (binding.dimension == ShaderImageDimension::SubpassData) {
+                    binding.type = ShaderResourceType::InputAttachment;
+                } else if (binding.dimension == ShaderImageDimension::Buffer) {
+                    binding.type = storage ? ShaderResourceType::StorageTexelBuffer : ShaderResourceType::UniformTexelBuffer;
+                } else {
+                    binding.type = storage ? ShaderResourceType::StorageImage : ShaderResourceType::SampledImage;
+                }
+            };
+
+            switch (type->opcode()) {
+                case OpTypeSampler:
+                    binding.type = ShaderResourceType::Sampler;
+                    return true;
+                case OpTypeImage:
+                    classifyImage(*type);
+                    return true;
+                case OpTypeSampledImage: {
+                    const IdInfo* image = module.find(type->word(2));
+                    if (!image || image->opcode() != OpTypeImage) {
+                        return false;
+                    }
+                    classifyImage(*image);
+                    binding.type = ShaderResourceType::CombinedImageSampler;
+                    return true;
+                }
+                case OpTypeStruct:
+                    binding.type = storageClass == StorageClassStorageBuffer || type->bufferBlock
+                        ? ShaderResourceType::StorageBuffer
+                        : ShaderResourceType::UniformBuffer;
+                    if (!type->name.empty()) {
+                        binding.name = type->name;
+                    }
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    }
+
+    std::optional<ShaderReflection> reflectSpirv(std::span<const std::uint32_t> spirv)
+    {
+        if (spirv.size() < kHeaderWords || spirv[0] != kSpirvMagic) {
+            spdlog::error("Cannot reflect shader, not a SPIR-V module");
+            return std::nullopt;
+        }
+
+        ShaderReflection reflection;
+        Module module(spirv[3]);
+
+        for (size_t offset = kHeaderWords; offset < spirv.size();) {
+            const uint32_t wordCount = spirv[offset] >> 16;
+            if (wordCount == 0 || offset + wordCount > spirv.size()) {
+                spdlog::error("Cannot reflect shader, instruction at word {} runs past the module", offset);
+                return std::nullopt;
+            }
+            const auto instruction = spirv.subspan(offset, wordCount);
+            offset += wordCount;
+
+            auto word = [&](size_t index) { return index < instruction.size() ? instruction[index] : 0u; };
+            switch (instruction[0] & 0xFFFF) {
+                case OpCapability:
+                    reflection.multiview |= word(1) == kCapabilityMultiView;
+                    break;
+                case OpName:
+                    if (IdInfo* info = module.find(word(1)); info && instruction.size() > 2) {
+                        info->name = readString(instruction.subspan(2));
+                    }
+                    break;
+                case OpDecorate:
+                    if (IdInfo* info = module.find(word(1))) {
+                        switch (word(2)) {
+                            case DecorationBufferBlock: info->bufferBlock = true; break;
+                            case DecorationArrayStride: info->arrayStride = word(3); break;
+                            case DecorationBuiltIn: info->builtIn = true; break;
+                            case DecorationLocation: info->location = word(3); break;
+                            case DecorationBinding: info->binding = word(3); break;
+                            case DecorationDescriptorSet: info->set = word(3); break;
+                            default: break;
+                        }
+                    }
+                    break;
+                case OpMemberDecorate:
+                    if (Member* member = module.findMember(word(1), word(2))) {
+                        switch (word(3)) {
+                            case DecorationOffset: member->offset = word(4); break;
+                            case DecorationMatrixStride: member->matrixStride = word(4); break;
+                            case DecorationBuiltIn: member->builtIn = true; break;
+                            default: break;
+                        }
+                    }
+                    break;
+                case OpTypeInt:
+                case OpTypeFloat:
+                case OpTypeVector:
+                case OpTypeMatrix:
+                case OpTypeImage:
+                case OpTypeSampler:
+                case OpTypeSampledImage:
+                case OpTypeArray:
+                case OpTypeRuntimeArray:
+                case OpTypeStruct:
+                case OpTypePointer:
+                    if (IdInfo* info = module.find(word(1))) {
+                        info->instruction = instruction;
+                    }
+                    break;
+                case OpConstant:
+                    if (IdInfo* info = module.find(word(2))) {
+                        info->instruction = instruction;
+                    }
+                    break;
+                case OpVariable:
+                    if (IdInfo* info = module.find(word(2))) {
+                        info->instruction = instruction;
+                        module.variables.push_back(word(2));
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Decorations can come before or after the types they decorate, so variables are only resolved once everything is read
+        for (const uint32_t variableId : module.variables) {
+            const IdInfo& variable = *module.find(variableId);
+            const IdInfo* pointer = module.find(variable.word(1));
+            if (!pointer || pointer->opcode() != OpTypePointer) {
+                continue;
+            }
+            const uint32_t storageClass = variable.word(3);
+            const uint32_t pointeeId = pointer->word(3);
+            const IdInfo* pointee = module.find(pointeeId);
+            if (!pointee) {
+                continue;
+            }
+
+            switch (storageClass) {
+                case StorageClassInput: {
+                    // Built-in blocks like gl_PerVertex carry the decoration on their members
+                    const bool builtInBlock = std::ranges::any_of(pointee->members, &Member::builtIn);
+                    if (!variable.builtIn && !builtInBlock && variable.location < 32) {
+                        reflection.inputLocations |= 1u << variable.location;
+                    }
+                    break;
+                }
+                case StorageClassPushConstant:
+                    reflection.pushConstants = ShaderPushConstantBlock{std::string(pointee->name), module.typeSize(pointeeId)};
+                    break;
+                case StorageClassUniformConstant:
+                case StorageClassUniform:
+                case StorageClassStorageBuffer: {
+                    if (variable.set == kNotDecorated || variable.binding == kNotDecorated) {
+                        continue;
+                    }
+                    ShaderResourceBinding binding{.set = variable.set, .binding = variable.binding, .name = std::string(variable.name)};
+                    if (classifyResource(module, pointeeId, storageClass, binding)) {
+                        reflection.bindings.push_back(std::move(binding));
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        std::ranges::sort(reflection.bindings, [](const ShaderResourceBinding& a, const ShaderResourceBinding& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+        return reflection;
+    }
+}
@@ -20,15 +20,11 @@ namespace am
     void ModelAsset::loadFromFile(ImportContext base_factory_context)
     {
         AssetManager& assetManager = AssetManager::getInstance();
-        Assimp::Importer& importer = assetManager.importer;
-        const aiScene* scene = importer.ReadFile(base_factory_context.importPath,
-                                                 aiProcess_Triangulate | aiProcess_GenSmoothNormals |
-                                                 // aiProcess_FlipUVs |
-                                                 aiProcess_CalcTangentSpace);
+        const aiScene* scene = assetManager.getImportScene(base_factory_context.importPath, kImportFlags);
         // check for errors
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
+        if (!scene)
         {
-            spdlog::error("Assimp error: " + string(importer.GetErrorString()));
+            spdlog::error("Assimp error: " + assetManager.getImportError());
             return;
         }
 
@@ -37,7 +33,12 @@ namespace am
 
         // process ASSIMP's root node recursively
        data.rootNode = processNode(base_factory_context, scene->mRootNode, scene);
-       importer.FreeScene();
+       assetManager.releaseImportScene();
+    }
+
+    ImportInputs ModelAsset::getImportInputs(const ImportContext& importContext)
+    {
+        return AssetManager::getImportSceneInputs(importContext.importPath, kImportFlags);
     }
 
     int ModelAsset::getMeshIndexInScene(const aiScene* scene, const aiMesh* targetMesh)
@@ -54,11 +55,7 @@ namespace am
 
     size_t ModelAsset::calculateContentHash() const
     {
-        size_t hash = 0;
-
-        hash = CalculateContentHash(data.rootNode);
-
-        return hash;
+        return CalculateContentHash(data.rootNode);
     }
 
     void ModelAsset::SaveAssetToJson(rapidjson::Document& document) {
@@ -119,7 +116,7 @@ namespace am
     ModelAsset::ModelAsset(const boost::uuids::uuid& id, const std::string& path, AssetFormat format) : Asset(id, path, format) {
         if (format == AssetFormat::Json) {
             rapidjson::Document document;
-            if (!loadJsonFromFile(path, document)) {
+            if (!AssetManager::getInstance().loadAssetJson(id, path, document)) {
                 spdlog::error("Failed to load ModelAsset from JSON: {}", path);
                 return;
             }
@@ -197,6 +194,25 @@ namespace am
         return AssetType::Model;
     }
 
+    std::vector<boost::uuids::uuid> ModelAsset::getDependencies() const
+    {
+        std::vector<boost::uuids::uuid> dependencies;
+        std::vector<const Node*> stack{&data.rootNode};
+        while (!stack.empty())
+        {
+            const Node* node = stack.back();
+            stack.pop_back();
+            for (const auto& mesh : node->meshes)
+            {
+                if (mesh && std::find(dependencies.begin(), dependencies.end(), mesh->id) == dependencies.end())
+                    dependencies.push_back(mesh->id);
+            }
+            for (const auto& child : node->mChildren)
+                stack.push_back(&child);
+        }
+        return dependencies;
+    }
+
 
     // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
     Node ModelAsset::processNode(ImportContext base_factory_context, aiNode* aiNode, const aiScene* scene)
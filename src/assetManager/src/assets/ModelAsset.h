@@ -35,12 +35,14 @@ namespace am {
         void SaveAssetToBin(std::string& path) override {}
 
         void loadFromFile(ImportContext base_factory_context);
+        static ImportInputs getImportInputs(const ImportContext& importContext);
 
         static int getMeshIndexInScene(const aiScene *scene, const aiMesh *targetMesh);
 
         [[nodiscard]] AssetType getType() const override;
 
         [[nodiscard]] size_t calculateContentHash() const override;
+        [[nodiscard]] std::vector<boost::uuids::uuid> getDependencies() const override;
         void SaveAssetMetadata(rapidjson::Document& document) override {}
         void LoadAssetMetadata(rapidjson::Document& document) override {}
 
@@ -48,6 +50,9 @@ namespace am {
             return &data;
         }
     private:
+        // UVs are not flipped here, unlike the meshes and materials read from the same scene
+        static constexpr unsigned int kImportFlags = aiProcess_Triangulate | aiProcess_GenSmoothNormals |
+                                                     aiProcess_CalcTangentSpace;
 
         Node processNode(ImportContext baseFactoryContext, aiNode *aiNode, const aiScene *scene);
         boost::uuids::uuid processMesh(ImportContext baseFactoryContext, aiMesh* mesh, const aiScene* scene);
@@ -1,4 +1,5 @@
 #include "PrefabAsset.h"
+#include "../../AssetManager.hpp"
 #include <boost/uuid/uuid_io.hpp>
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
@@ -32,7 +33,7 @@ namespace am {
 
             prefabData.Parse(jsonStr.c_str());
         } else {
-            loadJsonFromFile(path, prefabData);
+            AssetManager::getInstance().loadAssetJson(id, path, prefabData);
         }
     }
 
@@ -1,7 +1,10 @@
 #include "SceneAsset.h"
+#include "../../AssetManager.hpp"
 #include <boost/uuid/uuid_io.hpp>
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 
 namespace am {
@@ -15,11 +18,34 @@ namespace am {
 
     SceneAsset::SceneAsset(const boost::uuids::uuid& id, const std::string& path, AssetFormat format) : Asset(id, path, format) {
         if (format == AssetFormat::Binary) {
+            auto mapped = AssetManager::getInstance().openAssetFile(id, path);
+            if (mapped && mapped->bytes().size() >= sizeof(BinaryHeader) && BinaryContainerReader::isContainer(mapped->bytes())) {
+                const auto bytes = mapped->bytes();
+                BinaryHeader header;
+                std::memcpy(&header, bytes.data(), sizeof(header));
+                // The layout of binary scenes belongs to the engine, the asset keeps the mapping for it
+                if (header.kind != kSceneJsonKind) {
+                    sceneBinary = std::move(mapped);
+                    return;
+                }
+                auto reader = BinaryContainerReader::open(std::move(mapped), bytes, kSceneJsonKind);
+                if (!reader) return;
+                auto text = reader->section(kSceneJsonTag);
+                sceneData.Parse(reinterpret_cast<const char*>(text.data()), text.size());
+                return;
+            }
+
             std::ifstream ifs(path, std::ios::binary);
             if (!ifs.is_open()) return;
 
-            char magic[6];
+            char magic[6] = {};
             ifs.read(magic, sizeof(SCENE_MAGIC));
+            if (std::string_view(magic, sizeof(magic)) != std::string_view(SCENE_MAGIC, sizeof(SCENE_MAGIC))) {
+                // A plain JSON scene
+                ifs.close();
+                AssetManager::getInstance().loadAssetJson(id, path, sceneData);
+                return;
+            }
 
             boost::uuids::uuid savedId;
             ifs.read(reinterpret_cast<char*>(&savedId), 16);
@@ -32,7 +58,7 @@ namespace am {
 
             sceneData.Parse(jsonStr.c_str());
         } else {
-            loadJsonFromFile(path, sceneData);
+            AssetManager::getInstance().loadAssetJson(id, path, sceneData);
         }
     }
 
@@ -49,21 +75,34 @@ namespace am {
     }
 
     void SceneAsset::SaveAssetToBin(std::string& path) {
-        std::ofstream ofs(path, std::ios::binary | std::ios::out);
-        if (!ofs.is_open()) return;
-
-        ofs.write(SCENE_MAGIC, sizeof(SCENE_MAGIC));
-        ofs.write(reinterpret_cast<const char*>(&id), 16);
+        if (sceneBinary) {
+            // Possibly a mapping of the file being replaced, so it is written next to it and renamed over it
+            const std::string tempPath = path + ".tmp";
+            {
+                std::ofstream ofs(tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+                if (!ofs.is_open()) {
+                    spdlog::error("Failed to open file for writing binary scene: {}", tempPath);
+                    return;
+                }
+                const auto bytes = sceneBinary->bytes();
+                ofs.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            }
+            std::error_code error;
+            std::filesystem::rename(tempPath, path, error);
+            if (error) {
+                spdlog::error("Failed to replace binary scene {}: {}", path, error.message());
+                std::filesystem::remove(tempPath, error);
+            }
+            return;
+        }
 
         rapidjson::StringBuffer buffer;
         rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
         sceneData.Accept(writer);
 
-        size_t dataSize = buffer.GetSize();
-        ofs.write(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
-        ofs.write(buffer.GetString(), dataSize);
-
-        ofs.close();
+        BinaryContainerWriter container(kSceneJsonKind, id);
+        container.addSection(kSceneJsonTag, std::as_bytes(std::span(buffer.GetString(), buffer.GetSize())));
+        container.write(path);
     }
 
 
@@ -3,9 +3,14 @@
 
 #include "../../../include/Asset.hpp"
 #include "../../JsonHelpers.hpp"
+#include "BinaryContainer.hpp"
 
 namespace am {
+    // Files written before scenes had a binary format, the JSON text behind this magic
     const char SCENE_MAGIC[] = "RSCNE";
+    // Scenes that only exist as JSON, saved as a container holding the text
+    constexpr uint32_t kSceneJsonKind = makeFourCC('S', 'C', 'N', 'J');
+    constexpr uint32_t kSceneJsonTag = makeFourCC('J', 'S', 'O', 'N');
 
     class SceneAsset : public Asset {
     public:
@@ -30,6 +35,12 @@ namespace am {
         void SaveAssetMetadata(rapidjson::Document& document) override;
         void LoadAssetMetadata(rapidjson::Document& document) override;
 
+        // The binary scene container, written and read by the engine. Null for scenes that only exist as sceneData
+        [[nodiscard]] const std::shared_ptr<const MappedFile>& getSceneBinary() const { return sceneBinary; }
+        void setSceneBinary(std::shared_ptr<const MappedFile> binary) { sceneBinary = std::move(binary); }
+
+    private:
+        std::shared_ptr<const MappedFile> sceneBinary;
     };
 }
 
@@ -1,20 +1,18 @@
 #include "MaterialAsset.hpp"
 #include "../../AssetManager.hpp"
 #include "../../JsonHelpers.hpp"
+#include "ContentHash.hpp"
 
 am::MaterialAsset::MaterialAsset(const boost::uuids::uuid& id) : Asset(id) {
 }
 
 am::MaterialAsset::MaterialAsset(const boost::uuids::uuid& id, ImportContext assetFactoryData) : Asset(id, assetFactoryData) {
     AssetManager &assetManager = AssetManager::getInstance();
-    auto scene = assetManager.importer.GetScene();
+    auto scene = assetManager.getImportScene(assetFactoryData.importPath, kImportFlags);
 
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        scene = assetManager.importer.ReadFile(assetFactoryData.importPath, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            spdlog::error("Assimp error: " + std::string(assetManager.importer.GetErrorString()));
-            throw std::runtime_error("Assimp error: " + std::string(assetManager.importer.GetErrorString()));
-        }
+    if (!scene) {
+        spdlog::error("Assimp error: " + assetManager.getImportError());
+        throw std::runtime_error("Assimp error: " + assetManager.getImportError());
     }
 
     auto* aiMaterial = scene->mMaterials[assetFactoryData.assimpIndex];
@@ -29,7 +27,7 @@ am::MaterialAsset::MaterialAsset(const boost::uuids::uuid& id, ImportContext ass
 am::MaterialAsset::MaterialAsset(const boost::uuids::uuid& id, const std::string& path, AssetFormat format) : Asset(id, path, format) {
     if (format == AssetFormat::Json) {
         rapidjson::Document document;
-        if (!loadJsonFromFile(path, document)) {
+        if (!AssetManager::getInstance().loadAssetJson(id, path, document)) {
             spdlog::error("Failed to load MaterialAsset from JSON: {}", path);
             return;
         }
@@ -229,17 +227,28 @@ void am::MaterialAsset::extractPBRData(const aiMaterial* aiMaterial,ImportContex
 
 
 size_t am::MaterialAsset::calculateContentHash() const {
-    size_t hash = 0;
-
-    if (data.baseColorTexture) {
-        hash ^= data.baseColorTexture->contentHash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    }
-    if (data.metallicRoughnessTexture) {
-        hash ^= data.metallicRoughnessTexture->contentHash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    }
-    return hash;
+    // 0 stands in for a missing texture, so the two slots can't be swapped without changing the hash
+    am::ContentHasher hasher;
+    hasher.add(data.baseColorTexture ? static_cast<uint64_t>(data.baseColorTexture->contentHash) : 0);
+    hasher.add(data.metallicRoughnessTexture ? static_cast<uint64_t>(data.metallicRoughnessTexture->contentHash) : 0);
+    return hasher.result();
 }
 
 am::AssetType am::MaterialAsset::getType() const {
     return am::AssetType::Material;
-}
\ No newline at end of file
+}
+
+am::ImportInputs am::MaterialAsset::getImportInputs(const ImportContext& importContext) {
+    return AssetManager::getImportSceneInputs(importContext.importPath, kImportFlags);
+}
+
+std::vector<boost::uuids::uuid> am::MaterialAsset::getDependencies() const {
+    std::vector<boost::uuids::uuid> dependencies;
+    for (const auto& texture : {data.baseColorTexture, data.diffuseTexture, data.metallicRoughnessTexture, data.specularGlossinessTexture,
+                                data.normalTexture, data.occlusionTexture, data.emissiveTexture}) {
+        // The diffuse texture usually is the base color one
+        if (texture && std::find(dependencies.begin(), dependencies.end(), texture->id) == dependencies.end())
+            dependencies.push_back(texture->id);
+    }
+    return dependencies;
+}
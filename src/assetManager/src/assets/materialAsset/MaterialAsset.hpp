@@ -27,6 +27,8 @@ public:
 
     size_t calculateContentHash() const override;
     [[nodiscard]] AssetType getType() const override;
+    static ImportInputs getImportInputs(const ImportContext& importContext);
+    [[nodiscard]] std::vector<boost::uuids::uuid> getDependencies() const override;
 
     void SaveAssetMetadata(rapidjson::Document& document) override {}
     void LoadAssetMetadata(rapidjson::Document& document) override {}
@@ -36,6 +38,8 @@ public:
     }
 
 private:
+    static constexpr unsigned int kImportFlags = aiProcess_Triangulate | aiProcess_GenSmoothNormals |
+                                                 aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
 
     MaterialData data;
     void extractPBRData(const aiMaterial* aiMaterial,ImportContext& assetFactoryData);
@@ -4,6 +4,8 @@
 
 #include "MeshAsset.h"
 #include "../../JsonHelpers.hpp"
+#include "BinaryContainer.hpp"
+#include "ContentHash.hpp"
 
 
 
@@ -14,55 +16,48 @@
 using namespace std;
 
 namespace am {
+    namespace {
+        constexpr uint32_t kMeshKind = makeFourCC('M', 'E', 'S', 'H');
+        constexpr uint32_t kMeshInfoTag = makeFourCC('I', 'N', 'F', 'O');
+        constexpr uint32_t kMeshVertexTag = makeFourCC('V', 'E', 'R', 'T');
+        constexpr uint32_t kMeshIndexTag = makeFourCC('I', 'N', 'D', 'X');
+        constexpr uint32_t kMeshBvhNodeTag = makeFourCC('B', 'V', 'H', 'N');
+        constexpr uint32_t kMeshBvhPacketTag = makeFourCC('B', 'V', 'H', 'P');
+
+        struct MeshBinaryInfo {
+            boost::uuids::uuid material;
+            glm::vec3 boundingBoxMin;
+            glm::vec3 boundingBoxMax;
+        };
+    }
 
     MeshAsset::MeshAsset(const boost::uuids::uuid& id) : Asset(id), importContext("", AssetType::Other) {
     }
 
     size_t MeshAsset::calculateContentHash() const {
-        size_t hash = 0;
-
-        // Hash vertices
-        for (const auto &vertex: data.vertices) {
-            // Combine hash with vertex data
-            hash ^= std::hash<float>{}(vertex.Position.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.Position.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.Position.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-
-            // Hash normal if present
-            hash ^= std::hash<float>{}(vertex.Normal.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.Normal.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.Normal.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-
-            // Hash texture coordinates if present
-            hash ^= std::hash<float>{}(vertex.TexCoords.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            hash ^= std::hash<float>{}(vertex.TexCoords.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-        }
-
-        // Hash indices
-        for (const auto &index: data.indices) {
-            hash ^= std::hash<unsigned int>{}(index) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-        }
+        static_assert(sizeof(VertexAsset) == 18 * sizeof(float), "Vertices are hashed as bytes, they can't have padding");
 
-        return hash;
+        // Whole vertices, so meshes that only differ in colors or tangents aren't deduplicated into one
+        ContentHasher hasher;
+        hasher.addSpan(data.getVertices());
+        hasher.addSpan(data.getIndices());
+        return hasher.result();
     }
 
 
     MeshAsset::MeshAsset(const boost::uuids::uuid& id, const ImportContext& assetFactoryData): Asset(id, assetFactoryData), importContext(assetFactoryData)
     {
         AssetManager &assetManager = AssetManager::getInstance();
-        auto scene = assetManager.importer.GetScene();
+        // Reuses the scene of the model being imported on this thread
+        auto scene = assetManager.getImportScene(assetFactoryData.importPath, kImportFlags);
 
         data.boundingBoxMin = glm::vec3(std::numeric_limits<float>::max());
         data.boundingBoxMax = glm::vec3(std::numeric_limits<float>::lowest());
 
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+        if (!scene)
         {
-            scene = assetManager.importer.ReadFile(assetFactoryData.importPath, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
-            if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
-            {
-                spdlog::error("Assimp error: " + string(assetManager.importer.GetErrorString()));
-                throw std::runtime_error("Assimp error: " + string(assetManager.importer.GetErrorString()));
-            }
+            spdlog::error("Assimp error: " + assetManager.getImportError());
+            throw std::runtime_error("Assimp error: " + assetManager.getImportError());
         }
              // walk through each of the mesh's vertices
         auto mesh = scene->mMeshes[assetFactoryData.assimpIndex];
@@ -169,13 +164,15 @@ namespace am {
         for (int i = 0; i < data.vertices.size(); ++i) {
             Normalize(data.vertices[i]);
         }
+
+        data.bvh = buildMeshBVH(data.vertices, data.indices);
     }
 
     MeshAsset::MeshAsset(const boost::uuids::uuid& id, const std::string& path, AssetFormat format): Asset(id, path, format), importContext("",AssetType::Other)
     {
         if (format == AssetFormat::Json) {
             rapidjson::Document document;
-            if (!loadJsonFromFile(path, document)) {
+            if (!AssetManager::getInstance().loadAssetJson(id, path, document)) {
                 spdlog::error("Failed to load MeshAsset from JSON: {}", path);
                 return;
             }
@@ -191,54 +188,60 @@ namespace am {
             if (document.HasMember("binPath") && document["binPath"].IsString()) {
                 std::string binPath = document["binPath"].GetString();
 
-                std::ifstream ifs(binPath, std::ios::binary | std::ios::in);
-                if (!ifs.is_open()) {
-                    spdlog::error("Failed to open file for reading binary asset: {}", binPath);
-                    return;
-                }
-
-                // Read magic number
-                char magic[6];
-                ifs.read(magic, sizeof(magic));
-                if (std::string(magic) != "RMESH") {
-                    spdlog::error("Invalid magic number in binary mesh asset: {}", binPath);
-                    return;
-                }
+                auto mapped = MappedFile::open(binPath);
+                if (mapped && BinaryContainerReader::isContainer(mapped->bytes())) {
+                    loadFromContainer(std::move(mapped), binPath);
+                } else {
+                    std::ifstream ifs(binPath, std::ios::binary | std::ios::in);
+                    if (!ifs.is_open()) {
+                        spdlog::error("Failed to open file for reading binary asset: {}", binPath);
+                        return;
+                    }
 
-                // Read material path
-                size_t pathSize;
-                ifs.read(reinterpret_cast<char*>(&pathSize), sizeof(pathSize));
-                std::string materialPath(pathSize, '\0');
-                ifs.read(&materialPath[0], pathSize);
+                    // Read magic number
+                    char magic[6];
+                    ifs.read(magic, sizeof(magic));
+                    if (std::string(magic) != "RMESH") {
+                        spdlog::error("Invalid magic number in binary mesh asset: {}", binPath);
+                        return;
+                    }
 
-                if (!materialPath.empty()) {
-                    auto result = AssetManager::getInstance().registerAsset(materialPath);
-                    if (result) {
-                        data.material = AssetManager::getInstance().getAssetInfo(result.value()).value_or(nullptr);
+                    // Read material path
+                    size_t pathSize;
+                    ifs.read(reinterpret_cast<char*>(&pathSize), sizeof(pathSize));
+                    std::string materialPath(pathSize, '\0');
+                    ifs.read(&materialPath[0], pathSize);
+
+                    if (!materialPath.empty()) {
+                        auto result = AssetManager::getInstance().registerAsset(materialPath);
+                        if (result) {
+                            data.material = AssetManager::getInstance().getAssetInfo(result.value()).value_or(nullptr);
+                        }
                     }
-                }
 
-                // Read bounding box
-                ifs.read(reinterpret_cast<char*>(&data.boundingBoxMin), sizeof(glm::vec3));
-                ifs.read(reinterpret_cast<char*>(&data.boundingBoxMax), sizeof(glm::vec3));
+                    // Read bounding box
+                    ifs.read(reinterpret_cast<char*>(&data.boundingBoxMin), sizeof(glm::vec3));
+                    ifs.read(reinterpret_cast<char*>(&data.boundingBoxMax), sizeof(glm::vec3));
 
-                // Read vertices
-                size_t vertexCount;
-                ifs.read(reinterpret_cast<char*>(&vertexCount), sizeof(vertexCount));
-                data.vertices.resize(vertexCount);
-                if (vertexCount > 0) {
-                    ifs.read(reinterpret_cast<char*>(data.vertices.data()), vertexCount * sizeof(am::VertexAsset));
-                }
+                    // Read vertices
+                    size_t vertexCount;
+                    ifs.read(reinterpret_cast<char*>(&vertexCount), sizeof(vertexCount));
+                    data.vertices.resize(vertexCount);
+                    if (vertexCount > 0) {
+                        ifs.read(reinterpret_cast<char*>(data.vertices.data()), vertexCount * sizeof(am::VertexAsset));
+                    }
 
-                // Read indices
-                size_t indexCount;
-                ifs.read(reinterpret_cast<char*>(&indexCount), sizeof(indexCount));
-                data.indices.resize(indexCount);
-                if (indexCount > 0) {
-                    ifs.read(reinterpret_cast<char*>(data.indices.data()), indexCount * sizeof(unsigned int));
-                }
+                    // Read indices
+                    size_t indexCount;
+                    ifs.read(reinterpret_cast<char*>(&indexCount), sizeof(indexCount));
+                    data.indices.resize(indexCount);
+                    if (indexCount > 0) {
+                        ifs.read(reinterpret_cast<char*>(data.indices.data()), indexCount * sizeof(unsigned int));
+                    }
 
-                ifs.close();
+                    ifs.close();
+                    data.bvh = buildMeshBVH(data.vertices, data.indices);
+                }
             }
 
             if (document.HasMember("material") && document["material"].IsString()) {
@@ -265,6 +268,13 @@ namespace am {
             loadVec3("boundingBoxMin", data.boundingBoxMin);
             loadVec3("boundingBoxMax", data.boundingBoxMax);
         } else if (format == AssetFormat::Binary) {
+            auto mapped = AssetManager::getInstance().openAssetFile(id, path);
+            if (mapped && BinaryContainerReader::isContainer(mapped->bytes())) {
+                loadFromContainer(std::move(mapped), path);
+                return;
+            }
+
+            // Files written before the container format
             std::ifstream ifs(path, std::ios::binary | std::ios::in);
             if (!ifs.is_open()) {
                 spdlog::error("Failed to open file for reading binary asset: {}", path);
@@ -318,6 +328,7 @@ namespace am {
             }
 
             ifs.close();
+            data.bvh = buildMeshBVH(data.vertices, data.indices);
         }
     }
 
@@ -357,43 +368,93 @@ namespace am {
         return AssetType::Mesh;
     }
 
+    ImportInputs MeshAsset::getImportInputs(const ImportContext& importContext) {
+        return AssetManager::getImportSceneInputs(importContext.importPath, kImportFlags);
+    }
+
+    std::vector<boost::uuids::uuid> MeshAsset::getDependencies() const {
+        if (data.material)
+            return {data.material->id};
+        return {};
+    }
+
+    size_t MeshAsset::getMemoryUsage() const {
+        return data.getVertices().size_bytes() + data.getIndices().size_bytes() + data.getBvhNodes().size_bytes() +
+               data.getBvhPackets().size_bytes();
+    }
+
     void MeshAsset::SaveAssetToBin(std::string& path) {
-        std::ofstream ofs(path, std::ios::binary | std::ios::out);
-        if (!ofs.is_open()) {
-            spdlog::error("Failed to open file for writing binary asset: {}", path);
-            return;
+        MeshBinaryInfo info{};
+        info.material = data.material ? data.material->id : boost::uuids::nil_uuid();
+        info.boundingBoxMin = data.boundingBoxMin;
+        info.boundingBoxMax = data.boundingBoxMax;
+
+        BinaryContainerWriter writer(kMeshKind, id);
+        writer.addValue(kMeshInfoTag, info);
+        writer.addSection(kMeshVertexTag, data.getVertices());
+        writer.addSection(kMeshIndexTag, data.getIndices());
+        writer.addSection(kMeshBvhNodeTag, data.getBvhNodes());
+        writer.addSection(kMeshBvhPacketTag, data.getBvhPackets());
+        writer.write(path);
+    }
+
+    bool MeshAsset::loadFromContainer(std::shared_ptr<const MappedFile> file, const std::string& path) {
+        auto bytes = file->bytes();
+        auto reader = BinaryContainerReader::open(std::move(file), bytes, kMeshKind);
+        if (!reader) {
+            return false;
         }
 
-        // Write magic number or version if needed
-        const char magic[] = "RMESH";
-        ofs.write(magic, sizeof(magic));
+        if (reader->getId() != id) {
+            spdlog::warn("Mesh asset UUID mismatch: expected {}, got {}", boost::uuids::to_string(id), boost::uuids::to_string(reader->getId()));
+        }
 
-        // Write UUID
-        ofs.write(reinterpret_cast<const char*>(&id), 16);
+        auto info = reader->sectionValue<MeshBinaryInfo>(kMeshInfoTag);
+        auto vertices = reader->sectionAs<am::VertexAsset>(kMeshVertexTag);
+        auto indices = reader->sectionAs<unsigned int>(kMeshIndexTag);
 
-        // Write material UUID
-        boost::uuids::uuid materialId = data.material ? data.material->id : boost::uuids::nil_uuid();
-        ofs.write(reinterpret_cast<const char*>(&materialId), 16);
+        // An empty view is only valid if the section itself is empty, otherwise the vertex layout changed
+        if (!info || vertices.size_bytes() != reader->section(kMeshVertexTag).size() ||
+            indices.size_bytes() != reader->section(kMeshIndexTag).size()) {
+            spdlog::error("Binary mesh asset has missing or mismatched sections: {}", path);
+            return false;
+        }
 
-        // Write bounding box
-        ofs.write(reinterpret_cast<const char*>(&data.boundingBoxMin), sizeof(glm::vec3));
-        ofs.write(reinterpret_cast<const char*>(&data.boundingBoxMax), sizeof(glm::vec3));
+        data.boundingBoxMin = info->boundingBoxMin;
+        data.boundingBoxMax = info->boundingBoxMax;
 
-        // Write vertices
-        size_t vertexCount = data.vertices.size();
-        ofs.write(reinterpret_cast<const char*>(&vertexCount), sizeof(vertexCount));
-        if (vertexCount > 0) {
-            ofs.write(reinterpret_cast<const char*>(data.vertices.data()), vertexCount * sizeof(am::VertexAsset));
+        if (!info->material.is_nil()) {
+            data.material = AssetManager::getInstance().getAssetInfo(info->material).value_or(nullptr);
+            if (!data.material) {
+                spdlog::warn("Material asset with UUID {} not found for mesh {}", boost::uuids::to_string(info->material), path);
+            }
         }
 
-        // Write indices
-        size_t indexCount = data.indices.size();
-        ofs.write(reinterpret_cast<const char*>(&indexCount), sizeof(indexCount));
-        if (indexCount > 0) {
-            ofs.write(reinterpret_cast<const char*>(data.indices.data()), indexCount * sizeof(unsigned int));
+        data.vertices.clear();
+        data.indices.clear();
+        data.mappedVertices = vertices;
+        data.mappedIndices = indices;
+        data.mapping = reader->getFile();
+
+        // The tree is optional, containers written before it get one built from the mapped triangles. Its indices are
+        // checked here once, traversal trusts them
+        auto bvhNodes = reader->sectionAs<MeshBVHNode>(kMeshBvhNodeTag);
+        auto bvhPackets = reader->sectionAs<MeshTrianglePacket>(kMeshBvhPacketTag);
+        bool bvhUsable = !bvhNodes.empty() && bvhPackets.size_bytes() == reader->section(kMeshBvhPacketTag).size();
+        if (bvhUsable && !validateMeshBVH(bvhNodes, bvhPackets)) {
+            spdlog::warn("Mesh {} has a BVH with indices out of range, rebuilding it", path);
+            bvhUsable = false;
         }
-
-        ofs.close();
+        if (bvhUsable) {
+            data.mappedBvhNodes = bvhNodes;
+            data.mappedBvhPackets = bvhPackets;
+            data.bvh = {};
+        } else {
+            data.mappedBvhNodes = {};
+            data.mappedBvhPackets = {};
+            data.bvh = buildMeshBVH(vertices, indices);
+        }
+        return true;
     }
 }
 
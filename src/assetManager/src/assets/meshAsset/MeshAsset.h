@@ -42,6 +42,9 @@ namespace am {
         //This maby someday should intake a interface of materials
         size_t calculateContentHash() const override;
         [[nodiscard]] AssetType getType() const override;
+        static ImportInputs getImportInputs(const ImportContext& importContext);
+        [[nodiscard]] std::vector<boost::uuids::uuid> getDependencies() const override;
+        [[nodiscard]] size_t getMemoryUsage() const override;
 
         void SaveAssetMetadata(rapidjson::Document& document) override {}
         void LoadAssetMetadata(rapidjson::Document& document) override {}
@@ -51,8 +54,13 @@ namespace am {
         }
 
     private:
+        static constexpr unsigned int kImportFlags = aiProcess_Triangulate | aiProcess_GenSmoothNormals |
+                                                     aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
+
         MeshData data;
         ImportContext importContext;
+
+        bool loadFromContainer(std::shared_ptr<const MappedFile> file, const std::string& path);
     };
 }
 
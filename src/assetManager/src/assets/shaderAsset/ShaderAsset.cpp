@@ -1,17 +1,24 @@
 #include "ShaderAsset.h"
 #include "../../JsonHelpers.hpp"
+#include "BinaryContainer.hpp"
+#include "ContentHash.hpp"
 
 #include <spdlog/spdlog.h>
-#include <glslang/Public/ShaderLang.h>
-#include <glslang/Public/ResourceLimits.h>
-#include <glslang/SPIRV/GlslangToSpv.h>
 #include <filesystem>
-#include <regex>
 #include <set>
 
-#include "ShaderIncluder.hpp"
+#include "ShaderCompiler.hpp"
+#include "ShaderSourceScanner.hpp"
 
 namespace am {
+    namespace {
+        constexpr uint32_t kShaderKind = makeFourCC('S', 'H', 'D', 'R');
+        constexpr uint32_t kShaderStageTag = makeFourCC('S', 'T', 'G', 'E');
+        constexpr uint32_t kShaderSourceTag = makeFourCC('S', 'R', 'C', 'P');
+        constexpr uint32_t kShaderDefinesTag = makeFourCC('D', 'E', 'F', 'S');
+        constexpr uint32_t kShaderSpirvTag = makeFourCC('S', 'P', 'I', 'R');
+    }
+
     ShaderAsset::ShaderAsset(const boost::uuids::uuid& id) : Asset(id) {
     }
 
@@ -23,6 +30,13 @@ namespace am {
         if (format == AssetFormat::Json) {
             throw std::runtime_error("ShaderAsset does not support JSON format");
         } else if (format == AssetFormat::Binary) {
+            auto mapped = AssetManager::getInstance().openAssetFile(id, path);
+            if (mapped && BinaryContainerReader::isContainer(mapped->bytes())) {
+                loadFromContainer(std::move(mapped), path);
+                return;
+            }
+
+            // Files written before the container format
             std::ifstream ifs(path, std::ios::binary | std::ios::in);
             if (!ifs.is_open()) {
                 spdlog::error("Failed to open binary shader asset: {}", path);
@@ -77,15 +91,12 @@ namespace am {
         }
     }
 
-    // Helper function to extract defines from shader source
+    // Helper function to extract defines from shader source. Without defines it only follows the includes
     void extractDefinesRecursive(const std::string& source, const std::filesystem::path& currentFilePath,
                                  const std::filesystem::path& shaderBaseDir,
-                                 std::map<std::string, std::string>& defines,
+                                 std::map<std::string, std::string>* defines,
                                  std::set<std::filesystem::path>& processedFiles) {
-        // Regex to match: #define NAME VALUE (with optional value)
-        std::regex defineRegex(R"(#\s*define\s+(\w+)(?:\s+([^\n\r]+?))?\s*(?:\n|\r|$))");
-        // Regex to match: #include "PATH" or #include <PATH>
-        std::regex includeRegex(R"(#\s*include\s+["<]([^">]+)[">])");
+        const ShaderDirectives directives = scanShaderDirectives(source);
 
         // Mark this file as processed to avoid infinite inclusion loops
         try {
@@ -95,28 +106,17 @@ namespace am {
         }
 
         // 1. Extract defines from the current source
-        std::sregex_iterator d_begin(source.begin(), source.end(), defineRegex);
-        std::sregex_iterator d_end;
-        for (auto it = d_begin; it != d_end; ++it) {
-            std::string name = (*it)[1].str();
-            std::string value = (*it)[2].matched ? (*it)[2].str() : "";
-
-            if (!value.empty()) {
-                value.erase(0, value.find_first_not_of(" \t"));
-                value.erase(value.find_last_not_of(" \t") + 1);
-            }
-
-            if (defines.find(name) == defines.end()) {
-                defines[name] = value;
-        spdlog::info("Found shader define: {} = '{}'", name, value);
+        if (defines) {
+            for (const auto& [name, value] : directives.defines) {
+                if (defines->try_emplace(std::string(name), value).second) {
+                    spdlog::info("Found shader define: {} = '{}'", name, value);
+                }
             }
         }
 
         // 2. Process includes recursively
-        std::sregex_iterator i_begin(source.begin(), source.end(), includeRegex);
-        std::sregex_iterator i_end;
-        for (auto it = i_begin; it != i_end; ++it) {
-            std::string includePathStr = (*it)[1];
+        for (const auto includeName : directives.includes) {
+            const std::string includePathStr(includeName);
             std::filesystem::path includePath;
 
             // Resolve path (logic mirrored from ShaderIncluder)
@@ -154,49 +154,77 @@ namespace am {
 
     void ShaderAsset::SaveAssetToBin(std::string& path)
     {
-        std::ofstream ofs(path, std::ios::binary | std::ios::out);
-        if (!ofs.is_open()) {
-            spdlog::error("Failed to open file for writing binary shader asset: {}", path);
-            return;
+        const uint32_t stage = static_cast<uint32_t>(data.stage);
+
+        // Defines are packed as [keySize, valueSize, key, value] with 32 bit sizes
+        std::vector<std::byte> defines;
+        for (const auto& [key, value] : data.defines) {
+            const uint32_t sizes[2] = {static_cast<uint32_t>(key.size()), static_cast<uint32_t>(value.size())};
+            const auto* sizeBytes = reinterpret_cast<const std::byte*>(sizes);
+            defines.insert(defines.end(), sizeBytes, sizeBytes + sizeof(sizes));
+            defines.insert(defines.end(), reinterpret_cast<const std::byte*>(key.data()), reinterpret_cast<const std::byte*>(key.data()) + key.size());
+            defines.insert(defines.end(), reinterpret_cast<const std::byte*>(value.data()), reinterpret_cast<const std::byte*>(value.data()) + value.size());
         }
 
-        // Write magic number
-        const char magic[] = "RSHDR";
-        ofs.write(magic, sizeof(magic));
+        BinaryContainerWriter writer(kShaderKind, id);
+        writer.addValue(kShaderStageTag, stage);
+        writer.addSection(kShaderSourceTag, std::as_bytes(std::span(data.originalSource)));
+        writer.addSection(kShaderDefinesTag, std::span<const std::byte>(defines));
+        writer.addSection(kShaderSpirvTag, data.getBytecode());
+        if (writer.write(path)) {
+            spdlog::info("Saved binary shader asset: {}", path);
+        }
+    }
 
-        // Write UUID
-        ofs.write(reinterpret_cast<const char*>(&id), 16);
+    bool ShaderAsset::loadFromContainer(std::shared_ptr<const MappedFile> file, const std::string& path)
+    {
+        auto bytes = file->bytes();
+        auto reader = BinaryContainerReader::open(std::move(file), bytes, kShaderKind);
+        if (!reader) {
+            return false;
+        }
 
-        // Write stage
-        ofs.write(reinterpret_cast<const char*>(&data.stage), sizeof(data.stage));
+        if (reader->getId() != id) {
+            spdlog::warn("Shader asset UUID mismatch: expected {}, got {}", boost::uuids::to_string(id), boost::uuids::to_string(reader->getId()));
+        }
 
-        // Write originalSource
-        size_t sourcePathSize = data.originalSource.size();
-        ofs.write(reinterpret_cast<const char*>(&sourcePathSize), sizeof(sourcePathSize));
-        ofs.write(data.originalSource.c_str(), sourcePathSize);
+        auto stage = reader->sectionValue<uint32_t>(kShaderStageTag);
+        auto spirv = reader->sectionAs<std::uint32_t>(kShaderSpirvTag);
+        if (!stage || spirv.size_bytes() != reader->section(kShaderSpirvTag).size()) {
+            spdlog::error("Binary shader asset has missing or mismatched sections: {}", path);
+            return false;
+        }
 
-        // Write defines map
-        size_t definesCount = data.defines.size();
-        ofs.write(reinterpret_cast<const char*>(&definesCount), sizeof(definesCount));
-        for (const auto& [key, value] : data.defines) {
-            size_t keySize = key.size();
-            ofs.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
-            ofs.write(key.c_str(), keySize);
+        auto source = reader->section(kShaderSourceTag);
+        auto defines = reader->section(kShaderDefinesTag);
 
-            size_t valueSize = value.size();
-            ofs.write(reinterpret_cast<const char*>(&valueSize), sizeof(valueSize));
-            ofs.write(value.c_str(), valueSize);
-        }
+        std::map<std::string, std::string> parsedDefines;
+        size_t cursor = 0;
+        while (cursor < defines.size()) {
+            uint32_t sizes[2];
+            if (defines.size() - cursor < sizeof(sizes)) {
+                spdlog::error("Truncated defines in binary shader asset: {}", path);
+                return false;
+            }
+            std::memcpy(sizes, defines.data() + cursor, sizeof(sizes));
+            cursor += sizeof(sizes);
 
-        // Write bytecode
-        size_t bytecodeSize = data.bytecode.size();
-        ofs.write(reinterpret_cast<const char*>(&bytecodeSize), sizeof(bytecodeSize));
-        if (bytecodeSize > 0) {
-            ofs.write(reinterpret_cast<const char*>(data.bytecode.data()), bytecodeSize * sizeof(std::uint32_t));
+            if (defines.size() - cursor < static_cast<size_t>(sizes[0]) + sizes[1]) {
+                spdlog::error("Truncated defines in binary shader asset: {}", path);
+                return false;
+            }
+            const char* chars = reinterpret_cast<const char*>(defines.data() + cursor);
+            parsedDefines.emplace(std::string(chars, sizes[0]), std::string(chars + sizes[0], sizes[1]));
+            cursor += static_cast<size_t>(sizes[0]) + sizes[1];
         }
 
-        ofs.close();
-        spdlog::info("Saved binary shader asset: {}", path);
+        data.stage = static_cast<ShaderStage>(*stage);
+        data.originalSource.assign(reinterpret_cast<const char*>(source.data()), source.size());
+        data.defines = std::move(parsedDefines);
+        data.bytecode.clear();
+        data.mappedBytecode = spirv;
+        data.mapping = reader->getFile();
+        return true;
     }
 
     void ShaderAsset::loadFromFile(const std::string& path) {
@@ -243,137 +271,85 @@ namespace am {
         // Extract defines from shader source (recursively including files)
         std::map<std::string, std::string> defines;
         std::set<std::filesystem::path> processedFiles;
-        std::filesystem::path shaderBaseDir("res/shaders/glsl/entry");
-        extractDefinesRecursive(source, std::filesystem::absolute(path), shaderBaseDir, defines, processedFiles);
+        const ShaderCompiler& compiler = ShaderCompiler::getDefault();
+        extractDefinesRecursive(source, std::filesystem::absolute(path), compiler.getIncludeDirectory(), &defines, processedFiles);
 
         // Compile GLSL to SPIR-V with extracted defines
-        auto bytecode = compileGLSLToSPIRV(source, stage, defines);
+        auto compiled = compiler.compile(source, stage, defines);
 
-        if (bytecode.empty()) {
+        if (!compiled || compiled->getBytecode().empty()) {
             spdlog::error("Failed to compile shader: {}", path);
             throw std::runtime_error("Failed to compile shader: " + path);
         }
 
-        // Create and store the shader data
+        // Create and store the shader data, SPIR-V from the cache stays mapped
         data = ShaderData{
-            .bytecode = std::move(bytecode),
+            .bytecode = std::move(compiled->bytecode),
             .stage = stage,
             .defines = std::move(defines),
-            .originalSource = path
+            .originalSource = path,
+            .mapping = std::move(compiled->mapping),
+            .mappedBytecode = compiled->mappedBytecode
         };
 
-        spdlog::info("Compiled shader: {} (size: {} bytes)",
-                     path, (int)(data.bytecode.size() * 4));
+        spdlog::info("{} shader: {} (size: {} bytes)", compiled->fromCache ? "Cached" : "Compiled",
+                     path, (int)(data.getBytecode().size() * 4));
     }
 
 
-    std::vector<std::uint32_t> ShaderAsset::compileGLSLToSPIRV(
-        const std::string &source,
-        ShaderStage stage,
-        const std::map<std::string, std::string>& defines
-    ) const {
-        // Initialize glslang library
-        glslang::InitializeProcess();
-
-        // Determine EShLanguage from ShaderStage
-        EShLanguage language;
-        switch (stage) {
-            case ShaderStage::Vertex:
-                language = EShLangVertex;
-                break;
-            case ShaderStage::Fragment:
-                language = EShLangFragment;
-                break;
-            case ShaderStage::Compute:
-                language = EShLangCompute;
-                break;
-            case ShaderStage::Geometry:
-                language = EShLangGeometry;
-                break;
-            case ShaderStage::TessellationControl:
-                language = EShLangTessControl;
-                break;
-            case ShaderStage::TessellationEvaluation:
-                language = EShLangTessEvaluation;
-                break;
-            default:
-                spdlog::error("Unknown shader stage");
-                return {};
-        }
-
-        // Create shader object
-        glslang::TShader shader(language);
-        const char* sourcePtr = source.c_str();
-
-        // Build preamble with defines
-        std::string preamble;
-        for (const auto& [name, value] : defines) {
-            if (value.empty()) {
-                preamble += "#define " + name + "\n";
-            } else {
-                preamble += "#define " + name + " " + value + "\n";
-            }
-        }
-
-        // Combine preamble and source into a single string
-        std::string combinedSource = preamble + source;
-
-        shader.setStrings(&sourcePtr, 1);
+    size_t ShaderAsset::calculateContentHash() const {
+        // Hash both the bytecode and the shader stage
+        ContentHasher hasher;
+        hasher.addSpan(data.getBytecode());
+        hasher.add(static_cast<std::uint32_t>(data.stage));
+        return hasher.result();
+    }
 
-        shader.setEnvInput(glslang::EShSourceGlsl, language, glslang::EShClientVulkan, glslang::EShTargetVulkan_1_3);
-        shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_3);
-        shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_6);
+    AssetType ShaderAsset::getType() const {
+        return AssetType::Shader;
+    }
 
-        // Create custom includer
-        ShaderIncluder includer(std::filesystem::path("res/shaders/glsl/entry"));
+    std::span<const std::uint32_t> ShaderAsset::getBytecode() const {
+        return data.getBytecode();
+    }
 
-        // Compile the shader with include support
-        EShMessages messages = static_cast<EShMessages>(EShMsgDefault | EShMsgSpvRules);
-        if (!shader.parse(GetDefaultResources(), 100, false, messages, includer)) {
-            spdlog::error("Failed to parse shader:");
-            spdlog::error("Info: {}", shader.getInfoLog());
-            spdlog::error("Debug: {}", shader.getInfoDebugLog());
-            glslang::FinalizeProcess();
-            return {};
-        }
+    ShaderStage ShaderAsset::getStage() const {
+        return data.stage;
+    }
 
-        // Create program and link
-        glslang::TProgram program;
-        program.addShader(&shader);
+    std::vector<std::string> ShaderAsset::getSourceFiles() const {
+        // Includes aren't stored with the shader, they are found again in the source it was compiled from
+        return collectIncludes(data.originalSource);
+    }
 
-        if (!program.link(EShMessages::EShMsgDefault)) {
-            spdlog::error("Failed to link shader program:");
-            spdlog::error("Info: {}", program.getInfoLog());
-            spdlog::error("Debug: {}", program.getInfoDebugLog());
-            glslang::FinalizeProcess();
+    std::vector<std::string> ShaderAsset::collectIncludes(const std::string& sourcePath) {
+        std::ifstream file(sourcePath, std::ios::binary | std::ios::in | std::ios::ate);
+        if (sourcePath.empty() || !file.is_open()) {
             return {};
         }
+        size_t fileSize = static_cast<size_t>(file.tellg());
+        file.seekg(0);
+        std::string source(fileSize, '\0');
+        file.read(source.data(), fileSize);
+        file.close();
 
-        // Generate SPIR-V from the program
-        std::vector<std::uint32_t> spirv;
-        glslang::GlslangToSpv(*program.getIntermediate(language), spirv);
-
-        glslang::FinalizeProcess();
-
-        return spirv;
-    }
-
-    size_t ShaderAsset::calculateContentHash() const {
-        size_t hash = 0;
-
-        // Hash both the bytecode and the shader stage
-        for (const auto &word: data.bytecode) {
-            hash ^= std::hash<std::uint32_t>{}(word) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        std::set<std::filesystem::path> processedFiles;
+        const auto path = std::filesystem::absolute(sourcePath);
+        extractDefinesRecursive(source, path, ShaderCompiler::getDefault().getIncludeDirectory(), nullptr, processedFiles);
+
+        std::error_code error;
+        const auto canonicalPath = std::filesystem::canonical(path, error);
+        std::vector<std::string> includes;
+        for (const auto& processed : processedFiles) {
+            if (processed != canonicalPath && processed != path) {
+                includes.push_back(processed.string());
+            }
         }
-
-        // Combine with shader stage
-        hash ^= std::hash<std::uint32_t>{}(static_cast<std::uint32_t>(data.stage));
-
-        return hash;
+        return includes;
     }
 
-    AssetType ShaderAsset::getType() const {
-        return AssetType::Shader;
+    ImportInputs ShaderAsset::getImportInputs(const ImportContext& importContext) {
+        return {collectIncludes(importContext.importPath), ShaderCompiler::getDefault().getSettingsHash()};
     }
 
     bool ShaderAsset::recompileWithDefines(const std::map<std::string, std::string>& newDefines) {
@@ -394,15 +370,17 @@ namespace am {
         file.read(source.data(), fileSize);
         file.close();
 
-        auto bytecode = compileGLSLToSPIRV(source, data.stage, newDefines);
+        auto compiled = ShaderCompiler::getDefault().compile(source, data.stage, newDefines);
 
-        if (bytecode.empty()) {
+        if (!compiled || compiled->getBytecode().empty()) {
             spdlog::error("Failed to recompile shader with new defines");
             return false;
         }
 
-        // Update shader data with new bytecode and defines
-        data.bytecode = std::move(bytecode);
+        // Update shader data with new bytecode and defines, replacing whatever was mapped before
+        data.bytecode = std::move(compiled->bytecode);
+        data.mapping = std::move(compiled->mapping);
+        data.mappedBytecode = compiled->mappedBytecode;
         data.defines = newDefines;
 
         spdlog::info("Shader recompiled");
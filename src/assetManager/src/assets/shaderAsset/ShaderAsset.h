@@ -44,6 +44,10 @@ namespace am {
         // Returns a view into the shader bytecode
         [[nodiscard]] std::span<const std::uint32_t> getBytecode() const;
         [[nodiscard]] ShaderStage getStage() const;
+        // The files the source includes, directly or through other includes
+        [[nodiscard]] std::vector<std::string> getSourceFiles() const override;
+        [[nodiscard]] static std::vector<std::string> collectIncludes(const std::string& sourcePath);
+        [[nodiscard]] static ImportInputs getImportInputs(const ImportContext& importContext);
 
         void SaveAssetMetadata(rapidjson::Document& document) override {}
         void LoadAssetMetadata(rapidjson::Document& document) override {}
@@ -55,11 +59,7 @@ namespace am {
     private:
         ShaderData data;
 
-        [[nodiscard]] std::vector<std::uint32_t> compileGLSLToSPIRV(
-           const std::string &source,
-           ShaderStage stage,
-           const std::map<std::string, std::string>& defines = {}
-       ) const;
+        bool loadFromContainer(std::shared_ptr<const MappedFile> file, const std::string& path);
 
         size_t calculateContentHash() const override;
         [[nodiscard]] AssetType getType() const override;
@@ -0,0 +1,253 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "ShaderCompiler.hpp"
+
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <boost/uuid/nil_generator.hpp>
+#include <glslang/build_info.h>
+#include <glslang/Public/ShaderLang.h>
+#include <glslang/Public/ResourceLimits.h>
+#include <glslang/SPIRV/GlslangToSpv.h>
+#include <spdlog/spdlog.h>
+
+#include "../../AssetManager.hpp"
+#include "ContentHash.hpp"
+#include "ShaderIncluder.hpp"
+
+namespace am
+{
+    namespace
+    {
+        constexpr uint32_t kSpirvCacheKind = makeFourCC('S', 'P', 'V', 'C');
+        constexpr uint32_t kSpirvCacheKeyTag = makeFourCC('K', 'E', 'Y', ' ');
+        constexpr uint32_t kSpirvCacheSpirvTag = makeFourCC('S', 'P', 'I', 'R');
+        // Bump when the compile options change, SPIR-V compiled with the old ones is ignored from then on
+        constexpr uint32_t kSpirvCacheVersion = 1;
+        constexpr std::uint32_t kSpirvMagic = 0x07230203;
+
+        constexpr int kDefaultGlslVersion = 100;
+        constexpr auto kClientVersion = glslang::EShTargetVulkan_1_3;
+        constexpr auto kTargetVersion = glslang::EShTargetSpv_1_6;
+
+        struct GlslangProcess {
+            GlslangProcess() { glslang::InitializeProcess(); }
+            ~GlslangProcess() { glslang::FinalizeProcess(); }
+        };
+
+        // Once for the process rather than around every compile, which also stops parallel imports from finalizing
+        // glslang while another one is still compiling
+        void initializeGlslang()
+        {
+            static GlslangProcess process;
+        }
+
+        std::optional<EShLanguage> getLanguage(ShaderStage stage)
+        {
+            switch (stage) {
+                case ShaderStage::Vertex:
+                    return EShLangVertex;
+                case ShaderStage::Fragment:
+                    return EShLangFragment;
+                case ShaderStage::Compute:
+                    return EShLangCompute;
+                case ShaderStage::Geometry:
+                    return EShLangGeometry;
+                case ShaderStage::TessellationControl:
+                    return EShLangTessControl;
+                case ShaderStage::TessellationEvaluation:
+                    return EShLangTessEvaluation;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        void setEnvironment(glslang::TShader& shader, EShLanguage language)
+        {
+            shader.setEnvInput(glslang::EShSourceGlsl, language, glslang::EShClientVulkan, kClientVersion);
+            shader.setEnvClient(glslang::EShClientVulkan, kClientVersion);
+            shader.setEnvTarget(glslang::EShTargetSpv, kTargetVersion);
+        }
+
+        std::string makePreamble(std::span<const std::string> permutation)
+        {
+            std::string preamble;
+            for (const auto& name : permutation) {
+                preamble += fmt::format("#define {} 1\n", name);
+            }
+            return preamble;
+        }
+
+        uint64_t makeCacheKey(const std::string& preprocessed, const std::string& preamble, ShaderStage stage,
+                              const std::map<std::string, std::string>& defines)
+        {
+            ContentHasher hasher;
+            hasher.add(kSpirvCacheVersion);
+            hasher.add(static_cast<uint32_t>(GLSLANG_VERSION_MAJOR * 10000 + GLSLANG_VERSION_MINOR * 100 + GLSLANG_VERSION_PATCH));
+            hasher.add(static_cast<uint32_t>(kClientVersion));
+            hasher.add(static_cast<uint32_t>(kTargetVersion));
+            hasher.add(static_cast<uint32_t>(stage));
+            hasher.add(static_cast<uint64_t>(defines.size()));
+            for (const auto& [name, value] : defines) {
+                hasher.addString(name);
+                hasher.addString(value);
+            }
+            hasher.addString(preamble);
+            hasher.addString(preprocessed);
+            return hasher.result();
+        }
+    }
+
+    ShaderCompiler::ShaderCompiler(std::filesystem::path includeDirectory, std::filesystem::path cacheDirectory)
+        : includeDirectory(std::move(includeDirectory)), cacheDirectory(std::move(cacheDirectory))
+    {
+    }
+
+    const ShaderCompiler& ShaderCompiler::getDefault()
+    {
+        static const ShaderCompiler compiler("res/shaders/glsl/entry", AssetManager::getInstance().getCacheDirectory("spirv"));
+        return compiler;
+    }
+
+    uint64_t ShaderCompiler::getSettingsHash() const
+    {
+        ContentHasher hasher;
+        hasher.add(static_cast<uint32_t>(GLSLANG_VERSION_MAJOR * 10000 + GLSLANG_VERSION_MINOR * 100 + GLSLANG_VERSION_PATCH));
+        hasher.add(static_cast<uint32_t>(kClientVersion));
+        hasher.add(static_cast<uint32_t>(kTargetVersion));
+        hasher.add(kDefaultGlslVersion);
+        hasher.addString(includeDirectory.generic_string());
+        return hasher.result();
+    }
+
+    std::optional<CompiledShader> ShaderCompiler::compile(const std::string& source, ShaderStage stage,
+                                                          const std::map<std::string, std::string>& defines,
+                                                          std::span<const std::string> permutation) const
+    {
+        initializeGlslang();
+
+        const auto language = getLanguage(stage);
+        if (!language) {
+            spdlog::error("Unknown shader stage");
+            return std::nullopt;
+        }
+
+        const char* sourcePtr = source.c_str();
+        const std::string preamble = makePreamble(permutation);
+        ShaderIncluder includer(includeDirectory);
+        const EShMessages messages = static_cast<EShMessages>(EShMsgDefault | EShMsgSpvRules);
+
+        // Preprocessing pulls in every include, so its output changes whenever anything the shader sees does
+        std::optional<uint64_t> key;
+        if (!cacheDirectory.empty()) {
+            glslang::TShader preprocessor(language.value());
+            preprocessor.setStrings(&sourcePtr, 1);
+            preprocessor.setPreamble(preamble.c_str());
+            setEnvironment(preprocessor, language.value());
+
+            std::string preprocessed;
+            if (!preprocessor.preprocess(GetDefaultResources(), kDefaultGlslVersion, ENoProfile, false, false, messages,
+                                         &preprocessed, includer)) {
+                spdlog::error("Failed to preprocess shader:");
+                spdlog::error("Info: {}", preprocessor.getInfoLog());
+                spdlog::error("Debug: {}", preprocessor.getInfoDebugLog());
+                return std::nullopt;
+            }
+
+            key = makeCacheKey(preprocessed, preamble, stage, defines);
+            if (auto cached = loadCached(key.value())) {
+                return cached;
+            }
+        }
+
+        glslang::TShader shader(language.value());
+        shader.setStrings(&sourcePtr, 1);
+        shader.setPreamble(preamble.c_str());
+        setEnvironment(shader, language.value());
+
+        if (!shader.parse(GetDefaultResources(), kDefaultGlslVersion, false, messages, includer)) {
+            spdlog::error("Failed to parse shader:");
+            spdlog::error("Info: {}", shader.getInfoLog());
+            spdlog::error("Debug: {}", shader.getInfoDebugLog());
+            return std::nullopt;
+        }
+
+        glslang::TProgram program;
+        program.addShader(&shader);
+
+        if (!program.link(EShMessages::EShMsgDefault)) {
+            spdlog::error("Failed to link shader program:");
+            spdlog::error("Info: {}", program.getInfoLog());
+            spdlog::error("Debug: {}", program.getInfoDebugLog());
+            return std::nullopt;
+        }
+
+        CompiledShader compiled;
+        glslang::GlslangToSpv(*program.getIntermediate(language.value()), compiled.bytecode);
+        if (key) {
+            storeCached(key.value(), compiled.bytecode);
+        }
+        return compiled;
+    }
+
+    std::filesystem::path ShaderCompiler::getCachePath(uint64_t key) const
+    {
+        return cacheDirectory / fmt::format("{:016x}.spv", key);
+    }
+
+    std::optional<CompiledShader> ShaderCompiler::loadCached(uint64_t key) const
+    {
+        const auto path = getCachePath(key);
+        std::error_code error;
+        if (!std::filesystem::exists(path, error)) {
+            return std::nullopt;
+        }
+
+        auto reader = BinaryContainerReader::open(path.string(), kSpirvCacheKind);
+        if (!reader) {
+            return std::nullopt;
+        }
+        const auto storedKey = reader->sectionValue<uint64_t>(kSpirvCacheKeyTag);
+        const auto spirv = reader->sectionAs<std::uint32_t>(kSpirvCacheSpirvTag);
+        if (!storedKey || storedKey.value() != key || spirv.empty() || spirv[0] != kSpirvMagic) {
+            spdlog::warn("Ignoring damaged SPIR-V cache entry: {}", path.string());
+            return std::nullopt;
+        }
+
+        CompiledShader cached;
+        cached.mapping = reader->getFile();
+        cached.mappedBytecode = spirv;
+        cached.fromCache = true;
+        return cached;
+    }
+
+    void ShaderCompiler::storeCached(uint64_t key, std::span<const std::uint32_t> spirv) const
+    {
+        BinaryContainerWriter writer(kSpirvCacheKind, boost::uuids::nil_uuid());
+        writer.addValue(kSpirvCacheKeyTag, key);
+        writer.addSection(kSpirvCacheSpirvTag, spirv);
+
+        // Parallel imports can compile the same shader, so every thread writes its own temp file and the last rename wins
+        const auto path = getCachePath(key);
+        const std::string tempPath = path.string() + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+        std::error_code error;
+        {
+            std::ofstream ofs(tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!ofs.is_open() || !writer.write(ofs)) {
+                spdlog::warn("Failed to write SPIR-V cache entry: {}", tempPath);
+                ofs.close();
+                std::filesystem::remove(tempPath, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            spdlog::warn("Failed to store SPIR-V cache entry {}: {}", path.string(), error.message());
+            std::filesystem::remove(tempPath, error);
+        }
+    }
+}
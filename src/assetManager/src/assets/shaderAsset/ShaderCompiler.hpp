@@ -0,0 +1,68 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef SHADERCOMPILER_HPP
+#define SHADERCOMPILER_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "BinaryContainer.hpp"
+#include "assetDatas/ShaderData.h"
+
+namespace am
+{
+    struct CompiledShader {
+        // Filled by a compile, empty when the SPIR-V is mapped from the cache
+        std::vector<std::uint32_t> bytecode;
+        std::shared_ptr<const MappedFile> mapping;
+        std::span<const std::uint32_t> mappedBytecode;
+        bool fromCache = false;
+
+        [[nodiscard]] std::span<const std::uint32_t> getBytecode() const {
+            return mapping ? mappedBytecode : std::span<const std::uint32_t>(bytecode);
+        }
+    };
+
+    // GLSL to SPIR-V for Vulkan 1.3 with glslang, which is initialized once for the whole process.
+    // Results are cached on disk under the hash of the preprocessed source, the defines and the target environment,
+    // so a shader whose source and includes are unchanged is mapped instead of compiled.
+    // Thread safe, every compile has its own glslang objects.
+    class ShaderCompiler
+    {
+    public:
+        // Includes resolve against includeDirectory, an empty cacheDirectory disables the cache
+        ShaderCompiler(std::filesystem::path includeDirectory, std::filesystem::path cacheDirectory);
+
+        // The one shaders are imported with, caching next to the asset registry
+        static const ShaderCompiler& getDefault();
+
+        // Defines take part in the cache key only, shaders read them from their source. Permutation names are
+        // defined to 1 ahead of the source, switching on the matching #ifdef blocks of a shader variant.
+        // nullopt if the source doesn't preprocess, parse or link, the errors are logged
+        [[nodiscard]] std::optional<CompiledShader> compile(const std::string& source, ShaderStage stage,
+                                                            const std::map<std::string, std::string>& defines = {},
+                                                            std::span<const std::string> permutation = {}) const;
+
+        [[nodiscard]] const std::filesystem::path& getIncludeDirectory() const { return includeDirectory; }
+        // Everything besides the source that changes what a compile produces: glslang, the targets and where includes resolve
+        [[nodiscard]] uint64_t getSettingsHash() const;
+
+    private:
+        [[nodiscard]] std::filesystem::path getCachePath(uint64_t key) const;
+        [[nodiscard]] std::optional<CompiledShader> loadCached(uint64_t key) const;
+        void storeCached(uint64_t key, std::span<const std::uint32_t> spirv) const;
+
+        std::filesystem::path includeDirectory;
+        std::filesystem::path cacheDirectory;
+    };
+}
+
+#endif //SHADERCOMPILER_HPP
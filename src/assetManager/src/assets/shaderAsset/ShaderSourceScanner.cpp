@@ -0,0 +1,120 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "ShaderSourceScanner.hpp"
+
+namespace am
+{
+    namespace
+    {
+        bool isBlank(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+        }
+
+        bool isIdentifierChar(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        }
+
+        const char* skipBlanks(const char* p, const char* end)
+        {
+            while (p < end && isBlank(*p))
+                ++p;
+            return p;
+        }
+
+        const char* skipIdentifier(const char* p, const char* end)
+        {
+            while (p < end && isIdentifierChar(*p))
+                ++p;
+            return p;
+        }
+
+        const char* findLineEnd(const char* p, const char* end)
+        {
+            while (p < end && *p != '\n')
+                ++p;
+            return p;
+        }
+
+        std::string_view trimBlanks(const char* begin, const char* end)
+        {
+            while (begin < end && isBlank(*begin))
+                ++begin;
+            while (end > begin && isBlank(end[-1]))
+                --end;
+            return {begin, static_cast<size_t>(end - begin)};
+        }
+
+        // p is just past the '#', returns the end of the directive's line
+        const char* scanDirective(const char* p, const char* end, ShaderDirectives& directives)
+        {
+            p = skipBlanks(p, end);
+            const char* keyword = p;
+            p = skipIdentifier(p, end);
+            const std::string_view name(keyword, static_cast<size_t>(p - keyword));
+            const char* lineEnd = findLineEnd(p, end);
+
+            if (name == "define") {
+                const char* macro = skipBlanks(p, lineEnd);
+                const char* macroEnd = skipIdentifier(macro, lineEnd);
+                if (macroEnd == macro || (macroEnd < lineEnd && *macroEnd == '('))
+                    return lineEnd;
+
+                // The value stops at a comment, the preprocessor drops it too
+                const char* valueEnd = macroEnd;
+                while (valueEnd < lineEnd && !(valueEnd[0] == '/' && valueEnd + 1 < lineEnd && (valueEnd[1] == '/' || valueEnd[1] == '*')))
+                    ++valueEnd;
+                directives.defines.emplace_back(std::string_view(macro, static_cast<size_t>(macroEnd - macro)), trimBlanks(macroEnd, valueEnd));
+            } else if (name == "include") {
+                const char* open = skipBlanks(p, lineEnd);
+                if (open == lineEnd || (*open != '"' && *open != '<'))
+                    return lineEnd;
+
+                const char close = *open == '"' ? '"' : '>';
+                const char* path = open + 1;
+                const char* pathEnd = path;
+                while (pathEnd < lineEnd && *pathEnd != close)
+                    ++pathEnd;
+                if (pathEnd < lineEnd)
+                    directives.includes.emplace_back(path, static_cast<size_t>(pathEnd - path));
+            }
+            return lineEnd;
+        }
+    }
+
+    ShaderDirectives scanShaderDirectives(std::string_view source)
+    {
+        ShaderDirectives directives;
+        const char* p = source.data();
+        const char* end = p + source.size();
+        bool lineStart = true;
+
+        while (p < end) {
+            const char c = *p;
+            if (c == '\n') {
+                lineStart = true;
+                ++p;
+            } else if (isBlank(c)) {
+                ++p;
+            } else if (c == '/' && p + 1 < end && p[1] == '/') {
+                p = findLineEnd(p, end);
+            } else if (c == '/' && p + 1 < end && p[1] == '*') {
+                // Stands for a blank, so a directive can still follow it on the same line
+                p += 2;
+                while (p < end && !(p[0] == '*' && p + 1 < end && p[1] == '/'))
+                    ++p;
+                p = p < end ? p + 2 : end;
+            } else if (c == '#' && lineStart) {
+                p = scanDirective(p + 1, end, directives);
+                lineStart = false;
+            } else {
+                lineStart = false;
+                ++p;
+            }
+        }
+        return directives;
+    }
+}
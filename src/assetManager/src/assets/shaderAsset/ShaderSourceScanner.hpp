@@ -0,0 +1,26 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef SHADERSOURCESCANNER_HPP
+#define SHADERSOURCESCANNER_HPP
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace am
+{
+    // The #define and #include directives of a GLSL source, in the order they appear. Views point into the source.
+    struct ShaderDirectives {
+        std::vector<std::pair<std::string_view, std::string_view>> defines;    // Name and value, trimmed, empty if it has none
+        std::vector<std::string_view> includes;                                 // Path between the quotes or angle brackets
+    };
+
+    // Single pass over the source without running the preprocessor. Comments are skipped and directives only count
+    // at the start of a line, as for the preprocessor, but conditionals aren't evaluated so every branch is reported.
+    // Function-like macros are left out, they can't be switched from the outside.
+    ShaderDirectives scanShaderDirectives(std::string_view source);
+}
+
+#endif //SHADERSOURCESCANNER_HPP
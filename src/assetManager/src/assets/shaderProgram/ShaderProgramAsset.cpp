@@ -1,13 +1,62 @@
 #include "ShaderProgramAsset.h"
 #include "../../AssetManager.hpp"
 #include "../../JsonHelpers.hpp"
+#include "../shaderAsset/ShaderAsset.h"
+#include "../shaderAsset/ShaderCompiler.hpp"
+#include "BinaryContainer.hpp"
+#include "ContentHash.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
 #include <fstream>
 #include <rapidjson/document.h>
 #include <rapidjson/istreamwrapper.h>
 #include <spdlog/spdlog.h>
 #include <filesystem>
+#include <thread>
+#include <unordered_map>
 
 namespace am {
+    namespace {
+        // Without an explicit "variants" list every combination is reachable, which stops being cheap quickly
+        constexpr size_t kMaxImplicitPermutationAxes = 6;
+
+        constexpr uint32_t kShaderProgramKind = makeFourCC('S', 'P', 'R', 'G');
+        constexpr uint32_t kProgramStagesTag = makeFourCC('S', 'T', 'G', 'S');
+        constexpr uint32_t kProgramAxesTag = makeFourCC('A', 'X', 'E', 'S');
+        constexpr uint32_t kProgramVariantsTag = makeFourCC('V', 'R', 'N', 'T');
+        constexpr uint32_t kProgramModulesTag = makeFourCC('M', 'O', 'D', 'S');
+        constexpr uint32_t kProgramSpirvTag = makeFourCC('S', 'P', 'I', 'R');
+
+        // Uuids of the stage shaders indexed by ShaderStage, nil for the stages the program doesn't have
+        using ProgramStageIds = std::array<std::array<uint8_t, 16>, kShaderStageCount>;
+
+        // Where one of ShaderProgramData::modules sits in the SPIR-V section, in 32 bit words
+        struct ProgramModuleRecord {
+            uint32_t stage;
+            uint32_t firstWord;
+            uint32_t wordCount;
+        };
+
+        // Keys of the import JSON naming a stage's GLSL file, relative to the JSON
+        constexpr const char* kStageKeys[] = {"vertex", "fragment", "compute", "geometry", "tessellationControl",
+                                              "tessellationEvaluation"};
+
+        std::optional<std::string> readShaderSource(const std::string& path) {
+            std::ifstream file(path, std::ios::binary | std::ios::in | std::ios::ate);
+            if (!file.is_open()) {
+                spdlog::error("Failed to open shader file: {}", path);
+                return std::nullopt;
+            }
+            const size_t fileSize = static_cast<size_t>(file.tellg());
+            file.seekg(0);
+            std::string source(fileSize, '\0');
+            file.read(source.data(), fileSize);
+            return source;
+        }
+    }
+
     ShaderProgramAsset::ShaderProgramAsset(const boost::uuids::uuid& id) : Asset(id) {
     }
 
@@ -16,9 +65,15 @@ namespace am {
     }
 
     ShaderProgramAsset::ShaderProgramAsset(const boost::uuids::uuid& id, const std::string& path, AssetFormat format) : Asset(id, path, format) {
-        if (format == AssetFormat::Json) {
-            loadFromProgramJson(path);
+        if (format == AssetFormat::Binary) {
+            auto mapped = AssetManager::getInstance().openAssetFile(id, path);
+            if (mapped && BinaryContainerReader::isContainer(mapped->bytes())) {
+                loadFromContainer(std::move(mapped), path);
+                return;
+            }
         }
+        // Programs saved as JSON before their variants were packed, compiled once more until they are saved again
+        loadFromProgramJson(path);
     }
 
     void ShaderProgramAsset::SaveAssetToJson(rapidjson::Document& document) {
@@ -42,8 +97,160 @@ namespace am {
         addStage("geometry", data.geometryShader);
         addStage("tessellationControl", data.tessellationControlShader);
         addStage("tessellationEvaluation", data.tessellationEvaluationShader);
+
+        if (data.permutationAxes.empty()) {
+            return;
+        }
+
+        // Only the axis names, loading the JSON compiles the variants again from the stage sources
+        rapidjson::Value axes(rapidjson::kArrayType);
+        for (const auto& axis : data.permutationAxes) {
+            axes.PushBack(rapidjson::Value(axis.c_str(), allocator), allocator);
+        }
+        rapidjson::Value variants(rapidjson::kArrayType);
+        for (const auto& variant : data.variants) {
+            rapidjson::Value enabled(rapidjson::kArrayType);
+            for (size_t axis = 0; axis < data.permutationAxes.size(); ++axis) {
+                if (variant.mask & (1u << axis)) {
+                    enabled.PushBack(rapidjson::Value(data.permutationAxes[axis].c_str(), allocator), allocator);
+                }
+            }
+            variants.PushBack(enabled, allocator);
+        }
+        rapidjson::Value permutations(rapidjson::kObjectType);
+        permutations.AddMember("axes", axes, allocator);
+        permutations.AddMember("variants", variants, allocator);
+        document.AddMember("permutations", permutations, allocator);
+    }
+
+    void ShaderProgramAsset::SaveAssetToBin(std::string& path) {
+        const std::array<const std::shared_ptr<AssetInfo>*, kShaderStageCount> stageInfos = {
+            &data.vertexShader, &data.fragmentShader, &data.computeShader, &data.geometryShader,
+            &data.tessellationControlShader, &data.tessellationEvaluationShader
+        };
+        ProgramStageIds stages{};
+        for (size_t stage = 0; stage < kShaderStageCount; ++stage) {
+            if (*stageInfos[stage]) {
+                std::memcpy(stages[stage].data(), &(*stageInfos[stage])->id, stages[stage].size());
+            }
+        }
+
+        // Axes are packed as [size, name] with a 32 bit size
+        std::vector<std::byte> axes;
+        for (const auto& axis : data.permutationAxes) {
+            const uint32_t size = static_cast<uint32_t>(axis.size());
+            const auto* sizeBytes = reinterpret_cast<const std::byte*>(&size);
+            axes.insert(axes.end(), sizeBytes, sizeBytes + sizeof(size));
+            axes.insert(axes.end(), reinterpret_cast<const std::byte*>(axis.data()), reinterpret_cast<const std::byte*>(axis.data()) + axis.size());
+        }
+
+        std::vector<ProgramModuleRecord> modules;
+        std::vector<std::uint32_t> spirv;
+        for (const auto& module : data.modules) {
+            const auto bytecode = module.getBytecode();
+            modules.push_back({static_cast<uint32_t>(module.stage), static_cast<uint32_t>(spirv.size()), static_cast<uint32_t>(bytecode.size())});
+            spirv.insert(spirv.end(), bytecode.begin(), bytecode.end());
+        }
+
+        BinaryContainerWriter writer(kShaderProgramKind, id);
+        writer.addValue(kProgramStagesTag, stages);
+        writer.addSection(kProgramAxesTag, std::span<const std::byte>(axes));
+        writer.addSection(kProgramVariantsTag, std::span<const ShaderProgramVariant>(data.variants));
+        writer.addSection(kProgramModulesTag, std::span<const ProgramModuleRecord>(modules));
+        writer.addSection(kProgramSpirvTag, std::span<const std::uint32_t>(spirv));
+        if (writer.write(path)) {
+            spdlog::info("Saved binary shader program asset: {}", path);
+        }
     }
 
+    bool ShaderProgramAsset::loadFromContainer(std::shared_ptr<const MappedFile> file, const std::string& path) {
+        auto bytes = file->bytes();
+        auto reader = BinaryContainerReader::open(std::move(file), bytes, kShaderProgramKind);
+        if (!reader) {
+            return false;
+        }
+
+        if (reader->getId() != id) {
+            spdlog::warn("Shader program asset UUID mismatch: expected {}, got {}", boost::uuids::to_string(id), boost::uuids::to_string(reader->getId()));
+        }
+
+        const auto stages = reader->sectionValue<ProgramStageIds>(kProgramStagesTag);
+        const auto variants = reader->sectionAs<ShaderProgramVariant>(kProgramVariantsTag);
+        const auto modules = reader->sectionAs<ProgramModuleRecord>(kProgramModulesTag);
+        const auto spirv = reader->sectionAs<std::uint32_t>(kProgramSpirvTag);
+        if (!stages || variants.size_bytes() != reader->section(kProgramVariantsTag).size() ||
+            modules.size_bytes() != reader->section(kProgramModulesTag).size() ||
+            spirv.size_bytes() != reader->section(kProgramSpirvTag).size()) {
+            spdlog::error("Binary shader program asset has missing or mismatched sections: {}", path);
+            return false;
+        }
+
+        std::vector<std::string> axes;
+        const auto axesBytes = reader->section(kProgramAxesTag);
+        size_t cursor = 0;
+        while (cursor < axesBytes.size()) {
+            uint32_t size;
+            if (axesBytes.size() - cursor < sizeof(size)) {
+                spdlog::error("Truncated permutation axes in binary shader program asset: {}", path);
+                return false;
+            }
+            std::memcpy(&size, axesBytes.data() + cursor, sizeof(size));
+            cursor += sizeof(size);
+            if (axesBytes.size() - cursor < size) {
+                spdlog::error("Truncated permutation axes in binary shader program asset: {}", path);
+                return false;
+            }
+            axes.emplace_back(reinterpret_cast<const char*>(axesBytes.data() + cursor), size);
+            cursor += size;
+        }
+
+        // Checked once here, the renderer indexes modules and SPIR-V through these without looking again
+        std::vector<ShaderData> loadedModules;
+        loadedModules.reserve(modules.size());
+        for (const auto& module : modules) {
+            if (module.stage >= kShaderStageCount || module.firstWord > spirv.size() || module.wordCount > spirv.size() - module.firstWord) {
+                spdlog::error("Shader module out of range in binary shader program asset: {}", path);
+                return false;
+            }
+            loadedModules.push_back(ShaderData{
+                .stage = static_cast<ShaderStage>(module.stage),
+                .mapping = reader->getFile(),
+                .mappedBytecode = spirv.subspan(module.firstWord, module.wordCount)
+            });
+        }
+        for (size_t i = 0; i < variants.size(); ++i) {
+            const bool sorted = i == 0 || variants[i - 1].mask < variants[i].mask;
+            const bool inRange = std::ranges::all_of(variants[i].modules, [&](uint32_t module) {
+                return module == kNoShaderModule || module < loadedModules.size();
+            });
+            if (!sorted || !inRange || (axes.size() < 32 && variants[i].mask >> axes.size() != 0)) {
+                spdlog::error("Invalid permutation variant in binary shader program asset: {}", path);
+                return false;
+            }
+        }
+
+        AssetManager& assetManager = AssetManager::getInstance();
+        const std::array<std::shared_ptr<AssetInfo>*, kShaderStageCount> stageInfos = {
+            &data.vertexShader, &data.fragmentShader, &data.computeShader, &data.geometryShader,
+            &data.tessellationControlShader, &data.tessellationEvaluationShader
+        };
+        for (size_t stage = 0; stage < kShaderStageCount; ++stage) {
+            boost::uuids::uuid stageId;
+            std::memcpy(&stageId, (*stages)[stage].data(), (*stages)[stage].size());
+            if (stageId.is_nil()) {
+                continue;
+            }
+            *stageInfos[stage] = assetManager.getAssetInfo(stageId).value_or(nullptr);
+            if (!*stageInfos[stage]) {
+                spdlog::warn("Shader asset with UUID {} not found for program {}", boost::uuids::to_string(stageId), path);
+            }
+        }
+
+        data.permutationAxes = std::move(axes);
+        data.variants.assign(variants.begin(), variants.end());
+        data.modules = std::move(loadedModules);
+        return true;
+    }
 
     void ShaderProgramAsset::importFromImportJson(const std::string& path) {
         rapidjson::Document doc;
@@ -68,12 +275,14 @@ namespace am {
         loadStage("geometry", data.geometryShader);
         loadStage("tessellationControl", data.tessellationControlShader);
         loadStage("tessellationEvaluation", data.tessellationEvaluationShader);
+
+        buildVariants(loadPermutations(doc, path));
     }
 
     void ShaderProgramAsset::loadFromProgramJson(const std::string& path) {
         rapidjson::Document doc;
-        if (!loadJsonFromFile(path, doc)) {
-            // Error logged by loadJsonFromFile
+        if (!AssetManager::getInstance().loadAssetJson(id, path, doc)) {
+            // Error logged by loadAssetJson
             return;
         }
 
@@ -108,14 +317,193 @@ namespace am {
         loadStage("geometry", data.geometryShader);
         loadStage("tessellationControl", data.tessellationControlShader);
         loadStage("tessellationEvaluation", data.tessellationEvaluationShader);
+
+        const auto masks = loadPermutations(doc, path);
+        if (!masks.empty()) {
+            spdlog::warn("Shader program {} is saved as JSON, its variants are compiled from the stage sources until it is saved again", path);
+            buildVariants(masks);
+        }
+    }
+
+    std::vector<uint32_t> ShaderProgramAsset::loadPermutations(const rapidjson::Value& document, const std::string& path) {
+        if (!document.HasMember("permutations")) {
+            return {};
+        }
+        const auto& permutations = document["permutations"];
+        if (!permutations.IsObject() || !permutations.HasMember("axes") || !permutations["axes"].IsArray()) {
+            spdlog::error("Shader program {} has permutations without an axes array", path);
+            return {};
+        }
+
+        std::vector<std::string> axes;
+        for (const auto& axis : permutations["axes"].GetArray()) {
+            if (!axis.IsString() || axis.GetStringLength() == 0) {
+                spdlog::error("Shader program {} has a permutation axis that isn't a define name", path);
+                return {};
+            }
+            if (std::ranges::find(axes, axis.GetString()) != axes.end()) {
+                spdlog::error("Shader program {} declares permutation axis {} twice", path, axis.GetString());
+                return {};
+            }
+            axes.emplace_back(axis.GetString());
+        }
+        if (axes.size() > kMaxPermutationAxes) {
+            spdlog::error("Shader program {} has {} permutation axes, at most {} are supported", path, axes.size(), kMaxPermutationAxes);
+            return {};
+        }
+        data.permutationAxes = std::move(axes);
+
+        std::vector<uint32_t> masks;
+        if (!permutations.HasMember("variants")) {
+            if (data.permutationAxes.size() > kMaxImplicitPermutationAxes) {
+                spdlog::error("Shader program {} has {} permutation axes but no variants list, list the reachable ones",
+                              path, data.permutationAxes.size());
+                return {};
+            }
+            for (uint32_t mask = 0; mask < (1u << data.permutationAxes.size()); ++mask) {
+                masks.push_back(mask);
+            }
+        } else if (permutations["variants"].IsArray()) {
+            // The variant with every axis off is always there, it matches the program's own stages
+            masks.push_back(0);
+            for (const auto& variant : permutations["variants"].GetArray()) {
+                if (!variant.IsArray()) {
+                    spdlog::error("Shader program {} has a variant that isn't an array of axis names", path);
+                    continue;
+                }
+                uint32_t mask = 0;
+                bool valid = true;
+                for (const auto& axis : variant.GetArray()) {
+                    const uint32_t bit = axis.IsString() ? data.getPermutationBit(axis.GetString()) : 0;
+                    if (bit == 0) {
+                        spdlog::error("Shader program {} has a variant using an undeclared axis", path);
+                        valid = false;
+                        break;
+                    }
+                    mask |= bit;
+                }
+                if (valid) {
+                    masks.push_back(mask);
+                }
+            }
+            std::ranges::sort(masks);
+            masks.erase(std::ranges::unique(masks).begin(), masks.end());
+        } else {
+            spdlog::error("Shader program {} has a variants entry that isn't an array", path);
+            return {};
+        }
+
+        return masks;
+    }
+
+    void ShaderProgramAsset::buildVariants(const std::vector<uint32_t>& masks) {
+        struct StageSource {
+            ShaderStage stage;
+            std::string path;
+            std::string source;
+        };
+
+        // Indexed by ShaderStage
+        const std::array<const std::shared_ptr<AssetInfo>*, kShaderStageCount> stageInfos = {
+            &data.vertexShader, &data.fragmentShader, &data.computeShader, &data.geometryShader,
+            &data.tessellationControlShader, &data.tessellationEvaluationShader
+        };
+
+        std::vector<StageSource> sources;
+        for (size_t stage = 0; stage < kShaderStageCount; ++stage) {
+            const auto& info = *stageInfos[stage];
+            if (!info) {
+                continue;
+            }
+            auto source = readShaderSource(info->importContext.importPath);
+            if (!source) {
+                return;
+            }
+            sources.push_back({static_cast<ShaderStage>(stage), info->importContext.importPath, std::move(source.value())});
+        }
+        if (sources.empty() || masks.empty()) {
+            return;
+        }
+
+        // One job per variant and stage, an axis a stage never tests comes out of the cache after its first compile
+        const ShaderCompiler& compiler = ShaderCompiler::getDefault();
+        const size_t jobCount = masks.size() * sources.size();
+        std::vector<std::optional<CompiledShader>> results(jobCount);
+        std::atomic<size_t> next = 0;
+        auto worker = [&]() {
+            std::vector<std::string> enabled;
+            for (size_t job = next.fetch_add(1); job < jobCount; job = next.fetch_add(1)) {
+                const uint32_t mask = masks[job / sources.size()];
+                const auto& source = sources[job % sources.size()];
+                enabled.clear();
+                for (size_t axis = 0; axis < data.permutationAxes.size(); ++axis) {
+                    if (mask & (1u << axis)) {
+                        enabled.push_back(data.permutationAxes[axis]);
+                    }
+                }
+                results[job] = compiler.compile(source.source, source.stage, {}, enabled);
+            }
+        };
+
+        const unsigned int threadCount = static_cast<unsigned int>(
+            std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), jobCount));
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(threadCount - 1);
+            for (unsigned int i = 1; i < threadCount; ++i) {
+                workers.emplace_back(worker);
+            }
+            worker();
+        }
+
+        // Variants that differ only in axes a stage ignores compile to the same SPIR-V, keep one module for them
+        std::unordered_map<uint64_t, uint32_t> moduleByHash;
+        data.variants.clear();
+        data.modules.clear();
+        size_t cached = 0;
+        for (size_t variantIndex = 0; variantIndex < masks.size(); ++variantIndex) {
+            const size_t firstJob = variantIndex * sources.size();
+            const bool compiled = std::all_of(results.begin() + firstJob, results.begin() + firstJob + sources.size(),
+                                              [](const auto& result) { return result && !result->getBytecode().empty(); });
+            if (!compiled) {
+                spdlog::error("Failed to compile variant {:#x} of shader program {}", masks[variantIndex], boost::uuids::to_string(id));
+                continue;
+            }
+
+            ShaderProgramVariant variant{.mask = masks[variantIndex]};
+            variant.modules.fill(kNoShaderModule);
+            for (size_t i = 0; i < sources.size(); ++i) {
+                auto& result = results[firstJob + i].value();
+                cached += result.fromCache ? 1 : 0;
+
+                ContentHasher hasher;
+                hasher.add(static_cast<uint32_t>(sources[i].stage));
+                hasher.addSpan(result.getBytecode());
+                auto [it, inserted] = moduleByHash.try_emplace(hasher.result(), static_cast<uint32_t>(data.modules.size()));
+                if (inserted) {
+                    data.modules.push_back(ShaderData{
+                        .bytecode = std::move(result.bytecode),
+                        .stage = sources[i].stage,
+                        .defines = {},
+                        .originalSource = sources[i].path,
+                        .mapping = std::move(result.mapping),
+                        .mappedBytecode = result.mappedBytecode
+                    });
+                }
+                variant.modules[static_cast<size_t>(sources[i].stage)] = it->second;
+            }
+            data.variants.push_back(variant);
+        }
+
+        spdlog::info("Built {} variants of shader program {} from {} modules ({} of {} compiles cached) on {} threads",
+                     data.variants.size(), boost::uuids::to_string(id), data.modules.size(), cached, jobCount, threadCount);
     }
 
     size_t ShaderProgramAsset::calculateContentHash() const {
-        size_t hash = 0;
+        // 0 stands in for a missing stage, so a shader can't move between stages without changing the hash
+        ContentHasher hasher;
         auto combineHash = [&](const std::shared_ptr<AssetInfo>& asset) {
-            if (asset) {
-                hash ^= asset->contentHash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            }
+            hasher.add(asset ? static_cast<uint64_t>(asset->contentHash) : 0);
         };
 
         combineHash(data.vertexShader);
@@ -125,11 +513,49 @@ namespace am {
         combineHash(data.tessellationControlShader);
         combineHash(data.tessellationEvaluationShader);
 
-        return hash;
+        hasher.add(static_cast<uint64_t>(data.permutationAxes.size()));
+        for (const auto& axis : data.permutationAxes) {
+            hasher.addString(axis);
+        }
+        hasher.add(static_cast<uint64_t>(data.variants.size()));
+        for (const auto& variant : data.variants) {
+            hasher.add(variant.mask);
+        }
+
+        return hasher.result();
     }
 
     AssetType ShaderProgramAsset::getType() const {
         return AssetType::ShaderProgram;
     }
 
+    ImportInputs ShaderProgramAsset::getImportInputs(const ImportContext& importContext) {
+        // Variants are compiled from the stage sources, so they and everything they include are part of the program
+        ImportInputs inputs;
+        inputs.settingsHash = ShaderCompiler::getDefault().getSettingsHash();
+        rapidjson::Document doc;
+        if (!loadJsonFromFile(importContext.importPath, doc) || !doc.IsObject()) {
+            return inputs;
+        }
+        const std::filesystem::path basePath = std::filesystem::path(importContext.importPath).parent_path();
+        for (const char* key : kStageKeys) {
+            if (doc.HasMember(key) && doc[key].IsString()) {
+                const std::string stagePath = (basePath / doc[key].GetString()).lexically_normal().string();
+                inputs.sourceFiles.push_back(stagePath);
+                std::ranges::move(ShaderAsset::collectIncludes(stagePath), std::back_inserter(inputs.sourceFiles));
+            }
+        }
+        return inputs;
+    }
+
+    std::vector<boost::uuids::uuid> ShaderProgramAsset::getDependencies() const {
+        std::vector<boost::uuids::uuid> dependencies;
+        for (const auto& stage : {data.vertexShader, data.fragmentShader, data.computeShader, data.geometryShader,
+                                  data.tessellationControlShader, data.tessellationEvaluationShader}) {
+            if (stage)
+                dependencies.push_back(stage->id);
+        }
+        return dependencies;
+    }
+
 } // namespace am
@@ -12,9 +12,13 @@ namespace am {
         explicit ShaderProgramAsset(const boost::uuids::uuid& id, const std::string& path, AssetFormat format);
 
         void SaveAssetToJson(rapidjson::Document& document) override;
+        void SaveAssetToBin(std::string& path) override;
 
         size_t calculateContentHash() const override;
         [[nodiscard]] AssetType getType() const override;
+        [[nodiscard]] std::vector<boost::uuids::uuid> getDependencies() const override;
+        // The stage sources and their includes, with the shader compiler's settings
+        [[nodiscard]] static ImportInputs getImportInputs(const ImportContext& importContext);
 
         void SaveAssetMetadata(rapidjson::Document& document) override {}
         void LoadAssetMetadata(rapidjson::Document& document) override {}
@@ -27,6 +31,13 @@ namespace am {
         ShaderProgramData data;
         void importFromImportJson(const std::string& path);
         void loadFromProgramJson(const std::string& path);
+        // Variants come compiled with the program, nothing is read from the GLSL sources
+        bool loadFromContainer(std::shared_ptr<const MappedFile> file, const std::string& path);
+
+        // Reads the optional "permutations" block, shared by the import and the saved program JSON. Returns the reachable masks
+        std::vector<uint32_t> loadPermutations(const rapidjson::Value& document, const std::string& path);
+        // Compiles every stage for each reachable mask, in parallel. Variants with a stage that fails are left out
+        void buildVariants(const std::vector<uint32_t>& masks);
     };
 }
 
@@ -1,10 +1,38 @@
 #include "TextureAsset.h"
+#include <cstring>
 #include "../../AssetManager.hpp"
 #include "../../JsonHelpers.hpp"
+#include "BinaryContainer.hpp"
+#include "ContentHash.hpp"
+#include "TextureMipGenerator.hpp"
 #include "stb_image.h"
 
 namespace am
 {
+    namespace
+    {
+        constexpr uint32_t kTextureKind = makeFourCC('T', 'E', 'X', 'R');
+        constexpr uint32_t kTextureInfoTag = makeFourCC('I', 'N', 'F', 'O');
+        constexpr uint32_t kTextureMipTag = makeFourCC('M', 'I', 'P', 'S');
+        constexpr uint32_t kTexturePixelTag = makeFourCC('T', 'E', 'X', 'L');
+
+        // How sources are decoded, part of the import key
+        constexpr int kImportChannels = STBI_rgb_alpha;
+        constexpr bool kImportFlipVertically = true;
+
+        // Fixed width fields only, bool and enum sizes are up to the compiler
+        struct TextureBinaryInfo {
+            uint32_t width;
+            uint32_t height;
+            uint32_t channels;
+            uint32_t hasAlpha;
+            uint32_t type;
+            uint32_t mipFilter;
+            uint32_t srgb;
+            float alphaCutoff;
+        };
+    }
+
     TextureAsset::TextureAsset(const boost::uuids::uuid& id) : Asset(id)
     {
     }
@@ -19,7 +47,7 @@ namespace am
     {
         if (format == AssetFormat::Json) {
             rapidjson::Document document;
-            if (!loadJsonFromFile(path, document)) {
+            if (!AssetManager::getInstance().loadAssetJson(id, path, document)) {
                 spdlog::error("Failed to load TextureAsset from JSON: {}", path);
                 return;
             }
@@ -38,6 +66,13 @@ namespace am
                 else if (typeStr == "TextureCube") data.type = TextureType::TextureCube;
             }
         } else if (format == AssetFormat::Binary) {
+            auto mapped = AssetManager::getInstance().openAssetFile(id, path);
+            if (mapped && BinaryContainerReader::isContainer(mapped->bytes())) {
+                loadFromContainer(std::move(mapped), path);
+                return;
+            }
+
+            // Files written before the container format
             std::ifstream ifs(path, std::ios::binary | std::ios::in);
             if (!ifs.is_open()) {
                 spdlog::error("Failed to open file for reading binary asset: {}", path);
@@ -47,7 +82,9 @@ namespace am
             // Read magic number
             char magic[6];
             ifs.read(magic, sizeof(magic));
-            if (std::string(magic) != "RTEX_") {
+            const std::string magicStr(magic, strnlen(magic, sizeof(magic)));
+            const bool legacy = magicStr == "RTEX_";
+            if (!legacy && magicStr != "RTEX2") {
                 spdlog::error("Invalid magic number in binary texture asset: {}", path);
                 return;
             }
@@ -66,6 +103,22 @@ namespace am
             ifs.read(reinterpret_cast<char*>(&data.hasAlpha), sizeof(data.hasAlpha));
             ifs.read(reinterpret_cast<char*>(&data.type), sizeof(data.type));
 
+            if (!legacy) {
+                // Read mip settings and chain layout
+                ifs.read(reinterpret_cast<char*>(&data.mipFilter), sizeof(data.mipFilter));
+                ifs.read(reinterpret_cast<char*>(&data.srgb), sizeof(data.srgb));
+                ifs.read(reinterpret_cast<char*>(&data.alphaCutoff), sizeof(data.alphaCutoff));
+
+                uint32_t mipCount;
+                ifs.read(reinterpret_cast<char*>(&mipCount), sizeof(mipCount));
+                data.mips.resize(mipCount);
+                for (auto& mip : data.mips) {
+                    ifs.read(reinterpret_cast<char*>(&mip.width), sizeof(mip.width));
+                    ifs.read(reinterpret_cast<char*>(&mip.height), sizeof(mip.height));
+                    ifs.read(reinterpret_cast<char*>(&mip.offset), sizeof(mip.offset));
+                }
+            }
+
             // Read pixels
             size_t pixelCount;
             ifs.read(reinterpret_cast<char*>(&pixelCount), sizeof(pixelCount));
@@ -74,6 +127,18 @@ namespace am
                 ifs.read(reinterpret_cast<char*>(data.pixels.data()), pixelCount * sizeof(std::uint32_t));
             }
 
+            if (!ifs) {
+                spdlog::error("Truncated binary texture asset: {}", path);
+                data.pixels.clear();
+                data.mips.clear();
+                return;
+            }
+
+            if (legacy) {
+                // Old files carry level 0 only, build the chain once on load
+                TextureMipGenerator::generate(data);
+            }
+
             ifs.close();
         }
     }
@@ -97,45 +162,90 @@ namespace am
 
     void TextureAsset::SaveAssetToBin(std::string& path)
     {
-        std::ofstream ofs(path, std::ios::binary | std::ios::out);
-        if (!ofs.is_open()) {
-            spdlog::error("Failed to open file for writing binary asset: {}", path);
-            return;
-        }
+        TextureBinaryInfo info{};
+        info.width = data.width;
+        info.height = data.height;
+        info.channels = data.channels;
+        info.hasAlpha = data.hasAlpha ? 1 : 0;
+        info.type = static_cast<uint32_t>(data.type);
+        info.mipFilter = static_cast<uint32_t>(data.mipFilter);
+        info.srgb = data.srgb ? 1 : 0;
+        info.alphaCutoff = data.alphaCutoff;
+
+        BinaryContainerWriter writer(kTextureKind, id);
+        writer.addValue(kTextureInfoTag, info);
+        writer.addSection(kTextureMipTag, std::span<const TextureMipLevel>(data.mips));
+        writer.addSection(kTexturePixelTag, data.getPixels());
+        writer.write(path);
+    }
 
-        // Write magic number
-        ofs.write("RTEX_", 6);
+    bool TextureAsset::loadFromContainer(std::shared_ptr<const MappedFile> file, const std::string& path)
+    {
+        auto bytes = file->bytes();
+        auto reader = BinaryContainerReader::open(std::move(file), bytes, kTextureKind);
+        if (!reader) {
+            return false;
+        }
 
-        // Write UUID
-        ofs.write(reinterpret_cast<const char*>(&id), 16);
+        if (reader->getId() != id) {
+            spdlog::warn("Texture asset UUID mismatch in {}: expected {}, got {}", path.c_str(), boost::uuids::to_string(id).c_str(), boost::uuids::to_string(reader->getId()).c_str());
+        }
 
-        // Write metadata
-        ofs.write(reinterpret_cast<const char*>(&data.width), sizeof(data.width));
-        ofs.write(reinterpret_cast<const char*>(&data.height), sizeof(data.height));
-        ofs.write(reinterpret_cast<const char*>(&data.channels), sizeof(data.channels));
-        ofs.write(reinterpret_cast<const char*>(&data.hasAlpha), sizeof(data.hasAlpha));
-        ofs.write(reinterpret_cast<const char*>(&data.type), sizeof(data.type));
+        auto info = reader->sectionValue<TextureBinaryInfo>(kTextureInfoTag);
+        auto mips = reader->sectionAs<TextureMipLevel>(kTextureMipTag);
+        auto pixels = reader->sectionAs<std::uint32_t>(kTexturePixelTag);
+        if (!info || mips.size_bytes() != reader->section(kTextureMipTag).size() ||
+            pixels.size_bytes() != reader->section(kTexturePixelTag).size()) {
+            spdlog::error("Binary texture asset has missing or mismatched sections: {}", path);
+            return false;
+        }
 
-        // Write pixels
-        size_t pixelCount = data.pixels.size();
-        ofs.write(reinterpret_cast<const char*>(&pixelCount), sizeof(pixelCount));
-        if (pixelCount > 0) {
-            ofs.write(reinterpret_cast<const char*>(data.pixels.data()), pixelCount * sizeof(std::uint32_t));
+        // Every level has to lie inside the texel section, streaming reads them without further checks
+        for (const auto& mip : mips) {
+            const uint64_t texels = static_cast<uint64_t>(mip.width) * mip.height;
+            if (mip.offset > pixels.size() || texels > pixels.size() - mip.offset) {
+                spdlog::error("Mip level out of bounds in binary texture asset: {}", path);
+                return false;
+            }
         }
 
-        ofs.close();
+        data.width = info->width;
+        data.height = info->height;
+        data.channels = info->channels;
+        data.hasAlpha = info->hasAlpha != 0;
+        data.type = static_cast<TextureType>(info->type);
+        data.mipFilter = static_cast<MipFilter>(info->mipFilter);
+        data.srgb = info->srgb != 0;
+        data.alphaCutoff = info->alphaCutoff;
+
+        // The mip table is tiny, only the texels are used in place
+        data.mips.assign(mips.begin(), mips.end());
+        data.pixels.clear();
+        data.mappedPixels = pixels;
+        data.mapping = reader->getFile();
+        return true;
     }
 
 
     TextureAsset::~TextureAsset() = default;
 
+    ImportInputs TextureAsset::getImportInputs(const ImportContext& /*importContext*/)
+    {
+        // Mips of a fresh import are always built with the default filter, a filter set later is metadata
+        ContentHasher settings;
+        settings.add(static_cast<int32_t>(kImportChannels));
+        settings.add(static_cast<uint32_t>(kImportFlipVertically));
+        settings.add(static_cast<uint32_t>(TextureData{}.mipFilter));
+        return {{}, settings.result()};
+    }
+
     void TextureAsset::loadFromFile(const std::string& path)
     {
         // Force stb_image to return 4 channels for consistency
         int width, height, channels;
-        stbi_set_flip_vertically_on_load(true); // Flip images vertically
+        stbi_set_flip_vertically_on_load_thread(kImportFlipVertically); // Per thread so parallel imports don't race on it
 
-        uint8_t* fileData = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        uint8_t* fileData = stbi_load(path.c_str(), &width, &height, &channels, kImportChannels);
 
         if (!fileData)
         {
@@ -147,45 +257,39 @@ namespace am
         data.width = width;
         data.height = height;
         data.channels = 4; // We forced RGBA
-        data.hasAlpha = true;
 
-        // Calculate total size and copy data
-        size_t dataSize = width * height * 4; // 4 for RGBA
-        data.pixels.resize(dataSize);
-        std::memcpy(data.pixels.data(), fileData, dataSize);
+        // One packed RGBA8 texel per element
+        size_t texelCount = static_cast<size_t>(width) * height;
+        data.pixels.resize(texelCount);
+        std::memcpy(data.pixels.data(), fileData, texelCount * 4);
+
+        // Only treat the texture as alpha tested if it actually has non opaque texels
+        data.hasAlpha = false;
+        for (size_t i = 0; i < texelCount; ++i) {
+            if (fileData[i * 4 + 3] != 255) {
+                data.hasAlpha = true;
+                break;
+            }
+        }
 
         // Free the stb_image data
         stbi_image_free(fileData);
 
         data.type = TextureType::Texture2D;
 
+        TextureMipGenerator::generate(data);
+
         spdlog::info("Loaded texture");
     }
 
     size_t TextureAsset::calculateContentHash() const
     {
-        size_t hash = 0;
-
-        // Hash basic properties
-        hash ^= std::hash<int>{}(data.width);
-        hash ^= std::hash<int>{}(data.height) << 1;
-        hash ^= std::hash<int>{}(data.channels) << 2;
-
-        // Hash pixel data in chunks to improve performance
-        const size_t chunkSize = 1024; // Process 1KB at a time
-        const uint32_t* pixels = data.pixels.data();
-        const size_t totalSize = data.pixels.size();
-
-        for (size_t i = 0; i < totalSize; i += chunkSize)
-        {
-            size_t remaining = std::min(chunkSize, totalSize - i);
-            for (size_t j = 0; j < remaining; ++j)
-            {
-                hash ^= std::hash<uint8_t>{}(pixels[i + j]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-            }
-        }
-
-        return hash;
+        ContentHasher hasher;
+        hasher.add(data.width);
+        hasher.add(data.height);
+        hasher.add(data.channels);
+        hasher.addSpan(data.getPixels());
+        return hasher.result();
     }
 
     AssetType TextureAsset::getType() const
@@ -193,6 +297,11 @@ namespace am
         return AssetType::Texture;
     }
 
+    size_t TextureAsset::getMemoryUsage() const
+    {
+        return data.getPixels().size_bytes();
+    }
+
     void TextureAsset::SaveAssetMetadata(rapidjson::Document& document)
     {
         auto& allocator = document.GetAllocator();
@@ -208,6 +317,14 @@ namespace am
             rapidjson::Value(typeStr.c_str(), allocator),
             allocator
         );
+
+        document.AddMember(
+            rapidjson::Value("mipFilter", allocator),
+            rapidjson::Value(data.mipFilter == MipFilter::Box ? "Box" : "Kaiser", allocator),
+            allocator
+        );
+        document.AddMember("srgb", data.srgb, allocator);
+        document.AddMember("alphaCutoff", data.alphaCutoff, allocator);
     }
 
     void TextureAsset::LoadAssetMetadata(rapidjson::Document& document)
@@ -220,5 +337,16 @@ namespace am
                 data.type = TextureType::TextureCube;
             }
         }
+
+        if (document.HasMember("mipFilter") && document["mipFilter"].IsString()) {
+            std::string filterStr = document["mipFilter"].GetString();
+            data.mipFilter = filterStr == "Box" ? MipFilter::Box : MipFilter::Kaiser;
+        }
+        if (document.HasMember("srgb") && document["srgb"].IsBool()) {
+            data.srgb = document["srgb"].GetBool();
+        }
+        if (document.HasMember("alphaCutoff") && document["alphaCutoff"].IsNumber()) {
+            data.alphaCutoff = document["alphaCutoff"].GetFloat();
+        }
     }
 }
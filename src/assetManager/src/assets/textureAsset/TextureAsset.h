@@ -26,9 +26,11 @@ namespace am {
         void SaveAssetToBin(std::string& path) override;
 
         void loadFromFile(const std::string &path);
+        static ImportInputs getImportInputs(const ImportContext& importContext);
 
         [[nodiscard]] size_t calculateContentHash() const override;
         [[nodiscard]] AssetType getType() const override;
+        [[nodiscard]] size_t getMemoryUsage() const override;
 
         [[nodiscard]] int getWidth() const { return data.width ; }
         [[nodiscard]] int getHeight() const { return data.height ; }
@@ -36,11 +38,11 @@ namespace am {
         [[nodiscard]] bool hasAlpha() const { return data.hasAlpha; }
 
         [[nodiscard]] const unsigned* getData() const {
-            return data.pixels.data();
+            return data.getPixels().data();
         }
 
         [[nodiscard]] size_t getDataSize() const {
-            return data.pixels.size() ;
+            return data.getPixels().size() ;
         }
 
         void SaveAssetMetadata(rapidjson::Document& document) override;
@@ -51,6 +53,8 @@ namespace am {
         }
   private:
         TextureData data;
+
+        bool loadFromContainer(std::shared_ptr<const MappedFile> file, const std::string& path);
     };
 }
 
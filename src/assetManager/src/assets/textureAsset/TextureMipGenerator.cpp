@@ -0,0 +1,318 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "TextureMipGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+#include "spdlog/spdlog.h"
+
+namespace am
+{
+    namespace
+    {
+        // Kaiser window parameters, same defaults nvtt uses for mip generation
+        constexpr float kKaiserWidth = 3.0f;
+        constexpr float kKaiserAlpha = 4.0f;
+
+        struct FilterTap {
+            uint32_t index;
+            float weight;
+        };
+
+        float besselI0(float x)
+        {
+            float sum = 1.0f;
+            float term = 1.0f;
+            const float halfX = x * 0.5f;
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= (halfX / static_cast<float>(k)) * (halfX / static_cast<float>(k));
+                sum += term;
+                if (term < sum * 1e-7f)
+                    break;
+            }
+            return sum;
+        }
+
+        float sinc(float x)
+        {
+            if (std::abs(x) < 1e-5f)
+                return 1.0f;
+            const float px = std::numbers::pi_v<float> * x;
+            return std::sin(px) / px;
+        }
+
+        float kaiser(float x)
+        {
+            const float t = x / (kKaiserWidth * 0.5f);
+            if (std::abs(t) > 1.0f)
+                return 0.0f;
+            return sinc(x) * besselI0(kKaiserAlpha * std::sqrt(1.0f - t * t)) / besselI0(kKaiserAlpha);
+        }
+
+        // Per destination texel list of source taps along one axis
+        std::vector<std::vector<FilterTap>> buildKernel(uint32_t srcSize, uint32_t dstSize, MipFilter filter)
+        {
+            std::vector<std::vector<FilterTap>> kernel(dstSize);
+            const float scale = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+
+            for (uint32_t i = 0; i < dstSize; ++i)
+            {
+                auto& taps = kernel[i];
+                if (srcSize == dstSize)
+                {
+                    taps.push_back({i, 1.0f});
+                    continue;
+                }
+
+                const float begin = static_cast<float>(i) * scale;
+                const float end = begin + scale;
+
+                if (filter == MipFilter::Box)
+                {
+                    // Exact area coverage so odd sizes don't drop a row
+                    for (auto j = static_cast<uint32_t>(begin); j < srcSize && static_cast<float>(j) < end; ++j)
+                    {
+                        const float overlap = std::min(end, static_cast<float>(j + 1)) - std::max(begin, static_cast<float>(j));
+                        if (overlap > 0.0f)
+                            taps.push_back({j, overlap});
+                    }
+                }
+                else
+                {
+                    const float center = (begin + end) * 0.5f;
+                    const float radius = kKaiserWidth * 0.5f * scale;
+                    const int first = static_cast<int>(std::floor(center - radius));
+                    const int last = static_cast<int>(std::ceil(center + radius));
+                    for (int j = first; j <= last; ++j)
+                    {
+                        const float weight = kaiser((static_cast<float>(j) + 0.5f - center) / scale);
+                        if (weight == 0.0f)
+                            continue;
+                        const auto clamped = static_cast<uint32_t>(std::clamp(j, 0, static_cast<int>(srcSize) - 1));
+                        taps.push_back({clamped, weight});
+                    }
+                }
+
+                float sum = 0.0f;
+                for (const auto& tap : taps)
+                    sum += tap.weight;
+                if (sum <= 0.0f)
+                {
+                    taps.assign(1, {std::min(static_cast<uint32_t>(begin), srcSize - 1), 1.0f});
+                    continue;
+                }
+                for (auto& tap : taps)
+                    tap.weight /= sum;
+            }
+            return kernel;
+        }
+
+        const std::array<float, 256>& srgbToLinearTable()
+        {
+            static const std::array<float, 256> table = [] {
+                std::array<float, 256> result{};
+                for (int i = 0; i < 256; ++i)
+                {
+                    const float c = static_cast<float>(i) / 255.0f;
+                    result[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        float linearToSrgb(float c)
+        {
+            return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+        }
+
+        uint8_t quantize(float c)
+        {
+            return static_cast<uint8_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+
+    uint32_t TextureMipGenerator::mipCount(uint32_t width, uint32_t height)
+    {
+        const uint32_t largest = std::max(width, height);
+        return largest == 0 ? 0 : static_cast<uint32_t>(std::bit_width(largest));
+    }
+
+    void TextureMipGenerator::generate(TextureData& data)
+    {
+        const size_t baseCount = static_cast<size_t>(data.width) * data.height;
+        if (baseCount == 0)
+        {
+            data.mips.clear();
+            return;
+        }
+
+        if (data.pixels.size() < baseCount)
+        {
+            spdlog::error("Texture has {} texels, expected at least {}", data.pixels.size(), baseCount);
+            throw std::runtime_error("Texture pixel data is smaller than its dimensions");
+        }
+
+        // Faces of a cube atlas would bleed into each other, keep level 0 only
+        const uint32_t levels = data.type == TextureType::TextureCube ? 1 : mipCount(data.width, data.height);
+
+        data.mips.clear();
+        data.mips.reserve(levels);
+
+        size_t totalTexels = 0;
+        uint32_t levelWidth = data.width;
+        uint32_t levelHeight = data.height;
+        for (uint32_t level = 0; level < levels; ++level)
+        {
+            data.mips.push_back({levelWidth, levelHeight, totalTexels});
+            totalTexels += static_cast<size_t>(levelWidth) * levelHeight;
+            levelWidth = std::max(1u, levelWidth / 2);
+            levelHeight = std::max(1u, levelHeight / 2);
+        }
+
+        data.pixels.resize(totalTexels);
+        if (levels == 1)
+            return;
+
+        std::vector<float> current = decode(data.pixels.data(), baseCount, data.srgb);
+
+        const bool preserveCoverage = data.hasAlpha && data.alphaCutoff > 0.0f;
+        const float targetCoverage = preserveCoverage ? alphaCoverage(current, data.alphaCutoff) : 0.0f;
+
+        for (uint32_t level = 1; level < levels; ++level)
+        {
+            const auto& src = data.mips[level - 1];
+            const auto& dst = data.mips[level];
+
+            std::vector<float> next = downsample(current, src.width, src.height, dst.width, dst.height, data.mipFilter);
+            if (preserveCoverage)
+                preserveAlphaCoverage(next, data.alphaCutoff, targetCoverage);
+
+            encode(next, data.srgb, data.pixels.data() + dst.offset);
+            current = std::move(next);
+        }
+    }
+
+    float TextureMipGenerator::alphaCoverage(const std::vector<float>& rgba, float cutoff, float alphaScale)
+    {
+        const size_t count = rgba.size() / 4;
+        if (count == 0)
+            return 0.0f;
+
+        size_t covered = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (std::min(1.0f, rgba[i * 4 + 3] * alphaScale) > cutoff)
+                ++covered;
+        }
+        return static_cast<float>(covered) / static_cast<float>(count);
+    }
+
+    std::vector<float> TextureMipGenerator::decode(const std::uint32_t* texels, size_t count, bool srgb)
+    {
+        const auto& table = srgbToLinearTable();
+        const auto* bytes = reinterpret_cast<const uint8_t*>(texels);
+
+        std::vector<float> rgba(count * 4);
+        for (size_t i = 0; i < count * 4; ++i)
+        {
+            const bool isAlpha = (i & 3) == 3;
+            rgba[i] = srgb && !isAlpha ? table[bytes[i]] : static_cast<float>(bytes[i]) / 255.0f;
+        }
+        return rgba;
+    }
+
+    void TextureMipGenerator::encode(const std::vector<float>& rgba, bool srgb, std::uint32_t* out)
+    {
+        auto* bytes = reinterpret_cast<uint8_t*>(out);
+        for (size_t i = 0; i < rgba.size(); ++i)
+        {
+            const bool isAlpha = (i & 3) == 3;
+            bytes[i] = quantize(srgb && !isAlpha ? linearToSrgb(std::max(rgba[i], 0.0f)) : rgba[i]);
+        }
+    }
+
+    std::vector<float> TextureMipGenerator::downsample(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight,
+                                                       uint32_t dstWidth, uint32_t dstHeight, MipFilter filter)
+    {
+        const auto horizontal = buildKernel(srcWidth, dstWidth, filter);
+        const auto vertical = buildKernel(srcHeight, dstHeight, filter);
+
+        // Horizontal pass: srcHeight rows of dstWidth texels
+        std::vector<float> rows(static_cast<size_t>(dstWidth) * srcHeight * 4, 0.0f);
+        for (uint32_t y = 0; y < srcHeight; ++y)
+        {
+            const float* srcRow = src.data() + static_cast<size_t>(y) * srcWidth * 4;
+            float* dstRow = rows.data() + static_cast<size_t>(y) * dstWidth * 4;
+            for (uint32_t x = 0; x < dstWidth; ++x)
+            {
+                for (const auto& tap : horizontal[x])
+                {
+                    for (int c = 0; c < 4; ++c)
+                        dstRow[x * 4 + c] += srcRow[tap.index * 4 + c] * tap.weight;
+                }
+            }
+        }
+
+        // Vertical pass
+        std::vector<float> result(static_cast<size_t>(dstWidth) * dstHeight * 4, 0.0f);
+        for (uint32_t y = 0; y < dstHeight; ++y)
+        {
+            float* dstRow = result.data() + static_cast<size_t>(y) * dstWidth * 4;
+            for (const auto& tap : vertical[y])
+            {
+                const float* srcRow = rows.data() + static_cast<size_t>(tap.index) * dstWidth * 4;
+                for (size_t i = 0; i < static_cast<size_t>(dstWidth) * 4; ++i)
+                    dstRow[i] += srcRow[i] * tap.weight;
+            }
+        }
+
+        // Kaiser has negative lobes, keep the chain in range so ringing doesn't accumulate
+        for (auto& value : result)
+            value = std::clamp(value, 0.0f, 1.0f);
+
+        return result;
+    }
+
+    void TextureMipGenerator::preserveAlphaCoverage(std::vector<float>& rgba, float cutoff, float targetCoverage)
+    {
+        // Binary search the alpha scale whose coverage matches level 0
+        float low = 0.0f;
+        float high = 4.0f;
+        float bestScale = 1.0f;
+        float bestError = std::abs(alphaCoverage(rgba, cutoff) - targetCoverage);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            const float scale = (low + high) * 0.5f;
+            const float coverage = alphaCoverage(rgba, cutoff, scale);
+            const float error = std::abs(coverage - targetCoverage);
+            if (error < bestError)
+            {
+                bestError = error;
+                bestScale = scale;
+            }
+
+            if (coverage < targetCoverage)
+                low = scale;
+            else if (coverage > targetCoverage)
+                high = scale;
+            else
+                break;
+        }
+
+        if (bestScale == 1.0f)
+            return;
+
+        for (size_t i = 3; i < rgba.size(); i += 4)
+            rgba[i] = std::min(1.0f, rgba[i] * bestScale);
+    }
+}
@@ -0,0 +1,38 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef TEXTUREMIPGENERATOR_HPP
+#define TEXTUREMIPGENERATOR_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "assetDatas/TextureData.h"
+
+namespace am
+{
+    class TextureMipGenerator
+    {
+    public:
+        // Builds the full mip chain from level 0 of data.pixels using the settings stored in data.
+        // Any previously generated levels are discarded.
+        static void generate(TextureData& data);
+
+        // Fraction of texels whose alpha is above the cutoff, alpha in [0,1]
+        static float alphaCoverage(const std::vector<float>& rgba, float cutoff, float alphaScale = 1.0f);
+
+        static uint32_t mipCount(uint32_t width, uint32_t height);
+
+    private:
+        static std::vector<float> decode(const std::uint32_t* texels, size_t count, bool srgb);
+        static void encode(const std::vector<float>& rgba, bool srgb, std::uint32_t* out);
+
+        static std::vector<float> downsample(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight,
+                                             uint32_t dstWidth, uint32_t dstHeight, MipFilter filter);
+
+        static void preserveAlphaCoverage(std::vector<float>& rgba, float cutoff, float targetCoverage);
+    };
+}
+
+#endif //TEXTUREMIPGENERATOR_HPP
@@ -0,0 +1,128 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <filesystem>
+#include <fstream>
+
+#include "../src/AssetArchive.hpp"
+
+namespace
+{
+    constexpr uint32_t kTestKind = am::makeFourCC('T', 'E', 'S', 'T');
+    constexpr uint32_t kWordsTag = am::makeFourCC('W', 'R', 'D', 'S');
+
+    struct ArchiveFixture {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "asset_archive_test";
+        std::vector<am::AssetArchive::BuildEntry> entries;
+
+        ArchiveFixture() { std::filesystem::create_directories(directory); }
+        ~ArchiveFixture() { std::filesystem::remove_all(directory); }
+
+        void addFile(const std::string& name, const std::string& contents, am::AssetType type)
+        {
+            const auto path = (directory / name).string();
+            std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+            entries.push_back({boost::uuids::random_generator()(), type, path});
+        }
+
+        std::string archivePath() const { return (directory / "assets.pak").string(); }
+    };
+
+    std::string readEntry(const am::AssetArchive& archive, const boost::uuids::uuid& id)
+    {
+        auto file = archive.openEntry(id);
+        BOOST_REQUIRE(file);
+        auto bytes = file->bytes();
+        return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(AssetArchiveTests, ArchiveFixture)
+
+BOOST_AUTO_TEST_CASE(RawEntriesAreSlicesOfTheMapping) {
+    addFile("a.material", R"({"uuid":"a","albedo":[1,1,1]})", am::AssetType::Material);
+    addFile("b.scene", R"({"entities":[]})", am::AssetType::Scene);
+
+    am::AssetArchive::BuildSettings settings;
+    settings.alignment = 4096;
+    BOOST_REQUIRE(am::AssetArchive::build(archivePath(), entries, settings));
+
+    auto archive = am::AssetArchive::open(archivePath());
+    BOOST_REQUIRE(archive);
+    BOOST_TEST(archive->getEntryCount() == 2u);
+
+    for (const auto& entry : entries) {
+        const auto* toc = archive->find(entry.id);
+        BOOST_REQUIRE(toc);
+        BOOST_TEST(toc->offset % 4096 == 0u);
+        BOOST_TEST(toc->compression == static_cast<uint32_t>(am::ArchiveCompression::None));
+        BOOST_TEST(toc->assetType == static_cast<uint32_t>(entry.type));
+    }
+    BOOST_TEST(readEntry(*archive, entries[0].id) == R"({"uuid":"a","albedo":[1,1,1]})");
+    BOOST_TEST(!archive->contains(boost::uuids::random_generator()()));
+}
+
+BOOST_AUTO_TEST_CASE(CompressedEntriesRoundTrip) {
+    const std::string repetitive(64 * 1024, 'x');
+    addFile("big.model", repetitive, am::AssetType::Model);
+    addFile("tiny.material", "{}", am::AssetType::Material);
+
+    // Binary containers stay raw unless asked otherwise, so they can be used in place
+    std::vector<uint32_t> words(16 * 1024, 7u);
+    am::BinaryContainerWriter writer(kTestKind, boost::uuids::random_generator()());
+    writer.addSection(kWordsTag, std::span<const uint32_t>(words));
+    const auto binaryPath = (directory / "words.b_mesh").string();
+    BOOST_REQUIRE(writer.write(binaryPath));
+    entries.push_back({boost::uuids::random_generator()(), am::AssetType::Mesh, binaryPath});
+
+    am::AssetArchive::BuildSettings settings;
+    settings.compression = am::ArchiveCompression::LZ4;
+    BOOST_REQUIRE(am::AssetArchive::build(archivePath(), entries, settings));
+
+    auto archive = am::AssetArchive::open(archivePath());
+    BOOST_REQUIRE(archive);
+
+    const auto* big = archive->find(entries[0].id);
+    BOOST_REQUIRE(big);
+    BOOST_TEST(big->compression == static_cast<uint32_t>(am::ArchiveCompression::LZ4));
+    BOOST_TEST(big->storedSize < big->size);
+    BOOST_TEST(readEntry(*archive, entries[0].id) == repetitive);
+
+    // Too small to gain anything
+    BOOST_TEST(archive->find(entries[1].id)->compression == static_cast<uint32_t>(am::ArchiveCompression::None));
+
+    const auto* binary = archive->find(entries[2].id);
+    BOOST_REQUIRE(binary);
+    BOOST_TEST(binary->compression == static_cast<uint32_t>(am::ArchiveCompression::None));
+
+    auto file = archive->openEntry(entries[2].id);
+    BOOST_REQUIRE(file);
+    auto reader = am::BinaryContainerReader::open(file, file->bytes(), kTestKind);
+    BOOST_REQUIRE(reader.has_value());
+    BOOST_TEST(reader->sectionAs<uint32_t>(kWordsTag).size() == words.size());
+}
+
+BOOST_AUTO_TEST_CASE(LookupScalesToManyEntries) {
+    for (int i = 0; i < 2000; ++i)
+        addFile("asset" + std::to_string(i) + ".material", std::to_string(i), am::AssetType::Material);
+
+    BOOST_REQUIRE(am::AssetArchive::build(archivePath(), entries, {}));
+    auto archive = am::AssetArchive::open(archivePath());
+    BOOST_REQUIRE(archive);
+
+    for (size_t i = 0; i < entries.size(); ++i)
+        BOOST_TEST(readEntry(*archive, entries[i].id) == std::to_string(i));
+}
+
+BOOST_AUTO_TEST_CASE(MissingFilesAreSkipped) {
+    addFile("present.material", "{}", am::AssetType::Material);
+    entries.push_back({boost::uuids::random_generator()(), am::AssetType::Material, (directory / "missing.material").string()});
+
+    BOOST_REQUIRE(am::AssetArchive::build(archivePath(), entries, {}));
+    auto archive = am::AssetArchive::open(archivePath());
+    BOOST_REQUIRE(archive);
+    BOOST_TEST(archive->getEntryCount() == 1u);
+    BOOST_TEST(archive->contains(entries[0].id));
+    BOOST_TEST(!archive->contains(entries[1].id));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include "../src/AssetDependencyGraph.hpp"
+#include "../src/AssetManager.hpp"
+#include "../src/AssetWatcher.hpp"
+
+namespace
+{
+    struct TempDirectory {
+        std::filesystem::path path;
+
+        TempDirectory() {
+            path = std::filesystem::temp_directory_path() / ("am_hot_reload_" + std::to_string(std::rand()));
+            std::filesystem::create_directories(path);
+        }
+        ~TempDirectory() {
+            std::error_code error;
+            std::filesystem::remove_all(path, error);
+        }
+    };
+
+    void writeFile(const std::filesystem::path& path, const std::string& contents)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+
+    size_t indexOf(const std::vector<boost::uuids::uuid>& ids, const boost::uuids::uuid& id)
+    {
+        return static_cast<size_t>(std::ranges::find(ids, id) - ids.begin());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(AssetHotReloadTests)
+
+BOOST_AUTO_TEST_CASE(AffectedAssetsComeAfterTheirDependencies) {
+    boost::uuids::random_generator generator;
+    const auto texture = generator(), material = generator(), mesh = generator(), model = generator(), other = generator();
+
+    am::AssetDependencyGraph graph;
+    graph.record(texture, {}, {"textures/albedo.png"});
+    graph.record(material, {texture}, {"materials/pbr.json"});
+    // Diamond, the model reaches the material directly and through the mesh
+    graph.record(mesh, {material}, {"meshes/box.obj"});
+    graph.record(model, {mesh, material}, {"models/box.gltf"});
+    graph.record(other, {}, {"textures/other.png"});
+
+    const auto affected = graph.collectAffected({"textures/albedo.png"});
+    BOOST_REQUIRE_EQUAL(affected.size(), 4u);
+    BOOST_TEST(indexOf(affected, texture) < indexOf(affected, material));
+    BOOST_TEST(indexOf(affected, material) < indexOf(affected, mesh));
+    BOOST_TEST(indexOf(affected, mesh) < indexOf(affected, model));
+    BOOST_TEST(indexOf(affected, other) == affected.size());
+
+    const auto fromMesh = graph.collectAffected({"./meshes/../meshes/box.obj"});
+    BOOST_REQUIRE_EQUAL(fromMesh.size(), 2u);
+    BOOST_TEST(fromMesh[0] == mesh);
+    BOOST_TEST(fromMesh[1] == model);
+}
+
+BOOST_AUTO_TEST_CASE(RecordReplacesAndRemoveUnlinks) {
+    boost::uuids::random_generator generator;
+    const auto shader = generator(), program = generator();
+
+    am::AssetDependencyGraph graph;
+    graph.record(shader, {}, {"shaders/pbr.frag", "shaders/common.glsl"});
+    graph.record(program, {shader}, {"shaders/pbr.program"});
+    BOOST_TEST(graph.getReaders("shaders/common.glsl") == std::vector{shader});
+    BOOST_TEST(graph.getDependents(shader) == std::vector{program});
+
+    // The include was dropped on reimport, what depends on the shader stays
+    graph.record(shader, {}, {"shaders/pbr.frag"});
+    BOOST_TEST(graph.getReaders("shaders/common.glsl").empty());
+    BOOST_TEST(graph.getDependents(shader) == std::vector{program});
+
+    graph.remove(program);
+    BOOST_TEST(graph.getDependents(shader).empty());
+    BOOST_TEST(graph.getReaders("shaders/pbr.program").empty());
+    BOOST_TEST(graph.getSourceFiles().size() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(WatcherReportsChangedBytesOnce) {
+    TempDirectory directory;
+    const auto shader = (directory.path / "shader.frag").string();
+    const auto include = (directory.path / "common.glsl").string();
+    writeFile(shader, "void main() {}");
+    writeFile(include, "#define A 1");
+
+    am::AssetWatcher watcher;
+    watcher.watch(shader);
+    watcher.watch(include);
+    BOOST_TEST(watcher.isWatching(shader));
+    BOOST_TEST(watcher.poll().empty());
+
+    // Saved twice, reported once
+    writeFile(shader, "void main() { discard; }");
+    writeFile(shader, "void main() { return; }");
+    std::filesystem::last_write_time(shader, std::filesystem::last_write_time(shader) + std::chrono::seconds(1));
+    BOOST_TEST(watcher.poll() == std::vector{shader});
+    BOOST_TEST(watcher.poll().empty());
+
+    // Same bytes written back isn't a change
+    writeFile(include, "#define A 1");
+    std::filesystem::last_write_time(include, std::filesystem::last_write_time(include) + std::chrono::seconds(1));
+    BOOST_TEST(watcher.poll().empty());
+
+    // Replaced through a rename like editors save
+    writeFile(directory.path / "common.glsl.tmp", "#define A 2");
+    std::filesystem::rename(directory.path / "common.glsl.tmp", include);
+    std::filesystem::last_write_time(include, std::filesystem::last_write_time(include) + std::chrono::seconds(2));
+    BOOST_TEST(watcher.poll() == std::vector{include});
+}
+
+BOOST_AUTO_TEST_CASE(EditedIncludeIsReimported) {
+    TempDirectory directory;
+    const auto shader = (directory.path / "tinted.frag").string();
+    const auto include = directory.path / "tint.glsl";
+    writeFile(include, "#define TINT 1.0\n");
+    // Absolute, so it resolves the same wherever the compiler's include directory is
+    writeFile(shader, "#version 450\n#include \"" + include.generic_string() + "\"\n"
+                      "layout(location = 0) out vec4 color;\nvoid main() { color = vec4(TINT); }\n");
+
+    auto& manager = am::AssetManager::getInstance();
+    const auto id = manager.registerAsset(shader);
+    BOOST_REQUIRE(id.has_value());
+    const uint64_t sourceHash = manager.getAssetInfo(id.value()).value()->sourceHash;
+    const size_t contentHash = manager.getAssetInfo(id.value()).value()->contentHash;
+
+    // Nothing changed, the cached import is reused
+    BOOST_TEST(manager.registerAsset(shader) == id);
+    BOOST_TEST(manager.getAssetInfo(id.value()).value()->sourceHash == sourceHash);
+
+    // Only the include changed, the shader file itself is untouched
+    writeFile(include, "#define TINT 0.25\n");
+    std::filesystem::last_write_time(include, std::filesystem::last_write_time(include) + std::chrono::seconds(1));
+    BOOST_TEST(manager.registerAsset(shader) == id);
+    const auto reimported = manager.getAssetInfo(id.value()).value();
+    BOOST_TEST(reimported->sourceHash != sourceHash);
+    BOOST_TEST(reimported->contentHash != contentHash);
+
+    manager.unregisterAsset(id.value());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
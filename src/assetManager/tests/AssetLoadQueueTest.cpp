@@ -0,0 +1,145 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <latch>
+#include <map>
+#include <mutex>
+
+#include "../src/AssetLoadQueue.hpp"
+#include "../include/Asset.hpp"
+
+namespace
+{
+    class GraphAsset : public am::Asset {
+    public:
+        GraphAsset(const boost::uuids::uuid& id, std::vector<boost::uuids::uuid> dependencies)
+            : Asset(id), dependencies(std::move(dependencies)) {}
+
+        size_t calculateContentHash() const override { return 0; }
+        [[nodiscard]] am::AssetType getType() const override { return am::AssetType::Other; }
+        std::any getAssetData() override { return nullptr; }
+        void SaveAssetToJson(rapidjson::Document&) override {}
+        void SaveAssetMetadata(rapidjson::Document&) override {}
+        void LoadAssetMetadata(rapidjson::Document&) override {}
+        [[nodiscard]] std::vector<boost::uuids::uuid> getDependencies() const override { return dependencies; }
+
+    private:
+        std::vector<boost::uuids::uuid> dependencies;
+    };
+
+    // Asset graph plus a log of the order the workers loaded it in
+    struct AssetGraph {
+        std::map<boost::uuids::uuid, std::unique_ptr<GraphAsset>> assets;
+        std::vector<boost::uuids::uuid> loadOrder;
+        std::mutex mutex;
+
+        boost::uuids::uuid add(std::vector<boost::uuids::uuid> dependencies = {})
+        {
+            auto id = boost::uuids::random_generator()();
+            assets[id] = std::make_unique<GraphAsset>(id, std::move(dependencies));
+            return id;
+        }
+
+        am::Asset* load(const boost::uuids::uuid& id)
+        {
+            std::lock_guard lock(mutex);
+            loadOrder.push_back(id);
+            auto it = assets.find(id);
+            return it != assets.end() ? it->second.get() : nullptr;
+        }
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(AssetLoadQueueTests)
+
+BOOST_AUTO_TEST_CASE(ReadyOnlyOnceDependenciesAreLoaded) {
+    AssetGraph graph;
+    auto texture = graph.add();
+    auto material = graph.add({texture});
+    auto meshA = graph.add({material});
+    auto meshB = graph.add({material});
+    auto model = graph.add({meshA, meshB});
+
+    am::AssetLoadQueue queue([&](const boost::uuids::uuid& id) { return graph.load(id); }, 4);
+    auto handle = queue.request(model, am::LoadPriority::Normal);
+
+    BOOST_REQUIRE(handle.wait() == graph.assets[model].get());
+    BOOST_TEST(handle.isReady());
+
+    // Every asset of the graph was loaded before the model settled, the shared material only once
+    std::lock_guard lock(graph.mutex);
+    BOOST_TEST(graph.loadOrder.size() == 5u);
+    BOOST_TEST(std::count(graph.loadOrder.begin(), graph.loadOrder.end(), material) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(MissingDependencyDoesNotFailParent) {
+    AssetGraph graph;
+    auto missing = boost::uuids::random_generator()();
+    auto material = graph.add({missing});
+
+    am::AssetLoadQueue queue([&](const boost::uuids::uuid& id) { return graph.load(id); }, 2);
+    auto materialHandle = queue.request(material, am::LoadPriority::Normal);
+    BOOST_TEST(materialHandle.wait() != nullptr);
+
+    auto missingHandle = queue.request(missing, am::LoadPriority::Normal);
+    BOOST_TEST(missingHandle.wait() == nullptr);
+    BOOST_TEST((missingHandle.getState() == am::AssetLoadState::Failed));
+}
+
+BOOST_AUTO_TEST_CASE(HigherPriorityLoadsFirstAndQueuedLoadsCancel) {
+    AssetGraph graph;
+    auto blocker = graph.add();
+    std::vector<boost::uuids::uuid> background;
+    for (int i = 0; i < 8; ++i)
+        background.push_back(graph.add());
+    auto urgent = graph.add();
+
+    // A single worker held on the first load, so everything else piles up in the queue
+    std::latch started(1);
+    std::latch release(1);
+    am::AssetLoadQueue queue([&](const boost::uuids::uuid& id) {
+        if (id == blocker) {
+            started.count_down();
+            release.wait();
+        }
+        return graph.load(id);
+    }, 1);
+
+    auto blockerHandle = queue.request(blocker, am::LoadPriority::Normal);
+    started.wait();
+
+    std::vector<am::AssetLoadHandle> backgroundHandles;
+    for (const auto& id : background)
+        backgroundHandles.push_back(queue.request(id, am::LoadPriority::Background));
+    auto cancelled = backgroundHandles.back();
+    auto urgentHandle = queue.request(urgent, am::LoadPriority::Critical);
+
+    BOOST_TEST(cancelled.cancel());
+    BOOST_TEST(cancelled.isDone());
+    BOOST_TEST((cancelled.getState() == am::AssetLoadState::Cancelled));
+
+    release.count_down();
+    BOOST_TEST(urgentHandle.wait() != nullptr);
+    for (size_t i = 0; i + 1 < backgroundHandles.size(); ++i)
+        BOOST_TEST(backgroundHandles[i].wait() != nullptr);
+
+    std::lock_guard lock(graph.mutex);
+    BOOST_REQUIRE(graph.loadOrder.size() == background.size() + 1);
+    BOOST_TEST(graph.loadOrder[0] == blocker);
+    BOOST_TEST(graph.loadOrder[1] == urgent);
+    BOOST_TEST(std::count(graph.loadOrder.begin(), graph.loadOrder.end(), background.back()) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(RepeatedRequestsShareTheLoad) {
+    AssetGraph graph;
+    auto id = graph.add();
+
+    am::AssetLoadQueue queue([&](const boost::uuids::uuid& assetId) { return graph.load(assetId); }, 2);
+    auto first = queue.request(id, am::LoadPriority::Normal);
+    auto second = queue.request(id, am::LoadPriority::High);
+    BOOST_TEST(first.wait() == second.wait());
+
+    std::lock_guard lock(graph.mutex);
+    BOOST_TEST(graph.loadOrder.size() == 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,346 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/functional/hash.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+
+#include "../src/AssetRegistry.hpp"
+#include "../src/AssetRegistryFile.hpp"
+#include "../src/JsonHelpers.hpp"
+#include "../include/AssetInfo.hpp"
+
+namespace
+{
+    struct RegistryFixture {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "asset_registry_test";
+
+        RegistryFixture() { std::filesystem::create_directories(directory); }
+        ~RegistryFixture() { std::filesystem::remove_all(directory); }
+
+        std::string path(const std::string& name) const { return (directory / name).string(); }
+    };
+
+    // Owns the strings the entry views point at
+    struct RegistryEntries {
+        std::vector<std::string> strings;
+        std::vector<am::RegistryEntryView> views;
+
+        explicit RegistryEntries(size_t count)
+        {
+            strings.reserve(count * 3);
+            views.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                const std::string name = "asset_" + std::to_string(i);
+                strings.push_back("res/models/" + name + ".mesh.bin");
+                strings.push_back(name + ".mesh");
+                strings.push_back("res/models/source_" + std::to_string(i / 8) + ".fbx");
+
+                am::RegistryEntryView entry{};
+                entry.id = boost::uuids::random_generator()();
+                entry.type = am::AssetType::Mesh;
+                entry.importType = am::AssetType::Model;
+                entry.assimpIndex = static_cast<int32_t>(i % 8);
+                entry.contentHash = 0x9E3779B97F4A7C15ull * (i + 1);
+                entry.sourceHash = i % 2 == 0 ? 0 : i * 31 + 7;
+                views.push_back(entry);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                views[i].path = strings[i * 3];
+                views[i].lookUpName = strings[i * 3 + 1];
+                views[i].importPath = strings[i * 3 + 2];
+            }
+        }
+    };
+
+    std::shared_ptr<am::AssetInfo> makeInfo(size_t i, am::AssetType type)
+    {
+        const std::string name = "asset_" + std::to_string(i);
+        auto info = std::make_shared<am::AssetInfo>(boost::uuids::random_generator()(), "res/assets/" + name + ".bin", type,
+                                                    0x9E3779B97F4A7C15ull * (i + 1),
+                                                    am::ImportContext("res/models/source_" + std::to_string(i / 4) + ".fbx",
+                                                                      am::AssetType::Model, static_cast<int32_t>(i % 4)),
+                                                    name + ".asset");
+        info->sourceHash = i * 31 + 7;
+        return info;
+    }
+
+    bool writeJsonRegistry(const std::string& path, const RegistryEntries& entries)
+    {
+        rapidjson::Document document;
+        document.SetObject();
+        auto& allocator = document.GetAllocator();
+        rapidjson::Value metadataArray(rapidjson::kArrayType);
+        for (const auto& entry : entries.views) {
+            am::AssetInfo info(entry.id, std::string(entry.path), entry.type, entry.contentHash,
+                               am::ImportContext(std::string(entry.importPath), entry.importType, entry.assimpIndex),
+                               std::string(entry.lookUpName));
+            info.sourceHash = entry.sourceHash;
+            rapidjson::Value value(rapidjson::kObjectType);
+            info.SerializeAssetInfoToJson(value, allocator);
+            metadataArray.PushBack(value, allocator);
+        }
+        document.AddMember("metadata", metadataArray, allocator);
+        return am::saveJsonToFile(path, document);
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // What startup used to do, parse the whole file and build every map before the first lookup
+    double timeJsonStartup(const std::string& path, const RegistryEntries& entries, size_t lookups)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        rapidjson::Document document;
+        BOOST_REQUIRE(am::loadJsonFromFile(path, document));
+        std::unordered_map<boost::uuids::uuid, std::shared_ptr<am::AssetInfo>, boost::hash<boost::uuids::uuid>> metadata;
+        std::unordered_map<std::string, boost::uuids::uuid> lookupNames;
+        for (const auto& value : document["metadata"].GetArray()) {
+            auto info = std::make_shared<am::AssetInfo>(am::AssetInfo::DeserializeAssetInfoFromJson(value));
+            lookupNames[info->lookUpName] = info->id;
+            metadata[info->id] = std::move(info);
+        }
+        for (size_t i = 0; i < lookups; ++i) {
+            const auto& entry = entries.views[i * entries.views.size() / lookups];
+            BOOST_REQUIRE(metadata.contains(lookupNames.at(std::string(entry.lookUpName))));
+        }
+        return millisecondsSince(start);
+    }
+
+    double timeSnapshotStartup(const std::string& path, const RegistryEntries& entries, size_t lookups)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto snapshot = am::AssetRegistrySnapshot::open(path);
+        BOOST_REQUIRE(snapshot);
+        for (size_t i = 0; i < lookups; ++i) {
+            const auto& entry = entries.views[i * entries.views.size() / lookups];
+            auto found = snapshot->findByLookupName(entry.lookUpName);
+            BOOST_REQUIRE(found.has_value());
+            BOOST_REQUIRE(snapshot->find(found->id).has_value());
+        }
+        return millisecondsSince(start);
+    }
+
+    void benchmarkStartup(const RegistryFixture& fixture, size_t count)
+    {
+        const RegistryEntries entries(count);
+        const std::string jsonPath = fixture.path("metadatas_" + std::to_string(count) + ".json");
+        const std::string snapshotPath = fixture.path("metadatas_" + std::to_string(count) + ".reg");
+        BOOST_REQUIRE(writeJsonRegistry(jsonPath, entries));
+        BOOST_REQUIRE(am::AssetRegistrySnapshot::write(snapshotPath, entries.views));
+
+        // A typical startup resolves a scene's worth of assets, not the whole registry
+        constexpr size_t lookups = 256;
+        const double jsonMs = timeJsonStartup(jsonPath, entries, lookups);
+        const double snapshotMs = timeSnapshotStartup(snapshotPath, entries, lookups);
+
+        BOOST_TEST_MESSAGE("Registry startup with " << count << " assets and " << lookups << " lookups: json "
+                           << jsonMs << " ms (" << std::filesystem::file_size(jsonPath) / 1024 << " KiB), snapshot "
+                           << snapshotMs << " ms (" << std::filesystem::file_size(snapshotPath) / 1024 << " KiB)");
+        // Parsing the whole JSON against mapping the snapshot and probing its indexes, the gap is orders of
+        // magnitude at these sizes, so only the ordering is asserted to stay clear of timer noise
+        BOOST_TEST(snapshotMs < jsonMs);
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(AssetRegistryTests, RegistryFixture)
+
+BOOST_AUTO_TEST_CASE(SnapshotRoundTripsEveryIndex) {
+    const RegistryEntries entries(3000);
+    BOOST_REQUIRE(am::AssetRegistrySnapshot::write(path("registry.reg"), entries.views));
+    auto snapshot = am::AssetRegistrySnapshot::open(path("registry.reg"));
+    BOOST_REQUIRE(snapshot);
+    BOOST_REQUIRE_EQUAL(snapshot->size(), entries.views.size());
+
+    for (const auto& entry : entries.views) {
+        auto found = snapshot->find(entry.id);
+        BOOST_REQUIRE(found.has_value());
+        BOOST_TEST(found->path == entry.path);
+        BOOST_TEST(found->importPath == entry.importPath);
+        BOOST_TEST(found->assimpIndex == entry.assimpIndex);
+        BOOST_TEST((found->importType == entry.importType));
+
+        BOOST_TEST(snapshot->findByLookupName(entry.lookUpName)->id == entry.id);
+        BOOST_TEST(snapshot->findByContentHash(entry.contentHash)->id == entry.id);
+        if (entry.sourceHash != 0)
+            BOOST_TEST(snapshot->findBySourceHash(entry.sourceHash)->id == entry.id);
+    }
+
+    BOOST_TEST(!snapshot->find(boost::uuids::random_generator()()).has_value());
+    BOOST_TEST(!snapshot->findByLookupName("missing.mesh").has_value());
+    BOOST_TEST(!snapshot->findBySourceHash(0).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(RejectsForeignFiles) {
+    std::ofstream(path("foreign.reg"), std::ios::binary) << std::string(256, 'x');
+    BOOST_TEST(!am::AssetRegistrySnapshot::open(path("foreign.reg")));
+}
+
+BOOST_AUTO_TEST_CASE(JournalReplaysAndDropsTornTail) {
+    const RegistryEntries entries(10);
+    const std::string journalPath = path("registry.journal");
+    {
+        auto journal = am::AssetRegistryJournal::open(journalPath, [](const am::RegistryEntryView&) { BOOST_FAIL("New journal has records"); });
+        BOOST_REQUIRE(journal);
+        for (size_t i = 0; i < 5; ++i)
+            BOOST_REQUIRE(journal->append(entries.views[i]));
+    }
+
+    // Half a record, as left by a crash in the middle of an append
+    std::ofstream(journalPath, std::ios::binary | std::ios::app) << std::string(20, '\x7f');
+
+    std::vector<std::string> replayed;
+    auto collect = [&](const am::RegistryEntryView& entry) { replayed.emplace_back(entry.lookUpName); };
+    {
+        auto journal = am::AssetRegistryJournal::open(journalPath, collect);
+        BOOST_REQUIRE(journal);
+        BOOST_TEST(journal->getRecordCount() == 5u);
+        BOOST_REQUIRE(journal->append(entries.views[5]));
+    }
+    BOOST_REQUIRE_EQUAL(replayed.size(), 5u);
+    BOOST_TEST(replayed[4] == entries.views[4].lookUpName);
+
+    replayed.clear();
+    {
+        auto journal = am::AssetRegistryJournal::open(journalPath, collect);
+        BOOST_REQUIRE(journal);
+        BOOST_REQUIRE_EQUAL(replayed.size(), 6u);
+        BOOST_TEST(replayed[5] == entries.views[5].lookUpName);
+        BOOST_REQUIRE(journal->clear());
+    }
+
+    replayed.clear();
+    auto journal = am::AssetRegistryJournal::open(journalPath, collect);
+    BOOST_REQUIRE(journal);
+    BOOST_TEST(replayed.empty());
+}
+
+BOOST_AUTO_TEST_CASE(SnapshotIndexesTypesAndImportPaths) {
+    RegistryEntries entries(200);
+    const am::AssetType types[] = {am::AssetType::Texture, am::AssetType::Mesh, am::AssetType::Material};
+    for (size_t i = 0; i < entries.views.size(); ++i)
+        entries.views[i].type = types[i % 3];
+    BOOST_REQUIRE(am::AssetRegistrySnapshot::write(path("typed.reg"), entries.views));
+    auto snapshot = am::AssetRegistrySnapshot::open(path("typed.reg"));
+    BOOST_REQUIRE(snapshot);
+
+    // Every type is one contiguous run of records
+    uint32_t covered = 0;
+    for (const auto type : types) {
+        const auto range = snapshot->getTypeRange(type);
+        for (uint32_t i = range.first; i < range.first + range.count; ++i)
+            BOOST_TEST((snapshot->at(i).type == type));
+        covered += range.count;
+    }
+    BOOST_TEST(covered == snapshot->size());
+    BOOST_TEST(snapshot->getTypeRange(am::AssetType::Shader).count == 0u);
+
+    // RegistryEntries imports eight assets from each source
+    const auto imported = snapshot->findByImportPath(entries.views[17].importPath);
+    BOOST_REQUIRE_EQUAL(imported.size(), 8u);
+    for (const auto& entry : imported)
+        BOOST_TEST(entry.importPath == entries.views[17].importPath);
+    BOOST_TEST(snapshot->findByImportPath("res/models/missing.fbx").empty());
+}
+
+BOOST_AUTO_TEST_CASE(RegistryIndexesStayConsistent) {
+    std::vector<boost::uuids::uuid> kept;
+    std::vector<std::shared_ptr<am::AssetInfo>> removed;
+    {
+        am::AssetRegistry registry;
+        BOOST_REQUIRE(registry.open(path("registry.reg"), path("registry.journal")));
+        BOOST_TEST(!registry.hasSnapshot());
+
+        for (size_t i = 0; i < 40; ++i) {
+            auto info = makeInfo(i, i % 2 == 0 ? am::AssetType::Mesh : am::AssetType::Texture);
+            BOOST_REQUIRE(registry.insert(info, true) == info->id);
+            if (i % 4 == 3)
+                removed.push_back(info);
+            else
+                kept.push_back(info->id);
+        }
+        // Same content under another name is deduplicated, without deduplication it takes the next free name
+        auto duplicate = makeInfo(0, am::AssetType::Mesh);
+        BOOST_TEST(registry.insert(duplicate, true) == registry.findByLookupName("asset_0.asset").value());
+        BOOST_TEST(registry.findFreeLookupName("asset_0.asset") == "asset_0_1.asset");
+
+        BOOST_REQUIRE(registry.compact());
+        BOOST_TEST(registry.hasSnapshot());
+        for (const auto& info : removed)
+            BOOST_REQUIRE(registry.remove(info->id));
+        BOOST_TEST(!registry.remove(removed.front()->id));
+    }
+
+    // Half from the snapshot, the removals from the journal
+    am::AssetRegistry registry;
+    BOOST_REQUIRE(registry.open(path("registry.reg"), path("registry.journal")));
+    for (int pass = 0; pass < 2; ++pass) {
+        for (const auto& info : removed) {
+            BOOST_TEST(!registry.find(info->id));
+            BOOST_TEST(!registry.findByLookupName(info->lookUpName).has_value());
+            BOOST_TEST(!registry.findByContentHash(info->contentHash).has_value());
+            BOOST_TEST(!registry.findBySourceHash(info->sourceHash).has_value());
+        }
+        for (const auto& id : kept)
+            BOOST_TEST(registry.find(id) != nullptr);
+
+        // Assets 3, 7... are removed, every source keeps three of its four
+        BOOST_TEST(registry.findByImportPath("res/models/source_2.fbx").size() == 3u);
+        BOOST_TEST(registry.findByType(am::AssetType::Mesh).size() == 20u);
+        BOOST_TEST(registry.findByType(am::AssetType::Texture).size() == 10u);
+
+        size_t visited = 0;
+        registry.forEach([&](const am::RegistryEntryView&) { ++visited; });
+        BOOST_TEST(visited == kept.size());
+        BOOST_REQUIRE(registry.compact());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ReadersNeverMissAssetsDuringWrites) {
+    am::AssetRegistry registry;
+    BOOST_REQUIRE(registry.open(path("registry.reg"), path("registry.journal")));
+    std::vector<std::shared_ptr<am::AssetInfo>> infos;
+    for (size_t i = 0; i < 4000; ++i)
+        infos.push_back(makeInfo(i, am::AssetType::Texture));
+    for (size_t i = 0; i < 1000; ++i)
+        registry.insert(infos[i], false);
+
+    // The first thousand are registered before the readers start, they must stay visible through every compaction.
+    // The readers stop on their stop token, which the jthreads raise on destruction, so a failed requirement below
+    // unwinds through them instead of leaving them spinning
+    std::atomic<size_t> misses = 0;
+    std::vector<std::jthread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&, r](std::stop_token stop) {
+            for (size_t i = r; !stop.stop_requested(); i = (i + 7) % 1000) {
+                const auto& info = infos[i];
+                if (!registry.find(info->id) || registry.findByLookupName(info->lookUpName) != info->id
+                    || registry.findByContentHash(info->contentHash) != info->id)
+                    ++misses;
+            }
+        });
+    }
+    for (size_t i = 1000; i < infos.size(); ++i) {
+        registry.insert(infos[i], false);
+        if (i % 500 == 0)
+            BOOST_REQUIRE(registry.compact());
+    }
+    readers.clear();
+
+    BOOST_TEST(misses == 0u);
+    BOOST_TEST(registry.findByType(am::AssetType::Texture).size() == infos.size());
+}
+
+BOOST_AUTO_TEST_CASE(StartupBenchmark10k) {
+    benchmarkStartup(*this, 10000);
+}
+
+BOOST_AUTO_TEST_CASE(StartupBenchmark100k) {
+    benchmarkStartup(*this, 100000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
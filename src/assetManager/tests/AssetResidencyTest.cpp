@@ -0,0 +1,93 @@
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include "../src/assets/ModelAsset.h"
+#include "../src/AssetManager.hpp"
+
+BOOST_AUTO_TEST_SUITE(AssetResidencyTests)
+
+namespace
+{
+    boost::uuids::uuid firstMeshId(am::ModelAsset& model)
+    {
+        std::vector<const am::Node*> stack{&model.getAssetDataAs<am::ModelData>()->rootNode};
+        while (!stack.empty()) {
+            const am::Node* node = stack.back();
+            stack.pop_back();
+            if (!node->meshes.empty())
+                return node->meshes[0]->id;
+            for (const auto& child : node->mChildren)
+                stack.push_back(&child);
+        }
+        return boost::uuids::nil_uuid();
+    }
+
+    // The manager is shared with the other suites, teardown gives back the budget they run with and any
+    // reference a failed check left behind, so nothing they load is evicted after this test
+    struct ResidencyFixture {
+        ResidencyFixture() : previousBudget(am::AssetManager::getInstance().getResidencyStats().budgetBytes) {}
+
+        ~ResidencyFixture()
+        {
+            auto& manager = am::AssetManager::getInstance();
+            for (const auto& id : acquired) {
+                manager.releaseAsset(id);
+            }
+            manager.setMemoryBudget(0);
+        }
+
+        am::Asset* acquire(const boost::uuids::uuid& id)
+        {
+            am::Asset* asset = am::AssetManager::getInstance().acquireAsset(id);
+            if (asset) {
+                acquired.push_back(id);
+            }
+            return asset;
+        }
+
+        void release(const boost::uuids::uuid& id)
+        {
+            am::AssetManager::getInstance().releaseAsset(id);
+            std::erase(acquired, id);
+        }
+
+        size_t previousBudget;
+        std::vector<boost::uuids::uuid> acquired;
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE(AcquiredAssetsSurviveEviction, ResidencyFixture) {
+    auto& manager = am::AssetManager::getInstance();
+
+    auto modelId = manager.registerAsset("res/models/my/Sphere.fbx");
+    BOOST_REQUIRE(modelId.has_value());
+    auto model = manager.getByUUID<am::ModelAsset>(modelId.value());
+    BOOST_REQUIRE(model != nullptr);
+    auto meshId = firstMeshId(*model);
+    BOOST_REQUIRE(!meshId.is_nil());
+
+    am::Asset* mesh = acquire(meshId);
+    BOOST_REQUIRE(mesh != nullptr);
+    const size_t meshBytes = mesh->getMemoryUsage();
+    BOOST_TEST(meshBytes > 0u);
+
+    // Nothing but the pinned mesh fits in a single byte
+    manager.setMemoryBudget(1);
+    auto stats = manager.getResidencyStats();
+    BOOST_TEST(stats.evictableCount == 0u);
+    BOOST_TEST(stats.referencedCount >= 1u);
+    BOOST_TEST(stats.evictionCount > 0u);
+    BOOST_TEST(manager.getAsset(meshId).value() == mesh);
+
+    release(meshId);
+    stats = manager.getResidencyStats();
+    BOOST_TEST(stats.referencedCount == 0u);
+    BOOST_TEST(stats.residentBytes <= 1u);
+
+    // Evicted assets load again on demand
+    manager.setMemoryBudget(0);
+    auto reloaded = manager.getAsset(meshId);
+    BOOST_REQUIRE(reloaded.has_value());
+    BOOST_TEST(reloaded.value()->getMemoryUsage() == meshBytes);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
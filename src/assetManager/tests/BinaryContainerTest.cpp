@@ -0,0 +1,196 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/nil_generator.hpp>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+#include "BinaryContainer.hpp"
+#include "../src/assets/meshAsset/MeshAsset.h"
+
+namespace
+{
+    constexpr uint32_t kTestKind = am::makeFourCC('T', 'E', 'S', 'T');
+    constexpr uint32_t kWordsTag = am::makeFourCC('W', 'R', 'D', 'S');
+    constexpr uint32_t kOddTag = am::makeFourCC('O', 'D', 'D', '_');
+    constexpr uint32_t kValueTag = am::makeFourCC('V', 'A', 'L', 'U');
+
+    struct TestValue {
+        uint32_t a;
+        float b;
+    };
+
+    std::string tempPath(const std::string& name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::vector<am::VertexAsset> makeVertices(size_t count)
+    {
+        std::vector<am::VertexAsset> vertices(count);
+        for (size_t i = 0; i < count; ++i) {
+            const float f = static_cast<float>(i);
+            vertices[i].Position = glm::vec3(f, f * 0.5f, -f);
+            vertices[i].Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            vertices[i].TexCoords = glm::vec2(f * 0.01f, 1.0f - f * 0.01f);
+            vertices[i].Color = glm::vec4(1.0f);
+            vertices[i].Tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+            vertices[i].Bitangent = glm::vec3(0.0f, 0.0f, 1.0f);
+        }
+        return vertices;
+    }
+
+    // Same layout MeshAsset wrote before the container format
+    void writeLegacyMesh(const std::string& path, const boost::uuids::uuid& id,
+                         const std::vector<am::VertexAsset>& vertices, const std::vector<unsigned int>& indices)
+    {
+        std::ofstream ofs(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        const char magic[] = "RMESH";
+        ofs.write(magic, sizeof(magic));
+        ofs.write(reinterpret_cast<const char*>(&id), 16);
+        const boost::uuids::uuid material = boost::uuids::nil_uuid();
+        ofs.write(reinterpret_cast<const char*>(&material), 16);
+        const glm::vec3 bounds[2] = {glm::vec3(-1.0f), glm::vec3(1.0f)};
+        ofs.write(reinterpret_cast<const char*>(bounds), sizeof(bounds));
+
+        size_t vertexCount = vertices.size();
+        ofs.write(reinterpret_cast<const char*>(&vertexCount), sizeof(vertexCount));
+        ofs.write(reinterpret_cast<const char*>(vertices.data()), vertexCount * sizeof(am::VertexAsset));
+
+        size_t indexCount = indices.size();
+        ofs.write(reinterpret_cast<const char*>(&indexCount), sizeof(indexCount));
+        ofs.write(reinterpret_cast<const char*>(indices.data()), indexCount * sizeof(unsigned int));
+    }
+
+    // Load the asset and copy it into a staging sized buffer, the way MeshDescriptor consumes it
+    double timeMeshLoad(const boost::uuids::uuid& id, const std::string& path, std::vector<std::byte>& staging, int iterations)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            am::MeshAsset asset(id, path, am::AssetFormat::Binary);
+            const auto* mesh = asset.getAssetDataAs<am::MeshData>();
+            const auto vertices = std::as_bytes(mesh->getVertices());
+            const auto indices = std::as_bytes(mesh->getIndices());
+            staging.resize(vertices.size() + indices.size());
+            std::memcpy(staging.data(), vertices.data(), vertices.size());
+            std::memcpy(staging.data() + vertices.size(), indices.data(), indices.size());
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(BinaryContainerTests)
+
+BOOST_AUTO_TEST_CASE(SectionsRoundTripAligned) {
+    const auto id = boost::uuids::random_generator()();
+    std::vector<uint32_t> words(1000);
+    std::iota(words.begin(), words.end(), 0u);
+    const std::vector<uint8_t> odd = {1, 2, 3};
+
+    am::BinaryContainerWriter writer(kTestKind, id);
+    writer.addSection(kOddTag, std::span<const uint8_t>(odd));
+    writer.addSection(kWordsTag, std::span<const uint32_t>(words));
+    writer.addValue(kValueTag, TestValue{7, 2.5f});
+
+    const std::string path = tempPath("binary_container_roundtrip.bin");
+    BOOST_REQUIRE(writer.write(path));
+    BOOST_TEST(std::filesystem::file_size(path) == writer.getSize());
+
+    auto reader = am::BinaryContainerReader::open(path, kTestKind);
+    BOOST_REQUIRE(reader.has_value());
+    BOOST_TEST(reader->getId() == id);
+
+    auto view = reader->sectionAs<uint32_t>(kWordsTag);
+    BOOST_REQUIRE_EQUAL(view.size(), words.size());
+    BOOST_TEST(std::equal(view.begin(), view.end(), words.begin()));
+    BOOST_TEST(reinterpret_cast<std::uintptr_t>(view.data()) % am::kBinaryContainerAlignment == 0u);
+
+    // Views point into the mapping, nothing was copied
+    const auto file = reader->getFile()->bytes();
+    BOOST_TEST(reinterpret_cast<const std::byte*>(view.data()) >= file.data());
+    BOOST_TEST(reinterpret_cast<const std::byte*>(view.data()) < file.data() + file.size());
+
+    auto value = reader->sectionValue<TestValue>(kValueTag);
+    BOOST_REQUIRE(value.has_value());
+    BOOST_TEST(value->a == 7u);
+    BOOST_TEST(value->b == 2.5f);
+
+    // Wrong element type is refused instead of reinterpreted
+    BOOST_TEST(reader->sectionAs<uint16_t>(kWordsTag).empty());
+    BOOST_TEST(reader->section(am::makeFourCC('N', 'O', 'N', 'E')).empty());
+
+    std::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(RejectsForeignAndCorruptFiles) {
+    const auto id = boost::uuids::random_generator()();
+    std::vector<uint32_t> words(64, 0xABCDu);
+
+    am::BinaryContainerWriter writer(kTestKind, id);
+    writer.addSection(kWordsTag, std::span<const uint32_t>(words));
+
+    const std::string path = tempPath("binary_container_corrupt.bin");
+    BOOST_REQUIRE(writer.write(path));
+
+    BOOST_TEST(!am::BinaryContainerReader::open(path, am::makeFourCC('M', 'E', 'S', 'H')).has_value());
+
+    // Cut the payload short, the section table now points past the end
+    std::filesystem::resize_file(path, 80);
+    BOOST_TEST(!am::BinaryContainerReader::open(path, kTestKind).has_value());
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "RMESH";
+    BOOST_TEST(!am::BinaryContainerReader::open(path, kTestKind).has_value());
+
+    std::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(MeshLoadBenchmark) {
+    const auto id = boost::uuids::random_generator()();
+    const auto vertices = makeVertices(250000);
+    std::vector<unsigned int> indices(750000);
+    for (size_t i = 0; i < indices.size(); ++i)
+        indices[i] = static_cast<unsigned int>(i % vertices.size());
+
+    const std::string legacyPath = tempPath("binary_container_mesh_legacy.bin");
+    const std::string containerPath = tempPath("binary_container_mesh.bin");
+    writeLegacyMesh(legacyPath, id, vertices, indices);
+
+    {
+        // Going through the legacy reader also checks old files still load
+        am::MeshAsset legacy(id, legacyPath, am::AssetFormat::Binary);
+        const auto* mesh = legacy.getAssetDataAs<am::MeshData>();
+        BOOST_REQUIRE_EQUAL(mesh->getVertices().size(), vertices.size());
+        BOOST_TEST(!mesh->mapping);
+
+        std::string path = containerPath;
+        legacy.SaveAssetToBin(path);
+    }
+
+    {
+        am::MeshAsset mapped(id, containerPath, am::AssetFormat::Binary);
+        const auto* mesh = mapped.getAssetDataAs<am::MeshData>();
+        BOOST_REQUIRE(mesh->mapping);
+        BOOST_TEST(mesh->vertices.empty());
+        BOOST_REQUIRE_EQUAL(mesh->getVertices().size(), vertices.size());
+        BOOST_REQUIRE_EQUAL(mesh->getIndices().size(), indices.size());
+        BOOST_TEST(std::memcmp(mesh->getVertices().data(), vertices.data(), vertices.size() * sizeof(am::VertexAsset)) == 0);
+        BOOST_TEST(std::memcmp(mesh->getIndices().data(), indices.data(), indices.size() * sizeof(unsigned int)) == 0);
+        BOOST_TEST(mesh->boundingBoxMax.x == 1.0f);
+    }
+
+    constexpr int iterations = 10;
+    std::vector<std::byte> staging;
+    const double legacyMs = timeMeshLoad(id, legacyPath, staging, iterations);
+    const double mappedMs = timeMeshLoad(id, containerPath, staging, iterations);
+
+    BOOST_TEST_MESSAGE("Mesh load + staging copy of " << staging.size() / (1024 * 1024) << " MiB: stream reader "
+                       << legacyMs << " ms, mapped container " << mappedMs << " ms");
+
+    std::filesystem::remove(legacyPath);
+    std::filesystem::remove(containerPath);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,230 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+
+#include <glm/glm.hpp>
+
+#include "MeshBVH.hpp"
+#include "../src/assets/meshAsset/MeshAsset.h"
+
+namespace
+{
+    struct TriangleSoup {
+        std::vector<am::VertexAsset> vertices;
+        std::vector<unsigned int> indices;
+
+        void addTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+        {
+            for (const glm::vec3& position : {a, b, c}) {
+                am::VertexAsset vertex{};
+                vertex.Position = position;
+                vertices.push_back(vertex);
+                indices.push_back(static_cast<unsigned int>(vertices.size() - 1));
+            }
+        }
+    };
+
+    TriangleSoup randomSoup(size_t count, float spread, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> position(-spread, spread), offset(-2.0f, 2.0f);
+        TriangleSoup soup;
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec3 center(position(rng), position(rng), position(rng));
+            soup.addTriangle(center + glm::vec3(offset(rng), offset(rng), offset(rng)),
+                             center + glm::vec3(offset(rng), offset(rng), offset(rng)),
+                             center + glm::vec3(offset(rng), offset(rng), offset(rng)));
+        }
+        return soup;
+    }
+
+    // Every triangle tested one by one, the reference for the tree
+    std::optional<am::MeshRayHit> bruteForce(const TriangleSoup& soup, const glm::vec3& origin, const glm::vec3& direction)
+    {
+        std::optional<am::MeshRayHit> closest;
+        for (size_t triangle = 0; triangle < soup.indices.size() / 3; ++triangle) {
+            const glm::vec3 vertex0 = soup.vertices[soup.indices[3 * triangle]].Position;
+            const glm::vec3 edge1 = soup.vertices[soup.indices[3 * triangle + 1]].Position - vertex0;
+            const glm::vec3 edge2 = soup.vertices[soup.indices[3 * triangle + 2]].Position - vertex0;
+            const glm::vec3 p = glm::cross(direction, edge2);
+            const float determinant = glm::dot(edge1, p);
+            if (std::abs(determinant) < 1e-12f) {
+                continue;
+            }
+            const glm::vec3 s = origin - vertex0;
+            const float u = glm::dot(s, p) / determinant;
+            const glm::vec3 q = glm::cross(s, edge1);
+            const float v = glm::dot(direction, q) / determinant;
+            const float distance = glm::dot(edge2, q) / determinant;
+            if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && distance > 0.0f && (!closest || distance < closest->distance)) {
+                closest = am::MeshRayHit{distance, static_cast<uint32_t>(triangle), u, v};
+            }
+        }
+        return closest;
+    }
+
+    glm::vec3 randomDirection(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+        return glm::normalize(glm::vec3(direction(rng), direction(rng), direction(rng)));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(MeshBVHTests)
+
+BOOST_AUTO_TEST_CASE(EveryLaneWidthMatchesBruteForce) {
+    std::mt19937 rng(7);
+    const TriangleSoup soup = randomSoup(3000, 40.0f, rng);
+    const am::MeshBVH bvh = am::buildMeshBVH(soup.vertices, soup.indices);
+    BOOST_REQUIRE(!bvh.nodes.empty());
+
+    std::uniform_real_distribution<float> position(-45.0f, 45.0f);
+    for (int i = 0; i < 300; ++i) {
+        const glm::vec3 origin(position(rng), position(rng), position(rng));
+        const glm::vec3 direction = randomDirection(rng);
+        const auto expected = bruteForce(soup, origin, direction);
+
+        for (am::TriangleLanes lanes : {am::TriangleLanes::Scalar, am::TriangleLanes::SSE, am::TriangleLanes::AVX}) {
+            BOOST_TEST_CONTEXT("lanes " << static_cast<int>(lanes)) {
+                const auto hit = am::intersectMeshBVH(bvh.nodes, bvh.packets, origin, direction,
+                                                      std::numeric_limits<float>::max(), lanes);
+                BOOST_REQUIRE_EQUAL(hit.has_value(), expected.has_value());
+                if (hit) {
+                    BOOST_TEST(hit->distance == expected->distance, boost::test_tools::tolerance(1e-4f));
+                    BOOST_TEST(hit->triangle == expected->triangle);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RayPassesThroughHollowMesh) {
+    // Open tube along z, four walls and nothing at either end
+    TriangleSoup tube;
+    const glm::vec3 corners[4] = {{-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}};
+    const glm::vec3 length(0.0f, 0.0f, 10.0f);
+    for (int side = 0; side < 4; ++side) {
+        const glm::vec3& a = corners[side];
+        const glm::vec3& b = corners[(side + 1) % 4];
+        tube.addTriangle(a, b, b + length);
+        tube.addTriangle(a, b + length, a + length);
+    }
+    const am::MeshBVH bvh = am::buildMeshBVH(tube.vertices, tube.indices);
+
+    // Down the middle, inside the bounds the whole way
+    BOOST_TEST(!am::intersectMeshBVH(bvh.nodes, bvh.packets, {0.0f, 0.0f, -5.0f}, {0.0f, 0.0f, 1.0f},
+                                     std::numeric_limits<float>::max()).has_value());
+
+    // Across it, the near wall is hit and the point is exact
+    const auto hit = am::intersectMeshBVH(bvh.nodes, bvh.packets, {-5.0f, 0.25f, 4.0f}, {1.0f, 0.0f, 0.0f},
+                                          std::numeric_limits<float>::max());
+    BOOST_REQUIRE(hit.has_value());
+    BOOST_TEST(hit->distance == 4.0f, boost::test_tools::tolerance(1e-5f));
+    BOOST_TEST(!am::intersectMeshBVH(bvh.nodes, bvh.packets, {-5.0f, 0.25f, 4.0f}, {1.0f, 0.0f, 0.0f}, 3.5f).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(ValidationRejectsIndicesOutOfRange) {
+    std::mt19937 rng(5);
+    const TriangleSoup soup = randomSoup(200, 10.0f, rng);
+    const am::MeshBVH bvh = am::buildMeshBVH(soup.vertices, soup.indices);
+    BOOST_TEST(am::validateMeshBVH(bvh.nodes, bvh.packets));
+    BOOST_REQUIRE(bvh.nodes.front().triangleCount == 0u);
+
+    // A right child past the end, one pointing back at its parent, and a leaf past the packets
+    std::vector<am::MeshBVHNode> nodes = bvh.nodes;
+    nodes.front().offset = static_cast<uint32_t>(nodes.size());
+    BOOST_TEST(!am::validateMeshBVH(nodes, bvh.packets));
+    nodes.front().offset = 0;
+    BOOST_TEST(!am::validateMeshBVH(nodes, bvh.packets));
+
+    nodes = bvh.nodes;
+    const auto leaf = std::ranges::find_if(nodes, [](const am::MeshBVHNode& node) { return node.triangleCount > 0; });
+    leaf->offset = static_cast<uint32_t>(bvh.packets.size());
+    BOOST_TEST(!am::validateMeshBVH(nodes, bvh.packets));
+}
+
+BOOST_AUTO_TEST_CASE(TreeIsStoredInTheBinaryMesh) {
+    std::mt19937 rng(3);
+    const TriangleSoup soup = randomSoup(500, 10.0f, rng);
+    const auto id = boost::uuids::random_generator()();
+    std::string path = (std::filesystem::temp_directory_path() / "mesh_bvh_roundtrip.bin").string();
+
+    // Built by the legacy reader, written out into the container
+    {
+        std::ofstream ofs(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        const char magic[] = "RMESH";
+        ofs.write(magic, sizeof(magic));
+        ofs.write(reinterpret_cast<const char*>(&id), 16);
+        const boost::uuids::uuid material{};
+        ofs.write(reinterpret_cast<const char*>(&material), 16);
+        const glm::vec3 bounds[2] = {glm::vec3(-12.0f), glm::vec3(12.0f)};
+        ofs.write(reinterpret_cast<const char*>(bounds), sizeof(bounds));
+        size_t vertexCount = soup.vertices.size();
+        ofs.write(reinterpret_cast<const char*>(&vertexCount), sizeof(vertexCount));
+        ofs.write(reinterpret_cast<const char*>(soup.vertices.data()), vertexCount * sizeof(am::VertexAsset));
+        size_t indexCount = soup.indices.size();
+        ofs.write(reinterpret_cast<const char*>(&indexCount), sizeof(indexCount));
+        ofs.write(reinterpret_cast<const char*>(soup.indices.data()), indexCount * sizeof(unsigned int));
+    }
+    size_t nodeCount = 0;
+    {
+        am::MeshAsset legacy(id, path, am::AssetFormat::Binary);
+        const auto* mesh = legacy.getAssetDataAs<am::MeshData>();
+        BOOST_REQUIRE(!mesh->getBvhNodes().empty());
+        nodeCount = mesh->getBvhNodes().size();
+        legacy.SaveAssetToBin(path);
+    }
+
+    am::MeshAsset mapped(id, path, am::AssetFormat::Binary);
+    const auto* mesh = mapped.getAssetDataAs<am::MeshData>();
+    BOOST_REQUIRE(mesh->mapping);
+    // Viewed in place, nothing was rebuilt
+    BOOST_TEST(mesh->bvh.nodes.empty());
+    BOOST_TEST(mesh->getBvhNodes().size() == nodeCount);
+
+    const glm::vec3 origin(0.0f, 0.0f, -20.0f), direction(0.0f, 0.0f, 1.0f);
+    const auto expected = bruteForce(soup, origin, direction);
+    const auto hit = am::intersectMeshBVH(mesh->getBvhNodes(), mesh->getBvhPackets(), origin, direction,
+                                          std::numeric_limits<float>::max());
+    BOOST_REQUIRE_EQUAL(hit.has_value(), expected.has_value());
+    if (hit) {
+        BOOST_TEST(hit->triangle == expected->triangle);
+    }
+    std::filesystem::remove(path);
+}
+
+// Picking against a dense mesh, kept small enough for every test run. Reported, only a warning past the budget since
+// debug builds are far slower
+BOOST_AUTO_TEST_CASE(RayThroughputAt100kTriangles) {
+    std::mt19937 rng(11);
+    const TriangleSoup soup = randomSoup(100000, 100.0f, rng);
+
+    const auto buildStart = std::chrono::steady_clock::now();
+    const am::MeshBVH bvh = am::buildMeshBVH(soup.vertices, soup.indices);
+    const auto buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart).count();
+
+    constexpr int rayCount = 1000;
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::vector<std::pair<glm::vec3, glm::vec3>> rays;
+    for (int i = 0; i < rayCount; ++i) {
+        rays.emplace_back(glm::vec3(position(rng), position(rng), position(rng)), randomDirection(rng));
+    }
+
+    for (am::TriangleLanes lanes : {am::TriangleLanes::Scalar, am::TriangleLanes::SSE, am::TriangleLanes::AVX}) {
+        int hits = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& [origin, direction] : rays) {
+            hits += am::intersectMeshBVH(bvh.nodes, bvh.packets, origin, direction, std::numeric_limits<float>::max(), lanes).has_value();
+        }
+        const double averageUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rayCount;
+        BOOST_TEST_MESSAGE("100k triangles built in " << buildMs << " ms, lanes " << static_cast<int>(lanes) << ": "
+                           << averageUs << " us per ray, " << hits << " hits");
+        BOOST_WARN_LT(averageUs, 1000.0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
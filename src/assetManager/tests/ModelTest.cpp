@@ -88,4 +88,42 @@ BOOST_AUTO_TEST_CASE(InvalidModelStillCreatesInfo) {
     BOOST_TEST(allMeshes.empty(), "Non-existent model should result in empty mesh list");
 }
 
+BOOST_AUTO_TEST_CASE(UnchangedSourceHitsImportCache) {
+    auto& manager = am::AssetManager::getInstance();
+
+    auto first = manager.registerAsset("res/models/my/Plane.fbx");
+    BOOST_REQUIRE(first.has_value());
+    auto info = manager.getAssetInfo(first.value());
+    BOOST_REQUIRE(info.has_value());
+    BOOST_TEST(info.value()->sourceHash != 0u);
+
+    // Served from the cache, neither the model nor its meshes and materials go through an importer again
+    const uint64_t importerRuns = manager.getImporterRunCount();
+    auto second = manager.registerAsset("res/models/my/Plane.fbx");
+    BOOST_REQUIRE(second.has_value());
+    BOOST_TEST(second.value() == first.value());
+    BOOST_TEST(manager.getImporterRunCount() == importerRuns);
+}
+
+BOOST_AUTO_TEST_CASE(BatchImportMatchesSingleImport) {
+    auto& manager = am::AssetManager::getInstance();
+
+    const std::vector<std::string> paths = {
+        "res/models/my/Box.fbx", "res/models/my/Plane.fbx", "res/models/my/Sphere.fbx", "res/models/my/Box.fbx"
+    };
+    auto ids = manager.registerAssets(paths, 3);
+    BOOST_REQUIRE_EQUAL(ids.size(), paths.size());
+
+    for (const auto& id : ids) {
+        BOOST_REQUIRE(id.has_value());
+        auto model = manager.getByUUID<am::ModelAsset>(id.value());
+        BOOST_REQUIRE(model != nullptr);
+        BOOST_TEST(!collectAllMeshes(model->getAssetDataAs<am::ModelData>()->rootNode).empty());
+    }
+
+    // Same content imported on two workers still ends up as one asset
+    BOOST_TEST(ids[0].value() == ids[3].value());
+    BOOST_TEST(manager.registerAsset("res/models/my/Sphere.fbx").value() == ids[2].value());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
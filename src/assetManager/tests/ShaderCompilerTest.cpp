@@ -0,0 +1,195 @@
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "../src/assets/shaderAsset/ShaderCompiler.hpp"
+#include "../src/assets/shaderAsset/ShaderSourceScanner.hpp"
+#include "assetDatas/ShaderProgramData.h"
+
+namespace
+{
+    struct ShaderSource {
+        std::string path;
+        std::string source;
+        am::ShaderStage stage;
+    };
+
+    std::optional<am::ShaderStage> getStage(const std::filesystem::path& path)
+    {
+        const auto extension = path.extension().string();
+        if (extension == ".vert") return am::ShaderStage::Vertex;
+        if (extension == ".frag") return am::ShaderStage::Fragment;
+        if (extension == ".comp") return am::ShaderStage::Compute;
+        if (extension == ".geom") return am::ShaderStage::Geometry;
+        if (extension == ".tesc") return am::ShaderStage::TessellationControl;
+        if (extension == ".tese") return am::ShaderStage::TessellationEvaluation;
+        return std::nullopt;
+    }
+
+    std::vector<ShaderSource> readShaderTree(const std::filesystem::path& root)
+    {
+        std::vector<ShaderSource> shaders;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            const auto stage = getStage(entry.path());
+            if (!entry.is_regular_file() || !stage)
+                continue;
+            std::ifstream file(entry.path(), std::ios::binary);
+            std::stringstream source;
+            source << file.rdbuf();
+            shaders.push_back({entry.path().string(), source.str(), stage.value()});
+        }
+        std::ranges::sort(shaders, {}, &ShaderSource::path);
+        return shaders;
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(ShaderCompilerTests)
+
+BOOST_AUTO_TEST_CASE(ScannerFindsDirectivesOutsideComments) {
+    const std::string source =
+        "#version 450\n"
+        "#extension GL_ARB_shading_language_include : enable\n"
+        "  #  define USE_POINT_LIGHTS   1  // count\n"
+        "#define EMPTY\n"
+        "#define SQUARE(x) ((x) * (x))\n"
+        "// #define COMMENTED 1\n"
+        "/* #include \"commented.glsl\"\n"
+        "   #define ALSO_COMMENTED */ #define AFTER_COMMENT 2\n"
+        "float a = 1.0; # define NOT_AT_LINE_START\n"
+        "#include \"../common/scene_ubo.glsl\"\n"
+        "#include <lighting/light_point.glsl>\n";
+
+    const auto directives = am::scanShaderDirectives(source);
+    BOOST_REQUIRE_EQUAL(directives.defines.size(), 3u);
+    BOOST_TEST(directives.defines[0].first == "USE_POINT_LIGHTS");
+    BOOST_TEST(directives.defines[0].second == "1");
+    BOOST_TEST(directives.defines[1].first == "EMPTY");
+    BOOST_TEST(directives.defines[1].second.empty());
+    BOOST_TEST(directives.defines[2].first == "AFTER_COMMENT");
+    BOOST_TEST(directives.defines[2].second == "2");
+
+    BOOST_REQUIRE_EQUAL(directives.includes.size(), 2u);
+    BOOST_TEST(directives.includes[0] == "../common/scene_ubo.glsl");
+    BOOST_TEST(directives.includes[1] == "lighting/light_point.glsl");
+}
+
+BOOST_AUTO_TEST_CASE(ShaderTreeColdAndWarmCompile) {
+    const std::filesystem::path root("res/shaders/glsl");
+    BOOST_REQUIRE(std::filesystem::exists(root));
+    const auto shaders = readShaderTree(root);
+    BOOST_REQUIRE(!shaders.empty());
+
+    const auto cacheDirectory = std::filesystem::temp_directory_path() / "spirv_cache_test";
+    std::filesystem::remove_all(cacheDirectory);
+    std::filesystem::create_directories(cacheDirectory);
+    const am::ShaderCompiler compiler(root / "entry", cacheDirectory);
+
+    std::vector<std::vector<std::uint32_t>> coldSpirv;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& shader : shaders) {
+        auto compiled = compiler.compile(shader.source, shader.stage);
+        BOOST_REQUIRE_MESSAGE(compiled, "Failed to compile " << shader.path);
+        BOOST_TEST(!compiled->fromCache);
+        coldSpirv.emplace_back(compiled->getBytecode().begin(), compiled->getBytecode().end());
+    }
+    const double coldMs = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < shaders.size(); ++i) {
+        auto compiled = compiler.compile(shaders[i].source, shaders[i].stage);
+        BOOST_REQUIRE(compiled);
+        BOOST_TEST(compiled->fromCache);
+        BOOST_TEST(std::ranges::equal(compiled->getBytecode(), coldSpirv[i]));
+    }
+    const double warmMs = millisecondsSince(start);
+
+    // A different define set is a different program
+    auto defined = compiler.compile(shaders.front().source, shaders.front().stage, {{"BENCHMARK_DEFINE", "1"}});
+    BOOST_REQUIRE(defined);
+    BOOST_TEST(!defined->fromCache);
+
+    BOOST_TEST_MESSAGE("Compiling " << shaders.size() << " shaders under " << root.string() << ": cold " << coldMs
+                       << " ms, warm " << warmMs << " ms");
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+BOOST_AUTO_TEST_CASE(PermutationDefinesSwitchVariants) {
+    const std::string source =
+        "#version 450\n"
+        "layout(location = 0) out vec4 outColor;\n"
+        "void main() {\n"
+        "    outColor = vec4(1.0);\n"
+        "#ifdef USE_FOG\n"
+        "    outColor.rgb *= 0.5;\n"
+        "#endif\n"
+        "}\n";
+
+    const auto cacheDirectory = std::filesystem::temp_directory_path() / "spirv_permutation_test";
+    std::filesystem::remove_all(cacheDirectory);
+    std::filesystem::create_directories(cacheDirectory);
+    const am::ShaderCompiler compiler("res/shaders/glsl/entry", cacheDirectory);
+
+    const std::vector<std::string> fog = {"USE_FOG"};
+    const std::vector<std::string> unused = {"USE_SKINNING"};
+    auto base = compiler.compile(source, am::ShaderStage::Fragment);
+    auto fogged = compiler.compile(source, am::ShaderStage::Fragment, {}, fog);
+    BOOST_REQUIRE(base && fogged);
+    BOOST_TEST(!std::ranges::equal(base->getBytecode(), fogged->getBytecode()));
+
+    // An axis the stage never tests is a separate cache entry but the same SPIR-V, which is what variants dedupe on
+    auto ignored = compiler.compile(source, am::ShaderStage::Fragment, {}, unused);
+    BOOST_REQUIRE(ignored);
+    BOOST_TEST(!ignored->fromCache);
+    BOOST_TEST(std::ranges::equal(base->getBytecode(), ignored->getBytecode()));
+
+    auto cachedFog = compiler.compile(source, am::ShaderStage::Fragment, {}, fog);
+    BOOST_REQUIRE(cachedFog);
+    BOOST_TEST(cachedFog->fromCache);
+    BOOST_TEST(std::ranges::equal(cachedFog->getBytecode(), fogged->getBytecode()));
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+BOOST_AUTO_TEST_CASE(ProgramVariantsSelectedByMask) {
+    am::ShaderProgramData program;
+    program.permutationAxes = {"USE_FOG", "USE_SKINNING"};
+    program.modules.push_back({.bytecode = {0x07230203, 1}, .stage = am::ShaderStage::Vertex});
+    program.modules.push_back({.bytecode = {0x07230203, 2}, .stage = am::ShaderStage::Fragment});
+    program.modules.push_back({.bytecode = {0x07230203, 3}, .stage = am::ShaderStage::Vertex});
+    program.modules.push_back({.bytecode = {0x07230203, 4}, .stage = am::ShaderStage::Fragment});
+
+    auto makeVariant = [](uint32_t mask, uint32_t vertex, uint32_t fragment) {
+        am::ShaderProgramVariant variant{.mask = mask};
+        variant.modules.fill(am::kNoShaderModule);
+        variant.modules[static_cast<size_t>(am::ShaderStage::Vertex)] = vertex;
+        variant.modules[static_cast<size_t>(am::ShaderStage::Fragment)] = fragment;
+        return variant;
+    };
+    // Fog only touches the fragment stage and skinning only the vertex stage, so the modules are shared
+    program.variants = {makeVariant(0b00, 0, 1), makeVariant(0b01, 0, 3), makeVariant(0b11, 2, 3)};
+
+    const uint32_t fog = program.getPermutationBit("USE_FOG");
+    const uint32_t skinning = program.getPermutationBit("USE_SKINNING");
+    BOOST_TEST(fog == 0b01u);
+    BOOST_TEST(skinning == 0b10u);
+    BOOST_TEST(program.getPermutationBit("USE_SHADOWS") == 0u);
+
+    BOOST_REQUIRE(program.findVariant(fog | skinning));
+    BOOST_TEST(program.getVariantBytecode(fog | skinning, am::ShaderStage::Vertex)[1] == 3u);
+    BOOST_TEST(program.getVariantBytecode(fog, am::ShaderStage::Vertex)[1] == 1u);
+    BOOST_TEST(program.getVariantBytecode(fog, am::ShaderStage::Fragment)[1] == 4u);
+    BOOST_TEST(program.getVariantBytecode(fog, am::ShaderStage::Compute).empty());
+
+    // Skinning without fog wasn't declared reachable
+    BOOST_TEST(!program.findVariant(skinning));
+    BOOST_TEST(program.getVariantBytecode(skinning, am::ShaderStage::Vertex).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
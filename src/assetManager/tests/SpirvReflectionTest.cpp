@@ -0,0 +1,187 @@
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <sstream>
+#include <string_view>
+
+#include "SpirvReflection.hpp"
+#include "../src/assets/shaderAsset/ShaderCompiler.hpp"
+
+namespace
+{
+    // Writes instructions straight into words, ids are picked by the test
+    class SpirvBuilder {
+    public:
+        SpirvBuilder() : words{0x07230203, 0x00010600, 0, 64, 0} {}
+
+        void op(uint32_t opcode, std::initializer_list<uint32_t> operands) {
+            words.push_back(static_cast<uint32_t>(operands.size() + 1) << 16 | opcode);
+            words.insert(words.end(), operands.begin(), operands.end());
+        }
+
+        void name(uint32_t id, std::string_view text) {
+            std::vector<uint32_t> packed((text.size() + sizeof(uint32_t)) / sizeof(uint32_t), 0);
+            std::memcpy(packed.data(), text.data(), text.size());
+            words.push_back(static_cast<uint32_t>(packed.size() + 2) << 16 | 5);
+            words.push_back(id);
+            words.insert(words.end(), packed.begin(), packed.end());
+        }
+
+        std::vector<uint32_t> words;
+    };
+
+    std::string readSource(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream source;
+        source << file.rdbuf();
+        return source.str();
+    }
+
+    std::vector<uint32_t> buildModule()
+    {
+        SpirvBuilder spirv;
+        spirv.op(17, {4439});                           // OpCapability MultiView
+
+        spirv.name(5, "ModelPushConstant");
+        spirv.name(10, "cubemapSampler");
+        spirv.name(13, "albedoTex");
+        spirv.name(20, "textures");
+        spirv.name(21, "SceneBlock");
+        spirv.name(23, "");
+
+        spirv.op(72, {5, 0, 35, 0});                    // OpMemberDecorate Offset
+        spirv.op(72, {5, 0, 7, 16});                    // MatrixStride
+        spirv.op(72, {5, 1, 35, 64});
+        spirv.op(71, {10, 34, 1});                      // OpDecorate DescriptorSet
+        spirv.op(71, {10, 33, 0});                      // Binding
+        spirv.op(71, {13, 34, 1});
+        spirv.op(71, {13, 33, 1});
+        spirv.op(71, {20, 34, 0});
+        spirv.op(71, {20, 33, 3});
+        spirv.op(72, {21, 0, 35, 0});
+        spirv.op(71, {23, 34, 0});
+        spirv.op(71, {23, 33, 0});
+        spirv.op(71, {24, 6, 16});                      // ArrayStride
+        spirv.op(72, {25, 0, 35, 0});
+        spirv.op(71, {27, 34, 3});
+        spirv.op(71, {27, 33, 1});
+        spirv.op(71, {29, 30, 0});                      // Location
+        spirv.op(71, {30, 30, 2});
+        spirv.op(71, {31, 11, 42});                     // BuiltIn VertexIndex
+
+        spirv.op(22, {1, 32});                          // float
+        spirv.op(23, {2, 1, 4});                        // vec4
+        spirv.op(24, {3, 2, 4});                        // mat4
+        spirv.op(21, {4, 32, 1});                       // int
+        spirv.op(30, {5, 3, 4});                        // struct { mat4; int; }
+        spirv.op(32, {6, 9, 5});                        // PushConstant pointer
+        spirv.op(59, {6, 7, 9});
+
+        spirv.op(26, {8});                              // sampler
+        spirv.op(32, {9, 0, 8});
+        spirv.op(59, {9, 10, 0});
+        spirv.op(25, {11, 1, 3, 0, 0, 0, 1, 0});        // textureCube
+        spirv.op(32, {12, 0, 11});
+        spirv.op(59, {12, 13, 0});
+        spirv.op(25, {14, 1, 1, 0, 0, 0, 1, 0});        // texture2D
+        spirv.op(27, {15, 14});                         // sampler2D
+        spirv.op(43, {4, 17, 4});                       // int 4
+        spirv.op(28, {18, 15, 17});                     // sampler2D[4]
+        spirv.op(32, {19, 0, 18});
+        spirv.op(59, {19, 20, 0});
+
+        spirv.op(30, {21, 2});                          // uniform block
+        spirv.op(32, {22, 2, 21});
+        spirv.op(59, {22, 23, 2});
+        spirv.op(29, {24, 2});                          // vec4[]
+        spirv.op(30, {25, 24});                         // storage block
+        spirv.op(32, {26, 12, 25});
+        spirv.op(59, {26, 27, 12});
+
+        spirv.op(32, {28, 1, 2});                       // Input pointers
+        spirv.op(59, {28, 29, 1});
+        spirv.op(59, {28, 30, 1});
+        spirv.op(32, {32, 1, 4});
+        spirv.op(59, {32, 31, 1});
+        return spirv.words;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(SpirvReflectionTests)
+
+BOOST_AUTO_TEST_CASE(ReflectsBindingsPushConstantsAndInputs) {
+    const auto reflection = am::reflectSpirv(buildModule());
+    BOOST_REQUIRE(reflection);
+
+    const auto& bindings = reflection->bindings;
+    BOOST_REQUIRE_EQUAL(bindings.size(), 5u);
+
+    BOOST_TEST(bindings[0].set == 0u);
+    BOOST_TEST(bindings[0].binding == 0u);
+    BOOST_TEST((bindings[0].type == am::ShaderResourceType::UniformBuffer));
+    BOOST_TEST(bindings[0].name == "SceneBlock");
+
+    BOOST_TEST(bindings[1].binding == 3u);
+    BOOST_TEST((bindings[1].type == am::ShaderResourceType::CombinedImageSampler));
+    BOOST_TEST((bindings[1].dimension == am::ShaderImageDimension::Dim2D));
+    BOOST_TEST(bindings[1].count == 4u);
+
+    BOOST_TEST(bindings[2].set == 1u);
+    BOOST_TEST((bindings[2].type == am::ShaderResourceType::Sampler));
+    BOOST_TEST(bindings[2].name == "cubemapSampler");
+
+    BOOST_TEST((bindings[3].type == am::ShaderResourceType::SampledImage));
+    BOOST_TEST((bindings[3].dimension == am::ShaderImageDimension::Cube));
+
+    BOOST_TEST(bindings[4].set == 3u);
+    BOOST_TEST((bindings[4].type == am::ShaderResourceType::StorageBuffer));
+    BOOST_TEST(bindings[4].count == 1u);
+
+    BOOST_TEST(reflection->getSetMask() == 0b1011u);
+    BOOST_REQUIRE(reflection->pushConstants);
+    BOOST_TEST(reflection->pushConstants->name == "ModelPushConstant");
+    BOOST_TEST(reflection->pushConstants->size == 68u);
+    BOOST_TEST(reflection->inputLocations == 0b101u);
+    BOOST_TEST(reflection->multiview);
+}
+
+BOOST_AUTO_TEST_CASE(RejectsBrokenModules) {
+    auto words = buildModule();
+    words[0] = 0;
+    BOOST_TEST(!am::reflectSpirv(words));
+
+    words = buildModule();
+    words.resize(words.size() - 1);
+    BOOST_TEST(!am::reflectSpirv(words));
+    BOOST_TEST(!am::reflectSpirv({}));
+}
+
+BOOST_AUTO_TEST_CASE(ReflectsRepositoryShaders) {
+    const std::filesystem::path entry("res/shaders/glsl/entry");
+    BOOST_REQUIRE(std::filesystem::exists(entry));
+    const am::ShaderCompiler compiler(entry, {});
+
+    auto skybox = compiler.compile(readSource(entry / "skybox.frag"), am::ShaderStage::Fragment);
+    BOOST_REQUIRE(skybox);
+    const auto skyboxReflection = am::reflectSpirv(skybox->getBytecode());
+    BOOST_REQUIRE(skyboxReflection);
+    BOOST_TEST((skyboxReflection->getSetMask() & 0b10u) != 0u);
+    BOOST_TEST(std::ranges::any_of(skyboxReflection->bindings, [](const am::ShaderResourceBinding& binding) {
+        return binding.set == 1 && binding.dimension == am::ShaderImageDimension::Cube;
+    }));
+
+    auto shadowCube = compiler.compile(readSource(entry / "shadowCubeMap.vert"), am::ShaderStage::Vertex);
+    BOOST_REQUIRE(shadowCube);
+    const auto shadowReflection = am::reflectSpirv(shadowCube->getBytecode());
+    BOOST_REQUIRE(shadowReflection);
+    BOOST_TEST(shadowReflection->multiview);
+    BOOST_TEST(shadowReflection->inputLocations == 0b1u);
+    BOOST_REQUIRE(shadowReflection->pushConstants);
+    BOOST_TEST(shadowReflection->pushConstants->name == "LightModelPushConstant");
+    BOOST_TEST(shadowReflection->pushConstants->size == 80u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
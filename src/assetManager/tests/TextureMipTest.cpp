@@ -0,0 +1,120 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include "../src/assets/textureAsset/TextureMipGenerator.hpp"
+
+namespace
+{
+    uint32_t packRGBA(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+    {
+        uint32_t texel;
+        const uint8_t bytes[4] = {r, g, b, a};
+        std::memcpy(&texel, bytes, 4);
+        return texel;
+    }
+
+    uint8_t channel(uint32_t texel, int index)
+    {
+        uint8_t bytes[4];
+        std::memcpy(bytes, &texel, 4);
+        return bytes[index];
+    }
+
+    // Fraction of the level's texels an alpha test at 0.5 keeps
+    float coverage(const am::TextureData& data, uint32_t level)
+    {
+        const auto& mip = data.mips[level];
+        const size_t texels = static_cast<size_t>(mip.width) * mip.height;
+        size_t covered = 0;
+        for (size_t i = 0; i < texels; ++i)
+            if (channel(data.pixels[mip.offset + i], 3) > 127)
+                ++covered;
+        return static_cast<float>(covered) / static_cast<float>(texels);
+    }
+
+    am::TextureData makeTexture(uint32_t width, uint32_t height, uint32_t texel)
+    {
+        am::TextureData data;
+        data.width = width;
+        data.height = height;
+        data.channels = 4;
+        data.type = am::TextureType::Texture2D;
+        data.pixels.assign(static_cast<size_t>(width) * height, texel);
+        return data;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(TextureMipTests)
+
+BOOST_AUTO_TEST_CASE(ChainLayoutCoversAllLevels) {
+    auto data = makeTexture(8, 4, packRGBA(10, 20, 30, 255));
+    am::TextureMipGenerator::generate(data);
+
+    BOOST_REQUIRE_EQUAL(data.mipLevels(), 4u);
+    BOOST_TEST(data.mips[1].width == 4u);
+    BOOST_TEST(data.mips[3].width == 1u);
+    BOOST_TEST(data.mips[3].height == 1u);
+    BOOST_TEST(data.pixels.size() == 32u + 8u + 2u + 1u);
+    BOOST_TEST(data.mips[3].offset == 42u);
+}
+
+BOOST_AUTO_TEST_CASE(ConstantColorIsPreserved) {
+    for (auto filter : {am::MipFilter::Box, am::MipFilter::Kaiser}) {
+        auto data = makeTexture(16, 16, packRGBA(200, 100, 50, 255));
+        data.mipFilter = filter;
+        am::TextureMipGenerator::generate(data);
+
+        const uint32_t last = data.pixels[data.mips.back().offset];
+        BOOST_TEST(channel(last, 0) == 200);
+        BOOST_TEST(channel(last, 1) == 100);
+        BOOST_TEST(channel(last, 2) == 50);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SrgbAveragingIsGammaCorrect) {
+    // Black and white checkerboard averages to linear 0.5, which is ~188 in sRGB
+    auto data = makeTexture(2, 2, packRGBA(0, 0, 0, 255));
+    data.pixels[1] = packRGBA(255, 255, 255, 255);
+    data.pixels[2] = packRGBA(255, 255, 255, 255);
+    data.mipFilter = am::MipFilter::Box;
+    am::TextureMipGenerator::generate(data);
+
+    BOOST_TEST(channel(data.pixels[data.mips[1].offset], 0) == 188);
+
+    data.pixels.resize(4);
+    data.srgb = false;
+    am::TextureMipGenerator::generate(data);
+    BOOST_TEST(channel(data.pixels[data.mips[1].offset], 0) == 128);
+}
+
+BOOST_AUTO_TEST_CASE(AlphaCoverageIsPreserved) {
+    // Alpha noise in [0, 0.7] is about 28% over the cutoff. Averaging pulls every texel towards 0.35, so without
+    // preservation the smaller levels lose nearly all of it
+    auto data = makeTexture(64, 64, 0);
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> alpha(0, 178);
+    for (auto& texel : data.pixels)
+        texel = packRGBA(255, 255, 255, static_cast<uint8_t>(alpha(rng)));
+    data.hasAlpha = true;
+    data.mipFilter = am::MipFilter::Box;
+    auto unpreserved = data;
+    unpreserved.alphaCutoff = 0.0f;
+    am::TextureMipGenerator::generate(data);
+    am::TextureMipGenerator::generate(unpreserved);
+
+    const float base = coverage(data, 0);
+    BOOST_REQUIRE(base > 0.2f);
+    for (uint32_t level = 1; level < data.mipLevels(); ++level) {
+        const auto& mip = data.mips[level];
+        const size_t texels = static_cast<size_t>(mip.width) * mip.height;
+        // Below 4x4 a single texel moves coverage too far for a meaningful comparison
+        if (texels < 16)
+            break;
+        // One texel of quantization on top of the 8 bit rounding of the scaled alpha
+        BOOST_TEST(std::abs(coverage(data, level) - base) <= 0.05f + 1.0f / texels, "level " << level);
+    }
+    BOOST_TEST(coverage(unpreserved, 3) < base / 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
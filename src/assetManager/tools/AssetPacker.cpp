@@ -0,0 +1,54 @@
+//
+// Created by redkc on 19/10/2026.
+// Packs every asset of the registry into one archive. The runtime mounts each .pak next to the registry on startup,
+// so the default output is picked up without any further setup
+//
+
+#include <cstdlib>
+#include <filesystem>
+#include <string_view>
+#include <spdlog/spdlog.h>
+
+#include "AssetManager.hpp"
+
+namespace
+{
+    void printUsage()
+    {
+        spdlog::info("Usage: am_pack [output.pak] [--lz4] [--compress-binary]");
+        spdlog::info("  output.pak         Archive to write, assets.pak next to the registry by default");
+        spdlog::info("  --lz4              Compress entries that shrink enough");
+        spdlog::info("  --compress-binary  Compress binary containers too, they can't be used in place after that");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    am::AssetManager& assetManager = am::AssetManager::getInstance();
+
+    std::string output = (std::filesystem::path(assetManager.getRegistryDirectory()) / "assets.pak").string();
+    am::AssetArchive::BuildSettings settings;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument = argv[i];
+        if (argument == "--lz4") {
+            settings.compression = am::ArchiveCompression::LZ4;
+        } else if (argument == "--compress-binary") {
+            settings.compressBinaryAssets = true;
+        } else if (argument == "--help" || argument.starts_with("--")) {
+            printUsage();
+            return argument == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        } else {
+            output = argument;
+        }
+    }
+
+    // Archives mounted on startup would shadow the loose files being packed, and the output may be one of them
+    assetManager.unmountArchives();
+
+    spdlog::info("Packing {} assets into {}", assetManager.getRegisteredAssetsUuids().size(), output);
+    if (!assetManager.buildArchive(output, settings)) {
+        spdlog::error("Failed to build {}", output);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,6 +1,11 @@
 #include "Engine.h"
 
+#include <fstream>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
 #include "PlatformInterface.hpp"
+#include "../assetManager/src/assets/engineAssets/PrefabAsset.h"
 #include "../assetManager/src/assets/engineAssets/SceneAsset.h"
 #include "ecs/Scene.h"
 #include "systems/collisionSystem/CollisionSystem.hpp"
@@ -41,6 +46,10 @@ namespace engine {
             [this](const void* /*data*/) {
                 minimized = false;
             });
+
+#ifdef EDITOR_ENABLED
+        assetManagerInterface->enableHotReload();
+#endif
     }
 
     std::shared_ptr<Scene> Engine::CreateScene(const std::string& name) {
@@ -89,6 +98,15 @@ namespace engine {
     }
 
     void Engine::Update(float deltaTime) {
+        // Sources edited since the last frame are reimported before anything draws with them
+        const auto reloaded = assetManagerInterface->pollHotReload();
+        if (!reloaded.empty()) {
+            graphicsEngine->reloadResources(reloaded);
+            for (const auto& id : reloaded) {
+                prefabTemplates.erase(id);
+            }
+        }
+
         if (activeScene) {
             activeScene->Update(deltaTime);
         }
@@ -127,31 +145,89 @@ namespace engine {
         }
         else
         {
-            assetManagerInterface->createAsset(am::AssetType::Scene, "activeScene");
-            assetInfo = assetManagerInterface->getAssetInfo(activeScene->sceneId);
+            auto createdId = assetManagerInterface->createAsset(am::AssetType::Scene, "activeScene");
+            if (createdId)
+            {
+                activeScene->sceneId = *createdId;
+                assetInfo = assetManagerInterface->getAssetInfo(*createdId);
+            }
             if (!assetInfo)
             {
                 spdlog::error("Failed to create scene asset for scene ID: {}", boost::uuids::to_string(activeScene->sceneId).c_str());
                 return;
             }
-        }
-
-        rapidjson::Document* document = sceneAsset->getAssetDataAs<rapidjson::Document>();
-        if (!document)
-        {
-            spdlog::error("Scene asset data is null for scene ID: {}", boost::uuids::to_string(activeScene->sceneId).c_str());
-            return;
+            sceneAsset = dynamic_cast<am::SceneAsset*>(assetInfo->get()->getAsset());
+            if (!sceneAsset)
+            {
+                spdlog::error("Failed to cast asset to SceneAsset for scene ID: {}", boost::uuids::to_string(activeScene->sceneId).c_str());
+                return;
+            }
         }
 
         try
         {
-            activeScene->SerializeToJson(*document);
+            auto binary = activeScene->SerializeToBinary();
+            if (!binary)
+            {
+                return;
+            }
+            sceneAsset->setSceneBinary(std::move(binary));
             assetManagerInterface->saveAsset(assetInfo->get()->id);
         } catch (const std::exception& e) {
             spdlog::error("Error saving scene to file: {}", e.what());
         }
     }
 
+    void Engine::ExportSceneJson(const std::string& path) const
+    {
+        if (!activeScene)
+        {
+            return;
+        }
+        rapidjson::Document document;
+        activeScene->SerializeToJson(document);
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+        document.Accept(writer);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            spdlog::error("Can't open {} to export the scene", path);
+            return;
+        }
+        file.write(buffer.GetString(), static_cast<std::streamsize>(buffer.GetSize()));
+    }
+
+    std::shared_ptr<const PrefabTemplate> Engine::GetPrefab(const boost::uuids::uuid& prefabId)
+    {
+        if (auto it = prefabTemplates.find(prefabId); it != prefabTemplates.end())
+        {
+            return it->second;
+        }
+        if (!activeScene)
+        {
+            spdlog::error("Prefab {} requested without an active scene", boost::uuids::to_string(prefabId));
+            return nullptr;
+        }
+
+        auto assetInfo = assetManagerInterface->getAssetInfo(prefabId);
+        auto prefabAsset = assetInfo ? dynamic_cast<am::PrefabAsset*>(assetInfo->get()->getAsset()) : nullptr;
+        if (!prefabAsset)
+        {
+            spdlog::error("Asset {} is not a prefab", boost::uuids::to_string(prefabId));
+            return nullptr;
+        }
+
+        auto compiled = activeScene->CompilePrefab(*prefabAsset->getAssetDataAs<rapidjson::Document>());
+        if (compiled)
+        {
+            prefabTemplates[prefabId] = compiled;
+        }
+        return compiled;
+    }
+
     void Engine::LoadScene(boost::uuids::uuid sceneId)
     {
         if (!activeScene)
@@ -174,7 +250,13 @@ namespace engine {
         }
 
         try {
-
+            if (const auto& binary = sceneAsset->getSceneBinary()) {
+                auto reader = am::BinaryContainerReader::open(binary, binary->bytes(), ecs::kSceneBinaryKind);
+                if (!reader || !activeScene->DeserializeFromBinary(*reader)) {
+                    spdlog::error("Failed to load binary scene {}", boost::uuids::to_string(sceneId).c_str());
+                }
+                return;
+            }
 
             rapidjson::Document* document = sceneAsset->getAssetDataAs<rapidjson::Document>();
             if (document) {
@@ -8,17 +8,20 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <boost/functional/hash.hpp>
 #include <rapidjson/prettywriter.h>
 #include <spdlog/spdlog.h>
 
 #include "AssetManagerInterface.h"
 #include "GraphicsEngine.hpp"
 #include "ecs/componentArrays/IntegralComponentArray.h"
+#include "ecs/componentArrays/TransformComponentArray.h"
 #include "ecs/componentArrays/ComponentArray.h"
 
 namespace engine {
     namespace ecs
     {
+        struct PrefabTemplate;
         class SystemBase;
         struct TransformComponent;
         class Scene;
@@ -62,6 +65,11 @@ namespace engine {
 
         void SaveScene();
         void LoadScene(boost::uuids::uuid sceneId);
+        // Readable copy of the active scene for diffs and debugging, scenes themselves are saved as binary
+        void ExportSceneJson(const std::string& path) const;
+
+        // Compiled against the active scene on first use, dropped when the prefab asset is hot reloaded
+        std::shared_ptr<const PrefabTemplate> GetPrefab(const boost::uuids::uuid& prefabId);
 
         // Get registered types
         const std::set<std::type_index>& GetRegisteredComponentTypes() const { return componentTypes; }
@@ -76,6 +84,8 @@ namespace engine {
 
         std::unordered_map<std::string, std::shared_ptr<Scene>> scenes;
         std::shared_ptr<Scene> activeScene = nullptr;
+
+        std::unordered_map<boost::uuids::uuid, std::shared_ptr<const PrefabTemplate>, boost::hash<boost::uuids::uuid>> prefabTemplates;
     };
 
 
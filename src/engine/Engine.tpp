@@ -7,7 +7,7 @@ void Engine::RegisterComponentType()
     componentTypes.insert(type);
     componentFactories[type] = []() -> std::shared_ptr<IComponentArray> {
         if constexpr (std::is_same_v<T, TransformComponent>) {
-            return std::make_shared<IntegralComponentArray<T>>();
+            return std::make_shared<TransformComponentArray>();
         } else {
             return std::make_shared<ComponentArray<T>>();
         }
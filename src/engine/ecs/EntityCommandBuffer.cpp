@@ -0,0 +1,36 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "EntityCommandBuffer.h"
+
+#include <utility>
+
+namespace engine::ecs
+{
+    Entity EntityCommandBuffer::CreateEntity(Entity parentEntity, TransformComponent transform)
+    {
+        std::lock_guard lock(mutex);
+        const auto index = static_cast<Entity>(commands.creates.size());
+        commands.creates.push_back({parentEntity, std::move(transform)});
+        return kDeferredBit | index;
+    }
+
+    void EntityCommandBuffer::DestroyEntity(Entity entity)
+    {
+        std::lock_guard lock(mutex);
+        commands.destroys.push_back(entity);
+    }
+
+    bool EntityCommandBuffer::Empty() const
+    {
+        std::lock_guard lock(mutex);
+        return commands.creates.empty() && commands.adds.empty() && commands.removes.empty() && commands.destroys.empty();
+    }
+
+    EntityCommandBuffer::Commands EntityCommandBuffer::Take()
+    {
+        std::lock_guard lock(mutex);
+        return std::exchange(commands, Commands{});
+    }
+}
@@ -0,0 +1,87 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef ENTITYCOMMANDBUFFER_H
+#define ENTITYCOMMANDBUFFER_H
+
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <vector>
+
+#include "Component.hpp"
+#include "Types.h"
+#include "systems/transformSystem/componets/TransformComponent.hpp"
+
+namespace engine::ecs
+{
+    // Structural changes recorded while systems iterate, from any thread, and applied by Scene::Playback at a sync
+    // point. Playback sorts them into batches: creates first, then adds per component type, then removes, destroys
+    // last, so an entity destroyed in the same buffer ignores whatever else was recorded for it
+    class EntityCommandBuffer
+    {
+    public:
+        static constexpr Entity kNoParent = static_cast<Entity>(-1);
+
+        // Placeholders for entities the buffer creates, usable as entity or parent in later commands of the same buffer
+        static bool IsDeferred(Entity entity) { return entity != kNoParent && (entity & kDeferredBit); }
+        static uint32_t DeferredIndex(Entity entity) { return entity & ~kDeferredBit; }
+
+        Entity CreateEntity(Entity parentEntity = kNoParent, TransformComponent transform = TransformComponent());
+        void DestroyEntity(Entity entity);
+
+        // Adding a component the entity already has is skipped, the last add recorded for an entity wins
+        template<typename T>
+        void AddComponent(Entity entity, T component = T());
+        template<typename T>
+        void RemoveComponent(Entity entity);
+
+        bool Empty() const;
+
+        struct CreateCommand {
+            Entity parent;
+            TransformComponent transform;
+        };
+
+        struct ComponentCommand {
+            std::type_index type;
+            Entity entity;
+            std::unique_ptr<Component> component;     // Null for removes
+        };
+
+        struct Commands {
+            std::vector<CreateCommand> creates;
+            std::vector<ComponentCommand> adds;
+            std::vector<ComponentCommand> removes;
+            std::vector<Entity> destroys;
+        };
+
+        // Everything recorded so far, the buffer is left empty
+        Commands Take();
+
+    private:
+        static constexpr Entity kDeferredBit = 1u << 31;
+        static_assert(MAX_ENTITIES < kDeferredBit, "Entity IDs overlap deferred placeholders");
+
+        mutable std::mutex mutex;
+        Commands commands;
+    };
+
+    template<typename T>
+    void EntityCommandBuffer::AddComponent(Entity entity, T component)
+    {
+        auto copy = std::make_unique<T>(std::move(component));
+        std::lock_guard lock(mutex);
+        commands.adds.push_back({std::type_index(typeid(T)), entity, std::move(copy)});
+    }
+
+    template<typename T>
+    void EntityCommandBuffer::RemoveComponent(Entity entity)
+    {
+        std::lock_guard lock(mutex);
+        commands.removes.push_back({std::type_index(typeid(T)), entity, nullptr});
+    }
+}
+
+#endif //ENTITYCOMMANDBUFFER_H
@@ -0,0 +1,43 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef PREFAB_H
+#define PREFAB_H
+
+#include <memory>
+#include <typeindex>
+#include <vector>
+
+#include "Component.hpp"
+#include "Types.h"
+#include "componentArrays/ComponentType.h"
+
+namespace engine::ecs
+{
+    // A prefab compiled for spawning, built by Scene::CompilePrefab. Components are built from the prefab JSON once,
+    // their type IDs resolved and the hierarchy kept as indices into nodes, so Scene::Instantiate never touches JSON.
+    // Prefab JSON: {"entities": [{"parent": -1, "components": {"<type name>": {...}}}, ...]}, type names as in
+    // scene JSON and every parent listed before its children
+    struct PrefabTemplate {
+        static constexpr uint32_t kNoParent = ~0u;
+
+        struct Node {
+            uint32_t parent = kNoParent;
+            Signature signature;
+        };
+
+        struct Pool {
+            std::type_index type;
+            ComponentTypeID typeId;
+            std::vector<uint32_t> nodes;                            // Nodes having the component, in node order
+            std::vector<std::unique_ptr<Component>> prototypes;     // One per entry of nodes
+        };
+
+        std::vector<Node> nodes;
+        // The transform pool comes first and covers every node, the roots' transforms can be replaced per copy
+        std::vector<Pool> pools;
+    };
+}
+
+#endif //PREFAB_H
@@ -9,6 +9,14 @@
 #include "tracy/Tracy.hpp"
 #include "systems/editorSystem/EditorSystem.hpp"
 
+#include <algorithm>
+#include <spanstream>
+#include <tuple>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <spdlog/spdlog.h>
+#include <boost/uuid/uuid_io.hpp>
+
 
 using namespace engine::ecs;
 
@@ -22,7 +30,7 @@ void Scene::AddComponent(Entity entity, std::type_index typeIdx)
     auto componentID = componentArrays[typeIdx]->AddComponentUntyped(entity);
 
     Signature& signature = entitySignatures[entity];
-    signature.set(GetUniqueComponentTypeID(), true);
+    signature.set(componentArrays[typeIdx]->GetComponentTypeIDUntyped(), true);
 
     // Check each system
     for (auto& [_, system] : systems)
@@ -56,16 +64,16 @@ Scene::Scene(Engine& engine): engine(engine)
 
 #ifdef EDITOR_ENABLED
     RegisterSystem<EditorSystem>();
-    GetSystem<EditorSystem>().get()->RegisterComponentType<TransformComponent>();
-    GetSystem<EditorSystem>().get()->RegisterComponentType<RendererComponent>();
-    GetSystem<EditorSystem>().get()->RegisterComponentType<CameraComponent>();
-    GetSystem<EditorSystem>().get()->RegisterComponentType<LightComponent>();
+    GetSystem<EditorSystem>()->RegisterComponentType<TransformComponent>();
+    GetSystem<EditorSystem>()->RegisterComponentType<RendererComponent>();
+    GetSystem<EditorSystem>()->RegisterComponentType<CameraComponent>();
+    GetSystem<EditorSystem>()->RegisterComponentType<LightComponent>();
 #endif
     RegisterComponent<RendererComponent>(); //For some reason I have to register them in reverse
     RegisterComponent<CameraComponent>();
     RegisterComponent<LightComponent>();
 
-    RegisterIntegralComponent<TransformComponent>();
+    RegisterTransformComponent();
     RegisterSystem<TransformSystem>();
     RegisterSystem<CollisionSystem>();
 
@@ -73,11 +81,16 @@ Scene::Scene(Engine& engine): engine(engine)
 }
 
 void Scene::Update(float deltaTime) {
+    frameArena.beginFrame();
     engine.graphicsEngine->beginFrame();
     for (auto& [_, system] : systems) {
     ZoneTransientN(zoneName,(system->name).c_str(),true);
         system->Update(deltaTime);
     }
+    // Structural changes recorded while the systems iterated
+    if (!commandBuffer.Empty()) {
+        Playback(commandBuffer);
+    }
     engine.graphicsEngine->endFrame();
 }
 
@@ -86,7 +99,7 @@ Entity Scene::CreateEntity(Entity parentEntity)
     return CreateEntity(TransformComponent(),parentEntity);
 }
 
-const std::unordered_map<std::type_index, std::shared_ptr<SystemBase>> Scene::GetSystems()
+const std::unordered_map<std::type_index, std::shared_ptr<SystemBase>>& Scene::GetSystems() const
 {
     return systems;
 }
@@ -122,6 +135,7 @@ void Scene::SetParent(Entity child, Entity parent) {
     // Set new parent
     sceneGraph[child].parent = parent;
     sceneGraph[parent].children.push_back(child);
+    GetTransformArray()->MarkDirty(child);
 
     // Remove child from rootEntities because it now has a parent
     rootEntities.erase(std::remove(rootEntities.begin(), rootEntities.end(), child), rootEntities.end());
@@ -139,6 +153,7 @@ void Scene::RemoveParent(Entity child) {
 
         // Add child to rootEntities since it lost its parent
         rootEntities.push_back(child);
+        GetTransformArray()->MarkDirty(child);
     }
 }
 
@@ -163,31 +178,9 @@ bool Scene::HasParent(Entity entity) const {
 
 
 Entity Scene::CreateEntity(TransformComponent transform ,Entity parentEntity ) {
-    Entity entity;
-    if (!freeEntities.empty()) {
-        entity = freeEntities.front();
-        freeEntities.pop();
-    } else {
-        entity = maxEntityIndex++;
-    }
-
-    AddComponent<TransformComponent>(entity, transform);
-
-    if (parentEntity == -1)
-    {
-        rootEntities.push_back(entity);
-    }else
-    {
-        auto parentNode = sceneGraph.find(parentEntity);
-        parentNode->second.children.push_back(entity);
-    }
-
-    auto signature = Signature{};
-    signature.set(GetComponentTypeID<TransformComponent>());
-    entitySignatures[entity] = signature;
-
-    activeEntities.set(entity, true);
-    return entity;
+    const auto created = CreateEntitiesBatch({&transform, 1}, {&parentEntity, 1});
+    assert(!created.empty() && "MAX_ENTITIES reached");
+    return created.front();
 }
 
 Entity Scene::CreateEntity(std::string entityName, Entity parentEntity)
@@ -198,30 +191,449 @@ Entity Scene::CreateEntity(std::string entityName, Entity parentEntity)
 Entity Scene::CreateEntity(std::string entityName, TransformComponent transform,  Entity parentEntity)
 {
     auto entity = CreateEntity(transform,parentEntity);
-    GetSystem<engine::ecs::EditorSystem>().get()->SetEntityName(entity,entityName);
+    // Names only live in the editor
+    if (auto* editorSystem = GetSystem<EditorSystem>()) {
+        editorSystem->SetEntityName(entity,entityName);
+    }
     return entity;
 }
 
 void Scene::DestroyEntity(Entity entity) {
-    Signature signature = entitySignatures[entity]; // Get entity signature
-    std::type_index componentIndex(typeid(void)); // Initialize with a dummy type
-    for (size_t i = 0; i < signature.size(); ++i) {
-        if (signature.test(i)) {
-            componentIndex = GetTypeFromIndex(i);
-            auto& array = componentArrays[componentIndex];
-            array->RemoveComponentUntyped(entity);
+    DestroyEntities({&entity, 1});
+}
+
+std::vector<Entity> Scene::CreateEntities(std::span<const TransformComponent> transforms, Entity parentEntity) {
+    const std::vector<Entity> parents(transforms.size(), parentEntity);
+    return CreateEntitiesBatch(transforms, parents);
+}
+
+bool Scene::AcquireEntities(std::span<Entity> entities) {
+    if (freeEntities.size() + (MAX_ENTITIES - maxEntityIndex) < entities.size()) {
+        spdlog::error("Creating {} entities would exceed MAX_ENTITIES", entities.size());
+        return false;
+    }
+    for (Entity& entity : entities) {
+        if (!freeEntities.empty()) {
+            entity = freeEntities.front();
+            freeEntities.pop();
+        } else {
+            entity = maxEntityIndex++;
+        }
+        // Recycled IDs may still have the graph node of the entity they belonged to
+        if (auto graphNode = sceneGraph.find(entity); graphNode != sceneGraph.end()) {
+            graphNode->second = TransformNode{};
+        }
+    }
+    return true;
+}
+
+std::vector<Entity> Scene::CreateEntitiesBatch(std::span<const TransformComponent> transforms, std::span<const Entity> parents) {
+    ZoneScoped;
+    assert(parents.size() == transforms.size());
+    const std::type_index transformType(typeid(TransformComponent));
+    auto transformArray = componentArrays.find(transformType);
+    std::vector<Entity> entities(transforms.size());
+    if (transformArray == componentArrays.end() || !AcquireEntities(entities)) {
+        return {};
+    }
+
+    entitySignatures.reserve(entitySignatures.size() + entities.size());
+    std::vector<const Component*> components(entities.size());
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const Entity entity = entities[i];
+        entitySignatures[entity] = Signature{};
+        activeEntities.set(entity, true);
+        components[i] = &transforms[i];
+
+        Entity parent = parents[i];
+        if (EntityCommandBuffer::IsDeferred(parent)) {
+            const uint32_t index = EntityCommandBuffer::DeferredIndex(parent);
+            parent = index < i ? entities[index] : EntityCommandBuffer::kNoParent;
+        }
+        if (parent != EntityCommandBuffer::kNoParent && !entitySignatures.contains(parent)) {
+            spdlog::warn("Entity {} created under missing parent {}, it is a root instead", entity, parent);
+            parent = EntityCommandBuffer::kNoParent;
+        }
+        if (parent == EntityCommandBuffer::kNoParent) {
+            rootEntities.push_back(entity);
+        } else {
+            sceneGraph[entity].parent = parent;
+            sceneGraph[parent].children.push_back(entity);
+        }
+    }
+    AddComponentsBatch(*transformArray->second, transformType, entities, components);
+    return entities;
+}
+
+void Scene::DestroyEntities(std::span<const Entity> entities) {
+    ZoneScoped;
+    // Sorted and unique, an entity listed twice is destroyed once
+    std::vector<Entity> destroyed(entities.begin(), entities.end());
+    std::ranges::sort(destroyed);
+    destroyed.erase(std::unique(destroyed.begin(), destroyed.end()), destroyed.end());
+    std::erase_if(destroyed, [this](Entity entity) { return !entitySignatures.contains(entity); });
+    if (destroyed.empty()) {
+        return;
+    }
+
+    std::vector<Entity> holders;
+    for (auto& [type, array] : componentArrays) {
+        const ComponentTypeID typeId = array->GetComponentTypeIDUntyped();
+        holders.clear();
+        for (Entity entity : destroyed) {
+            if (entitySignatures.at(entity).test(typeId)) {
+                holders.push_back(entity);
+            }
+        }
+        if (!holders.empty()) {
+            RemoveComponentsBatch(*array, type, holders);
         }
     }
-    entitySignatures.erase(entity);
-    activeEntities.reset(entity);
 
+    std::bitset<MAX_ENTITIES> isDestroyed;
+    for (Entity entity : destroyed) {
+        isDestroyed.set(entity);
+    }
+    for (Entity entity : destroyed) {
+        auto graphNode = sceneGraph.find(entity);
+        if (graphNode == sceneGraph.end()) {
+            continue;
+        }
+        const Entity parent = graphNode->second.parent;
+        if (parent != MAX_ENTITIES && !isDestroyed.test(parent)) {
+            std::erase(sceneGraph[parent].children, entity);
+        }
+        for (Entity child : graphNode->second.children) {
+            if (!isDestroyed.test(child)) {
+                sceneGraph[child].parent = MAX_ENTITIES;
+                rootEntities.push_back(child);
+            }
+        }
+        sceneGraph.erase(graphNode);
+    }
+    std::erase_if(rootEntities, [&isDestroyed](Entity entity) { return entity < MAX_ENTITIES && isDestroyed.test(entity); });
+
+    for (Entity entity : destroyed) {
+        entitySignatures.erase(entity);
+        activeEntities.reset(entity);
+        freeEntities.push(entity);  // add ID back for reuse
+    }
+}
+
+void Scene::AddComponentsBatch(IComponentArray& array, const std::type_index& type, std::span<const Entity> entities,
+                               std::span<const Component* const> components) {
+    std::vector<ComponentID> ids(entities.size());
+    array.AddComponentsUntyped(entities, components, ids);
+
+    const ComponentTypeID typeId = array.GetComponentTypeIDUntyped();
+    for (Entity entity : entities) {
+        entitySignatures[entity].set(typeId, true);
+    }
+    // Systems are matched once per batch instead of once per component
+    for (auto& [_, system] : systems) {
+        if (std::ranges::find(system->registeredComponentTypes, type) == system->registeredComponentTypes.end()) {
+            continue;
+        }
+        for (ComponentID id : ids) {
+            system->AddComponent(id, type);
+        }
+    }
+}
+
+void Scene::RemoveComponentsBatch(IComponentArray& array, const std::type_index& type, std::span<const Entity> entities) {
+    std::vector<ComponentID> ids(entities.size());
+    array.RemoveComponentsUntyped(entities, ids);
+
+    const ComponentTypeID typeId = array.GetComponentTypeIDUntyped();
+    for (Entity entity : entities) {
+        entitySignatures[entity].set(typeId, false);
+    }
     for (auto& [_, system] : systems) {
-        system->RemoveComponent(entity,componentIndex);
+        if (std::ranges::find(system->registeredComponentTypes, type) == system->registeredComponentTypes.end()) {
+            continue;
+        }
+        for (ComponentID id : ids) {
+            system->RemoveComponent(id, type);
+        }
     }
+}
+
+std::vector<Entity> Scene::Playback(EntityCommandBuffer& buffer) {
+    ZoneScoped;
+    EntityCommandBuffer::Commands commands = buffer.Take();
+
+    std::vector<Entity> created;
+    if (!commands.creates.empty()) {
+        std::vector<TransformComponent> transforms;
+        std::vector<Entity> parents;
+        transforms.reserve(commands.creates.size());
+        parents.reserve(commands.creates.size());
+        for (auto& create : commands.creates) {
+            transforms.push_back(std::move(create.transform));
+            parents.push_back(create.parent);
+        }
+        created = CreateEntitiesBatch(transforms, parents);
+        if (created.empty()) {
+            spdlog::error("Dropped {} recorded entities and the commands using them", commands.creates.size());
+        }
+    }
+    // Placeholders resolve to MAX_ENTITIES if their entity couldn't be created
+    auto resolve = [&created](Entity entity) {
+        if (!EntityCommandBuffer::IsDeferred(entity)) {
+            return entity;
+        }
+        const uint32_t index = EntityCommandBuffer::DeferredIndex(entity);
+        return index < created.size() ? created[index] : MAX_ENTITIES;
+    };
+
+    std::vector<Entity> destroyed;
+    destroyed.reserve(commands.destroys.size());
+    for (Entity entity : commands.destroys) {
+        destroyed.push_back(resolve(entity));
+    }
+    std::ranges::sort(destroyed);
+    auto alive = [&](Entity entity) {
+        return entitySignatures.contains(entity) && !std::ranges::binary_search(destroyed, entity);
+    };
+
+    // Adds, one batch per type in entity order
+    for (auto& add : commands.adds) {
+        add.entity = resolve(add.entity);
+    }
+    auto byTypeAndEntity = [](const EntityCommandBuffer::ComponentCommand& a, const EntityCommandBuffer::ComponentCommand& b) {
+        return std::tie(a.type, a.entity) < std::tie(b.type, b.entity);
+    };
+    std::ranges::stable_sort(commands.adds, byTypeAndEntity);
+    std::vector<Entity> batchEntities;
+    std::vector<const Component*> batchComponents;
+    for (size_t begin = 0; begin < commands.adds.size();) {
+        const std::type_index type = commands.adds[begin].type;
+        size_t end = begin;
+        while (end < commands.adds.size() && commands.adds[end].type == type) {
+            ++end;
+        }
+        auto array = componentArrays.find(type);
+        if (array == componentArrays.end()) {
+            spdlog::warn("Dropped {} adds of unregistered component {}", end - begin, type.name());
+            begin = end;
+            continue;
+        }
+
+        const ComponentTypeID typeId = array->second->GetComponentTypeIDUntyped();
+        batchEntities.clear();
+        batchComponents.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const auto& add = commands.adds[i];
+            // The last add recorded for an entity wins
+            if (i + 1 < end && commands.adds[i + 1].entity == add.entity) {
+                continue;
+            }
+            if (!alive(add.entity)) {
+                continue;
+            }
+            if (entitySignatures.at(add.entity).test(typeId)) {
+                spdlog::warn("Entity {} already has a {}, the recorded add is skipped", add.entity, type.name());
+                continue;
+            }
+            batchEntities.push_back(add.entity);
+            batchComponents.push_back(add.component.get());
+        }
+        if (batchEntities.size() > array->second->GetCapacityLeft()) {
+            spdlog::error("Dropped {} adds of {}, its array is full", batchEntities.size() - array->second->GetCapacityLeft(),
+                          type.name());
+            batchEntities.resize(array->second->GetCapacityLeft());
+            batchComponents.resize(batchEntities.size());
+        }
+        if (!batchEntities.empty()) {
+            AddComponentsBatch(*array->second, type, batchEntities, batchComponents);
+        }
+        begin = end;
+    }
+
+    // Removes, one batch per type. Destroyed entities lose their components with the destroy
+    for (auto& remove : commands.removes) {
+        remove.entity = resolve(remove.entity);
+    }
+    std::ranges::sort(commands.removes, byTypeAndEntity);
+    for (size_t begin = 0; begin < commands.removes.size();) {
+        const std::type_index type = commands.removes[begin].type;
+        size_t end = begin;
+        while (end < commands.removes.size() && commands.removes[end].type == type) {
+            ++end;
+        }
+        auto array = componentArrays.find(type);
+        if (array != componentArrays.end()) {
+            const ComponentTypeID typeId = array->second->GetComponentTypeIDUntyped();
+            batchEntities.clear();
+            for (size_t i = begin; i < end; ++i) {
+                const Entity entity = commands.removes[i].entity;
+                if ((batchEntities.empty() || batchEntities.back() != entity) && alive(entity) &&
+                    entitySignatures.at(entity).test(typeId)) {
+                    batchEntities.push_back(entity);
+                }
+            }
+            if (!batchEntities.empty()) {
+                RemoveComponentsBatch(*array->second, type, batchEntities);
+            }
+        }
+        begin = end;
+    }
+
+    DestroyEntities(destroyed);
+    return created;
+}
+
 
-    freeEntities.push(entity);  // add ID back for reuse
+
+std::shared_ptr<const PrefabTemplate> Scene::CompilePrefab(const rapidjson::Value& prefab) const {
+    ZoneScoped;
+    auto fail = [](std::string_view reason) -> std::shared_ptr<const PrefabTemplate> {
+        spdlog::error("Malformed prefab: {}", reason);
+        return nullptr;
+    };
+    if (!prefab.IsObject() || !prefab.HasMember("entities") || !prefab["entities"].IsArray()) {
+        return fail("no entities array");
+    }
+
+    const std::type_index transformType(typeid(TransformComponent));
+    auto transformArray = componentArrays.find(transformType);
+    if (transformArray == componentArrays.end()) {
+        return fail("scene has no transform array");
+    }
+
+    auto compiled = std::make_shared<PrefabTemplate>();
+    compiled->pools.push_back({transformType, transformArray->second->GetComponentTypeIDUntyped(), {}, {}});
+    std::unordered_map<std::type_index, size_t> poolIndex{{transformType, 0}};
+
+    const auto& entities = prefab["entities"];
+    compiled->nodes.reserve(entities.Size());
+    for (rapidjson::SizeType i = 0; i < entities.Size(); ++i) {
+        const auto& entity = entities[i];
+        if (!entity.IsObject()) {
+            return fail("entity isn't an object");
+        }
+
+        PrefabTemplate::Node node;
+        if (entity.HasMember("parent") && entity["parent"].IsInt() && entity["parent"].GetInt() >= 0) {
+            if (static_cast<rapidjson::SizeType>(entity["parent"].GetInt()) >= i) {
+                return fail("parent listed after its child");
+            }
+            node.parent = entity["parent"].GetInt();
+        }
+
+        if (entity.HasMember("components")) {
+            if (!entity["components"].IsObject()) {
+                return fail("components isn't an object");
+            }
+            for (auto it = entity["components"].MemberBegin(); it != entity["components"].MemberEnd(); ++it) {
+                const std::string typeName = it->name.GetString();
+                auto array = std::ranges::find_if(componentArrays, [&typeName](const auto& entry) {
+                    return entry.first.name() == typeName;
+                });
+                if (array == componentArrays.end()) {
+                    return fail("unknown component type " + typeName);
+                }
+
+                auto [index, inserted] = poolIndex.try_emplace(array->first, compiled->pools.size());
+                if (inserted) {
+                    compiled->pools.push_back({array->first, array->second->GetComponentTypeIDUntyped(), {}, {}});
+                }
+                PrefabTemplate::Pool& pool = compiled->pools[index->second];
+                if (!pool.nodes.empty() && pool.nodes.back() == i) {
+                    return fail("component " + typeName + " listed twice");
+                }
+                pool.nodes.push_back(i);
+                pool.prototypes.push_back(array->second->CreatePrototypeFromJson(it->value));
+                node.signature.set(pool.typeId);
+            }
+        }
+
+        // Every entity has a transform, like the ones CreateEntity makes
+        PrefabTemplate::Pool& transforms = compiled->pools.front();
+        if (transforms.nodes.empty() || transforms.nodes.back() != i) {
+            transforms.nodes.push_back(i);
+            transforms.prototypes.push_back(std::make_unique<TransformComponent>());
+            node.signature.set(transforms.typeId);
+        }
+        compiled->nodes.push_back(node);
+    }
+    return compiled;
+}
+
+std::vector<Entity> Scene::Instantiate(const boost::uuids::uuid& prefabId, size_t count, std::span<const TransformComponent> transforms) {
+    const auto prefab = engine.GetPrefab(prefabId);
+    if (!prefab) {
+        spdlog::error("Prefab {} is unavailable, nothing was instantiated", boost::uuids::to_string(prefabId));
+        return {};
+    }
+    return Instantiate(*prefab, count, transforms);
 }
 
+std::vector<Entity> Scene::Instantiate(const PrefabTemplate& prefab, size_t count, std::span<const TransformComponent> transforms) {
+    ZoneScoped;
+    const size_t nodeCount = prefab.nodes.size();
+    const size_t entityCount = nodeCount * count;
+    if (entityCount == 0) {
+        return {};
+    }
+    if (!transforms.empty() && transforms.size() != count) {
+        spdlog::error("Instantiating {} prefab copies with {} transforms", count, transforms.size());
+        return {};
+    }
+    // Everything is resolved and checked before the first entity is taken
+    std::vector<IComponentArray*> arrays;
+    arrays.reserve(prefab.pools.size());
+    for (const auto& pool : prefab.pools) {
+        auto array = componentArrays.find(pool.type);
+        if (array == componentArrays.end() || array->second->GetCapacityLeft() < pool.nodes.size() * count) {
+            spdlog::error("Instantiating {} prefab copies doesn't fit the {} array", count, pool.type.name());
+            return {};
+        }
+        arrays.push_back(array->second.get());
+    }
+
+    std::vector<Entity> entities(entityCount);
+    if (!AcquireEntities(entities)) {
+        return {};
+    }
+
+    entitySignatures.reserve(entitySignatures.size() + entityCount);
+    for (size_t copy = 0; copy < count; ++copy) {
+        const Entity* copyEntities = entities.data() + copy * nodeCount;
+        for (size_t node = 0; node < nodeCount; ++node) {
+            const Entity entity = copyEntities[node];
+            entitySignatures[entity] = prefab.nodes[node].signature;
+            activeEntities.set(entity, true);
+
+            const uint32_t parent = prefab.nodes[node].parent;
+            if (parent == PrefabTemplate::kNoParent) {
+                rootEntities.push_back(entity);
+            } else {
+                sceneGraph[entity].parent = copyEntities[parent];
+                sceneGraph[copyEntities[parent]].children.push_back(entity);
+            }
+        }
+    }
+
+    std::vector<Entity> poolEntities;
+    std::vector<const Component*> prototypes;
+    for (size_t poolIndex = 0; poolIndex < prefab.pools.size(); ++poolIndex) {
+        const PrefabTemplate::Pool& pool = prefab.pools[poolIndex];
+        const bool replaceRoots = poolIndex == 0 && !transforms.empty();
+        poolEntities.clear();
+        prototypes.clear();
+        for (size_t copy = 0; copy < count; ++copy) {
+            for (size_t i = 0; i < pool.nodes.size(); ++i) {
+                const uint32_t node = pool.nodes[i];
+                poolEntities.push_back(entities[copy * nodeCount + node]);
+                const bool root = prefab.nodes[node].parent == PrefabTemplate::kNoParent;
+                prototypes.push_back(replaceRoots && root ? &transforms[copy] : pool.prototypes[i].get());
+            }
+        }
+        AddComponentsBatch(*arrays[poolIndex], pool.type, poolEntities, prototypes);
+    }
+    return entities;
+}
 
 void Scene::SetEntityActive(Entity entity, bool active)
 {
@@ -233,7 +645,7 @@ bool Scene::IsEntityActive(Entity entity) const
     return activeEntities[entity];
 }
 
-std::unordered_map<std::type_index, std::shared_ptr<IComponentArray>> Scene::GetComponentArrays()
+const std::unordered_map<std::type_index, std::shared_ptr<IComponentArray>>& Scene::GetComponentArrays() const
 {
     return componentArrays;
 }
@@ -351,82 +763,349 @@ void Scene::SerializeSceneGraph(rapidjson::Value& obj, rapidjson::Document::Allo
 void Scene::DeserializeFromJson(const rapidjson::Document& doc) {
 
     //TODO here are going to be problems if there are different systems
+    ResetForLoad();
+
+    // First, ensure all required components are registered
+    if (doc.HasMember("components") && doc["components"].IsObject()) {
+        for (auto it = doc["components"].MemberBegin(); it != doc["components"].MemberEnd(); ++it) {
+            EnsureComponentArray(it->name.GetString());
+        }
+    }
+
+    // Then, ensure all required systems are registered
+    if (doc.HasMember("systems") && doc["systems"].IsObject()) {
+        for (auto it = doc["systems"].MemberBegin(); it != doc["systems"].MemberEnd(); ++it) {
+            EnsureSystem(it->name.GetString());
+        }
+    }
+
+    // Now proceed with the actual deserialization
+    DeserializeEntities(doc["entities"]);
+    DeserializeComponents(doc["components"]);
+    DeserializeSystems(doc["systems"]);
+    DeserializeSceneGraph(doc["sceneGraph"]);
+}
+
+void Scene::ResetForLoad() {
     sceneGraph.clear();
     componentArrays.clear();
+    componentPools.fill(nullptr);
     rootEntities.clear();
     maxEntityIndex = 0;
     freeEntities = std::queue<Entity>{};
     entitySignatures.clear();
     activeEntities.reset();
     indexToType.clear();
+}
 
-    // First, ensure all required components are registered
-    if (doc.HasMember("components") && doc["components"].IsObject()) {
-        const auto& registeredComponents = engine.GetRegisteredComponentTypes();
+void Scene::EnsureComponentArray(const std::string& typeName) {
+    for (const auto& type : engine.GetRegisteredComponentTypes()) {
+        if (type.name() == typeName) {
+            AddComponent(type);
+            return;
+        }
+    }
+    throw std::runtime_error("Unknown component type in scene file: " + typeName);
+}
 
-        for (auto it = doc["components"].MemberBegin(); it != doc["components"].MemberEnd(); ++it) {
-            std::string typeName = it->name.GetString();
-            bool found = false;
-
-            // Find and register the component if needed
-            for (const auto& type : registeredComponents) {
-                if (type.name() == typeName) {
-                    // Check if component is already registered in scene
-                    if (componentArrays.find(type) == componentArrays.end()) {
-                        // Register the component using type information
-                        AddComponent(type);
-                    }
-                    found = true;
-                    break;
+void Scene::EnsureSystem(const std::string& typeName) {
+    for (const auto& type : engine.GetRegisteredSystemTypes()) {
+        if (type.name() == typeName) {
+            RegisterSystem(type);
+            return;
+        }
+    }
+    throw std::runtime_error("Unknown system type in scene file: " + typeName);
+}
+
+namespace
+{
+    const std::type_index* FindRegisteredType(const std::set<std::type_index>& types, const std::string& typeName)
+    {
+        const auto type = std::ranges::find_if(types, [&typeName](const std::type_index& type) { return type.name() == typeName; });
+        return type != types.end() ? &*type : nullptr;
+    }
+
+    bool IsRegisteredType(const std::set<std::type_index>& types, const std::string& typeName)
+    {
+        return FindRegisteredType(types, typeName) != nullptr;
+    }
+}
+
+std::shared_ptr<const am::MappedFile> Scene::SerializeToBinary() const {
+    ZoneScoped;
+    std::vector<SceneBinaryEntity> entities;
+    std::vector<uint32_t> parents;
+    std::unordered_map<Entity, uint32_t> rows;
+    entities.reserve(entitySignatures.size());
+    parents.reserve(entitySignatures.size());
+
+    auto addRow = [&](Entity entity, uint32_t parentRow, uint32_t flags) -> bool {
+        if (!rows.try_emplace(entity, static_cast<uint32_t>(entities.size())).second) {
+            return false;
+        }
+        auto signature = entitySignatures.find(entity);
+        if (signature != entitySignatures.end()) {
+            flags |= SceneEntityHasSignature;
+        }
+        if (entity < MAX_ENTITIES && activeEntities.test(entity)) {
+            flags |= SceneEntityActive;
+        }
+        entities.push_back({entity, flags, signature != entitySignatures.end() ? signature->second.to_ullong() : 0});
+        parents.push_back(parentRow);
+        return true;
+    };
+
+    // Scene graph order, depth first from the roots, so loading can link every child to a parent it already has
+    std::vector<Entity> stack;
+    for (Entity root : rootEntities) {
+        if (!addRow(root, kSceneNoParent, SceneEntityRoot)) {
+            continue;
+        }
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const Entity parent = stack.back();
+            stack.pop_back();
+            const uint32_t parentRow = rows.at(parent);
+            const auto& children = GetChildren(parent);
+            for (auto child = children.rbegin(); child != children.rend(); ++child) {
+                if (addRow(*child, parentRow, 0)) {
+                    stack.push_back(*child);
                 }
             }
+        }
+    }
+    // Entities the graph doesn't reach
+    std::vector<Entity> detached;
+    for (const auto& [entity, signature] : entitySignatures) {
+        if (!rows.contains(entity)) {
+            detached.push_back(entity);
+        }
+    }
+    std::ranges::sort(detached);
+    for (Entity entity : detached) {
+        addRow(entity, kSceneNoParent, 0);
+    }
 
-            if (!found) {
-                // Log warning or throw exception for unknown component type
-                throw std::runtime_error("Unknown component type in scene file: " + typeName);
-            }
+    std::string strings;
+    auto addString = [&strings](const std::string& value) {
+        const auto offset = static_cast<uint32_t>(strings.size());
+        strings += value;
+        return std::pair{offset, static_cast<uint32_t>(value.size())};
+    };
+
+    std::vector<SceneBinaryPool> pools;
+    std::vector<SceneBinaryPoolData> poolData;
+    pools.reserve(componentArrays.size());
+    poolData.reserve(componentArrays.size());
+    for (const auto& [typeIndex, componentArray] : componentArrays) {
+        SceneBinaryPoolData& data = poolData.emplace_back();
+        componentArray->SerializeToBinary(data);
+        const auto [nameOffset, nameSize] = addString(typeIndex.name());
+        pools.push_back({nameOffset, nameSize, data.recordSize, data.flags, data.version, 0});
+    }
+
+    std::vector<SceneBinarySystem> systemRows;
+    systemRows.reserve(systems.size());
+    for (const auto& [typeIndex, system] : systems) {
+        rapidjson::Document document;
+        document.SetObject();
+        system->SerializeToJson(document, document.GetAllocator());
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        document.Accept(writer);
+
+        const auto [nameOffset, nameSize] = addString(typeIndex.name());
+        const auto [dataOffset, dataSize] = addString(std::string(buffer.GetString(), buffer.GetSize()));
+        systemRows.push_back({nameOffset, nameSize, dataOffset, dataSize});
+    }
+
+    const SceneBinaryHeader header{maxEntityIndex, static_cast<uint32_t>(entities.size()),
+                                   static_cast<uint32_t>(pools.size()), static_cast<uint32_t>(systemRows.size())};
+
+    am::BinaryContainerWriter writer(kSceneBinaryKind, sceneId);
+    writer.addValue(kSceneHeaderTag, header);
+    writer.addSection(kSceneEntitiesTag, std::span<const SceneBinaryEntity>(entities));
+    writer.addSection(kSceneParentsTag, std::span<const uint32_t>(parents));
+    writer.addSection(kScenePoolsTag, std::span<const SceneBinaryPool>(pools));
+    for (uint32_t i = 0; i < poolData.size(); ++i) {
+        writer.addSection(scenePoolRecordsTag(i), std::span<const std::byte>(poolData[i].records), poolData[i].recordSize);
+        writer.addSection(scenePoolSlotsTag(i), std::span<const SceneBinarySlot>(poolData[i].slots));
+    }
+    writer.addSection(kSceneSystemsTag, std::span<const SceneBinarySystem>(systemRows));
+    writer.addSection(kSceneStringsTag, std::as_bytes(std::span(strings)));
+
+    auto file = am::MappedFile::allocate(writer.getSize(), boost::uuids::to_string(sceneId) + ".scene");
+    const auto bytes = file->writableBytes();
+    std::ospanstream stream(std::span(reinterpret_cast<char*>(bytes.data()), bytes.size()));
+    if (!writer.write(stream)) {
+        spdlog::error("Failed to serialize scene {}", boost::uuids::to_string(sceneId));
+        return nullptr;
+    }
+    return file;
+}
+
+bool Scene::DeserializeFromBinary(const am::BinaryContainerReader& reader) {
+    ZoneScoped;
+    const auto header = reader.sectionValue<SceneBinaryHeader>(kSceneHeaderTag);
+    const auto entities = reader.sectionAs<SceneBinaryEntity>(kSceneEntitiesTag);
+    const auto parents = reader.sectionAs<uint32_t>(kSceneParentsTag);
+    std::vector<SceneBinaryPool> pools;
+    if (const auto* poolSection = reader.findSection(kScenePoolsTag);
+        poolSection && poolSection->elementSize == sizeof(SceneBinaryPoolUnversioned)) {
+        for (const auto& pool : reader.sectionAs<SceneBinaryPoolUnversioned>(kScenePoolsTag)) {
+            pools.push_back({pool.nameOffset, pool.nameSize, pool.recordSize, pool.flags, 0, 0});
+        }
+    } else {
+        const auto rows = reader.sectionAs<SceneBinaryPool>(kScenePoolsTag);
+        pools.assign(rows.begin(), rows.end());
+    }
+    const auto systemRows = reader.sectionAs<SceneBinarySystem>(kSceneSystemsTag);
+    const auto stringBytes = reader.section(kSceneStringsTag);
+    const std::string_view strings(reinterpret_cast<const char*>(stringBytes.data()), stringBytes.size());
+
+    auto fail = [this](std::string_view reason) {
+        spdlog::error("Malformed binary scene {}: {}", boost::uuids::to_string(sceneId), reason);
+        return false;
+    };
+    auto inStrings = [&strings](uint32_t offset, uint32_t size) {
+        return offset <= strings.size() && size <= strings.size() - offset;
+    };
+
+    // Everything is checked before the scene is touched
+    if (!header) {
+        return fail("missing header");
+    }
+    if (header->maxEntityIndex > MAX_ENTITIES) {
+        return fail("more entities than MAX_ENTITIES");
+    }
+    if (entities.size() != header->entityCount || parents.size() != header->entityCount ||
+        pools.size() != header->poolCount || systemRows.size() != header->systemCount) {
+        return fail("section sizes don't match the header");
+    }
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        if (entities[row].entity >= MAX_ENTITIES) {
+            return fail("entity out of range");
+        }
+        if (parents[row] != kSceneNoParent && parents[row] >= row) {
+            return fail("parent listed after its child");
         }
     }
 
-    // Then, ensure all required systems are registered
-    if (doc.HasMember("systems") && doc["systems"].IsObject()) {
-        const auto& registeredSystems = engine.GetRegisteredSystemTypes();
+    // Pools are loaded into arrays of their own, the scene only takes them over once every one of them fit
+    std::vector<std::pair<std::type_index, std::shared_ptr<IComponentArray>>> stagedPools;
+    stagedPools.reserve(pools.size());
+    for (uint32_t i = 0; i < pools.size(); ++i) {
+        if (!inStrings(pools[i].nameOffset, pools[i].nameSize)) {
+            return fail("pool name out of range");
+        }
+        const std::string name(strings.substr(pools[i].nameOffset, pools[i].nameSize));
+        const std::type_index* type = FindRegisteredType(engine.GetRegisteredComponentTypes(), name);
+        if (!type) {
+            return fail("unknown component type " + name);
+        }
+        if (std::ranges::any_of(stagedPools, [type](const auto& staged) { return staged.first == *type; })) {
+            return fail("component type " + name + " listed twice");
+        }
+        const auto records = reader.section(scenePoolRecordsTag(i));
+        const auto slots = reader.sectionAs<SceneBinarySlot>(scenePoolSlotsTag(i));
+        if (slots.size() * sizeof(SceneBinarySlot) != reader.section(scenePoolSlotsTag(i)).size()) {
+            return fail("pool slots don't match their layout");
+        }
+        auto componentArray = engine.CreateComponentArray(*type);
+        if (!componentArray->DeserializeFromBinary(SceneBinaryPoolView{pools[i].recordSize, pools[i].flags, pools[i].version, records, slots})) {
+            return fail("component pool " + name + " doesn't match the component layout");
+        }
+        stagedPools.emplace_back(*type, std::move(componentArray));
+    }
+    for (const auto& system : systemRows) {
+        if (!inStrings(system.nameOffset, system.nameSize) || !inStrings(system.dataOffset, system.dataSize)) {
+            return fail("system out of range");
+        }
+        const std::string name(strings.substr(system.nameOffset, system.nameSize));
+        if (!IsRegisteredType(engine.GetRegisteredSystemTypes(), name)) {
+            return fail("unknown system type " + name);
+        }
+    }
 
-        for (auto it = doc["systems"].MemberBegin(); it != doc["systems"].MemberEnd(); ++it) {
-            std::string typeName = it->name.GetString();
-            bool found = false;
-
-            // Find and register the system if needed
-            for (const auto& type : registeredSystems) {
-                if (type.name() == typeName) {
-                    // Check if system is already registered in scene
-                    if (systems.find(type) == systems.end()) {
-                        // Register the system using type information
-                        RegisterSystem(type);
-                    }
-                    found = true;
-                    break;
-                }
-            }
+    ResetForLoad();
+    for (auto& [type, componentArray] : stagedPools) {
+        IndexComponentArray(componentArray.get());
+        componentArrays[type] = std::move(componentArray);
+    }
+    for (const auto& system : systemRows) {
+        EnsureSystem(std::string(strings.substr(system.nameOffset, system.nameSize)));
+    }
 
-            if (!found) {
-                // Log warning or throw exception for unknown system type
-                throw std::runtime_error("Unknown system type in scene file: " + typeName);
+    maxEntityIndex = header->maxEntityIndex;
+    for (uint32_t row = 0; row < entities.size(); ++row) {
+        const SceneBinaryEntity& entity = entities[row];
+        sceneGraph[entity.entity];
+        if (entity.flags & SceneEntityHasSignature) {
+            entitySignatures[entity.entity] = Signature(entity.signature);
+        }
+        activeEntities.set(entity.entity, entity.flags & SceneEntityActive);
+        if (entity.flags & SceneEntityRoot) {
+            rootEntities.push_back(entity.entity);
+        }
+        if (parents[row] != kSceneNoParent) {
+            const Entity parent = entities[parents[row]].entity;
+            sceneGraph[entity.entity].parent = parent;
+            sceneGraph[parent].children.push_back(entity.entity);
+        }
+    }
+
+    for (const auto& system : systemRows) {
+        const std::string name(strings.substr(system.nameOffset, system.nameSize));
+        rapidjson::Document document;
+        document.Parse(strings.data() + system.dataOffset, system.dataSize);
+        if (document.HasParseError()) {
+            spdlog::error("System {} in scene {} has malformed data", name, boost::uuids::to_string(sceneId));
+            continue;
+        }
+        for (const auto& [typeIndex, sceneSystem] : systems) {
+            if (typeIndex.name() == name) {
+                sceneSystem->DeserializeFromJson(document);
+                break;
             }
         }
     }
+    return true;
+}
 
-    // Now proceed with the actual deserialization
-    DeserializeEntities(doc["entities"]);
-    DeserializeComponents(doc["components"]);
-    DeserializeSystems(doc["systems"]);
-    DeserializeSceneGraph(doc["sceneGraph"]);
+TransformComponentArray* Scene::GetTransformArray()
+{
+    return static_cast<TransformComponentArray*>(componentPools[GetComponentTypeID<TransformComponent>()]);
+}
+
+void Scene::IndexComponentArray(IComponentArray* array)
+{
+    const ComponentTypeID typeId = array->GetComponentTypeIDUntyped();
+    assert(typeId < MAX_COMPONENTS && "More component types than MAX_COMPONENTS");
+    componentPools[typeId] = array;
+}
+
+void Scene::IndexSystem(SystemBase* system)
+{
+    const SystemTypeID typeId = system->GetSystemTypeIDUntyped();
+    assert(typeId < MAX_SYSTEMS && "More system types than MAX_SYSTEMS");
+    systemSlots[typeId] = system;
 }
 
+void Scene::RegisterTransformComponent()
+{
+    assert(componentArrays.find(typeid(TransformComponent)) == componentArrays.end() && "Component already registered.");
+
+    std::type_index typeIdx = typeid(TransformComponent);
+    componentArrays[typeIdx] = std::make_shared<TransformComponentArray>();
+    IndexComponentArray(componentArrays[typeIdx].get());
+    indexToType.insert_or_assign(GetComponentTypeID<TransformComponent>(), typeIdx);
+}
 
 void Scene::AddComponent(const std::type_index& type) {
     if (componentArrays.find(type) == componentArrays.end()) {
         componentArrays[type] = engine.CreateComponentArray(type);
+        IndexComponentArray(componentArrays[type].get());
     }
 }
 
@@ -435,32 +1114,36 @@ CameraObject Scene::GetActiveCamera()
         static TransformComponent defaultTransform;
         static CameraComponent defaultCamera;
 
-        if (GetSystem<EditorSystem>()->inEditMode)
+        auto* editorSystem = GetSystem<EditorSystem>();
+        if (editorSystem && editorSystem->inEditMode)
         {
-            return {&GetSystem<EditorSystem>()->camera, &GetSystem<EditorSystem>()->cameraTransform};
+            auto& cameraTransform = editorSystem->cameraTransform;
+            return {&editorSystem->camera, cameraTransform.globalMatrix, cameraTransform.position};
         }
         else
         {
-            auto& cameras = GetComponentArray<CameraComponent>().get()->GetComponents();
-            auto& transforms = GetIntegralComponentArray<TransformComponent>().get()->GetComponents();
+            auto* cameraArray = GetComponentArray<CameraComponent>();
+            auto& cameras = cameraArray->GetComponents();
+            auto transforms = GetTransformArray();
 
             for (int i = 0; i < cameras.size(); i++)
             {
-                if (GetComponentArray<CameraComponent>().get()->IsComponentActive(i))
+                if (cameraArray->IsComponentActive(i))
                 {
-                    auto cameraEntity = GetComponentArray<CameraComponent>().get()->ComponentIndexToEntity(i);
-                    return {&cameras[cameraEntity], &transforms[cameraEntity]};
+                    auto cameraEntity = cameraArray->ComponentIndexToEntity(i);
+                    return {&cameras[i], transforms->GetWorldMatrix(cameraEntity), transforms->GetPosition(cameraEntity)};
                 }
             }
         }
 
         // If no active camera found, return default camera
-        return {&defaultCamera, &defaultTransform};
+        return {&defaultCamera, defaultTransform.globalMatrix, defaultTransform.position};
     }
 
 void Scene::RegisterSystem(const std::type_index& type) {
     if (systems.find(type) == systems.end()) {
         systems[type] = engine.CreateSystem(type, this);
+        IndexSystem(systems[type].get());
     }
 }
 void Scene::DeserializeEntities(const rapidjson::Value& obj) {
@@ -5,19 +5,26 @@
 #ifndef REASONABLEGL_SCENE_H
 #define REASONABLEGL_SCENE_H
 
+#include <array>
 #include <memory>
+#include <memory_resource>
 #include <queue>
+#include <span>
 #include <typeindex>
 #include <unordered_map>
 
 #include "systems/transformSystem/componets/TransformComponent.hpp"
 #include "Engine.h"
+#include "FrameArena.hpp"
 #include "componentArrays/IComponentArray.h"
 #include "componentArrays/ComponentArray.h"
 #include "Types.h"
+#include "EntityCommandBuffer.h"
+#include "Prefab.h"
 #include "System.h"
 #include "TransformNode.h"
 #include "componentArrays/IntegralComponentArray.h"
+#include "componentArrays/TransformComponentArray.h"
 #include "systems/renderingSystem/componets/CameraComponent.hpp"
 
 namespace engine::ecs
@@ -27,7 +34,8 @@ namespace engine::ecs
     struct CameraObject
     {
         CameraComponent* camera;
-        TransformComponent* transform;
+        glm::mat4 worldMatrix;
+        glm::vec3 position;
     };
 
     class Scene {
@@ -46,25 +54,55 @@ namespace engine::ecs
 
         void DestroyEntity(Entity entity);
 
+        // Bulk paths, the bookkeeping of every entity is done in one pass per component type. CreateEntities returns
+        // nothing if the entities don't fit. Children of destroyed entities become roots
+        std::vector<Entity> CreateEntities(std::span<const TransformComponent> transforms, Entity parentEntity = -1);
+        void DestroyEntities(std::span<const Entity> entities);
+
+        // Systems record structural changes here while iterating, Update plays them back after every system ran
+        EntityCommandBuffer& GetCommandBuffer() { return commandBuffer; }
+        // Returns the entities created for the buffer's placeholders, in recording order
+        std::vector<Entity> Playback(EntityCommandBuffer& buffer);
+
         void SetEntityActive(Entity entity, bool active);
 
         bool IsEntityActive(Entity entity) const;
 
+        // Without a resource the result lives in the frame allocator, valid until the Update after next
+        template<typename... Components>
+        std::pmr::vector<Entity> GetEntitiesWith();
         template<typename... Components>
-        std::vector<Entity> GetEntitiesWith();
+        std::pmr::vector<Entity> GetEntitiesWith(std::pmr::memory_resource* resource);
+
+        // Transient memory for the current frame, one arena per frame in flight reset in bulk at the start of Update
+        std::pmr::memory_resource* GetFrameAllocator() { return &frameArena; }
+        gfx::FrameArenaStats GetFrameArenaStats() const { return frameArena.getStats(); }
+
+        //Prefabs
+        std::shared_ptr<const PrefabTemplate> CompilePrefab(const rapidjson::Value& prefab) const;
+        // Spawns count copies of the prefab in one batch, transforms is empty or holds the root transform of each copy.
+        // Returns the entities copy after copy in node order, or nothing without touching the scene if they don't fit
+        std::vector<Entity> Instantiate(const PrefabTemplate& prefab, size_t count,
+                                        std::span<const TransformComponent> transforms = {});
+        // Same through the engine's prefab cache, a prefab that is missing or doesn't compile spawns nothing
+        std::vector<Entity> Instantiate(const boost::uuids::uuid& prefabId, size_t count,
+                                        std::span<const TransformComponent> transforms = {});
 
         //Components
         template<typename T>
         void RegisterComponent();
 
-       std::unordered_map<std::type_index, std::shared_ptr<IComponentArray>> GetComponentArrays();
-
+        const std::unordered_map<std::type_index, std::shared_ptr<IComponentArray>>& GetComponentArrays() const;
 
+        // Non-owning, looked up by the component's type ID without hashing or reference counting. Null if the type
+        // isn't registered in this scene. Valid until the scene is reset for loading
         template<typename T>
-        std::shared_ptr<ComponentArray<T>> GetComponentArray();
+        ComponentArray<T>* GetComponentArray();
 
         template <class T>
-        std::shared_ptr<IntegralComponentArray<T>> GetIntegralComponentArray();
+        IntegralComponentArray<T>* GetIntegralComponentArray();
+
+        TransformComponentArray* GetTransformArray();
 
         template<typename T>
         void AddComponent(Entity entity, T component = T());
@@ -94,10 +132,15 @@ namespace engine::ecs
         template<typename T, typename... Args>
         std::shared_ptr<T> RegisterSystem(Args&&... args);
 
+        // Stops updating the system and destroys it, its pointers from GetSystem dangle afterwards
         template<typename T>
-        std::shared_ptr<T> GetSystem();
+        void UnregisterSystem();
 
-        const      std::unordered_map<std::type_index, std::shared_ptr<SystemBase>>GetSystems();
+        // Non-owning like GetComponentArray, null if the system isn't registered
+        template<typename T>
+        T* GetSystem();
+
+        const std::unordered_map<std::type_index, std::shared_ptr<SystemBase>>& GetSystems() const;
 
         //Scene Graph
         void SetParent(Entity child, Entity parent);
@@ -109,6 +152,11 @@ namespace engine::ecs
 
         void SerializeToJson(rapidjson::Document& doc) const;
         void DeserializeFromJson(const rapidjson::Document& doc);
+
+        // Scenes are saved as binary containers, JSON is kept for diffs and debugging. Loading returns false and
+        // leaves the scene as it was if the container is malformed or any pool doesn't fit its component layout
+        std::shared_ptr<const am::MappedFile> SerializeToBinary() const;
+        bool DeserializeFromBinary(const am::BinaryContainerReader& reader);
         void AddComponent(const std::type_index& type);
 
         std::unordered_map<Entity, TransformNode> sceneGraph;
@@ -127,16 +175,33 @@ namespace engine::ecs
         std::queue<Entity> freeEntities;  // recycled IDs
         std::unordered_map<Entity, Signature> entitySignatures;
         std::bitset<MAX_ENTITIES> activeEntities;
+        EntityCommandBuffer commandBuffer;
+        gfx::FrameArena frameArena;
+
+        bool AcquireEntities(std::span<Entity> entities);
+        // Parents are -1, existing entities or placeholders of a command buffer indexing transforms
+        std::vector<Entity> CreateEntitiesBatch(std::span<const TransformComponent> transforms, std::span<const Entity> parents);
+        // Signatures and the systems using the type are updated once for the whole batch
+        void AddComponentsBatch(IComponentArray& array, const std::type_index& type, std::span<const Entity> entities,
+                                std::span<const Component* const> components);
+        void RemoveComponentsBatch(IComponentArray& array, const std::type_index& type, std::span<const Entity> entities);
 
         //Components
         template<typename T>
         void RegisterIntegralComponent();
+        void RegisterTransformComponent();
 
         std::unordered_map<std::type_index, std::shared_ptr<IComponentArray>> componentArrays;
         std::unordered_map<ComponentTypeID, std::type_index> indexToType;
+        // Views of componentArrays indexed by ComponentTypeID, kept in step by every registration
+        std::array<IComponentArray*, MAX_COMPONENTS> componentPools{};
+        void IndexComponentArray(IComponentArray* array);
 
         //Systems
         std::unordered_map<std::type_index, std::shared_ptr<SystemBase>> systems;
+        // Views of systems indexed by SystemTypeID
+        std::array<SystemBase*, MAX_SYSTEMS> systemSlots{};
+        void IndexSystem(SystemBase* system);
 
         void SerializeEntities(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const;
         void SerializeComponents(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const;
@@ -144,6 +209,9 @@ namespace engine::ecs
         void SerializeSceneGraph(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const;
 
         void RegisterSystem(const std::type_index& type);
+        void ResetForLoad();
+        void EnsureComponentArray(const std::string& typeName);
+        void EnsureSystem(const std::string& typeName);
         void DeserializeEntities(const rapidjson::Value& obj);
         void DeserializeComponents(const rapidjson::Value& obj);
         void DeserializeSystems(const rapidjson::Value& obj);
@@ -5,12 +5,18 @@
 
 
 template <typename ... Components>
-std::vector<Entity> Scene::GetEntitiesWith()
+std::pmr::vector<Entity> Scene::GetEntitiesWith()
+{
+    return GetEntitiesWith<Components...>(&frameArena);
+}
+
+template <typename ... Components>
+std::pmr::vector<Entity> Scene::GetEntitiesWith(std::pmr::memory_resource* resource)
 {
     Signature requiredSignature;
     (requiredSignature.set(GetComponentTypeID<Components>()), ...); // Fold expression
 
-    std::vector<Entity> matching;
+    std::pmr::vector<Entity> matching(resource);
     for (auto& [entity, signature] : entitySignatures) {
         if ((signature & requiredSignature) == requiredSignature) {
             matching.push_back(entity);
@@ -27,7 +33,7 @@ void Scene::AddComponent(Entity entity, T component)
 
     if constexpr (std::is_same<T, TransformComponent>::value)
     {
-       componentId = GetIntegralComponentArray<T>()->AddComponentToEntity(entity, component);
+       componentId = GetTransformArray()->AddComponentToEntity(entity, component);
     }
     else
     {
@@ -56,7 +62,7 @@ void Scene::RemoveComponent(Entity entity)
     ComponentID componentId;
     if constexpr (std::is_same<T, TransformComponent>::value)
     {
-       componentId=  GetIntegralComponentArray<T>()->RemoveComponentFronEntity(entity);
+       componentId=  GetTransformArray()->RemoveComponentFronEntity(entity);
     }
     else
     {
@@ -83,7 +89,7 @@ bool Scene::HasComponent(Entity entity)
 {
     if constexpr (std::is_same<T, TransformComponent>::value)
     {
-    return GetIntegralComponentArray<T>()->HasComponent(entity);
+    return GetTransformArray()->HasComponent(entity);
     }
     else
     {
@@ -96,7 +102,7 @@ void Scene::SetComponentActive(Entity entity,bool active )
 {
     if constexpr (std::is_same<T, TransformComponent>::value)
     {
-        GetIntegralComponentArray<T>()->SetComponentActive(entity,active);
+        GetTransformArray()->SetComponentActive(entity,active);
     }
     else
     {
@@ -109,7 +115,7 @@ bool Scene::IsComponentActive(Entity entity)
 {
     if constexpr (std::is_same<T, TransformComponent>::value)
     {
-        return GetIntegralComponentArray<T>()->IsComponentActive(entity);
+        return GetTransformArray()->IsComponentActive(entity);
     }
     else
     {
@@ -122,7 +128,7 @@ auto Scene::GetComponent(Entity entity) -> T&
 {
     if constexpr (std::is_same<T, TransformComponent>::value)
     {
-        return GetIntegralComponentArray<T>()->GetComponentFromEntity(entity);
+        return GetTransformArray()->GetComponentFromEntity(entity);
     }
     else
     {
@@ -138,9 +144,19 @@ std::shared_ptr<T> Scene::RegisterSystem(Args&&... args)
     auto typeIndex = std::type_index(typeid(T));
     auto system = std::make_shared<T>(this,std::forward<Args>(args)...);
     systems[typeIndex] = system;
+    IndexSystem(system.get());
     return system;
 }
 
+template <typename T>
+void Scene::UnregisterSystem()
+{
+    const SystemTypeID typeId = GetSystemTypeID<T>();
+    assert(typeId < MAX_SYSTEMS && "More system types than MAX_SYSTEMS");
+    systemSlots[typeId] = nullptr;
+    systems.erase(std::type_index(typeid(T)));
+}
+
 template <typename T>
 void  Scene::RegisterIntegralComponent()
 {
@@ -148,6 +164,7 @@ void  Scene::RegisterIntegralComponent()
 
     std::type_index typeIdx = typeid(T);
     componentArrays[typeIdx] = std::make_unique<IntegralComponentArray<T>>();
+    IndexComponentArray(componentArrays[typeIdx].get());
 
     ComponentTypeID componentTypeId = GetComponentTypeID<T>();
     indexToType.insert_or_assign(componentTypeId, typeIdx);
@@ -161,32 +178,32 @@ void Scene::RegisterComponent()
 
     std::type_index typeIdx = typeid(T);
     componentArrays[typeIdx] = std::make_unique<ComponentArray<T>>();
+    IndexComponentArray(componentArrays[typeIdx].get());
 
     ComponentTypeID componentTypeId = GetComponentTypeID<T>();
     indexToType.insert_or_assign(componentTypeId, typeIdx);
 }
 
 template <typename T>
-std::shared_ptr<ComponentArray<T>> Scene::GetComponentArray()
+ComponentArray<T>* Scene::GetComponentArray()
 {
-    // Cast from IComponentArray to ComponentArray<T>
-    auto basePtr = componentArrays[ typeid(T)].get();
-    return std::shared_ptr<ComponentArray<T>>(static_cast<ComponentArray<T>*>(basePtr),
-                                              [](ComponentArray<T>*){}); // do-nothing deleter
+    const ComponentTypeID typeId = GetComponentTypeID<T>();
+    assert(typeId < MAX_COMPONENTS && "More component types than MAX_COMPONENTS");
+    return static_cast<ComponentArray<T>*>(componentPools[typeId]);
 }
 
 template <typename T>
-std::shared_ptr<IntegralComponentArray<T>> Scene::GetIntegralComponentArray()
+IntegralComponentArray<T>* Scene::GetIntegralComponentArray()
 {
-    // Cast from IComponentArray to ComponentArray<T>
-    auto basePtr = componentArrays[ typeid(T)].get();
-    return std::shared_ptr<IntegralComponentArray<T>>(static_cast<IntegralComponentArray<T>*>(basePtr),
-                                              [](IntegralComponentArray<T>*){}); // do-nothing deleter
+    const ComponentTypeID typeId = GetComponentTypeID<T>();
+    assert(typeId < MAX_COMPONENTS && "More component types than MAX_COMPONENTS");
+    return static_cast<IntegralComponentArray<T>*>(componentPools[typeId]);
 }
 
 template<typename T>
-std::shared_ptr<T> Scene::GetSystem()
+T* Scene::GetSystem()
 {
-    auto typeIndex = std::type_index(typeid(T));
-    return std::static_pointer_cast<T>(systems.at(typeIndex));
-}
\ No newline at end of file
+    const SystemTypeID typeId = GetSystemTypeID<T>();
+    assert(typeId < MAX_SYSTEMS && "More system types than MAX_SYSTEMS");
+    return static_cast<T*>(systemSlots[typeId]);
+}
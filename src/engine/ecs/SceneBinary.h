@@ -0,0 +1,204 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef SCENEBINARY_H
+#define SCENEBINARY_H
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "BinaryContainer.hpp"
+#include "Types.h"
+
+namespace engine::ecs
+{
+    // Binary scenes are am binary containers of kind kSceneBinaryKind:
+    //   HEAD       SceneBinaryHeader
+    //   ENTS       SceneBinaryEntity[entityCount], scene graph order, so every entity comes after its parent
+    //   PRNT       uint32_t[entityCount], row of the parent in ENTS or kSceneNoParent
+    //   POOL       SceneBinaryPool[poolCount], SceneBinaryPoolUnversioned in scenes written before pools had a version
+    //   RECx/SLTx  records and slots of pool x, x being the pool index in the last byte of the tag
+    //   SYST       SceneBinarySystem[systemCount]
+    //   STRS       type names and system JSON, referenced by offset
+    constexpr uint32_t kSceneBinaryKind = am::makeFourCC('S', 'C', 'N', 'E');
+    constexpr uint32_t kSceneHeaderTag = am::makeFourCC('H', 'E', 'A', 'D');
+    constexpr uint32_t kSceneEntitiesTag = am::makeFourCC('E', 'N', 'T', 'S');
+    constexpr uint32_t kSceneParentsTag = am::makeFourCC('P', 'R', 'N', 'T');
+    constexpr uint32_t kScenePoolsTag = am::makeFourCC('P', 'O', 'O', 'L');
+    constexpr uint32_t kSceneSystemsTag = am::makeFourCC('S', 'Y', 'S', 'T');
+    constexpr uint32_t kSceneStringsTag = am::makeFourCC('S', 'T', 'R', 'S');
+
+    constexpr uint32_t scenePoolRecordsTag(uint32_t pool) { return am::makeFourCC('R', 'E', 'C', static_cast<char>(pool)); }
+    constexpr uint32_t scenePoolSlotsTag(uint32_t pool) { return am::makeFourCC('S', 'L', 'T', static_cast<char>(pool)); }
+
+    constexpr uint32_t kSceneNoParent = ~0u;
+
+    enum SceneEntityFlags : uint32_t {
+        SceneEntityActive = 1u << 0,
+        SceneEntityRoot = 1u << 1,
+        SceneEntityHasSignature = 1u << 2,      // Graph nodes of destroyed entities have none
+    };
+
+    enum ScenePoolFlags : uint32_t {
+        ScenePoolJson = 1u << 0,                // Components without a Record, the records are one JSON array
+    };
+
+    static_assert(MAX_COMPONENTS <= 64, "Signatures are stored as 64 bits");
+
+    struct SceneBinaryHeader {
+        uint32_t maxEntityIndex;
+        uint32_t entityCount;
+        uint32_t poolCount;
+        uint32_t systemCount;
+    };
+
+    struct SceneBinaryEntity {
+        Entity entity;
+        uint32_t flags;
+        uint64_t signature;
+    };
+
+    struct SceneBinaryPool {
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        uint32_t recordSize;
+        uint32_t flags;
+        uint32_t version;       // SceneRecordVersion of the component it was written with
+        uint32_t reserved;
+    };
+
+    // Pool rows of scenes written before pools had a version, read as version 0
+    struct SceneBinaryPoolUnversioned {
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        uint32_t recordSize;
+        uint32_t flags;
+    };
+
+    struct SceneBinarySlot {
+        Entity entity;
+        uint32_t active;
+    };
+
+    struct SceneBinarySystem {
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        uint32_t dataOffset;
+        uint32_t dataSize;
+    };
+
+    // One component pool on its way to or from a container, records are in slot order
+    struct SceneBinaryPoolData {
+        uint32_t recordSize = 0;
+        uint32_t flags = 0;
+        uint32_t version = 0;
+        std::vector<std::byte> records;
+        std::vector<SceneBinarySlot> slots;
+    };
+
+    struct SceneBinaryPoolView {
+        uint32_t recordSize = 0;
+        uint32_t flags = 0;
+        uint32_t version = 0;
+        std::span<const std::byte> records;
+        std::span<const SceneBinarySlot> slots;
+    };
+
+    // Components stored as plain records: a trivially copyable Record with everything the JSON form keeps
+    template<typename T>
+    concept RecordComponent = requires(const T& component, T& target, const typename T::Record& record) {
+        { component.ToRecord() } -> std::same_as<typename T::Record>;
+        target.FromRecord(record);
+    } && std::is_trivially_copyable_v<typename T::Record>;
+
+    // Bumped by a Record that gains fields through a static constexpr uint32_t kVersion, 1 without one.
+    // Fields are only ever appended, so the records of an older version are read into the start of a
+    // value initialized Record and the fields added since are zero
+    template<typename T>
+    constexpr uint32_t SceneRecordVersion()
+    {
+        if constexpr (requires { { T::Record::kVersion } -> std::convertible_to<uint32_t>; }) {
+            return T::Record::kVersion;
+        } else {
+            return 1;
+        }
+    }
+
+    template<typename T>
+    void WriteSceneRecords(SceneBinaryPoolData& pool, std::span<const T* const> components)
+    {
+        if constexpr (RecordComponent<T>) {
+            using Record = typename T::Record;
+            pool.recordSize = sizeof(Record);
+            pool.version = SceneRecordVersion<T>();
+            pool.records.resize(components.size() * sizeof(Record));
+            for (size_t i = 0; i < components.size(); ++i) {
+                const Record record = components[i]->ToRecord();
+                std::memcpy(pool.records.data() + i * sizeof(Record), &record, sizeof(Record));
+            }
+        } else {
+            rapidjson::Document document;
+            document.SetArray();
+            for (const T* component : components) {
+                rapidjson::Value data(rapidjson::kObjectType);
+                component->SerializeComponentToJson(data, document.GetAllocator());
+                document.PushBack(data, document.GetAllocator());
+            }
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            document.Accept(writer);
+
+            pool.recordSize = 1;
+            pool.flags |= ScenePoolJson;
+            const auto* text = reinterpret_cast<const std::byte*>(buffer.GetString());
+            pool.records.assign(text, text + buffer.GetSize());
+        }
+    }
+
+    // Fills the component emplace(slot) returns for every slot, false if the pool was written for a different layout
+    // or by a newer version of the component
+    template<typename T, typename Emplace>
+    bool ReadSceneRecords(const SceneBinaryPoolView& pool, Emplace&& emplace)
+    {
+        if constexpr (RecordComponent<T>) {
+            using Record = typename T::Record;
+            constexpr uint32_t version = SceneRecordVersion<T>();
+            const bool sameLayout = pool.version == version && pool.recordSize == sizeof(Record);
+            const bool olderLayout = pool.version < version && pool.recordSize > 0 && pool.recordSize <= sizeof(Record);
+            if ((pool.flags & ScenePoolJson) || !(sameLayout || olderLayout) ||
+                pool.records.size() != pool.slots.size() * pool.recordSize) {
+                return false;
+            }
+            for (size_t i = 0; i < pool.slots.size(); ++i) {
+                Record record{};
+                std::memcpy(&record, pool.records.data() + i * pool.recordSize, pool.recordSize);
+                T& component = emplace(i);
+                component.FromRecord(record);
+            }
+        } else {
+            if (!(pool.flags & ScenePoolJson)) {
+                return false;
+            }
+            rapidjson::Document document;
+            document.Parse(reinterpret_cast<const char*>(pool.records.data()), pool.records.size());
+            if (document.HasParseError() || !document.IsArray() || document.Size() != pool.slots.size()) {
+                return false;
+            }
+            for (rapidjson::SizeType i = 0; i < document.Size(); ++i) {
+                T& component = emplace(i);
+                component.DeserializeComponentFromJson(document[i]);
+            }
+        }
+        return true;
+    }
+}
+
+#endif //SCENEBINARY_H
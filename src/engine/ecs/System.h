@@ -45,6 +45,11 @@ namespace engine::ecs
             OnEntityRemoved(component, type);
         }
 
+        SystemTypeID GetSystemTypeIDUntyped() const override
+        {
+            return GetSystemTypeID<Derived>();
+        }
+
         void SerializeToJson(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const override {
             // Store system name
             rapidjson::Value nameVal;
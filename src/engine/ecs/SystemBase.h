@@ -7,6 +7,7 @@
 #include <rapidjson/document.h>
 
 #include "Types.h"
+#include "componentArrays/ComponentType.h"
 
 namespace engine::ecs
 {
@@ -17,6 +18,7 @@ namespace engine::ecs
 
         virtual void AddComponent(ComponentID entity, std::type_index type) = 0;
         virtual void RemoveComponent(ComponentID component, std::type_index type) = 0;
+        virtual SystemTypeID GetSystemTypeIDUntyped() const = 0;
 
         std::string name;
         std::vector<std::type_index> registeredComponentTypes;
@@ -11,6 +11,7 @@ namespace engine::ecs
     using Signature = std::bitset<MAX_COMPONENTS>;
     const Entity MAX_ENTITIES = 100;
     const Entity MAX_COMPONENTS_ARRAY = 10;
+    constexpr std::size_t MAX_SYSTEMS = 16;
 }
 
 #endif
\ No newline at end of file
@@ -34,6 +34,14 @@ namespace engine::ecs{
 
         void SerializeToJson(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const override;
         void DeserializeFromJson(const rapidjson::Value& obj) override;
+        void SerializeToBinary(SceneBinaryPoolData& pool) const override;
+        bool DeserializeFromBinary(const SceneBinaryPoolView& pool) override;
+        ComponentTypeID GetComponentTypeIDUntyped() const override;
+        std::unique_ptr<Component> CreatePrototypeFromJson(const rapidjson::Value& data) const override;
+        std::size_t GetCapacityLeft() const override;
+        void AddComponentsUntyped(std::span<const Entity> entities, std::span<const Component* const> prototypes,
+                                  std::span<ComponentID> ids) override;
+        void RemoveComponentsUntyped(std::span<const Entity> entities, std::span<ComponentID> ids) override;
     private:
         std::array<T, MAX_COMPONENTS_ARRAY> componentArray;
         std::bitset<MAX_COMPONENTS_ARRAY> activeComponents;
@@ -197,4 +197,96 @@ void ComponentArray<T>::DeserializeFromJson(const rapidjson::Value& obj) {
             }
         }
     }
-}
\ No newline at end of file
+}
+template <typename T>
+void ComponentArray<T>::SerializeToBinary(SceneBinaryPoolData& pool) const
+{
+    std::vector<const T*> components;
+    components.reserve(size);
+    pool.slots.reserve(size);
+
+    // Packed order, so every component gets back the index systems were given for it
+    for (ComponentID index = 0; index < size; ++index) {
+        pool.slots.push_back({indexToEntityMap.at(index), activeComponents[index]});
+        components.push_back(&componentArray[index]);
+    }
+    WriteSceneRecords<T>(pool, components);
+}
+
+template <typename T>
+bool ComponentArray<T>::DeserializeFromBinary(const SceneBinaryPoolView& pool)
+{
+    if (pool.slots.size() > componentArray.size()) {
+        return false;
+    }
+    for (const SceneBinarySlot& slot : pool.slots) {
+        if (slot.entity >= MAX_ENTITIES) {
+            return false;
+        }
+    }
+
+    std::array<T, MAX_COMPONENTS_ARRAY> loaded;
+    if (!ReadSceneRecords<T>(pool, [&loaded](size_t index) -> T& { return loaded[index]; })) {
+        return false;
+    }
+
+    componentArray = loaded;
+    entityToIndexMap.clear();
+    indexToEntityMap.clear();
+    activeComponents.reset();
+    size = pool.slots.size();
+    for (ComponentID index = 0; index < size; ++index) {
+        const SceneBinarySlot& slot = pool.slots[index];
+        entityToIndexMap[slot.entity] = index;
+        indexToEntityMap[index] = slot.entity;
+        activeComponents[index] = slot.active != 0;
+    }
+    return true;
+}
+
+template <typename T>
+ComponentTypeID ComponentArray<T>::GetComponentTypeIDUntyped() const
+{
+    return GetComponentTypeID<T>();
+}
+
+template <typename T>
+std::unique_ptr<Component> ComponentArray<T>::CreatePrototypeFromJson(const rapidjson::Value& data) const
+{
+    auto prototype = std::make_unique<T>();
+    prototype->DeserializeComponentFromJson(data);
+    return prototype;
+}
+
+template <typename T>
+std::size_t ComponentArray<T>::GetCapacityLeft() const
+{
+    return componentArray.size() - size;
+}
+
+template <typename T>
+void ComponentArray<T>::AddComponentsUntyped(std::span<const Entity> entities, std::span<const Component* const> prototypes,
+                                             std::span<ComponentID> ids)
+{
+    assert(entities.size() <= GetCapacityLeft() && prototypes.size() == entities.size() && ids.size() == entities.size());
+    entityToIndexMap.reserve(size + entities.size());
+    indexToEntityMap.reserve(size + entities.size());
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        assert(entityToIndexMap.find(entities[i]) == entityToIndexMap.end());
+        const ComponentID index = size++;
+        componentArray[index] = static_cast<const T&>(*prototypes[i]);
+        entityToIndexMap[entities[i]] = index;
+        indexToEntityMap[index] = entities[i];
+        activeComponents[index] = true;
+        ids[i] = index;
+    }
+}
+
+template <typename T>
+void ComponentArray<T>::RemoveComponentsUntyped(std::span<const Entity> entities, std::span<ComponentID> ids)
+{
+    assert(ids.size() == entities.size());
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        ids[i] = RemoveComponentFronEntity(entities[i]);
+    }
+}
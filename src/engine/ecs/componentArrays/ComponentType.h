@@ -21,5 +21,21 @@ namespace engine::ecs
         static ComponentTypeID typeID = GetUniqueComponentTypeID();
         return typeID;
     }
+
+    // Systems are counted separately, so both stay dense enough to index arrays with
+    using SystemTypeID = std::size_t;
+
+    inline SystemTypeID GetUniqueSystemTypeID()
+    {
+        static SystemTypeID lastID = 0u;
+        return lastID++;
+    }
+
+    template<typename T>
+    SystemTypeID GetSystemTypeID()
+    {
+        static SystemTypeID typeID = GetUniqueSystemTypeID();
+        return typeID;
+    }
 }
 #endif //COMPONENTTYPE_H
@@ -1,7 +1,12 @@
 #ifndef COMPONENTARRAYBASE_H
 #define COMPONENTARRAYBASE_H
 
+#include <memory>
+#include <span>
+
 #include "../Types.h"
+#include "../SceneBinary.h"
+#include "ComponentType.h"
 #include "ecs/Component.hpp"
 
 namespace engine::ecs
@@ -21,6 +26,20 @@ namespace engine::ecs
 
         virtual void SerializeToJson(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const = 0;
         virtual void DeserializeFromJson(const rapidjson::Value& obj) = 0;
+
+        // Binary scenes, see SceneBinary.h. Loading fails without touching the array if the pool doesn't fit it
+        virtual void SerializeToBinary(SceneBinaryPoolData& pool) const = 0;
+        virtual bool DeserializeFromBinary(const SceneBinaryPoolView& pool) = 0;
+
+        // Prefabs, see Prefab.h. Prototypes are components of the array's type built once and copied on every spawn
+        virtual ComponentTypeID GetComponentTypeIDUntyped() const = 0;
+        virtual std::unique_ptr<Component> CreatePrototypeFromJson(const rapidjson::Value& data) const = 0;
+        virtual std::size_t GetCapacityLeft() const = 0;
+        // Copies prototypes[i] to entities[i] in one batch, ids gets the ComponentID of each. Callers check the capacity
+        virtual void AddComponentsUntyped(std::span<const Entity> entities, std::span<const Component* const> prototypes,
+                                          std::span<ComponentID> ids) = 0;
+        // Batch counterpart of RemoveComponentUntyped, ids gets the ComponentID each removal reports to systems
+        virtual void RemoveComponentsUntyped(std::span<const Entity> entities, std::span<ComponentID> ids) = 0;
     };
 }
 #endif // COMPONENTARRAYBASE_H
\ No newline at end of file
@@ -137,4 +137,86 @@ void IntegralComponentArray<T>::DeserializeFromJson(const rapidjson::Value& obj)
             }
         }
     }
-}
\ No newline at end of file
+}
+
+template <typename T>
+void IntegralComponentArray<T>::SerializeToBinary(SceneBinaryPoolData& pool) const
+{
+    std::vector<const T*> components;
+    for (Entity entity = 0; entity < MAX_ENTITIES; ++entity) {
+        if (activeComponents[entity]) {
+            pool.slots.push_back({entity, 1});
+            components.push_back(&componentArray[entity]);
+        }
+    }
+    WriteSceneRecords<T>(pool, components);
+}
+
+template <typename T>
+bool IntegralComponentArray<T>::DeserializeFromBinary(const SceneBinaryPoolView& pool)
+{
+    for (const SceneBinarySlot& slot : pool.slots) {
+        if (slot.entity >= MAX_ENTITIES) {
+            return false;
+        }
+    }
+
+    // Read aside first, a pool that doesn't match leaves the array as it was
+    std::vector<T> loaded(pool.slots.size());
+    if (!ReadSceneRecords<T>(pool, [&loaded](size_t index) -> T& { return loaded[index]; })) {
+        return false;
+    }
+
+    activeComponents.reset();
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        const Entity entity = pool.slots[i].entity;
+        componentArray[entity] = loaded[i];
+        activeComponents[entity] = pool.slots[i].active != 0;
+    }
+    return true;
+}
+
+template <typename T>
+ComponentTypeID IntegralComponentArray<T>::GetComponentTypeIDUntyped() const
+{
+    return GetComponentTypeID<T>();
+}
+
+template <typename T>
+std::unique_ptr<Component> IntegralComponentArray<T>::CreatePrototypeFromJson(const rapidjson::Value& data) const
+{
+    auto prototype = std::make_unique<T>();
+    prototype->DeserializeComponentFromJson(data);
+    return prototype;
+}
+
+template <typename T>
+std::size_t IntegralComponentArray<T>::GetCapacityLeft() const
+{
+    // Indexed by entity, every entity has a slot
+    return componentArray.size();
+}
+
+template <typename T>
+void IntegralComponentArray<T>::AddComponentsUntyped(std::span<const Entity> entities, std::span<const Component* const> prototypes,
+                                                     std::span<ComponentID> ids)
+{
+    assert(prototypes.size() == entities.size() && ids.size() == entities.size());
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        assert(entities[i] < MAX_ENTITIES);
+        componentArray[entities[i]] = static_cast<const T&>(*prototypes[i]);
+        activeComponents[entities[i]] = true;
+        ids[i] = entities[i];
+    }
+}
+
+template <typename T>
+void IntegralComponentArray<T>::RemoveComponentsUntyped(std::span<const Entity> entities, std::span<ComponentID> ids)
+{
+    assert(ids.size() == entities.size());
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        assert(entities[i] < MAX_ENTITIES);
+        activeComponents[entities[i]] = false;
+        ids[i] = entities[i];
+    }
+}
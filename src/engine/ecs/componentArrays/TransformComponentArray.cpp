@@ -0,0 +1,369 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "TransformComponentArray.h"
+
+namespace engine::ecs
+{
+    TransformComponentArray::TransformComponentArray()
+    {
+        for (TransformChunk& chunk : chunks) {
+            for (size_t lane = 0; lane < TransformChunk::kSize; ++lane) {
+                chunk.positionX[lane] = chunk.positionY[lane] = chunk.positionZ[lane] = 0.0f;
+                chunk.rotationX[lane] = chunk.rotationY[lane] = chunk.rotationZ[lane] = 0.0f;
+                chunk.rotationW[lane] = 1.0f;
+                chunk.scaleX[lane] = chunk.scaleY[lane] = chunk.scaleZ[lane] = 1.0f;
+                chunk.local[lane] = kAffineIdentity;
+                chunk.world[lane] = kAffineIdentity;
+            }
+        }
+    }
+
+    ComponentID TransformComponentArray::AddComponentToEntity(Entity entity, const TransformComponent& component)
+    {
+        Write(entity, component);
+        chunkOf(entity).active |= 1u << laneOf(entity);
+        chunkOf(entity).present |= 1u << laneOf(entity);
+        return entity;
+    }
+
+    ComponentID TransformComponentArray::RemoveComponentFronEntity(Entity entity)
+    {
+        chunkOf(entity).active &= ~(1u << laneOf(entity));
+        chunkOf(entity).present &= ~(1u << laneOf(entity));
+        proxies.erase(entity);
+        return entity;
+    }
+
+    TransformComponent& TransformComponentArray::GetComponentFromEntity(Entity entity)
+    {
+        auto [proxy, inserted] = proxies.try_emplace(entity);
+        if (inserted) {
+            proxy->second = Read(entity);
+        }
+        return proxy->second;
+    }
+
+    bool TransformComponentArray::HasComponent(Entity entity) const
+    {
+        return chunkOf(entity).present & (1u << laneOf(entity));
+    }
+
+    void TransformComponentArray::SetComponentActive(Entity entity, bool active)
+    {
+        if (active) {
+            chunkOf(entity).active |= 1u << laneOf(entity);
+        } else {
+            chunkOf(entity).active &= ~(1u << laneOf(entity));
+        }
+    }
+
+    bool TransformComponentArray::IsComponentActive(Entity entity) const
+    {
+        return chunkOf(entity).active & (1u << laneOf(entity));
+    }
+
+    void TransformComponentArray::CommitProxies()
+    {
+        for (const auto& [entity, proxy] : proxies) {
+            // Fields assigned directly don't raise isDirty, so the values are compared too
+            if (proxy.isDirty || proxy.position != streamPosition(entity) || proxy.rotation != streamRotation(entity) ||
+                proxy.scale != streamScale(entity)) {
+                Write(entity, proxy);
+            }
+        }
+        proxies.clear();
+    }
+
+    TransformComponent TransformComponentArray::Read(Entity entity) const
+    {
+        const TransformChunk& chunk = chunkOf(entity);
+        const size_t lane = laneOf(entity);
+
+        TransformComponent component;
+        component.position = GetPosition(entity);
+        component.rotation = GetRotation(entity);
+        component.scale = GetScale(entity);
+        component.localMatrix = ToMat4(chunk.local[lane]);
+        component.globalMatrix = ToMat4(chunk.world[lane]);
+        component.isDirty = IsDirty(entity);
+        return component;
+    }
+
+    void TransformComponentArray::Write(Entity entity, const TransformComponent& component)
+    {
+        SetPosition(entity, component.position);
+        SetRotation(entity, component.rotation);
+        SetScale(entity, component.scale);
+    }
+
+    glm::vec3 TransformComponentArray::GetPosition(Entity entity) const
+    {
+        const TransformComponent* proxy = findProxy(entity);
+        return proxy ? proxy->position : streamPosition(entity);
+    }
+
+    glm::quat TransformComponentArray::GetRotation(Entity entity) const
+    {
+        const TransformComponent* proxy = findProxy(entity);
+        return proxy ? proxy->rotation : streamRotation(entity);
+    }
+
+    glm::vec3 TransformComponentArray::GetScale(Entity entity) const
+    {
+        const TransformComponent* proxy = findProxy(entity);
+        return proxy ? proxy->scale : streamScale(entity);
+    }
+
+    TransformComponent* TransformComponentArray::findProxy(Entity entity)
+    {
+        // Usually there are none, hot callers don't pay for the lookup
+        if (proxies.empty()) {
+            return nullptr;
+        }
+        const auto proxy = proxies.find(entity);
+        return proxy != proxies.end() ? &proxy->second : nullptr;
+    }
+
+    const TransformComponent* TransformComponentArray::findProxy(Entity entity) const
+    {
+        if (proxies.empty()) {
+            return nullptr;
+        }
+        const auto proxy = proxies.find(entity);
+        return proxy != proxies.end() ? &proxy->second : nullptr;
+    }
+
+    glm::vec3 TransformComponentArray::streamPosition(Entity entity) const
+    {
+        const TransformChunk& chunk = chunkOf(entity);
+        const size_t lane = laneOf(entity);
+        return {chunk.positionX[lane], chunk.positionY[lane], chunk.positionZ[lane]};
+    }
+
+    glm::quat TransformComponentArray::streamRotation(Entity entity) const
+    {
+        const TransformChunk& chunk = chunkOf(entity);
+        const size_t lane = laneOf(entity);
+        return {chunk.rotationW[lane], chunk.rotationX[lane], chunk.rotationY[lane], chunk.rotationZ[lane]};
+    }
+
+    glm::vec3 TransformComponentArray::streamScale(Entity entity) const
+    {
+        const TransformChunk& chunk = chunkOf(entity);
+        const size_t lane = laneOf(entity);
+        return {chunk.scaleX[lane], chunk.scaleY[lane], chunk.scaleZ[lane]};
+    }
+
+    void TransformComponentArray::SetPosition(Entity entity, const glm::vec3& position)
+    {
+        TransformChunk& chunk = chunkOf(entity);
+        const size_t lane = laneOf(entity);
+        chunk.positionX[lane] = position.x;
+        chunk.positionY[lane] = position.y;
+        chunk.positionZ[lane] = position.z;
+        chunk.dirty |= 1u << lane;
+        // An outstanding proxy would otherwise put its older value back on commit
+        if (TransformComponent* proxy = findProxy(entity)) {
+            proxy->position = position;
+        }
+    }
+
+    void TransformComponentArray::SetRotation(Entity entity, const glm::quat& rotation)
+    {
+        TransformChunk& chunk = chunkOf(entity);
+        const size_t lane = laneOf(entity);
+        chunk.rotationX[lane] = rotation.x;
+        chunk.rotationY[lane] = rotation.y;
+        chunk.rotationZ[lane] = rotation.z;
+        chunk.rotationW[lane] = rotation.w;
+        chunk.dirty |= 1u << lane;
+        if (TransformComponent* proxy = findProxy(entity)) {
+            proxy->rotation = rotation;
+        }
+    }
+
+    void TransformComponentArray::SetScale(Entity entity, const glm::vec3& scale)
+    {
+        TransformChunk& chunk = chunkOf(entity);
+        const size_t lane = laneOf(entity);
+        chunk.scaleX[lane] = scale.x;
+        chunk.scaleY[lane] = scale.y;
+        chunk.scaleZ[lane] = scale.z;
+        chunk.dirty |= 1u << lane;
+        if (TransformComponent* proxy = findProxy(entity)) {
+            proxy->scale = scale;
+        }
+    }
+
+    void TransformComponentArray::ComposeLocalMatrices()
+    {
+        const AffineKernels& kernels = GetAffineKernels();
+        for (TransformChunk& chunk : chunks) {
+            if (!chunk.dirty) {
+                continue;
+            }
+            // Every lane of a touched chunk, clean lanes come out the same and the kernel stays branch free
+            const TRSStreams trs{chunk.positionX, chunk.positionY, chunk.positionZ, chunk.rotationX, chunk.rotationY,
+                                 chunk.rotationZ, chunk.rotationW, chunk.scaleX, chunk.scaleY, chunk.scaleZ};
+            kernels.compose(trs, TransformChunk::kSize, chunk.local);
+        }
+    }
+
+    void TransformComponentArray::ClearDirty()
+    {
+        for (TransformChunk& chunk : chunks) {
+            chunk.dirty = 0;
+        }
+    }
+
+    ComponentID TransformComponentArray::AddComponentUntyped(Entity entity)
+    {
+        return AddComponentToEntity(entity, TransformComponent());
+    }
+
+    Component& TransformComponentArray::GetComponentUntyped(Entity entity)
+    {
+        return GetComponentFromEntity(entity);
+    }
+
+    void TransformComponentArray::RemoveComponentUntyped(Entity entity)
+    {
+        RemoveComponentFronEntity(entity);
+    }
+
+    bool TransformComponentArray::HasComponentUntyped(Entity entity) const
+    {
+        return HasComponent(entity);
+    }
+
+    void TransformComponentArray::SetComponentActiveUntyped(Entity entity, bool active)
+    {
+        SetComponentActive(entity, active);
+    }
+
+    bool TransformComponentArray::IsComponentActiveUntyped(Entity entity) const
+    {
+        return IsComponentActive(entity);
+    }
+
+    void TransformComponentArray::SerializeToJson(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const
+    {
+        // Same layout as IntegralComponentArray, scenes saved before transforms were split load unchanged
+        rapidjson::Value components(rapidjson::kArrayType);
+        for (Entity entity = 0; entity < MAX_ENTITIES; ++entity) {
+            if (!IsComponentActive(entity)) {
+                continue;
+            }
+            rapidjson::Value componentObj(rapidjson::kObjectType);
+            componentObj.AddMember("entity", static_cast<uint64_t>(entity), allocator);
+
+            rapidjson::Value componentData(rapidjson::kObjectType);
+            Read(entity).SerializeComponentToJson(componentData, allocator);
+            componentObj.AddMember("data", componentData, allocator);
+
+            components.PushBack(componentObj, allocator);
+        }
+        obj.AddMember("components", components, allocator);
+    }
+
+    void TransformComponentArray::DeserializeFromJson(const rapidjson::Value& obj)
+    {
+        proxies.clear();
+        for (TransformChunk& chunk : chunks) {
+            chunk.active = 0;
+            chunk.present = 0;
+        }
+        if (!obj.HasMember("components") || !obj["components"].IsArray()) {
+            return;
+        }
+        for (const auto& componentObj : obj["components"].GetArray()) {
+            if (componentObj.HasMember("entity") && componentObj.HasMember("data")) {
+                const Entity entity = componentObj["entity"].GetUint64();
+                TransformComponent component;
+                component.DeserializeComponentFromJson(componentObj["data"]);
+                AddComponentToEntity(entity, component);
+            }
+        }
+    }
+
+    void TransformComponentArray::SerializeToBinary(SceneBinaryPoolData& pool) const
+    {
+        using Record = TransformComponent::Record;
+        pool.recordSize = sizeof(Record);
+        pool.version = SceneRecordVersion<TransformComponent>();
+        for (Entity entity = 0; entity < MAX_ENTITIES; ++entity) {
+            if (!IsComponentActive(entity)) {
+                continue;
+            }
+            const Record record{GetPosition(entity), GetRotation(entity), GetScale(entity)};
+            const auto* bytes = reinterpret_cast<const std::byte*>(&record);
+            pool.records.insert(pool.records.end(), bytes, bytes + sizeof(Record));
+            pool.slots.push_back({entity, 1});
+        }
+    }
+
+    bool TransformComponentArray::DeserializeFromBinary(const SceneBinaryPoolView& pool)
+    {
+        for (const SceneBinarySlot& slot : pool.slots) {
+            if (slot.entity >= MAX_ENTITIES) {
+                return false;
+            }
+        }
+
+        // Read aside first, a pool that doesn't match leaves the array as it was
+        std::vector<TransformComponent> loaded(pool.slots.size());
+        if (!ReadSceneRecords<TransformComponent>(pool, [&loaded](size_t index) -> TransformComponent& { return loaded[index]; })) {
+            return false;
+        }
+
+        proxies.clear();
+        for (TransformChunk& chunk : chunks) {
+            chunk.active = 0;
+            chunk.present = 0;
+        }
+        for (size_t i = 0; i < loaded.size(); ++i) {
+            const Entity entity = pool.slots[i].entity;
+            Write(entity, loaded[i]);
+            chunkOf(entity).present |= 1u << laneOf(entity);
+            SetComponentActive(entity, pool.slots[i].active != 0);
+        }
+        return true;
+    }
+
+    ComponentTypeID TransformComponentArray::GetComponentTypeIDUntyped() const
+    {
+        return GetComponentTypeID<TransformComponent>();
+    }
+
+    std::unique_ptr<Component> TransformComponentArray::CreatePrototypeFromJson(const rapidjson::Value& data) const
+    {
+        auto prototype = std::make_unique<TransformComponent>();
+        prototype->DeserializeComponentFromJson(data);
+        return prototype;
+    }
+
+    std::size_t TransformComponentArray::GetCapacityLeft() const
+    {
+        // Indexed by entity, every entity has a slot
+        return MAX_ENTITIES;
+    }
+
+    void TransformComponentArray::AddComponentsUntyped(std::span<const Entity> entities, std::span<const Component* const> prototypes,
+                                                       std::span<ComponentID> ids)
+    {
+        assert(prototypes.size() == entities.size() && ids.size() == entities.size());
+        for (std::size_t i = 0; i < entities.size(); ++i) {
+            ids[i] = AddComponentToEntity(entities[i], static_cast<const TransformComponent&>(*prototypes[i]));
+        }
+    }
+
+    void TransformComponentArray::RemoveComponentsUntyped(std::span<const Entity> entities, std::span<ComponentID> ids)
+    {
+        assert(ids.size() == entities.size());
+        for (std::size_t i = 0; i < entities.size(); ++i) {
+            ids[i] = RemoveComponentFronEntity(entities[i]);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef TRANSFORMCOMPONENTARRAY_H
+#define TRANSFORMCOMPONENTARRAY_H
+
+#include <array>
+#include <cassert>
+#include <span>
+#include <unordered_map>
+
+#include "IComponentArray.h"
+#include "systems/transformSystem/AffineKernels.h"
+#include "systems/transformSystem/componets/TransformComponent.hpp"
+
+namespace engine::ecs
+{
+    // Transforms of kSize consecutive entities as structure of arrays. Every stream starts on its own cache line, so
+    // building matrices and reading world matrices walks contiguous memory instead of 200 byte components
+    struct alignas(64) TransformChunk {
+        static constexpr size_t kSize = 16;     // One cache line of floats per stream
+
+        float positionX[kSize], positionY[kSize], positionZ[kSize];
+        float rotationX[kSize], rotationY[kSize], rotationZ[kSize], rotationW[kSize];
+        float scaleX[kSize], scaleY[kSize], scaleZ[kSize];
+        Affine local[kSize];
+        Affine world[kSize];
+        uint32_t dirty = 0;         // Lanes whose TRS changed since local was built
+        uint32_t active = 0;
+        uint32_t present = 0;       // Lanes that have a transform, active or not
+    };
+    static_assert(TransformChunk::kSize <= 32, "Chunk masks are 32 bits");
+
+    // Transform storage, indexed by entity like IntegralComponentArray. Hot code goes through the stream accessors.
+    // Editor and serialization code keeps working on TransformComponent: GetComponentFromEntity hands out a proxy
+    // copy that CommitProxies writes back, TransformSystem commits them before building matrices. Until then the
+    // stream getters and serialization read through the proxy, and the stream setters write through it, so whichever
+    // write came last wins and nothing is lost by saving between updates
+    class TransformComponentArray : public IComponentArray {
+    public:
+        static constexpr size_t kChunkCount = (MAX_ENTITIES + TransformChunk::kSize - 1) / TransformChunk::kSize;
+
+        TransformComponentArray();
+
+        ComponentID AddComponentToEntity(Entity entity, const TransformComponent& component);
+        ComponentID RemoveComponentFronEntity(Entity entity);
+        // Proxy, valid until the next CommitProxies
+        TransformComponent& GetComponentFromEntity(Entity entity);
+        bool HasComponent(Entity entity) const;
+        void SetComponentActive(Entity entity, bool active);
+        bool IsComponentActive(Entity entity) const;
+        void CommitProxies();
+
+        // Streams, pending proxy writes included. Matrices only catch up with them on CommitProxies
+        TransformComponent Read(Entity entity) const;
+        void Write(Entity entity, const TransformComponent& component);
+        glm::vec3 GetPosition(Entity entity) const;
+        glm::quat GetRotation(Entity entity) const;
+        glm::vec3 GetScale(Entity entity) const;
+        void SetPosition(Entity entity, const glm::vec3& position);
+        void SetRotation(Entity entity, const glm::quat& rotation);
+        void SetScale(Entity entity, const glm::vec3& scale);
+        glm::mat4 GetLocalMatrix(Entity entity) const { return ToMat4(GetLocalAffine(entity)); }
+        glm::mat4 GetWorldMatrix(Entity entity) const { return ToMat4(GetWorldAffine(entity)); }
+        void SetWorldMatrix(Entity entity, const glm::mat4& world) { GetWorldAffine(entity) = ToAffine(world); }
+        const Affine& GetLocalAffine(Entity entity) const { return chunkOf(entity).local[laneOf(entity)]; }
+        const Affine& GetWorldAffine(Entity entity) const { return chunkOf(entity).world[laneOf(entity)]; }
+        Affine& GetWorldAffine(Entity entity) { return chunkOf(entity).world[laneOf(entity)]; }
+        bool IsDirty(Entity entity) const { return chunkOf(entity).dirty & (1u << laneOf(entity)); }
+        // World matrix of the entity and its children is rebuilt next update, e.g. after reparenting
+        void MarkDirty(Entity entity) { chunkOf(entity).dirty |= 1u << laneOf(entity); }
+        std::span<TransformChunk> GetChunks() { return chunks; }
+        std::span<const TransformChunk> GetChunks() const { return chunks; }
+
+        // Rebuilds local matrices of chunks with dirty lanes using the CPU's best kernels, the dirty bits stay set for
+        // the hierarchy pass to see
+        void ComposeLocalMatrices();
+        void ClearDirty();
+
+        // Untyped interface overrides
+        ComponentID AddComponentUntyped(Entity entity) override;
+        Component& GetComponentUntyped(Entity entity) override;
+        void RemoveComponentUntyped(Entity entity) override;
+        bool HasComponentUntyped(Entity entity) const override;
+        void SetComponentActiveUntyped(Entity entity, bool active) override;
+        bool IsComponentActiveUntyped(Entity entity) const override;
+
+        void SerializeToJson(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const override;
+        void DeserializeFromJson(const rapidjson::Value& obj) override;
+        void SerializeToBinary(SceneBinaryPoolData& pool) const override;
+        bool DeserializeFromBinary(const SceneBinaryPoolView& pool) override;
+        ComponentTypeID GetComponentTypeIDUntyped() const override;
+        std::unique_ptr<Component> CreatePrototypeFromJson(const rapidjson::Value& data) const override;
+        std::size_t GetCapacityLeft() const override;
+        void AddComponentsUntyped(std::span<const Entity> entities, std::span<const Component* const> prototypes,
+                                  std::span<ComponentID> ids) override;
+        void RemoveComponentsUntyped(std::span<const Entity> entities, std::span<ComponentID> ids) override;
+
+    private:
+        static size_t laneOf(Entity entity) { return entity % TransformChunk::kSize; }
+        TransformChunk& chunkOf(Entity entity) { assert(entity < MAX_ENTITIES); return chunks[entity / TransformChunk::kSize]; }
+        const TransformChunk& chunkOf(Entity entity) const { assert(entity < MAX_ENTITIES); return chunks[entity / TransformChunk::kSize]; }
+        TransformComponent* findProxy(Entity entity);
+        const TransformComponent* findProxy(Entity entity) const;
+        glm::vec3 streamPosition(Entity entity) const;
+        glm::quat streamRotation(Entity entity) const;
+        glm::vec3 streamScale(Entity entity) const;
+
+        std::array<TransformChunk, kChunkCount> chunks;
+        std::unordered_map<Entity, TransformComponent> proxies;
+    };
+}
+
+#endif //TRANSFORMCOMPONENTARRAY_H
@@ -1,5 +1,16 @@
 #include "CollisionSystem.hpp"
 
+#include <algorithm>
+#include <any>
+#include <bitset>
+#include <limits>
+#include <vector>
+
+#include "Asset.hpp"
+#include "AssetManagerInterface.h"
+#include "MeshBVH.hpp"
+#include "assetDatas/MeshData.h"
+#include "assetDatas/ModelData.h"
 #include "ecs/Scene.h"
 #include "systems/renderingSystem/componets/CameraComponent.hpp"
 #include "systems/renderingSystem/componets/RendererComponent.hpp"
@@ -13,13 +24,10 @@ Ray CollisionSystem::ScreenToWorldRay(const CameraComponent& camera,
     float x = (2.0f * screenX) / windowWidth - 1.0f;
     float y = (2.0f * screenY) / windowHeight - 1.0f;
 
-    // Get view and projection matrices
-    glm::mat4 projection = camera.projection;
-    glm::mat4 view = camera.view;
-    
     // Unproject near and far points
-    glm::vec4 nearPoint = glm::inverse(projection * view) * glm::vec4(x, y, -1.0f, 1.0f);
-    glm::vec4 farPoint = glm::inverse(projection * view) * glm::vec4(x, y, 1.0f, 1.0f);
+    const glm::mat4 inverseViewProjection = glm::inverse(camera.projection * camera.view);
+    glm::vec4 nearPoint = inverseViewProjection * glm::vec4(x, y, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverseViewProjection * glm::vec4(x, y, 1.0f, 1.0f);
     
     // Convert to 3D points
     nearPoint /= nearPoint.w;
@@ -32,36 +40,112 @@ Ray CollisionSystem::ScreenToWorldRay(const CameraComponent& camera,
     return ray;
 }
 
+Frustum CollisionSystem::ScreenRectToFrustum(const CameraComponent& camera, float x0, float y0, float x1, float y1,
+                                             float windowWidth, float windowHeight) const {
+    // Rectangle in normalized device coordinates, kept a pixel wide so a click still selects
+    const float minX = (2.0f * std::min(x0, x1)) / windowWidth - 1.0f;
+    const float maxX = (2.0f * std::max(std::max(x0, x1), std::min(x0, x1) + 1.0f)) / windowWidth - 1.0f;
+    const float minY = (2.0f * std::min(y0, y1)) / windowHeight - 1.0f;
+    const float maxY = (2.0f * std::max(std::max(y0, y1), std::min(y0, y1) + 1.0f)) / windowHeight - 1.0f;
+
+    // Scales and moves the rectangle onto the whole clip space, the planes of the result bound the rectangle
+    glm::mat4 rectangle(1.0f);
+    rectangle[0][0] = 2.0f / (maxX - minX);
+    rectangle[1][1] = 2.0f / (maxY - minY);
+    rectangle[3][0] = -(maxX + minX) / (maxX - minX);
+    rectangle[3][1] = -(maxY + minY) / (maxY - minY);
+    return Frustum::FromMatrix(rectangle * camera.projection * camera.view);
+}
+
 bool CollisionSystem::RayIntersectsAABB(const Ray& ray, const glm::vec3& boxMin, const glm::vec3& boxMax,
                                       const glm::mat4& worldMatrix, float& outDistance) {
-    glm::vec3 modifiedDirection = ray.direction;
-    const float epsilon = 1e-6f;  // Small value to avoid division by zero
+    return RaySlab(ray).Intersect(TransformAABB(boxMin, boxMax, worldMatrix), std::numeric_limits<float>::max(), outDistance);
+}
 
-    if (modifiedDirection.x == 0.0f) modifiedDirection.x = epsilon;
-    if (modifiedDirection.y == 0.0f) modifiedDirection.y = epsilon;
-    if (modifiedDirection.z == 0.0f) modifiedDirection.z = epsilon;
+size_t CollisionSystem::QueryAABB(const AABB& box, std::span<Entity> out) const {
+    size_t count = 0;
+    broadphase.Query(box, [&](uint32_t entity) {
+        if (worldBounds[entity].Overlaps(box))
+        {
+            if (count < out.size())
+            {
+                out[count] = entity;
+            }
+            ++count;
+        }
+    });
+    return count;
+}
 
-    glm::vec3 worldMin = glm::vec3(worldMatrix * glm::vec4(boxMin, 1.0f));
-    glm::vec3 worldMax = glm::vec3(worldMatrix * glm::vec4(boxMax, 1.0f));
-    
-    glm::vec3 dirfrac = 1.0f / ray.direction;
-    
-    float t1 = (worldMin.x - ray.origin.x) * dirfrac.x;
-    float t2 = (worldMax.x - ray.origin.x) * dirfrac.x;
-    float t3 = (worldMin.y - ray.origin.y) * dirfrac.y;
-    float t4 = (worldMax.y - ray.origin.y) * dirfrac.y;
-    float t5 = (worldMin.z - ray.origin.z) * dirfrac.z;
-    float t6 = (worldMax.z - ray.origin.z) * dirfrac.z;
-    
-    float tmin = std::max(std::max(std::min(t1, t2), std::min(t3, t4)), std::min(t5, t6));
-    float tmax = std::min(std::min(std::max(t1, t2), std::max(t3, t4)), std::max(t5, t6));
-    
-    if (tmax >= 0 && tmin <= tmax) {
-        outDistance = tmin;
-        return true;
+size_t CollisionSystem::QuerySphere(const Sphere& sphere, std::span<Entity> out) const {
+    size_t count = 0;
+    broadphase.Query(sphere.Bounds(), [&](uint32_t entity) {
+        if (sphere.Overlaps(worldBounds[entity]))
+        {
+            if (count < out.size())
+            {
+                out[count] = entity;
+            }
+            ++count;
+        }
+    });
+    return count;
+}
+
+size_t CollisionSystem::QueryFrustum(const Frustum& frustum, std::span<Entity> out) const {
+    size_t count = 0;
+    broadphase.Query(frustum, [&](uint32_t entity) {
+        if (frustum.Overlaps(worldBounds[entity]))
+        {
+            if (count < out.size())
+            {
+                out[count] = entity;
+            }
+            ++count;
+        }
+    });
+    return count;
+}
+
+void CollisionSystem::Update(float /*deltaTime*/) {
+    SyncBroadphase();
+}
+
+void CollisionSystem::SyncBroadphase() {
+    auto modelArray = scene->GetComponentArray<RendererComponent>();
+    auto& models = modelArray->GetComponents();
+    auto transforms = scene->GetTransformArray();
+
+    std::bitset<MAX_ENTITIES> present;
+    for (ComponentID i = 0; i < modelArray->GetArraySize(); i++)
+    {
+        if (!modelArray->IsComponentActive(i) || models[i].modelUuid == boost::uuids::nil_uuid())
+        {
+            continue;
+        }
+        Entity entity = modelArray->ComponentIndexToEntity(i);
+        present.set(entity);
+
+        worldBounds[entity] = TransformAABB(models[i].boundingBoxMin, models[i].boundingBoxMax, transforms->GetWorldMatrix(entity));
+        if (proxies[entity] == DynamicAABBTree::kNullNode)
+        {
+            proxies[entity] = broadphase.CreateProxy(worldBounds[entity], entity);
+        }
+        else
+        {
+            broadphase.MoveProxy(proxies[entity], worldBounds[entity]);
+        }
+    }
+
+    // Entities that lost their model, or were destroyed
+    for (Entity entity = 0; entity < MAX_ENTITIES; ++entity)
+    {
+        if (proxies[entity] != DynamicAABBTree::kNullNode && !present[entity])
+        {
+            broadphase.DestroyProxy(proxies[entity]);
+            proxies[entity] = DynamicAABBTree::kNullNode;
+        }
     }
-    
-    return false;
 }
 
 std::optional<RayHit> CollisionSystem::RayCastClosest(const Ray& ray) {
@@ -69,32 +153,146 @@ std::optional<RayHit> CollisionSystem::RayCastClosest(const Ray& ray) {
     closestHit.distance = std::numeric_limits<float>::max();
     bool hasHit = false;
 
-    auto modelArray = scene->GetComponentArray<RendererComponent>().get();
-    auto& models = modelArray->GetComponents();
-    auto& transforms = scene->GetIntegralComponentArray<TransformComponent>().get()->GetComponents();
+    // The tree only has fat boxes, the exact bounds decide
+    const RaySlab slab(ray);
+    broadphase.RayCast(ray, closestHit.distance, [&](uint32_t entity, float) {
+        float entry;
+        if (!slab.Intersect(worldBounds[entity], closestHit.distance, entry) || entry >= closestHit.distance)
+        {
+            return closestHit.distance;
+        }
+        if (auto distance = IntersectModel(entity, ray, closestHit.distance, entry))
+        {
+            closestHit.entity = entity;
+            closestHit.distance = *distance;
+            hasHit = true;
+        }
+        return closestHit.distance;
+    });
 
-    // Only iterate up to the actual size of used components
-    for (ComponentID i = 0; i < modelArray->GetArraySize(); i++)
+    if (!hasHit)
     {
-            Entity entity = modelArray->ComponentIndexToEntity(i);
-            if (models[i].modelUuid != boost::uuids::nil_uuid())
+        return std::nullopt;
+    }
+    closestHit.hitPoint = ray.origin + ray.direction * closestHit.distance;
+    return closestHit;
+}
+
+void CollisionSystem::RayCastClosest(std::span<const Ray> rays, std::span<std::optional<RayHit>> hits) {
+    assert(rays.size() == hits.size());
+    std::vector<RaySlab> slabs;
+    slabs.reserve(rays.size());
+    for (const Ray& ray : rays)
+    {
+        slabs.emplace_back(ray);
+    }
+    std::vector<float> closest(rays.size(), std::numeric_limits<float>::max());
+    std::ranges::fill(hits, std::nullopt);
+
+    broadphase.RayCastPacket(rays, closest, [&](size_t rayIndex, uint32_t entity, float) {
+        float entry;
+        if (!slabs[rayIndex].Intersect(worldBounds[entity], closest[rayIndex], entry) || entry >= closest[rayIndex])
+        {
+            return closest[rayIndex];
+        }
+        if (auto distance = IntersectModel(entity, rays[rayIndex], closest[rayIndex], entry))
+        {
+            hits[rayIndex] = RayHit{entity, *distance, rays[rayIndex].origin + rays[rayIndex].direction * *distance};
+            return *distance;
+        }
+        return closest[rayIndex];
+    });
+}
+
+struct CollisionSystem::AssetPins {
+    explicit AssetPins(am::AssetManagerInterface& assets) : assets(assets) {}
+    AssetPins(const AssetPins&) = delete;
+    AssetPins& operator=(const AssetPins&) = delete;
+    ~AssetPins()
+    {
+        for (const boost::uuids::uuid& id : pinned)
+        {
+            assets.releaseAsset(id);
+        }
+    }
+
+    // Null for unknown ids, failed loads and other asset types
+    template<typename T>
+    T* Acquire(const boost::uuids::uuid& id)
+    {
+        am::Asset* asset = assets.acquireAsset(id);
+        if (!asset)
+        {
+            return nullptr;
+        }
+        pinned.push_back(id);
+        std::any data = asset->getAssetData();
+        auto* typed = std::any_cast<T*>(&data);
+        return typed ? *typed : nullptr;
+    }
+
+    am::AssetManagerInterface& assets;
+    std::vector<boost::uuids::uuid> pinned;
+};
+
+std::optional<float> CollisionSystem::IntersectModel(Entity entity, const Ray& ray, float maxDistance, float boundsEntry) {
+    auto* assets = scene->engine.assetManagerInterface;
+    if (!assets)
+    {
+        return boundsEntry;
+    }
+
+    AssetPins pins(*assets);
+    auto* modelData = pins.Acquire<am::ModelData>(scene->GetComponent<RendererComponent>(entity).modelUuid);
+    if (!modelData)
+    {
+        return boundsEntry;
+    }
+
+    float closest = maxDistance;
+    const bool hasTriangles = IntersectNode(modelData->rootNode, scene->GetTransformArray()->GetWorldMatrix(entity), ray, closest, pins);
+    if (!hasTriangles)
+    {
+        return boundsEntry;
+    }
+    if (closest >= maxDistance)
+    {
+        return std::nullopt;
+    }
+    return closest;
+}
+
+bool CollisionSystem::IntersectNode(const am::Node& node, const glm::mat4& worldMatrix, const Ray& ray, float& closest, AssetPins& pins) {
+    bool hasTriangles = false;
+    // Like RenderManager::renderNode, each child is placed by its own matrix on top of the model's
+    for (const am::Node& child : node.mChildren)
+    {
+        const glm::mat4 nodeMatrix = worldMatrix * child.mTransformation;
+        if (!child.meshes.empty())
+        {
+            // Affine, so distances along the local ray match the world ones
+            const glm::mat4 inverse = glm::inverse(nodeMatrix);
+            const glm::vec3 localOrigin = glm::vec3(inverse * glm::vec4(ray.origin, 1.0f));
+            const glm::vec3 localDirection = glm::vec3(inverse * glm::vec4(ray.direction, 0.0f));
+
+            for (const auto& meshInfo : child.meshes)
             {
-                float distance;
-                if (RayIntersectsAABB(ray, models[i].boundingBoxMin, models[i].boundingBoxMax,
-                                      transforms[entity].globalMatrix, distance))
+                const auto* meshData = pins.Acquire<am::MeshData>(meshInfo->id);
+                if (!meshData || meshData->getBvhNodes().empty())
                 {
-                    if (distance < closestHit.distance) {
-                        closestHit.entity = entity;
-                        closestHit.distance = distance;
-                        closestHit.hitPoint = ray.origin + ray.direction * distance;
-                        hasHit = true;
-                    }
+                    continue;
+                }
+                hasTriangles = true;
+                if (auto hit = am::intersectMeshBVH(meshData->getBvhNodes(), meshData->getBvhPackets(),
+                                                    localOrigin, localDirection, closest))
+                {
+                    closest = hit->distance;
                 }
             }
+        }
+        hasTriangles |= IntersectNode(child, worldMatrix, ray, closest, pins);
     }
-
-
-    return hasHit ? std::optional<RayHit>(closestHit) : std::nullopt;
+    return hasTriangles;
 }
 
 } // namespace engine::ecs
\ No newline at end of file
@@ -2,46 +2,83 @@
 #ifndef REASONABLEVULKAN_COLLISIONSYSTEM_HPP
 #define REASONABLEVULKAN_COLLISIONSYSTEM_HPP
 
+#include <array>
+#include <optional>
+#include <span>
 #include <typeindex>
 
+#include "DynamicAABBTree.h"
 #include "ecs/System.h"
 #include <glm/glm.hpp>
 
-
+namespace am {
+    struct Node;
+}
 
 namespace engine::ecs {
     struct TransformComponent;
     struct CameraComponent;
 
-    struct Ray {
-        glm::vec3 origin;
-        glm::vec3 direction;
-    };
-
     struct RayHit {
         Entity entity;
         float distance;
         glm::vec3 hitPoint;
     };
 
+    // Ray casts and region queries against every RendererComponent. The world bounds live in a dynamic AABB tree that
+    // Update keeps in sync, queries see the scene as of the last update. Models hit by a ray's bounds test are then
+    // tested against the triangle trees of their meshes, models without mesh data count as solid boxes
     class CollisionSystem : public System<CollisionSystem> {
     public:
-        CollisionSystem(Scene* scene) : System(scene) {}
-        void Update(float deltaTime) override {};
+        CollisionSystem(Scene* scene) : System(scene) { proxies.fill(DynamicAABBTree::kNullNode); }
+        void Update(float deltaTime) override;
         // Convert screen coordinates to world ray
         Ray ScreenToWorldRay(const CameraComponent& camera,
                              float screenX, float screenY, float windowWidth, float windowHeight);
+        // Frustum through a screen rectangle, for marquee selection. Corners in any order, in the same space as
+        // ScreenToWorldRay
+        Frustum ScreenRectToFrustum(const CameraComponent& camera, float x0, float y0, float x1, float y1,
+                                    float windowWidth, float windowHeight) const;
 
-        // Ray-AABB intersection test
+        // Ray-AABB intersection test, the box is the world space bounds of the local box
         bool RayIntersectsAABB(const Ray& ray, const glm::vec3& boxMin, const glm::vec3& boxMax,
                               const glm::mat4& worldMatrix, float& outDistance);
 
         // Find closest entity hit by ray
         std::optional<RayHit> RayCastClosest(const Ray& ray);
+        // Closest hit of every ray in one traversal, fastest when the rays are coherent (e.g. a selection rectangle)
+        void RayCastClosest(std::span<const Ray> rays, std::span<std::optional<RayHit>> hits);
+
+        // Entities whose world bounds overlap the region, in no particular order. At most out.size() are written, the
+        // return value is the total so a larger buffer can be retried. Nothing is allocated and the queries only read,
+        // any number of threads can run them as long as Update or SyncBroadphase doesn't run at the same time
+        size_t QueryAABB(const AABB& box, std::span<Entity> out) const;
+        size_t QuerySphere(const Sphere& sphere, std::span<Entity> out) const;
+        size_t QueryFrustum(const Frustum& frustum, std::span<Entity> out) const;
+
+        // Refreshes the world bounds of moved entities, Update does it every frame
+        void SyncBroadphase();
+        const DynamicAABBTree& GetBroadphase() const { return broadphase; }
+
+        // Distance to the closest triangle of the entity's model before maxDistance. boundsEntry if the model has no
+        // triangle data, nullopt if the ray passes through the bounds without touching a triangle. The model and its
+        // meshes are acquired for the test, so a memory budget can't evict them while their trees are walked
+        std::optional<float> IntersectModel(Entity entity, const Ray& ray, float maxDistance, float boundsEntry);
 
     protected:
         void OnComponentAdded(ComponentID componentID, std::type_index type) override {}
         void OnEntityRemoved(ComponentID componentID, std::type_index type) override {}
+
+    private:
+        // Assets acquired during one IntersectModel, released when it returns
+        struct AssetPins;
+
+        // Meshes of the node and its children with the matrices the renderer draws them with
+        bool IntersectNode(const am::Node& node, const glm::mat4& worldMatrix, const Ray& ray, float& closest, AssetPins& pins);
+
+        DynamicAABBTree broadphase;
+        std::array<int32_t, MAX_ENTITIES> proxies;      // Tree proxy of every entity, kNullNode if it has none
+        std::array<AABB, MAX_ENTITIES> worldBounds;     // Exact bounds, the tree stores fattened ones
     };
 
 } // namespace engine::ecs
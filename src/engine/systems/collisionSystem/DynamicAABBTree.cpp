@@ -0,0 +1,290 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "DynamicAABBTree.h"
+
+namespace engine::ecs
+{
+    RaySlab::RaySlab(const Ray& ray) : origin(ray.origin)
+    {
+        constexpr float epsilon = 1e-6f;
+        glm::vec3 direction = ray.direction;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (direction[axis] == 0.0f) {
+                direction[axis] = epsilon;
+            }
+        }
+        inverseDirection = 1.0f / direction;
+    }
+
+    Frustum Frustum::FromMatrix(const glm::mat4& viewProjection)
+    {
+        // Rows of the matrix, glm stores columns
+        glm::vec4 rows[4];
+        for (int row = 0; row < 4; ++row) {
+            rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+        }
+
+        Frustum frustum;
+        frustum.planes[Left] = rows[3] + rows[0];
+        frustum.planes[Right] = rows[3] - rows[0];
+        frustum.planes[Top] = rows[3] - rows[1];
+        frustum.planes[Bottom] = rows[3] + rows[1];
+        frustum.planes[Near] = rows[3] + rows[2];
+        frustum.planes[Far] = rows[3] - rows[2];
+        for (glm::vec4& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    int32_t DynamicAABBTree::CreateProxy(const AABB& box, uint32_t userData)
+    {
+        const int32_t proxy = AllocateNode();
+        Node& node = nodes[proxy];
+        node.box = {box.min - glm::vec3(fatMargin), box.max + glm::vec3(fatMargin)};
+        node.userData = userData;
+        node.height = 0;
+        InsertLeaf(proxy);
+        ++proxyCount;
+        return proxy;
+    }
+
+    void DynamicAABBTree::DestroyProxy(int32_t proxy)
+    {
+        assert(proxy >= 0 && proxy < static_cast<int32_t>(nodes.size()) && nodes[proxy].IsLeaf());
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        --proxyCount;
+    }
+
+    bool DynamicAABBTree::MoveProxy(int32_t proxy, const AABB& box)
+    {
+        assert(proxy >= 0 && proxy < static_cast<int32_t>(nodes.size()) && nodes[proxy].IsLeaf());
+        if (nodes[proxy].box.Contains(box)) {
+            return false;
+        }
+        RemoveLeaf(proxy);
+        nodes[proxy].box = {box.min - glm::vec3(fatMargin), box.max + glm::vec3(fatMargin)};
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void DynamicAABBTree::Clear()
+    {
+        nodes.clear();
+        root = kNullNode;
+        freeList = kNullNode;
+        proxyCount = 0;
+    }
+
+    int32_t DynamicAABBTree::AllocateNode()
+    {
+        if (freeList == kNullNode) {
+            nodes.emplace_back();
+            return static_cast<int32_t>(nodes.size() - 1);
+        }
+        const int32_t node = freeList;
+        freeList = nodes[node].parent;
+        nodes[node] = Node{};
+        return node;
+    }
+
+    void DynamicAABBTree::FreeNode(int32_t node)
+    {
+        nodes[node] = Node{};
+        nodes[node].parent = freeList;
+        freeList = node;
+    }
+
+    void DynamicAABBTree::InsertLeaf(int32_t leaf)
+    {
+        if (root == kNullNode) {
+            root = leaf;
+            nodes[root].parent = kNullNode;
+            return;
+        }
+
+        // Walk down to the sibling with the lowest surface area cost, inherited growth included
+        const AABB leafBox = nodes[leaf].box;
+        int32_t index = root;
+        while (!nodes[index].IsLeaf()) {
+            const Node& node = nodes[index];
+            const float area = node.box.SurfaceArea();
+            const float combinedArea = Union(node.box, leafBox).SurfaceArea();
+
+            // Making a new parent of this node and the leaf
+            const float cost = 2.0f * combinedArea;
+            // Every ancestor grows by this much if the leaf goes further down
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int32_t child) {
+                const AABB combined = Union(leafBox, nodes[child].box);
+                if (nodes[child].IsLeaf()) {
+                    return combined.SurfaceArea() + inheritanceCost;
+                }
+                return combined.SurfaceArea() - nodes[child].box.SurfaceArea() + inheritanceCost;
+            };
+            const float leftCost = descendCost(node.left);
+            const float rightCost = descendCost(node.right);
+
+            if (cost < leftCost && cost < rightCost) {
+                break;
+            }
+            index = leftCost < rightCost ? node.left : node.right;
+        }
+
+        const int32_t sibling = index;
+        const int32_t oldParent = nodes[sibling].parent;
+        const int32_t newParent = AllocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = Union(leafBox, nodes[sibling].box);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].left = sibling;
+        nodes[newParent].right = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        if (oldParent == kNullNode) {
+            root = newParent;
+        } else if (nodes[oldParent].left == sibling) {
+            nodes[oldParent].left = newParent;
+        } else {
+            nodes[oldParent].right = newParent;
+        }
+
+        Refit(nodes[leaf].parent);
+    }
+
+    void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+    {
+        if (leaf == root) {
+            root = kNullNode;
+            return;
+        }
+
+        const int32_t parent = nodes[leaf].parent;
+        const int32_t grandParent = nodes[parent].parent;
+        const int32_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+        if (grandParent == kNullNode) {
+            root = sibling;
+            nodes[sibling].parent = kNullNode;
+            FreeNode(parent);
+        } else {
+            // The sibling takes the parent's place
+            if (nodes[grandParent].left == parent) {
+                nodes[grandParent].left = sibling;
+            } else {
+                nodes[grandParent].right = sibling;
+            }
+            nodes[sibling].parent = grandParent;
+            FreeNode(parent);
+            Refit(grandParent);
+        }
+        nodes[leaf].parent = kNullNode;
+    }
+
+    void DynamicAABBTree::Refit(int32_t node)
+    {
+        while (node != kNullNode) {
+            node = Balance(node);
+            Node& current = nodes[node];
+            current.height = 1 + std::max(nodes[current.left].height, nodes[current.right].height);
+            current.box = Union(nodes[current.left].box, nodes[current.right].box);
+            node = current.parent;
+        }
+    }
+
+    // Rotates the taller child up if the subtree heights differ by more than one, returns the subtree's new root
+    int32_t DynamicAABBTree::Balance(int32_t iA)
+    {
+        Node& a = nodes[iA];
+        if (a.IsLeaf() || a.height < 2) {
+            return iA;
+        }
+
+        const int32_t iB = a.left;
+        const int32_t iC = a.right;
+        Node& b = nodes[iB];
+        Node& c = nodes[iC];
+        const int32_t balance = c.height - b.height;
+
+        auto replaceChild = [this](int32_t parent, int32_t oldChild, int32_t newChild) {
+            if (parent == kNullNode) {
+                root = newChild;
+            } else if (nodes[parent].left == oldChild) {
+                nodes[parent].left = newChild;
+            } else {
+                nodes[parent].right = newChild;
+            }
+        };
+
+        // C goes up, A takes C's smaller child
+        if (balance > 1) {
+            const int32_t iF = c.left;
+            const int32_t iG = c.right;
+            Node& f = nodes[iF];
+            Node& g = nodes[iG];
+
+            c.left = iA;
+            c.parent = a.parent;
+            a.parent = iC;
+            replaceChild(c.parent, iA, iC);
+
+            if (f.height > g.height) {
+                c.right = iF;
+                a.right = iG;
+                g.parent = iA;
+                a.box = Union(b.box, g.box);
+                c.box = Union(a.box, f.box);
+                a.height = 1 + std::max(b.height, g.height);
+                c.height = 1 + std::max(a.height, f.height);
+            } else {
+                c.right = iG;
+                a.right = iF;
+                f.parent = iA;
+                a.box = Union(b.box, f.box);
+                c.box = Union(a.box, g.box);
+                a.height = 1 + std::max(b.height, f.height);
+                c.height = 1 + std::max(a.height, g.height);
+            }
+            return iC;
+        }
+
+        // B goes up, A takes B's smaller child
+        if (balance < -1) {
+            const int32_t iD = b.left;
+            const int32_t iE = b.right;
+            Node& d = nodes[iD];
+            Node& e = nodes[iE];
+
+            b.left = iA;
+            b.parent = a.parent;
+            a.parent = iB;
+            replaceChild(b.parent, iA, iB);
+
+            if (d.height > e.height) {
+                b.right = iD;
+                a.left = iE;
+                e.parent = iA;
+                a.box = Union(c.box, e.box);
+                b.box = Union(a.box, d.box);
+                a.height = 1 + std::max(c.height, e.height);
+                b.height = 1 + std::max(a.height, d.height);
+            } else {
+                b.right = iE;
+                a.left = iD;
+                d.parent = iA;
+                a.box = Union(c.box, d.box);
+                b.box = Union(a.box, e.box);
+                a.height = 1 + std::max(c.height, d.height);
+                b.height = 1 + std::max(a.height, e.height);
+            }
+            return iB;
+        }
+
+        return iA;
+    }
+}
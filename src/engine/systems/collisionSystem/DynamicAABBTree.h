@@ -0,0 +1,205 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef DYNAMICAABBTREE_H
+#define DYNAMICAABBTREE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace engine::ecs
+{
+    struct Ray {
+        glm::vec3 origin;
+        glm::vec3 direction;
+    };
+
+    struct AABB {
+        glm::vec3 min;
+        glm::vec3 max;
+
+        bool Contains(const AABB& other) const
+        {
+            return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+        }
+        bool Overlaps(const AABB& other) const
+        {
+            return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+        }
+        float SurfaceArea() const
+        {
+            const glm::vec3 size = max - min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+    };
+
+    inline AABB Union(const AABB& a, const AABB& b)
+    {
+        return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+    }
+
+    // Bounds of the local box after the affine transform. Transforming only min and max is wrong as soon as the
+    // matrix rotates, the extent is projected on every world axis instead
+    inline AABB TransformAABB(const glm::vec3& localMin, const glm::vec3& localMax, const glm::mat4& worldMatrix)
+    {
+        const glm::vec3 center = glm::vec3(worldMatrix * glm::vec4((localMin + localMax) * 0.5f, 1.0f));
+        const glm::vec3 extent = (localMax - localMin) * 0.5f;
+        const glm::vec3 worldExtent = glm::abs(glm::vec3(worldMatrix[0])) * extent.x +
+                                      glm::abs(glm::vec3(worldMatrix[1])) * extent.y +
+                                      glm::abs(glm::vec3(worldMatrix[2])) * extent.z;
+        return {center - worldExtent, center + worldExtent};
+    }
+
+    struct Sphere {
+        glm::vec3 center;
+        float radius;
+
+        // Distance from the center to the closest point of the box
+        bool Overlaps(const AABB& box) const
+        {
+            const glm::vec3 offset = glm::clamp(center, box.min, box.max) - center;
+            return glm::dot(offset, offset) <= radius * radius;
+        }
+        AABB Bounds() const { return {center - glm::vec3(radius), center + glm::vec3(radius)}; }
+    };
+
+    // Planes point inwards, a point is inside when dot(plane.xyz, point) + plane.w >= 0 for all of them
+    struct Frustum {
+        enum Side { Left, Right, Top, Bottom, Near, Far };
+        static constexpr uint32_t kAllPlanes = 0b111111;
+
+        // Gribb and Hartmann extraction, clip space depth from -1 to 1 like the camera projection
+        static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+        // Bit i of the result is set if the box straddles plane i, planes outside the mask are skipped as the box is
+        // already known to be inside them. Returns false if the box is outside any plane
+        bool Classify(const AABB& box, uint32_t planeMask, uint32_t& straddling) const
+        {
+            const glm::vec3 center = (box.min + box.max) * 0.5f;
+            const glm::vec3 extent = (box.max - box.min) * 0.5f;
+            straddling = 0;
+            for (uint32_t i = 0; i < planes.size(); ++i) {
+                if (!(planeMask & (1u << i))) {
+                    continue;
+                }
+                const glm::vec3 normal(planes[i]);
+                const float distance = glm::dot(normal, center) + planes[i].w;
+                const float radius = glm::dot(glm::abs(normal), extent);
+                if (distance < -radius) {
+                    return false;
+                }
+                if (distance < radius) {
+                    straddling |= 1u << i;
+                }
+            }
+            return true;
+        }
+        bool Overlaps(const AABB& box) const
+        {
+            uint32_t straddling;
+            return Classify(box, kAllPlanes, straddling);
+        }
+
+        std::array<glm::vec4, 6> planes;
+    };
+
+    // Ray prepared for slab tests, zero direction components are nudged so the reciprocal stays finite
+    struct RaySlab {
+        explicit RaySlab(const Ray& ray);
+
+        // Distance along the ray where it enters the box, clamped to the origin. False if it misses within maxDistance
+        bool Intersect(const AABB& box, float maxDistance, float& entry) const
+        {
+            const glm::vec3 t1 = (box.min - origin) * inverseDirection;
+            const glm::vec3 t2 = (box.max - origin) * inverseDirection;
+            const glm::vec3 tNear = glm::min(t1, t2);
+            const glm::vec3 tFar = glm::max(t1, t2);
+            const float tMin = std::max(std::max(std::max(tNear.x, tNear.y), tNear.z), 0.0f);
+            const float tMax = std::min(std::min(std::min(tFar.x, tFar.y), tFar.z), maxDistance);
+            entry = tMin;
+            return tMin <= tMax;
+        }
+
+        glm::vec3 origin;
+        glm::vec3 inverseDirection;
+    };
+
+    // Dynamic bounding volume hierarchy over fattened boxes. Leaves are inserted next to the sibling that grows the
+    // surface area least and the tree is kept height balanced with rotations, so moving a proxy only touches the
+    // path to the root, and only when it leaves its fat box. The tree itself grows without limit, CollisionSystem only
+    // ever holds one proxy per entity, so at most MAX_ENTITIES
+    class DynamicAABBTree
+    {
+    public:
+        static constexpr int32_t kNullNode = -1;
+
+        explicit DynamicAABBTree(float fatMargin = 0.1f) : fatMargin(fatMargin) {}
+
+        int32_t CreateProxy(const AABB& box, uint32_t userData);
+        void DestroyProxy(int32_t proxy);
+        // False if the box still fits the fat box and the tree is unchanged
+        bool MoveProxy(int32_t proxy, const AABB& box);
+        void Clear();
+
+        uint32_t GetUserData(int32_t proxy) const { return nodes[proxy].userData; }
+        const AABB& GetFatAABB(int32_t proxy) const { return nodes[proxy].box; }
+        size_t GetProxyCount() const { return proxyCount; }
+        int32_t GetHeight() const { return root == kNullNode ? 0 : nodes[root].height; }
+
+        // Visits leaves the ray enters before maxDistance, nearest child first. callback(userData, entry) returns the
+        // distance the ray is clipped to from then on, returning the current maximum keeps it as is
+        template<typename Callback>
+        void RayCast(const Ray& ray, float maxDistance, Callback&& callback) const;
+
+        // One traversal for a packet of rays, a node is opened when any ray of the packet still reaches it.
+        // callback(rayIndex, userData, entry) returns the new maximum of that ray, maxDistances holds them afterwards
+        template<typename Callback>
+        void RayCastPacket(std::span<const Ray> rays, std::span<float> maxDistances, Callback&& callback) const;
+
+        // Visits leaves whose fat box overlaps the box
+        template<typename Callback>
+        void Query(const AABB& box, Callback&& callback) const;
+
+        // Visits leaves whose fat box is at least partly inside the frustum. Subtrees found fully inside are reported
+        // without testing them again
+        template<typename Callback>
+        void Query(const Frustum& frustum, Callback&& callback) const;
+
+    private:
+        struct Node {
+            AABB box;
+            int32_t parent = kNullNode;         // Next free node while on the free list
+            int32_t left = kNullNode;
+            int32_t right = kNullNode;
+            int32_t height = -1;                // 0 for leaves, -1 for free nodes
+            uint32_t userData = 0;
+
+            bool IsLeaf() const { return left == kNullNode; }
+        };
+
+        // Deep enough for any height balanced tree that fits in memory
+        static constexpr size_t kStackSize = 256;
+
+        int32_t AllocateNode();
+        void FreeNode(int32_t node);
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+        int32_t Balance(int32_t node);
+        void Refit(int32_t node);
+
+        std::vector<Node> nodes;
+        int32_t root = kNullNode;
+        int32_t freeList = kNullNode;
+        size_t proxyCount = 0;
+        float fatMargin;
+    };
+}
+
+#include "DynamicAABBTree.tpp"
+
+#endif //DYNAMICAABBTREE_H
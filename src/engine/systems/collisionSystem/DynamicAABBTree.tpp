@@ -0,0 +1,156 @@
+//
+// Created by redkc on 19/10/2026.
+//
+#pragma once
+#include <array>
+#include <cassert>
+
+#include "DynamicAABBTree.h"
+
+namespace engine::ecs
+{
+    template<typename Callback>
+    void DynamicAABBTree::RayCast(const Ray& ray, float maxDistance, Callback&& callback) const
+    {
+        if (root == kNullNode) {
+            return;
+        }
+        const RaySlab slab(ray);
+        float entry;
+        if (!slab.Intersect(nodes[root].box, maxDistance, entry)) {
+            return;
+        }
+
+        std::array<int32_t, kStackSize> stack;
+        size_t top = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (node.IsLeaf()) {
+                // Entry was tested against an older maximum when the node was pushed
+                if (slab.Intersect(node.box, maxDistance, entry)) {
+                    maxDistance = std::min(maxDistance, callback(node.userData, entry));
+                }
+                continue;
+            }
+
+            float leftEntry, rightEntry;
+            const bool hitLeft = slab.Intersect(nodes[node.left].box, maxDistance, leftEntry);
+            const bool hitRight = slab.Intersect(nodes[node.right].box, maxDistance, rightEntry);
+            assert(top + 2 <= kStackSize);
+            // The nearer child goes on top so closest hits clip the far side early
+            if (hitLeft && hitRight) {
+                const bool leftFirst = leftEntry <= rightEntry;
+                stack[top++] = leftFirst ? node.right : node.left;
+                stack[top++] = leftFirst ? node.left : node.right;
+            } else if (hitLeft) {
+                stack[top++] = node.left;
+            } else if (hitRight) {
+                stack[top++] = node.right;
+            }
+        }
+    }
+
+    template<typename Callback>
+    void DynamicAABBTree::RayCastPacket(std::span<const Ray> rays, std::span<float> maxDistances, Callback&& callback) const
+    {
+        assert(rays.size() == maxDistances.size());
+        if (root == kNullNode || rays.empty()) {
+            return;
+        }
+        std::vector<RaySlab> slabs;
+        slabs.reserve(rays.size());
+        for (const Ray& ray : rays) {
+            slabs.emplace_back(ray);
+        }
+
+        // Each entry remembers the first ray that reached its parent, rays before it missed an ancestor already
+        struct Entry {
+            int32_t node;
+            size_t firstRay;
+        };
+        std::array<Entry, kStackSize> stack;
+        size_t top = 0;
+        stack[top++] = {root, 0};
+        while (top > 0) {
+            const auto [index, firstRay] = stack[--top];
+            const Node& node = nodes[index];
+            float entry;
+            size_t first = firstRay;
+            while (first < slabs.size() && !slabs[first].Intersect(node.box, maxDistances[first], entry)) {
+                ++first;
+            }
+            if (first == slabs.size()) {
+                continue;
+            }
+
+            if (node.IsLeaf()) {
+                maxDistances[first] = std::min(maxDistances[first], callback(first, node.userData, entry));
+                for (size_t i = first + 1; i < slabs.size(); ++i) {
+                    if (slabs[i].Intersect(node.box, maxDistances[i], entry)) {
+                        maxDistances[i] = std::min(maxDistances[i], callback(i, node.userData, entry));
+                    }
+                }
+                continue;
+            }
+            assert(top + 2 <= kStackSize);
+            stack[top++] = {node.right, first};
+            stack[top++] = {node.left, first};
+        }
+    }
+
+    template<typename Callback>
+    void DynamicAABBTree::Query(const AABB& box, Callback&& callback) const
+    {
+        if (root == kNullNode) {
+            return;
+        }
+        std::array<int32_t, kStackSize> stack;
+        size_t top = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (!node.box.Overlaps(box)) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                callback(node.userData);
+            } else {
+                assert(top + 2 <= kStackSize);
+                stack[top++] = node.right;
+                stack[top++] = node.left;
+            }
+        }
+    }
+
+    template<typename Callback>
+    void DynamicAABBTree::Query(const Frustum& frustum, Callback&& callback) const
+    {
+        if (root == kNullNode) {
+            return;
+        }
+        // Each entry keeps the planes its parent straddled, the others are already known to contain it
+        struct Entry {
+            int32_t node;
+            uint32_t planeMask;
+        };
+        std::array<Entry, kStackSize> stack;
+        size_t top = 0;
+        stack[top++] = {root, Frustum::kAllPlanes};
+        while (top > 0) {
+            const auto [index, parentMask] = stack[--top];
+            const Node& node = nodes[index];
+            uint32_t planeMask = 0;
+            if (parentMask != 0 && !frustum.Classify(node.box, parentMask, planeMask)) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                callback(node.userData);
+            } else {
+                assert(top + 2 <= kStackSize);
+                stack[top++] = {node.right, planeMask};
+                stack[top++] = {node.left, planeMask};
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 //
 
 #include "EditorSystem.hpp"
+#include <format>
 #include <imgui.h>
 #include <ImGuizmo.h>
 
@@ -26,7 +27,7 @@ void EditorSystem::ImGuiInspector()
         ImGui::Text("Selected: %s", name.c_str());
 
 
-        auto componentArrays = scene->GetComponentArrays();
+        const auto& componentArrays = scene->GetComponentArrays();
 
         for (auto& [typeIndex, array] : componentArrays)
         {
@@ -66,7 +67,7 @@ void EditorSystem::ImGuiGizmo()
 {
     if (selectedEntity != std::numeric_limits<std::uint32_t>::max())
     {
-        auto& transform = scene->GetIntegralComponentArray<TransformComponent>().get()->GetComponentFromEntity(selectedEntity);
+        auto& transform = scene->GetTransformArray()->GetComponentFromEntity(selectedEntity);
 
         static ImGuizmo::OPERATION currentGizmoOperation(ImGuizmo::ROTATE);
         static ImGuizmo::MODE currentGizmoMode(ImGuizmo::WORLD);
@@ -178,8 +179,8 @@ void EditorSystem::ImGuiGizmo()
             auto it = scene->sceneGraph.find(selectedEntity);
             if (it != scene->sceneGraph.end() && it->second.parent != MAX_ENTITIES)
             {
-                auto& parentTransform = scene->GetIntegralComponentArray<TransformComponent>().get()->GetComponentFromEntity(it->second.parent);
-                setLocalMatrixFromGlobal(transform, newGlobalMatrix, parentTransform.globalMatrix);
+                const glm::mat4 parentGlobalMatrix = scene->GetTransformArray()->GetWorldMatrix(it->second.parent);
+                setLocalMatrixFromGlobal(transform, newGlobalMatrix, parentGlobalMatrix);
             }
             else
             {
@@ -231,6 +232,86 @@ void EditorSystem::ImguiShaderOverrideWindow()
     ImGui::End();
 }
 
+void EditorSystem::ImguiTextureStreamingWindow()
+{
+    ImGui::Begin("Texture Streaming");
+
+    auto stats = scene->engine.graphicsEngine->getTextureStreamingStats();
+    constexpr float megabyte = 1024.0f * 1024.0f;
+
+    int budgetMb = static_cast<int>(stats.budgetBytes / (1024 * 1024));
+    if (ImGui::DragInt("Budget (MB)", &budgetMb, 16.0f, 64, 16384)) {
+        scene->engine.graphicsEngine->setTextureMemoryBudget(static_cast<uint64_t>(budgetMb) * 1024 * 1024);
+    }
+
+    float usage = stats.budgetBytes > 0 ? static_cast<float>(stats.residentBytes) / static_cast<float>(stats.budgetBytes) : 0.0f;
+    std::string usageLabel = std::format("{:.1f} / {:.1f} MB", stats.residentBytes / megabyte, stats.budgetBytes / megabyte);
+    ImGui::ProgressBar(usage, ImVec2(-1.0f, 0.0f), usageLabel.c_str());
+    ImGui::Text("Streamed in: %u  Evicted: %u", stats.streamedInLastFrame, stats.evictedLastFrame);
+
+    if (ImGui::BeginTable("Residency", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Texture");
+        ImGui::TableSetupColumn("Resident");
+        ImGui::TableSetupColumn("Wanted");
+        ImGui::TableSetupColumn("MB");
+        ImGui::TableSetupColumn("Idle frames");
+        ImGui::TableHeadersRow();
+
+        for (const auto& texture : stats.textures) {
+            ImGui::TableNextRow();
+
+            ImGui::TableNextColumn();
+            auto info = scene->engine.assetManagerInterface->getAssetInfo(texture.textureId);
+            std::string name = info.has_value() && !info.value()->lookUpName.empty()
+                                   ? info.value()->lookUpName
+                                   : boost::uuids::to_string(texture.textureId);
+            ImGui::TextUnformatted(name.c_str());
+
+            ImGui::TableNextColumn();
+            ImGui::Text("mip %u (%ux%u)", texture.residentBaseMip,
+                        std::max(1u, texture.width >> texture.residentBaseMip),
+                        std::max(1u, texture.height >> texture.residentBaseMip));
+
+            ImGui::TableNextColumn();
+            ImGui::Text("mip %u / %u", texture.targetBaseMip, texture.mipCount);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", texture.residentBytes / megabyte);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(texture.framesSinceRequested));
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+void EditorSystem::ImguiFrameMemoryWindow()
+{
+    ImGui::Begin("Frame Memory");
+
+    constexpr float kilobyte = 1024.0f;
+    auto showArena = [&](const char* label, const gfx::FrameArenaStats& stats) {
+        ImGui::SeparatorText(label);
+        ImGui::Text("Used: %.1f KB  Peak: %.1f KB  Reserved: %.1f KB", stats.usedBytes / kilobyte,
+                    stats.peakUsedBytes / kilobyte, stats.capacityBytes / kilobyte);
+        ImGui::Text("Arena blocks: %u this frame, %u last frame, %llu total", stats.blockAllocations,
+                    stats.lastFrameBlockAllocations, static_cast<unsigned long long>(stats.totalBlockAllocations));
+        if (stats.heapAllocationsTracked) {
+            ImGui::Text("Heap allocations: %llu this frame, %llu last frame",
+                        static_cast<unsigned long long>(stats.heapAllocations),
+                        static_cast<unsigned long long>(stats.lastFrameHeapAllocations));
+        } else {
+            ImGui::TextDisabled("Heap allocations: not tracked");
+        }
+    };
+    showArena("Renderer", scene->engine.graphicsEngine->getFrameArenaStats());
+    showArena("Scene", scene->GetFrameArenaStats());
+
+    ImGui::End();
+}
+
 void engine::ecs::EditorSystem::Update(float deltaTime)
 {
     if (scene->engine.minimized)
@@ -277,6 +358,7 @@ void engine::ecs::EditorSystem::Update(float deltaTime)
         ImGui::DockBuilderDockWindow("Inspector", dock_right);
         ImGui::DockBuilderDockWindow("Toolbar", dock_top);
         ImGui::DockBuilderDockWindow("Menu", dock_bottom);
+        ImGui::DockBuilderDockWindow("Texture Streaming", dock_bottom);
 
         ImGui::DockBuilderFinish(dockspace_id);
     }
@@ -307,10 +389,10 @@ void engine::ecs::EditorSystem::Update(float deltaTime)
     }
     ImGui::End();
 
-    auto& cameras = scene->GetComponentArray<CameraComponent>().get()->GetComponents();
+    auto& cameras = scene->GetComponentArray<CameraComponent>()->GetComponents();
     bool foundActive = false;
-    for (int i = 0; i < scene->GetComponentArray<CameraComponent>().get()->GetArraySize(); i++) {
-        if (scene->GetComponentArray<CameraComponent>().get()->IsComponentActive(i) && cameras[i].active) {
+    for (int i = 0; i < scene->GetComponentArray<CameraComponent>()->GetArraySize(); i++) {
+        if (scene->GetComponentArray<CameraComponent>()->IsComponentActive(i) && cameras[i].active) {
             foundActive = true;
             break;
         }
@@ -332,6 +414,8 @@ void engine::ecs::EditorSystem::Update(float deltaTime)
     ImGuiInspector();
     ImGuiGizmo();
     ImguiShaderOverrideWindow();
+    ImguiTextureStreamingWindow();
+    ImguiFrameMemoryWindow();
 
     ImGui::End();
 }
@@ -380,7 +464,7 @@ void EditorSystem::SetUpCameraControls(plt::PlatformInterface* platform)
             isLeftMousePressed = true;
 
             if (!ImGui::GetIO().WantCaptureMouse) {
-                auto* collisionSystem = scene->GetSystem<CollisionSystem>().get();
+                auto* collisionSystem = scene->GetSystem<CollisionSystem>();
                 if (collisionSystem) {
                     ImGui::Begin("Editor");
                     ImVec2 viewportPos = ImGui::GetWindowPos();
@@ -88,6 +88,8 @@ namespace engine::ecs
         void ImGuiInspector();
         void ImGuiGizmo();
         void ImguiShaderOverrideWindow();
+        void ImguiTextureStreamingWindow();
+        void ImguiFrameMemoryWindow();
         void ImguiToolbar();
         void ImguiMenu();
 
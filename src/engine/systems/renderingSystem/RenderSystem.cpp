@@ -17,18 +17,19 @@ void engine::ecs::RenderSystem::Update(float deltaTime)
     if (scene->engine.minimized)
         return;
 
-    auto modelArray = scene->GetComponentArray<RendererComponent>().get();
+    auto modelArray = scene->GetComponentArray<RendererComponent>();
     auto& models = modelArray->GetComponents();
 
-    auto lightArray = scene->GetComponentArray<LightComponent>().get();
+    auto lightArray = scene->GetComponentArray<LightComponent>();
     auto& lights = lightArray->GetComponents();
 
-    auto& transforms = scene->GetIntegralComponentArray<TransformComponent>().get()->GetComponents();
+    auto transforms = scene->GetTransformArray();
 
     CameraObject cameraObject = scene->GetActiveCamera();
 
-    auto editorSystem = scene->GetSystem<EditorSystem>();
-    bool inEditMode = editorSystem->inEditMode;
+    // Only registered in editor builds
+    auto* editorSystem = scene->GetSystem<EditorSystem>();
+    bool inEditMode = editorSystem && editorSystem->inEditMode;
 
     int width, height;
 #ifdef ENABLE_IMGUI
@@ -55,16 +56,16 @@ void engine::ecs::RenderSystem::Update(float deltaTime)
         activeCameraCount = 1;
 
         // Camera 1 is the active scene camera (if any)
-        auto& cameras = scene->GetComponentArray<CameraComponent>().get()->GetComponents();
-        auto& cameraTransforms = scene->GetIntegralComponentArray<TransformComponent>().get()->GetComponents();
-        for (int i = 0; i < scene->GetComponentArray<CameraComponent>().get()->GetArraySize(); i++) {
-            if (scene->GetComponentArray<CameraComponent>().get()->IsComponentActive(i) && cameras[i].active) {
-                auto cameraEntity = scene->GetComponentArray<CameraComponent>().get()->ComponentIndexToEntity(i);
-                updateViewMatrix(cameras[i], cameraTransforms[cameraEntity].globalMatrix);
+        auto* cameraArray = scene->GetComponentArray<CameraComponent>();
+        auto& cameras = cameraArray->GetComponents();
+        for (int i = 0; i < cameraArray->GetArraySize(); i++) {
+            if (cameraArray->IsComponentActive(i) && cameras[i].active) {
+                auto cameraEntity = cameraArray->ComponentIndexToEntity(i);
+                updateViewMatrix(cameras[i], transforms->GetWorldMatrix(cameraEntity));
                 cameras[i].aspectRatio = aspectRatio;
                 updateProjectionMatrix(cameras[i]);
                 scene->engine.graphicsEngine->setCameraData(1, cameras[i].projection, cameras[i].view,
-                                                            cameraTransforms[cameraEntity].position);
+                                                            transforms->GetPosition(cameraEntity));
                 if (cameras[i].skyboxMaterialId != boost::uuids::nil_uuid()) {
                     scene->engine.graphicsEngine->drawSkybox(1, cameras[i].skyboxMaterialId, boost::uuids::nil_uuid());
                 }
@@ -73,12 +74,12 @@ void engine::ecs::RenderSystem::Update(float deltaTime)
             }
         }
     } else {
-        updateViewMatrix(*cameraObject.camera, cameraObject.transform->globalMatrix);
+        updateViewMatrix(*cameraObject.camera, cameraObject.worldMatrix);
         cameraObject.camera->aspectRatio = aspectRatio;
         updateProjectionMatrix(*cameraObject.camera);
 
         scene->engine.graphicsEngine->setCameraData(0, cameraObject.camera->projection, cameraObject.camera->view,
-                                                    cameraObject.transform->position);
+                                                    cameraObject.position);
 
         if (cameraObject.camera->skyboxMaterialId != boost::uuids::nil_uuid()) {
             scene->engine.graphicsEngine->drawSkybox(0, cameraObject.camera->skyboxMaterialId, boost::uuids::nil_uuid());
@@ -96,18 +97,24 @@ void engine::ecs::RenderSystem::Update(float deltaTime)
             Entity entity = modelArray->ComponentIndexToEntity(i);
             if (models[i].modelUuid != boost::uuids::nil_uuid())
             {
+                const glm::mat4 worldMatrix = transforms->GetWorldMatrix(entity);
                 for (int camIdx = 0; camIdx < activeCameraCount; ++camIdx) {
                     boost::uuids::uuid currentShader = models[i].shaderUuid;
+                    uint32_t currentPermutation = models[i].shaderPermutation;
                     if (inEditMode && camIdx == 0) { // Only override for the editor camera
+                        // The mask's bits are the model's program's axes, they mean nothing to the override
                         if (editorSystem->currentShaderOverride == EditorSystem::ShaderOverrideMode::Wiremesh) {
                             currentShader = editorSystem->wiremeshShaderId;
+                            currentPermutation = 0;
                         } else if (editorSystem->currentShaderOverride == EditorSystem::ShaderOverrideMode::TexturedWiremesh) {
                             currentShader = editorSystem->wiremeshTexturedShaderId;
+                            currentPermutation = 0;
                         }
                     }
 
-                    scene->engine.graphicsEngine->drawModel(camIdx, models[i].modelUuid, currentShader,
-                                                            transforms[entity].globalMatrix);
+                    scene->engine.graphicsEngine->drawModel(camIdx, models[i].modelUuid, currentShader, currentPermutation,
+                                                            worldMatrix,
+                                                            models[i].boundingBoxMin, models[i].boundingBoxMax);
                 }
             }
         }
@@ -135,7 +142,7 @@ void engine::ecs::RenderSystem::Update(float deltaTime)
                             pointData.shadowBias,
                             pointData.shadowStrength
                     };
-                    scene->engine.graphicsEngine->drawLight(lightData, transforms[entity].globalMatrix);
+                    scene->engine.graphicsEngine->drawLight(lightData, transforms->GetWorldMatrix(entity));
                     break;
                 }
                 case LightComponent::Type::Spot:
@@ -151,7 +158,7 @@ void engine::ecs::RenderSystem::Update(float deltaTime)
                             spotData.shadowBias,
                             spotData.shadowStrength
                     };
-                    scene->engine.graphicsEngine->drawLight(lightData, transforms[entity].globalMatrix);
+                    scene->engine.graphicsEngine->drawLight(lightData, transforms->GetWorldMatrix(entity));
                     break;
                 }
                 case LightComponent::Type::Directional:
@@ -164,7 +171,7 @@ void engine::ecs::RenderSystem::Update(float deltaTime)
                             dirData.shadowBias,
                             dirData.shadowStrength
                     };
-                    scene->engine.graphicsEngine->drawLight(lightData, transforms[entity].globalMatrix);
+                    scene->engine.graphicsEngine->drawLight(lightData, transforms->GetWorldMatrix(entity));
                     break;
                 }
                 default:
@@ -178,7 +185,7 @@ void RenderSystem::OnComponentAdded(ComponentID componentID, std::type_index typ
 {
   if (type == typeid(RendererComponent))
   {
-      auto& model = scene->GetComponentArray<RendererComponent>().get()->GetComponent(componentID);
+      auto& model = scene->GetComponentArray<RendererComponent>()->GetComponent(componentID);
 
       if (model.modelUuid == boost::uuids::nil_uuid())
           return;
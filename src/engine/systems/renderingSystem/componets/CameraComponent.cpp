@@ -87,3 +87,18 @@ void CameraComponent::DeserializeComponentFromJson(const rapidjson::Value& obj)
     isDirty = true;
 }
 
+CameraComponent::Record CameraComponent::ToRecord() const
+{
+    return {fov, aspectRatio, nearPlane, farPlane, skyboxMaterialId, active};
+}
+
+void CameraComponent::FromRecord(const Record& record)
+{
+    fov = record.fov;
+    aspectRatio = record.aspectRatio;
+    nearPlane = record.nearPlane;
+    farPlane = record.farPlane;
+    skyboxMaterialId = record.skyboxMaterialId;
+    active = record.active != 0;
+    isDirty = true;
+}
@@ -29,6 +29,18 @@ namespace engine::ecs
 
         void SerializeComponentToJson(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const override;
         void DeserializeComponentFromJson(const rapidjson::Value& obj) override;
+
+        // Binary scenes, the matrices are rebuilt from these
+        struct Record {
+            float fov;
+            float aspectRatio;
+            float nearPlane;
+            float farPlane;
+            boost::uuids::uuid skyboxMaterialId;
+            uint32_t active;
+        };
+        Record ToRecord() const;
+        void FromRecord(const Record& record);
     };
 
 
@@ -3,6 +3,7 @@
 // Created by redkc on 22/12/2025.
 //
 
+#include <cstring>
 #include <imgui.h>
 #include "LightComponent.hpp"
 #include "ecs/Scene.h"
@@ -146,4 +147,25 @@ void engine::ecs::LightComponent::DeserializeComponentFromJson(const rapidjson::
             // No extra data
             break;
     }
-}
\ No newline at end of file
+}
+
+engine::ecs::LightComponent::Record engine::ecs::LightComponent::ToRecord() const
+{
+    Record record{static_cast<uint32_t>(type), color, intensity, hasShadow, {}};
+    std::visit([&record](const auto& lightData) {
+        static_assert(sizeof(lightData) <= sizeof(record.data));
+        std::memcpy(record.data, &lightData, sizeof(lightData));
+    }, data);
+    return record;
+}
+
+void engine::ecs::LightComponent::FromRecord(const Record& record)
+{
+    setType(record.type <= static_cast<uint32_t>(Type::Spot) ? static_cast<Type>(record.type) : Type::Point);
+    color = record.color;
+    intensity = record.intensity;
+    hasShadow = record.hasShadow != 0;
+    std::visit([&record](auto& lightData) {
+        std::memcpy(&lightData, record.data, sizeof(lightData));
+    }, data);
+}
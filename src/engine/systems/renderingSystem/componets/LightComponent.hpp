@@ -62,6 +62,17 @@ namespace engine::ecs
         void SerializeComponentToJson(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const override;
         void DeserializeComponentFromJson(const rapidjson::Value& obj) override;
 
+        // Binary scenes, the fields of the active light data in declaration order
+        struct Record {
+            uint32_t type;
+            glm::vec3 color;
+            float intensity;
+            uint32_t hasShadow;
+            float data[5];
+        };
+        Record ToRecord() const;
+        void FromRecord(const Record& record);
+
     private:
         Type type;
     };
@@ -6,7 +6,9 @@
 
 #include "Asset.hpp"
 #include "AssetTypes.hpp"
+#include "AssetInfo.hpp"
 #include "assetDatas/ModelData.h"
+#include "assetDatas/ShaderProgramData.h"
 #include "ecs/Scene.h"
 
 
@@ -51,6 +53,33 @@ void RendererComponent::ShowImGui(Scene* scene, Component* component) const
             ImGui::EndPopup();
         }
 
+        // One checkbox per axis of the program, the renderer reports a variant that wasn't compiled and draws mask 0
+        const auto shaderInfo = scene->engine.assetManagerInterface->getAssetInfo(typed->shaderUuid);
+        if (!typed->shaderUuid.is_nil() && shaderInfo && shaderInfo.value()->type == am::AssetType::ShaderProgram)
+        {
+            auto programData = scene->engine.assetManagerInterface->getAssetData<am::ShaderProgramData>(typed->shaderUuid);
+            if (!programData)
+            {
+                // Program failed to load, its axes are unknown so the mask is only shown
+                ImGui::BeginDisabled();
+                int mask = static_cast<int>(typed->shaderPermutation);
+                ImGui::InputInt("Shader permutation", &mask);
+                ImGui::EndDisabled();
+            }
+            else
+            {
+                for (const auto& axis : programData->permutationAxes)
+                {
+                    const uint32_t bit = programData->getPermutationBit(axis);
+                    bool enabled = (typed->shaderPermutation & bit) != 0;
+                    if (ImGui::Checkbox(axis.c_str(), &enabled))
+                    {
+                        typed->shaderPermutation = enabled ? typed->shaderPermutation | bit : typed->shaderPermutation & ~bit;
+                    }
+                }
+            }
+        }
+
         ImGui::DragVec3("Min bounding box", typed->boundingBoxMin);
         ImGui::DragVec3("Max bounding box", typed->boundingBoxMax);
     }
@@ -68,6 +97,8 @@ void RendererComponent::SerializeComponentToJson(rapidjson::Value& obj, rapidjso
     std::string shaderUuidString = boost::uuids::to_string(shaderUuid);
     shaderUuidStr.SetString(shaderUuidString.c_str(), allocator);
     obj.AddMember("shaderUuid", shaderUuidStr, allocator);
+
+    obj.AddMember("shaderPermutation", shaderPermutation, allocator);
 }
 
 void RendererComponent::DeserializeComponentFromJson(const rapidjson::Value& obj)
@@ -82,4 +113,19 @@ void RendererComponent::DeserializeComponentFromJson(const rapidjson::Value& obj
         boost::uuids::string_generator gen;
         shaderUuid = gen(uuidStr);
     }
+    if (obj.HasMember("shaderPermutation") && obj["shaderPermutation"].IsUint()) {
+        shaderPermutation = obj["shaderPermutation"].GetUint();
+    }
+}
+
+RendererComponent::Record RendererComponent::ToRecord() const
+{
+    return {modelUuid, shaderUuid, shaderPermutation};
+}
+
+void RendererComponent::FromRecord(const Record& record)
+{
+    modelUuid = record.modelUuid;
+    shaderUuid = record.shaderUuid;
+    shaderPermutation = record.shaderPermutation;
 }
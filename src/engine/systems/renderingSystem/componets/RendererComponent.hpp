@@ -5,6 +5,7 @@
 #ifndef REASONABLEVULKAN_MODEL_HPP
 #define REASONABLEVULKAN_MODEL_HPP
 
+#include <cstdint>
 #include <boost/uuid/nil_generator.hpp>
 #include <boost/uuid/string_generator.hpp>
 #include <boost/uuid/uuid.hpp>
@@ -19,6 +20,8 @@ namespace engine::ecs
     {
         boost::uuids::uuid modelUuid;
         boost::uuids::uuid shaderUuid;
+        // Axis bits of the shader program's variant to draw with, see ShaderProgramData::getPermutationBit
+        uint32_t shaderPermutation = 0;
         glm::vec3 boundingBoxMin;
         glm::vec3 boundingBoxMax;
 
@@ -29,6 +32,18 @@ namespace engine::ecs
 
         void SerializeComponentToJson(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const override;
         void DeserializeComponentFromJson(const rapidjson::Value& obj) override;
+
+        // Binary scenes
+        struct Record {
+            // 2 appended shaderPermutation
+            static constexpr uint32_t kVersion = 2;
+
+            boost::uuids::uuid modelUuid;
+            boost::uuids::uuid shaderUuid;
+            uint32_t shaderPermutation;
+        };
+        Record ToRecord() const;
+        void FromRecord(const Record& record);
     };
 }
 
@@ -0,0 +1,332 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "AffineKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ENGINE_AFFINE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC emits any intrinsic without flags, GCC and Clang need the target on each function using it
+#if defined(ENGINE_AFFINE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define AFFINE_TARGET(features) __attribute__((target(features)))
+#else
+#define AFFINE_TARGET(features)
+#endif
+
+namespace engine::ecs
+{
+    namespace
+    {
+        // Reference path, also handles the tails of the SIMD paths
+        void ComposeScalarRange(const TRSStreams& trs, std::size_t first, std::size_t end, Affine* out)
+        {
+            for (std::size_t i = first; i < end; ++i) {
+                const float x = trs.rotationX[i], y = trs.rotationY[i], z = trs.rotationZ[i], w = trs.rotationW[i];
+                const float xx = x * x, yy = y * y, zz = z * z;
+                const float xy = x * y, xz = x * z, yz = y * z;
+                const float wx = w * x, wy = w * y, wz = w * z;
+                const float sx = trs.scaleX[i], sy = trs.scaleY[i], sz = trs.scaleZ[i];
+
+                Affine& affine = out[i];
+                affine.rows[0][0] = (1.0f - 2.0f * (yy + zz)) * sx;
+                affine.rows[0][1] = 2.0f * (xy - wz) * sy;
+                affine.rows[0][2] = 2.0f * (xz + wy) * sz;
+                affine.rows[0][3] = trs.positionX[i];
+                affine.rows[1][0] = 2.0f * (xy + wz) * sx;
+                affine.rows[1][1] = (1.0f - 2.0f * (xx + zz)) * sy;
+                affine.rows[1][2] = 2.0f * (yz - wx) * sz;
+                affine.rows[1][3] = trs.positionY[i];
+                affine.rows[2][0] = 2.0f * (xz - wy) * sx;
+                affine.rows[2][1] = 2.0f * (yz + wx) * sy;
+                affine.rows[2][2] = (1.0f - 2.0f * (xx + yy)) * sz;
+                affine.rows[2][3] = trs.positionZ[i];
+            }
+        }
+
+        void ComposeScalar(const TRSStreams& trs, std::size_t count, Affine* out)
+        {
+            ComposeScalarRange(trs, 0, count, out);
+        }
+
+        void MultiplyScalar(const Affine& parent, const Affine& local, Affine& out)
+        {
+            Affine result;
+            for (int row = 0; row < 3; ++row) {
+                const float* p = parent.rows[row];
+                for (int column = 0; column < 4; ++column) {
+                    result.rows[row][column] = p[0] * local.rows[0][column] + p[1] * local.rows[1][column] +
+                                               p[2] * local.rows[2][column];
+                }
+                result.rows[row][3] += p[3];
+            }
+            out = result;
+        }
+
+        // Batch of levels without a wider register to pair products in, one product after the other
+        template <void (*Multiply)(const Affine&, const Affine&, Affine&)>
+        void MultiplyEach(const Affine* const* parents, const Affine* const* locals, Affine* const* out, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i) {
+                Multiply(*parents[i], *locals[i], *out[i]);
+            }
+        }
+
+#ifdef ENGINE_AFFINE_X86
+        // Rows of an affine transform as lanes of 4 transforms, written out as one row per transform
+        AFFINE_TARGET("sse4.1")
+        inline void StoreRowsSSE(__m128 c0, __m128 c1, __m128 c2, __m128 c3, int row, Affine* out)
+        {
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            _mm_store_ps(out[0].rows[row], c0);
+            _mm_store_ps(out[1].rows[row], c1);
+            _mm_store_ps(out[2].rows[row], c2);
+            _mm_store_ps(out[3].rows[row], c3);
+        }
+
+        AFFINE_TARGET("sse4.1")
+        void ComposeSSE(const TRSStreams& trs, std::size_t count, Affine* out)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128 x = _mm_loadu_ps(trs.rotationX + i), y = _mm_loadu_ps(trs.rotationY + i);
+                const __m128 z = _mm_loadu_ps(trs.rotationZ + i), w = _mm_loadu_ps(trs.rotationW + i);
+                const __m128 sx = _mm_loadu_ps(trs.scaleX + i), sy = _mm_loadu_ps(trs.scaleY + i), sz = _mm_loadu_ps(trs.scaleZ + i);
+
+                const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+                const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+                const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+                const __m128 r00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+                const __m128 r01 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+                const __m128 r02 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+                const __m128 r10 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+                const __m128 r11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+                const __m128 r12 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+                const __m128 r20 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+                const __m128 r21 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+                const __m128 r22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+
+                StoreRowsSSE(r00, r01, r02, _mm_loadu_ps(trs.positionX + i), 0, out + i);
+                StoreRowsSSE(r10, r11, r12, _mm_loadu_ps(trs.positionY + i), 1, out + i);
+                StoreRowsSSE(r20, r21, r22, _mm_loadu_ps(trs.positionZ + i), 2, out + i);
+            }
+            ComposeScalarRange(trs, i, count, out);
+        }
+
+        AFFINE_TARGET("sse4.1")
+        void MultiplySSE(const Affine& parent, const Affine& local, Affine& out)
+        {
+            const __m128 l0 = _mm_load_ps(local.rows[0]);
+            const __m128 l1 = _mm_load_ps(local.rows[1]);
+            const __m128 l2 = _mm_load_ps(local.rows[2]);
+            const __m128 p0 = _mm_load_ps(parent.rows[0]);
+            const __m128 p1 = _mm_load_ps(parent.rows[1]);
+            const __m128 p2 = _mm_load_ps(parent.rows[2]);
+            const __m128 p[3] = {p0, p1, p2};
+            for (int row = 0; row < 3; ++row) {
+                __m128 result = _mm_mul_ps(_mm_shuffle_ps(p[row], p[row], _MM_SHUFFLE(0, 0, 0, 0)), l0);
+                result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(p[row], p[row], _MM_SHUFFLE(1, 1, 1, 1)), l1));
+                result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(p[row], p[row], _MM_SHUFFLE(2, 2, 2, 2)), l2));
+                // Translation of the parent row lands in the last column only
+                result = _mm_add_ps(result, _mm_blend_ps(_mm_setzero_ps(), p[row], 0b1000));
+                _mm_store_ps(out.rows[row], result);
+            }
+        }
+
+        // 4x4 transpose inside each 128 bit half: lane k of the low half and lane k + 4 of the high half
+        AFFINE_TARGET("avx2,fma")
+        inline void StoreRowsAVX(__m256 c0, __m256 c1, __m256 c2, __m256 c3, int row, Affine* out)
+        {
+            const __m256 t0 = _mm256_unpacklo_ps(c0, c1), t1 = _mm256_unpacklo_ps(c2, c3);
+            const __m256 t2 = _mm256_unpackhi_ps(c0, c1), t3 = _mm256_unpackhi_ps(c2, c3);
+            const __m256 lanes[4] = {
+                _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)),
+                _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2)),
+            };
+            for (int k = 0; k < 4; ++k) {
+                _mm_store_ps(out[k].rows[row], _mm256_castps256_ps128(lanes[k]));
+                _mm_store_ps(out[k + 4].rows[row], _mm256_extractf128_ps(lanes[k], 1));
+            }
+        }
+
+        AFFINE_TARGET("avx2,fma")
+        void ComposeAVX2(const TRSStreams& trs, std::size_t count, Affine* out)
+        {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 two = _mm256_set1_ps(2.0f);
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256 x = _mm256_loadu_ps(trs.rotationX + i), y = _mm256_loadu_ps(trs.rotationY + i);
+                const __m256 z = _mm256_loadu_ps(trs.rotationZ + i), w = _mm256_loadu_ps(trs.rotationW + i);
+                const __m256 sx = _mm256_loadu_ps(trs.scaleX + i), sy = _mm256_loadu_ps(trs.scaleY + i);
+                const __m256 sz = _mm256_loadu_ps(trs.scaleZ + i);
+
+                const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+                const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+                const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+                const __m256 r00 = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx);
+                const __m256 r01 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+                const __m256 r02 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+                const __m256 r10 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+                const __m256 r11 = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy);
+                const __m256 r12 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+                const __m256 r20 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+                const __m256 r21 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+                const __m256 r22 = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz);
+
+                StoreRowsAVX(r00, r01, r02, _mm256_loadu_ps(trs.positionX + i), 0, out + i);
+                StoreRowsAVX(r10, r11, r12, _mm256_loadu_ps(trs.positionY + i), 1, out + i);
+                StoreRowsAVX(r20, r21, r22, _mm256_loadu_ps(trs.positionZ + i), 2, out + i);
+            }
+            ComposeScalarRange(trs, i, count, out);
+        }
+
+        AFFINE_TARGET("avx2,fma")
+        void MultiplyAVX2(const Affine& parent, const Affine& local, Affine& out)
+        {
+            const __m128 l0 = _mm_load_ps(local.rows[0]);
+            const __m128 l1 = _mm_load_ps(local.rows[1]);
+            const __m128 l2 = _mm_load_ps(local.rows[2]);
+            const __m128 p[3] = {_mm_load_ps(parent.rows[0]), _mm_load_ps(parent.rows[1]), _mm_load_ps(parent.rows[2])};
+            for (int row = 0; row < 3; ++row) {
+                __m128 result = _mm_blend_ps(_mm_setzero_ps(), p[row], 0b1000);
+                result = _mm_fmadd_ps(_mm_permute_ps(p[row], _MM_SHUFFLE(0, 0, 0, 0)), l0, result);
+                result = _mm_fmadd_ps(_mm_permute_ps(p[row], _MM_SHUFFLE(1, 1, 1, 1)), l1, result);
+                result = _mm_fmadd_ps(_mm_permute_ps(p[row], _MM_SHUFFLE(2, 2, 2, 2)), l2, result);
+                _mm_store_ps(out.rows[row], result);
+            }
+        }
+
+        // Two products per iteration, one in each 128 bit half
+        AFFINE_TARGET("avx2,fma")
+        void MultiplyBatchAVX2(const Affine* const* parents, const Affine* const* locals, Affine* const* out, std::size_t count)
+        {
+            std::size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                const Affine& parentA = *parents[i];
+                const Affine& parentB = *parents[i + 1];
+                const Affine& localA = *locals[i];
+                const Affine& localB = *locals[i + 1];
+                const __m256 l0 = _mm256_set_m128(_mm_load_ps(localB.rows[0]), _mm_load_ps(localA.rows[0]));
+                const __m256 l1 = _mm256_set_m128(_mm_load_ps(localB.rows[1]), _mm_load_ps(localA.rows[1]));
+                const __m256 l2 = _mm256_set_m128(_mm_load_ps(localB.rows[2]), _mm_load_ps(localA.rows[2]));
+                __m256 p[3];
+                for (int row = 0; row < 3; ++row) {
+                    p[row] = _mm256_set_m128(_mm_load_ps(parentB.rows[row]), _mm_load_ps(parentA.rows[row]));
+                }
+                for (int row = 0; row < 3; ++row) {
+                    __m256 result = _mm256_blend_ps(_mm256_setzero_ps(), p[row], 0b10001000);
+                    result = _mm256_fmadd_ps(_mm256_permute_ps(p[row], _MM_SHUFFLE(0, 0, 0, 0)), l0, result);
+                    result = _mm256_fmadd_ps(_mm256_permute_ps(p[row], _MM_SHUFFLE(1, 1, 1, 1)), l1, result);
+                    result = _mm256_fmadd_ps(_mm256_permute_ps(p[row], _MM_SHUFFLE(2, 2, 2, 2)), l2, result);
+                    _mm_store_ps(out[i]->rows[row], _mm256_castps256_ps128(result));
+                    _mm_store_ps(out[i + 1]->rows[row], _mm256_extractf128_ps(result, 1));
+                }
+            }
+            for (; i < count; ++i) {
+                MultiplyAVX2(*parents[i], *locals[i], *out[i]);
+            }
+        }
+
+        bool CpuHasSSE41()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            return info[2] & (1 << 19);
+#else
+            return __builtin_cpu_supports("sse4.1");
+#endif
+        }
+
+        bool CpuHasAVX2()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            const bool fma = info[2] & (1 << 12);
+            const bool osxsave = info[2] & (1 << 27);
+            const bool avx = info[2] & (1 << 28);
+            if (!fma || !osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return info[1] & (1 << 5);
+#else
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        }
+#endif
+
+        constexpr AffineKernels kScalarKernels{SimdLevel::Scalar, ComposeScalar, MultiplyScalar, MultiplyEach<MultiplyScalar>};
+#ifdef ENGINE_AFFINE_X86
+        constexpr AffineKernels kSSEKernels{SimdLevel::SSE41, ComposeSSE, MultiplySSE, MultiplyEach<MultiplySSE>};
+        constexpr AffineKernels kAVX2Kernels{SimdLevel::AVX2, ComposeAVX2, MultiplyAVX2, MultiplyBatchAVX2};
+#endif
+    }
+
+    SimdLevel DetectSimdLevel()
+    {
+#ifdef ENGINE_AFFINE_X86
+        if (CpuHasAVX2()) {
+            return SimdLevel::AVX2;
+        }
+        if (CpuHasSSE41()) {
+            return SimdLevel::SSE41;
+        }
+#endif
+        return SimdLevel::Scalar;
+    }
+
+    const AffineKernels& GetAffineKernels(SimdLevel level)
+    {
+        static const SimdLevel supported = DetectSimdLevel();
+        if (level > supported) {
+            level = supported;
+        }
+#ifdef ENGINE_AFFINE_X86
+        switch (level) {
+            case SimdLevel::AVX2:
+                return kAVX2Kernels;
+            case SimdLevel::SSE41:
+                return kSSEKernels;
+            case SimdLevel::Scalar:
+                break;
+        }
+#endif
+        return kScalarKernels;
+    }
+
+    const AffineKernels& GetAffineKernels()
+    {
+        static const AffineKernels& kernels = GetAffineKernels(DetectSimdLevel());
+        return kernels;
+    }
+
+    Affine ComposeAffine(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+    {
+        const TRSStreams trs{&position.x, &position.y, &position.z, &rotation.x, &rotation.y, &rotation.z, &rotation.w,
+                             &scale.x, &scale.y, &scale.z};
+        Affine affine;
+        ComposeScalar(trs, 1, &affine);
+        return affine;
+    }
+
+    Affine MultiplyAffine(const Affine& parent, const Affine& local)
+    {
+        Affine result;
+        GetAffineKernels().multiply(parent, local, result);
+        return result;
+    }
+}
@@ -0,0 +1,86 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef AFFINEKERNELS_H
+#define AFFINEKERNELS_H
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace engine::ecs
+{
+    // Row major 3x4 matrix. The last row of an affine transform is always 0 0 0 1 and isn't stored, every row is one
+    // aligned SSE load
+    struct alignas(16) Affine {
+        float rows[3][4];
+    };
+
+    inline constexpr Affine kAffineIdentity{{{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}}};
+
+    inline glm::mat4 ToMat4(const Affine& affine)
+    {
+        glm::mat4 matrix(1.0f);
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 3; ++row) {
+                matrix[column][row] = affine.rows[row][column];
+            }
+        }
+        return matrix;
+    }
+
+    // The projective row of the matrix is dropped
+    inline Affine ToAffine(const glm::mat4& matrix)
+    {
+        Affine affine;
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 3; ++row) {
+                affine.rows[row][column] = matrix[column][row];
+            }
+        }
+        return affine;
+    }
+
+    // Translation, rotation and scale of consecutive transforms as separate streams, the layout of TransformChunk
+    struct TRSStreams {
+        const float* positionX;
+        const float* positionY;
+        const float* positionZ;
+        const float* rotationX;
+        const float* rotationY;
+        const float* rotationZ;
+        const float* rotationW;
+        const float* scaleX;
+        const float* scaleY;
+        const float* scaleZ;
+    };
+
+    enum class SimdLevel {
+        Scalar,
+        SSE41,
+        AVX2,       // With FMA
+    };
+
+    // One code path of the transform math, picked at runtime for the CPU
+    struct AffineKernels {
+        SimdLevel level;
+        // out[i] = translate * rotate * scale of transform i, the quaternions are expected to be normalized
+        void (*compose)(const TRSStreams& trs, std::size_t count, Affine* out);
+        // out = parent * local, out may alias either input
+        void (*multiply)(const Affine& parent, const Affine& local, Affine& out);
+        // *out[i] = *parents[i] * *locals[i], outputs must not alias the inputs of another index
+        void (*multiplyBatch)(const Affine* const* parents, const Affine* const* locals, Affine* const* out, std::size_t count);
+    };
+
+    SimdLevel DetectSimdLevel();
+    // Kernels of the level, or of the best lower level this build and CPU have
+    const AffineKernels& GetAffineKernels(SimdLevel level);
+    // Best kernels for the running CPU, detected once
+    const AffineKernels& GetAffineKernels();
+
+    Affine ComposeAffine(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+    Affine MultiplyAffine(const Affine& parent, const Affine& local);
+}
+
+#endif //AFFINEKERNELS_H
@@ -6,30 +6,53 @@ using namespace engine::ecs;
 
 void TransformSystem::Update(float /*deltaTime*/)
 {
-    auto& transforms = scene->GetIntegralComponentArray<TransformComponent>()->GetComponents();
+    auto transforms = scene->GetTransformArray();
+    const AffineKernels& kernels = GetAffineKernels();
 
-    for (Entity root : scene->rootEntities)
-    {
-        UpdateTransformRecursive(root, nullptr, transforms);
-    }
-}
-
-void TransformSystem::UpdateTransformRecursive(Entity entity,const glm::mat4* parentMatrix, std::array<TransformComponent, MAX_ENTITIES>& transforms)
-{
-    TransformComponent& current = transforms[entity];
-    bool isDirty = current.isDirty || (parentMatrix != nullptr);
+    // Editor and gameplay writes through proxies land first, then local matrices are built chunk by chunk
+    transforms->CommitProxies();
+    transforms->ComposeLocalMatrices();
 
-    if (isDirty)
+    // One depth level at a time, so every parent's world matrix is final before its children's products are batched.
+    // A world matrix is only rebuilt when the entity or one of its ancestors changed
+    level.clear();
+    for (Entity root : scene->rootEntities)
     {
-        computeGlobalMatrix(current, parentMatrix ? *parentMatrix : glm::mat4(1.0f));
+        const bool changed = transforms->IsDirty(root);
+        if (changed)
+        {
+            transforms->GetWorldAffine(root) = transforms->GetLocalAffine(root);
+        }
+        level.push_back({root, changed});
     }
-
-    auto it = scene->sceneGraph.find(entity);
-    if (it != scene->sceneGraph.end())
+    while (!level.empty())
     {
-        for (Entity child : it->second.children)
+        nextLevel.clear();
+        parents.clear();
+        locals.clear();
+        outputs.clear();
+        for (const auto [entity, changed] : level)
         {
-            UpdateTransformRecursive(child, &current.globalMatrix, transforms);
+            auto it = scene->sceneGraph.find(entity);
+            if (it == scene->sceneGraph.end())
+            {
+                continue;
+            }
+            for (Entity child : it->second.children)
+            {
+                const bool childChanged = changed || transforms->IsDirty(child);
+                if (childChanged)
+                {
+                    parents.push_back(&transforms->GetWorldAffine(entity));
+                    locals.push_back(&transforms->GetLocalAffine(child));
+                    outputs.push_back(&transforms->GetWorldAffine(child));
+                }
+                nextLevel.push_back({child, childChanged});
+            }
         }
+        kernels.multiplyBatch(parents.data(), locals.data(), outputs.data(), outputs.size());
+        std::swap(level, nextLevel);
     }
-}
\ No newline at end of file
+
+    transforms->ClearDirty();
+}
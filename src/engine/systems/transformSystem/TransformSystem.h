@@ -2,7 +2,9 @@
 #define TRANSFORMSYSTEM_H
 
 #include <typeindex>
+#include <vector>
 
+#include "AffineKernels.h"
 #include "componets/TransformComponent.hpp"
 #include "../../ecs/System.h"
 
@@ -22,7 +24,16 @@ namespace engine::ecs
         void OnEntityRemoved(ComponentID componentID, std::type_index type) override {}
 
     private:
-        void UpdateTransformRecursive(Entity entity,const glm::mat4* parentMatrix, std::array<TransformComponent, MAX_ENTITIES>& transforms);
+        struct PendingEntity {
+            Entity entity;
+            bool changed;
+        };
+        // Kept between updates to reuse their storage
+        std::vector<PendingEntity> level;
+        std::vector<PendingEntity> nextLevel;
+        std::vector<const Affine*> parents;
+        std::vector<const Affine*> locals;
+        std::vector<Affine*> outputs;
     };
 }
 
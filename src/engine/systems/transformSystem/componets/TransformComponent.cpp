@@ -101,3 +101,16 @@ void TransformComponent::DeserializeComponentFromJson(const rapidjson::Value& ob
 
     isDirty = true;
 }
+
+TransformComponent::Record TransformComponent::ToRecord() const
+{
+    return {position, rotation, scale};
+}
+
+void TransformComponent::FromRecord(const Record& record)
+{
+    position = record.position;
+    rotation = record.rotation;
+    scale = record.scale;
+    isDirty = true;
+}
@@ -26,6 +26,15 @@ namespace engine::ecs
 
         void SerializeComponentToJson(rapidjson::Value& obj, rapidjson::Document::AllocatorType& allocator) const override;
         void DeserializeComponentFromJson(const rapidjson::Value& obj) override;
+
+        // Binary scenes, the matrices are rebuilt from these
+        struct Record {
+            glm::vec3 position;
+            glm::quat rotation;
+            glm::vec3 scale;
+        };
+        Record ToRecord() const;
+        void FromRecord(const Record& record);
     };
 
 
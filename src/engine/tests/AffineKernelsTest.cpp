@@ -0,0 +1,171 @@
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <random>
+
+#include "../systems/transformSystem/AffineKernels.h"
+#include "../systems/transformSystem/componets/TransformComponent.hpp"
+
+using namespace engine::ecs;
+
+namespace
+{
+    constexpr float kTolerance = 1e-4f;
+
+    // Odd count so every SIMD path also runs its scalar tail
+    struct TRSData {
+        explicit TRSData(size_t count) : streams(10, std::vector<float>(count))
+        {
+            std::mt19937 rng(11);
+            std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+            for (size_t i = 0; i < count; ++i) {
+                const glm::quat rotation = glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng)));
+                const float values[10] = {dist(rng) * 10.0f, dist(rng) * 10.0f, dist(rng) * 10.0f,
+                                          rotation.x, rotation.y, rotation.z, rotation.w,
+                                          1.5f + dist(rng), 1.5f + dist(rng), 1.5f + dist(rng)};
+                for (size_t stream = 0; stream < streams.size(); ++stream) {
+                    streams[stream][i] = values[stream];
+                }
+            }
+        }
+
+        TRSStreams Streams() const
+        {
+            return {streams[0].data(), streams[1].data(), streams[2].data(), streams[3].data(), streams[4].data(),
+                    streams[5].data(), streams[6].data(), streams[7].data(), streams[8].data(), streams[9].data()};
+        }
+
+        TransformComponent Transform(size_t i) const
+        {
+            TransformComponent transform;
+            transform.position = glm::vec3(streams[0][i], streams[1][i], streams[2][i]);
+            transform.rotation = glm::quat(streams[6][i], streams[3][i], streams[4][i], streams[5][i]);
+            transform.scale = glm::vec3(streams[7][i], streams[8][i], streams[9][i]);
+            return transform;
+        }
+
+        std::vector<std::vector<float>> streams;
+    };
+
+    bool closeTo(const glm::mat4& a, const glm::mat4& b)
+    {
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                if (std::abs(a[column][row] - b[column][row]) > kTolerance * std::max(1.0f, std::abs(b[column][row]))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::vector<SimdLevel> availableLevels()
+    {
+        std::vector<SimdLevel> levels;
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2}) {
+            if (GetAffineKernels(level).level == level) {
+                levels.push_back(level);
+            }
+        }
+        return levels;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(AffineKernelsTests)
+
+BOOST_AUTO_TEST_CASE(KernelsMatchGlm) {
+    constexpr size_t count = 37;
+    const TRSData data(count);
+
+    for (SimdLevel level : availableLevels()) {
+        BOOST_TEST_CONTEXT("SIMD level " << static_cast<int>(level)) {
+            const AffineKernels& kernels = GetAffineKernels(level);
+
+            std::vector<Affine> locals(count);
+            kernels.compose(data.Streams(), count, locals.data());
+            for (size_t i = 0; i < count; ++i) {
+                BOOST_TEST(closeTo(ToMat4(locals[i]), getLocalModelMatrix(data.Transform(i))));
+            }
+
+            // Every transform parented to another one
+            std::vector<Affine> worlds(count);
+            std::vector<const Affine*> parents(count), localPtrs(count);
+            std::vector<Affine*> outputs(count);
+            for (size_t i = 0; i < count; ++i) {
+                parents[i] = &locals[(i * 5 + 3) % count];
+                localPtrs[i] = &locals[i];
+                outputs[i] = &worlds[i];
+            }
+            kernels.multiplyBatch(parents.data(), localPtrs.data(), outputs.data(), count);
+            for (size_t i = 0; i < count; ++i) {
+                const glm::mat4 expected = ToMat4(*parents[i]) * ToMat4(locals[i]);
+                BOOST_TEST(closeTo(ToMat4(worlds[i]), expected));
+
+                Affine single;
+                kernels.multiply(*parents[i], locals[i], single);
+                BOOST_TEST(closeTo(ToMat4(single), expected));
+            }
+
+            // In place, the output is the local operand
+            Affine inPlace = locals[1];
+            kernels.multiply(locals[0], inPlace, inPlace);
+            BOOST_TEST(closeTo(ToMat4(inPlace), ToMat4(locals[0]) * ToMat4(locals[1])));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AffineRoundTripsThroughMat4) {
+    const TRSData data(1);
+    const glm::mat4 matrix = getLocalModelMatrix(data.Transform(0));
+    BOOST_TEST(closeTo(ToMat4(ToAffine(matrix)), matrix));
+    const TransformComponent transform = data.Transform(0);
+    BOOST_TEST(closeTo(ToMat4(ComposeAffine(transform.position, transform.rotation, transform.scale)), matrix));
+}
+
+// Compose and parent every transform, glm 4x4 math against each kernel level. The bound is loose so a loaded machine
+// doesn't fail it, a level slower than the glm path it replaced does
+BOOST_AUTO_TEST_CASE(KernelThroughput) {
+    constexpr size_t count = 1021;
+    constexpr int iterations = 2000;
+    const TRSData data(count);
+
+    std::vector<TransformComponent> transforms;
+    for (size_t i = 0; i < count; ++i) {
+        transforms.push_back(data.Transform(i));
+    }
+    const glm::mat4 parentMatrix = getLocalModelMatrix(transforms.front());
+
+    const auto glmStart = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        for (TransformComponent& transform : transforms) {
+            transform.isDirty = true;
+            computeGlobalMatrix(transform, parentMatrix);
+        }
+    }
+    const auto glmUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - glmStart).count();
+    BOOST_TEST_MESSAGE("glm x" << iterations << ": " << glmUs << " us");
+
+    const Affine parent = ToAffine(parentMatrix);
+    std::vector<Affine> locals(count), worlds(count);
+    std::vector<const Affine*> parents(count, &parent), localPtrs(count);
+    std::vector<Affine*> outputs(count);
+    for (size_t i = 0; i < count; ++i) {
+        localPtrs[i] = &locals[i];
+        outputs[i] = &worlds[i];
+    }
+
+    for (SimdLevel level : availableLevels()) {
+        const AffineKernels& kernels = GetAffineKernels(level);
+        const auto start = std::chrono::steady_clock::now();
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            kernels.compose(data.Streams(), count, locals.data());
+            kernels.multiplyBatch(parents.data(), localPtrs.data(), outputs.data(), count);
+        }
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        BOOST_TEST_MESSAGE("SIMD level " << static_cast<int>(level) << " x" << iterations << ": " << us << " us ("
+                           << static_cast<double>(glmUs) / std::max<long long>(us, 1) << "x)");
+        BOOST_TEST(closeTo(ToMat4(worlds.back()), transforms.back().globalMatrix));
+        BOOST_TEST(us < glmUs * 2);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
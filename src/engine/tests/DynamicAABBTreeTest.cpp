@@ -0,0 +1,412 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+
+#include "Asset.hpp"
+#include "AssetManagerInterface.h"
+#include "MeshBVH.hpp"
+#include "assetDatas/MeshData.h"
+#include "assetDatas/ModelData.h"
+#include "../Engine.h"
+#include "../ecs/Scene.h"
+#include "../systems/collisionSystem/CollisionSystem.hpp"
+#include "../systems/renderingSystem/componets/CameraComponent.hpp"
+#include "../systems/renderingSystem/componets/RendererComponent.hpp"
+#include "../systems/transformSystem/TransformSystem.h"
+
+using namespace engine;
+using namespace engine::ecs;
+
+namespace
+{
+    constexpr float kNoHit = std::numeric_limits<float>::max();
+
+    struct BoxField {
+        BoxField(size_t count, float spread) : rng(5)
+        {
+            std::uniform_real_distribution<float> position(-spread, spread), extent(0.2f, 3.0f);
+            for (size_t i = 0; i < count; ++i) {
+                const glm::vec3 center(position(rng), position(rng), position(rng));
+                const glm::vec3 halfSize(extent(rng), extent(rng), extent(rng));
+                boxes.push_back({center - halfSize, center + halfSize});
+                proxies.push_back(tree.CreateProxy(boxes.back(), static_cast<uint32_t>(i)));
+                alive.push_back(true);
+            }
+        }
+
+        // Closest box along the ray through the tree, and the index of the box or -1
+        std::pair<float, int> Cast(const Ray& ray) const
+        {
+            const RaySlab slab(ray);
+            float closest = kNoHit;
+            int hit = -1;
+            tree.RayCast(ray, closest, [&](uint32_t box, float) {
+                float distance;
+                if (slab.Intersect(boxes[box], closest, distance) && distance < closest) {
+                    closest = distance;
+                    hit = static_cast<int>(box);
+                }
+                return closest;
+            });
+            return {closest, hit};
+        }
+
+        std::pair<float, int> BruteForce(const Ray& ray) const
+        {
+            const RaySlab slab(ray);
+            float closest = kNoHit;
+            int hit = -1;
+            for (size_t i = 0; i < boxes.size(); ++i) {
+                float distance;
+                if (alive[i] && slab.Intersect(boxes[i], closest, distance) && distance < closest) {
+                    closest = distance;
+                    hit = static_cast<int>(i);
+                }
+            }
+            return {closest, hit};
+        }
+
+        std::mt19937 rng;
+        DynamicAABBTree tree;
+        std::vector<AABB> boxes;
+        std::vector<int32_t> proxies;
+        std::vector<bool> alive;
+    };
+
+    // Boxes the tree reports that also pass the exact test, against every live box tested directly
+    template<typename Shape>
+    void checkQuery(const BoxField& field, const Shape& shape)
+    {
+        std::set<uint32_t> found, expected;
+        auto exact = [&](uint32_t box) {
+            if (shape.Overlaps(field.boxes[box])) {
+                found.insert(box);
+            }
+        };
+        if constexpr (std::is_same_v<Shape, Sphere>) {
+            field.tree.Query(shape.Bounds(), exact);
+        } else {
+            field.tree.Query(shape, exact);
+        }
+        for (size_t i = 0; i < field.boxes.size(); ++i) {
+            if (field.alive[i] && shape.Overlaps(field.boxes[i])) {
+                expected.insert(static_cast<uint32_t>(i));
+            }
+        }
+        BOOST_TEST(found == expected);
+    }
+
+    Entity addModel(Scene& scene, const glm::vec3& position, const glm::vec3& halfSize)
+    {
+        const Entity entity = scene.CreateEntity();
+        scene.AddComponent<RendererComponent>(entity);
+        auto& model = scene.GetComponent<RendererComponent>(entity);
+        model.modelUuid = boost::uuids::random_generator()();
+        model.boundingBoxMin = -halfSize;
+        model.boundingBoxMax = halfSize;
+        scene.GetComponent<TransformComponent>(entity).position = position;
+        return entity;
+    }
+
+    // Hands out in-memory model and mesh data. Only acquire is allowed, a pick that loads through getAsset or leaves
+    // something pinned fails the test
+    class PinningAssets : public am::AssetManagerInterface {
+    public:
+        struct DataAsset : am::Asset {
+            DataAsset(const boost::uuids::uuid& id, std::any data) : Asset(id), data(std::move(data)) {}
+            size_t calculateContentHash() const override { return 0; }
+            am::AssetType getType() const override { return am::AssetType::Other; }
+            std::any getAssetData() override { return data; }
+            void SaveAssetToJson(rapidjson::Document&) override {}
+            void SaveAssetMetadata(rapidjson::Document&) override {}
+            void LoadAssetMetadata(rapidjson::Document&) override {}
+            std::any data;
+        };
+
+        void add(const boost::uuids::uuid& id, std::any data) { assets.emplace(id, std::make_unique<DataAsset>(id, std::move(data))); }
+
+        am::Asset* acquireAsset(const boost::uuids::uuid& id) override
+        {
+            auto it = assets.find(id);
+            if (it == assets.end()) {
+                return nullptr;
+            }
+            ++acquired;
+            ++pinned[id];
+            return it->second.get();
+        }
+        void releaseAsset(const boost::uuids::uuid& id) override
+        {
+            BOOST_REQUIRE(pinned[id] > 0);
+            --pinned[id];
+        }
+        bool anyPinned() const
+        {
+            return std::ranges::any_of(pinned, [](const auto& entry) { return entry.second != 0; });
+        }
+
+        std::any getAssetData(const boost::uuids::uuid&) override { ++unpinnedLoads; return {}; }
+        std::any getAssetData(std::string) override { ++unpinnedLoads; return {}; }
+        std::optional<am::Asset*> getAsset(const boost::uuids::uuid&) override { ++unpinnedLoads; return std::nullopt; }
+
+        std::optional<boost::uuids::uuid> createAsset(am::AssetType, std::string) override { return std::nullopt; }
+        std::optional<boost::uuids::uuid> createAsset(am::AssetType, std::string, std::string) override { return std::nullopt; }
+        std::optional<boost::uuids::uuid> registerAsset(std::string) override { return std::nullopt; }
+        std::optional<boost::uuids::uuid> registerAsset(std::string, std::string) override { return std::nullopt; }
+        std::optional<boost::uuids::uuid> getAssetUuid(std::string) override { return std::nullopt; }
+        std::optional<std::shared_ptr<am::AssetInfo>> getAssetInfo(const boost::uuids::uuid&) const override { return std::nullopt; }
+        am::AssetLoadHandle loadAssetAsync(const boost::uuids::uuid&, am::LoadPriority) override { return {}; }
+        void setMemoryBudget(size_t) override {}
+        am::AssetResidencyStats getResidencyStats() const override { return {}; }
+        void saveAsset(boost::uuids::uuid) override {}
+        void saveAsset(std::string) override {}
+        std::vector<std::string> getRegisteredAssetsNames() const override { return {}; }
+        std::vector<std::string> getRegisteredAssetsNames(am::AssetType) const override { return {}; }
+        std::vector<boost::uuids::uuid> getRegisteredAssetsUuids() const override { return {}; }
+        std::vector<boost::uuids::uuid> getRegisteredAssetsUuids(am::AssetType) const override { return {}; }
+        void enableHotReload() override {}
+        std::vector<boost::uuids::uuid> pollHotReload() override { return {}; }
+
+        size_t acquired = 0;
+        size_t unpinnedLoads = 0;
+
+    private:
+        std::map<boost::uuids::uuid, std::unique_ptr<DataAsset>> assets;
+        std::map<boost::uuids::uuid, int> pinned;
+    };
+
+    Ray randomRay(std::mt19937& rng, float spread)
+    {
+        std::uniform_real_distribution<float> position(-spread, spread), direction(-1.0f, 1.0f);
+        return {{position(rng), position(rng), position(rng)},
+                glm::normalize(glm::vec3(direction(rng), direction(rng), direction(rng)))};
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(DynamicAABBTreeTests)
+
+BOOST_AUTO_TEST_CASE(RayCastMatchesBruteForceAfterEdits) {
+    BoxField field(2000, 50.0f);
+    std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+    for (size_t i = 0; i < field.boxes.size(); i += 7) {
+        const glm::vec3 move(offset(field.rng), offset(field.rng), offset(field.rng));
+        field.boxes[i] = {field.boxes[i].min + move, field.boxes[i].max + move};
+        field.tree.MoveProxy(field.proxies[i], field.boxes[i]);
+    }
+    for (size_t i = 3; i < field.boxes.size(); i += 11) {
+        field.tree.DestroyProxy(field.proxies[i]);
+        field.alive[i] = false;
+    }
+
+    for (int i = 0; i < 500; ++i) {
+        const Ray ray = randomRay(field.rng, 60.0f);
+        BOOST_TEST(field.Cast(ray).second == field.BruteForce(ray).second);
+    }
+    // Balanced, 2^height stays within a small factor of the proxy count
+    BOOST_TEST(field.tree.GetHeight() < 32);
+}
+
+BOOST_AUTO_TEST_CASE(PacketMatchesSingleRays) {
+    BoxField field(2000, 50.0f);
+    std::uniform_real_distribution<float> spread(-0.2f, 0.2f);
+    std::vector<Ray> rays;
+    for (int i = 0; i < 64; ++i) {
+        rays.push_back({{0.0f, 0.0f, -80.0f}, glm::normalize(glm::vec3(spread(field.rng), spread(field.rng), 1.0f))});
+    }
+
+    std::vector<float> closest(rays.size(), kNoHit);
+    std::vector<int> hits(rays.size(), -1);
+    field.tree.RayCastPacket(rays, closest, [&](size_t ray, uint32_t box, float) {
+        float distance;
+        if (RaySlab(rays[ray]).Intersect(field.boxes[box], closest[ray], distance) && distance < closest[ray]) {
+            hits[ray] = static_cast<int>(box);
+            return distance;
+        }
+        return closest[ray];
+    });
+    for (size_t i = 0; i < rays.size(); ++i) {
+        BOOST_TEST(hits[i] == field.Cast(rays[i]).second);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RotatedBoundsCoverEveryCorner) {
+    const glm::mat4 world = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(3.0f, 0.0f, 0.0f)),
+                                        glm::radians(45.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    const glm::vec3 localMin(-1.0f, -0.5f, -0.5f), localMax(1.0f, 0.5f, 0.5f);
+    const AABB bounds = TransformAABB(localMin, localMax, world);
+
+    glm::vec3 tightMin(kNoHit), tightMax(-kNoHit);
+    for (int corner = 0; corner < 8; ++corner) {
+        const glm::vec3 local((corner & 1) ? localMax.x : localMin.x, (corner & 2) ? localMax.y : localMin.y,
+                              (corner & 4) ? localMax.z : localMin.z);
+        const glm::vec3 point = glm::vec3(world * glm::vec4(local, 1.0f));
+        tightMin = glm::min(tightMin, point);
+        tightMax = glm::max(tightMax, point);
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        BOOST_TEST(bounds.min[axis] == tightMin[axis], boost::test_tools::tolerance(1e-4f));
+        BOOST_TEST(bounds.max[axis] == tightMax[axis], boost::test_tools::tolerance(1e-4f));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CollisionSystemPicksRotatedModels) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+    const Entity entity = scene.CreateEntity();
+    // Added without a model so no asset is loaded, the bounds are set by hand
+    scene.AddComponent<RendererComponent>(entity);
+    auto& model = scene.GetComponent<RendererComponent>(entity);
+    model.modelUuid = boost::uuids::random_generator()();
+    model.boundingBoxMin = glm::vec3(-2.0f, -0.1f, -0.1f);
+    model.boundingBoxMax = glm::vec3(2.0f, 0.1f, 0.1f);
+
+    // A thin bar turned upright, min and max alone would still describe a flat box
+    scene.GetComponent<TransformComponent>(entity).rotation = glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    scene.GetSystem<TransformSystem>()->Update(0.0f);
+    auto collision = scene.GetSystem<CollisionSystem>();
+    collision->Update(0.0f);
+
+    const Ray high{{0.0f, 1.5f, -10.0f}, {0.0f, 0.0f, 1.0f}};
+    const auto hit = collision->RayCastClosest(high);
+    BOOST_REQUIRE(hit.has_value());
+    BOOST_TEST(hit->entity == entity);
+    BOOST_TEST(hit->distance == 9.9f, boost::test_tools::tolerance(1e-4f));
+    BOOST_TEST(!collision->RayCastClosest(Ray{{1.5f, 0.0f, -10.0f}, {0.0f, 0.0f, 1.0f}}).has_value());
+
+    // Removing the model takes the entity out of the tree
+    scene.RemoveComponent<RendererComponent>(entity);
+    collision->Update(0.0f);
+    BOOST_TEST(collision->GetBroadphase().GetProxyCount() == 0u);
+    BOOST_TEST(!collision->RayCastClosest(high).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(PickingPinsModelAndMeshes) {
+    // One triangle in the z = 0 plane, only its lower left half of the unit square is solid
+    am::MeshData mesh;
+    for (const glm::vec3& position : {glm::vec3(-1.0f, -1.0f, 0.0f), glm::vec3(1.0f, -1.0f, 0.0f), glm::vec3(-1.0f, 1.0f, 0.0f)}) {
+        am::VertexAsset vertex{};
+        vertex.Position = position;
+        mesh.vertices.push_back(vertex);
+    }
+    mesh.indices = {0, 1, 2};
+    mesh.bvh = am::buildMeshBVH(mesh.vertices, mesh.indices);
+
+    const auto meshId = boost::uuids::random_generator()();
+    am::ModelData modelData{};
+    modelData.rootNode.mChildren.emplace_back();
+    am::Node& child = modelData.rootNode.mChildren.back();
+    child.mTransformation = glm::mat4(1.0f);
+    child.meshes.push_back(std::make_shared<am::AssetInfo>(meshId, "", am::AssetType::Mesh, 0,
+                                                           am::ImportContext("", am::AssetType::Mesh), ""));
+
+    PinningAssets assets;
+    assets.add(meshId, &mesh);
+    Engine engine(nullptr, nullptr, &assets);
+    Scene scene(engine);
+    const Entity entity = addModel(scene, glm::vec3(0.0f), glm::vec3(1.0f, 1.0f, 0.1f));
+    const auto modelId = scene.GetComponent<RendererComponent>(entity).modelUuid;
+    assets.add(modelId, &modelData);
+    scene.GetSystem<TransformSystem>()->Update(0.0f);
+    auto collision = scene.GetSystem<CollisionSystem>();
+    collision->Update(0.0f);
+
+    const auto hit = collision->RayCastClosest(Ray{{-0.5f, -0.5f, -5.0f}, {0.0f, 0.0f, 1.0f}});
+    BOOST_REQUIRE(hit.has_value());
+    BOOST_TEST(hit->distance == 5.0f, boost::test_tools::tolerance(1e-5f));
+    // Inside the bounds but past the triangle's edge
+    BOOST_TEST(!collision->RayCastClosest(Ray{{0.5f, 0.5f, -5.0f}, {0.0f, 0.0f, 1.0f}}).has_value());
+
+    BOOST_TEST(assets.acquired == 4u);
+    BOOST_TEST(!assets.anyPinned());
+    BOOST_TEST(assets.unpinnedLoads == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(RegionQueriesMatchBruteForce) {
+    BoxField field(2000, 50.0f);
+    for (size_t i = 5; i < field.boxes.size(); i += 13) {
+        field.tree.DestroyProxy(field.proxies[i]);
+        field.alive[i] = false;
+    }
+
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f), size(1.0f, 20.0f);
+    for (int i = 0; i < 50; ++i) {
+        const glm::vec3 center(position(field.rng), position(field.rng), position(field.rng));
+        const glm::vec3 halfSize(size(field.rng), size(field.rng), size(field.rng));
+        checkQuery(field, AABB{center - halfSize, center + halfSize});
+        checkQuery(field, Sphere{center, size(field.rng)});
+
+        const glm::mat4 view = glm::lookAt(center, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        checkQuery(field, Frustum::FromMatrix(glm::perspective(glm::radians(40.0f), 1.5f, 0.5f, 60.0f) * view));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CollisionSystemRegionQueries) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+    const Entity center = addModel(scene, glm::vec3(0.0f), glm::vec3(1.0f));
+    const Entity right = addModel(scene, glm::vec3(3.0f, 0.0f, 0.0f), glm::vec3(0.5f));
+    const Entity distant = addModel(scene, glm::vec3(40.0f, 0.0f, 0.0f), glm::vec3(0.5f));
+    scene.GetSystem<TransformSystem>()->Update(0.0f);
+    auto collision = scene.GetSystem<CollisionSystem>();
+    collision->Update(0.0f);
+
+    std::array<Entity, 4> buffer{};
+    BOOST_TEST(collision->QueryAABB({glm::vec3(2.0f, -1.0f, -1.0f), glm::vec3(5.0f, 1.0f, 1.0f)}, buffer) == 1u);
+    BOOST_TEST(buffer[0] == right);
+
+    // The sphere reaches the corner region of the box around the center, but not the box around the right one
+    BOOST_TEST(collision->QuerySphere({glm::vec3(1.5f, 1.5f, 0.0f), 0.75f}, buffer) == 1u);
+    BOOST_TEST(buffer[0] == center);
+
+    // Too small a buffer still reports how many there are
+    std::array<Entity, 1> small{};
+    BOOST_TEST(collision->QuerySphere({glm::vec3(0.0f), 100.0f}, small) == 3u);
+
+    CameraComponent camera;
+    camera.aspectRatio = 1.0f;
+    updateProjectionMatrix(camera);
+    camera.view = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Marquee around the middle of the screen, then over all of it
+    const size_t middle = collision->QueryFrustum(collision->ScreenRectToFrustum(camera, 60.0f, 60.0f, 40.0f, 40.0f, 100.0f, 100.0f), buffer);
+    BOOST_TEST(middle == 1u);
+    BOOST_TEST(buffer[0] == center);
+
+    const size_t screen = collision->QueryFrustum(collision->ScreenRectToFrustum(camera, 0.0f, 0.0f, 100.0f, 100.0f, 100.0f, 100.0f), buffer);
+    BOOST_REQUIRE(screen == 2u);
+    const std::set<Entity> selected(buffer.begin(), buffer.begin() + 2);
+    BOOST_TEST((selected == std::set<Entity>{center, right}));
+    BOOST_TEST(!selected.contains(distant));
+}
+
+// Rays against 100k objects in a bare DynamicAABBTree. CollisionSystem itself is capped at MAX_ENTITIES proxies, so
+// this measures the tree, not a scene of that size. Reported, only a warning past the budget since debug builds are
+// far slower
+BOOST_AUTO_TEST_CASE(RayCastThroughputAt100kObjects) {
+    const auto buildStart = std::chrono::steady_clock::now();
+    BoxField field(100000, 500.0f);
+    const auto buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart).count();
+
+    constexpr int rayCount = 1000;
+    std::vector<Ray> rays;
+    for (int i = 0; i < rayCount; ++i) {
+        rays.push_back(randomRay(field.rng, 500.0f));
+    }
+    const auto start = std::chrono::steady_clock::now();
+    int hits = 0;
+    for (const Ray& ray : rays) {
+        hits += field.Cast(ray).second >= 0;
+    }
+    const double averageUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rayCount;
+
+    BOOST_TEST_MESSAGE("100k proxies built in " << buildMs << " ms, height " << field.tree.GetHeight() << ", "
+                       << averageUs << " us per ray, " << hits << " hits");
+    BOOST_WARN_LT(averageUs, 1000.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+#include "../Engine.h"
+#include "../ecs/Scene.h"
+#include "../systems/renderingSystem/componets/LightComponent.hpp"
+
+using namespace engine;
+using namespace engine::ecs;
+
+BOOST_AUTO_TEST_SUITE(EntityCommandBufferTests)
+
+BOOST_AUTO_TEST_CASE(PlaybackAppliesCommandsRecordedFromThreads) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+    EntityCommandBuffer buffer;
+
+    // Every thread records a parent with a child, the child gets a light
+    constexpr size_t threadCount = 4;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&buffer, t] {
+            TransformComponent transform;
+            transform.position.x = static_cast<float>(t);
+            const Entity parent = buffer.CreateEntity(EntityCommandBuffer::kNoParent, transform);
+            const Entity child = buffer.CreateEntity(parent);
+            buffer.AddComponent<LightComponent>(child);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    BOOST_TEST(!buffer.Empty());
+
+    const auto created = scene.Playback(buffer);
+    BOOST_TEST(buffer.Empty());
+    BOOST_REQUIRE_EQUAL(created.size(), threadCount * 2);
+    BOOST_TEST(scene.rootEntities.size() == threadCount);
+    BOOST_TEST(scene.GetEntitiesWith<LightComponent>().size() == threadCount);
+    for (Entity entity : scene.GetEntitiesWith<LightComponent>()) {
+        BOOST_TEST(scene.HasParent(entity));
+        BOOST_TEST(!scene.HasComponent<LightComponent>(scene.GetParent(entity)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DestroyWinsOverOtherCommandsForTheEntity) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+    const Entity root = scene.CreateEntity();
+    const Entity child = scene.CreateEntity(root);
+    const Entity lit = scene.CreateEntity();
+    scene.AddComponent<LightComponent>(lit);
+
+    EntityCommandBuffer buffer;
+    buffer.AddComponent<CameraComponent>(root);
+    buffer.DestroyEntity(root);
+    buffer.DestroyEntity(root);
+    buffer.RemoveComponent<LightComponent>(lit);
+    const Entity spawned = buffer.CreateEntity();
+    buffer.DestroyEntity(spawned);
+    scene.Playback(buffer);
+
+    BOOST_TEST(!scene.IsEntityActive(root));
+    BOOST_TEST(scene.GetEntitiesWith<CameraComponent>().empty());
+    // The orphan is a root now
+    BOOST_TEST(!scene.HasParent(child));
+    BOOST_TEST((std::ranges::find(scene.rootEntities, child) != scene.rootEntities.end()));
+    BOOST_TEST((std::ranges::find(scene.rootEntities, root) == scene.rootEntities.end()));
+    BOOST_TEST(!scene.HasComponent<LightComponent>(lit));
+    BOOST_TEST(scene.IsEntityActive(lit));
+
+    // Destroyed IDs are handed out again
+    const auto reused = scene.CreateEntities(std::vector<TransformComponent>(2));
+    BOOST_REQUIRE_EQUAL(reused.size(), 2u);
+    BOOST_TEST((std::ranges::find(reused, root) != reused.end()));
+}
+
+BOOST_AUTO_TEST_CASE(BulkCreateAndDestroyRespectCapacity) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+
+    BOOST_TEST(scene.CreateEntities(std::vector<TransformComponent>(MAX_ENTITIES + 1)).empty());
+    BOOST_TEST(scene.rootEntities.empty());
+
+    const auto entities = scene.CreateEntities(std::vector<TransformComponent>(MAX_ENTITIES));
+    BOOST_REQUIRE_EQUAL(entities.size(), MAX_ENTITIES);
+    scene.DestroyEntities(entities);
+    BOOST_TEST(scene.rootEntities.empty());
+    BOOST_TEST(scene.GetEntitiesWith<TransformComponent>().empty());
+    BOOST_TEST(scene.CreateEntities(std::vector<TransformComponent>(MAX_ENTITIES)).size() == MAX_ENTITIES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
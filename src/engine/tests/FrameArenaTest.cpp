@@ -0,0 +1,89 @@
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+
+#include "FrameArena.hpp"
+#include "../Engine.h"
+#include "../ecs/Scene.h"
+#include "../systems/renderingSystem/componets/LightComponent.hpp"
+
+using namespace engine;
+using namespace engine::ecs;
+
+BOOST_AUTO_TEST_SUITE(FrameArenaTests)
+
+BOOST_AUTO_TEST_CASE(SteadyStateFramesStayOffTheHeap) {
+    gfx::FrameArena arena(2, 1024);
+    std::pmr::vector<uint64_t> queue(&arena);
+
+    for (size_t frame = 0; frame < 8; ++frame) {
+        gfx::releaseFrameStorage(queue);
+        arena.beginFrame(frame % 2);
+        // Far past the first block, the frames after it spill over until each slot was merged into one block
+        for (uint64_t i = 0; i < 4096; ++i) {
+            queue.push_back(i);
+        }
+        std::pmr::vector<float> scratch(100, 0.0f, &arena);
+        void* aligned = arena.allocate(64, 256);
+        BOOST_TEST(reinterpret_cast<uintptr_t>(aligned) % 256 == 0u);
+        BOOST_TEST(queue.back() == 4095u);
+    }
+
+    const gfx::FrameArenaStats stats = arena.getStats();
+    BOOST_TEST(stats.blockAllocations == 0u);
+    BOOST_TEST(stats.lastFrameBlockAllocations == 0u);
+    BOOST_TEST(stats.totalBlockAllocations > 0u);
+    BOOST_TEST(stats.usedBytes >= 4096u * sizeof(uint64_t));
+    BOOST_TEST(stats.peakUsedBytes >= stats.usedBytes);
+    BOOST_TEST(stats.capacityBytes >= 2 * stats.usedBytes);
+}
+
+BOOST_AUTO_TEST_CASE(MemoryOutlivesTheNextFrame) {
+    gfx::FrameArena arena(2, 256);
+    arena.beginFrame(0);
+    auto* first = static_cast<uint32_t*>(arena.allocate(sizeof(uint32_t), alignof(uint32_t)));
+    *first = 7;
+
+    // The other slot is handed out meanwhile, the first one is only reused a frame later
+    arena.beginFrame(1);
+    auto* second = static_cast<uint32_t*>(arena.allocate(sizeof(uint32_t), alignof(uint32_t)));
+    *second = 9;
+    BOOST_TEST(*first == 7u);
+
+    arena.beginFrame(0);
+    BOOST_TEST(arena.allocate(sizeof(uint32_t), alignof(uint32_t)) == first);
+}
+
+BOOST_AUTO_TEST_CASE(HeapAllocationsAreReportedPerFrame) {
+    gfx::FrameArena arena(2, 256);
+    arena.beginFrame(0);
+    // Stands in for an operator new override, nothing else may allocate until the next beginFrame
+    for (int i = 0; i < 3; ++i) {
+        gfx::countHeapAllocation();
+    }
+    arena.beginFrame(1);
+    gfx::countHeapAllocation();
+
+    const gfx::FrameArenaStats stats = arena.getStats();
+    BOOST_TEST(stats.heapAllocationsTracked);
+    BOOST_TEST(stats.lastFrameHeapAllocations == 3u);
+    BOOST_TEST(stats.heapAllocations == 1u);
+    BOOST_TEST(gfx::getHeapAllocationCount() >= 4u);
+}
+
+BOOST_AUTO_TEST_CASE(SceneQueriesUseTheFrameAllocator) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+    for (int i = 0; i < 3; ++i) {
+        scene.AddComponent<LightComponent>(scene.CreateEntity());
+    }
+
+    const auto lights = scene.GetEntitiesWith<LightComponent>();
+    BOOST_TEST(lights.size() == 3u);
+    BOOST_TEST(lights.get_allocator().resource() == scene.GetFrameAllocator());
+    BOOST_TEST(scene.GetFrameArenaStats().usedBytes >= 3 * sizeof(Entity));
+
+    std::pmr::monotonic_buffer_resource local;
+    BOOST_TEST(scene.GetEntitiesWith<LightComponent>(&local).get_allocator().resource() == &local);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,55 @@
+#ifndef ENGINE_TESTS_NULLBACKENDS_HPP
+#define ENGINE_TESTS_NULLBACKENDS_HPP
+
+#include "GraphicsEngine.hpp"
+#include "PlatformInterface.hpp"
+
+// Stand-ins for the window and the renderer, so systems can run a full scene update without a device
+namespace
+{
+    // Accepts everything and draws nothing
+    class NullGraphicsEngine : public gfx::GraphicsEngine {
+    public:
+        void initialize(plt::PlatformInterface*, uint32_t, uint32_t) override {}
+        glm::uvec2 getExtent() override { return {1280, 720}; }
+        void* getViewportTexturePointer() override { return nullptr; }
+        void* getViewportTexturePointer(uint32_t) override { return nullptr; }
+        void setCameraData(uint32_t, const glm::mat4&, const glm::mat4&, const glm::vec3) override {}
+        void setActiveCameraCount(uint32_t) override {}
+        void drawModel(uint32_t, boost::uuids::uuid, boost::uuids::uuid, uint32_t, const glm::mat4&, const glm::vec3&,
+                       const glm::vec3&) override { ++modelsDrawn; }
+        void drawSkybox(uint32_t, boost::uuids::uuid, boost::uuids::uuid) override {}
+        void drawLight(gfx::PointLightData, const glm::mat4&) override { ++lightsDrawn; }
+        void drawLight(gfx::SpotLightData, const glm::mat4&) override { ++lightsDrawn; }
+        void drawLight(gfx::DirectionalLightData, const glm::mat4&) override { ++lightsDrawn; }
+        void loadModel(boost::uuids::uuid) override {}
+        void loadShader(boost::uuids::uuid) override {}
+        void loadTexture(boost::uuids::uuid) override {}
+        void beginFrame() override {}
+        void renderFrame() override {}
+        void endFrame() override {}
+
+        size_t modelsDrawn = 0;
+        size_t lightsDrawn = 0;
+    };
+
+    class NullPlatform : public plt::PlatformInterface {
+    public:
+        bool Init(const std::string&, int, int) override { return true; }
+        void PollEvents(bool&) override {}
+        void Shutdown() override {}
+        void* GetNativeWindow() const override { return nullptr; }
+        float GetDeltaTime() const override { return 0.016f; }
+        void SubscribeToEvent(plt::EventType, plt::EventCallback) override {}
+        void UnsubscribeFromEvent(plt::EventType, const plt::EventCallback&) override {}
+        void GetWindowSize(int& width, int& height) const override { width = 1280; height = 720; }
+        void GetWindowPosition(int& x, int& y) const override { x = 0; y = 0; }
+        bool IsWindowMinimized() const override { return false; }
+        bool IsWindowFocused() const override { return true; }
+        bool IsKeyPressed(int) const override { return false; }
+        bool IsMouseButtonPressed(uint8_t) const override { return false; }
+        void GetMousePosition(float& x, float& y) const override { x = 0.0f; y = 0.0f; }
+    };
+}
+
+#endif //ENGINE_TESTS_NULLBACKENDS_HPP
@@ -0,0 +1,94 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <rapidjson/document.h>
+
+#include "../Engine.h"
+#include "../ecs/Scene.h"
+#include "../systems/renderingSystem/componets/LightComponent.hpp"
+
+using namespace engine;
+using namespace engine::ecs;
+
+namespace
+{
+    // Root with a light and a child offset along x, the shape of a projectile with a trail
+    rapidjson::Document makePrefab()
+    {
+        const std::string json = R"({"entities": [
+            {"parent": -1, "components": {")" + std::string(typeid(LightComponent).name()) + R"(": {}}},
+            {"parent": 0, "components": {")" + std::string(typeid(TransformComponent).name()) +
+            R"(": {"position": [2, 0, 0], "rotation": [1, 0, 0, 0], "scale": [1, 1, 1]}}}
+        ]})";
+        rapidjson::Document document;
+        document.Parse(json.c_str());
+        return document;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(PrefabTests)
+
+BOOST_AUTO_TEST_CASE(InstantiateBuildsHierarchyAndComponents) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+    const auto prefab = scene.CompilePrefab(makePrefab());
+    BOOST_REQUIRE(prefab);
+    BOOST_REQUIRE_EQUAL(prefab->nodes.size(), 2u);
+    BOOST_TEST(prefab->pools.front().nodes.size() == 2u);
+
+    std::vector<TransformComponent> roots(4);
+    for (size_t i = 0; i < roots.size(); ++i) {
+        roots[i].position = glm::vec3(0.0f, static_cast<float>(i), 0.0f);
+    }
+    const auto entities = scene.Instantiate(*prefab, roots.size(), roots);
+    BOOST_REQUIRE_EQUAL(entities.size(), 8u);
+
+    for (size_t copy = 0; copy < roots.size(); ++copy) {
+        const Entity root = entities[copy * 2];
+        const Entity child = entities[copy * 2 + 1];
+        BOOST_TEST(scene.IsEntityActive(root));
+        BOOST_TEST(scene.GetParent(child) == root);
+        BOOST_TEST(scene.GetChildren(root) == std::vector{child});
+        BOOST_TEST(scene.GetComponent<TransformComponent>(root).position.y == static_cast<float>(copy));
+        BOOST_TEST(scene.GetComponent<TransformComponent>(child).position.x == 2.0f);
+        BOOST_TEST(scene.HasComponent<LightComponent>(root));
+        BOOST_TEST(!scene.HasComponent<LightComponent>(child));
+    }
+    BOOST_TEST(scene.GetEntitiesWith<LightComponent>().size() == roots.size());
+}
+
+BOOST_AUTO_TEST_CASE(InstantiateThatDoesNotFitLeavesSceneUntouched) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+    const auto prefab = scene.CompilePrefab(makePrefab());
+    BOOST_REQUIRE(prefab);
+
+    // The light array runs out before the entities do
+    BOOST_TEST(scene.Instantiate(*prefab, MAX_COMPONENTS_ARRAY + 1).empty());
+    BOOST_TEST(scene.rootEntities.empty());
+    BOOST_TEST(scene.GetEntitiesWith<TransformComponent>().empty());
+
+    BOOST_TEST(scene.Instantiate(*prefab, MAX_COMPONENTS_ARRAY).size() == MAX_COMPONENTS_ARRAY * 2);
+}
+
+BOOST_AUTO_TEST_CASE(InstantiateMissingPrefabSpawnsNothing) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+
+    BOOST_TEST(scene.Instantiate(boost::uuids::random_generator()(), 4).empty());
+    BOOST_TEST(scene.rootEntities.empty());
+}
+
+BOOST_AUTO_TEST_CASE(CompileRejectsMalformedPrefabs) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+
+    rapidjson::Document unknownType;
+    unknownType.Parse(R"({"entities": [{"components": {"NotAComponent": {}}}]})");
+    BOOST_TEST(!scene.CompilePrefab(unknownType));
+
+    rapidjson::Document parentAfterChild;
+    parentAfterChild.Parse(R"({"entities": [{"parent": 1}, {"parent": -1}]})");
+    BOOST_TEST(!scene.CompilePrefab(parentAfterChild));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
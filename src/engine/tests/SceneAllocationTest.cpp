@@ -0,0 +1,173 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "FrameArena.hpp"
+#include "NullBackends.hpp"
+#include "../Engine.h"
+#include "../ecs/Scene.h"
+#include "../systems/collisionSystem/CollisionSystem.hpp"
+#include "../systems/editorSystem/EditorSystem.hpp"
+#include "../systems/renderingSystem/RenderSystem.h"
+#include "../systems/renderingSystem/componets/CameraComponent.hpp"
+#include "../systems/renderingSystem/componets/LightComponent.hpp"
+#include "../systems/renderingSystem/componets/RendererComponent.hpp"
+#include "../systems/transformSystem/TransformSystem.h"
+
+using namespace engine;
+using namespace engine::ecs;
+
+// Every heap allocation in the test binary goes through here, only counted while a test asks for it
+namespace
+{
+    std::atomic<bool> countAllocations{false};
+    std::atomic<size_t> allocationCount{0};
+
+    void countAllocation()
+    {
+        gfx::countHeapAllocation();
+        if (countAllocations.load(std::memory_order_relaxed)) {
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void* allocate(std::size_t size)
+    {
+        countAllocation();
+        void* memory = std::malloc(std::max<std::size_t>(size, 1));
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    // Neither MSVC's nor MinGW's CRT has aligned_alloc, their aligned blocks also need their own free
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        countAllocation();
+        const auto bytes = static_cast<std::size_t>(alignment);
+        size = std::max<std::size_t>(size, 1);
+#ifdef _WIN32
+        void* memory = _aligned_malloc(size, bytes);
+#else
+        void* memory = std::aligned_alloc(bytes, (size + bytes - 1) / bytes * bytes);
+#endif
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    void freeAligned(void* memory)
+    {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { freeAligned(memory); }
+
+namespace
+{
+    struct AllocationCounter {
+        AllocationCounter()
+        {
+            allocationCount = 0;
+            countAllocations = true;
+        }
+        ~AllocationCounter() { countAllocations = false; }
+        size_t Count() const { return allocationCount.load(); }
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(SceneAllocationTests)
+
+BOOST_AUTO_TEST_CASE(AccessorsReturnTheRegisteredPools) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+
+    BOOST_TEST(scene.GetComponentArray<CameraComponent>() ==
+               scene.GetComponentArrays().at(typeid(CameraComponent)).get());
+    BOOST_TEST(scene.GetTransformArray() == scene.GetComponentArrays().at(typeid(TransformComponent)).get());
+    BOOST_TEST(scene.GetSystem<TransformSystem>() == scene.GetSystems().at(typeid(TransformSystem)).get());
+    BOOST_TEST(scene.GetSystem<CollisionSystem>() == scene.GetSystems().at(typeid(CollisionSystem)).get());
+}
+
+BOOST_AUTO_TEST_CASE(SteadyStateUpdateDoesNotAllocate) {
+    NullGraphicsEngine graphics;
+    NullPlatform platform;
+    Engine engine(&platform, &graphics, nullptr);
+    Scene scene(engine);
+#ifdef EDITOR_ENABLED
+    // Its panels need an ImGui frame, the runtime systems are what this measures
+    scene.UnregisterSystem<EditorSystem>();
+#endif
+
+    const Entity camera = scene.CreateEntity();
+    scene.AddComponent<CameraComponent>(camera);
+    scene.GetComponent<TransformComponent>(camera).position = glm::vec3(0.0f, 0.0f, 10.0f);
+
+    Entity parent = camera;
+    for (int i = 0; i < 20; ++i) {
+        // Half of them hang off each other so the hierarchy pass has levels to walk
+        const Entity entity = scene.CreateEntity(i % 2 ? parent : camera);
+        scene.AddComponent<RendererComponent>(entity);
+        auto& model = scene.GetComponent<RendererComponent>(entity);
+        model.modelUuid = boost::uuids::random_generator()();
+        model.boundingBoxMin = glm::vec3(-0.5f);
+        model.boundingBoxMax = glm::vec3(0.5f);
+        scene.GetComponent<TransformComponent>(entity).position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f);
+        parent = entity;
+    }
+    for (auto type : {LightComponent::Type::Point, LightComponent::Type::Spot, LightComponent::Type::Directional}) {
+        const Entity light = scene.CreateEntity();
+        scene.AddComponent<LightComponent>(light, LightComponent(type, glm::vec3(1.0f), 1.0f));
+    }
+
+    // First frames grow the systems' scratch buffers and the broadphase
+    for (int i = 0; i < 3; ++i) {
+        scene.Update(0.016f);
+    }
+    graphics.modelsDrawn = 0;
+    graphics.lightsDrawn = 0;
+
+    size_t allocations;
+    {
+        AllocationCounter counter;
+        for (int i = 0; i < 10; ++i) {
+            // Something moves every frame through the streams, so matrices and broadphase proxies are really rebuilt
+            scene.GetTransformArray()->SetPosition(parent, glm::vec3(0.0f, static_cast<float>(i % 2), 0.0f));
+            scene.Update(0.016f);
+        }
+        allocations = counter.Count();
+    }
+    BOOST_TEST(allocations == 0u);
+    // The frame arena sees the same allocations through the hook
+    const gfx::FrameArenaStats stats = scene.GetFrameArenaStats();
+    BOOST_TEST(stats.heapAllocationsTracked);
+    BOOST_TEST(stats.lastFrameHeapAllocations == 0u);
+    BOOST_TEST(graphics.modelsDrawn == 200u);
+    BOOST_TEST(graphics.lightsDrawn == 30u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
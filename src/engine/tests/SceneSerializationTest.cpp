@@ -0,0 +1,290 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "../Engine.h"
+#include "../ecs/Scene.h"
+#include "../systems/renderingSystem/componets/LightComponent.hpp"
+#include "../systems/renderingSystem/componets/RendererComponent.hpp"
+
+using namespace engine;
+using namespace engine::ecs;
+
+namespace
+{
+    // Fills the scene up to MAX_ENTITIES as a forest of small hierarchies with cameras and lights mixed in
+    void populateScene(Scene& scene)
+    {
+        std::vector<Entity> created;
+        for (Entity i = 0; i < MAX_ENTITIES; ++i) {
+            TransformComponent transform;
+            transform.position = glm::vec3(static_cast<float>(i), 1.0f, -static_cast<float>(i));
+            transform.scale = glm::vec3(1.0f + i * 0.01f);
+            const Entity entity = scene.CreateEntity(transform);
+            if (i % 4 != 0) {
+                scene.SetParent(entity, created[i - i % 4]);
+            }
+            created.push_back(entity);
+        }
+        for (size_t i = 0; i < MAX_COMPONENTS_ARRAY / 2; ++i) {
+            CameraComponent camera;
+            camera.fov = 40.0f + static_cast<float>(i);
+            scene.AddComponent<CameraComponent>(created[i * 7], camera);
+            scene.AddComponent<LightComponent>(created[i * 9 + 1],
+                                               LightComponent(LightComponent::Type::Spot, glm::vec3(0.5f, 0.25f, i), 3.0f, true));
+        }
+        scene.SetEntityActive(created[5], false);
+    }
+
+    std::shared_ptr<const am::MappedFile> saveBinary(const Scene& scene)
+    {
+        return scene.SerializeToBinary();
+    }
+
+    bool loadBinary(Scene& scene, const std::shared_ptr<const am::MappedFile>& binary)
+    {
+        auto reader = am::BinaryContainerReader::open(binary, binary->bytes(), kSceneBinaryKind);
+        return reader && scene.DeserializeFromBinary(*reader);
+    }
+
+    // Copy of a saved scene with element index of a section changed by edit
+    template<typename T, typename Edit>
+    std::shared_ptr<const am::MappedFile> patchSection(const std::shared_ptr<const am::MappedFile>& binary, uint32_t tag,
+                                                       size_t index, Edit&& edit)
+    {
+        auto patched = am::MappedFile::allocate(binary->bytes().size(), "patched.scene");
+        std::ranges::copy(binary->bytes(), patched->writableBytes().begin());
+        auto reader = am::BinaryContainerReader::open(patched, patched->bytes(), kSceneBinaryKind);
+        BOOST_REQUIRE(reader);
+        const auto section = reader->section(tag);
+        BOOST_REQUIRE(section.size() >= (index + 1) * sizeof(T));
+
+        std::byte* element = patched->writableBytes().data() + (section.data() - patched->bytes().data()) + index * sizeof(T);
+        T value;
+        std::memcpy(&value, element, sizeof(T));
+        edit(value);
+        std::memcpy(element, &value, sizeof(T));
+        return patched;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(SceneSerializationTests)
+
+BOOST_AUTO_TEST_CASE(BinaryRoundTripKeepsEntitiesGraphAndComponents) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene source(engine);
+    populateScene(source);
+
+    const auto binary = saveBinary(source);
+    BOOST_REQUIRE(binary);
+
+    Scene loaded(engine);
+    BOOST_REQUIRE(loadBinary(loaded, binary));
+
+    for (Entity entity = 0; entity < MAX_ENTITIES; ++entity) {
+        BOOST_TEST(loaded.IsEntityActive(entity) == source.IsEntityActive(entity));
+        BOOST_TEST(loaded.GetParent(entity) == source.GetParent(entity));
+        BOOST_TEST(loaded.GetChildren(entity) == source.GetChildren(entity));
+        BOOST_TEST(loaded.GetComponent<TransformComponent>(entity).position.x ==
+                   source.GetComponent<TransformComponent>(entity).position.x);
+        BOOST_TEST(loaded.HasComponent<CameraComponent>(entity) == source.HasComponent<CameraComponent>(entity));
+        if (source.HasComponent<LightComponent>(entity)) {
+            const auto& light = loaded.GetComponent<LightComponent>(entity);
+            BOOST_TEST((light.getType() == LightComponent::Type::Spot));
+            BOOST_TEST(light.hasShadow);
+            BOOST_TEST(std::get<SpotLightData>(light.data).outerAngle == 45.0f);
+        }
+    }
+    BOOST_TEST(loaded.rootEntities == source.rootEntities);
+}
+
+BOOST_AUTO_TEST_CASE(MalformedBinaryLeavesSceneUntouched) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene source(engine);
+    populateScene(source);
+    const auto binary = saveBinary(source);
+    BOOST_REQUIRE(binary);
+
+    // Header claims more entities than the table holds
+    const auto broken = patchSection<SceneBinaryHeader>(binary, kSceneHeaderTag, 0,
+                                                        [](SceneBinaryHeader& header) { header.entityCount += 1; });
+
+    Scene target(engine);
+    const Entity kept = target.CreateEntity();
+    BOOST_TEST(!loadBinary(target, broken));
+    BOOST_TEST(target.IsEntityActive(kept));
+    BOOST_TEST(target.rootEntities.size() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(MismatchedPoolLeavesSceneUntouched) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene source(engine);
+    populateScene(source);
+    const auto binary = saveBinary(source);
+    BOOST_REQUIRE(binary);
+    auto reader = am::BinaryContainerReader::open(binary, binary->bytes(), kSceneBinaryKind);
+    BOOST_REQUIRE(reader);
+    const uint32_t poolCount = reader->sectionValue<SceneBinaryHeader>(kSceneHeaderTag)->poolCount;
+    BOOST_REQUIRE(poolCount > 1u);
+
+    Scene target(engine);
+    const Entity kept = target.CreateEntity();
+    target.AddComponent<CameraComponent>(kept);
+
+    // Every pool in turn, the last ones are read after the earlier ones were already accepted
+    for (uint32_t pool = 0; pool < poolCount; ++pool) {
+        // Written for the other storage, records and JSON
+        const auto otherLayout = patchSection<SceneBinaryPool>(binary, kScenePoolsTag, pool,
+                                                               [](SceneBinaryPool& row) { row.flags ^= ScenePoolJson; });
+        BOOST_TEST(!loadBinary(target, otherLayout));
+
+        if (!reader->section(scenePoolSlotsTag(pool)).empty()) {
+            const auto outOfRange = patchSection<SceneBinarySlot>(binary, scenePoolSlotsTag(pool), 0,
+                                                                  [](SceneBinarySlot& slot) { slot.entity = MAX_ENTITIES; });
+            BOOST_TEST(!loadBinary(target, outOfRange));
+        }
+
+        BOOST_TEST(target.IsEntityActive(kept));
+        BOOST_TEST(target.rootEntities.size() == 1u);
+        BOOST_TEST(target.HasComponent<CameraComponent>(kept));
+        BOOST_TEST(!target.HasComponent<LightComponent>(kept));
+    }
+    BOOST_TEST(loadBinary(target, binary));
+}
+
+BOOST_AUTO_TEST_CASE(OlderRecordLayoutLoadsWithDefaults) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene source(engine);
+    const Entity entity = source.CreateEntity();
+    RendererComponent renderer(boost::uuids::random_generator()(), boost::uuids::random_generator()());
+    renderer.shaderPermutation = 0b11;
+    source.AddComponent<RendererComponent>(entity, renderer);
+    const auto binary = saveBinary(source);
+    BOOST_REQUIRE(binary);
+    auto reader = am::BinaryContainerReader::open(binary, binary->bytes(), kSceneBinaryKind);
+    BOOST_REQUIRE(reader);
+
+    // The same scene as it was saved before pools had a version and renderer records a permutation
+    const auto header = reader->sectionValue<SceneBinaryHeader>(kSceneHeaderTag);
+    BOOST_REQUIRE(header);
+    const auto stringBytes = reader->section(kSceneStringsTag);
+    const std::string_view strings(reinterpret_cast<const char*>(stringBytes.data()), stringBytes.size());
+    constexpr uint32_t oldRecordSize = offsetof(RendererComponent::Record, shaderPermutation);
+
+    std::vector<SceneBinaryPoolUnversioned> pools;
+    std::vector<std::vector<std::byte>> records(header->poolCount);
+    std::optional<uint32_t> rendererPool;
+    for (uint32_t i = 0; i < header->poolCount; ++i) {
+        const SceneBinaryPool pool = reader->sectionAs<SceneBinaryPool>(kScenePoolsTag)[i];
+        const auto poolRecords = reader->section(scenePoolRecordsTag(i));
+        pools.push_back({pool.nameOffset, pool.nameSize, pool.recordSize, pool.flags});
+        if (strings.substr(pool.nameOffset, pool.nameSize) != typeid(RendererComponent).name()) {
+            records[i].assign(poolRecords.begin(), poolRecords.end());
+            continue;
+        }
+        for (size_t offset = 0; offset < poolRecords.size(); offset += pool.recordSize) {
+            records[i].insert(records[i].end(), poolRecords.begin() + offset, poolRecords.begin() + offset + oldRecordSize);
+        }
+        pools.back().recordSize = oldRecordSize;
+        rendererPool = i;
+    }
+    BOOST_REQUIRE(rendererPool.has_value());
+
+    am::BinaryContainerWriter writer(kSceneBinaryKind, reader->getId());
+    auto copySection = [&](uint32_t tag) {
+        writer.addSection(tag, reader->section(tag), reader->findSection(tag)->elementSize);
+    };
+    copySection(kSceneHeaderTag);
+    copySection(kSceneEntitiesTag);
+    copySection(kSceneParentsTag);
+    writer.addSection(kScenePoolsTag, std::span<const SceneBinaryPoolUnversioned>(pools));
+    for (uint32_t i = 0; i < header->poolCount; ++i) {
+        writer.addSection(scenePoolRecordsTag(i), std::span<const std::byte>(records[i]), pools[i].recordSize);
+        copySection(scenePoolSlotsTag(i));
+    }
+    copySection(kSceneSystemsTag);
+    copySection(kSceneStringsTag);
+    std::ostringstream stream;
+    BOOST_REQUIRE(writer.write(stream));
+    const std::string bytes = stream.str();
+    auto older = am::MappedFile::allocate(bytes.size(), "older.scene");
+    std::memcpy(older->writableBytes().data(), bytes.data(), bytes.size());
+
+    Scene loaded(engine);
+    BOOST_REQUIRE(loadBinary(loaded, older));
+    BOOST_REQUIRE(loaded.HasComponent<RendererComponent>(entity));
+    const auto& loadedRenderer = loaded.GetComponent<RendererComponent>(entity);
+    BOOST_TEST(loadedRenderer.modelUuid == renderer.modelUuid);
+    BOOST_TEST(loadedRenderer.shaderUuid == renderer.shaderUuid);
+    BOOST_TEST(loadedRenderer.shaderPermutation == 0u);
+
+    // Records written by a newer version than the component are refused, not read
+    const auto newer = patchSection<SceneBinaryPool>(binary, kScenePoolsTag, *rendererPool,
+                                                     [](SceneBinaryPool& row) { row.version += 100; });
+    BOOST_TEST(!loadBinary(loaded, newer));
+}
+
+// Not a correctness test, reports what a scene costs to save and load in both formats. Scenes are capped at
+// MAX_ENTITIES, so the full scene is saved and loaded repeatedly to reach 100k entities each way
+BOOST_AUTO_TEST_CASE(SceneSaveLoadBenchmark) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene source(engine);
+    populateScene(source);
+    Scene target(engine);
+    const size_t iterations = 100000 / MAX_ENTITIES;
+
+    using Clock = std::chrono::steady_clock;
+    auto milliseconds = [](Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+
+    std::string json;
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        rapidjson::Document document;
+        source.SerializeToJson(document);
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        document.Accept(writer);
+        json.assign(buffer.GetString(), buffer.GetSize());
+    }
+    const double jsonSave = milliseconds(Clock::now() - start);
+
+    start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        rapidjson::Document document;
+        document.Parse(json.c_str(), json.size());
+        target.DeserializeFromJson(document);
+    }
+    const double jsonLoad = milliseconds(Clock::now() - start);
+
+    std::shared_ptr<const am::MappedFile> binary;
+    start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        binary = saveBinary(source);
+    }
+    const double binarySave = milliseconds(Clock::now() - start);
+
+    start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        BOOST_REQUIRE(loadBinary(target, binary));
+    }
+    const double binaryLoad = milliseconds(Clock::now() - start);
+
+    BOOST_TEST_MESSAGE("Scene of " << MAX_ENTITIES << " entities, " << iterations << " iterations");
+    BOOST_TEST_MESSAGE("JSON:   " << json.size() << " bytes, save " << jsonSave << " ms, load " << jsonLoad << " ms");
+    BOOST_TEST_MESSAGE("Binary: " << binary->bytes().size() << " bytes, save " << binarySave << " ms, load " << binaryLoad << " ms");
+    BOOST_TEST_MESSAGE("Per load: JSON " << jsonLoad / iterations << " ms, binary " << binaryLoad / iterations
+                       << " ms (" << jsonLoad / std::max(binaryLoad, 1e-6) << "x)");
+    BOOST_TEST(binary->bytes().size() < json.size());
+    // Timings depend on the machine and build type, the bound only catches binary loads falling well behind JSON
+    BOOST_TEST(binaryLoad < jsonLoad * 2.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+#include <rapidjson/document.h>
+
+#include "NullBackends.hpp"
+#include "SpirvReflection.hpp"
+#include "assetDatas/ShaderProgramData.h"
+#include "../../assetManager/src/AssetManager.hpp"
+#include "../../assetManager/src/assets/shaderProgram/ShaderProgramAsset.h"
+#include "../Engine.h"
+#include "../ecs/Scene.h"
+#include "../systems/editorSystem/EditorSystem.hpp"
+#include "../systems/renderingSystem/componets/CameraComponent.hpp"
+#include "../systems/renderingSystem/componets/RendererComponent.hpp"
+
+using namespace engine;
+using namespace engine::ecs;
+
+namespace
+{
+    struct DrawCall {
+        boost::uuids::uuid modelId;
+        boost::uuids::uuid shaderId;
+        uint32_t permutationMask;
+    };
+
+    // Keeps what the render system asked for, the part of a draw the pipeline is picked by
+    class RecordingGraphicsEngine : public NullGraphicsEngine {
+    public:
+        void drawModel(uint32_t, boost::uuids::uuid modelId, boost::uuids::uuid shaderId, uint32_t permutationMask,
+                       const glm::mat4&, const glm::vec3&, const glm::vec3&) override
+        {
+            draws.push_back({modelId, shaderId, permutationMask});
+        }
+
+        std::vector<DrawCall> draws;
+    };
+
+    bool bindsLightsSet(std::span<const uint32_t> bytecode)
+    {
+        const auto reflection = am::reflectSpirv(bytecode);
+        BOOST_REQUIRE(reflection.has_value());
+        return std::ranges::any_of(reflection->bindings, [](const auto& binding) { return binding.set == 3; });
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(ShaderPermutationTests)
+
+BOOST_AUTO_TEST_CASE(RendererMaskSelectsTheProgramVariant) {
+    auto& assetManager = am::AssetManager::getInstance();
+    const auto programId = assetManager.registerAsset("res/shaders/jsons/pbr.shaderImport");
+    BOOST_REQUIRE(programId.has_value());
+    const auto* program = assetManager.getAssetData<am::ShaderProgramData>(programId.value());
+    const uint32_t unlit = program->getPermutationBit("UNLIT");
+    BOOST_REQUIRE(unlit != 0u);
+
+    RecordingGraphicsEngine graphics;
+    NullPlatform platform;
+    Engine engine(&platform, &graphics, nullptr);
+    Scene scene(engine);
+#ifdef EDITOR_ENABLED
+    // Its shader override replaces the program of the editor camera, this is about the model's own
+    scene.UnregisterSystem<EditorSystem>();
+#endif
+    scene.AddComponent<CameraComponent>(scene.CreateEntity());
+
+    const boost::uuids::uuid litModel = boost::uuids::random_generator()();
+    const boost::uuids::uuid unlitModel = boost::uuids::random_generator()();
+    for (const auto& [modelId, mask] : {std::pair{litModel, 0u}, std::pair{unlitModel, unlit}}) {
+        const Entity entity = scene.CreateEntity();
+        RendererComponent renderer(modelId, programId.value());
+        renderer.shaderPermutation = mask;
+        scene.AddComponent<RendererComponent>(entity, renderer);
+    }
+    scene.Update(0.016f);
+
+    BOOST_REQUIRE(graphics.draws.size() == 2u);
+    for (const DrawCall& draw : graphics.draws) {
+        BOOST_TEST(draw.shaderId == programId.value());
+        const bool isUnlit = draw.modelId == unlitModel;
+        BOOST_TEST(draw.permutationMask == (isUnlit ? unlit : 0u));
+
+        // What the pipeline of the draw is built from, the unlit variant has no lights to bind
+        BOOST_TEST(program->findVariant(draw.permutationMask) != nullptr);
+        const auto fragment = program->getVariantBytecode(draw.permutationMask, am::ShaderStage::Fragment);
+        BOOST_REQUIRE(!fragment.empty());
+        BOOST_TEST(bindsLightsSet(fragment) == !isUnlit);
+    }
+    BOOST_TEST(!std::ranges::equal(program->getVariantBytecode(0, am::ShaderStage::Fragment),
+                                   program->getVariantBytecode(unlit, am::ShaderStage::Fragment)));
+}
+
+BOOST_AUTO_TEST_CASE(VariantsLoadFromTheSavedProgram) {
+    auto& assetManager = am::AssetManager::getInstance();
+    const auto programId = assetManager.registerAsset("res/shaders/jsons/pbr.shaderImport");
+    BOOST_REQUIRE(programId.has_value());
+    auto imported = assetManager.getAsset(programId.value());
+    BOOST_REQUIRE(imported.has_value());
+    const auto* program = assetManager.getAssetData<am::ShaderProgramData>(programId.value());
+
+    std::string path = (std::filesystem::temp_directory_path() / "shader_permutation_test.b_shaderprogram").string();
+    imported.value()->SaveAssetToBin(path);
+
+    // What a build running from an archive gets, the variants come out of the file instead of a compile
+    am::ShaderProgramAsset loaded(programId.value(), path, am::AssetFormat::Binary);
+    const auto* loadedData = loaded.getAssetDataAs<am::ShaderProgramData>();
+    BOOST_TEST(loadedData->permutationAxes == program->permutationAxes);
+    BOOST_REQUIRE(loadedData->variants.size() == program->variants.size());
+    BOOST_REQUIRE(loadedData->modules.size() == program->modules.size());
+    for (const auto& module : loadedData->modules) {
+        BOOST_TEST(module.mapping != nullptr);
+    }
+    for (const auto& variant : program->variants) {
+        BOOST_REQUIRE(loadedData->findVariant(variant.mask) != nullptr);
+        for (const auto stage : {am::ShaderStage::Vertex, am::ShaderStage::Fragment}) {
+            BOOST_TEST(std::ranges::equal(loadedData->getVariantBytecode(variant.mask, stage),
+                                          program->getVariantBytecode(variant.mask, stage)));
+        }
+    }
+    BOOST_TEST(loadedData->vertexShader == program->vertexShader);
+    BOOST_TEST(loadedData->fragmentShader == program->fragmentShader);
+    std::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(RendererMaskSurvivesSerialization) {
+    RendererComponent renderer(boost::uuids::random_generator()(), boost::uuids::random_generator()());
+    renderer.shaderPermutation = 0b101;
+
+    rapidjson::Document document(rapidjson::kObjectType);
+    renderer.SerializeComponentToJson(document, document.GetAllocator());
+    RendererComponent fromJson;
+    fromJson.DeserializeComponentFromJson(document);
+    BOOST_TEST(fromJson.shaderPermutation == 0b101u);
+
+    RendererComponent fromRecord;
+    fromRecord.FromRecord(renderer.ToRecord());
+    BOOST_TEST(fromRecord.shaderPermutation == 0b101u);
+    BOOST_TEST(fromRecord.shaderUuid == renderer.shaderUuid);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,179 @@
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+#include "../Engine.h"
+#include "../ecs/Scene.h"
+#include "../systems/transformSystem/TransformSystem.h"
+
+using namespace engine;
+using namespace engine::ecs;
+
+namespace
+{
+    std::vector<TransformComponent> makeTransforms(size_t count)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<TransformComponent> transforms(count);
+        for (TransformComponent& transform : transforms) {
+            transform.position = glm::vec3(dist(rng), dist(rng), dist(rng)) * 10.0f;
+            transform.rotation = glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng)));
+            transform.scale = glm::vec3(1.5f + dist(rng));
+        }
+        return transforms;
+    }
+
+    bool closeTo(const glm::mat4& a, const glm::mat4& b)
+    {
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                if (std::abs(a[column][row] - b[column][row]) > 1e-4f) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(TransformStorageTests)
+
+BOOST_AUTO_TEST_CASE(ChunkedLocalMatricesMatchComponentMath) {
+    const auto transforms = makeTransforms(MAX_ENTITIES);
+    TransformComponentArray array;
+    for (Entity entity = 0; entity < MAX_ENTITIES; ++entity) {
+        array.AddComponentToEntity(entity, transforms[entity]);
+    }
+    array.ComposeLocalMatrices();
+
+    for (Entity entity = 0; entity < MAX_ENTITIES; ++entity) {
+        BOOST_TEST(closeTo(array.GetLocalMatrix(entity), getLocalModelMatrix(transforms[entity])));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(HasComponentFollowsAddAndRemove) {
+    TransformComponentArray array;
+    const Entity entity = TransformChunk::kSize + 3;
+    BOOST_TEST(!array.HasComponent(entity));
+
+    array.AddComponentToEntity(entity, TransformComponent());
+    BOOST_TEST(array.HasComponent(entity));
+    BOOST_TEST(!array.HasComponent(entity + 1));
+
+    // Inactive is still there, removed is not
+    array.SetComponentActive(entity, false);
+    BOOST_TEST(array.HasComponent(entity));
+    array.RemoveComponentFronEntity(entity);
+    BOOST_TEST(!array.HasComponent(entity));
+}
+
+BOOST_AUTO_TEST_CASE(ProxyWritesReachTheHierarchy) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+    const Entity parent = scene.CreateEntity();
+    const Entity child = scene.CreateEntity(parent);
+    auto transformSystem = scene.GetSystem<TransformSystem>();
+
+    // Plain field writes don't raise isDirty, the commit still has to notice them
+    scene.GetComponent<TransformComponent>(parent).position = glm::vec3(1.0f, 0.0f, 0.0f);
+    scene.GetComponent<TransformComponent>(child).position = glm::vec3(0.0f, 2.0f, 0.0f);
+    transformSystem->Update(0.0f);
+    BOOST_TEST(scene.GetTransformArray()->GetWorldMatrix(child)[3].x == 1.0f);
+    BOOST_TEST(scene.GetTransformArray()->GetWorldMatrix(child)[3].y == 2.0f);
+
+    // Moving the parent alone carries the child along
+    scene.GetTransformArray()->SetPosition(parent, glm::vec3(5.0f, 0.0f, 0.0f));
+    transformSystem->Update(0.0f);
+    BOOST_TEST(scene.GetTransformArray()->GetWorldMatrix(child)[3].x == 5.0f);
+    BOOST_TEST(!scene.GetTransformArray()->IsDirty(parent));
+
+    // Reparented entities pick up the new parent's space
+    scene.RemoveParent(child);
+    transformSystem->Update(0.0f);
+    BOOST_TEST(scene.GetTransformArray()->GetWorldMatrix(child)[3].x == 0.0f);
+}
+
+BOOST_AUTO_TEST_CASE(ProxiesAndStreamWritesKeepTheLatest) {
+    Engine engine(nullptr, nullptr, nullptr);
+    Scene scene(engine);
+    const Entity entity = scene.CreateEntity();
+    auto transforms = scene.GetTransformArray();
+
+    // Saved before any update, the proxy edit is in the pool
+    scene.GetComponent<TransformComponent>(entity).position = glm::vec3(3.0f, 0.0f, 0.0f);
+    BOOST_TEST(transforms->GetPosition(entity).x == 3.0f);
+    SceneBinaryPoolData pool;
+    transforms->SerializeToBinary(pool);
+    const auto slot = std::ranges::find(pool.slots, entity, &SceneBinarySlot::entity);
+    BOOST_REQUIRE(slot != pool.slots.end());
+    TransformComponent::Record record;
+    std::memcpy(&record, pool.records.data() + (slot - pool.slots.begin()) * sizeof(record), sizeof(record));
+    BOOST_TEST(record.position.x == 3.0f);
+
+    // A direct write after the proxy edit is newer, the proxy must not put its value back
+    transforms->SetPosition(entity, glm::vec3(7.0f, 0.0f, 0.0f));
+    BOOST_TEST(scene.GetComponent<TransformComponent>(entity).position.x == 7.0f);
+    scene.GetSystem<TransformSystem>()->Update(0.0f);
+    BOOST_TEST(transforms->GetWorldMatrix(entity)[3].x == 7.0f);
+
+    // And a proxy edit after a direct write wins
+    TransformComponent& proxy = scene.GetComponent<TransformComponent>(entity);
+    transforms->SetScale(entity, glm::vec3(2.0f));
+    proxy.scale = glm::vec3(4.0f);
+    scene.GetSystem<TransformSystem>()->Update(0.0f);
+    BOOST_TEST(transforms->GetScale(entity).x == 4.0f);
+    BOOST_TEST(transforms->GetWorldMatrix(entity)[0].x == 4.0f);
+}
+
+// Throughput of building local and world matrices for every entity, the old component array against the chunks.
+// MAX_ENTITIES is small so the whole set is walked many times. The bound is loose so a loaded machine doesn't fail it,
+// it catches the chunks falling behind the layout they replaced
+BOOST_AUTO_TEST_CASE(IterationThroughputAgainstComponentLayout) {
+    constexpr int iterations = 20000;
+    const auto source = makeTransforms(MAX_ENTITIES);
+
+    std::array<TransformComponent, MAX_ENTITIES> components;
+    std::ranges::copy(source, components.begin());
+    TransformComponentArray array;
+    for (Entity entity = 0; entity < MAX_ENTITIES; ++entity) {
+        array.AddComponentToEntity(entity, source[entity]);
+    }
+
+    const auto componentStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (TransformComponent& transform : components) {
+            transform.isDirty = true;
+            computeGlobalMatrix(transform, glm::mat4(1.0f));
+        }
+    }
+    const auto componentTime = std::chrono::steady_clock::now() - componentStart;
+
+    const auto chunkStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (Entity entity = 0; entity < MAX_ENTITIES; entity += TransformChunk::kSize) {
+            array.MarkDirty(entity);
+        }
+        array.ComposeLocalMatrices();
+        for (TransformChunk& chunk : array.GetChunks()) {
+            std::ranges::copy(chunk.local, chunk.world);
+        }
+        array.ClearDirty();
+    }
+    const auto chunkTime = std::chrono::steady_clock::now() - chunkStart;
+
+    for (Entity entity = 0; entity < MAX_ENTITIES; ++entity) {
+        BOOST_TEST(closeTo(array.GetWorldMatrix(entity), components[entity].globalMatrix));
+    }
+
+    using std::chrono::microseconds;
+    const auto componentUs = std::chrono::duration_cast<microseconds>(componentTime).count();
+    const auto chunkUs = std::chrono::duration_cast<microseconds>(chunkTime).count();
+    BOOST_TEST_MESSAGE("Transforms x" << iterations << ": components " << componentUs << " us, chunks " << chunkUs
+                       << " us (" << static_cast<double>(componentUs) / std::max<long long>(chunkUs, 1) << "x)");
+    BOOST_TEST(chunkTime < componentTime * 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -72,22 +72,35 @@ namespace vks {
     }
 
     void VulkanRenderer::loadModel(boost::uuids::uuid uuid) {
-        descriptorManager->getOrLoadResource<ModelDescriptor>(uuid);
+        descriptorManager->acquireResource(uuid);
     }
 
     void VulkanRenderer::loadShader(boost::uuids::uuid uuid) {
-        descriptorManager->getOrLoadResource<ShaderProgramDescriptor>(uuid);
+        descriptorManager->acquireResource(uuid);
     }
 
     void VulkanRenderer::loadTexture(boost::uuids::uuid uuid) {
-        descriptorManager->getOrLoadResource<TextureDescriptor>(uuid);
+        descriptorManager->acquireResource(uuid);
     }
 
-    void VulkanRenderer::drawModel(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid shaderId, const glm::mat4& transform) {
+    void VulkanRenderer::releaseResource(boost::uuids::uuid uuid) {
+        descriptorManager->releaseResource(uuid);
+    }
+
+    void VulkanRenderer::reloadResources(const std::vector<boost::uuids::uuid>& assetIds) {
+        // Frames in flight still read the old descriptors and pipelines, a reload is rare enough to wait for them
+        waitIdle();
+        const auto rebuilt = descriptorManager->rebuildResources(assetIds);
+        pipelineManager->rebuildPipelines(rebuilt);
+        renderManager->refreshResources(rebuilt);
+    }
+
+    void VulkanRenderer::drawModel(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid shaderId, uint32_t permutationMask,
+                                   const glm::mat4& transform, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
     if (shaderId.is_nil()){
         shaderId = pbrShaderId;
     }
-    renderManager->submitRenderCommand(cameraIndex, modelId, shaderId, transform);
+    renderManager->submitRenderCommand(cameraIndex, modelId, shaderId, permutationMask, transform, boundsMin, boundsMax);
 }
 
     void VulkanRenderer::drawSkybox(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid shaderId)
@@ -115,6 +128,32 @@ namespace vks {
     }
 
 
+    void VulkanRenderer::setTextureMemoryBudget(uint64_t bytes)
+    {
+        descriptorManager->textureStreamer.settings.budgetBytes = bytes;
+    }
+
+    gfx::TextureStreamingStats VulkanRenderer::getTextureStreamingStats()
+    {
+        return descriptorManager->textureStreamer.getStats();
+    }
+
+    void VulkanRenderer::setResourceMemoryBudget(uint64_t bytes)
+    {
+        descriptorManager->residencySettings.budgetBytes = bytes;
+    }
+
+    gfx::ResourceResidencyStats VulkanRenderer::getResourceResidencyStats()
+    {
+        return descriptorManager->getResidencyStats();
+    }
+
+    gfx::FrameArenaStats VulkanRenderer::getFrameArenaStats()
+    {
+        return renderManager->getFrameArenaStats();
+    }
+
+
     void VulkanRenderer::beginFrame() {
         if (!minimized)
         {
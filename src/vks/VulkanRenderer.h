@@ -32,12 +32,21 @@ namespace vks {
 		void loadModel(boost::uuids::uuid uuid) override;
 		void loadShader(boost::uuids::uuid uuid) override;
 		void loadTexture(boost::uuids::uuid uuid) override;
-		void drawModel(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid shaderId, const glm::mat4& transform) override;
+		void releaseResource(boost::uuids::uuid uuid) override;
+		void reloadResources(const std::vector<boost::uuids::uuid>& assetIds) override;
+		void drawModel(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid shaderId, uint32_t permutationMask,
+		               const glm::mat4& transform, const glm::vec3& boundsMin, const glm::vec3& boundsMax) override;
 		void drawSkybox(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid shaderId) override;
 		void drawLight(gfx::PointLightData pointLightData, const glm::mat4& transform) override;
 		void drawLight(gfx::SpotLightData spotLightData, const glm::mat4& transform) override;
 		void drawLight(gfx::DirectionalLightData directionalLightData, const glm::mat4& transform) override;
 
+		void setTextureMemoryBudget(uint64_t bytes) override;
+		gfx::TextureStreamingStats getTextureStreamingStats() override;
+		void setResourceMemoryBudget(uint64_t bytes) override;
+		gfx::ResourceResidencyStats getResourceResidencyStats() override;
+		gfx::FrameArenaStats getFrameArenaStats() override;
+
 		void beginFrame() override;
 		void renderFrame() override;
 		void endFrame() override;
@@ -0,0 +1,114 @@
+//
+// Created by redkc on 19/10/2026.
+// Linear allocator for data that only lives for a frame, one arena per frame in flight
+//
+
+#ifndef REASONABLEVULKAN_FRAMEARENA_HPP
+#define REASONABLEVULKAN_FRAMEARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace gfx
+{
+    struct FrameArenaStats
+    {
+        uint64_t usedBytes = 0;             // Handed out since the current frame began
+        uint64_t peakUsedBytes = 0;         // Most any single frame used
+        uint64_t capacityBytes = 0;         // Held by the arenas of all frames in flight
+        uint32_t blockAllocations = 0;      // Arena blocks taken from the heap since the current frame began, 0 once warm
+        uint32_t lastFrameBlockAllocations = 0;
+        uint64_t totalBlockAllocations = 0;
+
+        // Every heap allocation of the process, only known when something feeds countHeapAllocation
+        bool heapAllocationsTracked = false;
+        uint64_t heapAllocations = 0;       // Since the current frame began
+        uint64_t lastFrameHeapAllocations = 0;
+    };
+
+    // Opt-in hook for an operator new override in the executable or a test. Lock free and allocation free, so it can
+    // be called from inside operator new. Frame arenas report the count per frame next to their own stats
+    void countHeapAllocation() noexcept;
+    [[nodiscard]] bool isHeapAllocationCountTracked() noexcept;
+    [[nodiscard]] uint64_t getHeapAllocationCount() noexcept;
+
+    // Bump allocator. Deallocation does nothing, everything is released at once by reset. Blocks are kept across
+    // resets, and when a frame needed more than one they are merged into a single block of the combined size
+    class LinearArena : public std::pmr::memory_resource
+    {
+    public:
+        explicit LinearArena(size_t blockSize = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~LinearArena() override;
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        void reset();
+
+        size_t usedBytes() const { return used; }
+        size_t capacityBytes() const;
+        uint32_t blockAllocations() const { return allocationsSinceReset; }
+
+    private:
+        struct Block {
+            std::byte* data;
+            size_t size;
+        };
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        void addBlock(size_t minimumSize);
+        void releaseBlocks();
+
+        std::pmr::memory_resource* upstream;
+        size_t blockSize;
+        std::vector<Block> blocks;
+        size_t current = 0;         // Block being bumped
+        size_t offset = 0;          // Into the current block
+        size_t used = 0;
+        uint32_t allocationsSinceReset = 0;
+    };
+
+    // Double (or more) buffered LinearArena. beginFrame resets the arena of the frame slot whose GPU work is known to
+    // be done, memory handed out stays valid until that slot comes around again. Containers bind to the FrameArena
+    // itself, it forwards to whichever slot is current, so they have to drop their storage every frame. The usual way
+    // is swapping with an empty container, see releaseFrameStorage
+    class FrameArena : public std::pmr::memory_resource
+    {
+    public:
+        explicit FrameArena(size_t framesInFlight = 2, size_t blockSize = 64 * 1024);
+
+        void beginFrame(size_t frameIndex);
+        // Advances to the next slot, for owners that don't track a frame index themselves
+        void beginFrame() { beginFrame((currentFrame + 1) % arenas.size()); }
+
+        size_t getFramesInFlight() const { return arenas.size(); }
+        FrameArenaStats getStats() const;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        std::vector<std::unique_ptr<LinearArena>> arenas;
+        size_t currentFrame = 0;
+        size_t peakUsed = 0;
+        uint32_t lastFrameBlockAllocations = 0;
+        uint64_t totalBlockAllocations = 0;
+        uint64_t frameStartHeapAllocations = 0;
+        uint64_t lastFrameHeapAllocations = 0;
+    };
+
+    // Gives up a container's storage without touching it, the arena reclaims it in bulk
+    template <typename Container>
+    void releaseFrameStorage(Container& container)
+    {
+        Container(container.get_allocator()).swap(container);
+    }
+}
+
+#endif //REASONABLEVULKAN_FRAMEARENA_HPP
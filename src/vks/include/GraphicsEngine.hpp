@@ -3,10 +3,14 @@
 #define GFX_HPP
 #include <boost/mp11/integral.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <vector>
 #include <glm/fwd.hpp>
 #include <glm/detail/type_mat4x4.hpp>
 
+#include "FrameArena.hpp"
 #include "LightData.hpp"
+#include "TextureStreamingData.hpp"
+#include "ResourceResidencyData.hpp"
 
 
 namespace plt
@@ -30,7 +34,9 @@ namespace gfx {
 
         virtual void setCameraData(uint32_t cameraIndex, const glm::mat4& projection, const glm::mat4& view, const glm::vec3 cameraPos) = 0;
         virtual void setActiveCameraCount(uint32_t count) = 0;
-        virtual void drawModel(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid shaderId, const glm::mat4& transform) = 0;
+        // permutationMask picks one of the program's compiled variants by its axis bits, 0 draws the program as written
+        virtual void drawModel(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid shaderId, uint32_t permutationMask,
+                               const glm::mat4& transform, const glm::vec3& boundsMin, const glm::vec3& boundsMax) = 0;
         virtual void drawSkybox(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid shaderId) = 0;
         virtual void drawLight(PointLightData pointLightData, const glm::mat4& transform) = 0;
         virtual void drawLight(SpotLightData spotLightData, const glm::mat4& transform) = 0;
@@ -38,6 +44,21 @@ namespace gfx {
         virtual void loadModel(boost::uuids::uuid uuid) = 0;
         virtual void loadShader(boost::uuids::uuid uuid) = 0;
         virtual void loadTexture(boost::uuids::uuid uuid) = 0;
+        // Loads keep a resource resident until released, anything drawn without one can be evicted under budget
+        virtual void releaseResource(boost::uuids::uuid uuid) {}
+        // Assets were reimported in place, rebuilds what was made from them and everything built on that
+        virtual void reloadResources(const std::vector<boost::uuids::uuid>& assetIds) {}
+
+        // Texture streaming
+        virtual void setTextureMemoryBudget(uint64_t bytes) {}
+        virtual gfx::TextureStreamingStats getTextureStreamingStats() { return {}; }
+
+        // GPU resource residency
+        virtual void setResourceMemoryBudget(uint64_t bytes) {}
+        virtual gfx::ResourceResidencyStats getResourceResidencyStats() { return {}; }
+
+        // Per-frame transient memory of the renderer
+        virtual gfx::FrameArenaStats getFrameArenaStats() { return {}; }
 
         virtual void beginFrame() = 0;
         virtual void renderFrame() = 0;
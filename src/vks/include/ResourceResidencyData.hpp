@@ -0,0 +1,25 @@
+//
+// Created by redkc on 19/10/2026.
+// GPU resource residency statistics exposed by the graphics engine
+//
+
+#ifndef REASONABLEVULKAN_RESOURCERESIDENCYDATA_HPP
+#define REASONABLEVULKAN_RESOURCERESIDENCYDATA_HPP
+
+#include <cstdint>
+
+namespace gfx
+{
+    struct ResourceResidencyStats
+    {
+        uint64_t budgetBytes = 0;           // 0 when unlimited
+        uint64_t residentBytes = 0;
+        uint32_t residentCount = 0;
+        uint32_t referencedCount = 0;       // Acquired directly or by a resource built on top of them
+        uint32_t evictableCount = 0;
+        uint32_t pendingDestroyCount = 0;   // Evicted, waiting for the frames in flight that may use them
+        uint32_t evictedLastFrame = 0;
+    };
+}
+
+#endif //REASONABLEVULKAN_RESOURCERESIDENCYDATA_HPP
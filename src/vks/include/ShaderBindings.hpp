@@ -0,0 +1,34 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef REASONABLEVULKAN_SHADERBINDINGS_HPP
+#define REASONABLEVULKAN_SHADERBINDINGS_HPP
+
+#include <cstdint>
+
+namespace vks
+{
+    // Descriptor sets every shader agrees on
+    constexpr uint32_t kSceneSet = 0;
+    constexpr uint32_t kMaterialSet = 1;
+    constexpr uint32_t kMeshSet = 2;
+    constexpr uint32_t kLightsSet = 3;
+
+    // What a shader program binds, reflected from its SPIR-V once when it's loaded so draws only test bits
+    enum ShaderBindingBits : uint32_t {
+        SCENE_SET_BIT = 1u << 0,
+        MATERIAL_PBR_SET_BIT = 1u << 1,
+        MATERIAL_SKYBOX_SET_BIT = 1u << 2,        // Set 1 samples a cube map
+        MESH_SET_BIT = 1u << 3,
+        LIGHTS_SET_BIT = 1u << 4,
+        MODEL_PUSH_CONSTANT_BIT = 1u << 5,
+        LIGHT_MODEL_PUSH_CONSTANT_BIT = 1u << 6,
+        VERTEX_INPUT_BIT = 1u << 7,               // The vertex stage reads vertex attributes
+        MULTIVIEW_BIT = 1u << 8
+    };
+
+    using ShaderBindingMask = uint32_t;
+}
+
+#endif //REASONABLEVULKAN_SHADERBINDINGS_HPP
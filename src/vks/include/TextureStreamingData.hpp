@@ -0,0 +1,38 @@
+//
+// Created by redkc on 19/10/2026.
+// Texture streaming statistics exposed by the graphics engine
+//
+
+#ifndef REASONABLEVULKAN_TEXTURESTREAMINGDATA_HPP
+#define REASONABLEVULKAN_TEXTURESTREAMINGDATA_HPP
+
+#include <cstdint>
+#include <vector>
+#include <boost/uuid/uuid.hpp>
+
+namespace gfx
+{
+    // Residency of a single streamed texture
+    struct TextureResidencyInfo
+    {
+        boost::uuids::uuid textureId;
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipCount;
+        uint32_t residentBaseMip;   // Finest level currently in VRAM
+        uint32_t targetBaseMip;     // Finest level the last frames asked for
+        uint64_t residentBytes;
+        uint64_t framesSinceRequested;
+    };
+
+    struct TextureStreamingStats
+    {
+        uint64_t budgetBytes = 0;
+        uint64_t residentBytes = 0;
+        uint32_t streamedInLastFrame = 0;
+        uint32_t evictedLastFrame = 0;
+        std::vector<TextureResidencyInfo> textures;
+    };
+}
+
+#endif //REASONABLEVULKAN_TEXTURESTREAMINGDATA_HPP
@@ -1,5 +1,10 @@
 #include "DescriptorManager.h"
+#include <algorithm>
+#include <array>
+#include <functional>
 #include <stdexcept>
+#include <unordered_set>
+#include <boost/uuid/uuid_io.hpp>
 
 #include "buffers/LightBufferData.hpp"
 
@@ -100,7 +105,16 @@ namespace vks
         }
 
         // Clear resource cache
+        for (auto& retired : retiredResources)
+        {
+            destroyResource(retired);
+        }
+        retiredResources.clear();
         loadedResources.clear();
+        pendingLoads.clear();
+        residencies.clear();
+        evictionList.clear();
+        residentBytes = 0;
 
         // Destroy descriptor sets layouts
         if (pbrMaterialLayout != VK_NULL_HANDLE)
@@ -148,6 +162,7 @@ namespace vks
         materialPoolInfo.poolSizeCount = static_cast<uint32_t>(materialPoolSizes.size());
         materialPoolInfo.pPoolSizes = materialPoolSizes.data();
         materialPoolInfo.maxSets = 100;
+        materialPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT; // Evicted materials give their set back
 
         if (vkCreateDescriptorPool(context->getDevice(), &materialPoolInfo, nullptr, &pbrMaterialPool) != VK_SUCCESS)
         {
@@ -161,6 +176,7 @@ namespace vks
         meshPoolInfo.poolSizeCount = 1;
         meshPoolInfo.pPoolSizes = &meshPoolSize;
         meshPoolInfo.maxSets = 1000;
+        meshPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
         if (vkCreateDescriptorPool(context->getDevice(), &meshPoolInfo, nullptr, &meshPool) != VK_SUCCESS)
         {
@@ -332,7 +348,7 @@ namespace vks
         samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
         samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
         samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        samplerInfo.maxLod = static_cast<float>(0);
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE; // Textures ship with their full mip chain
         samplerInfo.maxAnisotropy = 8.0f;
         samplerInfo.anisotropyEnable = VK_TRUE;
 
@@ -342,6 +358,7 @@ namespace vks
         samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
         samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
         samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.maxLod = static_cast<float>(0);
         VK_CHECK_RESULT(vkCreateSampler(context->getDevice(), &samplerInfo, nullptr, &cubeSampler));
 
         createDefaultTexture();
@@ -686,6 +703,298 @@ namespace vks
         return loadedResources.find(assetId) != loadedResources.end();
     }
 
+    void DescriptorManager::acquireResource(const boost::uuids::uuid& assetId)
+    {
+        if (!isResourceLoaded(assetId))
+        {
+            loadResource(assetId);
+        }
+
+        auto& residency = residencies.at(assetId);
+        if (residency.refCount++ == 0)
+        {
+            evictionList.erase(residency.lruPosition);
+        }
+    }
+
+    void DescriptorManager::releaseResource(const boost::uuids::uuid& assetId)
+    {
+        auto residency = residencies.find(assetId);
+        if (residency == residencies.end() || residency->second.refCount == 0)
+        {
+            spdlog::error("Released resource {} that was never acquired", boost::uuids::to_string(assetId));
+            return;
+        }
+
+        // Evicted on the next update if the budget needs the memory
+        if (--residency->second.refCount == 0)
+        {
+            residency->second.lruPosition = evictionList.insert(evictionList.begin(), assetId);
+        }
+    }
+
+    void DescriptorManager::updateResidency()
+    {
+        ++residencyFrame;
+        evictedLastFrame = 0;
+
+        std::erase_if(retiredResources, [this](RetiredResource& retired)
+        {
+            if (retired.frame + residencySettings.framesInFlight > residencyFrame)
+                return false;
+            destroyResource(retired);
+            return true;
+        });
+
+        // Textures change size as their mips stream in and out
+        residentBytes = 0;
+        for (auto& [id, residency] : residencies)
+        {
+            residency.bytes = loadedResources[id]->getMemoryUsage();
+            residentBytes += residency.bytes;
+        }
+
+        if (residencySettings.budgetBytes == 0)
+            return;
+
+        // Evicting a resource releases what it was built from, those land at the front and are reached later in the walk
+        auto it = evictionList.end();
+        while (residentBytes > residencySettings.budgetBytes && it != evictionList.begin())
+        {
+            --it;
+            const boost::uuids::uuid assetId = *it;
+            if (residencies.at(assetId).type == am::AssetType::Shader || residencies.at(assetId).type == am::AssetType::ShaderProgram)
+                continue;   // Pipelines are built from these
+
+            it = evictionList.erase(it);
+            evictResource(assetId);
+        }
+    }
+
+    gfx::ResourceResidencyStats DescriptorManager::getResidencyStats() const
+    {
+        gfx::ResourceResidencyStats stats;
+        stats.budgetBytes = residencySettings.budgetBytes;
+        stats.residentBytes = residentBytes;
+        stats.residentCount = static_cast<uint32_t>(residencies.size());
+        stats.evictableCount = static_cast<uint32_t>(evictionList.size());
+        stats.referencedCount = stats.residentCount - stats.evictableCount;
+        stats.pendingDestroyCount = static_cast<uint32_t>(retiredResources.size());
+        stats.evictedLastFrame = evictedLastFrame;
+        return stats;
+    }
+
+    IVulkanDescriptor* DescriptorManager::trackResource(const boost::uuids::uuid& assetId, const am::Asset& asset)
+    {
+        IVulkanDescriptor* descriptor = loadedResources[assetId].get();
+
+        auto& residency = residencies[assetId];
+        residency.type = asset.getType();
+        residency.bytes = descriptor->getMemoryUsage();
+        residency.lruPosition = evictionList.insert(evictionList.begin(), assetId);
+        residentBytes += residency.bytes;
+
+        // The descriptor holds pointers into these, they were loaded while it was built
+        for (const auto& dependencyId : asset.getDependencies())
+        {
+            if (isResourceLoaded(dependencyId))
+            {
+                acquireResource(dependencyId);
+                residency.dependencies.push_back(dependencyId);
+            }
+        }
+        return descriptor;
+    }
+
+    void DescriptorManager::touchResource(const boost::uuids::uuid& assetId)
+    {
+        auto residency = residencies.find(assetId);
+        if (residency != residencies.end() && residency->second.refCount == 0)
+        {
+            evictionList.splice(evictionList.begin(), evictionList, residency->second.lruPosition);
+        }
+    }
+
+    // The caller already took it out of the eviction list
+    void DescriptorManager::evictResource(const boost::uuids::uuid& assetId)
+    {
+        auto residency = residencies.find(assetId);
+        const am::AssetType type = residency->second.type;
+        const std::vector<boost::uuids::uuid> dependencies = std::move(residency->second.dependencies);
+        residentBytes -= residency->second.bytes;
+        residencies.erase(residency);
+
+        if (type == am::AssetType::Texture)
+        {
+            textureStreamer.unregisterTexture(assetId);
+        }
+
+        auto resource = loadedResources.find(assetId);
+        retiredResources.push_back({std::move(resource->second), type, residencyFrame});
+        loadedResources.erase(resource);
+        ++evictedLastFrame;
+
+        for (const auto& dependencyId : dependencies)
+        {
+            releaseResource(dependencyId);
+        }
+    }
+
+    std::vector<boost::uuids::uuid> DescriptorManager::rebuildResources(const std::vector<boost::uuids::uuid>& assetIds)
+    {
+        // Reimported assets that failed before get asked for again right away
+        for (const auto& assetId : assetIds)
+        {
+            pendingLoads.erase(assetId);
+        }
+
+        // A resource built on a rebuilt one points into what is retired, so it is rebuilt as well
+        std::unordered_map<boost::uuids::uuid, std::vector<boost::uuids::uuid>> dependents;
+        for (const auto& [id, residency] : residencies)
+        {
+            for (const auto& dependencyId : residency.dependencies)
+            {
+                dependents[dependencyId].push_back(id);
+            }
+        }
+
+        std::vector<boost::uuids::uuid> affected;
+        std::unordered_set<boost::uuids::uuid> affectedSet;
+        for (const auto& assetId : assetIds)
+        {
+            if (isResourceLoaded(assetId) && affectedSet.insert(assetId).second)
+                affected.push_back(assetId);
+        }
+        for (size_t i = 0; i < affected.size(); ++i)
+        {
+            for (const auto& dependentId : dependents[affected[i]])
+            {
+                if (affectedSet.insert(dependentId).second)
+                    affected.push_back(dependentId);
+            }
+        }
+
+        // Dependencies first, a descriptor looks up what it uses while it is built
+        std::vector<boost::uuids::uuid> rebuilt;
+        std::unordered_set<boost::uuids::uuid> visited;
+        std::function<void(const boost::uuids::uuid&)> rebuild = [&](const boost::uuids::uuid& assetId)
+        {
+            if (!visited.insert(assetId).second)
+                return;
+            for (const auto& dependencyId : residencies.at(assetId).dependencies)
+            {
+                if (affectedSet.contains(dependencyId))
+                    rebuild(dependencyId);
+            }
+            if (rebuildResource(assetId))
+                rebuilt.push_back(assetId);
+        };
+        for (const auto& assetId : affected)
+        {
+            rebuild(assetId);
+        }
+        return rebuilt;
+    }
+
+    void DescriptorManager::retryPendingLoadLater(const boost::uuids::uuid& assetId, PendingLoad& pending)
+    {
+        constexpr uint64_t kFirstRetryFrames = 60;
+        constexpr uint64_t kMaxRetryFrames = 60 * 64;
+
+        if (pending.failures == 0)
+        {
+            spdlog::error("Failed to load asset {}, retrying with backoff until it is reimported",
+                          boost::uuids::to_string(assetId));
+        }
+        pending.retryFrame = residencyFrame + std::min(kFirstRetryFrames << std::min(pending.failures, 6u), kMaxRetryFrames);
+        ++pending.failures;
+        pending.handle = {};
+    }
+
+    bool DescriptorManager::rebuildResource(const boost::uuids::uuid& assetId)
+    {
+        auto assetInfo = assetManager->getAssetInfo(assetId);
+        am::Asset* asset = assetInfo.has_value() ? assetInfo->get()->getAsset() : nullptr;
+        if (!asset)
+        {
+            spdlog::error("Can't rebuild resource {}, its asset failed to load", boost::uuids::to_string(assetId));
+            return false;
+        }
+
+        auto& residency = residencies.at(assetId);
+        if (residency.type == am::AssetType::Texture)
+        {
+            textureStreamer.unregisterTexture(assetId);
+        }
+
+        std::unique_ptr<IVulkanDescriptor> descriptor;
+        try
+        {
+            descriptor = createDescriptor(assetId, *asset);
+        }
+        catch (const std::exception& e)
+        {
+            spdlog::error("Failed to rebuild resource {}, keeping the previous one: {}", boost::uuids::to_string(assetId), e.what());
+            if (residency.type == am::AssetType::Texture)
+                textureStreamer.registerTexture(static_cast<TextureDescriptor*>(loadedResources[assetId].get()));
+            return false;
+        }
+
+        // Building it may have loaded what it uses, so the slot is looked up only now
+        auto& resource = loadedResources[assetId];
+        retiredResources.push_back({std::move(resource), residency.type, residencyFrame});
+        resource = std::move(descriptor);
+
+        // The reimport may have changed what it is built from, the new ones are acquired before the old ones are released
+        std::vector<boost::uuids::uuid> dependencies;
+        for (const auto& dependencyId : asset->getDependencies())
+        {
+            if (isResourceLoaded(dependencyId))
+            {
+                acquireResource(dependencyId);
+                dependencies.push_back(dependencyId);
+            }
+        }
+        for (const auto& dependencyId : residency.dependencies)
+        {
+            releaseResource(dependencyId);
+        }
+        residency.dependencies = std::move(dependencies);
+
+        residentBytes -= residency.bytes;
+        residency.bytes = resource->getMemoryUsage();
+        residentBytes += residency.bytes;
+        return true;
+    }
+
+    void DescriptorManager::destroyResource(RetiredResource& resource)
+    {
+        VkDevice device = context->getDevice();
+        switch (resource.type)
+        {
+        case am::AssetType::Mesh:
+            {
+                auto mesh = static_cast<MeshDescriptor*>(resource.descriptor.get());
+                if (mesh->uniformBuffer.descriptorSet != VK_NULL_HANDLE)
+                    vkFreeDescriptorSets(device, meshPool, 1, &mesh->uniformBuffer.descriptorSet);
+                break;
+            }
+        case am::AssetType::Material:
+            {
+                auto material = static_cast<MaterialDescriptor*>(resource.descriptor.get());
+                if (material->descriptorSet != VK_NULL_HANDLE)
+                    vkFreeDescriptorSets(device, pbrMaterialPool, 1, &material->descriptorSet);
+                break;
+            }
+        case am::AssetType::Texture:
+            static_cast<TextureDescriptor*>(resource.descriptor.get())->destroy();
+            break;
+        default:
+            break;
+        }
+        resource.descriptor.reset();
+    }
+
 
     void DescriptorManager::createSceneUBO()
     {
@@ -915,8 +1224,8 @@ namespace vks
         cubeMapShadowMapArray.descriptorSet = lightsDescriptorSet;
     }
 
-    void DescriptorManager::updateLightsData(const std::vector<DirectionalLightBufferData>& directionalLights,
-        const std::vector<PointLightBufferData>& pointLights, const std::vector<SpotLightBufferData>& spotLights, float farPlane)
+    void DescriptorManager::updateLightsData(std::span<const DirectionalLightBufferData> directionalLights,
+        std::span<const PointLightBufferData> pointLights, std::span<const SpotLightBufferData> spotLights, float farPlane)
     {
 
         lightInfoUBO.uniformBlock.directionalLightCount = directionalLights.size();
@@ -998,27 +1307,21 @@ namespace vks
         vkUpdateDescriptorSets(context->getDevice(), static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
     }
 
-    std::vector<VkDescriptorSetLayout> DescriptorManager::getLayoutsFromEnums(std::vector<ShaderDefinesEnum> definitions)
+    std::vector<VkDescriptorSetLayout> DescriptorManager::getLayoutsFromBindings(ShaderBindingMask bindings) const
     {
+        std::array<VkDescriptorSetLayout, kLightsSet + 1> setLayouts{};
+        if (bindings & SCENE_SET_BIT) setLayouts[kSceneSet] = sceneLayout;
+        if (bindings & MATERIAL_PBR_SET_BIT) setLayouts[kMaterialSet] = pbrMaterialLayout;
+        if (bindings & MATERIAL_SKYBOX_SET_BIT) setLayouts[kMaterialSet] = skyboxMaterialLayout;
+        if (bindings & MESH_SET_BIT) setLayouts[kMeshSet] = meshUniformLayout;
+        if (bindings & LIGHTS_SET_BIT) setLayouts[kLightsSet] = lightsLayout;
+
+        // A layout needs every set below the highest one it uses
         std::vector<VkDescriptorSetLayout> layouts;
-        for (auto definition : definitions) {
-            switch (definition)
-            {
-            case SCENE_UBO_GLSL:
-                layouts.push_back(sceneLayout);
-                break;
-            case LIGHTING_COMMON_GLSL:
-                layouts.push_back(lightsLayout);
-                break;
-            case VERTEX_IO_GLSL:
-                layouts.push_back(meshUniformLayout);
-                break;
-            case MATERIAL_PBR_GLSL:
-                layouts.push_back(pbrMaterialLayout);
-                break;
-            case MATERIAL_SKYBOX_GLSL:
-                layouts.push_back(skyboxMaterialLayout);
-                break;
+        for (uint32_t set = 0; set < setLayouts.size(); ++set) {
+            if (setLayouts[set] != VK_NULL_HANDLE) {
+                layouts.resize(set + 1, sceneLayout);
+                layouts[set] = setLayouts[set];
             }
         }
         return layouts;
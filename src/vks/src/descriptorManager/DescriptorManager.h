@@ -1,5 +1,7 @@
 
 #pragma once
+#include <list>
+#include <span>
 #include <unordered_map>
 #include "Asset.hpp"
 #include "AssetManagerInterface.h"
@@ -14,11 +16,13 @@
 #include <glm/glm.hpp>
 #include <spdlog/spdlog.h>
 
-#include "ShaderDefinesEnum.hpp"
+#include "ShaderBindings.hpp"
 #include "buffers/LightBufferData.hpp"
 #include "buffers/LightSSBO.hpp"
 #include "buffers/ShadowMapArray.hpp"
 #include "buffers/SceneUBO.hpp"
+#include "textureStreamer/TextureStreamer.hpp"
+#include "ResourceResidencyData.hpp"
 
 namespace vks {
     class IVulkanDescriptor;
@@ -49,16 +53,37 @@ namespace vks {
         // Resource management
         template <typename T>
         T* getOrLoadResource(const boost::uuids::uuid& assetId);
+        // Never blocks on disk, requests the asset in the background and returns nullptr until it can be uploaded
+        template <typename T>
+        T* getResourceIfReady(const boost::uuids::uuid& assetId, am::LoadPriority priority = am::LoadPriority::Normal);
         bool isResourceLoaded(const boost::uuids::uuid& assetId);
 
+        // Residency. Loaded resources nobody acquired are evicted least recently used first once the budget is
+        // exceeded, a resource acquires what it is built from for as long as it stays loaded
+        struct ResidencySettings
+        {
+            VkDeviceSize budgetBytes = 0;   // 0 keeps everything resident
+            uint32_t framesInFlight = 2;    // Evicted resources are destroyed only once these frames completed
+        };
+        ResidencySettings residencySettings;
+
+        void acquireResource(const boost::uuids::uuid& assetId);
+        void releaseResource(const boost::uuids::uuid& assetId);
+        // Destroys what the GPU is done with and evicts under budget, call once per frame after waiting on its fence
+        void updateResidency();
+        gfx::ResourceResidencyStats getResidencyStats() const;
+        // The assets were reimported in place, rebuilds their loaded resources and everything built on top of them,
+        // each after what it uses. The old ones are retired like evicted ones. Returns the ids that were rebuilt
+        std::vector<boost::uuids::uuid> rebuildResources(const std::vector<boost::uuids::uuid>& assetIds);
+
         void createSceneUBO();
         void updateSceneUBO(uint32_t cameraIndex, const glm::mat4& projection, const glm::mat4& view, glm::vec3 cameraPos);
 
         void createLightsData();
         void updateLightsData(
-                 const std::vector<DirectionalLightBufferData>& directionalLights,
-                 const std::vector<PointLightBufferData>& pointLights,
-                 const std::vector<SpotLightBufferData>& spotLights,
+                 std::span<const DirectionalLightBufferData> directionalLights,
+                 std::span<const PointLightBufferData> pointLights,
+                 std::span<const SpotLightBufferData> spotLights,
                  float farPlane);
 
         // Resource management
@@ -81,7 +106,8 @@ namespace vks {
         VkDescriptorSetLayout getMeshUniformLayout() const { return meshUniformLayout; }
         VkDescriptorSetLayout getSceneLayout() const { return sceneLayout; }
         VkDescriptorSetLayout getLightsLayout() const { return lightsLayout; }
-        std::vector<VkDescriptorSetLayout> getLayoutsFromEnums(std::vector<ShaderDefinesEnum> definitions);
+        // Indexed by set up to the highest one the program binds, sets it skips hold the scene layout as a placeholder
+        std::vector<VkDescriptorSetLayout> getLayoutsFromBindings(ShaderBindingMask bindings) const;
 
         //Image sampler
         VkSampler defaultSampler = VK_NULL_HANDLE;
@@ -99,6 +125,14 @@ namespace vks {
 
         // Resource cache
         std::unordered_map<boost::uuids::uuid, std::unique_ptr<IVulkanDescriptor>> loadedResources;
+        // Asynchronous loads getResourceIfReady started. A failed one is asked for again after a backoff in frames
+        struct PendingLoad
+        {
+            am::AssetLoadHandle handle;     // Invalid while waiting for the retry
+            uint32_t failures = 0;
+            uint64_t retryFrame = 0;
+        };
+        std::unordered_map<boost::uuids::uuid, PendingLoad> pendingLoads;
         std::vector<SceneUBO> sceneUBOs;
         LightsInfoUBO lightInfoUBO;
         LightSSBO directionalLightSSBO;
@@ -106,6 +140,7 @@ namespace vks {
         LightSSBO spotLightSSBO;
         ShadowMapArray shadowMapArray;
         ShadowMapArray cubeMapShadowMapArray;
+        TextureStreamer textureStreamer{this};
 
         int maxDirectionalLights = 4;
         int maxPointLights = 124;
@@ -118,6 +153,41 @@ namespace vks {
         void createDefaultCubeTexture();
         void createDescriptorSetLayouts();
         IVulkanDescriptor* loadResource(const boost::uuids::uuid& assetId);
+        // A new descriptor for the asset, not tracked yet. Throws for types without one
+        std::unique_ptr<IVulkanDescriptor> createDescriptor(const boost::uuids::uuid& assetId, am::Asset& asset);
+
+    private:
+        struct ResourceResidency
+        {
+            am::AssetType type;
+            uint32_t refCount = 0;
+            VkDeviceSize bytes = 0;
+            std::vector<boost::uuids::uuid> dependencies;           // Acquired while this stays loaded
+            std::list<boost::uuids::uuid>::iterator lruPosition;    // Valid while refCount is 0
+        };
+
+        struct RetiredResource
+        {
+            std::unique_ptr<IVulkanDescriptor> descriptor;
+            am::AssetType type;
+            uint64_t frame;
+        };
+
+        std::unordered_map<boost::uuids::uuid, ResourceResidency> residencies;
+        std::list<boost::uuids::uuid> evictionList;     // Unreferenced resources, most recently used first
+        std::vector<RetiredResource> retiredResources;
+        uint64_t residencyFrame = 0;
+        VkDeviceSize residentBytes = 0;
+        uint32_t evictedLastFrame = 0;
+
+        IVulkanDescriptor* trackResource(const boost::uuids::uuid& assetId, const am::Asset& asset);
+        void touchResource(const boost::uuids::uuid& assetId);
+        void evictResource(const boost::uuids::uuid& assetId);
+        // Keeps the previous descriptor when the new one fails to build
+        bool rebuildResource(const boost::uuids::uuid& assetId);
+        // Logs the first failure only, later ones just push the retry further out
+        void retryPendingLoadLater(const boost::uuids::uuid& assetId, PendingLoad& pending);
+        void destroyResource(RetiredResource& resource);
 
 
 
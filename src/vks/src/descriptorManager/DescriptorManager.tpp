@@ -6,11 +6,46 @@ template <typename T>
 T* vks::DescriptorManager::getOrLoadResource(const boost::uuids::uuid& assetId)
 {
     if (isResourceLoaded(assetId))
+    {
+        touchResource(assetId);
         return (T*)(loadedResources[assetId].get());
+    }
 
     return (T*)(loadResource(assetId));
 }
 
+template <typename T>
+T* vks::DescriptorManager::getResourceIfReady(const boost::uuids::uuid& assetId, am::LoadPriority priority)
+{
+    if (isResourceLoaded(assetId))
+    {
+        touchResource(assetId);
+        return (T*)(loadedResources[assetId].get());
+    }
+
+    auto it = pendingLoads.try_emplace(assetId).first;
+    PendingLoad& pending = it->second;
+    if (!pending.handle.valid())
+    {
+        if (residencyFrame < pending.retryFrame)
+            return nullptr;
+        pending.handle = assetManager->loadAssetAsync(assetId, priority);
+    }
+
+    switch (pending.handle.getState())
+    {
+    case am::AssetLoadState::Ready:
+        pendingLoads.erase(it);
+        return (T*)(loadResource(assetId));
+    case am::AssetLoadState::Failed:
+    case am::AssetLoadState::Cancelled:
+        retryPendingLoadLater(assetId, pending);
+        return nullptr;
+    default:
+        return nullptr;
+    }
+}
+
 template <typename T>
 T* vks::DescriptorManager::getOrLoadResource(std::string lookUpName)
 {
@@ -37,88 +72,8 @@ inline vks::IVulkanDescriptor* vks::DescriptorManager::loadResource(const boost:
     if (assetInfo.has_value())
     {
         auto assetPtr = assetInfo->get()->getAsset();
-        switch (assetPtr->getType())
-        {
-        case am::AssetType::Mesh:
-            {
-                auto mesh = std::make_unique<MeshDescriptor>(assetId, this,
-                                                         *assetPtr->getAssetDataAs<am::MeshData>(), glm::mat4(1),
-                                                        *context);
-                loadedResources[assetId] = std::move(mesh);
-                return loadedResources[assetId].get();
-                break;
-            }
-
-        case am::AssetType::Model:
-            {
-                auto model = std::make_unique<vks::ModelDescriptor>(assetId, this, *assetPtr->getAssetDataAs<am::ModelData>(),
-                                                          *context);
-                loadedResources[assetId] = std::move(model);
-                return loadedResources[assetId].get();
-                break;
-            }
-
-        case am::AssetType::Texture:
-            {
-                auto texture = std::make_unique<TextureDescriptor>(
-                  assetId, this, *assetPtr->getAssetDataAs<am::TextureData>(),*context);
-                loadedResources[assetId] = std::move(texture);
-                return loadedResources[assetId].get();
-                break;
-            }
-
-        case am::AssetType::Material:
-            {
-                auto material = std::make_unique<MaterialDescriptor>(assetId, this,
-                    *assetPtr->getAssetDataAs<am::MaterialData>(),
-                   *context);
-                loadedResources[assetId] = std::move(material);
-                return loadedResources[assetId].get();
-                break;
-            }
-
-        case am::AssetType::Shader:
-            {
-                auto shader = std::make_unique<ShaderDescriptor>(
-                    assetId, *assetPtr->getAssetDataAs<am::ShaderData>(),*context);
-                loadedResources[assetId] = std::move(shader);
-                return loadedResources[assetId].get();
-                break;
-            }
-
-        case am::AssetType::ShaderProgram:
-            {
-                auto shaderProgram = std::make_unique<ShaderProgramDescriptor>(
-                    assetId, *assetPtr->getAssetDataAs<am::ShaderProgramData>(), this, *context);
-                loadedResources[assetId] = std::move(shaderProgram);
-                return loadedResources[assetId].get();
-                break;
-            }
-
-        case am::AssetType::Animation:
-            {
-                // Handle animation asset loading
-                throw std::runtime_error("Animation loading not yet implemented");
-                break;
-            }
-
-        case am::AssetType::Animator:
-            {
-                // Handle animator asset loading
-                throw std::runtime_error("Animator loading not yet implemented");
-                break;
-            }
-
-        case am::AssetType::Other:
-            {
-                // Handle other/generic asset loading
-                throw std::runtime_error("Generic asset loading not yet implemented");
-                break;
-            }
-
-        default:
-            throw std::runtime_error("Asset type not supported");
-        }
+        loadedResources[assetId] = createDescriptor(assetId, *assetPtr);
+        return trackResource(assetId, *assetPtr);
     }
     else
     {
@@ -127,3 +82,74 @@ inline vks::IVulkanDescriptor* vks::DescriptorManager::loadResource(const boost:
 
     return nullptr; // This should never be reached due to exceptions above
 }
+
+inline std::unique_ptr<vks::IVulkanDescriptor> vks::DescriptorManager::createDescriptor(const boost::uuids::uuid& assetId, am::Asset& asset)
+{
+    switch (asset.getType())
+    {
+    case am::AssetType::Mesh:
+        {
+            return std::make_unique<MeshDescriptor>(assetId, this,
+                                                     *asset.getAssetDataAs<am::MeshData>(), glm::mat4(1),
+                                                    *context);
+        }
+
+    case am::AssetType::Model:
+        {
+            return std::make_unique<vks::ModelDescriptor>(assetId, this, *asset.getAssetDataAs<am::ModelData>(),
+                                                      *context);
+        }
+
+    case am::AssetType::Texture:
+        {
+            auto& textureData = *asset.getAssetDataAs<am::TextureData>();
+            auto texture = std::make_unique<TextureDescriptor>(
+              assetId, this, textureData,*context, textureStreamer.getInitialBaseMip(textureData));
+            textureStreamer.registerTexture(texture.get());
+            return texture;
+        }
+
+    case am::AssetType::Material:
+        {
+            return std::make_unique<MaterialDescriptor>(assetId, this,
+                *asset.getAssetDataAs<am::MaterialData>(),
+               *context);
+        }
+
+    case am::AssetType::Shader:
+        {
+            return std::make_unique<ShaderDescriptor>(
+                assetId, *asset.getAssetDataAs<am::ShaderData>(),*context);
+        }
+
+    case am::AssetType::ShaderProgram:
+        {
+            return std::make_unique<ShaderProgramDescriptor>(
+                assetId, *asset.getAssetDataAs<am::ShaderProgramData>(), this, *context);
+        }
+
+    case am::AssetType::Animation:
+        {
+            // Handle animation asset loading
+            throw std::runtime_error("Animation loading not yet implemented");
+            break;
+        }
+
+    case am::AssetType::Animator:
+        {
+            // Handle animator asset loading
+            throw std::runtime_error("Animator loading not yet implemented");
+            break;
+        }
+
+    case am::AssetType::Other:
+        {
+            // Handle other/generic asset loading
+            throw std::runtime_error("Generic asset loading not yet implemented");
+            break;
+        }
+
+    default:
+        throw std::runtime_error("Asset type not supported");
+    }
+}
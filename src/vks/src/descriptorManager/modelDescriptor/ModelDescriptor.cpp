@@ -19,6 +19,10 @@ void vks::ModelDescriptor::loadNode(DescriptorManager* assetHandleManager,NodeDe
                 MeshDescriptor* meshHandle =  assetHandleManager->getOrLoadResource<MeshDescriptor>(node.meshes[i]->id);
                 model.meshes.push_back(meshHandle);
 				newNode->meshes.push_back(meshHandle);
+        	// Meshes shared between models keep the set of whichever loaded them first
+        	if (meshHandle->uniformBuffer.descriptorSet != VK_NULL_HANDLE) {
+        		continue;
+        	}
         	VkDescriptorSetAllocateInfo descriptorSetAllocInfo{};
         	descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         	descriptorSetAllocInfo.descriptorPool = assetHandleManager->meshPool;
@@ -53,5 +57,8 @@ vks::ModelDescriptor::ModelDescriptor(const boost::uuids::uuid& assetId, Descrip
 
 vks::ModelDescriptor::~ModelDescriptor()
 {
-
+    // Meshes are owned by DescriptorManager, only the node tree belongs to the model
+    for (auto node : nodes) {
+        delete node;
+    }
 }
@@ -34,6 +34,13 @@ namespace vks
     matrix(glm::mat4(1.0f))
     {
     }
+
+    inline NodeDescriptorStruct::~NodeDescriptorStruct()
+    {
+        for (auto child : children) {
+            delete child;
+        }
+    }
 }
 
 
@@ -18,6 +18,9 @@ namespace vks
 
         virtual void cleanup(){};
 
+        // Device memory owned by this descriptor alone, counted against DescriptorManager's residency budget
+        virtual VkDeviceSize getMemoryUsage() const { return 0; }
+
         const boost::uuids::uuid& getAssetId() const { return assetId; }
     protected:
         boost::uuids::uuid assetId;
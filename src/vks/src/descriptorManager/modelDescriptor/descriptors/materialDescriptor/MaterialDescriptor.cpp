@@ -4,6 +4,8 @@
 
 #include "MaterialDescriptor.h"
 
+#include <algorithm>
+
 #include "Asset.hpp"
 #include "../../../DescriptorManager.h"
 #
@@ -45,11 +47,7 @@ vks::MaterialDescriptor::MaterialDescriptor(const boost::uuids::uuid& assetId, D
     setUpDescriptorSet(assetHandleManager->pbrMaterialLayout, assetHandleManager->pbrMaterialPool, assetHandleManager->defaultImageInfo, assetHandleManager->cubeImageInfo);
 }
 vks::MaterialDescriptor::~MaterialDescriptor() {
-    delete baseColorTexture;
-    delete metallicRoughnessTexture;
-    delete normalTexture;
-    delete occlusionTexture;
-    delete emissiveTexture;
+    // Textures are owned by DescriptorManager, which releases them along with this material
 }
 
 void vks::MaterialDescriptor::setUpDescriptorSet(VkDescriptorSetLayout materialLayout, VkDescriptorPool materialDescriptorPool, VkDescriptorImageInfo defaultImageInfo, VkDescriptorImageInfo defaultCubeImageInfo) {
@@ -131,4 +129,47 @@ void vks::MaterialDescriptor::setUpDescriptorSet(VkDescriptorSetLayout materialL
         vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()),
                               writeDescriptorSets.data(), 0, nullptr);
     }
-}
\ No newline at end of file
+}
+
+void vks::MaterialDescriptor::updateTextureBindings() {
+    if (descriptorSet == VK_NULL_HANDLE) {
+        return;
+    }
+
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    std::vector<VkWriteDescriptorSet> writeDescriptorSets;
+    imageInfos.reserve(2);
+
+    auto addWrite = [&](TextureDescriptor* texture, uint32_t binding) {
+        if (!texture) {
+            return;
+        }
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.sampler = VK_NULL_HANDLE;
+        imageInfo.imageView = texture->descriptor.imageView;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfos.push_back(imageInfo);
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        write.descriptorCount = 1;
+        write.dstSet = descriptorSet;
+        write.dstBinding = binding;
+        write.pImageInfo = &imageInfos.back();
+        writeDescriptorSets.push_back(write);
+    };
+
+    addWrite(baseColorTexture, 1);
+    addWrite(normalTexture, 2);
+
+    if (!writeDescriptorSets.empty()) {
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()),
+                              writeDescriptorSets.data(), 0, nullptr);
+    }
+}
+
+bool vks::MaterialDescriptor::usesTexture(const TextureDescriptor* texture) const {
+    const auto bound = getBoundTextures();
+    return texture && std::ranges::find(bound, texture) != bound.end();
+}
@@ -4,6 +4,7 @@
 
 #ifndef MATERIAL_H
 #define MATERIAL_H
+#include <array>
 #include <vulkan/vulkan_core.h>
 
 #include "../IVulkanDescriptor.h"
@@ -45,6 +46,11 @@ namespace vks
         ~MaterialDescriptor();
 
         void setUpDescriptorSet(VkDescriptorSetLayout materialLayout, VkDescriptorPool materialDescriptorPool, VkDescriptorImageInfo defaultImageInfo, VkDescriptorImageInfo defaultCubeImageInfo);
+        // Rewrites the image bindings after a streamed texture swapped its view
+        void updateTextureBindings();
+        // Textures the descriptor set binds, in binding order. The others are loaded but no shader samples them yet
+        std::array<TextureDescriptor*, 2> getBoundTextures() const { return {baseColorTexture, normalTexture}; }
+        bool usesTexture(const TextureDescriptor* texture) const;
         void cleanup() override {};
 
     };
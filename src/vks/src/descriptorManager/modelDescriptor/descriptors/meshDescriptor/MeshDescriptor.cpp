@@ -20,8 +20,12 @@ vks::MeshDescriptor::MeshDescriptor(const boost::uuids::uuid& assetId, Descripto
     this->uniformBlock.matrix = matrix;
     this->material = assetHandleManager->getOrLoadResource<vks::MaterialDescriptor>(meshData.material->id);
 
+    // Views may point straight into a mapped binary asset, copied once into staging below
+    const auto meshVertices = meshData.getVertices();
+    const auto meshIndices = meshData.getIndices();
+
     // Create vertex buffer
-    VkDeviceSize vertexBufferSize = sizeof(am::VertexAsset) * meshData.vertices.size();
+    VkDeviceSize vertexBufferSize = sizeof(am::VertexAsset) * meshVertices.size();
     
     // Create staging buffer for vertices
     VkBuffer vertexStagingBuffer;
@@ -38,7 +42,7 @@ vks::MeshDescriptor::MeshDescriptor(const boost::uuids::uuid& assetId, Descripto
     // Copy vertex data to staging buffer
     void* data;
     vkMapMemory(vulkanContext.getDevice(), vertexStagingMemory, 0, vertexBufferSize, 0, &data);
-    memcpy(data, meshData.vertices.data(), vertexBufferSize);
+    memcpy(data, meshVertices.data(), vertexBufferSize);
     vkUnmapMemory(vulkanContext.getDevice(), vertexStagingMemory);
 
     // Create device local vertex buffer
@@ -56,14 +60,14 @@ vks::MeshDescriptor::MeshDescriptor(const boost::uuids::uuid& assetId, Descripto
         vertexBufferSize,
         QueueType::Transfer);
 
-    vertices.count = meshData.vertices.size();
+    vertices.count = meshVertices.size();
 
     // Clean up vertex staging buffer
     vkDestroyBuffer(vulkanContext.getDevice(), vertexStagingBuffer, nullptr);
     vkFreeMemory(vulkanContext.getDevice(), vertexStagingMemory, nullptr);
 
     // Create index buffer
-    VkDeviceSize indexBufferSize = sizeof(uint32_t) * meshData.indices.size();
+    VkDeviceSize indexBufferSize = sizeof(uint32_t) * meshIndices.size();
     
     // Create staging buffer for indices
     VkBuffer indexStagingBuffer;
@@ -78,7 +82,7 @@ vks::MeshDescriptor::MeshDescriptor(const boost::uuids::uuid& assetId, Descripto
 
     // Copy index data to staging buffer
     vkMapMemory(vulkanContext.getDevice(), indexStagingMemory, 0, indexBufferSize, 0, &data);
-    memcpy(data, meshData.indices.data(), indexBufferSize);
+    memcpy(data, meshIndices.data(), indexBufferSize);
     vkUnmapMemory(vulkanContext.getDevice(), indexStagingMemory);
 
     // Create device local index buffer
@@ -96,7 +100,7 @@ vks::MeshDescriptor::MeshDescriptor(const boost::uuids::uuid& assetId, Descripto
         indexBufferSize,
         QueueType::Transfer);
 
-    indices.count = meshData.indices.size();
+    indices.count = meshIndices.size();
 
     // Clean up index staging buffer
     vkDestroyBuffer(vulkanContext.getDevice(), indexStagingBuffer, nullptr);
@@ -139,6 +143,10 @@ vks::MeshDescriptor::~MeshDescriptor() {
     }
 }
 
+VkDeviceSize vks::MeshDescriptor::getMemoryUsage() const {
+    return sizeof(am::VertexAsset) * vertices.count + sizeof(uint32_t) * indices.count + sizeof(UniformBlock);
+}
+
 void vks::MeshDescriptor::setUpDescriptorSet(VkDescriptorSetLayout meshUniformLayout,VkDescriptorPool meshDescriptorPool) {
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
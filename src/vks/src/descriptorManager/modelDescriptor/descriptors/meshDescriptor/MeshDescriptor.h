@@ -44,6 +44,7 @@ namespace vks
         ~MeshDescriptor();
         void setUpDescriptorSet(VkDescriptorSetLayout meshUniformLayout,VkDescriptorPool meshDescriptorPool);
         void cleanup() override {};
+        VkDeviceSize getMemoryUsage() const override;
 
         static VkVertexInputBindingDescription inputBindingDescription(uint32_t binding);
         static VkVertexInputAttributeDescription inputAttributeDescription(
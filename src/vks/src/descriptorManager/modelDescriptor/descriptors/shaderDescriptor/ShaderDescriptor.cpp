@@ -1,22 +1,37 @@
 
 #include "ShaderDescriptor.h"
 #include <cassert>
+#include <boost/uuid/uuid_io.hpp>
+#include <spdlog/spdlog.h>
 #include "../../../../base/VulkanDevice.h"
+#include "../../../buffers/LightModelPushConstant.hpp"
+#include "../../../buffers/ModelPushConstant.hpp"
 namespace vks
 {
     ShaderDescriptor::ShaderDescriptor(const boost::uuids::uuid& assetId, am::ShaderData& shaderData,VulkanContext& vulkanContext)
+        : ShaderDescriptor(assetId, shaderData.getBytecode(), shaderData.stage, vulkanContext) {
+    }
+
+    ShaderDescriptor::ShaderDescriptor(const boost::uuids::uuid& assetId, std::span<const uint32_t> bytecode, am::ShaderStage stage,
+                                       VulkanContext& vulkanContext)
         : IVulkanDescriptor(assetId, vulkanContext) {
 
+        // Reflected once here, pipelines and draws only look at the resulting bits
+        auto reflected = am::reflectSpirv(bytecode);
+        if (!reflected) {
+            throw std::runtime_error("Failed to reflect shader: " + boost::uuids::to_string(assetId));
+        }
+        reflection = std::move(reflected.value());
+        bindings = convertReflection(reflection, stage);
+
         // Create shader module from bytecode
-        shaderModule = createShaderModule(shaderData.bytecode);
+        shaderModule = createShaderModule(bytecode);
         assert(shaderModule != VK_NULL_HANDLE);
 
-        defines = convertDefines(shaderData.defines);
-
         // Setup shader stage info
         shaderStage = {};
         shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        shaderStage.stage = convertShaderStage(shaderData.stage);
+        shaderStage.stage = convertShaderStage(stage);
         shaderStage.module = shaderModule;
         shaderStage.pName = "main";  // Assuming main entry point
     }
@@ -32,7 +47,7 @@ namespace vks
         }
     }
 
-    VkShaderModule ShaderDescriptor::createShaderModule(const std::vector<uint32_t>& code) {
+    VkShaderModule ShaderDescriptor::createShaderModule(std::span<const uint32_t> code) {
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
         createInfo.pNext = nullptr;
@@ -66,31 +81,50 @@ namespace vks
         }
     }
 
-    std::vector<ShaderDefinesEnum> ShaderDescriptor::convertDefines(std::map<std::string, std::string> defines)
+    ShaderBindingMask ShaderDescriptor::convertReflection(const am::ShaderReflection& reflection, am::ShaderStage stage)
     {
-        std::vector<ShaderDefinesEnum> result;
-       for (auto& [key, value] : defines)
-       {
-           if (key == "SCENE_UBO_GLSL") {
-               result.push_back(ShaderDefinesEnum::SCENE_UBO_GLSL);
-           } else if (key == "VERTEX_IO_GLSL")  {
-               result.push_back(ShaderDefinesEnum::VERTEX_IO_GLSL);
-           }else if (key == "LIGHTING_COMMON_GLSL")  {
-               result.push_back(ShaderDefinesEnum::LIGHTING_COMMON_GLSL);
-           }else if (key == "MODEL_PC_GLSL")  {
-               result.push_back(ShaderDefinesEnum::MODEL_PC_GLSL);
-           }else if (key == "LIGHT_MODEL_PC_GLSL")  {
-               result.push_back(ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL);
-           }else if (key == "MATERIAL_PBR_GLSL")  {
-               result.push_back(ShaderDefinesEnum::MATERIAL_PBR_GLSL);
-           }else if (key == "MATERIAL_SKYBOX_GLSL")  {
-               result.push_back(ShaderDefinesEnum::MATERIAL_SKYBOX_GLSL);
-           }else if (key == "WIREMESH_GLSL")  {
-               result.push_back(ShaderDefinesEnum::WIREMESH_GLSL);
-           }else if (key == "ENABLE_MULTVIEW")  {
-               result.push_back(ShaderDefinesEnum::ENABLE_MULTVIEW);
-           }
-       }
+        ShaderBindingMask result = 0;
+        for (const auto& binding : reflection.bindings) {
+            switch (binding.set) {
+            case kSceneSet:
+                result |= SCENE_SET_BIT;
+                break;
+            case kMaterialSet:
+                result |= binding.dimension == am::ShaderImageDimension::Cube ? MATERIAL_SKYBOX_SET_BIT : MATERIAL_PBR_SET_BIT;
+                break;
+            case kMeshSet:
+                result |= MESH_SET_BIT;
+                break;
+            case kLightsSet:
+                result |= LIGHTS_SET_BIT;
+                break;
+            default:
+                spdlog::warn("Shader binds {} to set {}, which no layout is made for", binding.name, binding.set);
+                break;
+            }
+        }
+        // A skybox material samples a cube map, anything else on set 1 is the PBR material
+        if (result & MATERIAL_SKYBOX_SET_BIT) {
+            result &= ~MATERIAL_PBR_SET_BIT;
+        }
+
+        // The block name says which push constant it is, the size covers SPIR-V stripped of names
+        if (const auto& push = reflection.pushConstants) {
+            if (push->name == "LightModelPushConstant" || (push->name.empty() && push->size == sizeof(LightModelPushConstant))) {
+                result |= LIGHT_MODEL_PUSH_CONSTANT_BIT;
+            } else if (push->name == "ModelPushConstant" || (push->name.empty() && push->size == sizeof(ModelPushConstant))) {
+                result |= MODEL_PUSH_CONSTANT_BIT;
+            } else {
+                spdlog::warn("Shader has an unknown push constant block {} of {} bytes", push->name, push->size);
+            }
+        }
+
+        if (stage == am::ShaderStage::Vertex && reflection.inputLocations != 0) {
+            result |= VERTEX_INPUT_BIT;
+        }
+        if (reflection.multiview) {
+            result |= MULTIVIEW_BIT;
+        }
         return result;
     }
 }
\ No newline at end of file
@@ -3,29 +3,36 @@
 #define SHADERHANDLE_H
 #include "../IVulkanDescriptor.h"
 #include "assetDatas/ShaderData.h"
+#include <span>
 #include <vulkan/vulkan.h>
 
-#include "ShaderDefinesEnum.hpp"
+#include "ShaderBindings.hpp"
+#include "SpirvReflection.hpp"
 
 namespace vks
 {
     class ShaderDescriptor : public vks::IVulkanDescriptor {
     public:
         ShaderDescriptor(const boost::uuids::uuid& assetId, am::ShaderData& shaderData, VulkanContext& vulkanContext);
+        // For SPIR-V that isn't an asset of its own, like a shader program's permutation variants
+        ShaderDescriptor(const boost::uuids::uuid& assetId, std::span<const uint32_t> bytecode, am::ShaderStage stage,
+                         VulkanContext& vulkanContext);
         ~ShaderDescriptor();
 
         VkPipelineShaderStageCreateInfo getShaderStage() const { return shaderStage; }
         void cleanup() override;
 
-        const std::vector<ShaderDefinesEnum> getDefines() const { return defines; }
+        const am::ShaderReflection& getReflection() const { return reflection; }
+        ShaderBindingMask getBindings() const { return bindings; }
     private:
 
-        VkShaderModule createShaderModule(const std::vector<uint32_t>& code);
+        VkShaderModule createShaderModule(std::span<const uint32_t> code);
         VkShaderModule shaderModule{VK_NULL_HANDLE};
         VkPipelineShaderStageCreateInfo shaderStage{};
-        std::vector<ShaderDefinesEnum> defines;
+        am::ShaderReflection reflection;
+        ShaderBindingMask bindings = 0;
         static VkShaderStageFlagBits convertShaderStage(am::ShaderStage stage);
-        static std::vector<ShaderDefinesEnum> convertDefines(std::map<std::string, std::string> defines);
+        static ShaderBindingMask convertReflection(const am::ShaderReflection& reflection, am::ShaderStage stage);
     };
 }
 #endif //SHADERHANDLE_H
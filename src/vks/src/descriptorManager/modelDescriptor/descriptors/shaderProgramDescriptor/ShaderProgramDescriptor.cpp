@@ -1,6 +1,6 @@
 #include "../shaderProgramDescriptor/ShaderProgramDescriptor.h"
-#include <algorithm>
 #include "../../../DescriptorManager.h"
+#include <algorithm>
 
 namespace vks {
 
@@ -12,8 +12,7 @@ namespace vks {
                 auto shaderDesc = descriptorManager->getOrLoadResource<ShaderDescriptor>(stageInfo->id);
                 if (shaderDesc) {
                     shaderStages.push_back(shaderDesc->getShaderStage());
-                    auto stageDefines = shaderDesc->getDefines();
-                    defines.insert(defines.end(), stageDefines.begin(), stageDefines.end());
+                    bindings |= shaderDesc->getBindings();
                 }
             }
         };
@@ -25,10 +24,52 @@ namespace vks {
         processStage(programData.tessellationControlShader);
         processStage(programData.tessellationEvaluationShader);
 
-        // Deduplicate defines
-        std::ranges::sort(defines);
-        auto [first, last] = std::ranges::unique(defines);
-        defines.erase(first, last);
+        variantModules.resize(programData.modules.size());
+        for (const am::ShaderProgramVariant& programVariant : programData.variants) {
+            if (programVariant.mask == 0) {
+                continue;
+            }
+            Variant& variant = variants.emplace_back();
+            variant.mask = programVariant.mask;
+            for (size_t stage = 0; stage < am::kShaderStageCount; ++stage) {
+                const uint32_t module = programVariant.modules[stage];
+                if (module == am::kNoShaderModule) {
+                    continue;
+                }
+                // Variants that compiled a stage to the same SPIR-V share its module
+                auto& shaderDesc = variantModules[module];
+                if (!shaderDesc) {
+                    shaderDesc = std::make_unique<ShaderDescriptor>(
+                        assetId, programData.getVariantBytecode(programVariant.mask, static_cast<am::ShaderStage>(stage)),
+                        static_cast<am::ShaderStage>(stage), vulkanContext);
+                }
+                variant.shaderStages.push_back(shaderDesc->getShaderStage());
+                variant.bindings |= shaderDesc->getBindings();
+            }
+        }
+    }
+
+    const ShaderProgramDescriptor::Variant* ShaderProgramDescriptor::findVariant(uint32_t permutationMask) const {
+        const auto it = std::ranges::lower_bound(variants, permutationMask, {}, &Variant::mask);
+        return it != variants.end() && it->mask == permutationMask ? &*it : nullptr;
+    }
+
+    std::vector<uint32_t> ShaderProgramDescriptor::getPermutationMasks() const {
+        std::vector<uint32_t> masks{0};
+        for (const Variant& variant : variants) {
+            masks.push_back(variant.mask);
+        }
+        return masks;
+    }
+
+    const std::vector<VkPipelineShaderStageCreateInfo>& ShaderProgramDescriptor::getShaderStages(uint32_t permutationMask) const {
+        const Variant* variant = findVariant(permutationMask);
+        return variant ? variant->shaderStages : shaderStages;
+    }
+
+    ShaderBindingMask ShaderProgramDescriptor::getBindings(uint32_t permutationMask) const {
+        const Variant* variant = findVariant(permutationMask);
+        return variant ? variant->bindings : bindings;
     }
 
     ShaderProgramDescriptor::~ShaderProgramDescriptor() {
@@ -36,9 +77,11 @@ namespace vks {
     }
 
     void ShaderProgramDescriptor::cleanup() {
-        // Individual ShaderDescriptors are managed by DescriptorManager
+        // Individual ShaderDescriptors are managed by DescriptorManager, only the variants' modules are owned here
         shaderStages.clear();
-        defines.clear();
+        bindings = 0;
+        variants.clear();
+        variantModules.clear();
     }
 
 } // namespace vks
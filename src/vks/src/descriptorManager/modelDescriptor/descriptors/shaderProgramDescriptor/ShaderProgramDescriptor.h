@@ -18,11 +18,30 @@ namespace vks {
         void cleanup() override;
 
         const std::vector<VkPipelineShaderStageCreateInfo>& getShaderStages() const { return shaderStages; }
-        const std::vector<ShaderDefinesEnum>& getDefines() const { return defines; }
+        ShaderBindingMask getBindings() const { return bindings; }
+        bool hasBindings(ShaderBindingMask bits) const { return (bindings & bits) != 0; }
+
+        // Every mask a pipeline is made for, 0 first
+        std::vector<uint32_t> getPermutationMasks() const;
+        // A permutation mask the program wasn't compiled for gets the program's own stages, same as mask 0
+        const std::vector<VkPipelineShaderStageCreateInfo>& getShaderStages(uint32_t permutationMask) const;
+        ShaderBindingMask getBindings(uint32_t permutationMask) const;
 
     private:
+        struct Variant {
+            uint32_t mask = 0;
+            std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+            ShaderBindingMask bindings = 0;
+        };
+
+        const Variant* findVariant(uint32_t permutationMask) const;
+
         std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
-        std::vector<ShaderDefinesEnum> defines;
+        ShaderBindingMask bindings = 0;
+        // Sorted by mask, without mask 0 since that's the program's own stages
+        std::vector<Variant> variants;
+        // Modules of the variants, indexed like ShaderProgramData::modules and made only for the ones a variant uses
+        std::vector<std::unique_ptr<ShaderDescriptor>> variantModules;
     };
 }
 
@@ -3,6 +3,7 @@
 //
 
 #include "TextureDescriptor.h"
+#include <algorithm>
 #include <spdlog/spdlog.h>
 #include "../../../DescriptorManager.h"
 
@@ -20,15 +21,67 @@ void vks::TextureDescriptor::destroy() {
 	}
 }
 
-vks::TextureDescriptor::TextureDescriptor(const boost::uuids::uuid& assetId, DescriptorManager* assetHandleManager, am::TextureData& textureData,VulkanContext& vulkanContext)
-    : IVulkanDescriptor(assetId, vulkanContext) {
+vks::TextureDescriptor::TextureDescriptor(const boost::uuids::uuid& assetId, DescriptorManager* assetHandleManager, am::TextureData& textureData,VulkanContext& vulkanContext, uint32_t baseMip)
+    : IVulkanDescriptor(assetId, vulkanContext), context(&vulkanContext) {
     this->width = textureData.width;
     this->height = textureData.height;
     this->channels = textureData.channels;
     this->hasAlpha = textureData.hasAlpha;
+    this->type = textureData.type;
 
     // Set format based on channels
-    VkFormat format = (channels == 4) ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8_UNORM;
+    format = (channels == 4) ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8_UNORM;
+
+    // The chain is generated offline by the asset manager, cube atlases only carry level 0
+    totalMipLevels = type == am::TextureType::TextureCube ? 1 : textureData.mipLevels();
+
+    createImage(textureData, baseMip);
+
+    if (textureData.type == am::TextureType::Texture2D)
+    {
+        descriptor.sampler = assetHandleManager->defaultSampler;
+    }else
+    {
+        descriptor.sampler = assetHandleManager->cubeSampler;
+    }
+    // Update descriptor
+    imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    descriptor.imageView = view;
+    descriptor.imageLayout = imageLayout;
+}
+
+void vks::TextureDescriptor::setResidentBaseMip(const am::TextureData& textureData, uint32_t baseMip) {
+    if (type == am::TextureType::TextureCube) {
+        return;
+    }
+    baseMip = std::min(baseMip, totalMipLevels - 1);
+    if (baseMip == baseMipLevel) {
+        return;
+    }
+
+    // The upload waits for the device to go idle, so the old image is no longer referenced afterwards
+    VkImage oldImage = image;
+    VkImageView oldView = view;
+    VkDeviceMemory oldMemory = deviceMemory;
+
+    createImage(textureData, baseMip);
+    descriptor.imageView = view;
+
+    vkDestroyImageView(device, oldView, nullptr);
+    vkDestroyImage(device, oldImage, nullptr);
+    vkFreeMemory(device, oldMemory, nullptr);
+}
+
+VkDeviceSize vks::TextureDescriptor::getMipChainSize(const am::TextureData& textureData, uint32_t baseMip) {
+    if (textureData.mips.empty() || textureData.type == am::TextureType::TextureCube) {
+        return static_cast<VkDeviceSize>(textureData.getPixels().size()) * sizeof(std::uint32_t);
+    }
+    baseMip = std::min(baseMip, static_cast<uint32_t>(textureData.mips.size()) - 1);
+    return static_cast<VkDeviceSize>(textureData.getPixels().size() - textureData.mips[baseMip].offset) * sizeof(std::uint32_t);
+}
+
+void vks::TextureDescriptor::createImage(const am::TextureData& textureData, uint32_t baseMip) {
+    VulkanContext& vulkanContext = *context;
 
     uint32_t imageWidth = width;
     uint32_t imageHeight = height;
@@ -44,21 +97,34 @@ vks::TextureDescriptor::TextureDescriptor(const boost::uuids::uuid& assetId, Des
         }
     }
 
-    mipLevels = static_cast<uint32_t>(floor(log2(std::max(imageWidth, imageHeight))) + 1.0);
+    // Levels [baseMip, totalMipLevels) are resident, finer ones stay on the CPU until streamed in
+    std::vector<am::TextureMipLevel> levels;
+    if (textureData.mips.empty() || textureData.type == am::TextureType::TextureCube) {
+        levels.push_back({width, height, 0});
+        baseMip = 0;
+    } else {
+        baseMip = std::min(baseMip, totalMipLevels - 1);
+        levels.assign(textureData.mips.begin() + baseMip, textureData.mips.end());
+        imageWidth = levels[0].width;
+        imageHeight = levels[0].height;
+    }
+    baseMipLevel = baseMip;
+    mipLevels = static_cast<uint32_t>(levels.size());
 
     // Verify format support
     VkFormatProperties formatProperties;
     vkGetPhysicalDeviceFormatProperties(vulkanContext.getPhysicalDevice(), format, &formatProperties);
-    assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT);
-    assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
+    assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
 
     // Create staging buffer
     VkBuffer stagingBuffer;
     VkDeviceMemory stagingMemory;
+    VkDeviceSize stagingSize = getMipChainSize(textureData, baseMip);
+    const std::uint32_t* stagingSource = textureData.getPixels().data() + levels[0].offset;
 
     // Create staging buffer using VulkanContext utility
     vulkanContext.createBuffer(
-        textureData.pixels.size(),
+        stagingSize,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         stagingBuffer,
@@ -66,8 +132,8 @@ vks::TextureDescriptor::TextureDescriptor(const boost::uuids::uuid& assetId, Des
 
     // Copy data to staging buffer
     void* data;
-    vkMapMemory(vulkanContext.getDevice(), stagingMemory, 0, textureData.pixels.size(), 0, &data);
-    memcpy(data, textureData.pixels.data(), textureData.pixels.size());
+    vkMapMemory(vulkanContext.getDevice(), stagingMemory, 0, stagingSize, 0, &data);
+    memcpy(data, stagingSource, stagingSize);
     vkUnmapMemory(vulkanContext.getDevice(), stagingMemory);
 
     // Create the image
@@ -85,7 +151,7 @@ vks::TextureDescriptor::TextureDescriptor(const boost::uuids::uuid& assetId, Des
     }
     imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
     imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
@@ -104,8 +170,8 @@ vks::TextureDescriptor::TextureDescriptor(const boost::uuids::uuid& assetId, Des
     VK_CHECK_RESULT(vkAllocateMemory(vulkanContext.getDevice(), &memAllocInfo, nullptr, &deviceMemory));
     VK_CHECK_RESULT(vkBindImageMemory(vulkanContext.getDevice(), image, deviceMemory, 0));
 
-    // Transition image layout and copy data
-    VkCommandBuffer cmdBuffer = vulkanContext.beginSingleTimeCommands(QueueType::Graphics);
+    // Upload every level with a single copy on the transfer queue
+    VkCommandBuffer cmdBuffer = vulkanContext.beginSingleTimeCommands(QueueType::Transfer);
 
     // Transition to transfer destination layout
     VkImageMemoryBarrier barrier{};
@@ -134,8 +200,8 @@ vks::TextureDescriptor::TextureDescriptor(const boost::uuids::uuid& assetId, Des
         1, &barrier);
 
     // Copy buffer to image
+    std::vector<VkBufferImageCopy> copyRegions;
     if (textureData.type == am::TextureType::TextureCube && width != height) {
-        std::vector<VkBufferImageCopy> copyRegions;
         // Standard 4x3 layout:
         //     [+Y]
         // [-X][+Z][+X][-Z]
@@ -165,38 +231,70 @@ vks::TextureDescriptor::TextureDescriptor(const boost::uuids::uuid& assetId, Des
             region.imageExtent = {imageWidth, imageHeight, 1};
             copyRegions.push_back(region);
         }
-
-        vkCmdCopyBufferToImage(cmdBuffer, stagingBuffer, image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
     } else {
-        VkBufferImageCopy copyRegion{};
-        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copyRegion.imageSubresource.mipLevel = 0;
-        copyRegion.imageSubresource.baseArrayLayer = 0;
-        if (textureData.type == am::TextureType::TextureCube) {
-            copyRegion.imageSubresource.layerCount = 6;
-        } else {
-            copyRegion.imageSubresource.layerCount = 1;
+        for (uint32_t level = 0; level < mipLevels; level++) {
+            VkBufferImageCopy region{};
+            region.bufferOffset = (levels[level].offset - levels[0].offset) * sizeof(std::uint32_t);
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = level;
+            region.imageSubresource.baseArrayLayer = 0;
+            if (textureData.type == am::TextureType::TextureCube) {
+                region.imageSubresource.layerCount = 6;
+            } else {
+                region.imageSubresource.layerCount = 1;
+            }
+            region.imageExtent = {levels[level].width, levels[level].height, 1};
+            copyRegions.push_back(region);
         }
-        copyRegion.imageExtent = {imageWidth, imageHeight, 1};
-
-        vkCmdCopyBufferToImage(cmdBuffer, stagingBuffer, image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
     }
 
-    // Transition to shader read layout
+    vkCmdCopyBufferToImage(cmdBuffer, stagingBuffer, image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+
+    // Transition to shader read layout, handing the image over to graphics if the families differ
+    QueueFamilyIndices queueFamilies = vulkanContext.getQueueFamilyIndices();
+    bool ownershipTransfer = queueFamilies.transfer != queueFamilies.graphics;
+
     barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
     barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    if (ownershipTransfer) {
+        barrier.srcQueueFamilyIndex = queueFamilies.transfer;
+        barrier.dstQueueFamilyIndex = queueFamilies.graphics;
+        barrier.dstAccessMask = 0;
+
+        vkCmdPipelineBarrier(cmdBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+    } else {
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-    vkCmdPipelineBarrier(cmdBuffer,
-        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier);
+        vkCmdPipelineBarrier(cmdBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+    }
+
+    vulkanContext.endSingleTimeCommands(cmdBuffer, QueueType::Transfer);
 
-    vulkanContext.endSingleTimeCommands(cmdBuffer, QueueType::Graphics);
+    if (ownershipTransfer) {
+        // Matching acquire on the graphics queue
+        VkCommandBuffer acquireBuffer = vulkanContext.beginSingleTimeCommands(QueueType::Graphics);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier(acquireBuffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+
+        vulkanContext.endSingleTimeCommands(acquireBuffer, QueueType::Graphics);
+    }
 
     // Clean up staging resources
     vkDestroyBuffer(vulkanContext.getDevice(), stagingBuffer, nullptr);
@@ -224,14 +322,5 @@ vks::TextureDescriptor::TextureDescriptor(const boost::uuids::uuid& assetId, Des
 
     VK_CHECK_RESULT(vkCreateImageView(vulkanContext.getDevice(), &viewInfo, nullptr, &view));
 
-    if (textureData.type == am::TextureType::Texture2D)
-    {
-        descriptor.sampler = assetHandleManager->defaultSampler;
-    }else
-    {
-        descriptor.sampler = assetHandleManager->cubeSampler;
-    }
-    // Update descriptor
-    descriptor.imageView = view;
-    descriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    residentBytes = memReqs.size;
 }
@@ -27,11 +27,28 @@ namespace vks
         uint32_t mipLevels;
         VkDescriptorImageInfo descriptor;
 
+        // Streaming state, the image holds levels [baseMipLevel, totalMipLevels) of the asset's chain
+        VkFormat format{VK_FORMAT_R8G8B8A8_UNORM};
+        am::TextureType type{am::TextureType::Texture2D};
+        uint32_t baseMipLevel{0};
+        uint32_t totalMipLevels{1};
+        VkDeviceSize residentBytes{0};
+
         void updateDescriptor();
 
+        // Recreates the image with a different finest resident level, descriptor sets using the old view must be rewritten
+        void setResidentBaseMip(const am::TextureData& textureData, uint32_t baseMip);
+        static VkDeviceSize getMipChainSize(const am::TextureData& textureData, uint32_t baseMip);
+
         void destroy();
         void cleanup() override {};
-        TextureDescriptor(const boost::uuids::uuid& assetId, DescriptorManager* assetHandleManager, am::TextureData& textureData,VulkanContext& vulkanContext);
+        VkDeviceSize getMemoryUsage() const override { return residentBytes; }
+        TextureDescriptor(const boost::uuids::uuid& assetId, DescriptorManager* assetHandleManager, am::TextureData& textureData,VulkanContext& vulkanContext, uint32_t baseMip = 0);
+
+    private:
+        VulkanContext* context;
+
+        void createImage(const am::TextureData& textureData, uint32_t baseMip);
     };
 }
 
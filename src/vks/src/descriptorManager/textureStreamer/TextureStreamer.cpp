@@ -0,0 +1,275 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "TextureStreamer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "../DescriptorManager.h"
+
+namespace vks
+{
+    TextureStreamer::TextureStreamer(DescriptorManager* descriptorManager) : descriptorManager(descriptorManager)
+    {
+    }
+
+    uint32_t TextureStreamer::getInitialBaseMip(const am::TextureData& textureData) const
+    {
+        if (textureData.type == am::TextureType::TextureCube || textureData.mips.size() <= 1)
+            return 0;
+
+        for (uint32_t level = 0; level < textureData.mips.size(); ++level)
+        {
+            const auto& mip = textureData.mips[level];
+            if (std::max(mip.width, mip.height) <= settings.initialMaxDimension)
+                return level;
+        }
+        return static_cast<uint32_t>(textureData.mips.size()) - 1;
+    }
+
+    void TextureStreamer::registerTexture(TextureDescriptor* texture)
+    {
+        if (!texture || texture->type == am::TextureType::TextureCube)
+            return;
+
+        Residency residency{};
+        residency.texture = texture;
+        residency.initialBaseMip = texture->baseMipLevel;
+        residency.requestedBaseMip = UINT32_MAX;
+        residency.targetBaseMip = texture->baseMipLevel;
+        residency.lastRequestedFrame = frameIndex;
+
+        residencies[texture->getAssetId()] = residency;
+        residentBytes += texture->residentBytes;
+    }
+
+    void TextureStreamer::unregisterTexture(const boost::uuids::uuid& textureId)
+    {
+        auto it = residencies.find(textureId);
+        if (it == residencies.end())
+            return;
+
+        residentBytes -= it->second.texture->residentBytes;
+        residencies.erase(it);
+    }
+
+    void TextureStreamer::requestBaseMip(TextureDescriptor* texture, uint32_t baseMip)
+    {
+        if (!texture)
+            return;
+
+        auto it = residencies.find(texture->getAssetId());
+        if (it == residencies.end())
+            return;
+
+        auto& residency = it->second;
+        residency.requestedBaseMip = std::min(residency.requestedBaseMip, baseMip);
+        residency.lastRequestedFrame = frameIndex;
+    }
+
+    void TextureStreamer::requestModel(ModelDescriptor* model, const glm::mat4& transform, const glm::vec3& boundsMin,
+                                       const glm::vec3& boundsMax, const glm::mat4& projection, const glm::vec3& cameraPos,
+                                       float viewportHeight)
+    {
+        if (!model)
+            return;
+
+        const float projectedSize = computeProjectedSize(transform, boundsMin, boundsMax, projection, cameraPos, viewportHeight);
+
+        for (auto* mesh : model->meshes)
+        {
+            if (!mesh || !mesh->material)
+                continue;
+
+            // Only what the material binds, streaming in a texture no shader samples would just take memory
+            for (auto* texture : mesh->material->getBoundTextures())
+            {
+                if (!texture)
+                    continue;
+
+                requestBaseMip(texture, computeDesiredBaseMip(texture->width, texture->height, texture->totalMipLevels,
+                                                              projectedSize, settings.mipBias));
+            }
+        }
+    }
+
+    float TextureStreamer::computeProjectedSize(const glm::mat4& transform, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                                                const glm::mat4& projection, const glm::vec3& cameraPos, float viewportHeight)
+    {
+        const glm::vec3 halfExtent = (boundsMax - boundsMin) * 0.5f;
+        const float maxScale = std::max({glm::length(glm::vec3(transform[0])),
+                                         glm::length(glm::vec3(transform[1])),
+                                         glm::length(glm::vec3(transform[2]))});
+        const float radius = glm::length(halfExtent) * maxScale;
+
+        // Bounds were never filled in, don't starve the texture
+        if (radius <= 1e-5f)
+            return std::numeric_limits<float>::max();
+
+        const glm::vec3 center = glm::vec3(transform * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+        const float distance = glm::length(center - cameraPos) - radius;
+        if (distance <= 1e-3f)
+            return std::numeric_limits<float>::max();
+
+        // projection[1][1] is 1 / tan(fov / 2), the sign flip for Vulkan clip space doesn't matter here
+        return radius * std::abs(projection[1][1]) * viewportHeight / distance;
+    }
+
+    uint32_t TextureStreamer::computeDesiredBaseMip(uint32_t width, uint32_t height, uint32_t mipCount, float projectedSize, float mipBias)
+    {
+        if (mipCount <= 1)
+            return 0;
+
+        // Assume the texture is mapped once across the object, one texel per pixel is enough
+        const float largest = static_cast<float>(std::max(width, height));
+        if (projectedSize >= largest)
+            return 0;
+
+        const float level = std::log2(largest / std::max(projectedSize, 1.0f)) + mipBias;
+        if (level <= 0.0f)
+            return 0;
+        return std::min(static_cast<uint32_t>(level), mipCount - 1);
+    }
+
+    void TextureStreamer::update()
+    {
+        streamedInLastFrame = 0;
+        evictedLastFrame = 0;
+
+        std::vector<Residency*> streamIns;
+        for (auto& [id, residency] : residencies)
+        {
+            if (residency.lastRequestedFrame == frameIndex && residency.requestedBaseMip != UINT32_MAX)
+                residency.targetBaseMip = residency.requestedBaseMip;
+            residency.requestedBaseMip = UINT32_MAX;
+
+            if (residency.targetBaseMip < residency.texture->baseMipLevel)
+                streamIns.push_back(&residency);
+        }
+
+        // Biggest quality gain first
+        std::sort(streamIns.begin(), streamIns.end(), [](const Residency* a, const Residency* b) {
+            return a->texture->baseMipLevel - a->targetBaseMip > b->texture->baseMipLevel - b->targetBaseMip;
+        });
+
+        for (auto* residency : streamIns)
+        {
+            if (streamedInLastFrame >= settings.maxStreamInsPerFrame)
+                break;
+
+            auto* textureData = descriptorManager->assetManager->getAssetData<am::TextureData>(residency->texture->getAssetId());
+            if (!textureData)
+                continue;
+
+            // Walk towards the target until the chain fits the budget
+            uint32_t baseMip = residency->targetBaseMip;
+            for (; baseMip < residency->texture->baseMipLevel; ++baseMip)
+            {
+                VkDeviceSize required = TextureDescriptor::getMipChainSize(*textureData, baseMip);
+                VkDeviceSize extra = required > residency->texture->residentBytes ? required - residency->texture->residentBytes : 0;
+                if (residentBytes + extra > settings.budgetBytes)
+                    evictUntilFits(extra, residency);
+                if (residentBytes + extra <= settings.budgetBytes)
+                    break;
+            }
+
+            if (baseMip < residency->texture->baseMipLevel && applyBaseMip(*residency, baseMip))
+                streamedInLastFrame++;
+        }
+
+        // Budget may have been lowered at runtime
+        if (residentBytes > settings.budgetBytes)
+            evictUntilFits(0, nullptr);
+
+        frameIndex++;
+    }
+
+    uint32_t TextureStreamer::getEvictionFloor(const Residency& residency) const
+    {
+        // Textures drawn last frame only give up levels finer than they need
+        if (residency.lastRequestedFrame == frameIndex)
+            return residency.targetBaseMip;
+        return std::max(residency.targetBaseMip, residency.initialBaseMip);
+    }
+
+    void TextureStreamer::evictUntilFits(VkDeviceSize requiredBytes, const Residency* keep)
+    {
+        std::vector<Residency*> candidates;
+        for (auto& [id, residency] : residencies)
+        {
+            if (&residency == keep)
+                continue;
+            if (residency.texture->baseMipLevel < getEvictionFloor(residency))
+                candidates.push_back(&residency);
+        }
+
+        // Least recently needed first
+        std::sort(candidates.begin(), candidates.end(), [](const Residency* a, const Residency* b) {
+            return a->lastRequestedFrame < b->lastRequestedFrame;
+        });
+
+        for (auto* residency : candidates)
+        {
+            if (residentBytes + requiredBytes <= settings.budgetBytes)
+                break;
+            if (applyBaseMip(*residency, getEvictionFloor(*residency)))
+                evictedLastFrame++;
+        }
+    }
+
+    bool TextureStreamer::applyBaseMip(Residency& residency, uint32_t baseMip)
+    {
+        auto* texture = residency.texture;
+        auto* textureData = descriptorManager->assetManager->getAssetData<am::TextureData>(texture->getAssetId());
+        if (!textureData)
+        {
+            spdlog::error("Texture data missing while streaming {}", boost::uuids::to_string(texture->getAssetId()));
+            return false;
+        }
+
+        VkDeviceSize previousBytes = texture->residentBytes;
+        texture->setResidentBaseMip(*textureData, baseMip);
+        residentBytes = residentBytes - previousBytes + texture->residentBytes;
+
+        // Materials hold the old view in their descriptor sets
+        for (auto& [id, resource] : descriptorManager->loadedResources)
+        {
+            auto* material = dynamic_cast<MaterialDescriptor*>(resource.get());
+            if (material && material->usesTexture(texture))
+                material->updateTextureBindings();
+        }
+        return true;
+    }
+
+    gfx::TextureStreamingStats TextureStreamer::getStats() const
+    {
+        gfx::TextureStreamingStats stats;
+        stats.budgetBytes = settings.budgetBytes;
+        stats.residentBytes = residentBytes;
+        stats.streamedInLastFrame = streamedInLastFrame;
+        stats.evictedLastFrame = evictedLastFrame;
+        stats.textures.reserve(residencies.size());
+
+        for (const auto& [id, residency] : residencies)
+        {
+            const auto* texture = residency.texture;
+            stats.textures.push_back({
+                id,
+                texture->width,
+                texture->height,
+                texture->totalMipLevels,
+                texture->baseMipLevel,
+                residency.targetBaseMip,
+                texture->residentBytes,
+                frameIndex - residency.lastRequestedFrame
+            });
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,85 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#ifndef REASONABLEVULKAN_TEXTURESTREAMER_HPP
+#define REASONABLEVULKAN_TEXTURESTREAMER_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <boost/uuid/uuid.hpp>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include "TextureStreamingData.hpp"
+#include "assetDatas/TextureData.h"
+
+namespace vks
+{
+    class DescriptorManager;
+    class ModelDescriptor;
+    struct TextureDescriptor;
+
+    // Keeps only the mip levels that are actually needed in VRAM. Textures start with their
+    // coarse levels, draws request finer levels based on projected screen size and the
+    // least recently needed levels are dropped when the budget is exceeded.
+    class TextureStreamer
+    {
+    public:
+        struct Settings
+        {
+            VkDeviceSize budgetBytes = 2048ull * 1024 * 1024;
+            uint32_t initialMaxDimension = 64;  // Largest resident level a texture starts with
+            uint32_t maxStreamInsPerFrame = 2;  // Every stream in stalls on an upload, keep it bounded
+            float mipBias = 0.0f;               // Positive values stream coarser levels
+        };
+
+        explicit TextureStreamer(DescriptorManager* descriptorManager);
+
+        Settings settings;
+
+        uint32_t getInitialBaseMip(const am::TextureData& textureData) const;
+        void registerTexture(TextureDescriptor* texture);
+        void unregisterTexture(const boost::uuids::uuid& textureId);
+
+        // Requests are gathered while recording a frame and applied on the next update
+        void requestBaseMip(TextureDescriptor* texture, uint32_t baseMip);
+        void requestModel(ModelDescriptor* model, const glm::mat4& transform, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                          const glm::mat4& projection, const glm::vec3& cameraPos, float viewportHeight);
+
+        // Streams in requested levels and evicts under budget, call between frames
+        void update();
+
+        gfx::TextureStreamingStats getStats() const;
+        VkDeviceSize getResidentBytes() const { return residentBytes; }
+
+        // Approximate on screen size in pixels of the bounds' bounding sphere
+        static float computeProjectedSize(const glm::mat4& transform, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                                          const glm::mat4& projection, const glm::vec3& cameraPos, float viewportHeight);
+        static uint32_t computeDesiredBaseMip(uint32_t width, uint32_t height, uint32_t mipCount, float projectedSize, float mipBias);
+
+    private:
+        struct Residency
+        {
+            TextureDescriptor* texture;
+            uint32_t initialBaseMip;
+            uint32_t requestedBaseMip;   // Finest level asked for during the current frame
+            uint32_t targetBaseMip;      // Request of the last frame that drew the texture
+            uint64_t lastRequestedFrame;
+        };
+
+        DescriptorManager* descriptorManager;
+        std::unordered_map<boost::uuids::uuid, Residency> residencies;
+
+        uint64_t frameIndex = 0;
+        VkDeviceSize residentBytes = 0;
+        uint32_t streamedInLastFrame = 0;
+        uint32_t evictedLastFrame = 0;
+
+        bool applyBaseMip(Residency& residency, uint32_t baseMip);
+        void evictUntilFits(VkDeviceSize requiredBytes, const Residency* keep);
+        uint32_t getEvictionFloor(const Residency& residency) const;
+    };
+}
+
+#endif //REASONABLEVULKAN_TEXTURESTREAMER_HPP
@@ -0,0 +1,152 @@
+//
+// Created by redkc on 19/10/2026.
+//
+
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace gfx
+{
+    namespace
+    {
+        // Constant initialized, so they work for allocations made before any dynamic initializer ran
+        std::atomic<uint64_t> heapAllocationCount{0};
+        std::atomic<bool> heapAllocationsTracked{false};
+    }
+
+    void countHeapAllocation() noexcept
+    {
+        if (!heapAllocationsTracked.load(std::memory_order_relaxed)) {
+            heapAllocationsTracked.store(true, std::memory_order_relaxed);
+        }
+        heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool isHeapAllocationCountTracked() noexcept
+    {
+        return heapAllocationsTracked.load(std::memory_order_relaxed);
+    }
+
+    uint64_t getHeapAllocationCount() noexcept
+    {
+        return heapAllocationCount.load(std::memory_order_relaxed);
+    }
+
+    LinearArena::LinearArena(size_t blockSize, std::pmr::memory_resource* upstream)
+        : upstream(upstream), blockSize(std::max<size_t>(blockSize, 256))
+    {
+    }
+
+    LinearArena::~LinearArena()
+    {
+        releaseBlocks();
+    }
+
+    size_t LinearArena::capacityBytes() const
+    {
+        size_t capacity = 0;
+        for (const Block& block : blocks) {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    void LinearArena::reset()
+    {
+        allocationsSinceReset = 0;
+        // Last frame spilled over, next frames get all of it in one piece
+        if (blocks.size() > 1) {
+            const size_t capacity = capacityBytes();
+            releaseBlocks();
+            addBlock(capacity);
+        }
+        current = 0;
+        offset = 0;
+        used = 0;
+    }
+
+    void* LinearArena::do_allocate(size_t bytes, size_t alignment)
+    {
+        for (;;) {
+            while (current < blocks.size()) {
+                const Block& block = blocks[current];
+                const auto base = reinterpret_cast<uintptr_t>(block.data);
+                const size_t aligned = ((base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+                if (aligned + bytes <= block.size) {
+                    offset = aligned + bytes;
+                    used += bytes;
+                    return block.data + aligned;
+                }
+                // The rest of this block is wasted until the next reset
+                ++current;
+                offset = 0;
+            }
+            addBlock(bytes + alignment);
+        }
+    }
+
+    void LinearArena::addBlock(size_t minimumSize)
+    {
+        // Growing by the whole capacity keeps the number of blocks logarithmic in what a frame needs
+        const size_t size = std::max({blockSize, minimumSize, capacityBytes()});
+        blocks.push_back({static_cast<std::byte*>(upstream->allocate(size, alignof(std::max_align_t))), size});
+        ++allocationsSinceReset;
+    }
+
+    void LinearArena::releaseBlocks()
+    {
+        for (const Block& block : blocks) {
+            upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+        }
+        blocks.clear();
+    }
+
+    FrameArena::FrameArena(size_t framesInFlight, size_t blockSize) : frameStartHeapAllocations(getHeapAllocationCount())
+    {
+        arenas.resize(std::max<size_t>(framesInFlight, 1));
+        for (auto& arena : arenas) {
+            arena = std::make_unique<LinearArena>(blockSize);
+        }
+    }
+
+    void FrameArena::beginFrame(size_t frameIndex)
+    {
+        assert(frameIndex < arenas.size());
+        const LinearArena& finished = *arenas[currentFrame];
+        peakUsed = std::max(peakUsed, finished.usedBytes());
+        lastFrameBlockAllocations = finished.blockAllocations();
+        totalBlockAllocations += finished.blockAllocations();
+        const uint64_t heapCount = getHeapAllocationCount();
+        lastFrameHeapAllocations = heapCount - frameStartHeapAllocations;
+        frameStartHeapAllocations = heapCount;
+
+        currentFrame = frameIndex;
+        arenas[currentFrame]->reset();
+    }
+
+    FrameArenaStats FrameArena::getStats() const
+    {
+        const LinearArena& arena = *arenas[currentFrame];
+        FrameArenaStats stats;
+        stats.usedBytes = arena.usedBytes();
+        stats.peakUsedBytes = std::max(peakUsed, arena.usedBytes());
+        for (const auto& slot : arenas) {
+            stats.capacityBytes += slot->capacityBytes();
+        }
+        stats.blockAllocations = arena.blockAllocations();
+        stats.lastFrameBlockAllocations = lastFrameBlockAllocations;
+        stats.totalBlockAllocations = totalBlockAllocations + arena.blockAllocations();
+        stats.heapAllocationsTracked = isHeapAllocationCountTracked();
+        stats.heapAllocations = getHeapAllocationCount() - frameStartHeapAllocations;
+        stats.lastFrameHeapAllocations = lastFrameHeapAllocations;
+        return stats;
+    }
+
+    void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+    {
+        return arenas[currentFrame]->allocate(bytes, alignment);
+    }
+}
@@ -37,9 +37,32 @@ void RenderManager::initialize(boost::uuids::uuid pbrShaderId, boost::uuids::uui
     this->cubeShadowShaderId = cubeShadowShaderId;
     createCommandBuffers();
     createSyncObjects();
+    descriptorManager->residencySettings.framesInFlight = MAX_FRAMES_IN_FLIGHT;
     
-    // Load a default box model for skybox rendering
-    descriptorManager->getOrLoadResource<ModelDescriptor>("boxModel");
+    // Load a default box model for skybox rendering, it also stands in for models that are still loading
+    placeholderModel = descriptorManager->getOrLoadResource<ModelDescriptor>("boxModel");
+    if (placeholderModel) {
+        descriptorManager->acquireResource(placeholderModel->getAssetId());
+    }
+    if (placeholderModel && !placeholderModel->meshes.empty()) {
+        auto boxMesh = descriptorManager->assetManager->getAsset(placeholderModel->meshes[0]->getAssetId());
+        if (boxMesh.has_value() && boxMesh.value()) {
+            auto meshData = boxMesh.value()->getAssetDataAs<am::MeshData>();
+            placeholderBoundsMin = meshData->boundingBoxMin;
+            placeholderBoundsMax = meshData->boundingBoxMax;
+        }
+    }
+}
+
+glm::mat4 RenderManager::placeholderTransform(const RenderCommand& command) const
+{
+    const glm::vec3 boxExtent = glm::max(placeholderBoundsMax - placeholderBoundsMin, glm::vec3(1e-4f));
+    const glm::vec3 scale = (command.boundsMax - command.boundsMin) / boxExtent;
+    const glm::vec3 boxCenter = (placeholderBoundsMin + placeholderBoundsMax) * 0.5f;
+    const glm::vec3 center = (command.boundsMin + command.boundsMax) * 0.5f;
+
+    return command.transform * glm::translate(glm::mat4(1.0f), center) * glm::scale(glm::mat4(1.0f), scale)
+        * glm::translate(glm::mat4(1.0f), -boxCenter);
 }
 
 #ifdef ENABLE_IMGUI
@@ -72,13 +95,13 @@ void RenderManager::createSyncObjects() {
 }
 
 
-    void vks::RenderManager::renderNode(vks::NodeDescriptorStruct* mainNode, VkCommandBuffer commandBuffer, const glm::mat4 matrix, boost::uuids::uuid renderProgramId)
+    void vks::RenderManager::renderNode(vks::NodeDescriptorStruct* mainNode, VkCommandBuffer commandBuffer, const glm::mat4 matrix, boost::uuids::uuid renderProgramId,
+                                        uint32_t permutationMask)
 {
     auto shaderProgramDescriptor = descriptorManager->getOrLoadResource<ShaderProgramDescriptor>(renderProgramId);
     if (!shaderProgramDescriptor) return;
-    const auto& defines = shaderProgramDescriptor->getDefines();
-
-   bool hasModelPushConstants = std::find(defines.begin(), defines.end(), ShaderDefinesEnum::MODEL_PC_GLSL) != defines.end();
+    const ShaderBindingMask bindings = shaderProgramDescriptor->getBindings(permutationMask);
+    const bool hasModelPushConstants = (bindings & MODEL_PUSH_CONSTANT_BIT) != 0;
 
     for (const auto& node : mainNode->children) {
         glm::mat4 nodeWorldTransform = matrix * node->matrix;
@@ -88,7 +111,7 @@ void RenderManager::createSyncObjects() {
             push_m.model = nodeWorldTransform;
             vkCmdPushConstants(
                 commandBuffer,
-                pipelineManager->getPipelineLayout(renderProgramId),
+                pipelineManager->getPipelineLayout(renderProgramId, permutationMask),
                 VK_SHADER_STAGE_VERTEX_BIT,
                 0,
                 sizeof(ModelPushConstant),
@@ -97,10 +120,10 @@ void RenderManager::createSyncObjects() {
         }
 
         for (const auto& mesh : node->meshes) {
-            bindMeshDescriptors(commandBuffer, renderProgramId, mesh, defines);
+            bindMeshDescriptors(commandBuffer, renderProgramId, mesh, bindings, permutationMask);
             vkCmdDrawIndexed(commandBuffer, mesh->indices.count, 1, 0, 0, 0);
         }
-        renderNode(node, commandBuffer, matrix, renderProgramId);
+        renderNode(node, commandBuffer, matrix, renderProgramId, permutationMask);
     }
 }
 
@@ -108,9 +131,8 @@ void vks::RenderManager::renderLightNode(vks::NodeDescriptorStruct* mainNode, Vk
 {
     auto shaderProgramDescriptor = descriptorManager->getOrLoadResource<ShaderProgramDescriptor>(renderProgramId);
     if (!shaderProgramDescriptor) return;
-    const auto& defines = shaderProgramDescriptor->getDefines();
-
-    bool hasLightModelPushConstants = std::find(defines.begin(), defines.end(), ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL) != defines.end();
+    const ShaderBindingMask bindings = shaderProgramDescriptor->getBindings();
+    const bool hasLightModelPushConstants = (bindings & LIGHT_MODEL_PUSH_CONSTANT_BIT) != 0;
 
     for (const auto& node : mainNode->children) {
         glm::mat4 nodeWorldTransform = matrix * node->matrix;
@@ -132,7 +154,7 @@ void vks::RenderManager::renderLightNode(vks::NodeDescriptorStruct* mainNode, Vk
         }
 
         for (const auto& mesh : node->meshes) {
-            bindMeshDescriptors(commandBuffer, renderProgramId, mesh, defines);
+            bindMeshDescriptors(commandBuffer, renderProgramId, mesh, bindings);
             vkCmdDrawIndexed(commandBuffer, mesh->indices.count, 1, 0, 0, 0);
         }
         renderLightNode(node, commandBuffer, matrix, renderProgramId, lightIndex, lightType);
@@ -151,9 +173,10 @@ void RenderManager::cleanup() {
     vkDestroyCommandPool(context->getDevice(), context->getGraphicsCommandPool(), nullptr);
 }
 
-void RenderManager::submitRenderCommand(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid renderProgramId, glm::mat4 transform)
+void RenderManager::submitRenderCommand(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid renderProgramId, uint32_t permutationMask,
+                                        glm::mat4 transform, glm::vec3 boundsMin, glm::vec3 boundsMax)
 {
-    renderQueue.push_back(RenderCommand{cameraIndex, modelId, renderProgramId, transform});
+    renderQueue.push_back(RenderCommand{cameraIndex, modelId, renderProgramId, permutationMask, transform, boundsMin, boundsMax});
 }
 
 void RenderManager::submitSkyboxRenderCommand(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid renderProgramId)
@@ -232,6 +255,16 @@ void RenderManager::createCommandBuffers() {
 void RenderManager::beginFrame() {
     vkWaitForFences(context->getDevice(), 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
 
+    // The fence covers this slot's previous use, so its transient memory can be handed out again. The queues let go
+    // of last frame's storage first, they're empty by now
+    gfx::releaseFrameStorage(renderQueue);
+    gfx::releaseFrameStorage(skyboxRenderQueue);
+    gfx::releaseFrameStorage(directionalLightQueue);
+    gfx::releaseFrameStorage(pointLightQueue);
+    gfx::releaseFrameStorage(spotLightQueue);
+    frameArena.beginFrame(currentFrame);
+    renderQueue.reserve(lastRenderQueueSize);
+
     VkResult result = swapChain->acquireNextImage(imageAvailableSemaphores[currentFrame]);
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
         return; 
@@ -251,6 +284,10 @@ void RenderManager::beginFrame() {
     imagesInFlight[currentImageIndex] = inFlightFences[currentFrame];
 
     vkResetFences(context->getDevice(), 1, &inFlightFences[currentFrame]);
+
+    // Apply last frame's mip requests before anything references the texture views
+    descriptorManager->textureStreamer.update();
+    descriptorManager->updateResidency();
 }
 
 void RenderManager::renderFrame() {
@@ -359,10 +396,12 @@ void RenderManager::endFrame() {
 
                     auto shadowShaderDescriptor = descriptorManager->getOrLoadResource<ShaderProgramDescriptor>(shadowShaderId);
                     if (shadowShaderDescriptor) {
-                        bindPipelineDescriptors(commandBuffer, shadowShaderId, 0, shadowShaderDescriptor->getDefines());
+                        bindPipelineDescriptors(commandBuffer, shadowShaderId, 0, shadowShaderDescriptor->getBindings());
                     }
 
                     for (auto& command : renderQueue) {
+                        // Models still loading cast no shadow, the main pass requests them
+                        if (!descriptorManager->isResourceLoaded(command.modelId)) continue;
                         auto modelDescriptor = descriptorManager->getOrLoadResource<ModelDescriptor>(command.modelId);
                         if (modelDescriptor) {
                             renderLightNode(modelDescriptor->nodes[0], commandBuffer, command.transform, shadowShaderId, light.shadowMapIndex, 0);
@@ -417,10 +456,12 @@ void RenderManager::endFrame() {
 
                     auto cubeShadowShaderDescriptor = descriptorManager->getOrLoadResource<ShaderProgramDescriptor>(cubeShadowShaderId);
                     if (cubeShadowShaderDescriptor) {
-                        bindPipelineDescriptors(commandBuffer, cubeShadowShaderId, 0, cubeShadowShaderDescriptor->getDefines());
+                        bindPipelineDescriptors(commandBuffer, cubeShadowShaderId, 0, cubeShadowShaderDescriptor->getBindings());
                     }
 
                     for (auto& command : renderQueue) {
+                        // Models still loading cast no shadow, the main pass requests them
+                        if (!descriptorManager->isResourceLoaded(command.modelId)) continue;
                         auto modelDescriptor = descriptorManager->getOrLoadResource<ModelDescriptor>(command.modelId);
                         if (modelDescriptor) {
                             renderLightNode(modelDescriptor->nodes[0], commandBuffer, command.transform, cubeShadowShaderId, light.shadowMapIndex, 1);
@@ -468,10 +509,12 @@ void RenderManager::endFrame() {
 
                     auto spotShadowShaderDescriptor = descriptorManager->getOrLoadResource<ShaderProgramDescriptor>(shadowShaderId);
                     if (spotShadowShaderDescriptor) {
-                        bindPipelineDescriptors(commandBuffer, shadowShaderId, 0, spotShadowShaderDescriptor->getDefines());
+                        bindPipelineDescriptors(commandBuffer, shadowShaderId, 0, spotShadowShaderDescriptor->getBindings());
                     }
 
                     for (auto& command : renderQueue) {
+                        // Models still loading cast no shadow, the main pass requests them
+                        if (!descriptorManager->isResourceLoaded(command.modelId)) continue;
                         auto modelDescriptor = descriptorManager->getOrLoadResource<ModelDescriptor>(command.modelId);
                         if (modelDescriptor) {
                             renderLightNode(modelDescriptor->nodes[0], commandBuffer, command.transform, shadowShaderId, light.shadowMapIndex, 2);
@@ -484,7 +527,7 @@ void RenderManager::endFrame() {
         }
 
         // Add memory barrier for UBOs before using them
-        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        std::pmr::vector<VkBufferMemoryBarrier> bufferBarriers(&frameArena);
         for (auto& sceneUBO : descriptorManager->sceneUBOs) {
             VkBufferMemoryBarrier bufferBarrier{};
             bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
@@ -514,10 +557,11 @@ void RenderManager::endFrame() {
         pointLightQueue.clear();
         spotLightQueue.clear();
 
-        // Sort render queue by renderProgramId to minimize pipeline switching (optional, could be per camera)
+        // Sort render queue by renderProgramId and variant to minimize pipeline switching (optional, could be per camera)
         std::sort(renderQueue.begin(), renderQueue.end(), [](const RenderCommand& a, const RenderCommand& b) {
             if (a.cameraIndex != b.cameraIndex) return a.cameraIndex < b.cameraIndex;
-            return a.renderProgramId < b.renderProgramId;
+            if (a.renderProgramId != b.renderProgramId) return a.renderProgramId < b.renderProgramId;
+            return a.permutationMask < b.permutationMask;
         });
 
         // Loop through all active cameras
@@ -581,8 +625,7 @@ void RenderManager::endFrame() {
 
                              auto shaderProgramDescriptor = descriptorManager->getOrLoadResource<ShaderProgramDescriptor>(cmd.renderProgramId);
                              if (shaderProgramDescriptor) {
-                                 const auto& defines = shaderProgramDescriptor->getDefines();
-                                 if (std::find(defines.begin(), defines.end(), ShaderDefinesEnum::MATERIAL_SKYBOX_GLSL) != defines.end()) {
+                                 if (shaderProgramDescriptor->hasBindings(MATERIAL_SKYBOX_SET_BIT)) {
                                      vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                                         pipelineManager->getPipelineLayout(cmd.renderProgramId), 1, 1, &materialDescriptor->descriptorSet, 0, nullptr);
                                  }
@@ -612,30 +655,45 @@ void RenderManager::endFrame() {
 
             // Process model render queue for this camera
             boost::uuids::uuid lastProgramId = boost::uuids::nil_uuid();
+            uint32_t lastPermutationMask = 0;
             for (auto& cmd : renderQueue) {
                 if (cmd.cameraIndex != i) continue;
 
-                auto modelDescriptor = descriptorManager->getOrLoadResource<ModelDescriptor>(cmd.modelId);
-                if (!modelDescriptor) continue;
+                auto modelDescriptor = descriptorManager->getResourceIfReady<ModelDescriptor>(cmd.modelId, am::LoadPriority::High);
+                glm::mat4 transform = cmd.transform;
+                if (modelDescriptor) {
+                    const auto& sceneBlock = descriptorManager->sceneUBOs[i].uniformBlock;
+                    descriptorManager->textureStreamer.requestModel(modelDescriptor, cmd.transform, cmd.boundsMin, cmd.boundsMax,
+                        sceneBlock.projection, sceneBlock.cameraPos, static_cast<float>(swapChain->getSwapChainExtent().height));
+                } else {
+                    if (!placeholderModel) continue;
+                    modelDescriptor = placeholderModel;
+                    transform = placeholderTransform(cmd);
+                }
 
-                if (cmd.renderProgramId != lastProgramId) {
-                    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineManager->getPipeline(cmd.renderProgramId));
+                if (cmd.renderProgramId != lastProgramId || cmd.permutationMask != lastPermutationMask) {
+                    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                      pipelineManager->getPipeline(cmd.renderProgramId, cmd.permutationMask));
 
+                    // Each variant has its own layout, so the sets are bound again even within one program
                     auto shaderProgramDescriptor = descriptorManager->getOrLoadResource<ShaderProgramDescriptor>(cmd.renderProgramId);
                     if (shaderProgramDescriptor) {
-                        bindPipelineDescriptors(commandBuffer, cmd.renderProgramId, i, shaderProgramDescriptor->getDefines());
+                        bindPipelineDescriptors(commandBuffer, cmd.renderProgramId, i, shaderProgramDescriptor->getBindings(cmd.permutationMask),
+                                                cmd.permutationMask);
                     }
 
                     lastProgramId = cmd.renderProgramId;
+                    lastPermutationMask = cmd.permutationMask;
                 }
 
-                renderNode(modelDescriptor->nodes[0], commandBuffer, cmd.transform, cmd.renderProgramId);
+                renderNode(modelDescriptor->nodes[0], commandBuffer, transform, cmd.renderProgramId, cmd.permutationMask);
             }
 
             vkCmdEndRenderPass(commandBuffer);
         }
 
         skyboxRenderQueue.clear();
+        lastRenderQueueSize = renderQueue.size();
         renderQueue.clear();
 
 #ifdef ENABLE_IMGUI
@@ -688,27 +746,31 @@ void RenderManager::waitIdle() {
     vkDeviceWaitIdle(context->getDevice());
 }
 
-void RenderManager::bindPipelineDescriptors(VkCommandBuffer commandBuffer, boost::uuids::uuid renderProgramId, uint32_t imageIndex, const std::vector<ShaderDefinesEnum>& defines) {
-    bool hasSceneUBO = std::find(defines.begin(), defines.end(), ShaderDefinesEnum::SCENE_UBO_GLSL) != defines.end();
-    bool hasLighting = std::find(defines.begin(), defines.end(), ShaderDefinesEnum::LIGHTING_COMMON_GLSL) != defines.end() ||
-                       std::find(defines.begin(), defines.end(), ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL) != defines.end();
+void RenderManager::refreshResources(const std::vector<boost::uuids::uuid>& assetIds)
+{
+    if (placeholderModel && std::ranges::find(assetIds, placeholderModel->getAssetId()) != assetIds.end()) {
+        placeholderModel = descriptorManager->getOrLoadResource<ModelDescriptor>(placeholderModel->getAssetId());
+    }
+}
 
-    if (hasSceneUBO) {
+void RenderManager::bindPipelineDescriptors(VkCommandBuffer commandBuffer, boost::uuids::uuid renderProgramId, uint32_t imageIndex, ShaderBindingMask bindings,
+                                            uint32_t permutationMask) {
+    if (bindings & SCENE_SET_BIT) {
         vkCmdBindDescriptorSets(
               commandBuffer,
               VK_PIPELINE_BIND_POINT_GRAPHICS,
-              pipelineManager->getPipelineLayout(renderProgramId),
+              pipelineManager->getPipelineLayout(renderProgramId, permutationMask),
               0,                                    // First set index (Set 0)
               1,                                    // Number of sets
               &descriptorManager->sceneUBOs[imageIndex].buffer.descriptorSet,
               0, nullptr);
     }
 
-    if (hasLighting) {
+    if (bindings & LIGHTS_SET_BIT) {
         vkCmdBindDescriptorSets(
               commandBuffer,
               VK_PIPELINE_BIND_POINT_GRAPHICS,
-              pipelineManager->getPipelineLayout(renderProgramId),
+              pipelineManager->getPipelineLayout(renderProgramId, permutationMask),
               3,                                    // Set index 3
               1,                                    // Number of sets
               &descriptorManager->lightInfoUBO.buffer.descriptorSet,
@@ -716,27 +778,25 @@ void RenderManager::bindPipelineDescriptors(VkCommandBuffer commandBuffer, boost
     }
 }
 
-void RenderManager::bindMeshDescriptors(VkCommandBuffer commandBuffer, boost::uuids::uuid renderProgramId, MeshDescriptor* mesh, const std::vector<ShaderDefinesEnum>& defines) {
-    bool hasMeshUBO = std::find(defines.begin(), defines.end(), ShaderDefinesEnum::VERTEX_IO_GLSL) != defines.end();
-    bool hasMaterial = std::find(defines.begin(), defines.end(), ShaderDefinesEnum::MATERIAL_PBR_GLSL) != defines.end();
-
+void RenderManager::bindMeshDescriptors(VkCommandBuffer commandBuffer, boost::uuids::uuid renderProgramId, MeshDescriptor* mesh, ShaderBindingMask bindings,
+                                        uint32_t permutationMask) {
     VkBuffer vertexBuffers[] = { mesh->vertices.buffer.buffer };
     VkDeviceSize offsets[] = { 0 };
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
     vkCmdBindIndexBuffer(commandBuffer, mesh->indices.buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
 
     // Bind mesh descriptor set at set index 2
-    if (hasMeshUBO && mesh->uniformBuffer.descriptorSet != VK_NULL_HANDLE) {
+    if ((bindings & MESH_SET_BIT) && mesh->uniformBuffer.descriptorSet != VK_NULL_HANDLE) {
         vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-            pipelineManager->getPipelineLayout(renderProgramId), 2, 1, &mesh->uniformBuffer.descriptorSet, 0, nullptr);
+            pipelineManager->getPipelineLayout(renderProgramId, permutationMask), 2, 1, &mesh->uniformBuffer.descriptorSet, 0, nullptr);
     }
 
     // Bind material descriptor set at set index 1
-    if (hasMaterial) {
+    if (bindings & MATERIAL_PBR_SET_BIT) {
         auto materialDescriptorSet = mesh->material->descriptorSet;
         if (materialDescriptorSet != VK_NULL_HANDLE) {
             vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                pipelineManager->getPipelineLayout(renderProgramId), 1, 1, &materialDescriptorSet, 0, nullptr);
+                pipelineManager->getPipelineLayout(renderProgramId, permutationMask), 1, 1, &materialDescriptorSet, 0, nullptr);
         }
     }
 }
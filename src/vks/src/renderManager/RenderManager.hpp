@@ -2,6 +2,7 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 
+#include "FrameArena.hpp"
 #include "LightData.hpp"
 #include "../vulkanContext/VulkanContext.hpp"
 #include "../swapChainManager/SwapChainManager.hpp"
@@ -16,6 +17,7 @@ namespace vks {
     class ImguiManager;
 #endif
     class MeshDescriptor;
+    class ModelDescriptor;
     struct NodeDescriptorStruct;
 
 
@@ -24,7 +26,11 @@ namespace vks {
         uint32_t cameraIndex;
         boost::uuids::uuid modelId;
         boost::uuids::uuid renderProgramId;
+        // Selects the program's variant, 0 is the program as written
+        uint32_t permutationMask;
         glm::mat4 transform;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
     };
 
     struct SkyboxRenderCommand
@@ -66,7 +72,8 @@ private:
         void cleanup();
 
         // Core rendering functions
-        void submitRenderCommand(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid renderProgramId, glm::mat4 transform);
+        void submitRenderCommand(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid renderProgramId, uint32_t permutationMask, glm::mat4 transform,
+                                 glm::vec3 boundsMin, glm::vec3 boundsMax);
         void submitSkyboxRenderCommand(uint32_t cameraIndex, boost::uuids::uuid modelId, boost::uuids::uuid renderProgramId);
         void submitLightCommand(gfx::DirectionalLightData data, glm::mat4 transform); // Prob will pack transform later on for optimization but for now IDK enough
         void submitLightCommand(gfx::PointLightData data, glm::mat4 transform);
@@ -76,8 +83,11 @@ private:
         void renderFrame();
         void endFrame();
         void waitIdle();
+        // Drops pointers into descriptors that were rebuilt
+        void refreshResources(const std::vector<boost::uuids::uuid>& assetIds);
 
         size_t getCurrentFrame() const { return currentFrame; }
+        gfx::FrameArenaStats getFrameArenaStats() const { return frameArena.getStats(); }
         void setActiveCameraCount(uint32_t count) { activeCameraCount = count; }
 
 
@@ -93,8 +103,10 @@ private:
         void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
 
     private:
-        void bindPipelineDescriptors(VkCommandBuffer commandBuffer, boost::uuids::uuid renderProgramId, uint32_t imageIndex, const std::vector<ShaderDefinesEnum>& defines);
-        void bindMeshDescriptors(VkCommandBuffer commandBuffer, boost::uuids::uuid renderProgramId, MeshDescriptor* mesh, const std::vector<ShaderDefinesEnum>& defines);
+        void bindPipelineDescriptors(VkCommandBuffer commandBuffer, boost::uuids::uuid renderProgramId, uint32_t imageIndex, ShaderBindingMask bindings,
+                                     uint32_t permutationMask = 0);
+        void bindMeshDescriptors(VkCommandBuffer commandBuffer, boost::uuids::uuid renderProgramId, MeshDescriptor* mesh, ShaderBindingMask bindings,
+                                 uint32_t permutationMask = 0);
 
         boost::uuids::uuid pbrShaderId;
         boost::uuids::uuid skyboxShaderId;
@@ -102,11 +114,15 @@ private:
         boost::uuids::uuid cubeShadowShaderId;
 
     private:
-        std::vector<RenderCommand> renderQueue;
-        std::vector<SkyboxRenderCommand> skyboxRenderQueue;
-        std::vector<DirectionalLightBufferData> directionalLightQueue;
-        std::vector<PointLightBufferData> pointLightQueue;
-        std::vector<SpotLightBufferData> spotLightQueue;
+        // Transient per-frame data, everything below is allocated from it and dropped in bulk at beginFrame
+        gfx::FrameArena frameArena{MAX_FRAMES_IN_FLIGHT};
+        std::pmr::vector<RenderCommand> renderQueue{&frameArena};
+        std::pmr::vector<SkyboxRenderCommand> skyboxRenderQueue{&frameArena};
+        std::pmr::vector<DirectionalLightBufferData> directionalLightQueue{&frameArena};
+        std::pmr::vector<PointLightBufferData> pointLightQueue{&frameArena};
+        std::pmr::vector<SpotLightBufferData> spotLightQueue{&frameArena};
+        // Sizes the queues reached last frame, reserved up front so they don't grow through the arena
+        size_t lastRenderQueueSize = 0;
 
         // Core Vulkan components
         VulkanContext* context;
@@ -116,6 +132,11 @@ private:
 
         uint32_t activeCameraCount = 1;
 
+        // Drawn stretched over the bounds of models that are still loading
+        ModelDescriptor* placeholderModel = nullptr;
+        glm::vec3 placeholderBoundsMin{-1.0f};
+        glm::vec3 placeholderBoundsMax{1.0f};
+
 #ifdef ENABLE_IMGUI
         ImguiManager* imguiManager = nullptr;
 #endif
@@ -127,7 +148,9 @@ private:
         void createSyncObjects();
 
         //Render helper functions
-        void renderNode(vks::NodeDescriptorStruct* mainNode, VkCommandBuffer commandBuffer, const glm::mat4 matrix, boost::uuids::uuid renderProgramId);
+        void renderNode(vks::NodeDescriptorStruct* mainNode, VkCommandBuffer commandBuffer, const glm::mat4 matrix, boost::uuids::uuid renderProgramId,
+                        uint32_t permutationMask);
+        glm::mat4 placeholderTransform(const RenderCommand& command) const;
         void renderLightNode(vks::NodeDescriptorStruct* mainNode, VkCommandBuffer commandBuffer, const glm::mat4 matrix, boost::uuids::uuid renderProgramId, int lightIndex, int lightType);
     };
 
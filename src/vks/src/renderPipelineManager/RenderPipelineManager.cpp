@@ -11,6 +11,24 @@
 
 namespace vks
 {
+    namespace
+    {
+        // Both push constants start at 0, a program declares one of them at most
+        std::vector<VkPushConstantRange> getPushConstantRanges(ShaderBindingMask bindings)
+        {
+            std::vector<VkPushConstantRange> pushConstantRanges;
+            if (bindings & MODEL_PUSH_CONSTANT_BIT) {
+                // Vertex shader transform matrix
+                pushConstantRanges.push_back({VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ModelPushConstant)});
+            }
+            if (bindings & LIGHT_MODEL_PUSH_CONSTANT_BIT) {
+                // Light shadow model push constant
+                pushConstantRanges.push_back({VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(LightModelPushConstant)});
+            }
+            return pushConstantRanges;
+        }
+    }
+
     RenderPipelineManager::RenderPipelineManager(VulkanContext* context, SwapChainManager* swapChain, DescriptorManager* descriptorManager)
         : context(context), swapChain(swapChain), descriptorManager(descriptorManager)
     {
@@ -21,25 +39,35 @@ namespace vks
         cleanup();
     }
 
-    const RenderPipelineManager::Pipeline* RenderPipelineManager::findPipeline(const boost::uuids::uuid& pipelineId) const
+    const RenderPipelineManager::Pipeline* RenderPipelineManager::findPipeline(const boost::uuids::uuid& pipelineId,
+                                                                               uint32_t permutationMask) const
     {
-        auto it = std::find_if(pipelines.begin(), pipelines.end(),
-                              [&pipelineId](const Pipeline& p) { return p.id == pipelineId; });
+        auto it = std::find_if(pipelines.begin(), pipelines.end(), [&pipelineId, permutationMask](const Pipeline& p) {
+            return p.id == pipelineId && p.permutationMask == permutationMask;
+        });
+        if (it == pipelines.end() && permutationMask != 0) {
+            const Pipeline* fallback = findPipeline(pipelineId, 0);
+            if (fallback && reportedMissingVariants.emplace(pipelineId, permutationMask).second) {
+                spdlog::error("Shader program {} has no variant {:#x}, drawing it without permutations",
+                              boost::uuids::to_string(pipelineId), permutationMask);
+            }
+            return fallback;
+        }
         return (it != pipelines.end()) ? &(*it) : nullptr;
     }
 
-    VkPipeline RenderPipelineManager::getPipeline(const boost::uuids::uuid& pipelineId) const
+    VkPipeline RenderPipelineManager::getPipeline(const boost::uuids::uuid& pipelineId, uint32_t permutationMask) const
     {
-        const Pipeline* pipeline = findPipeline(pipelineId);
+        const Pipeline* pipeline = findPipeline(pipelineId, permutationMask);
         if (!pipeline) {
             throw std::runtime_error("Pipeline not found: " + boost::uuids::to_string(pipelineId));
         }
         return pipeline->handle;
     }
 
-    VkPipelineLayout RenderPipelineManager::getPipelineLayout(const boost::uuids::uuid& pipelineId) const
+    VkPipelineLayout RenderPipelineManager::getPipelineLayout(const boost::uuids::uuid& pipelineId, uint32_t permutationMask) const
     {
-        const Pipeline* pipeline = findPipeline(pipelineId);
+        const Pipeline* pipeline = findPipeline(pipelineId, permutationMask);
         if (!pipeline) {
             throw std::runtime_error("Pipeline layout not found: " + boost::uuids::to_string(pipelineId));
         }
@@ -730,53 +758,24 @@ namespace vks
     }
 
     void RenderPipelineManager::createShadowPipeline(ShaderProgramDescriptor* shaderProgramDescriptor)
+    {
+        for (const uint32_t permutationMask : shaderProgramDescriptor->getPermutationMasks())
+        {
+            createShadowPipeline(shaderProgramDescriptor, permutationMask);
+        }
+    }
+
+    void RenderPipelineManager::createShadowPipeline(ShaderProgramDescriptor* shaderProgramDescriptor, uint32_t permutationMask)
     {
         boost::uuids::uuid pipelineId = shaderProgramDescriptor->getAssetId();
         createPipelineCache();
 
-        if (findPipeline(pipelineId)) {
+        if (std::ranges::any_of(pipelines, [&](const Pipeline& p) { return p.id == pipelineId && p.permutationMask == permutationMask; })) {
             throw std::runtime_error("Pipeline already exists: " + boost::uuids::to_string(pipelineId));
         }
 
-        const auto& combinedDefines = shaderProgramDescriptor->getDefines();
-
-        // Get layouts for each define - ensuring they are at the correct set index
-        // We know the set indices: 0: Scene, 1: Material, 2: Mesh, 3: Lights
-        std::vector<VkDescriptorSetLayout> combinedLayouts;
-
-        // Find max define index to determine layout count
-        int maxSet = 0;
-        for (auto def : combinedDefines) {
-            if (def == ShaderDefinesEnum::SCENE_UBO_GLSL) maxSet = std::max(maxSet, 0);
-            else if (def == ShaderDefinesEnum::MATERIAL_PBR_GLSL) maxSet = std::max(maxSet, 1);
-            else if (def == ShaderDefinesEnum::MATERIAL_SKYBOX_GLSL) maxSet = std::max(maxSet, 1);
-            else if (def == ShaderDefinesEnum::VERTEX_IO_GLSL) maxSet = std::max(maxSet, 2);
-            else if (def == ShaderDefinesEnum::LIGHTING_COMMON_GLSL) maxSet = std::max(maxSet, 3);
-            else if (def == ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL) maxSet = std::max(maxSet, 3);
-        }
-
-        combinedLayouts.resize(maxSet + 1, VK_NULL_HANDLE);
-
-        // Fill them based on define
-        for (auto def : combinedDefines) {
-            switch (def) {
-            case ShaderDefinesEnum::SCENE_UBO_GLSL: combinedLayouts[0] = descriptorManager->getSceneLayout(); break;
-            case ShaderDefinesEnum::MATERIAL_PBR_GLSL: combinedLayouts[1] = descriptorManager->getPbrMaterialLayout(); break;
-            case ShaderDefinesEnum::MATERIAL_SKYBOX_GLSL: combinedLayouts[1] = descriptorManager->getSkyboxMaterialLayout(); break;
-            case ShaderDefinesEnum::VERTEX_IO_GLSL: combinedLayouts[2] = descriptorManager->getMeshUniformLayout(); break;
-            case ShaderDefinesEnum::LIGHTING_COMMON_GLSL: combinedLayouts[3] = descriptorManager->getLightsLayout(); break;
-            case ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL: combinedLayouts[3] = descriptorManager->getLightsLayout(); break;
-            }
-        }
-
-        // Check for any null layouts in the sequence (up to maxSet)
-        // If a shader uses Set N, it must have valid layouts for 0..N-1
-        for (int i = 0; i <= maxSet; ++i) {
-            if (combinedLayouts[i] == VK_NULL_HANDLE) {
-                // Use scene layout as a placeholder for missing sets
-                combinedLayouts[i] = descriptorManager->getSceneLayout();
-            }
-        }
+        const ShaderBindingMask bindings = shaderProgramDescriptor->getBindings(permutationMask);
+        const std::vector<VkDescriptorSetLayout> combinedLayouts = descriptorManager->getLayoutsFromBindings(bindings);
 
         VkPipelineLayout shadowPipelineLayout = VK_NULL_HANDLE;
         VkPipelineLayoutCreateInfo shadowPipelineLayoutInfo{};
@@ -784,26 +783,7 @@ namespace vks
         shadowPipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(combinedLayouts.size());
         shadowPipelineLayoutInfo.pSetLayouts = combinedLayouts.data();
 
-        std::vector<VkPushConstantRange> pushConstantRanges;
-        
-        if (std::find(combinedDefines.begin(), combinedDefines.end(), ShaderDefinesEnum::MODEL_PC_GLSL) != combinedDefines.end())
-        {
-            VkPushConstantRange modelPCRange{};
-            modelPCRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-            modelPCRange.offset = 0;
-            modelPCRange.size = sizeof(ModelPushConstant);
-            pushConstantRanges.push_back(modelPCRange);
-        }
-        
-        if (std::find(combinedDefines.begin(), combinedDefines.end(), ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL) != combinedDefines.end())
-        {
-            VkPushConstantRange lightModelPCRange{};
-            lightModelPCRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-            lightModelPCRange.offset = 0;
-            lightModelPCRange.size = sizeof(LightModelPushConstant);
-            pushConstantRanges.push_back(lightModelPCRange);
-        }
-
+        const std::vector<VkPushConstantRange> pushConstantRanges = getPushConstantRanges(bindings);
         shadowPipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
         shadowPipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
 
@@ -821,7 +801,7 @@ namespace vks
         VkPipelineColorBlendAttachmentState blendAttachmentState = base::initializers::pipelineColorBlendAttachmentState(0, VK_FALSE);
         VkPipelineColorBlendStateCreateInfo colorBlendState = base::initializers::pipelineColorBlendStateCreateInfo(1, &blendAttachmentState);
 
-        const auto& shaderStages = shaderProgramDescriptor->getShaderStages();
+        const auto& shaderStages = shaderProgramDescriptor->getShaderStages(permutationMask);
 
         VkPipelineRasterizationStateCreateInfo rasterizationState = base::initializers::pipelineRasterizationStateCreateInfo(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, 0);
         rasterizationState.depthBiasEnable = VK_TRUE;
@@ -831,7 +811,7 @@ namespace vks
         VkGraphicsPipelineCreateInfo pipelineCI = vks::base::initializers::pipelineCreateInfo(shadowPipelineLayout, shadowRenderPass, 0);
         
         // Use multiview render pass for point shadow shaders (which use multiple views)
-        bool isMultiview = std::find(combinedDefines.begin(), combinedDefines.end(), ShaderDefinesEnum::ENABLE_MULTVIEW) != combinedDefines.end();
+        bool isMultiview = (bindings & MULTIVIEW_BIT) != 0;
         
         if (isMultiview) {
             pipelineCI.renderPass = shadowRenderPassMultiview;
@@ -856,60 +836,29 @@ namespace vks
             throw std::runtime_error("failed to create shadow graphics pipeline!");
         }
 
-        pipelines.push_back(Pipeline{pipelineId, pipelineHandle, shadowPipelineLayout});
+        pipelines.push_back(Pipeline{pipelineId, permutationMask, pipelineHandle, shadowPipelineLayout, true});
     }
 
-     void RenderPipelineManager::createGraphicsPipeline(ShaderProgramDescriptor* shaderProgramDescriptor)
+    void RenderPipelineManager::createGraphicsPipeline(ShaderProgramDescriptor* shaderProgramDescriptor)
+    {
+        for (const uint32_t permutationMask : shaderProgramDescriptor->getPermutationMasks())
+        {
+            createGraphicsPipeline(shaderProgramDescriptor, permutationMask);
+        }
+    }
+
+     void RenderPipelineManager::createGraphicsPipeline(ShaderProgramDescriptor* shaderProgramDescriptor, uint32_t permutationMask)
     {
         boost::uuids::uuid pipelineId = shaderProgramDescriptor->getAssetId();
         createPipelineCache();
 
         // Check if pipeline already exists
-        if (findPipeline(pipelineId)) {
+        if (std::ranges::any_of(pipelines, [&](const Pipeline& p) { return p.id == pipelineId && p.permutationMask == permutationMask; })) {
             throw std::runtime_error("Pipeline already exists: " + boost::uuids::to_string(pipelineId));
         }
 
-        const auto& combinedDefines = shaderProgramDescriptor->getDefines();
-
-        // Get layouts for each define - ensuring they are at the correct set index
-        // We know the set indices: 0: Scene, 1: Material, 2: Mesh, 3: Lights
-        // DescriptorManager::getLayoutsFromEnums should ideally return them in the correct order,
-        // but it doesn't guarantee the size or empty slots.
-
-        // Let's get them one by one or filter.
-        std::vector<VkDescriptorSetLayout> combinedLayouts;
-
-        // Find max define index to determine layout count
-        int maxSet = 0;
-        for (auto def : combinedDefines) {
-            if (def == ShaderDefinesEnum::SCENE_UBO_GLSL) maxSet = std::max(maxSet, 0);
-            else if (def == ShaderDefinesEnum::MATERIAL_PBR_GLSL) maxSet = std::max(maxSet, 1);
-            else if (def == ShaderDefinesEnum::MATERIAL_SKYBOX_GLSL) maxSet = std::max(maxSet, 1);
-            else if (def == ShaderDefinesEnum::VERTEX_IO_GLSL) maxSet = std::max(maxSet, 2);
-            else if (def == ShaderDefinesEnum::LIGHTING_COMMON_GLSL) maxSet = std::max(maxSet, 3);
-            else if (def == ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL) maxSet = std::max(maxSet, 3);
-        }
-
-        combinedLayouts.resize(maxSet + 1, VK_NULL_HANDLE);
-
-        // Fill them based on define
-        for (auto def : combinedDefines) {
-            switch (def) {
-            case ShaderDefinesEnum::SCENE_UBO_GLSL: combinedLayouts[0] = descriptorManager->getSceneLayout(); break;
-            case ShaderDefinesEnum::MATERIAL_PBR_GLSL: combinedLayouts[1] = descriptorManager->getPbrMaterialLayout(); break;
-            case ShaderDefinesEnum::MATERIAL_SKYBOX_GLSL: combinedLayouts[1] = descriptorManager->getSkyboxMaterialLayout(); break;
-            case ShaderDefinesEnum::VERTEX_IO_GLSL: combinedLayouts[2] = descriptorManager->getMeshUniformLayout(); break;
-            case ShaderDefinesEnum::LIGHTING_COMMON_GLSL: combinedLayouts[3] = descriptorManager->getLightsLayout(); break;
-            case ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL: combinedLayouts[3] = descriptorManager->getLightsLayout(); break;
-            }
-        }
-
-        // Check for any null layouts in the sequence (up to maxSet)
-        for (int i = 0; i <= maxSet; ++i) {
-            if (combinedLayouts[i] == VK_NULL_HANDLE) {
-                combinedLayouts[i] = descriptorManager->getSceneLayout();
-            }
-        }
+        const ShaderBindingMask bindings = shaderProgramDescriptor->getBindings(permutationMask);
+        const std::vector<VkDescriptorSetLayout> combinedLayouts = descriptorManager->getLayoutsFromBindings(bindings);
 
         VkPipelineLayout meshPipelineLayout = VK_NULL_HANDLE;
         VkPipelineLayoutCreateInfo meshPipelineLayoutInfo{};
@@ -917,27 +866,7 @@ namespace vks
         meshPipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(combinedLayouts.size());
         meshPipelineLayoutInfo.pSetLayouts = combinedLayouts.data();
 
-        VkPushConstantRange modelPCRange{};
-        VkPushConstantRange lightModelPCRange{};
-        std::vector<VkPushConstantRange> pushConstantRanges;
-
-        if (std::find(combinedDefines.begin(), combinedDefines.end(), ShaderDefinesEnum::MODEL_PC_GLSL) != combinedDefines.end())
-        {
-            // Define push constant range for the vertex shader transform matrix
-            modelPCRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-            modelPCRange.offset = 0;
-            modelPCRange.size = sizeof(ModelPushConstant);
-            pushConstantRanges.push_back(modelPCRange);
-        }
-        
-        if (std::find(combinedDefines.begin(), combinedDefines.end(), ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL) != combinedDefines.end())
-        {
-            // Define push constant range for the light shadow model push constant
-            lightModelPCRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-            lightModelPCRange.offset = 0;
-            lightModelPCRange.size = sizeof(LightModelPushConstant);
-            pushConstantRanges.push_back(lightModelPCRange);
-        }
+        const std::vector<VkPushConstantRange> pushConstantRanges = getPushConstantRanges(bindings);
 
         if (!pushConstantRanges.empty()) {
             meshPipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
@@ -976,7 +905,7 @@ namespace vks
             base::initializers::pipelineColorBlendStateCreateInfo(1, &blendAttachmentState);
 
         // Load shaders
-        const auto& shaderStages = shaderProgramDescriptor->getShaderStages();
+        const auto& shaderStages = shaderProgramDescriptor->getShaderStages(permutationMask);
 
         // Mesh-specific rasterization state
         VkPipelineRasterizationStateCreateInfo rasterizationState =
@@ -987,7 +916,7 @@ namespace vks
         VkPipelineDepthStencilStateCreateInfo depthStencilState =
             base::initializers::pipelineDepthStencilStateCreateInfo(VK_TRUE, VK_TRUE, VK_COMPARE_OP_LESS_OR_EQUAL);
 
-        if (std::find(combinedDefines.begin(), combinedDefines.end(), ShaderDefinesEnum::MATERIAL_SKYBOX_GLSL) != combinedDefines.end())
+        if (bindings & MATERIAL_SKYBOX_SET_BIT)
         {
             rasterizationState.cullMode = VK_CULL_MODE_NONE;
         }
@@ -1005,8 +934,7 @@ namespace vks
         pipelineCI.stageCount = static_cast<uint32_t>(shaderStages.size());
         pipelineCI.pStages = shaderStages.data();
 
-        if (std::find(combinedDefines.begin(), combinedDefines.end(), ShaderDefinesEnum::MODEL_PC_GLSL) != combinedDefines.end() ||
-            std::find(combinedDefines.begin(), combinedDefines.end(), ShaderDefinesEnum::LIGHT_MODEL_PC_GLSL) != combinedDefines.end())
+        if (bindings & VERTEX_INPUT_BIT)
         {
             pipelineCI.pVertexInputState = MeshDescriptor::getPipelineVertexInputState({
                 VertexComponent::Position,
@@ -1026,7 +954,53 @@ namespace vks
         }
 
         // Add pipeline to vector
-        pipelines.push_back(Pipeline{pipelineId, pipelineHandle, meshPipelineLayout});
+        pipelines.push_back(Pipeline{pipelineId, permutationMask, pipelineHandle, meshPipelineLayout});
+    }
+
+    void RenderPipelineManager::rebuildPipelines(const std::vector<boost::uuids::uuid>& programIds)
+    {
+        auto destroy = [this](const Pipeline& pipeline) {
+            vkDestroyPipeline(context->getDevice(), pipeline.handle, nullptr);
+            vkDestroyPipelineLayout(context->getDevice(), pipeline.layout, nullptr);
+        };
+
+        for (const auto& programId : programIds)
+        {
+            // Taken out first, the create functions refuse an id that already has a pipeline. The rebuilt program
+            // may have other variants than before, so every mask goes and is made again
+            std::vector<Pipeline> previous;
+            std::erase_if(pipelines, [&](const Pipeline& p) {
+                if (p.id != programId)
+                    return false;
+                previous.push_back(p);
+                return true;
+            });
+            if (previous.empty())
+                continue;
+
+            try
+            {
+                auto* shaderProgramDescriptor = descriptorManager->getOrLoadResource<ShaderProgramDescriptor>(programId);
+                if (previous.front().shadow)
+                    createShadowPipeline(shaderProgramDescriptor);
+                else
+                    createGraphicsPipeline(shaderProgramDescriptor);
+            }
+            catch (const std::exception& e)
+            {
+                spdlog::error("Failed to rebuild pipeline {}, keeping the previous one: {}", boost::uuids::to_string(programId), e.what());
+                // Variants made before the failing one are dropped, the program keeps its old set as a whole
+                std::erase_if(pipelines, [&](const Pipeline& p) {
+                    if (p.id != programId)
+                        return false;
+                    destroy(p);
+                    return true;
+                });
+                pipelines.insert(pipelines.end(), previous.begin(), previous.end());
+                continue;
+            }
+            std::ranges::for_each(previous, destroy);
+        }
     }
 
     void RenderPipelineManager::createPipelineCache()
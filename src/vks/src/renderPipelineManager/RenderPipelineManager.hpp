@@ -1,6 +1,7 @@
 #pragma once
 #include <boost/uuid/uuid.hpp>
 #include <vulkan/vulkan.h>
+#include <set>
 #include <vector>
 #include <string>
 #include "../vulkanContext/VulkanContext.hpp"
@@ -17,8 +18,12 @@ namespace vks {
 
         void createRenderPass();
         void createShadowRenderPass();
+        // One pipeline per permutation variant of the program, each with the layout of the bindings that variant uses
         void createGraphicsPipeline(ShaderProgramDescriptor* shaderProgramDescriptor);
         void createShadowPipeline(ShaderProgramDescriptor* shaderProgramDescriptor);
+        // Recreates the pipelines of the given programs from their rebuilt descriptors, one that fails keeps the old pipeline.
+        // The device has to be idle
+        void rebuildPipelines(const std::vector<boost::uuids::uuid>& programIds);
         void createFramebuffers(VkExtent2D swapChainExtent);
         void createShadowFramebuffers();
         void createShadowResources();
@@ -34,21 +39,24 @@ namespace vks {
         // Pipeline structure to hold pipeline data
         struct Pipeline {
             boost::uuids::uuid id;
+            uint32_t permutationMask = 0;
             VkPipeline handle{VK_NULL_HANDLE};
             VkPipelineLayout layout{VK_NULL_HANDLE};
+            bool shadow = false;
         };
 
         // Getters
         VkRenderPass getRenderPass() const { return renderPass; }
         VkRenderPass getShadowRenderPass() const { return shadowRenderPass; }
         VkRenderPass getShadowRenderPassMultiview() const { return shadowRenderPassMultiview; }
-        VkPipeline getPipeline(const boost::uuids::uuid& pipelineId) const;
-        VkPipelineLayout getPipelineLayout(const boost::uuids::uuid& pipelineId) const;
+        // A permutation the program wasn't compiled for is reported once and gets its mask 0 pipeline
+        VkPipeline getPipeline(const boost::uuids::uuid& pipelineId, uint32_t permutationMask = 0) const;
+        VkPipelineLayout getPipelineLayout(const boost::uuids::uuid& pipelineId, uint32_t permutationMask = 0) const;
         VkFramebuffer getFramebuffer(uint32_t cameraIndex, uint32_t imageIndex) const;
         VkFramebuffer getDirectionalShadowFramebuffer(uint32_t index) const { return directionalShadowFramebuffers[index]; }
         VkFramebuffer getPointShadowFramebuffer(uint32_t index) const { return pointShadowFramebuffers[index]; }
         VkFramebuffer getSpotShadowFramebuffer(uint32_t index) const { return spotShadowFramebuffers[index]; }
-        bool hasPipeline(const boost::uuids::uuid& pipelineId) const { return findPipeline(pipelineId) != nullptr; }
+        bool hasPipeline(const boost::uuids::uuid& pipelineId, uint32_t permutationMask = 0) const { return findPipeline(pipelineId, permutationMask) != nullptr; }
 
         // Offscreen resources
         struct OffscreenTarget {
@@ -97,9 +105,13 @@ namespace vks {
         VkPipelineCache pipelineCache{VK_NULL_HANDLE};
 
         std::vector<Pipeline> pipelines;
+        // Programs and masks a draw asked for without a pipeline, so the error isn't logged every frame
+        mutable std::set<std::pair<boost::uuids::uuid, uint32_t>> reportedMissingVariants;
 
         // Helper methods
         void createPipelineCache();
-        const Pipeline* findPipeline(const boost::uuids::uuid& pipelineId) const;
+        void createGraphicsPipeline(ShaderProgramDescriptor* shaderProgramDescriptor, uint32_t permutationMask);
+        void createShadowPipeline(ShaderProgramDescriptor* shaderProgramDescriptor, uint32_t permutationMask);
+        const Pipeline* findPipeline(const boost::uuids::uuid& pipelineId, uint32_t permutationMask) const;
     };
 }
\ No newline at end of file